@@ -41,6 +41,7 @@ const string WPEFramework::Plugin::Bluetooth::METHOD_IS_DISCOVERABLE = "isDiscov
 const string WPEFramework::Plugin::Bluetooth::METHOD_GET_DISCOVERED_DEVICES = "getDiscoveredDevices";
 const string WPEFramework::Plugin::Bluetooth::METHOD_GET_PAIRED_DEVICES = "getPairedDevices";
 const string WPEFramework::Plugin::Bluetooth::METHOD_GET_CONNECTED_DEVICES = "getConnectedDevices";
+const string WPEFramework::Plugin::Bluetooth::METHOD_GET_DEVICE_CHANGES = "getDeviceChanges";
 const string WPEFramework::Plugin::Bluetooth::METHOD_CONNECT = "connect";
 const string WPEFramework::Plugin::Bluetooth::METHOD_DISCONNECT = "disconnect";
 const string WPEFramework::Plugin::Bluetooth::METHOD_SET_AUDIO_STREAM = "setAudioStream";
@@ -144,6 +145,7 @@ namespace WPEFramework
             registerMethod(METHOD_GET_DISCOVERED_DEVICES, &Bluetooth::getDiscoveredDevicesWrapper, this);
             registerMethod(METHOD_GET_PAIRED_DEVICES, &Bluetooth::getPairedDevicesWrapper, this);
             registerMethod(METHOD_GET_CONNECTED_DEVICES, &Bluetooth::getConnectedDevicesWrapper, this);
+            registerMethod(METHOD_GET_DEVICE_CHANGES, &Bluetooth::getDeviceChangesWrapper, this);
             registerMethod(METHOD_CONNECT, &Bluetooth::connectWrapper, this);
             registerMethod(METHOD_DISCONNECT, &Bluetooth::disconnectWrapper, this);
             registerMethod(METHOD_SET_AUDIO_STREAM, &Bluetooth::setAudioStreamWrapper, this);
@@ -349,59 +351,139 @@ namespace WPEFramework
             stopDeviceDiscovery();
         }
 
-        JsonArray Bluetooth::getDiscoveredDevices()
+        // Queries a device list from BTRMGR when the registry has not got it yet, or it may be out of date.
+        // Called with m_registryMutex held.
+        void Bluetooth::syncDeviceList(BluetoothDeviceRegistry::List list)
         {
-            JsonArray deviceArray;
-            BTRMGR_DiscoveredDevicesList_t discoveredDevices;
+            uint64_t nowMs = BluetoothDeviceRegistry::NowMs();
+            if (!m_deviceRegistry.isStale(list, nowMs))
+                return;
 
-            memset (&discoveredDevices, 0, sizeof(discoveredDevices));
-            BTRMGR_Result_t rc = BTRMGR_GetDiscoveredDevices(0, &discoveredDevices);
-            if (BTRMGR_RESULT_SUCCESS != rc)
+            std::vector<BluetoothDevice> devices;
+            BluetoothDevice device;
+            BTRMGR_Result_t rc = BTRMGR_RESULT_GENERIC_FAILURE;
+            int i = 0;
+
+            if (BluetoothDeviceRegistry::LIST_DISCOVERED == list)
+            {
+                BTRMGR_DiscoveredDevicesList_t discoveredDevices;
+
+                memset (&discoveredDevices, 0, sizeof(discoveredDevices));
+                rc = BTRMGR_GetDiscoveredDevices(0, &discoveredDevices);
+                if (BTRMGR_RESULT_SUCCESS != rc)
+                {
+                    LOGERR("Failed to get the discovered devices");
+                }
+                else
+                {
+                    LOGINFO ("Success....   Discovered %d Devices", discoveredDevices.m_numOfDevices);
+                    for (; i < discoveredDevices.m_numOfDevices; i++)
+                    {
+                        device.handle = discoveredDevices.m_deviceProperty[i].m_deviceHandle;
+                        device.name = string(discoveredDevices.m_deviceProperty[i].m_name);
+                        device.deviceType = string(BTRMGR_GetDeviceTypeAsString(discoveredDevices.m_deviceProperty[i].m_deviceType));
+                        device.connected = discoveredDevices.m_deviceProperty[i].m_isConnected?true:false;
+                        device.paired = discoveredDevices.m_deviceProperty[i].m_isPairedDevice?true:false;
+                        devices.push_back(device);
+                    }
+                }
+            }
+            else if (BluetoothDeviceRegistry::LIST_PAIRED == list)
             {
-                LOGERR("Failed to get the discovered devices");
+                BTRMGR_PairedDevicesList_t pairedDevices;
+
+                memset (&pairedDevices, 0, sizeof(pairedDevices));
+                rc = BTRMGR_GetPairedDevices(0, &pairedDevices);
+                if (BTRMGR_RESULT_SUCCESS != rc)
+                {
+                    LOGERR("Failed to get the paired devices");
+                }
+                else
+                {
+                    LOGINFO ("Success....   Paired %d Devices", pairedDevices.m_numOfDevices);
+                    for (; i < pairedDevices.m_numOfDevices; i++)
+                    {
+                        device.handle = pairedDevices.m_deviceProperty[i].m_deviceHandle;
+                        device.name = string(pairedDevices.m_deviceProperty[i].m_name);
+                        device.deviceType = string(BTRMGR_GetDeviceTypeAsString(pairedDevices.m_deviceProperty[i].m_deviceType));
+                        device.connected = pairedDevices.m_deviceProperty[i].m_isConnected?true:false;
+                        devices.push_back(device);
+                    }
+                }
             }
             else
             {
-                int i = 0;
-                JsonObject deviceDetails;
-                LOGINFO ("Success....   Discovered %d Devices", discoveredDevices.m_numOfDevices);
-                for (; i < discoveredDevices.m_numOfDevices; i++)
+                BTRMGR_ConnectedDevicesList_t connectedDevices;
+
+                memset (&connectedDevices, 0, sizeof(connectedDevices));
+                rc = BTRMGR_GetConnectedDevices(0, &connectedDevices);
+                if (BTRMGR_RESULT_SUCCESS != rc)
                 {
-                    deviceDetails["deviceID"] = std::to_string(discoveredDevices.m_deviceProperty[i].m_deviceHandle);
-                    deviceDetails["name"] = string(discoveredDevices.m_deviceProperty[i].m_name);
-                    deviceDetails["deviceType"] = string(BTRMGR_GetDeviceTypeAsString(discoveredDevices.m_deviceProperty[i].m_deviceType));
-                    deviceDetails["connected"] = discoveredDevices.m_deviceProperty[i].m_isConnected?true:false;
-                    deviceDetails["paired"] = discoveredDevices.m_deviceProperty[i].m_isPairedDevice?true:false;
-                    deviceArray.Add(deviceDetails);
+                    LOGERR("Failed to get the connected devices");
+                }
+                else
+                {
+                    LOGINFO ("Success....   Connected %d Devices", connectedDevices.m_numOfDevices);
+                    for (; i < connectedDevices.m_numOfDevices; i++)
+                    {
+                        device.handle = connectedDevices.m_deviceProperty[i].m_deviceHandle;
+                        device.name = string(connectedDevices.m_deviceProperty[i].m_name);
+                        device.deviceType = string(BTRMGR_GetDeviceTypeAsString(connectedDevices.m_deviceProperty[i].m_deviceType));
+                        device.activeState = connectedDevices.m_deviceProperty[i].m_powerStatus;
+                        devices.push_back(device);
+                    }
                 }
             }
+
+            // On failure the registry keeps what it has and asks again next time
+            if (BTRMGR_RESULT_SUCCESS == rc)
+            {
+                m_deviceRegistry.replace(list, devices, nowMs);
+                LOGINFO("Device registry: %u BTRMGR list queries so far", m_deviceRegistry.syncs());
+            }
+        }
+
+        JsonArray Bluetooth::getDiscoveredDevices()
+        {
+            JsonArray deviceArray;
+            std::vector<BluetoothDevice> devices;
+            {
+                std::lock_guard<std::mutex> lock(m_registryMutex);
+                syncDeviceList(BluetoothDeviceRegistry::LIST_DISCOVERED);
+                m_deviceRegistry.list(BluetoothDeviceRegistry::LIST_DISCOVERED, devices);
+            }
+
+            JsonObject deviceDetails;
+            for (auto& device : devices)
+            {
+                deviceDetails["deviceID"] = std::to_string(device.handle);
+                deviceDetails["name"] = device.name;
+                deviceDetails["deviceType"] = device.deviceType;
+                deviceDetails["connected"] = device.connected;
+                deviceDetails["paired"] = device.paired;
+                deviceArray.Add(deviceDetails);
+            }
             return deviceArray;
         }
 
         JsonArray Bluetooth::getPairedDevices()
         {
             JsonArray deviceArray;
-            BTRMGR_PairedDevicesList_t pairedDevices;
-
-            memset (&pairedDevices, 0, sizeof(pairedDevices));
-            BTRMGR_Result_t rc = BTRMGR_GetPairedDevices(0, &pairedDevices);
-            if (BTRMGR_RESULT_SUCCESS != rc)
+            std::vector<BluetoothDevice> devices;
             {
-                LOGERR("Failed to get the paired devices");
+                std::lock_guard<std::mutex> lock(m_registryMutex);
+                syncDeviceList(BluetoothDeviceRegistry::LIST_PAIRED);
+                m_deviceRegistry.list(BluetoothDeviceRegistry::LIST_PAIRED, devices);
             }
-            else
+
+            JsonObject deviceDetails;
+            for (auto& device : devices)
             {
-                int i = 0;
-                JsonObject deviceDetails;
-                LOGINFO ("Success....   Paired %d Devices", pairedDevices.m_numOfDevices);
-                for (; i < pairedDevices.m_numOfDevices; i++)
-                {
-                    deviceDetails["deviceID"] = std::to_string(pairedDevices.m_deviceProperty[i].m_deviceHandle);
-                    deviceDetails["name"] = string(pairedDevices.m_deviceProperty[i].m_name);
-                    deviceDetails["deviceType"] = string(BTRMGR_GetDeviceTypeAsString(pairedDevices.m_deviceProperty[i].m_deviceType));
-                    deviceDetails["connected"] = pairedDevices.m_deviceProperty[i].m_isConnected?true:false;
-                    deviceArray.Add(deviceDetails);
-                }
+                deviceDetails["deviceID"] = std::to_string(device.handle);
+                deviceDetails["name"] = device.name;
+                deviceDetails["deviceType"] = device.deviceType;
+                deviceDetails["connected"] = device.connected;
+                deviceArray.Add(deviceDetails);
             }
             return deviceArray;
         }
@@ -409,27 +491,21 @@ namespace WPEFramework
         JsonArray Bluetooth::getConnectedDevices()
         {
             JsonArray deviceArray;
-            BTRMGR_ConnectedDevicesList_t connectedDevices;
-
-            memset (&connectedDevices, 0, sizeof(connectedDevices));
-            BTRMGR_Result_t rc = BTRMGR_GetConnectedDevices(0, &connectedDevices);
-            if (BTRMGR_RESULT_SUCCESS != rc)
+            std::vector<BluetoothDevice> devices;
             {
-                LOGERR("Failed to get the connected devices");
+                std::lock_guard<std::mutex> lock(m_registryMutex);
+                syncDeviceList(BluetoothDeviceRegistry::LIST_CONNECTED);
+                m_deviceRegistry.list(BluetoothDeviceRegistry::LIST_CONNECTED, devices);
             }
-            else
+
+            JsonObject deviceDetails;
+            for (auto& device : devices)
             {
-                int i = 0;
-                JsonObject deviceDetails;
-                LOGINFO ("Success....   Connected %d Devices", connectedDevices.m_numOfDevices);
-                for (; i < connectedDevices.m_numOfDevices; i++)
-                {
-                    deviceDetails["deviceID"] = std::to_string(connectedDevices.m_deviceProperty[i].m_deviceHandle);
-                    deviceDetails["name"] = string(connectedDevices.m_deviceProperty[i].m_name);
-                    deviceDetails["deviceType"] = string(BTRMGR_GetDeviceTypeAsString(connectedDevices.m_deviceProperty[i].m_deviceType));
-                    deviceDetails["activeState"] = std::to_string(connectedDevices.m_deviceProperty[i].m_powerStatus);
-                    deviceArray.Add(deviceDetails);
-                }
+                deviceDetails["deviceID"] = std::to_string(device.handle);
+                deviceDetails["name"] = device.name;
+                deviceDetails["deviceType"] = device.deviceType;
+                deviceDetails["activeState"] = std::to_string(device.activeState);
+                deviceArray.Add(deviceDetails);
             }
             return deviceArray;
         }
@@ -541,6 +617,11 @@ namespace WPEFramework
             {
                 LOGERR("Failed to do setBluetoothEnabled");
             }
+            else
+            {
+                std::lock_guard<std::mutex> lock(m_registryMutex);
+                m_deviceRegistry.invalidateAll();
+            }
 
             return BTRMGR_RESULT_SUCCESS == rc;
         }
@@ -824,12 +905,72 @@ namespace WPEFramework
             return mediaTrackInfo;
         }
 
+        // Keeps the device registry in step with BTRMGR, so the device lists need not be queried again
+        void Bluetooth::updateDeviceRegistry(const BTRMGR_EventMessage_t& eventMsg)
+        {
+            BluetoothDevice device;
+            uint32_t fields = 0;
+
+            std::lock_guard<std::mutex> lock(m_registryMutex);
+            switch (eventMsg.m_eventType) {
+                case BTRMGR_EVENT_DEVICE_DISCOVERY_STARTED:
+                    // BTRMGR starts a new list for each scan
+                    m_deviceRegistry.invalidate(BluetoothDeviceRegistry::LIST_DISCOVERED);
+                    break;
+
+                case BTRMGR_EVENT_DEVICE_DISCOVERY_UPDATE:
+                    device.handle = eventMsg.m_discoveredDevice.m_deviceHandle;
+                    device.name = string(eventMsg.m_discoveredDevice.m_name);
+                    device.deviceType = BTRMGR_GetDeviceTypeAsString(eventMsg.m_discoveredDevice.m_deviceType);
+                    device.discovered = eventMsg.m_discoveredDevice.m_isDiscovered ? true : false;
+                    device.paired = eventMsg.m_discoveredDevice.m_isPairedDevice ? true : false;
+                    fields = BluetoothDeviceRegistry::FIELD_DISCOVERED | BluetoothDeviceRegistry::FIELD_PAIRED;
+                    break;
+
+                case BTRMGR_EVENT_DEVICE_PAIRING_COMPLETE:
+                    device.handle = eventMsg.m_discoveredDevice.m_deviceHandle;
+                    device.name = string(eventMsg.m_discoveredDevice.m_name);
+                    device.deviceType = BTRMGR_GetDeviceTypeAsString(eventMsg.m_discoveredDevice.m_deviceType);
+                    device.paired = eventMsg.m_discoveredDevice.m_isPairedDevice ? true : false;
+                    device.connected = eventMsg.m_discoveredDevice.m_isConnected ? true : false;
+                    fields = BluetoothDeviceRegistry::FIELD_PAIRED | BluetoothDeviceRegistry::FIELD_CONNECTED;
+                    break;
+
+                case BTRMGR_EVENT_DEVICE_UNPAIRING_COMPLETE:
+                    device.handle = eventMsg.m_pairedDevice.m_deviceHandle;
+                    device.paired = false;
+                    device.connected = eventMsg.m_pairedDevice.m_isConnected ? true : false;
+                    fields = BluetoothDeviceRegistry::FIELD_PAIRED | BluetoothDeviceRegistry::FIELD_CONNECTED;
+                    break;
+
+                case BTRMGR_EVENT_DEVICE_CONNECTION_COMPLETE:
+                case BTRMGR_EVENT_DEVICE_DISCONNECT_COMPLETE:
+                    device.handle = eventMsg.m_pairedDevice.m_deviceHandle;
+                    device.name = string(eventMsg.m_pairedDevice.m_name);
+                    device.deviceType = BTRMGR_GetDeviceTypeAsString(eventMsg.m_pairedDevice.m_deviceType);
+                    device.paired = true;
+                    device.connected = (BTRMGR_EVENT_DEVICE_CONNECTION_COMPLETE == eventMsg.m_eventType);
+                    fields = BluetoothDeviceRegistry::FIELD_PAIRED | BluetoothDeviceRegistry::FIELD_CONNECTED;
+                    // The event has no power status, the connected list is queried for it
+                    if (device.connected)
+                        m_deviceRegistry.invalidate(BluetoothDeviceRegistry::LIST_CONNECTED);
+                    break;
+
+                default:
+                    break;
+            }
+
+            if (fields != 0)
+                m_deviceRegistry.update(device, fields);
+        }
+
         void Bluetooth::notifyEventWrapper (BTRMGR_EventMessage_t eventMsg)
         {
             JsonObject params;
             string profileInfo;
             string eventId;
             LOGINFO ("Event notification: event of type %d received", eventMsg.m_eventType);
+            updateDeviceRegistry(eventMsg);
             switch (eventMsg.m_eventType) {
                 case BTRMGR_EVENT_DEVICE_DISCOVERY_COMPLETE:
                     LOGINFO ("Received %s Event from BTRMgr", C_STR(STATUS_DISCOVERY_COMPLETED));
@@ -1279,6 +1420,51 @@ namespace WPEFramework
             returnResponse(true);
         }
 
+        uint32_t Bluetooth::getDeviceChangesWrapper(const JsonObject& parameters, JsonObject& response)
+        {
+            LOGINFOMETHOD();
+            uint64_t sinceSeq;
+            std::vector<BluetoothDevice> devices;
+            std::vector<uint64_t> removed;
+            bool complete;
+
+            getDefaultNumberParameter("sinceSeq", sinceSeq, 0);
+
+            {
+                std::lock_guard<std::mutex> lock(m_registryMutex);
+                syncDeviceList(BluetoothDeviceRegistry::LIST_DISCOVERED);
+                syncDeviceList(BluetoothDeviceRegistry::LIST_PAIRED);
+                syncDeviceList(BluetoothDeviceRegistry::LIST_CONNECTED);
+                complete = m_deviceRegistry.changes(sinceSeq, devices, removed);
+                response["seq"] = m_deviceRegistry.seq();
+            }
+
+            JsonArray deviceArray;
+            JsonObject deviceDetails;
+            for (auto& device : devices)
+            {
+                deviceDetails["deviceID"] = std::to_string(device.handle);
+                deviceDetails["name"] = device.name;
+                deviceDetails["deviceType"] = device.deviceType;
+                deviceDetails["discovered"] = device.discovered;
+                deviceDetails["paired"] = device.paired;
+                deviceDetails["connected"] = device.connected;
+                deviceDetails["activeState"] = std::to_string(device.activeState);
+                deviceArray.Add(deviceDetails);
+            }
+
+            JsonArray removedArray;
+            for (auto handle : removed)
+            {
+                removedArray.Add(std::to_string(handle));
+            }
+
+            response["full"] = !complete;
+            response["devices"] = deviceArray;
+            response["removed"] = removedArray;
+            returnResponse(true);
+        }
+
         uint32_t Bluetooth::connectWrapper(const JsonObject& parameters, JsonObject& response)
         {
             LOGINFOMETHOD();
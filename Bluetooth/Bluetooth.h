@@ -19,11 +19,13 @@
 
 #pragma once
 
+#include <mutex>
 #include <thread>
 
 #include "Module.h"
 #include "utils.h"
 #include "AbstractPlugin.h"
+#include "BluetoothDeviceRegistry.h"
 
 #include "btmgr.h" //TODO: can we move it to the module? Required by notifyEventWrapper()
 
@@ -83,6 +85,7 @@ namespace WPEFramework {
             uint32_t getDiscoveredDevicesWrapper(const JsonObject& parameters, JsonObject& response);
             uint32_t getPairedDevicesWrapper(const JsonObject& parameters, JsonObject& response);
             uint32_t getConnectedDevicesWrapper(const JsonObject& parameters, JsonObject& response);
+            uint32_t getDeviceChangesWrapper(const JsonObject& parameters, JsonObject& response);
             uint32_t connectWrapper(const JsonObject& parameters, JsonObject& response);
             uint32_t disconnectWrapper(const JsonObject& parameters, JsonObject& response);
             uint32_t setAudioStreamWrapper(const JsonObject& parameters, JsonObject& response);
@@ -111,6 +114,8 @@ namespace WPEFramework {
             JsonArray getDiscoveredDevices();
             JsonArray getPairedDevices();
             JsonArray getConnectedDevices();
+            void syncDeviceList(BluetoothDeviceRegistry::List list);
+            void updateDeviceRegistry(const BTRMGR_EventMessage_t& eventMsg);
             bool setDeviceConnection(long long int deviceID, const string &enable, const string &deviceType = "UNKNOWN DEVICE");
             bool setAudioStream(long long int deviceID, const string &audioStreamName);
             bool setDevicePairing(long long int deviceID, bool pair);
@@ -137,6 +142,7 @@ namespace WPEFramework {
             static const string METHOD_GET_DISCOVERED_DEVICES;
             static const string METHOD_GET_PAIRED_DEVICES;
             static const string METHOD_GET_CONNECTED_DEVICES;
+            static const string METHOD_GET_DEVICE_CHANGES;
             static const string METHOD_CONNECT;
             static const string METHOD_DISCONNECT;
             static const string METHOD_SET_AUDIO_STREAM;
@@ -222,6 +228,9 @@ namespace WPEFramework {
             Utils::ThreadRAII m_executionThread;
             bool m_discoveryRunning;
             DiscoveryTimer m_discoveryTimer;
+            // Serves the device lists without a BTRMGR query each time, updated from the BTRMGR events
+            std::mutex m_registryMutex;
+            BluetoothDeviceRegistry m_deviceRegistry;
             friend class DiscoveryTimer;
         };
 	} // Plugin
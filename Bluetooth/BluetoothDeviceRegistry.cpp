@@ -0,0 +1,289 @@
+/**
+* If not stated otherwise in this file or this component's LICENSE
+* file the following copyright and licenses apply:
+*
+* Copyright 2020 RDK Management
+*
+* Licensed under the Apache License, Version 2.0 (the "License");
+* you may not use this file except in compliance with the License.
+* You may obtain a copy of the License at
+*
+* http://www.apache.org/licenses/LICENSE-2.0
+*
+* Unless required by applicable law or agreed to in writing, software
+* distributed under the License is distributed on an "AS IS" BASIS,
+* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+* See the License for the specific language governing permissions and
+* limitations under the License.
+**/
+
+#include "BluetoothDeviceRegistry.h"
+
+#include <chrono>
+
+namespace WPEFramework
+{
+    namespace Plugin
+    {
+        // The field that makes a device part of each list, and the other fields its BTRMGR query returns
+        static const uint32_t s_listField[BluetoothDeviceRegistry::LIST_COUNT] = {
+            BluetoothDeviceRegistry::FIELD_DISCOVERED,
+            BluetoothDeviceRegistry::FIELD_PAIRED,
+            BluetoothDeviceRegistry::FIELD_CONNECTED
+        };
+        static const uint32_t s_listExtraFields[BluetoothDeviceRegistry::LIST_COUNT] = {
+            BluetoothDeviceRegistry::FIELD_PAIRED | BluetoothDeviceRegistry::FIELD_CONNECTED,
+            BluetoothDeviceRegistry::FIELD_CONNECTED,
+            BluetoothDeviceRegistry::FIELD_ACTIVE_STATE
+        };
+
+        static bool inList(const BluetoothDevice& device, BluetoothDeviceRegistry::List list)
+        {
+            switch (list)
+            {
+                case BluetoothDeviceRegistry::LIST_DISCOVERED:
+                    return device.discovered;
+                case BluetoothDeviceRegistry::LIST_PAIRED:
+                    return device.paired;
+                case BluetoothDeviceRegistry::LIST_CONNECTED:
+                    return device.connected;
+                default:
+                    return false;
+            }
+        }
+
+        BluetoothDeviceRegistry::BluetoothDeviceRegistry()
+        : m_seq(0)
+        , m_forgottenSeq(0)
+        , m_syncs(0)
+        {
+            invalidateAll();
+        }
+
+        uint64_t BluetoothDeviceRegistry::NowMs()
+        {
+            return std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+        }
+
+        bool BluetoothDeviceRegistry::isStale(List list, uint64_t nowMs) const
+        {
+            return !m_valid[list] || (nowMs - m_syncedMs[list] >= BLUETOOTH_REGISTRY_MAX_AGE_MS);
+        }
+
+        void BluetoothDeviceRegistry::invalidate(List list)
+        {
+            m_valid[list] = false;
+        }
+
+        void BluetoothDeviceRegistry::invalidateAll()
+        {
+            for (int list = 0; list < LIST_COUNT; list++)
+            {
+                m_valid[list] = false;
+                m_syncedMs[list] = 0;
+            }
+        }
+
+        void BluetoothDeviceRegistry::replace(List list, const std::vector<BluetoothDevice>& devices, uint64_t nowMs)
+        {
+            uint32_t fields = s_listField[list] | s_listExtraFields[list];
+
+            for (auto& it : m_devices)
+            {
+                bool listed = false;
+                for (auto& device : devices)
+                {
+                    if (device.handle == it.handle)
+                    {
+                        listed = true;
+                        break;
+                    }
+                }
+                if (!listed && apply(it, BluetoothDevice(), s_listField[list]))
+                {
+                    changed(it);
+                }
+            }
+
+            for (auto& device : devices)
+            {
+                BluetoothDevice listed(device);
+                switch (list)
+                {
+                    case LIST_DISCOVERED: listed.discovered = true; break;
+                    case LIST_PAIRED: listed.paired = true; break;
+                    default: listed.connected = true; break;
+                }
+
+                BluetoothDevice* existing = find(device.handle);
+                if (existing == nullptr)
+                {
+                    existing = &insert(device.handle);
+                }
+                if (apply(*existing, listed, fields))
+                {
+                    changed(*existing);
+                }
+            }
+
+            removeUnlisted();
+
+            m_valid[list] = true;
+            m_syncedMs[list] = nowMs;
+            m_syncs++;
+        }
+
+        void BluetoothDeviceRegistry::update(const BluetoothDevice& device, uint32_t fields)
+        {
+            BluetoothDevice* existing = find(device.handle);
+            if (existing == nullptr)
+            {
+                bool listed = ((fields & FIELD_DISCOVERED) && device.discovered)
+                    || ((fields & FIELD_PAIRED) && device.paired)
+                    || ((fields & FIELD_CONNECTED) && device.connected);
+                if (!listed)
+                {
+                    // Lost or unpaired before we knew of it
+                    return;
+                }
+                existing = &insert(device.handle);
+            }
+
+            if (apply(*existing, device, fields))
+            {
+                changed(*existing);
+                removeUnlisted();
+            }
+        }
+
+        void BluetoothDeviceRegistry::list(List list, std::vector<BluetoothDevice>& devices) const
+        {
+            devices.clear();
+            for (auto& it : m_devices)
+            {
+                if (inList(it, list))
+                {
+                    devices.push_back(it);
+                }
+            }
+        }
+
+        bool BluetoothDeviceRegistry::changes(uint64_t sinceSeq, std::vector<BluetoothDevice>& devices, std::vector<uint64_t>& removed) const
+        {
+            devices.clear();
+            removed.clear();
+
+            // A sequence number from before a restart can be ahead of ours
+            bool complete = (sinceSeq != 0 && sinceSeq <= m_seq && sinceSeq >= m_forgottenSeq);
+            for (auto& it : m_devices)
+            {
+                if (!complete || it.seq > sinceSeq)
+                {
+                    devices.push_back(it);
+                }
+            }
+            if (complete)
+            {
+                for (auto& it : m_removed)
+                {
+                    if (it.seq > sinceSeq)
+                    {
+                        removed.push_back(it.handle);
+                    }
+                }
+            }
+            return complete;
+        }
+
+        BluetoothDevice* BluetoothDeviceRegistry::find(uint64_t handle)
+        {
+            for (auto& it : m_devices)
+            {
+                if (it.handle == handle)
+                {
+                    return &it;
+                }
+            }
+            return nullptr;
+        }
+
+        BluetoothDevice& BluetoothDeviceRegistry::insert(uint64_t handle)
+        {
+            for (auto it = m_removed.begin(); it != m_removed.end(); ++it)
+            {
+                if (it->handle == handle)
+                {
+                    m_removed.erase(it);
+                    break;
+                }
+            }
+
+            m_devices.push_back(BluetoothDevice());
+            m_devices.back().handle = handle;
+            return m_devices.back();
+        }
+
+        bool BluetoothDeviceRegistry::apply(BluetoothDevice& device, const BluetoothDevice& from, uint32_t fields)
+        {
+            bool result = false;
+            if (!from.name.empty() && device.name != from.name)
+            {
+                device.name = from.name;
+                result = true;
+            }
+            if (!from.deviceType.empty() && device.deviceType != from.deviceType)
+            {
+                device.deviceType = from.deviceType;
+                result = true;
+            }
+            if ((fields & FIELD_DISCOVERED) && device.discovered != from.discovered)
+            {
+                device.discovered = from.discovered;
+                result = true;
+            }
+            if ((fields & FIELD_PAIRED) && device.paired != from.paired)
+            {
+                device.paired = from.paired;
+                result = true;
+            }
+            if ((fields & FIELD_CONNECTED) && device.connected != from.connected)
+            {
+                device.connected = from.connected;
+                result = true;
+            }
+            if ((fields & FIELD_ACTIVE_STATE) && device.activeState != from.activeState)
+            {
+                device.activeState = from.activeState;
+                result = true;
+            }
+            return result;
+        }
+
+        void BluetoothDeviceRegistry::changed(BluetoothDevice& device)
+        {
+            device.seq = ++m_seq;
+        }
+
+        void BluetoothDeviceRegistry::removeUnlisted()
+        {
+            for (auto it = m_devices.begin(); it != m_devices.end(); )
+            {
+                if (it->discovered || it->paired || it->connected)
+                {
+                    ++it;
+                    continue;
+                }
+
+                Removed removed = { it->handle, ++m_seq };
+                m_removed.push_back(removed);
+                if (m_removed.size() > BLUETOOTH_REGISTRY_MAX_REMOVED)
+                {
+                    m_forgottenSeq = m_removed.front().seq;
+                    m_removed.pop_front();
+                }
+                it = m_devices.erase(it);
+            }
+        }
+
+    } // namespace Plugin
+} // namespace WPEFramework
@@ -0,0 +1,127 @@
+/**
+* If not stated otherwise in this file or this component's LICENSE
+* file the following copyright and licenses apply:
+*
+* Copyright 2020 RDK Management
+*
+* Licensed under the Apache License, Version 2.0 (the "License");
+* you may not use this file except in compliance with the License.
+* You may obtain a copy of the License at
+*
+* http://www.apache.org/licenses/LICENSE-2.0
+*
+* Unless required by applicable law or agreed to in writing, software
+* distributed under the License is distributed on an "AS IS" BASIS,
+* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+* See the License for the specific language governing permissions and
+* limitations under the License.
+**/
+
+#pragma once
+
+#include <stdint.h>
+#include <deque>
+#include <string>
+#include <vector>
+
+// A list is queried from BTRMGR again once it is this old, in case an event was missed
+#define BLUETOOTH_REGISTRY_MAX_AGE_MS 30000
+// Removed devices remembered for getDeviceChanges; older callers get a full listing
+#define BLUETOOTH_REGISTRY_MAX_REMOVED 64
+
+namespace WPEFramework {
+
+    namespace Plugin {
+
+        struct BluetoothDevice
+        {
+            BluetoothDevice()
+            : handle(0), discovered(false), paired(false), connected(false), activeState(0), seq(0)
+            {
+            }
+
+            uint64_t handle;
+            std::string name;
+            std::string deviceType;
+            bool discovered;
+            bool paired;
+            bool connected;
+            uint32_t activeState;
+            uint64_t seq;           // registry sequence number of the last change
+        };
+
+        /**
+        * @brief The devices BTRMGR reported, kept up to date from its events so the device
+        * lists are not queried over IARM on every call. Not thread safe, Bluetooth serializes the calls.
+        */
+        class BluetoothDeviceRegistry
+        {
+        public:
+            enum List
+            {
+                LIST_DISCOVERED = 0,
+                LIST_PAIRED,
+                LIST_CONNECTED,
+                LIST_COUNT
+            };
+
+            // Device fields an update carries
+            enum Field
+            {
+                FIELD_DISCOVERED = 0x1,
+                FIELD_PAIRED = 0x2,
+                FIELD_CONNECTED = 0x4,
+                FIELD_ACTIVE_STATE = 0x8
+            };
+
+            BluetoothDeviceRegistry();
+
+            BluetoothDeviceRegistry(const BluetoothDeviceRegistry&) = delete;
+            BluetoothDeviceRegistry& operator=(const BluetoothDeviceRegistry&) = delete;
+
+            static uint64_t NowMs();
+
+            // True if the list was never queried, was invalidated or is older than BLUETOOTH_REGISTRY_MAX_AGE_MS
+            bool isStale(List list, uint64_t nowMs) const;
+            void invalidate(List list);
+            void invalidateAll();
+
+            // The whole list as BTRMGR returned it; listed devices not in it leave the list
+            void replace(List list, const std::vector<BluetoothDevice>& devices, uint64_t nowMs);
+            // A single device from an event, only the given fields (and a non empty name and type) apply
+            void update(const BluetoothDevice& device, uint32_t fields);
+
+            void list(List list, std::vector<BluetoothDevice>& devices) const;
+            // Devices changed and removed after sinceSeq; false if the removals since then were
+            // forgotten, in which case devices holds every device and the caller starts over
+            bool changes(uint64_t sinceSeq, std::vector<BluetoothDevice>& devices, std::vector<uint64_t>& removed) const;
+
+            uint64_t seq() const { return m_seq; }
+            size_t size() const { return m_devices.size(); }
+            // BTRMGR list queries the registry was seeded or resynced from
+            uint32_t syncs() const { return m_syncs; }
+
+        private:
+            struct Removed
+            {
+                uint64_t handle;
+                uint64_t seq;
+            };
+
+            BluetoothDevice* find(uint64_t handle);
+            BluetoothDevice& insert(uint64_t handle);
+            bool apply(BluetoothDevice& device, const BluetoothDevice& from, uint32_t fields);
+            void changed(BluetoothDevice& device);
+            void removeUnlisted();
+
+            std::vector<BluetoothDevice> m_devices;
+            std::deque<Removed> m_removed;
+            uint64_t m_seq;
+            uint64_t m_forgottenSeq;
+            bool m_valid[LIST_COUNT];
+            uint64_t m_syncedMs[LIST_COUNT];
+            uint32_t m_syncs;
+        };
+
+    } // namespace Plugin
+} // namespace WPEFramework
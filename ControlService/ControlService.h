@@ -21,6 +21,7 @@
 
 #include "Module.h"
 #include "utils.h"
+#include "iarmeventdispatcher.h"
 #include "AbstractPlugin.h"
 #include "libIBus.h"
 
@@ -182,6 +183,8 @@ namespace WPEFramework {
             // Used to remember the "golden" and "entered" digits, during 3-digit manual pairing validation
             threeDigits m_goldenValDigits;
             threeDigits m_enteredValDigits;
+
+            IARMEventDispatcher m_iarmEvents;
         };
 	} // namespace Plugin
 } // namespace WPEFramework
@@ -19,16 +19,32 @@
 
 #include "DeviceDiagnostics.h"
 
-#include <curl/curl.h>
 #include <time.h>
+#include <algorithm>
+#include <chrono>
 
 #include "utils.h"
+#include "tr181client.h"
+#include "iarmcallstats.h"
 
 #define DEVICE_DIAGNOSTICS_METHOD_NAME_GET_CONFIGURATION  "getConfiguration"
 #define DEVICE_DIAGNOSTICS_METHOD_GET_AV_DECODER_STATUS "getAVDecoderStatus"
+#define DEVICE_DIAGNOSTICS_METHOD_GET_AV_DECODER_STATUS_HISTORY "getAVDecoderStatusHistory"
+#define DEVICE_DIAGNOSTICS_METHOD_GET_IARM_CALL_STATS "getIARMCallStats"
+#define DEVICE_DIAGNOSTICS_METHOD_SET_IARM_CALL_SLOW_THRESHOLD "setIARMCallSlowThreshold"
 
 #define DEVICE_DIAGNOSTICS_EVT_ON_AV_DECODER_STATUS_CHANGED "onAVDecoderStatusChanged"
 
+#define AV_POLL_ACTIVE_MS 250
+#define AV_POLL_IDLE_MIN_MS 1000
+#define AV_POLL_IDLE_MAX_MS 30000
+#define AV_POLL_HINT_WINDOW_MS 15000
+#define AV_POLL_SUBSCRIBE_RETRY_MS 30000
+#define AV_STATUS_HISTORY_MAX 256
+
+#define SERVER_DETAILS  "127.0.0.1:9998"
+#define RDKSHELL_CALLSIGN_VER "org.rdk.RDKShell.1"
+
 namespace WPEFramework
 {
     namespace Plugin
@@ -37,7 +53,6 @@ namespace WPEFramework
 
         DeviceDiagnostics* DeviceDiagnostics::_instance = nullptr;
 
-        const int curlTimeoutInSeconds = 30;
         static const char *decoderStatusStr[] = {
             "IDLE",
             "PAUSED",
@@ -45,14 +60,6 @@ namespace WPEFramework
             NULL
         };
 
-        static size_t writeCurlResponse(void *ptr, size_t size, size_t nmemb, std::string stream)
-        {
-          size_t realsize = size * nmemb;
-          std::string temp(static_cast<const char*>(ptr), realsize);
-          stream.append(temp);
-          return realsize;
-        }
-
         DeviceDiagnostics::DeviceDiagnostics()
         : AbstractPlugin()
         {
@@ -60,6 +67,9 @@ namespace WPEFramework
 
             registerMethod(DEVICE_DIAGNOSTICS_METHOD_NAME_GET_CONFIGURATION, &DeviceDiagnostics::getConfigurationWrapper, this);
             registerMethod(DEVICE_DIAGNOSTICS_METHOD_GET_AV_DECODER_STATUS, &DeviceDiagnostics::getAVDecoderStatus, this);
+            registerMethod(DEVICE_DIAGNOSTICS_METHOD_GET_AV_DECODER_STATUS_HISTORY, &DeviceDiagnostics::getAVDecoderStatusHistory, this);
+            registerMethod(DEVICE_DIAGNOSTICS_METHOD_GET_IARM_CALL_STATS, &DeviceDiagnostics::getIARMCallStats, this);
+            registerMethod(DEVICE_DIAGNOSTICS_METHOD_SET_IARM_CALL_SLOW_THRESHOLD, &DeviceDiagnostics::setIARMCallSlowThreshold, this);
         }
 
         DeviceDiagnostics::~DeviceDiagnostics()
@@ -78,6 +88,7 @@ namespace WPEFramework
             }
 
             m_pollThreadRun = 1;
+            m_pollHint = false;
             m_AVPollThread = std::thread(AVPollThread, this);
 #else
             LOGWARN("ENABLE_ERM is not defined, decoder status will "
@@ -93,7 +104,9 @@ namespace WPEFramework
             m_AVDecoderStatusLock.lock();
             m_pollThreadRun = 0;
             m_AVDecoderStatusLock.unlock();
+            m_AVPollCond.notify_all();
             m_AVPollThread.join();
+            unsubscribeFromShellEvents();
             EssRMgrDestroy(m_EssRMgr);
 #endif
             DeviceDiagnostics::_instance = nullptr;
@@ -105,30 +118,19 @@ namespace WPEFramework
 
             JsonArray names = parameters["names"].Array();
 
-            JsonObject requestParams;
-            JsonArray namePairs;
+            std::vector<std::string> namesList;
 
             JsonArray::Iterator index(names.Elements());
 
             while (index.Next() == true)
             {
                 if (Core::JSON::Variant::type::STRING == index.Current().Content())
-                {
-                    //JSON::String s = index.Current().String();
-                    JsonObject o;
-                    o["name"] = index.Current().String();
-                    namePairs.Add(o);
-                }
+                    namesList.push_back(index.Current().String());
                 else
                     LOGWARN("Unexpected variant type");
             }
 
-            requestParams["paramList"] = namePairs;
-
-            string json;
-            requestParams.ToString(json);
-
-            if (0 == getConfiguration(json, response))
+            if (0 == getConfiguration(namesList, response))
                 returnResponse(true);
 
             returnResponse(false);
@@ -147,42 +149,128 @@ namespace WPEFramework
             return status;
         }
 
-        /* periodically polls ERM library for changes in most
-         * active decoder and send thunder event when decoder
-         * status changes. Needs to be done via poll and separate
-         * thread because ERM doesn't support events. */
+        /* polls ERM library for changes in most active decoder
+         * and sends thunder event when decoder status changes.
+         * Needs to be done via poll and separate thread because
+         * ERM doesn't support events. Polls fast while a decoder
+         * is in use or an app was just launched/suspended/destroyed
+         * (RDKShell events), and backs off exponentially when idle. */
 #ifdef ENABLE_ERM
         void *DeviceDiagnostics::AVPollThread(void *arg)
         {
-            struct timespec poll_wait = { .tv_sec = 30, .tv_nsec = 0  };
             int lastStatus = EssRMgrRes_idle;
             int status;
-            DeviceDiagnostics* t = DeviceDiagnostics::_instance;
+            uint32_t interval;
+            uint32_t idleInterval = AV_POLL_IDLE_MIN_MS;
+            bool subscribed = false;
+            std::chrono::steady_clock::time_point nextSubscribe = std::chrono::steady_clock::now();
+            DeviceDiagnostics* t = static_cast<DeviceDiagnostics*>(arg);
 
             LOGINFO("AVPollThread started");
             for (;;)
             {
-                nanosleep(&poll_wait, NULL);
+                // RDKShell may come up after us, keep trying at a low rate
+                if (!subscribed && std::chrono::steady_clock::now() >= nextSubscribe)
+                {
+                    subscribed = t->subscribeToShellEvents();
+                    nextSubscribe = std::chrono::steady_clock::now() + std::chrono::milliseconds(AV_POLL_SUBSCRIBE_RETRY_MS);
+                }
+
                 std::unique_lock<std::mutex> lock(t->m_AVDecoderStatusLock);
                 if (t->m_pollThreadRun == 0)
                     break;
 
+                t->m_pollHint = false;
                 status = t->getMostActiveDecoderStatus();
+
+                if (status != EssRMgrRes_idle || std::chrono::steady_clock::now() < t->m_hintExpiry)
+                {
+                    interval = AV_POLL_ACTIVE_MS;
+                    idleInterval = AV_POLL_IDLE_MIN_MS;
+                }
+                else if (status != lastStatus)
+                {
+                    interval = idleInterval = AV_POLL_IDLE_MIN_MS;
+                }
+                else
+                {
+                    interval = idleInterval;
+                    idleInterval = std::min(idleInterval * 2, (uint32_t)AV_POLL_IDLE_MAX_MS);
+                }
                 lock.unlock();
 
-                if (status == lastStatus)
-                    continue;
+                if (status != lastStatus)
+                {
+                    lastStatus = status;
+                    t->onDecoderStatusChange(status);
+                }
 
-                lastStatus = status;
-                t->onDecoderStatusChange(status);
+                lock.lock();
+                t->m_AVPollCond.wait_for(lock, std::chrono::milliseconds(interval),
+                    [t]() { return t->m_pollThreadRun == 0 || t->m_pollHint; });
             }
 
             return NULL;
         }
+
+        bool DeviceDiagnostics::subscribeToShellEvents()
+        {
+            static const char* events[] = { "onLaunched", "onSuspended", "onDestroyed" };
+            uint32_t err = Core::ERROR_NONE;
+
+            Core::SystemInfo::SetEnvironment(_T("THUNDER_ACCESS"), (_T(SERVER_DETAILS)));
+            if (nullptr == m_shellClient)
+                m_shellClient = make_shared<WPEFramework::JSONRPC::LinkType<Core::JSON::IElement>>(_T(RDKSHELL_CALLSIGN_VER), (_T(RDKSHELL_CALLSIGN_VER)));
+
+            for (size_t i = 0; i < sizeof(events) / sizeof(events[0]); i++)
+            {
+                err = m_shellClient->Subscribe<JsonObject>(1000, events[i], &DeviceDiagnostics::onShellAppEvent, this);
+                if (err != Core::ERROR_NONE)
+                {
+                    LOGWARN("Failed to subscribe for %s with code %d, polling without app hints", events[i], err);
+                    unsubscribeFromShellEvents();
+                    return false;
+                }
+            }
+
+            LOGINFO("Subscribed for RDKShell app events");
+            return true;
+        }
+
+        void DeviceDiagnostics::unsubscribeFromShellEvents()
+        {
+            if (nullptr == m_shellClient)
+                return;
+
+            m_shellClient->Unsubscribe(1000, _T("onLaunched"));
+            m_shellClient->Unsubscribe(1000, _T("onSuspended"));
+            m_shellClient->Unsubscribe(1000, _T("onDestroyed"));
+            m_shellClient.reset();
+        }
+
+        /* an app changing state is likely to start or stop a pipeline */
+        void DeviceDiagnostics::onShellAppEvent(const JsonObject& parameters)
+        {
+            std::lock_guard<std::mutex> lock(m_AVDecoderStatusLock);
+            m_hintExpiry = std::chrono::steady_clock::now() + std::chrono::milliseconds(AV_POLL_HINT_WINDOW_MS);
+            m_pollHint = true;
+            m_AVPollCond.notify_all();
+        }
 #endif
 
         void DeviceDiagnostics::onDecoderStatusChange(int status)
         {
+            {
+                std::lock_guard<std::mutex> lock(m_historyLock);
+                DecoderStatusChange change;
+                change.timestamp = std::chrono::duration_cast<std::chrono::milliseconds>(
+                    std::chrono::system_clock::now().time_since_epoch()).count();
+                change.status = status;
+                m_history.push_back(change);
+                if (m_history.size() > AV_STATUS_HISTORY_MAX)
+                    m_history.pop_front();
+            }
+
             JsonObject params;
             params["avDecoderStatusChange"] = decoderStatusStr[status];
             sendNotify(DEVICE_DIAGNOSTICS_EVT_ON_AV_DECODER_STATUS_CHANGED, params);
@@ -202,56 +290,114 @@ namespace WPEFramework
             returnResponse(true);
         }
 
-        int DeviceDiagnostics::getConfiguration(const std::string& postData, JsonObject& out)
+        uint32_t DeviceDiagnostics::getAVDecoderStatusHistory(const JsonObject& parameters, JsonObject& response)
         {
-            LOGINFO("%s",__FUNCTION__);
+            LOGINFOMETHOD();
 
-            JsonObject DeviceDiagnosticsResult;
-            int result = -1;
+            uint64_t since = 0;
+            if (parameters.HasLabel("since"))
+                since = parameters["since"].Number();
 
-            long http_code = 0;
-            std::string response;
-            CURL *curl_handle = NULL;
-            CURLcode res = CURLE_OK;
-            curl_handle = curl_easy_init();
+            JsonArray history;
+            {
+                std::lock_guard<std::mutex> lock(m_historyLock);
+                for (auto& change : m_history)
+                {
+                    if (change.timestamp <= since)
+                        continue;
 
-            LOGINFO("data: %s", postData.c_str());
+                    JsonObject entry;
+                    entry["timestamp"] = change.timestamp;
+                    entry["avDecoderStatus"] = decoderStatusStr[change.status];
+                    history.Add(entry);
+                }
+            }
 
-            if (curl_handle) {
+            response["history"] = history;
+            returnResponse(true);
+        }
 
-                curl_easy_setopt(curl_handle, CURLOPT_URL, "http://127.0.0.1:10999");
-                curl_easy_setopt(curl_handle, CURLOPT_POSTFIELDS, postData.c_str());
-                curl_easy_setopt(curl_handle, CURLOPT_POSTFIELDSIZE, postData.size());
-                curl_easy_setopt(curl_handle, CURLOPT_FOLLOWLOCATION, 1); //when redirected, follow the redirections
-                curl_easy_setopt(curl_handle, CURLOPT_WRITEFUNCTION, writeCurlResponse);
-                curl_easy_setopt(curl_handle, CURLOPT_WRITEDATA, &response);
-                curl_easy_setopt(curl_handle, CURLOPT_TIMEOUT, curlTimeoutInSeconds);
+        /* the IARM calls of all the plugins using IARM_BUS_CALL, in any process,
+         * as they share the table of IARMCallStats */
+        uint32_t DeviceDiagnostics::getIARMCallStats(const JsonObject& parameters, JsonObject& response)
+        {
+            LOGINFOMETHOD();
 
-                res = curl_easy_perform(curl_handle);
-                curl_easy_getinfo(curl_handle, CURLINFO_RESPONSE_CODE, &http_code);
+            IARMCallStats& stats = IARMCallStats::instance();
 
-                LOGWARN("Perfomed curl call : %d http response code: %ld", res, http_code);
-                curl_easy_cleanup(curl_handle);
+            JsonArray calls;
+            for (auto& entry : stats.snapshot())
+            {
+                JsonObject call;
+                call["owner"] = entry.owner;
+                call["method"] = entry.method;
+                call["inFlight"] = entry.inFlight;
+                call["calls"] = entry.calls;
+                call["failures"] = entry.failures;
+                call["slow"] = entry.slow;
+                call["averageUs"] = (entry.calls != 0) ? entry.totalUs / entry.calls : 0;
+                call["p50Us"] = IARMCallStats::percentileUs(entry, 0.5);
+                call["p99Us"] = IARMCallStats::percentileUs(entry, 0.99);
+                call["maxUs"] = entry.maxUs;
+
+                // up to the last bucket holding calls, each bucket below the next power of 2
+                JsonArray histogram;
+                size_t used = entry.buckets.size();
+                while (used > 0 && entry.buckets[used - 1] == 0)
+                    used--;
+                for (size_t bucket = 0; bucket < used; bucket++)
+                    histogram.Add(entry.buckets[bucket]);
+                call["histogram"] = histogram;
+
+                if (!entry.lastSlowCaller.empty())
+                {
+                    call["lastSlowCaller"] = entry.lastSlowCaller;
+                    call["lastSlowUs"] = entry.lastSlowUs;
+                }
+                calls.Add(call);
             }
-            else {
-                LOGWARN("Could not perform curl ");
+
+            response["calls"] = calls;
+            response["slowThresholdMs"] = stats.slowThresholdUs() / 1000;
+            response["shared"] = stats.shared();
+            response["dropped"] = stats.dropped();
+
+            if (parameters.HasLabel("reset") && parameters["reset"].Boolean())
+                stats.reset();
+
+            returnResponse(true);
+        }
+
+        uint32_t DeviceDiagnostics::setIARMCallSlowThreshold(const JsonObject& parameters, JsonObject& response)
+        {
+            LOGINFOMETHOD();
+
+            returnIfNumberParamNotFound(parameters, "thresholdMs");
+
+            uint32_t thresholdMs = parameters["thresholdMs"].Number();
+            if (thresholdMs == 0 || thresholdMs > UINT32_MAX / 1000)
+            {
+                LOGWARN("thresholdMs %u out of range", thresholdMs);
+                returnResponse(false);
+            }
+
+            IARMCallStats::instance().setSlowThresholdUs(thresholdMs * 1000);
+            returnResponse(true);
+        }
+
+        int DeviceDiagnostics::getConfiguration(const std::vector<std::string>& names, JsonObject& out)
+        {
+            LOGINFO("%s",__FUNCTION__);
+
+            JsonArray paramList;
+            if (!TR181Client::instance().getParameters(names, paramList))
+            {
+                LOGWARN("Could not get parameters from tr69hostif");
+                return -1;
             }
 
-            if (res == CURLE_OK && (http_code == 0 || http_code == 200))
-             {
-                 LOGWARN("curl Response: %s", response.c_str());
-
-                 JsonObject jsonHash;
-                 jsonHash.FromString(response);
-
-                 if (jsonHash.HasLabel("paramList"))
-                 {
-                    LOGWARN("key paramList present");
-                    out["paramList"] = jsonHash["paramList"];
-                    result = 0;
-                 }
-             }
-            return result;
+            out["paramList"] = paramList;
+            return 0;
         }
 
 
@@ -21,6 +21,8 @@
 
 #include <thread>
 #include <mutex>
+#include <condition_variable>
+#include <deque>
 #ifdef ENABLE_ERM
 #include <essos-resmgr.h>
 #endif
@@ -57,21 +59,39 @@ namespace WPEFramework {
             uint32_t getConfigurationWrapper(const JsonObject& parameters, JsonObject& response);
             //End methods
 
-            int getConfiguration(const std::string& postData, JsonObject& response);
+            int getConfiguration(const std::vector<std::string>& names, JsonObject& response);
             uint32_t getAVDecoderStatus(const JsonObject& parameters, JsonObject& response);
+            uint32_t getAVDecoderStatusHistory(const JsonObject& parameters, JsonObject& response);
+            uint32_t getIARMCallStats(const JsonObject& parameters, JsonObject& response);
+            uint32_t setIARMCallSlowThreshold(const JsonObject& parameters, JsonObject& response);
             int getMostActiveDecoderStatus();
             void onDecoderStatusChange(int status);
 #ifdef ENABLE_ERM
             static void *AVPollThread(void *arg);
+            bool subscribeToShellEvents();
+            void unsubscribeFromShellEvents();
+            void onShellAppEvent(const JsonObject& parameters);
 #endif
 
         private:
+            struct DecoderStatusChange
+            {
+                uint64_t timestamp; // ms since epoch
+                int status;
+            };
+
 #ifdef ENABLE_ERM
             std::thread m_AVPollThread;
             std::mutex m_AVDecoderStatusLock;
+            std::condition_variable m_AVPollCond;
             EssRMgr* m_EssRMgr;
             int m_pollThreadRun;
+            bool m_pollHint;
+            std::chrono::steady_clock::time_point m_hintExpiry;
+            std::shared_ptr<WPEFramework::JSONRPC::LinkType<WPEFramework::Core::JSON::IElement>> m_shellClient;
 #endif
+            std::mutex m_historyLock;
+            std::deque<DecoderStatusChange> m_history;
 
         public:
             DeviceDiagnostics();
@@ -507,7 +507,7 @@ namespace WPEFramework {
                 IARM_CHECK( IARM_Bus_RegisterEventHandler(IARM_BUS_DSMGR_NAME, IARM_BUS_DSMGR_EVENT_AUDIO_FADER_CONTROL_CHANGED, dsSettingsChangeEventHandler) );
                 IARM_CHECK( IARM_Bus_RegisterEventHandler(IARM_BUS_DSMGR_NAME, IARM_BUS_DSMGR_EVENT_AUDIO_PRIMARY_LANGUAGE_CHANGED, dsSettingsChangeEventHandler) );
                 IARM_CHECK( IARM_Bus_RegisterEventHandler(IARM_BUS_DSMGR_NAME, IARM_BUS_DSMGR_EVENT_AUDIO_SECONDARY_LANGUAGE_CHANGED, dsSettingsChangeEventHandler) );
-                res = IARM_Bus_Call(IARM_BUS_PWRMGR_NAME, IARM_BUS_PWRMGR_API_GetPowerState, (void *)&param, sizeof(param));
+                res = IARM_BUS_CALL(IARM_BUS_PWRMGR_NAME, IARM_BUS_PWRMGR_API_GetPowerState, (void *)&param, sizeof(param));
 
                 if (res == IARM_RESULT_SUCCESS)
                 {
@@ -1944,7 +1944,7 @@ namespace WPEFramework {
             param.isEnabled = enabled;
             strncpy(param.port, portname.c_str(), PWRMGR_MAX_VIDEO_PORT_NAME_LENGTH);
             bool success = true;
-            if(IARM_RESULT_SUCCESS != IARM_Bus_Call(IARM_BUS_PWRMGR_NAME, IARM_BUS_PWRMGR_API_SetStandbyVideoState, &param, sizeof(param)))
+            if(IARM_RESULT_SUCCESS != IARM_BUS_CALL(IARM_BUS_PWRMGR_NAME, IARM_BUS_PWRMGR_API_SetStandbyVideoState, &param, sizeof(param)))
             {
                 LOGERR("Port: %s. enable: %d", param.port, param.isEnabled);
                 response["error_message"] = "Bus failure";
@@ -1969,7 +1969,7 @@ namespace WPEFramework {
             bool success = true;
             IARM_Bus_PWRMgr_StandbyVideoState_Param_t param;
             strncpy(param.port, portname.c_str(), PWRMGR_MAX_VIDEO_PORT_NAME_LENGTH);
-            if(IARM_RESULT_SUCCESS != IARM_Bus_Call(IARM_BUS_PWRMGR_NAME, IARM_BUS_PWRMGR_API_GetStandbyVideoState, &param, sizeof(param)))
+            if(IARM_RESULT_SUCCESS != IARM_BUS_CALL(IARM_BUS_PWRMGR_NAME, IARM_BUS_PWRMGR_API_GetStandbyVideoState, &param, sizeof(param)))
             {
                 LOGERR("Port: %s. enable:%d", param.port, param.isEnabled);
                 response["error_message"] = "Bus failure";
@@ -4147,7 +4147,7 @@ namespace WPEFramework {
             IARM_Result_t res;
             IARM_Bus_PWRMgr_GetPowerState_Param_t param;
 
-            res = IARM_Bus_Call(IARM_BUS_PWRMGR_NAME, IARM_BUS_PWRMGR_API_GetPowerState, (void *)&param, sizeof(param));
+            res = IARM_BUS_CALL(IARM_BUS_PWRMGR_NAME, IARM_BUS_PWRMGR_API_GetPowerState, (void *)&param, sizeof(param));
             if (res == IARM_RESULT_SUCCESS)
             {
                 m_powerState = param.curState;
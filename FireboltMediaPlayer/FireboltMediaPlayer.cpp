@@ -51,6 +51,52 @@ namespace WPEFramework {
             return result;
         }
 
+        /**
+         * @brief The latest playback progress, from the snapshot or else from the events.
+         *
+         * The events come through the player process's connection. They are coalesced, so
+         * the position is as old as the last playbackProgressUpdate.
+         *
+         */
+        bool FireboltMediaPlayer::MediaStreamProxy::Progress(PlaybackProgress& progress) const
+        {
+            if (_snapshot.Read(progress))
+                return true;
+
+            _progressLock.Lock();
+            progress = _eventProgress;
+            _progressLock.Unlock();
+            return (progress.updatedMs != 0);
+        }
+
+        void FireboltMediaPlayer::MediaStreamProxy::UpdateProgress(const string &eventName, const string &parametersJson)
+        {
+            const bool progressUpdate = (eventName == _T("playbackProgressUpdate"));
+            if (!progressUpdate && eventName != _T("playbackStateChanged")
+                && eventName != _T("playbackSpeedChanged") && eventName != _T("bufferingChanged"))
+                return;
+
+            JsonObject parameters;
+            parameters.FromString(parametersJson);
+
+            _progressLock.Lock();
+            if (progressUpdate) {
+                _eventProgress.durationMs = parameters[_T("durationMiliseconds")].Number();
+                _eventProgress.positionMs = parameters[_T("positionMiliseconds")].Number();
+                _eventProgress.startMs = parameters[_T("startMiliseconds")].Number();
+                _eventProgress.endMs = parameters[_T("endMiliseconds")].Number();
+                _eventProgress.rate = static_cast<int32_t>(parameters[_T("playbackSpeed")].Number() * 100);
+                _eventProgress.updatedMs = PlaybackSnapshot::NowMs();
+            } else if (eventName == _T("playbackStateChanged")) {
+                _eventProgress.state = static_cast<int32_t>(parameters[_T("state")].Number());
+            } else if (eventName == _T("playbackSpeedChanged")) {
+                _eventProgress.rate = static_cast<int32_t>(strtod(parameters[_T("speed")].Value().c_str(), nullptr) * 100);
+            } else {
+                _eventProgress.buffering = parameters[_T("buffering")].Boolean();
+            }
+            _progressLock.Unlock();
+        }
+
         SERVICE_REGISTRATION(FireboltMediaPlayer, 1, 0);
 
         FireboltMediaPlayer::FireboltMediaPlayer()
@@ -149,6 +195,7 @@ namespace WPEFramework {
             Register(_T("stop"), &FireboltMediaPlayer::stop, this);
             Register(_T("initConfig"), &FireboltMediaPlayer::initConfig, this);
             Register(_T("setDRMConfig"), &FireboltMediaPlayer::setDRMConfig, this);
+            Register(_T("getPlaybackProgress"), &FireboltMediaPlayer::getPlaybackProgress, this);
         }
 
         void FireboltMediaPlayer::UnregisterAll()
@@ -162,6 +209,7 @@ namespace WPEFramework {
             Unregister(_T("stop"));
             Unregister(_T("initConfig"));
             Unregister(_T("setDRMConfig"));
+            Unregister(_T("getPlaybackProgress"));
         }
 
         uint32_t FireboltMediaPlayer::create(const JsonObject& parameters, JsonObject& response)
@@ -360,6 +408,45 @@ namespace WPEFramework {
             returnResponse((*it).second->Stream()->InitDRMConfig(parametersWithoutIdStr) == Core::ERROR_NONE);
         }
 
+        uint32_t FireboltMediaPlayer::getPlaybackProgress(const JsonObject& parameters, JsonObject& response)
+        {
+            // Polled by UIs as often as they redraw, so not logged
+            const char *keyId = "id";
+            returnIfStringParamNotFound(parameters, keyId);
+            string id = parameters[keyId].String();
+            MediaStreams::const_iterator it = _mediaStreams.find(id);
+            if (it == _mediaStreams.end()) {
+                LOGERR("Instance '%s' does not exist", id.c_str());
+                returnResponse(false);
+            }
+
+            // Read from the snapshot the stream keeps in shared memory, no call into the player process;
+            // if it is not shared, or the player died halfway through a write, from the events it sent
+            PlaybackProgress progress;
+            if (!(*it).second->Progress(progress)) {
+                returnResponse(false);
+            }
+
+            // Where playback is now, rather than at the last tick
+            int64_t positionMs = progress.positionMs;
+            if (progress.rate != 0 && !progress.buffering) {
+                positionMs += (static_cast<int64_t>(PlaybackSnapshot::NowMs() - progress.updatedMs) * progress.rate) / 100;
+                if (progress.durationMs > 0 && positionMs > progress.durationMs)
+                    positionMs = progress.durationMs;
+                if (positionMs < 0)
+                    positionMs = 0;
+            }
+
+            response[_T("durationMiliseconds")] = static_cast<int>(progress.durationMs);
+            response[_T("positionMiliseconds")] = static_cast<int>(positionMs);
+            response[_T("playbackSpeed")] = static_cast<int>(progress.rate / 100);
+            response[_T("startMiliseconds")] = static_cast<int>(progress.startMs);
+            response[_T("endMiliseconds")] = static_cast<int>(progress.endMs);
+            response[_T("state")] = static_cast<int>(progress.state);
+            response[_T("buffering")] = progress.buffering;
+            returnResponse(true);
+        }
+
         void FireboltMediaPlayer::onMediaStreamEvent(const string& id, const string &eventName, const string &parametersJson)
         {
             JsonObject parametersJsonObjWithId;
@@ -20,6 +20,7 @@
 #pragma once
 
 #include "Module.h"
+#include "PlaybackProgress.h"
 #include <interfaces/IMediaPlayer.h>
 
 namespace WPEFramework {
@@ -116,10 +117,12 @@ namespace WPEFramework {
                 MediaStreamProxy(FireboltMediaPlayer& parent, const string& id,
                         Exchange::IMediaPlayer::IMediaStream* implementation)
                 : _parent(parent), _id(id), _implementation(implementation),
-                  _mediaPlayerSink(this)
+                  _mediaPlayerSink(this), _progressLock(), _eventProgress()
                 {
                     ASSERT(implementation != nullptr);
                    _implementation->Register(&_mediaPlayerSink);
+                   // Created by the stream, if shared memory can be shared with the player process
+                   _snapshot.Open(id);
                 }
 
                 virtual ~MediaStreamProxy();
@@ -133,8 +136,11 @@ namespace WPEFramework {
 
                 uint32_t Release();
 
+                bool Progress(PlaybackProgress& progress) const;
+
                 void OnEvent(const string &eventName, const string &parametersJson)
                 {
+                    UpdateProgress(eventName, parametersJson);
                     _parent.onMediaStreamEvent(_id, eventName, parametersJson);
                 }
 
@@ -143,6 +149,12 @@ namespace WPEFramework {
                 string _id;
                 Exchange::IMediaPlayer::IMediaStream *_implementation;
                 Core::Sink<MediaStreamSink> _mediaPlayerSink;
+                PlaybackSnapshot _snapshot;
+                // From the events, for when the snapshot cannot be read
+                mutable Core::CriticalSection _progressLock;
+                PlaybackProgress _eventProgress;
+
+                void UpdateProgress(const string &eventName, const string &parametersJson);
             };
 
             typedef std::map<string, MediaStreamProxy*> MediaStreams;
@@ -161,6 +173,7 @@ namespace WPEFramework {
             uint32_t stop(const JsonObject& parameters, JsonObject& response);
             uint32_t initConfig(const JsonObject& parameters, JsonObject& response);
             uint32_t setDRMConfig(const JsonObject& parameters, JsonObject& response);
+            uint32_t getPlaybackProgress(const JsonObject& parameters, JsonObject& response);
 
             void onMediaStreamEvent(const string& id, const string &eventName, const string &parameters);
 
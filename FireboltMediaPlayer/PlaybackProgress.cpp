@@ -0,0 +1,316 @@
+/**
+ * If not stated otherwise in this file or this component's LICENSE
+ * file the following copyright and licenses apply:
+ *
+ * Copyright 2020 RDK Management
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ **/
+
+#include "PlaybackProgress.h"
+
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sched.h>
+
+#include <chrono>
+#include <new>
+
+#include <plugins/plugins.h>
+
+#define PLAYBACK_SNAPSHOT_MAGIC 0x464d5031 // "FMP1"
+
+namespace WPEFramework {
+    namespace Plugin {
+
+        static_assert(ATOMIC_LLONG_LOCK_FREE == 2, "The snapshot is shared between processes, its atomics must not need a lock");
+
+        PlaybackSnapshot::PlaybackSnapshot()
+        : _layout(nullptr)
+        , _name()
+        , _owner(false)
+        , _shared(false)
+        {
+        }
+
+        PlaybackSnapshot::~PlaybackSnapshot()
+        {
+            Close();
+        }
+
+        std::string PlaybackSnapshot::Name(const std::string& id)
+        {
+            std::string name("/FireboltMediaPlayer-");
+            for (char c : id) {
+                bool valid = (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z') || (c >= '0' && c <= '9') || c == '-' || c == '_';
+                name += (valid ? c : '_');
+            }
+            return name;
+        }
+
+        uint64_t PlaybackSnapshot::NowMs()
+        {
+            return std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+        }
+
+        bool PlaybackSnapshot::Create(const std::string& id)
+        {
+            Close();
+
+            _name = Name(id);
+            _owner = true;
+
+            void* memory = nullptr;
+            int fd = shm_open(_name.c_str(), O_CREAT | O_EXCL | O_RDWR, 0644);
+            if (fd < 0 && errno == EEXIST) {
+                // Left behind by a player of the same id that died, replaced only if it is ours
+                int stale = shm_open(_name.c_str(), O_RDONLY, 0);
+                if (stale >= 0) {
+                    struct stat st;
+                    if (fstat(stale, &st) == 0 && S_ISREG(st.st_mode) && st.st_uid == geteuid()
+                        && shm_unlink(_name.c_str()) == 0) {
+                        fd = shm_open(_name.c_str(), O_CREAT | O_EXCL | O_RDWR, 0644);
+                    }
+                    close(stale);
+                }
+            }
+            if (fd >= 0) {
+                if (ftruncate(fd, sizeof(Layout)) == 0) {
+                    memory = mmap(nullptr, sizeof(Layout), PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+                    if (memory == MAP_FAILED) {
+                        memory = nullptr;
+                    }
+                }
+                close(fd);
+                if (memory == nullptr) {
+                    shm_unlink(_name.c_str());
+                }
+            }
+
+            _shared = (memory != nullptr);
+            _layout = (_shared ? new (memory) Layout : new Layout);
+
+            _layout->sequence.store(0, std::memory_order_relaxed);
+            _layout->magic = PLAYBACK_SNAPSHOT_MAGIC;
+            return _shared;
+        }
+
+        bool PlaybackSnapshot::Open(const std::string& id)
+        {
+            Close();
+
+            int fd = shm_open(Name(id).c_str(), O_RDONLY, 0);
+            if (fd < 0) {
+                return false;
+            }
+
+            // Written by the player, running as this user; nobody else may write it
+            void* memory = nullptr;
+            struct stat st;
+            if (fstat(fd, &st) == 0 && S_ISREG(st.st_mode) && st.st_uid == geteuid()
+                && (st.st_mode & (S_IWGRP | S_IWOTH)) == 0
+                && st.st_size >= static_cast<off_t>(sizeof(Layout))) {
+                memory = mmap(nullptr, sizeof(Layout), PROT_READ, MAP_SHARED, fd, 0);
+                if (memory == MAP_FAILED) {
+                    memory = nullptr;
+                }
+            }
+            close(fd);
+
+            if (memory == nullptr) {
+                return false;
+            }
+            if (static_cast<Layout*>(memory)->magic != PLAYBACK_SNAPSHOT_MAGIC) {
+                munmap(memory, sizeof(Layout));
+                return false;
+            }
+
+            _layout = static_cast<Layout*>(memory);
+            _shared = true;
+            _owner = false;
+            return true;
+        }
+
+        void PlaybackSnapshot::Close()
+        {
+            if (_layout == nullptr) {
+                return;
+            }
+
+            if (_shared) {
+                munmap(_layout, sizeof(Layout));
+                if (_owner) {
+                    shm_unlink(_name.c_str());
+                }
+            } else {
+                delete _layout;
+            }
+            _layout = nullptr;
+            _shared = false;
+            _owner = false;
+        }
+
+        void PlaybackSnapshot::Write(const PlaybackProgress& progress)
+        {
+            if (_layout == nullptr) {
+                return;
+            }
+
+            // Odd while the fields are being written
+            uint32_t sequence = _layout->sequence.load(std::memory_order_relaxed);
+            _layout->sequence.store(sequence + 1, std::memory_order_relaxed);
+            std::atomic_thread_fence(std::memory_order_release);
+
+            _layout->durationMs.store(progress.durationMs, std::memory_order_relaxed);
+            _layout->positionMs.store(progress.positionMs, std::memory_order_relaxed);
+            _layout->startMs.store(progress.startMs, std::memory_order_relaxed);
+            _layout->endMs.store(progress.endMs, std::memory_order_relaxed);
+            _layout->rate.store(progress.rate, std::memory_order_relaxed);
+            _layout->state.store(progress.state, std::memory_order_relaxed);
+            _layout->buffering.store(progress.buffering ? 1 : 0, std::memory_order_relaxed);
+            _layout->updatedMs.store(progress.updatedMs, std::memory_order_relaxed);
+
+            _layout->sequence.store(sequence + 2, std::memory_order_release);
+        }
+
+        bool PlaybackSnapshot::Read(PlaybackProgress& progress) const
+        {
+            if (_layout == nullptr) {
+                return false;
+            }
+
+            for (uint32_t attempt = 0; attempt < PLAYBACK_SNAPSHOT_READ_ATTEMPTS; attempt++) {
+                uint32_t before = _layout->sequence.load(std::memory_order_acquire);
+                if (before == 0) {
+                    // Nothing written yet
+                    return false;
+                }
+
+                if ((before & 1) == 0) {
+                    progress.durationMs = _layout->durationMs.load(std::memory_order_relaxed);
+                    progress.positionMs = _layout->positionMs.load(std::memory_order_relaxed);
+                    progress.startMs = _layout->startMs.load(std::memory_order_relaxed);
+                    progress.endMs = _layout->endMs.load(std::memory_order_relaxed);
+                    progress.rate = _layout->rate.load(std::memory_order_relaxed);
+                    progress.state = _layout->state.load(std::memory_order_relaxed);
+                    progress.buffering = (_layout->buffering.load(std::memory_order_relaxed) != 0);
+                    progress.updatedMs = _layout->updatedMs.load(std::memory_order_relaxed);
+
+                    std::atomic_thread_fence(std::memory_order_acquire);
+                    if (_layout->sequence.load(std::memory_order_relaxed) == before) {
+                        return true;
+                    }
+                }
+
+                // The writer was preempted halfway, let it finish
+                if (attempt >= 16) {
+                    sched_yield();
+                }
+            }
+
+            // Still halfway: the writer is stuck or gone, the caller asks the player instead
+            return false;
+        }
+
+        ProgressCoalescer::ProgressCoalescer(uint32_t intervalMs)
+        : _intervalMs(intervalMs)
+        , _reset(true)
+        , _last()
+        , _ticks(0)
+        , _sent(0)
+        {
+        }
+
+        bool ProgressCoalescer::Update(const PlaybackProgress& progress)
+        {
+            _ticks++;
+
+            uint32_t intervalMs = _intervalMs;
+            bool send = _reset.exchange(false) || (intervalMs == 0) || (progress.rate != _last.rate);
+
+            if (!send) {
+                int64_t elapsedMs = static_cast<int64_t>(progress.updatedMs - _last.updatedMs);
+                int64_t expectedMs = _last.positionMs + (elapsedMs * _last.rate) / 100;
+                int64_t offMs = progress.positionMs - expectedMs;
+
+                // Ticks arrive a little early as often as late, 5% slack keeps a matching interval from halving the rate
+                send = (offMs > PROGRESS_JUMP_MS) || (offMs < -PROGRESS_JUMP_MS)
+                    || (elapsedMs + intervalMs / 20 >= intervalMs);
+            }
+
+            if (send) {
+                _last = progress;
+                _sent++;
+            }
+            return send;
+        }
+
+        ProgressTracker::ProgressTracker()
+        : _lock()
+        , _progress()
+        , _snapshot()
+        , _events()
+        {
+        }
+
+        bool ProgressTracker::Tick(const PlaybackProgress& tick, std::string& parameters)
+        {
+            std::unique_lock<std::mutex> lock(_lock);
+            _progress.durationMs = tick.durationMs;
+            _progress.positionMs = tick.positionMs;
+            _progress.startMs = tick.startMs;
+            _progress.endMs = tick.endMs;
+            _progress.rate = tick.rate;
+            _progress.updatedMs = tick.updatedMs;
+            _snapshot.Write(_progress);
+            if (!_events.Update(_progress)) {
+                return false;
+            }
+            lock.unlock();
+
+            JsonObject event;
+            event[_T("durationMiliseconds")] = static_cast<int>(tick.durationMs);
+            event[_T("positionMiliseconds")] = static_cast<int>(tick.positionMs);
+            event[_T("playbackSpeed")] = static_cast<int>(tick.rate / 100);
+            event[_T("startMiliseconds")] = static_cast<int>(tick.startMs);
+            event[_T("endMiliseconds")] = static_cast<int>(tick.endMs);
+            event.ToString(parameters);
+            return true;
+        }
+
+        void ProgressTracker::Rate(int32_t rate)
+        {
+            std::lock_guard<std::mutex> lock(_lock);
+            _progress.rate = rate;
+            _snapshot.Write(_progress);
+        }
+
+        void ProgressTracker::State(int32_t state)
+        {
+            std::lock_guard<std::mutex> lock(_lock);
+            _progress.state = state;
+            _snapshot.Write(_progress);
+        }
+
+        void ProgressTracker::Buffering(bool buffering)
+        {
+            std::lock_guard<std::mutex> lock(_lock);
+            _progress.buffering = buffering;
+            _snapshot.Write(_progress);
+        }
+
+    }
+}
@@ -0,0 +1,206 @@
+/**
+ * If not stated otherwise in this file or this component's LICENSE
+ * file the following copyright and licenses apply:
+ *
+ * Copyright 2020 RDK Management
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ **/
+
+#pragma once
+
+#include <stdint.h>
+#include <atomic>
+#include <mutex>
+#include <string>
+
+// Progress events are sent at most this often, unless the rate changes or the position jumps
+#define PROGRESS_EVENT_INTERVAL_MS 1000
+// A position further than this from where playback should be is a seek, or a discontinuity
+#define PROGRESS_JUMP_MS 1000
+// Reads that find the writer halfway through before giving up, the writer may have died there
+#define PLAYBACK_SNAPSHOT_READ_ATTEMPTS 64
+
+namespace WPEFramework {
+    namespace Plugin {
+
+        struct PlaybackProgress {
+            PlaybackProgress()
+            : durationMs(0), positionMs(0), startMs(0), endMs(0)
+            , rate(0), state(0), buffering(false), updatedMs(0)
+            {
+            }
+
+            int64_t durationMs;
+            int64_t positionMs;
+            int64_t startMs;
+            int64_t endMs;
+            int32_t rate;       // in hundredths, as passed to SetRate
+            int32_t state;      // AAMP player state
+            bool buffering;
+            uint64_t updatedMs; // steady clock, when the position was reported
+        };
+
+        /**
+         * @brief The latest playback progress of a stream, in shared memory.
+         *
+         * The stream writes it on every progress tick; readers, in any process, read it
+         * without locking and without a call into the player process (seqlock). Readers
+         * never delay the writer or each other. If shared memory is not available the
+         * writer keeps the snapshot in private memory.
+         *
+         * The segment is created for the stream alone, and only opened if it belongs to
+         * this user and no one else can write to it. A read fails, rather than waits, if
+         * the writer stays halfway through a write: the player process may have died there.
+         *
+         */
+        class PlaybackSnapshot {
+        public:
+            PlaybackSnapshot();
+            ~PlaybackSnapshot();
+
+            PlaybackSnapshot(const PlaybackSnapshot&) = delete;
+            PlaybackSnapshot& operator=(const PlaybackSnapshot&) = delete;
+
+            static std::string Name(const std::string& id);
+            static uint64_t NowMs();
+
+            // Writer side, one per stream
+            bool Create(const std::string& id);
+            void Write(const PlaybackProgress& progress);
+
+            // Reader side
+            bool Open(const std::string& id);
+            bool Read(PlaybackProgress& progress) const;
+
+            bool IsOpen() const
+            {
+                return (_layout != nullptr);
+            }
+            void Close();
+
+        private:
+            struct Layout {
+                uint32_t magic;
+                std::atomic<uint32_t> sequence;
+                std::atomic<int64_t> durationMs;
+                std::atomic<int64_t> positionMs;
+                std::atomic<int64_t> startMs;
+                std::atomic<int64_t> endMs;
+                std::atomic<int32_t> rate;
+                std::atomic<int32_t> state;
+                std::atomic<int32_t> buffering;
+                std::atomic<uint64_t> updatedMs;
+            };
+
+            Layout* _layout;
+            std::string _name;
+            bool _owner;
+            bool _shared;
+        };
+
+        /**
+         * @brief Decides which progress ticks are worth an event.
+         *
+         * A tick is sent when the rate changed, when the position is not where playback
+         * should have taken it (seek, discontinuity) or when the interval has passed since
+         * the last one sent. An interval of 0 sends every tick.
+         *
+         */
+        class ProgressCoalescer {
+        public:
+            explicit ProgressCoalescer(uint32_t intervalMs = PROGRESS_EVENT_INTERVAL_MS);
+
+            ProgressCoalescer(const ProgressCoalescer&) = delete;
+            ProgressCoalescer& operator=(const ProgressCoalescer&) = delete;
+
+            void Interval(uint32_t intervalMs)
+            {
+                _intervalMs = intervalMs;
+            }
+            // The next tick is sent, whatever it holds
+            void Reset()
+            {
+                _reset = true;
+            }
+
+            bool Update(const PlaybackProgress& progress);
+
+            uint32_t Ticks() const
+            {
+                return _ticks;
+            }
+            uint32_t Sent() const
+            {
+                return _sent;
+            }
+
+        private:
+            std::atomic<uint32_t> _intervalMs;
+            std::atomic<bool> _reset;
+            PlaybackProgress _last;
+            uint32_t _ticks;
+            uint32_t _sent;
+        };
+
+        /**
+         * @brief The progress of one stream, as the player reports it.
+         *
+         * Progress ticks and rate, state and buffering changes go into the snapshot as
+         * they arrive. A tick worth an event comes back with its playbackProgressUpdate
+         * parameters.
+         *
+         */
+        class ProgressTracker {
+        public:
+            ProgressTracker();
+
+            ProgressTracker(const ProgressTracker&) = delete;
+            ProgressTracker& operator=(const ProgressTracker&) = delete;
+
+            bool Create(const std::string& id)
+            {
+                return _snapshot.Create(id);
+            }
+            void Interval(uint32_t intervalMs)
+            {
+                _events.Interval(intervalMs);
+            }
+            void Reset()
+            {
+                _events.Reset();
+            }
+
+            bool Tick(const PlaybackProgress& tick, std::string& parameters);
+            void Rate(int32_t rate);
+            void State(int32_t state);
+            void Buffering(bool buffering);
+
+            uint32_t Ticks() const
+            {
+                return _events.Ticks();
+            }
+            uint32_t Sent() const
+            {
+                return _events.Sent();
+            }
+
+        private:
+            std::mutex _lock;
+            PlaybackProgress _progress;
+            PlaybackSnapshot _snapshot;
+            ProgressCoalescer _events;
+        };
+
+    }
+}
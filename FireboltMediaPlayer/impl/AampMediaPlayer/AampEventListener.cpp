@@ -37,7 +37,9 @@ namespace WPEFramework {
 
         void AampEventListener::Event(const AAMPEvent& event)
         {
-            LOGINFO("Event: handling event: %d", event.type);
+            // Progress ticks are too frequent to log
+            if (event.type != AAMP_EVENT_PROGRESS)
+                LOGINFO("Event: handling event: %d", event.type);
             switch(event.type)
             {
             case AAMP_EVENT_TUNED:
@@ -70,6 +72,8 @@ namespace WPEFramework {
 
         void AampEventListener::HandlePlaybackStateChangedEvent(const AAMPEvent& event)
         {
+            _parent.UpdateState(static_cast<int32_t>(event.data.stateChanged.state));
+
             JsonObject parameters;
             parameters[_T("state")] = static_cast<int>(event.data.stateChanged.state);
 
@@ -80,20 +84,24 @@ namespace WPEFramework {
 
         void AampEventListener::HandlePlaybackProgressUpdateEvent(const AAMPEvent& event)
         {
-            JsonObject parameters;
-            parameters[_T("durationMiliseconds")] = static_cast<int>(event.data.progress.durationMiliseconds);
-            parameters[_T("positionMiliseconds")] = static_cast<int>(event.data.progress.positionMiliseconds);
-            parameters[_T("playbackSpeed")] = static_cast<int>(event.data.progress.playbackSpeed);
-            parameters[_T("startMiliseconds")] = static_cast<int>(event.data.progress.startMiliseconds);
-            parameters[_T("endMiliseconds")] = static_cast<int>(event.data.progress.endMiliseconds);
-
+            PlaybackProgress tick;
+            tick.durationMs = static_cast<int64_t>(event.data.progress.durationMiliseconds);
+            tick.positionMs = static_cast<int64_t>(event.data.progress.positionMiliseconds);
+            tick.startMs = static_cast<int64_t>(event.data.progress.startMiliseconds);
+            tick.endMs = static_cast<int64_t>(event.data.progress.endMiliseconds);
+            tick.rate = static_cast<int32_t>(event.data.progress.playbackSpeed * 100);
+            tick.updatedMs = PlaybackSnapshot::NowMs();
+
+            // Every tick is in the snapshot, only the ones that tell something new go out as events
             string s;
-            parameters.ToString(s);
-            _parent.SendEvent(_T("playbackProgressUpdate"), s);
+            if (_parent.UpdateProgress(tick, s))
+                _parent.SendEvent(_T("playbackProgressUpdate"), s);
         }
 
         void AampEventListener::HandleBufferingChangedEvent(const AAMPEvent& event)
         {
+            _parent.UpdateBuffering(event.data.bufferingChanged.buffering);
+
             JsonObject parameters;
             parameters[_T("buffering")] = event.data.bufferingChanged.buffering;
 
@@ -104,6 +112,8 @@ namespace WPEFramework {
 
         void AampEventListener::HandlePlaybackSpeedChanged(const AAMPEvent& event)
         {
+            _parent.UpdateRate(static_cast<int32_t>(event.data.speedChanged.rate * 100));
+
             JsonObject parameters;
             parameters[_T("speed")] = event.data.speedChanged.rate;
 
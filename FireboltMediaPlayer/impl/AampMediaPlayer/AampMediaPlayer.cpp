@@ -43,7 +43,7 @@ namespace WPEFramework {
         Exchange::IMediaPlayer::IMediaStream* AampMediaPlayer::CreateStream(const string& id)
         {
             LOGINFO("Create with id: %s", id.c_str());
-            return Core::Service<AampMediaStream>::Create<IMediaPlayer::IMediaStream>();
+            return Core::Service<AampMediaStream>::Create<IMediaPlayer::IMediaStream>(id);
         }
 
     }//Plugin
@@ -527,14 +527,19 @@ namespace WPEFramework {
     namespace Plugin {
 
 
-        AampMediaStream::AampMediaStream()
+        AampMediaStream::AampMediaStream(const string& id)
         : _adminLock()
 	, _notificationRelease() //Lock
         , _notification(nullptr)
         , _aampPlayer(nullptr)
         , _aampEventListener(nullptr)
         , _aampGstPlayerMainLoop(nullptr)
+        , _progress()
         {
+            if (!_progress.Create(id)) {
+                LOGWARN("Playback progress of '%s' is not shared, shared memory is not available", id.c_str());
+            }
+
             gst_init(0, nullptr);
             _aampPlayer = new PlayerInstanceAAMP();
             if(_aampPlayer == nullptr)
@@ -600,6 +605,7 @@ namespace WPEFramework {
             _adminLock.Lock();
 
             ASSERT(_aampPlayer != nullptr);
+            _progress.Reset();
             _aampPlayer->Tune(url.c_str(), autoPlay);
 
             _adminLock.Unlock();
@@ -624,6 +630,7 @@ namespace WPEFramework {
             LOGINFO("SetPosition with pos=%d sec", positionSec);
             _adminLock.Lock();
             ASSERT(_aampPlayer != nullptr);
+            _progress.Reset();
             _aampPlayer->Seek(static_cast<double>(positionSec));
             _adminLock.Unlock();
             return Core::ERROR_NONE;
@@ -654,6 +661,7 @@ namespace WPEFramework {
             string const langCodePreferenceLabel("langCodePreference");
             string const descriptiveTrackNameLabel("descriptiveTrackName");
             string const enableVideoRectangleLabel("enableVideoRectangle");
+            string const progressEventIntervalLabel("progressEventInterval");
             JsonObject const config(configurationJson);
             JsonObject::Iterator it = config.Variants();
             while (it.Next())
@@ -671,6 +679,14 @@ namespace WPEFramework {
                     (void)Settings::extractSetting(descriptiveTrackNameLabel, it.Current(), descriptiveTrackNameValue);
                 else if (label == enableVideoRectangleLabel)
                     enableVideoRectangleSet = Settings::extractSetting(descriptiveTrackNameLabel, it.Current(), enableVideoRectangleValue);
+                else if (label == progressEventIntervalLabel) {
+                    // Not an AAMP setting: seconds between progress events, the snapshot still gets every tick. 0 sends every tick.
+                    double progressEventIntervalValue;
+                    if (Settings::extractSetting(progressEventIntervalLabel, it.Current(), progressEventIntervalValue) && progressEventIntervalValue >= 0) {
+                        LOGINFO("Progress events at most every %lf s", progressEventIntervalValue);
+                        _progress.Interval(static_cast<uint32_t>(progressEventIntervalValue * 1000));
+                    }
+                }
                 else
                     ConfigurationSettings::getInstance().apply(_aampPlayer, label, it.Current());
             }
@@ -757,6 +773,26 @@ namespace WPEFramework {
 	    _notificationRelease.Unlock();
         }
 
+        bool AampMediaStream::UpdateProgress(const PlaybackProgress& tick, string& parameters)
+        {
+            return _progress.Tick(tick, parameters);
+        }
+
+        void AampMediaStream::UpdateRate(int32_t rate)
+        {
+            _progress.Rate(rate);
+        }
+
+        void AampMediaStream::UpdateState(int32_t state)
+        {
+            _progress.State(state);
+        }
+
+        void AampMediaStream::UpdateBuffering(bool buffering)
+        {
+            _progress.Buffering(buffering);
+        }
+
         // Thread overrides
         uint32_t AampMediaStream::Worker()
         {
@@ -21,6 +21,7 @@
 
 #include "Module.h"
 #include "AampEventListener.h"
+#include "PlaybackProgress.h"
 
 #include <interfaces/IMediaPlayer.h>
 #include <gst/gst.h>
@@ -31,7 +32,7 @@ namespace WPEFramework {
 
         class AampMediaStream : public Exchange::IMediaPlayer::IMediaStream, Core::Thread {
         public:
-            AampMediaStream();
+            AampMediaStream(const string& id);
             ~AampMediaStream() override;
 
             AampMediaStream(const AampMediaStream&) = delete;
@@ -53,6 +54,12 @@ namespace WPEFramework {
 
             void SendEvent(const string& eventName, const string& parameters);
 
+            // Progress snapshot, returns whether the tick is to be sent as an event, and its parameters
+            bool UpdateProgress(const PlaybackProgress& tick, string& parameters);
+            void UpdateRate(int32_t rate);
+            void UpdateState(int32_t state);
+            void UpdateBuffering(bool buffering);
+
         private:
             typedef struct _GMainLoop GMainLoop;
 
@@ -64,6 +71,8 @@ namespace WPEFramework {
             PlayerInstanceAAMP *_aampPlayer;
             AampEventListener *_aampEventListener;
             GMainLoop *_aampGstPlayerMainLoop;
+
+            ProgressTracker _progress;
         };
 
     }
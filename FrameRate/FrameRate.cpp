@@ -35,17 +35,24 @@
 #define METHOD_GET_FRAME_MODE "getFrmMode"
 #define METHOD_GET_DISPLAY_FRAME_RATE "getDisplayFrameRate"
 #define METHOD_SET_DISPLAY_FRAME_RATE "setDisplayFrameRate"
+#define METHOD_UPDATE_FRAME_TIMES "updateFrameTimes"
+#define METHOD_GET_FRAME_TIMING_REPORT "getFrameTimingReport"
 
 // Events
 #define EVENT_FPS_UPDATE "onFpsEvent"
 #define EVENT_FRAMERATE_PRECHANGE  "onDisplayFrameRateChanging"
 #define EVENT_FRAMERATE_POSTCHANGE    "onDisplayFrameRateChanged"
+#define EVENT_FRAME_TIMING_REPORT "onFrameTimingReport"
 
 //Defines
 #define DEFAULT_FPS_COLLECTION_TIME_IN_MILLISECONDS 10000
 #define MINIMUM_FPS_COLLECTION_TIME_IN_MILLISECONDS 100
 #define DEFAULT_MIN_FPS_VALUE 60
 #define DEFAULT_MAX_FPS_VALUE -1
+#define SHELL_SUBSCRIBE_RETRY_MS 30000
+
+#define SERVER_DETAILS  "127.0.0.1:9998"
+#define RDKSHELL_CALLSIGN_VER "org.rdk.RDKShell.1"
 
 namespace WPEFramework
 {
@@ -60,6 +67,8 @@ namespace WPEFramework
           , m_fpsCollectionFrequencyInMs(DEFAULT_FPS_COLLECTION_TIME_IN_MILLISECONDS)
           , m_minFpsValue(DEFAULT_MIN_FPS_VALUE), m_maxFpsValue(DEFAULT_MAX_FPS_VALUE)
           , m_totalFpsValues(0), m_numberOfFpsUpdates(0), m_fpsCollectionInProgress(false), m_lastFpsValue(-1)
+          , m_shellSubscribed(false)
+          , m_shellJob(*this)
         {
             FrameRate::_instance = this;
 
@@ -71,6 +80,8 @@ namespace WPEFramework
             registerMethod(METHOD_GET_FRAME_MODE, &FrameRate::getFrmMode, this, {2});
             registerMethod(METHOD_GET_DISPLAY_FRAME_RATE, &FrameRate::getDisplayFrameRate, this, {2});
             registerMethod(METHOD_SET_DISPLAY_FRAME_RATE, &FrameRate::setDisplayFrameRate, this, {2});		
+            registerMethod(METHOD_UPDATE_FRAME_TIMES, &FrameRate::updateFrameTimesWrapper, this, {2});
+            registerMethod(METHOD_GET_FRAME_TIMING_REPORT, &FrameRate::getFrameTimingReportWrapper, this, {2});
 
             m_reportFpsTimer.connect( std::bind( &FrameRate::onReportFpsTimer, this ) );
         }
@@ -82,6 +93,7 @@ namespace WPEFramework
 	const string FrameRate::Initialize(PluginHost::IShell * /* service */)
         {
 		InitializeIARM();
+                updateVsyncInterval();
                 return "";
         }
 
@@ -110,6 +122,8 @@ namespace WPEFramework
         void FrameRate::Deinitialize(PluginHost::IShell* /* service */)
         {
 		DeinitializeIARM();
+                m_shellJob.Revoke();
+                unsubscribeFromShellEvents();
     		FrameRate::_instance = nullptr;
         }
 
@@ -148,6 +162,9 @@ namespace WPEFramework
         
         uint32_t FrameRate::startFpsCollectionWrapper(const JsonObject& parameters, JsonObject& response)
         {
+            if (!m_shellSubscribed)
+                m_shellJob.Submit();
+
             std::lock_guard<std::mutex> guard(m_callMutex);
 
             LOGINFOMETHOD();
@@ -180,6 +197,87 @@ namespace WPEFramework
             returnResponse(true);
         }
         
+        uint32_t FrameRate::updateFrameTimesWrapper(const JsonObject& parameters, JsonObject& response)
+        {
+            std::lock_guard<std::mutex> guard(m_callMutex);
+
+            returnIfParamNotFound(parameters, "frameIntervals");
+
+            if (!m_fpsCollectionInProgress)
+            {
+                returnResponse(false);
+            }
+
+            const JsonArray intervals = parameters["frameIntervals"].Array();
+            for (int i = 0; i < intervals.Length(); i++)
+            {
+                int64_t intervalUs = intervals[i].Number();
+                if (intervalUs > 0)
+                {
+                    m_frameTiming.record(intervalUs > UINT32_MAX ? UINT32_MAX : static_cast<uint32_t>(intervalUs));
+                }
+            }
+
+            returnResponse(true);
+        }
+
+        static JsonObject frameTimingToJson(const FrameTimingReport& report)
+        {
+            JsonObject json;
+            json["frames"] = report.frames;
+            json["longFrames"] = report.longFrames;
+            json["min"] = report.minUs;
+            json["max"] = report.maxUs;
+            json["average"] = report.meanUs;
+            json["p50"] = report.p50Us;
+            json["p95"] = report.p95Us;
+            json["p99"] = report.p99Us;
+            return json;
+        }
+
+        uint32_t FrameRate::getFrameTimingReportWrapper(const JsonObject& parameters, JsonObject& response)
+        {
+            std::lock_guard<std::mutex> guard(m_callMutex);
+
+            LOGINFOMETHOD();
+
+            FrameTimingReport report;
+            if (parameters.HasLabel("app"))
+            {
+                string app = parameters["app"].String();
+                if (!m_frameTiming.appReport(app, report))
+                {
+                    LOGWARN("No frame timing for %s", app.c_str());
+                    returnResponse(false);
+                }
+                response["app"] = app;
+                response["total"] = frameTimingToJson(report);
+                returnResponse(true);
+            }
+
+            response["vsyncInterval"] = m_frameTiming.vsyncInterval();
+            response["focusedApp"] = m_frameTiming.focusedApp();
+            m_frameTiming.windowReport(report);
+            response["window"] = frameTimingToJson(report);
+            m_frameTiming.totalReport(report);
+            response["total"] = frameTimingToJson(report);
+
+            JsonArray apps;
+            for (size_t i = 0; i < m_frameTiming.apps(); i++)
+            {
+                string app;
+                if (m_frameTiming.appAt(i, app, report))
+                {
+                    JsonObject entry = frameTimingToJson(report);
+                    entry["app"] = app;
+                    apps.Add(entry);
+                }
+            }
+            response["apps"] = apps;
+
+            returnResponse(true);
+        }
+
 	uint32_t FrameRate::setFrmMode(const JsonObject& parameters, JsonObject& response)
         {
             std::lock_guard<std::mutex> guard(m_callMutex);
@@ -322,6 +420,7 @@ namespace WPEFramework
             m_maxFpsValue = DEFAULT_MAX_FPS_VALUE;
             m_totalFpsValues = 0;
             m_numberOfFpsUpdates = 0;
+            m_frameTiming.reset();
             m_fpsCollectionInProgress = true;
             int fpsCollectionFrequency = m_fpsCollectionFrequencyInMs;
             if (fpsCollectionFrequency < MINIMUM_FPS_COLLECTION_TIME_IN_MILLISECONDS)
@@ -360,6 +459,7 @@ namespace WPEFramework
                 maxFps = m_maxFpsValue;
                 fpsCollectionUpdate(averageFps, minFps, maxFps);
                 }
+                frameTimingUpdate();
                 disableFpsCollection();
             }
             return true;
@@ -396,8 +496,32 @@ namespace WPEFramework
             sendNotify(EVENT_FPS_UPDATE, params);
         }
         
+        /**
+        * @brief Sends the frame times of the window that just ended, if there were any, and starts a new one.
+        */
+        void FrameRate::frameTimingUpdate()
+        {
+            FrameTimingReport report;
+            m_frameTiming.windowReport(report);
+            m_frameTiming.resetWindow();
+            if (report.frames == 0)
+            {
+                return;
+            }
+
+            JsonObject params = frameTimingToJson(report);
+            params["vsyncInterval"] = m_frameTiming.vsyncInterval();
+            params["app"] = m_frameTiming.focusedApp();
+
+            sendNotify(EVENT_FRAME_TIMING_REPORT, params);
+        }
+
         void FrameRate::onReportFpsTimer()
         {
+            // RDKShell may have come up after the collection started
+            if (!m_shellSubscribed)
+                m_shellJob.Submit();
+
             std::lock_guard<std::mutex> guard(m_callMutex);
             
             int averageFps = -1;
@@ -410,6 +534,7 @@ namespace WPEFramework
                 maxFps = m_maxFpsValue;
             }
             fpsCollectionUpdate(averageFps, minFps, maxFps);
+            frameTimingUpdate();
             if (m_lastFpsValue >= 0)
             {
                 // store the last fps value just in case there are no updates
@@ -450,9 +575,107 @@ namespace WPEFramework
 
         void FrameRate::frameRatePostChange()
         {
+            {
+                std::lock_guard<std::mutex> guard(m_callMutex);
+                updateVsyncInterval();
+            }
             sendNotify(EVENT_FRAMERATE_POSTCHANGE, JsonObject());
         }
 
+        /**
+        * @brief Long frames are counted against the display refresh rate, taken from the
+        * display frame rate ("3840x2160px48"). Keeps the previous interval if it can't be read.
+        */
+        void FrameRate::updateVsyncInterval()
+        {
+            char sFramerate[20] = {0};
+            try
+            {
+                device::VideoDevice &device = device::Host::getInstance().getVideoDevices().at(0);
+                device.getCurrentDisframerate(sFramerate);
+            }
+            catch (const device::Exception& err)
+            {
+                LOG_DEVICE_EXCEPTION0();
+                return;
+            }
+
+            const char* rate = strstr(sFramerate, "px");
+            double hz = (rate != nullptr ? atof(rate + 2) : 0);
+            if (hz > 0)
+            {
+                m_frameTiming.setVsyncInterval(static_cast<uint32_t>(1000000 / hz + 0.5));
+            }
+        }
+
+        void FrameRate::Dispatch()
+        {
+            subscribeToShellEvents();
+        }
+
+        /**
+        * @brief Frames are counted against the app RDKShell last gave focus with setFocus, which
+        * launch also uses. Focus the compositor moves on its own, e.g. to the next app when the
+        * focused one is killed, is not announced: frames count for no app from the destruction
+        * of the focused app until the next onFocus.
+        */
+        void FrameRate::subscribeToShellEvents()
+        {
+            std::lock_guard<std::mutex> lock(m_shellMutex);
+
+            if (m_shellSubscribed || std::chrono::steady_clock::now() < m_nextShellSubscribe)
+                return;
+            m_nextShellSubscribe = std::chrono::steady_clock::now() + std::chrono::milliseconds(SHELL_SUBSCRIBE_RETRY_MS);
+
+            Core::SystemInfo::SetEnvironment(_T("THUNDER_ACCESS"), (_T(SERVER_DETAILS)));
+            if (nullptr == m_shellClient)
+                m_shellClient = make_shared<WPEFramework::JSONRPC::LinkType<Core::JSON::IElement>>(_T(RDKSHELL_CALLSIGN_VER), (_T(RDKSHELL_CALLSIGN_VER)));
+
+            uint32_t err = m_shellClient->Subscribe<JsonObject>(1000, _T("onFocus"), &FrameRate::onShellFocus, this);
+            if (err != Core::ERROR_NONE)
+            {
+                LOGWARN("Failed to subscribe for onFocus with code %d, no per app frame timing", err);
+                return;
+            }
+            err = m_shellClient->Subscribe<JsonObject>(1000, _T("onDestroyed"), &FrameRate::onShellDestroyed, this);
+            if (err != Core::ERROR_NONE)
+            {
+                LOGWARN("Failed to subscribe for onDestroyed with code %d, frames of a destroyed app may count for it", err);
+            }
+
+            m_shellSubscribed = true;
+            LOGINFO("Subscribed for RDKShell focus events");
+        }
+
+        void FrameRate::unsubscribeFromShellEvents()
+        {
+            std::lock_guard<std::mutex> lock(m_shellMutex);
+
+            if (nullptr == m_shellClient)
+                return;
+
+            if (m_shellSubscribed)
+            {
+                m_shellClient->Unsubscribe(1000, _T("onFocus"));
+                m_shellClient->Unsubscribe(1000, _T("onDestroyed"));
+            }
+            m_shellClient.reset();
+            m_shellSubscribed = false;
+        }
+
+        void FrameRate::onShellFocus(const JsonObject& parameters)
+        {
+            std::lock_guard<std::mutex> guard(m_callMutex);
+            m_frameTiming.setFocusedApp(parameters["client"].String());
+        }
+
+        void FrameRate::onShellDestroyed(const JsonObject& parameters)
+        {
+            std::lock_guard<std::mutex> guard(m_callMutex);
+            if (m_frameTiming.focusedApp() == parameters["client"].String())
+                m_frameTiming.setFocusedApp("");
+        }
+
         
     } // namespace Plugin
 } // namespace WPEFramework
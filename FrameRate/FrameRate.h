@@ -19,9 +19,13 @@
 
 #pragma once
 
+#include <atomic>
 #include <mutex>
+#include <memory>
+#include <chrono>
 
 #include "Module.h"
+#include "FrameTiming.h"
 #include "tptimer.h"
 #include "utils.h"
 #include "AbstractPlugin.h"
@@ -58,6 +62,8 @@ namespace WPEFramework {
 	    uint32_t getFrmMode(const JsonObject& parameters, JsonObject& response);
 	    uint32_t getDisplayFrameRate(const JsonObject& parameters, JsonObject& response);
 	    uint32_t setDisplayFrameRate(const JsonObject& parameters, JsonObject& response);
+            uint32_t updateFrameTimesWrapper(const JsonObject& parameters, JsonObject& response);
+            uint32_t getFrameTimingReportWrapper(const JsonObject& parameters, JsonObject& response);
 	    //End methods
             
             int getCollectionFrequency();
@@ -67,6 +73,17 @@ namespace WPEFramework {
             void updateFps(int newFpsValue);
 
             void fpsCollectionUpdate( int averageFps, int minFps, int maxFps );
+            void frameTimingUpdate();
+            void updateVsyncInterval();
+
+            void subscribeToShellEvents();
+            void unsubscribeFromShellEvents();
+            void onShellFocus(const JsonObject& parameters);
+            void onShellDestroyed(const JsonObject& parameters);
+
+            // Subscribes on the worker pool, the JSON-RPC call waits for RDKShell
+            friend Core::ThreadPool::JobType<FrameRate&>;
+            void Dispatch();
             
             virtual void enableFpsCollection() {}
             virtual void disableFpsCollection() {}
@@ -102,8 +119,15 @@ namespace WPEFramework {
             //QTimer m_reportFpsTimer;
             TpTimer m_reportFpsTimer;
             int m_lastFpsValue;
+            FrameTiming m_frameTiming;
             
             std::mutex m_callMutex;
+
+            std::mutex m_shellMutex;
+            std::shared_ptr<WPEFramework::JSONRPC::LinkType<Core::JSON::IElement>> m_shellClient;
+            std::atomic<bool> m_shellSubscribed;
+            std::chrono::steady_clock::time_point m_nextShellSubscribe;
+            Core::WorkerPool::JobType<FrameRate&> m_shellJob;
         };
     } // namespace Plugin
 } // namespace WPEFramework
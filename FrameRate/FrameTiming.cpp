@@ -0,0 +1,272 @@
+/**
+* If not stated otherwise in this file or this component's LICENSE
+* file the following copyright and licenses apply:
+*
+* Copyright 2019 RDK Management
+*
+* Licensed under the Apache License, Version 2.0 (the "License");
+* you may not use this file except in compliance with the License.
+* You may obtain a copy of the License at
+*
+* http://www.apache.org/licenses/LICENSE-2.0
+*
+* Unless required by applicable law or agreed to in writing, software
+* distributed under the License is distributed on an "AS IS" BASIS,
+* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+* See the License for the specific language governing permissions and
+* limitations under the License.
+**/
+
+#include "FrameTiming.h"
+
+#include <string.h>
+
+#define SUB_BUCKETS (1u << FRAME_TIMING_SUB_BUCKET_BITS)
+
+namespace WPEFramework
+{
+    namespace Plugin
+    {
+        FrameTimingHistogram::FrameTimingHistogram()
+        {
+            reset();
+        }
+
+        uint32_t FrameTimingHistogram::bucketOf(uint32_t intervalUs)
+        {
+            if (intervalUs < SUB_BUCKETS)
+            {
+                return intervalUs;
+            }
+
+            uint32_t exponent = 31 - __builtin_clz(intervalUs);
+            if (exponent > FRAME_TIMING_MAX_EXPONENT)
+            {
+                return FRAME_TIMING_BUCKETS - 1;
+            }
+
+            uint32_t shift = exponent - FRAME_TIMING_SUB_BUCKET_BITS;
+            return ((shift + 1) << FRAME_TIMING_SUB_BUCKET_BITS) + ((intervalUs >> shift) & (SUB_BUCKETS - 1));
+        }
+
+        uint32_t FrameTimingHistogram::lowestOf(uint32_t bucket)
+        {
+            if (bucket < SUB_BUCKETS)
+            {
+                return bucket;
+            }
+
+            uint32_t shift = (bucket >> FRAME_TIMING_SUB_BUCKET_BITS) - 1;
+            return (SUB_BUCKETS + (bucket & (SUB_BUCKETS - 1))) << shift;
+        }
+
+        uint32_t FrameTimingHistogram::highestOf(uint32_t bucket)
+        {
+            if (bucket < SUB_BUCKETS)
+            {
+                return bucket;
+            }
+
+            uint32_t shift = (bucket >> FRAME_TIMING_SUB_BUCKET_BITS) - 1;
+            return lowestOf(bucket) + (1u << shift) - 1;
+        }
+
+        void FrameTimingHistogram::record(uint32_t intervalUs, bool longFrame)
+        {
+            m_counts[bucketOf(intervalUs)]++;
+            m_frames++;
+            m_totalUs += intervalUs;
+            if (longFrame)
+            {
+                m_longFrames++;
+            }
+            if (intervalUs < m_minUs)
+            {
+                m_minUs = intervalUs;
+            }
+            if (intervalUs > m_maxUs)
+            {
+                m_maxUs = intervalUs;
+            }
+        }
+
+        void FrameTimingHistogram::reset()
+        {
+            memset(m_counts, 0, sizeof(m_counts));
+            m_frames = 0;
+            m_longFrames = 0;
+            m_totalUs = 0;
+            m_minUs = UINT32_MAX;
+            m_maxUs = 0;
+        }
+
+        /**
+        * @brief Returns the frame interval that the given percentage of the frames did not exceed,
+        * as the midpoint of its bucket.
+        */
+        uint32_t FrameTimingHistogram::percentile(double percent) const
+        {
+            if (m_frames == 0)
+            {
+                return 0;
+            }
+
+            uint64_t rank = static_cast<uint64_t>(percent * m_frames / 100.0 + 0.5);
+            if (rank < 1)
+            {
+                rank = 1;
+            }
+            if (rank > m_frames)
+            {
+                rank = m_frames;
+            }
+
+            uint64_t seen = 0;
+            for (uint32_t bucket = 0; bucket < FRAME_TIMING_BUCKETS; bucket++)
+            {
+                seen += m_counts[bucket];
+                if (seen >= rank)
+                {
+                    uint32_t value = lowestOf(bucket) + (highestOf(bucket) - lowestOf(bucket)) / 2;
+                    if (value < m_minUs)
+                    {
+                        value = m_minUs;
+                    }
+                    if (value > m_maxUs)
+                    {
+                        value = m_maxUs;
+                    }
+                    return value;
+                }
+            }
+            return m_maxUs;
+        }
+
+        void FrameTimingHistogram::report(FrameTimingReport& report) const
+        {
+            report.frames = m_frames;
+            report.longFrames = m_longFrames;
+            report.minUs = (m_frames > 0 ? m_minUs : 0);
+            report.maxUs = m_maxUs;
+            report.meanUs = (m_frames > 0 ? static_cast<uint32_t>(m_totalUs / m_frames) : 0);
+            report.p50Us = percentile(50);
+            report.p95Us = percentile(95);
+            report.p99Us = percentile(99);
+        }
+
+        FrameTiming::FrameTiming()
+        : m_vsyncUs(FRAME_TIMING_DEFAULT_VSYNC_US)
+        , m_focused(nullptr)
+        , m_focusCount(0)
+        {
+        }
+
+        void FrameTiming::setVsyncInterval(uint32_t intervalUs)
+        {
+            if (intervalUs > 0)
+            {
+                m_vsyncUs = intervalUs;
+            }
+        }
+
+        void FrameTiming::setFocusedApp(const std::string& app)
+        {
+            if (app.empty())
+            {
+                m_focused = nullptr;
+                return;
+            }
+
+            App* slot = nullptr;
+            for (auto& it : m_apps)
+            {
+                if (it.name == app)
+                {
+                    slot = &it;
+                    break;
+                }
+                if (slot == nullptr || it.lastFocused < slot->lastFocused)
+                {
+                    slot = &it;
+                }
+            }
+
+            if (slot->name != app)
+            {
+                slot->name = app;
+                slot->total.reset();
+            }
+            slot->lastFocused = ++m_focusCount;
+            m_focused = slot;
+        }
+
+        const std::string& FrameTiming::focusedApp() const
+        {
+            static const std::string none;
+            return (m_focused != nullptr ? m_focused->name : none);
+        }
+
+        void FrameTiming::record(uint32_t intervalUs)
+        {
+            bool longFrame = (intervalUs > 2 * m_vsyncUs);
+
+            m_window.record(intervalUs, longFrame);
+            m_total.record(intervalUs, longFrame);
+            if (m_focused != nullptr)
+            {
+                m_focused->total.record(intervalUs, longFrame);
+            }
+        }
+
+        void FrameTiming::resetWindow()
+        {
+            m_window.reset();
+        }
+
+        void FrameTiming::reset()
+        {
+            m_window.reset();
+            m_total.reset();
+            for (auto& it : m_apps)
+            {
+                it.total.reset();
+            }
+        }
+
+        void FrameTiming::windowReport(FrameTimingReport& report) const
+        {
+            m_window.report(report);
+        }
+
+        void FrameTiming::totalReport(FrameTimingReport& report) const
+        {
+            m_total.report(report);
+        }
+
+        bool FrameTiming::appReport(const std::string& app, FrameTimingReport& report) const
+        {
+            for (auto& it : m_apps)
+            {
+                if (!app.empty() && it.name == app)
+                {
+                    it.total.report(report);
+                    return true;
+                }
+            }
+            return false;
+        }
+
+        bool FrameTiming::appAt(size_t index, std::string& app, FrameTimingReport& report) const
+        {
+            if (index >= FRAME_TIMING_MAX_APPS || m_apps[index].name.empty())
+            {
+                return false;
+            }
+
+            app = m_apps[index].name;
+            m_apps[index].total.report(report);
+            return true;
+        }
+
+    } // namespace Plugin
+} // namespace WPEFramework
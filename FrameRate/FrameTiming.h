@@ -0,0 +1,135 @@
+/**
+* If not stated otherwise in this file or this component's LICENSE
+* file the following copyright and licenses apply:
+*
+* Copyright 2019 RDK Management
+*
+* Licensed under the Apache License, Version 2.0 (the "License");
+* you may not use this file except in compliance with the License.
+* You may obtain a copy of the License at
+*
+* http://www.apache.org/licenses/LICENSE-2.0
+*
+* Unless required by applicable law or agreed to in writing, software
+* distributed under the License is distributed on an "AS IS" BASIS,
+* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+* See the License for the specific language governing permissions and
+* limitations under the License.
+**/
+
+#pragma once
+
+#include <stdint.h>
+#include <string>
+
+// 8 buckets per power of two, values are within 6.25% of their bucket's midpoint
+#define FRAME_TIMING_SUB_BUCKET_BITS 3
+// Frame intervals up to 2^24 us (16.7 s), longer ones are counted in the last bucket
+#define FRAME_TIMING_MAX_EXPONENT 24
+#define FRAME_TIMING_BUCKETS ((FRAME_TIMING_MAX_EXPONENT - FRAME_TIMING_SUB_BUCKET_BITS + 2) << FRAME_TIMING_SUB_BUCKET_BITS)
+// Apps with their own breakdown; the least recently focused one gives its slot to a new one
+#define FRAME_TIMING_MAX_APPS 8
+#define FRAME_TIMING_DEFAULT_VSYNC_US 16667
+
+namespace WPEFramework {
+
+    namespace Plugin {
+
+        struct FrameTimingReport
+        {
+            FrameTimingReport()
+            : frames(0), longFrames(0), minUs(0), maxUs(0), meanUs(0), p50Us(0), p95Us(0), p99Us(0)
+            {
+            }
+
+            uint64_t frames;
+            uint64_t longFrames;    // longer than two vsync intervals
+            uint32_t minUs;
+            uint32_t maxUs;
+            uint32_t meanUs;
+            uint32_t p50Us;
+            uint32_t p95Us;
+            uint32_t p99Us;
+        };
+
+        /**
+        * @brief Frame intervals in log-linear buckets (as HdrHistogram does), a fixed
+        * size array so recording a frame never allocates.
+        */
+        class FrameTimingHistogram
+        {
+        public:
+            FrameTimingHistogram();
+
+            static uint32_t bucketOf(uint32_t intervalUs);
+            static uint32_t lowestOf(uint32_t bucket);
+            static uint32_t highestOf(uint32_t bucket);
+
+            void record(uint32_t intervalUs, bool longFrame);
+            void reset();
+
+            uint64_t frames() const { return m_frames; }
+            uint32_t percentile(double percent) const;
+            void report(FrameTimingReport& report) const;
+
+        private:
+            uint32_t m_counts[FRAME_TIMING_BUCKETS];
+            uint64_t m_frames;
+            uint64_t m_longFrames;
+            uint64_t m_totalUs;
+            uint32_t m_minUs;
+            uint32_t m_maxUs;
+        };
+
+        /**
+        * @brief Frame timing over the current report window and since the collection started,
+        * overall and for each focused app. Not thread safe, FrameRate serializes the calls.
+        */
+        class FrameTiming
+        {
+        public:
+            FrameTiming();
+
+            FrameTiming(const FrameTiming&) = delete;
+            FrameTiming& operator=(const FrameTiming&) = delete;
+
+            void setVsyncInterval(uint32_t intervalUs);
+            uint32_t vsyncInterval() const { return m_vsyncUs; }
+
+            void setFocusedApp(const std::string& app);
+            const std::string& focusedApp() const;
+
+            void record(uint32_t intervalUs);
+
+            // Starts a new report window
+            void resetWindow();
+            void reset();
+
+            void windowReport(FrameTimingReport& report) const;
+            void totalReport(FrameTimingReport& report) const;
+            bool appReport(const std::string& app, FrameTimingReport& report) const;
+
+            size_t apps() const { return FRAME_TIMING_MAX_APPS; }
+            // Slot index; false if the slot is not in use
+            bool appAt(size_t index, std::string& app, FrameTimingReport& report) const;
+
+        private:
+            struct App
+            {
+                App() : lastFocused(0) {}
+
+                std::string name;
+                uint64_t lastFocused;
+                FrameTimingHistogram total;
+            };
+
+            uint32_t m_vsyncUs;
+            FrameTimingHistogram m_window;
+            FrameTimingHistogram m_total;
+            App m_apps[FRAME_TIMING_MAX_APPS];
+            App* m_focused;
+            uint64_t m_focusCount;
+        };
+
+    } // namespace Plugin
+} // namespace WPEFramework
@@ -35,6 +35,7 @@
 #include "websocket/URL.h"
 
 #include "utils.h"
+#include "settingsstore.h"
 
 #define HDMICEC_METHOD_SET_ENABLED "setEnabled"
 #define HDMICEC_METHOD_GET_ENABLED "getEnabled"
@@ -153,7 +154,13 @@ namespace WPEFramework
 //=========================================== HdmiCec =========================================
 
         HdmiCec::HdmiCec()
-        : AbstractPlugin(),smConnection(nullptr),cecEnableStatus(false)
+        : AbstractPlugin(),cecEnableStatus(false),cecRouter(nullptr)
+        , m_iarmEvents("HdmiCec", [](const char *owner, IARM_EventId_t eventId, void *data, size_t len) {
+            if (!strcmp(owner, IARM_BUS_DSMGR_NAME))
+                dsHdmiEventHandler(owner, eventId, data, len);
+            else
+                cecMgrEventHandler(owner, eventId, data, len);
+        })
         {
             HdmiCec::_instance = this;
             InitializeIARM();
@@ -191,6 +198,10 @@ namespace WPEFramework
             HdmiCec::_instance = nullptr;
 
             DeinitializeIARM();
+            m_iarmEvents.stop();
+
+            // loadSettings reads the file, so it must not wait for SETTINGS_STORE_WRITE_DELAY_MS
+            SettingsStore::instance(CEC_SETTING_ENABLED_FILE).flush();
 
         }
 
@@ -200,9 +211,9 @@ namespace WPEFramework
             {
                 IARM_Result_t res;
                 //IARM_CHECK( IARM_Bus_RegisterEventHandler(IARM_BUS_CECHOST_NAME, IARM_BUS_CECHost_EVENT_DEVICESTATUSCHANGE,cecDeviceStatusEventHandler) ); // It didn't do anything in original service
-                IARM_CHECK( IARM_Bus_RegisterEventHandler(IARM_BUS_CECMGR_NAME, IARM_BUS_CECMGR_EVENT_DAEMON_INITIALIZED,cecMgrEventHandler) );
-                IARM_CHECK( IARM_Bus_RegisterEventHandler(IARM_BUS_CECMGR_NAME, IARM_BUS_CECMGR_EVENT_STATUS_UPDATED,cecMgrEventHandler) );
-                IARM_CHECK( IARM_Bus_RegisterEventHandler(IARM_BUS_DSMGR_NAME,IARM_BUS_DSMGR_EVENT_HDMI_HOTPLUG, dsHdmiEventHandler) );
+                IARM_CHECK( IARM_Bus_RegisterEventHandler(IARM_BUS_CECMGR_NAME, IARM_BUS_CECMGR_EVENT_DAEMON_INITIALIZED,iarmEventHandler) );
+                IARM_CHECK( IARM_Bus_RegisterEventHandler(IARM_BUS_CECMGR_NAME, IARM_BUS_CECMGR_EVENT_STATUS_UPDATED,iarmEventHandler) );
+                IARM_CHECK( IARM_Bus_RegisterEventHandler(IARM_BUS_DSMGR_NAME,IARM_BUS_DSMGR_EVENT_HDMI_HOTPLUG, iarmEventHandler) );
             }
         }
 
@@ -218,6 +229,14 @@ namespace WPEFramework
             }
         }
 
+        void HdmiCec::iarmEventHandler(const char *owner, IARM_EventId_t eventId, void *data, size_t len)
+        {
+            if(!HdmiCec::_instance)
+                return;
+
+            HdmiCec::_instance->m_iarmEvents.post(owner, eventId, data, len);
+        }
+
         void HdmiCec::cecMgrEventHandler(const char *owner, IARM_EventId_t eventId, void *data, size_t len)
         {
             if(!HdmiCec::_instance)
@@ -441,23 +460,28 @@ namespace WPEFramework
             }
             libcecInitStatus++;
 
-            smConnection = new Connection(LogicalAddress::UNREGISTERED,false,"ServiceManager::Connection::");
-            smConnection->open();
-            smConnection->addFrameListener(this);
+            cecRouter = &CECFrameRouter::instance();
+            cecRouter->acquire();
+            // Decoded for the opcodes processed here only, every frame goes to onMessage
+            static const int processedOpcodes[] = { ACTIVE_SOURCE, IMAGE_VIEW_ON, TEXT_VIEW_ON, CEC_VERSION, SET_OSD_NAME,
+                REPORT_PHYSICAL_ADDRESS, DEVICE_VENDOR_ID, REPORT_POWER_STATUS };
+            for (int opcode : processedOpcodes)
+                cecSubscriptions.push_back(cecRouter->subscribe(opcode, [this](const CECRouter::Frame &frame) { onProcessedFrame(frame); }));
+            cecSubscriptions.push_back(cecRouter->subscribe(CEC_ROUTER_ALL_OPCODES, [this](const CECRouter::Frame &frame) { onFrame(frame); }));
 
             //Acquire CEC Addresses
             getPhysicalAddress();
             getLogicalAddress();
-            if(smConnection)
+            if(cecRouter)
             {
 
-                LOGWARN("Start Update thread %p", smConnection );
+                LOGWARN("Start Update thread %p", cecRouter );
                 m_updateThreadExit = false;
                 _instance->m_lockUpdate = PTHREAD_MUTEX_INITIALIZER;
                 _instance->m_condSigUpdate = PTHREAD_COND_INITIALIZER;
                 m_UpdateThread = std::thread(threadUpdateCheck);
 
-                LOGWARN("Start Thread %p", smConnection );
+                LOGWARN("Start Thread %p", cecRouter );
                 m_pollThreadExit = false;
                 _instance->m_numberOfDevices = 0;
                 _instance->m_lock = PTHREAD_MUTEX_INITIALIZER;
@@ -478,16 +502,16 @@ namespace WPEFramework
                 return;
             }
 
-            if (smConnection != NULL)
+            if (cecRouter != NULL)
             {
-                LOGWARN("Stop Thread %p", smConnection );
+                LOGWARN("Stop Thread %p", cecRouter );
 
                 m_updateThreadExit = true;
                 //Trigger codition to exit poll loop
                 pthread_cond_signal(&(_instance->m_condSigUpdate));
                 try {
                     if (m_UpdateThread.joinable()) {
-                       LOGWARN("Join update Thread %p", smConnection );
+                       LOGWARN("Join update Thread %p", cecRouter );
                        m_UpdateThread.join();
                     }
                 }
@@ -497,7 +521,7 @@ namespace WPEFramework
                 catch(const std::exception& e) {
                     LOGERR("exception in thread join %s", e.what());
                 }
-                LOGWARN("Deleted update Thread %p", smConnection );
+                LOGWARN("Deleted update Thread %p", cecRouter );
 
 
                 m_pollThreadExit = true;
@@ -505,7 +529,7 @@ namespace WPEFramework
                 pthread_cond_signal(&(_instance->m_condSig));
                 try {
                     if (m_pollThread.joinable()) {
-                       LOGWARN("Join Thread %p", smConnection );
+                       LOGWARN("Join Thread %p", cecRouter );
                        m_pollThread.join();
                     }
                 }
@@ -515,14 +539,16 @@ namespace WPEFramework
                 catch(const std::exception& e) {
                     LOGERR("exception in thread join %s", e.what());
                 }
-                LOGWARN("Deleted Thread %p", smConnection );
+                LOGWARN("Deleted Thread %p", cecRouter );
                 //Clear cec device cache.
                 removeAllCecDevices();
 
 
-                smConnection->close();
-                delete smConnection;
-                smConnection = NULL;
+                for (uint32_t subscription : cecSubscriptions)
+                    cecRouter->unsubscribe(subscription);
+                cecSubscriptions.clear();
+                cecRouter->release();
+                cecRouter = NULL;
             }
             cecEnableStatus = false;
 
@@ -710,7 +736,7 @@ namespace WPEFramework
                 CECFrame frame = CECFrame((const uint8_t *)buf.data(), decodedLen);
         //      SVCLOG_WARN("Frame to be sent from servicemanager in %s \n",__FUNCTION__);
         //      frame.hexDump();
-                smConnection->sendAsync(frame);
+                cecRouter->send(frame);
             }
             else
                 LOGWARN("cecEnableStatus=false");
@@ -747,28 +773,25 @@ namespace WPEFramework
             return;
         }
 
-        void HdmiCec::notify(const CECFrame &in) const
+        void HdmiCec::onProcessedFrame(const CECRouter::Frame &frame)
         {
-            LOGINFO("Inside notify ");
-            size_t length;
-            const uint8_t *input_frameBuf = NULL;
-            CECFrame Frame = in;
-        //  SVCLOG_WARN("Frame received by servicemanager is \n");
-        //  Frame.hexDump();
-            Frame.getBuffer(&input_frameBuf,&length);
-
-            std::vector <char> buf;
-            buf.resize(length * 2);
-
-            uint16_t encodedLen = Core::URL::Base64Encode(input_frameBuf, length, buf.data(), buf.size());
-            buf[encodedLen] = 0;
             if (HdmiCec::_instance) {
-                MessageDecoder((*(HdmiCec::_instance))).decode(in);
+                MessageDecoder((*(HdmiCec::_instance))).decode(CECFrame(frame.data, frame.len));
             } else {
                 LOGWARN("HdmiCec::_instance NULL Cec msg decoding failed.");
             }
+        }
+
+        void HdmiCec::onFrame(const CECRouter::Frame &frame)
+        {
+            LOGINFO("Inside onFrame ");
+            std::vector <char> buf;
+            buf.resize(frame.len * 2);
 
-            (const_cast<HdmiCec*>(this))->onMessage(buf.data());
+            uint16_t encodedLen = Core::URL::Base64Encode(frame.data, frame.len, buf.data(), buf.size());
+            buf[encodedLen] = 0;
+
+            onMessage(buf.data());
             return;
         }
 
@@ -819,37 +842,31 @@ namespace WPEFramework
 			LOGERR("HdmiCec::_instance not existing");
 			return isConnected;
 		}
-		if ( !(_instance->smConnection) || _instance->logicalAddress == LogicalAddress::UNREGISTERED || (false == cecEnableStatus)){
-			LOGERR("Exiting from pingDeviceUpdateList _instance->smConnection:%p, _instance->logicalAddress:%d, cecEnableStatus=%d",
-					_instance->smConnection, _instance->logicalAddress, cecEnableStatus);
+		if ( !(_instance->cecRouter) || _instance->logicalAddress == LogicalAddress::UNREGISTERED || (false == cecEnableStatus)){
+			LOGERR("Exiting from pingDeviceUpdateList _instance->cecRouter:%p, _instance->logicalAddress:%d, cecEnableStatus=%d",
+					_instance->cecRouter, _instance->logicalAddress, cecEnableStatus);
 			return isConnected;
 		}
 
 		LOGWARN("PING for  0x%x \r\n",idev);
-		try {
-			_instance->smConnection->ping(LogicalAddress(_instance->logicalAddress), LogicalAddress(idev), Throw_e());
-		}
-		catch(CECNoAckException &e)
+		CECRouter::SendResult result = _instance->cecRouter->ping(_instance->logicalAddress, idev);
+		if (result == CECRouter::SEND_NO_ACK)
 		{
 			if (BIT_CHECK(_instance->deviceList[idev].m_deviceInfoStatus, BIT_DEVICE_PRESENT)) {
 				LOGINFO("Device disconnected: %d \r\n",idev);
 				removeDevice (idev);
 			} else {
-				LOGINFO("Device is not connected: %d. Ping caught %s\r\n",idev, e.what());
+				LOGINFO("Device is not connected: %d. Ping not acknowledged\r\n",idev);
 			}
 			isConnected = false;
 			return isConnected;;
 		}
-		catch(IOException &e)
+		else if (result != CECRouter::SEND_OK)
 		{
-			LOGINFO("Device is not reachable: %d. Ping caught %s\r\n",idev, e.what());
+			LOGINFO("Device is not reachable: %d. Ping result %d\r\n",idev, result);
 			isConnected = false;
 			return isConnected;;
 		}
-		catch(Exception &e)
-		{
-			LOGINFO("Ping caught %s \r\n",e.what());
-		}
 
 		/* If we get ACK, then the device is present in the network*/
 		isConnected = true;
@@ -931,7 +948,7 @@ namespace WPEFramework
 			CECFrame frame = CECFrame((const uint8_t *)buf.data(), size);
 			//      SVCLOG_WARN("Frame to be sent from servicemanager in %s \n",__FUNCTION__);
 			//      frame.hexDump();
-			smConnection->sendAsync(frame);
+			cecRouter->send(frame);
 		}
 		else
 			LOGWARN("cecEnableStatus=false");
@@ -985,7 +1002,7 @@ namespace WPEFramework
 	{
 		if(!HdmiCec::_instance)
 			return;
-		if(!(_instance->smConnection))
+		if(!(_instance->cecRouter))
 			return;
 		LOGINFO("Entering ThreadRun: _instance->m_pollThreadExit %d",_instance->m_pollThreadExit);
 		int i = 0;
@@ -1014,7 +1031,7 @@ namespace WPEFramework
 	{
 		if(!HdmiCec::_instance)
 			return;
-		if(!(_instance->smConnection))
+		if(!(_instance->cecRouter))
 			return;
 		LOGINFO("Entering ThreadUpdate: _instance->m_updateThreadExit %d",_instance->m_updateThreadExit);
 		int i = 0;
@@ -35,6 +35,8 @@
 
 #include "Module.h"
 #include "utils.h"
+#include "iarmeventdispatcher.h"
+#include "cecframerouter.h"
 #include "AbstractPlugin.h"
 
 #include "tptimer.h"
@@ -116,7 +118,7 @@ namespace WPEFramework {
 		// As the registration/unregistration of notifications is realized by the class PluginHost::JSONRPC,
 		// this class exposes a public method called, Notify(), using this methods, all subscribed clients
 		// will receive a JSONRPC message as a notification, in case this method is called.
-        class HdmiCec : public AbstractPlugin, public FrameListener, public MessageProcessor {
+        class HdmiCec : public AbstractPlugin, public MessageProcessor {
         private:
 
             // We do not allow this plugin to be copied !!
@@ -164,7 +166,8 @@ namespace WPEFramework {
             unsigned int physicalAddress;
             bool cecSettingEnabled;
             bool cecEnableStatus;
-            Connection *smConnection;
+            CECFrameRouter *cecRouter;
+            std::vector<uint32_t> cecSubscriptions;
             int m_numberOfDevices;
             bool m_pollThreadExit;
             std::thread m_pollThread;
@@ -173,6 +176,7 @@ namespace WPEFramework {
 
             const void InitializeIARM();
             void DeinitializeIARM();
+            static void iarmEventHandler(const char *owner, IARM_EventId_t eventId, void *data, size_t len);
             static void cecMgrEventHandler(const char *owner, IARM_EventId_t eventId, void *data, size_t len);
             static void dsHdmiEventHandler(const char *owner, IARM_EventId_t eventId, void *data, size_t len);
             void onCECDaemonInit();
@@ -206,11 +210,14 @@ namespace WPEFramework {
             void sendMessage(std::string message);
             void cecAddressesChanged(int changeStatus);
 
-            void notify(const CECFrame &in) const;
+            void onFrame(const CECRouter::Frame &frame);
+            void onProcessedFrame(const CECRouter::Frame &frame);
             void onMessage(const char *message);
             static void threadRun();
             static void threadUpdateCheck();
 
+            // Both the CEC manager and the HDMI hotplug events, in the order they came
+            IARMEventDispatcher m_iarmEvents;
         };
 	} // namespace Plugin
 } // namespace WPEFramework
@@ -36,6 +36,7 @@
 #include "websocket/URL.h"
 
 #include "utils.h"
+#include "settingsstore.h"
 
 #define HDMICECSINK_METHOD_SET_ENABLED 			"setEnabled"
 #define HDMICECSINK_METHOD_GET_ENABLED 			"getEnabled"
@@ -215,7 +216,7 @@ namespace WPEFramework
              LOGINFO("Command: GetCECVersion sending CECVersion response \n");
              try
              { 
-                 conn.sendTo(header.from, MessageEncoder().encode(CECVersion(Version::V_1_4)));
+                 router.sendTo(HdmiCecSink::_instance->m_logicalAddressAllocated, header.from, MessageEncoder().encode(CECVersion(Version::V_1_4)));
              } 
              catch(...)
              {
@@ -246,7 +247,7 @@ namespace WPEFramework
              LOGINFO("Command: GiveOSDName sending SetOSDName : %s\n",osdName.toString().c_str());
              try
              { 
-                 conn.sendTo(header.from, MessageEncoder().encode(SetOSDName(osdName)));
+                 router.sendTo(HdmiCecSink::_instance->m_logicalAddressAllocated, header.from, MessageEncoder().encode(SetOSDName(osdName)));
              } 
              catch(...)
              {
@@ -261,7 +262,7 @@ namespace WPEFramework
                  try
                  { 
                      LOGINFO(" sending ReportPhysicalAddress response physical_addr :%s logicalAddress :%x \n",physical_addr.toString().c_str(), logicalAddress.toInt());
-                     conn.sendTo(LogicalAddress(LogicalAddress::BROADCAST), MessageEncoder().encode(ReportPhysicalAddress(physical_addr,logicalAddress.toInt())),100);
+                     router.sendTo(HdmiCecSink::_instance->m_logicalAddressAllocated, LogicalAddress(LogicalAddress::BROADCAST), MessageEncoder().encode(ReportPhysicalAddress(physical_addr,logicalAddress.toInt())));
                  } 
                  catch(...)
                  {
@@ -275,7 +276,7 @@ namespace WPEFramework
              try
              {
                  LOGINFO("Command: GiveDeviceVendorID sending VendorID response :%s\n",appVendorId.toString().c_str());
-                 conn.sendTo(LogicalAddress(LogicalAddress::BROADCAST), MessageEncoder().encode(DeviceVendorID(appVendorId)));
+                 router.sendTo(HdmiCecSink::_instance->m_logicalAddressAllocated, LogicalAddress(LogicalAddress::BROADCAST), MessageEncoder().encode(DeviceVendorID(appVendorId)));
              }
              catch(...)
              {
@@ -360,7 +361,7 @@ namespace WPEFramework
              LOGINFO("Command: GiveDevicePowerStatus sending powerState :%d \n",powerState);
              try
              { 
-                 conn.sendTo(header.from, MessageEncoder().encode(ReportPowerStatus(PowerStatus(powerState))));
+                 router.sendTo(HdmiCecSink::_instance->m_logicalAddressAllocated, header.from, MessageEncoder().encode(ReportPowerStatus(PowerStatus(powerState))));
              } 
              catch(...)
              {
@@ -492,7 +493,8 @@ namespace WPEFramework
        	   int err;
            LOGWARN("Initlaizing HdmiCecSink");
            HdmiCecSink::_instance = this;
-           smConnection=NULL;
+           cecRouter=NULL;
+           cecSubscription = 0;
 		   cecEnableStatus = false;
                    HdmiCecSink::_instance->m_numberOfDevices = 0;
 		   m_logicalAddressAllocated = LogicalAddress::UNREGISTERED;
@@ -653,6 +655,9 @@ namespace WPEFramework
 
             HdmiCecSink::_instance = nullptr;
             DeinitializeIARM();
+
+            // loadSettings reads the file, so it must not wait for SETTINGS_STORE_WRITE_DELAY_MS
+            SettingsStore::instance(CEC_SETTING_ENABLED_FILE).flush();
 	    LOGWARN(" HdmiCecSink Deinitialize() Done");
        }
 
@@ -781,14 +786,14 @@ namespace WPEFramework
       {
       		if(!HdmiCecSink::_instance)
 				return;
-          if(!(HdmiCecSink::_instance->smConnection))
+          if(!(HdmiCecSink::_instance->cecRouter))
               return;
 			if ( _instance->m_logicalAddressAllocated == LogicalAddress::UNREGISTERED){
 				LOGERR("Logical Address NOT Allocated Or its not valid");
 				return;
 			}
 
-			_instance->smConnection->sendTo(LogicalAddress(LogicalAddress::BROADCAST), MessageEncoder().encode(Standby()), 1000);
+			_instance->cecRouter->sendTo(_instance->m_logicalAddressAllocated, LogicalAddress(LogicalAddress::BROADCAST), MessageEncoder().encode(Standby()));
        } 
 
 	   void HdmiCecSink::wakeupFromStandby()
@@ -974,79 +979,79 @@ namespace WPEFramework
          }
 		 void HdmiCecSink::sendKeyPressEvent(const int logicalAddress, int keyCode)
 		 {
-                    if(!(_instance->smConnection))
+                    if(!(_instance->cecRouter))
                         return;
 		    LOGINFO(" sendKeyPressEvent logicalAddress 0x%x keycode 0x%x\n",logicalAddress,keyCode);
                     switch(keyCode)
                    {
                        case VOLUME_UP:
-			   _instance->smConnection->sendTo(LogicalAddress(logicalAddress), MessageEncoder().encode(UserControlPressed(UICommand::UI_COMMAND_VOLUME_UP)),100);
+			   _instance->cecRouter->sendTo(_instance->m_logicalAddressAllocated, LogicalAddress(logicalAddress), MessageEncoder().encode(UserControlPressed(UICommand::UI_COMMAND_VOLUME_UP)));
 			   break;
 		       case VOLUME_DOWN:
-			   _instance->smConnection->sendTo(LogicalAddress(logicalAddress), MessageEncoder().encode(UserControlPressed(UICommand::UI_COMMAND_VOLUME_DOWN)), 100);
+			   _instance->cecRouter->sendTo(_instance->m_logicalAddressAllocated, LogicalAddress(logicalAddress), MessageEncoder().encode(UserControlPressed(UICommand::UI_COMMAND_VOLUME_DOWN)));
                           break;
 		       case MUTE:
-			   _instance->smConnection->sendTo(LogicalAddress(logicalAddress), MessageEncoder().encode(UserControlPressed(UICommand::UI_COMMAND_MUTE)), 100);
+			   _instance->cecRouter->sendTo(_instance->m_logicalAddressAllocated, LogicalAddress(logicalAddress), MessageEncoder().encode(UserControlPressed(UICommand::UI_COMMAND_MUTE)));
 			   break;
 		       case UP:
-			   _instance->smConnection->sendTo(LogicalAddress(logicalAddress), MessageEncoder().encode(UserControlPressed(UICommand::UI_COMMAND_UP)), 100);
+			   _instance->cecRouter->sendTo(_instance->m_logicalAddressAllocated, LogicalAddress(logicalAddress), MessageEncoder().encode(UserControlPressed(UICommand::UI_COMMAND_UP)));
 			   break;
 		       case DOWN:
-			   _instance->smConnection->sendTo(LogicalAddress(logicalAddress), MessageEncoder().encode(UserControlPressed(UICommand::UI_COMMAND_DOWN)), 100);
+			   _instance->cecRouter->sendTo(_instance->m_logicalAddressAllocated, LogicalAddress(logicalAddress), MessageEncoder().encode(UserControlPressed(UICommand::UI_COMMAND_DOWN)));
 			   break;
 		       case LEFT:
-			   _instance->smConnection->sendTo(LogicalAddress(logicalAddress), MessageEncoder().encode(UserControlPressed(UICommand::UI_COMMAND_LEFT)), 100);
+			   _instance->cecRouter->sendTo(_instance->m_logicalAddressAllocated, LogicalAddress(logicalAddress), MessageEncoder().encode(UserControlPressed(UICommand::UI_COMMAND_LEFT)));
 			   break;
 		       case RIGHT:
-			   _instance->smConnection->sendTo(LogicalAddress(logicalAddress), MessageEncoder().encode(UserControlPressed(UICommand::UI_COMMAND_RIGHT)), 100);
+			   _instance->cecRouter->sendTo(_instance->m_logicalAddressAllocated, LogicalAddress(logicalAddress), MessageEncoder().encode(UserControlPressed(UICommand::UI_COMMAND_RIGHT)));
 			   break;
 		       case SELECT:
-			   _instance->smConnection->sendTo(LogicalAddress(logicalAddress), MessageEncoder().encode(UserControlPressed(UICommand::UI_COMMAND_SELECT)), 100);
+			   _instance->cecRouter->sendTo(_instance->m_logicalAddressAllocated, LogicalAddress(logicalAddress), MessageEncoder().encode(UserControlPressed(UICommand::UI_COMMAND_SELECT)));
 			   break;
 		       case HOME:
-			   _instance->smConnection->sendTo(LogicalAddress(logicalAddress), MessageEncoder().encode(UserControlPressed(UICommand::UI_COMMAND_HOME)), 100);
+			   _instance->cecRouter->sendTo(_instance->m_logicalAddressAllocated, LogicalAddress(logicalAddress), MessageEncoder().encode(UserControlPressed(UICommand::UI_COMMAND_HOME)));
 			   break;
 		       case BACK:
-			   _instance->smConnection->sendTo(LogicalAddress(logicalAddress), MessageEncoder().encode(UserControlPressed(UICommand::UI_COMMAND_BACK)), 100);
+			   _instance->cecRouter->sendTo(_instance->m_logicalAddressAllocated, LogicalAddress(logicalAddress), MessageEncoder().encode(UserControlPressed(UICommand::UI_COMMAND_BACK)));
 			   break;
 		       case NUMBER_0:
-			   _instance->smConnection->sendTo(LogicalAddress(logicalAddress), MessageEncoder().encode(UserControlPressed(UICommand::UI_COMMAND_NUM_0)), 100);
+			   _instance->cecRouter->sendTo(_instance->m_logicalAddressAllocated, LogicalAddress(logicalAddress), MessageEncoder().encode(UserControlPressed(UICommand::UI_COMMAND_NUM_0)));
 			   break;
 		       case NUMBER_1:
-			   _instance->smConnection->sendTo(LogicalAddress(logicalAddress), MessageEncoder().encode(UserControlPressed(UICommand::UI_COMMAND_NUM_1)), 100);
+			   _instance->cecRouter->sendTo(_instance->m_logicalAddressAllocated, LogicalAddress(logicalAddress), MessageEncoder().encode(UserControlPressed(UICommand::UI_COMMAND_NUM_1)));
 			   break;
 		       case NUMBER_2:
-			   _instance->smConnection->sendTo(LogicalAddress(logicalAddress), MessageEncoder().encode(UserControlPressed(UICommand::UI_COMMAND_NUM_2)), 100);
+			   _instance->cecRouter->sendTo(_instance->m_logicalAddressAllocated, LogicalAddress(logicalAddress), MessageEncoder().encode(UserControlPressed(UICommand::UI_COMMAND_NUM_2)));
 			   break;
 		       case NUMBER_3:
-			   _instance->smConnection->sendTo(LogicalAddress(logicalAddress), MessageEncoder().encode(UserControlPressed(UICommand::UI_COMMAND_NUM_3)), 100);
+			   _instance->cecRouter->sendTo(_instance->m_logicalAddressAllocated, LogicalAddress(logicalAddress), MessageEncoder().encode(UserControlPressed(UICommand::UI_COMMAND_NUM_3)));
 			   break;
 		       case NUMBER_4:
-			   _instance->smConnection->sendTo(LogicalAddress(logicalAddress), MessageEncoder().encode(UserControlPressed(UICommand::UI_COMMAND_NUM_4)), 100);
+			   _instance->cecRouter->sendTo(_instance->m_logicalAddressAllocated, LogicalAddress(logicalAddress), MessageEncoder().encode(UserControlPressed(UICommand::UI_COMMAND_NUM_4)));
 			   break;
 		       case NUMBER_5:
-			   _instance->smConnection->sendTo(LogicalAddress(logicalAddress), MessageEncoder().encode(UserControlPressed(UICommand::UI_COMMAND_NUM_5)), 100);
+			   _instance->cecRouter->sendTo(_instance->m_logicalAddressAllocated, LogicalAddress(logicalAddress), MessageEncoder().encode(UserControlPressed(UICommand::UI_COMMAND_NUM_5)));
 			   break;
 		       case NUMBER_6:
-			   _instance->smConnection->sendTo(LogicalAddress(logicalAddress), MessageEncoder().encode(UserControlPressed(UICommand::UI_COMMAND_NUM_6)), 100);
+			   _instance->cecRouter->sendTo(_instance->m_logicalAddressAllocated, LogicalAddress(logicalAddress), MessageEncoder().encode(UserControlPressed(UICommand::UI_COMMAND_NUM_6)));
 			   break;
 		       case NUMBER_7:
-			   _instance->smConnection->sendTo(LogicalAddress(logicalAddress), MessageEncoder().encode(UserControlPressed(UICommand::UI_COMMAND_NUM_7)), 100);
+			   _instance->cecRouter->sendTo(_instance->m_logicalAddressAllocated, LogicalAddress(logicalAddress), MessageEncoder().encode(UserControlPressed(UICommand::UI_COMMAND_NUM_7)));
 			   break;
 		       case NUMBER_8:
-			   _instance->smConnection->sendTo(LogicalAddress(logicalAddress), MessageEncoder().encode(UserControlPressed(UICommand::UI_COMMAND_NUM_8)), 100);
+			   _instance->cecRouter->sendTo(_instance->m_logicalAddressAllocated, LogicalAddress(logicalAddress), MessageEncoder().encode(UserControlPressed(UICommand::UI_COMMAND_NUM_8)));
 			   break;
 		       case NUMBER_9:
-			   _instance->smConnection->sendTo(LogicalAddress(logicalAddress), MessageEncoder().encode(UserControlPressed(UICommand::UI_COMMAND_NUM_9)), 100);
+			   _instance->cecRouter->sendTo(_instance->m_logicalAddressAllocated, LogicalAddress(logicalAddress), MessageEncoder().encode(UserControlPressed(UICommand::UI_COMMAND_NUM_9)));
 			   break;
 
                    }
 		 }
 		 void HdmiCecSink::sendKeyReleaseEvent(const int logicalAddress)
 		 {
-                    if(!(_instance->smConnection))
+                    if(!(_instance->cecRouter))
                         return;
-		 _instance->smConnection->sendTo(LogicalAddress(logicalAddress), MessageEncoder().encode(UserControlReleased()), 100);
+		 _instance->cecRouter->sendTo(_instance->m_logicalAddressAllocated, LogicalAddress(logicalAddress), MessageEncoder().encode(UserControlReleased()));
 
 		 }
          void  HdmiCecSink::sendDeviceUpdateInfo(const int logicalAddress)
@@ -1065,20 +1070,20 @@ namespace WPEFramework
 
             if(!HdmiCecSink::_instance)
              return;
-            if(!(_instance->smConnection))
+            if(!(_instance->cecRouter))
                 return;
              LOGINFO(" Send systemAudioModeRequest ");
-           _instance->smConnection->sendTo(LogicalAddress::AUDIO_SYSTEM,MessageEncoder().encode(SystemAudioModeRequest(physical_addr)), 1000);
+           _instance->cecRouter->sendTo(_instance->m_logicalAddressAllocated, LogicalAddress::AUDIO_SYSTEM, MessageEncoder().encode(SystemAudioModeRequest(physical_addr)));
 
         }
          void HdmiCecSink::sendGiveAudioStatusMsg()
         {
             if(!HdmiCecSink::_instance)
              return;
-            if(!(_instance->smConnection))
+            if(!(_instance->cecRouter))
                 return;
              LOGINFO(" Send GiveAudioStatus ");
-	      _instance->smConnection->sendTo(LogicalAddress::AUDIO_SYSTEM,MessageEncoder().encode(GiveAudioStatus()), 100);
+	      _instance->cecRouter->sendTo(_instance->m_logicalAddressAllocated, LogicalAddress::AUDIO_SYSTEM, MessageEncoder().encode(GiveAudioStatus()));
 
         }
         void HdmiCecSink::SendStandbyMsgEvent(const int logicalAddress)
@@ -1731,15 +1736,14 @@ namespace WPEFramework
 			if(!HdmiCecSink::_instance)
 				return;
 
-                        if(!(_instance->smConnection))
+                        if(!(_instance->cecRouter))
                             return;
 			if ( _instance->m_logicalAddressAllocated == LogicalAddress::UNREGISTERED ){
 				LOGERR("Logical Address NOT Allocated");
 				return;
 			}
 
-			_instance->smConnection->sendTo(LogicalAddress::BROADCAST, 
-										MessageEncoder().encode(RequestActiveSource()), 500);
+			_instance->cecRouter->sendTo(_instance->m_logicalAddressAllocated, LogicalAddress::BROADCAST, MessageEncoder().encode(RequestActiveSource()));
 		}
 		
 		void HdmiCecSink::setActiveSource(bool isResponse)
@@ -1747,7 +1751,7 @@ namespace WPEFramework
 			if(!HdmiCecSink::_instance)
 				return;
 
-                        if(!(_instance->smConnection))
+                        if(!(_instance->cecRouter))
                             return;
 			if ( _instance->m_logicalAddressAllocated == LogicalAddress::UNREGISTERED ){
 				LOGERR("Logical Address NOT Allocated");
@@ -1760,8 +1764,7 @@ namespace WPEFramework
 				return;
 			}
 		
-			_instance->smConnection->sendTo(LogicalAddress::BROADCAST, 
-										MessageEncoder().encode(ActiveSource(_instance->deviceList[_instance->m_logicalAddressAllocated].m_physicalAddr)), 500);
+			_instance->cecRouter->sendTo(_instance->m_logicalAddressAllocated, LogicalAddress::BROADCAST, MessageEncoder().encode(ActiveSource(_instance->deviceList[_instance->m_logicalAddressAllocated].m_physicalAddr)));
 			_instance->m_currentActiveSource = _instance->m_logicalAddressAllocated;
 		}
 
@@ -1784,7 +1787,7 @@ namespace WPEFramework
 			if(!HdmiCecSink::_instance)
 				return;
 
-                        if(!(_instance->smConnection))
+                        if(!(_instance->cecRouter))
                             return;
 			if ( _instance->m_logicalAddressAllocated == LogicalAddress::UNREGISTERED ){
 				LOGERR("Logical Address NOT Allocated");
@@ -1793,7 +1796,7 @@ namespace WPEFramework
 
 			lang = _instance->deviceList[_instance->m_logicalAddressAllocated].m_currentLanguage;
 
-			_instance->smConnection->sendTo(LogicalAddress::BROADCAST, MessageEncoder().encode(SetMenuLanguage(lang)), 100);
+			_instance->cecRouter->sendTo(_instance->m_logicalAddressAllocated, LogicalAddress::BROADCAST, MessageEncoder().encode(SetMenuLanguage(lang)));
 		}
 
 		void HdmiCecSink::updateInActiveSource(const int logical_address, const InActiveSource &source )
@@ -1868,7 +1871,7 @@ namespace WPEFramework
 		        if(!HdmiCecSink::_instance)
 				return;
 
-                        if(!(_instance->smConnection))
+                        if(!(_instance->cecRouter))
                             return;
 			if ( _instance->m_logicalAddressAllocated == LogicalAddress::UNREGISTERED ){
 				LOGERR("Logical Address NOT Allocated");
@@ -1876,7 +1879,7 @@ namespace WPEFramework
 			}
 
                         LOGINFO(" Send requestShortAudioDescriptor Message ");
-                    _instance->smConnection->sendTo(LogicalAddress::AUDIO_SYSTEM,MessageEncoder().encode(RequestShortAudioDescriptor(formatid,audioFormatCode,numberofdescriptor)), 1000);
+                    _instance->cecRouter->sendTo(_instance->m_logicalAddressAllocated, LogicalAddress::AUDIO_SYSTEM, MessageEncoder().encode(RequestShortAudioDescriptor(formatid,audioFormatCode,numberofdescriptor)));
 
 		}
 		void HdmiCecSink::sendFeatureAbort(const LogicalAddress logicalAddress, const OpCode feature, const AbortReason reason)
@@ -1884,10 +1887,10 @@ namespace WPEFramework
 
                        if(!HdmiCecSink::_instance)
                                return;
-                       if(!(_instance->smConnection))
+                       if(!(_instance->cecRouter))
                            return;
 		       LOGINFO(" Sending FeatureAbort to %s for opcode %s with reason %s ",logicalAddress.toString().c_str(),feature.toString().c_str(),reason.toString().c_str());
-                       _instance->smConnection->sendTo(logicalAddress, MessageEncoder().encode(FeatureAbort(feature,reason)), 100);
+                       _instance->cecRouter->sendTo(_instance->m_logicalAddressAllocated, logicalAddress, MessageEncoder().encode(FeatureAbort(feature,reason)));
                  }
 	void HdmiCecSink::pingDevices(std::vector<int> &connected , std::vector<int> &disconnected)
         {
@@ -1895,7 +1898,7 @@ namespace WPEFramework
 
 		if(!HdmiCecSink::_instance)
                 return;
-                if(!(_instance->smConnection))
+                if(!(_instance->cecRouter))
                     return;
 
 			if ( _instance->m_logicalAddressAllocated == LogicalAddress::UNREGISTERED ){
@@ -1907,21 +1910,18 @@ namespace WPEFramework
 				if ( i != _instance->m_logicalAddressAllocated )
 				{
 					//LOGWARN("PING for  0x%x \r\n",i);
-					try {
-						_instance->smConnection->ping(LogicalAddress(_instance->m_logicalAddressAllocated), LogicalAddress(i), Throw_e());
-					}
-					catch(CECNoAckException &e)
+					CECRouter::SendResult result = _instance->cecRouter->ping(_instance->m_logicalAddressAllocated, i);
+					if (result == CECRouter::SEND_NO_ACK)
 					{
 						if ( _instance->deviceList[i].m_isDevicePresent ) {
 							disconnected.push_back(i);
 						}
-                                                //LOGWARN("Ping device: 0x%x caught %s \r\n", i, e.what());
 						usleep(50000);
 						continue;
 					}
-					  catch(Exception &e)
+					  else if (result != CECRouter::SEND_OK)
 					  {
-						LOGWARN("Ping device: 0x%x caught %s \r\n", i, e.what());
+						LOGWARN("Ping device: 0x%x result %d \r\n", i, result);
                                                 usleep(50000);
                                                 continue;
 					  }
@@ -2005,7 +2005,7 @@ namespace WPEFramework
 			if(!HdmiCecSink::_instance)
 				return;
 		
-                        if(!(_instance->smConnection))
+                        if(!(_instance->cecRouter))
                             return;
 			if ( _instance->m_logicalAddressAllocated == LogicalAddress::UNREGISTERED){
 				LOGERR("Logical Address NOT Allocated Or its not valid");
@@ -2021,9 +2021,9 @@ namespace WPEFramework
 				{
 					LOGINFO("Sending Power OFF ");
 					/* send Power OFF Function to turn OFF */
-					_instance->smConnection->sendTo(LogicalAddress(_instance->m_currentActiveSource), MessageEncoder().encode(UserControlPressed(UICommand::UI_COMMAND_POWER_OFF_FUNCTION)), 100);
+					_instance->cecRouter->sendTo(_instance->m_logicalAddressAllocated, LogicalAddress(_instance->m_currentActiveSource), MessageEncoder().encode(UserControlPressed(UICommand::UI_COMMAND_POWER_OFF_FUNCTION)));
 
-					_instance->smConnection->sendTo(LogicalAddress(_instance->m_currentActiveSource), MessageEncoder().encode(UserControlReleased()), 100);
+					_instance->cecRouter->sendTo(_instance->m_logicalAddressAllocated, LogicalAddress(_instance->m_currentActiveSource), MessageEncoder().encode(UserControlReleased()));
 				}
 			}
 		}
@@ -2036,7 +2036,7 @@ namespace WPEFramework
 			if(!HdmiCecSink::_instance)
 				return;
 		
-                        if(!(_instance->smConnection))
+                        if(!(_instance->cecRouter))
                             return;
 			if ( _instance->m_logicalAddressAllocated == LogicalAddress::UNREGISTERED){
 				LOGERR("Logical Address NOT Allocated Or its not valid");
@@ -2057,8 +2057,8 @@ namespace WPEFramework
 				{
 					LOGINFO("Sending Power ON");
 					/* send Power ON Function to turn ON */
-					_instance->smConnection->sendTo(LogicalAddress(logicalAddr), MessageEncoder().encode(UserControlPressed(UICommand::UI_COMMAND_POWER_ON_FUNCTION)), 100);
-					_instance->smConnection->sendTo(LogicalAddress(logicalAddr), MessageEncoder().encode(UserControlReleased()), 100);
+					_instance->cecRouter->sendTo(_instance->m_logicalAddressAllocated, LogicalAddress(logicalAddr), MessageEncoder().encode(UserControlPressed(UICommand::UI_COMMAND_POWER_ON_FUNCTION)));
+					_instance->cecRouter->sendTo(_instance->m_logicalAddressAllocated, LogicalAddress(logicalAddr), MessageEncoder().encode(UserControlReleased()));
 				}
 			}
 		}
@@ -2068,14 +2068,14 @@ namespace WPEFramework
 			if(!HdmiCecSink::_instance)
 				return;
 
-                        if(!(_instance->smConnection))
+                        if(!(_instance->cecRouter))
                             return;
 			if ( _instance->m_logicalAddressAllocated == LogicalAddress::UNREGISTERED){
 				LOGERR("Logical Address NOT Allocated Or its not valid");
 				return;
 			}
 
-			_instance->smConnection->sendTo(LogicalAddress(LogicalAddress::BROADCAST), MessageEncoder().encode(SetStreamPath(physical_addr)), 500);
+			_instance->cecRouter->sendTo(_instance->m_logicalAddressAllocated, LogicalAddress(LogicalAddress::BROADCAST), MessageEncoder().encode(SetStreamPath(physical_addr)));
 		}
 
 		void HdmiCecSink::setRoutingChange(const std::string &from, const std::string &to) {
@@ -2132,9 +2132,9 @@ namespace WPEFramework
 				}
 			}
 			
-                        if(!(_instance->smConnection))
+                        if(!(_instance->cecRouter))
                             return;
-			_instance->smConnection->sendTo(LogicalAddress(LogicalAddress::BROADCAST), MessageEncoder().encode(RoutingChange(oldPhyAddr, newPhyAddr)), 500);
+			_instance->cecRouter->sendTo(_instance->m_logicalAddressAllocated, LogicalAddress(LogicalAddress::BROADCAST), MessageEncoder().encode(RoutingChange(oldPhyAddr, newPhyAddr)));
 		}
 
 		void HdmiCecSink::addDevice(const int logicalAddress) {
@@ -2211,13 +2211,13 @@ namespace WPEFramework
 			
 			if(!HdmiCecSink::_instance)
 				return;
-                        if(!(_instance->smConnection))
+                        if(!(_instance->cecRouter))
                             return;
 			if ( _instance->m_logicalAddressAllocated == LogicalAddress::UNREGISTERED || logicalAddress >= LogicalAddress::UNREGISTERED + TEST_ADD ){
 				LOGERR("Logical Address NOT Allocated Or its not valid");
 				return;
 			}
-			_instance->smConnection->sendTo(LogicalAddress(logicalAddress), MessageEncoder().encode(GiveDevicePowerStatus()), 100);
+			_instance->cecRouter->sendTo(_instance->m_logicalAddressAllocated, LogicalAddress(logicalAddress), MessageEncoder().encode(GiveDevicePowerStatus()));
 		}
 
 		void HdmiCecSink::request(const int logicalAddress) {
@@ -2226,7 +2226,7 @@ namespace WPEFramework
 			
 			if(!HdmiCecSink::_instance)
 				return;
-                        if(!(_instance->smConnection))
+                        if(!(_instance->cecRouter))
                             return;
 			if ( _instance->m_logicalAddressAllocated == LogicalAddress::UNREGISTERED || logicalAddress >= LogicalAddress::UNREGISTERED + TEST_ADD ){
 				LOGERR("Logical Address NOT Allocated Or its not valid");
@@ -2240,31 +2240,31 @@ namespace WPEFramework
 			{
 				case CECDeviceParams::REQUEST_PHISICAL_ADDRESS :
 				{
-					_instance->smConnection->sendTo(LogicalAddress(logicalAddress), MessageEncoder().encode(GivePhysicalAddress()), 200);
+					_instance->cecRouter->sendTo(_instance->m_logicalAddressAllocated, LogicalAddress(logicalAddress), MessageEncoder().encode(GivePhysicalAddress()));
 				}
 					break;
 
 				case CECDeviceParams::REQUEST_CEC_VERSION :
 				{
-					_instance->smConnection->sendTo(LogicalAddress(logicalAddress), MessageEncoder().encode(GetCECVersion()), 100);
+					_instance->cecRouter->sendTo(_instance->m_logicalAddressAllocated, LogicalAddress(logicalAddress), MessageEncoder().encode(GetCECVersion()));
 				}
 					break;
 
 				case CECDeviceParams::REQUEST_DEVICE_VENDOR_ID :
 				{
-					_instance->smConnection->sendTo(LogicalAddress(logicalAddress), MessageEncoder().encode(GiveDeviceVendorID()), 100);
+					_instance->cecRouter->sendTo(_instance->m_logicalAddressAllocated, LogicalAddress(logicalAddress), MessageEncoder().encode(GiveDeviceVendorID()));
 				}
 					break;
 
 				case CECDeviceParams::REQUEST_OSD_NAME :	
 				{
-					_instance->smConnection->sendTo(LogicalAddress(logicalAddress), MessageEncoder().encode(GiveOSDName()), 200);
+					_instance->cecRouter->sendTo(_instance->m_logicalAddressAllocated, LogicalAddress(logicalAddress), MessageEncoder().encode(GiveOSDName()));
 				}
 					break;
 
 				case CECDeviceParams::REQUEST_POWER_STATUS :	
 				{
-					_instance->smConnection->sendTo(LogicalAddress(logicalAddress), MessageEncoder().encode(GiveDevicePowerStatus()), 100);
+					_instance->cecRouter->sendTo(_instance->m_logicalAddressAllocated, LogicalAddress(logicalAddress), MessageEncoder().encode(GiveDevicePowerStatus()));
 				}
 					break;
 				default:
@@ -2424,7 +2424,7 @@ namespace WPEFramework
 			if(!HdmiCecSink::_instance)
                 return;
 
-                if(!(_instance->smConnection))
+                if(!(_instance->cecRouter))
                     return;
                LOGINFO("Entering ThreadRun: _instance->m_pollThreadExit %d isExit %d _instance->m_pollThreadState %d  _instance->m_pollNextState %d",_instance->m_pollThreadExit,isExit,_instance->m_pollThreadState,_instance->m_pollNextState );
 			_instance->m_sleepTime = HDMICECSINK_PING_INTERVAL_MS;
@@ -2453,7 +2453,6 @@ namespace WPEFramework
 					{
 						logicalAddress = LogicalAddress(_instance->m_logicalAddressAllocated);
 						LibCCEC::getInstance().addLogicalAddress(logicalAddress);
-						_instance->smConnection->setSource(logicalAddress);
 						_instance->m_numberOfDevices = 0;
 						_instance->deviceList[_instance->m_logicalAddressAllocated].m_deviceType = DeviceType::TV;
 						_instance->deviceList[_instance->m_logicalAddressAllocated].m_isDevicePresent = true;
@@ -2464,9 +2463,8 @@ namespace WPEFramework
 						_instance->deviceList[_instance->m_logicalAddressAllocated].m_vendorID = appVendorId;
 						_instance->deviceList[_instance->m_logicalAddressAllocated].m_powerStatus = PowerStatus(powerState);
 						_instance->deviceList[_instance->m_logicalAddressAllocated].m_currentLanguage = defaultLanguage;
-						_instance->smConnection->addFrameListener(_instance->msgFrameListener);
-						_instance->smConnection->sendTo(LogicalAddress(LogicalAddress::BROADCAST), 
-								MessageEncoder().encode(ReportPhysicalAddress(physical_addr, _instance->deviceList[_instance->m_logicalAddressAllocated].m_deviceType)), 100);
+						_instance->subscribeFrames();
+						_instance->cecRouter->sendTo(_instance->m_logicalAddressAllocated, LogicalAddress(LogicalAddress::BROADCAST), MessageEncoder().encode(ReportPhysicalAddress(physical_addr, _instance->deviceList[_instance->m_logicalAddressAllocated].m_deviceType)));
 
 						_instance->m_sleepTime = 0;
 						_instance->m_pollThreadState = POLL_THREAD_STATE_PING;
@@ -2627,7 +2625,7 @@ namespace WPEFramework
             bool gotLogicalAddress = false;
             int addr = LogicalAddress::TV;
             int i, j;
-            if (!(_instance->smConnection))
+            if (!(_instance->cecRouter))
                 return;
 
             for (i = 0; i< HDMICECSINK_NUMBER_TV_ADDR; i++)
@@ -2635,18 +2633,17 @@ namespace WPEFramework
                 /* poll for TV logical address - retry 5 times*/
                 for (j = 0; j < 5; j++)
                 {
-                    try {
-                        smConnection->poll(LogicalAddress(addr), Throw_e());
-                    }
-                    catch(CECNoAckException &e )
+                    // A polling message from the address to itself, not acknowledged while it is free
+                    CECRouter::SendResult result = cecRouter->ping(addr, addr);
+                    if (result == CECRouter::SEND_NO_ACK)
                     {
-                        LOGWARN("Poll caught %s \r\n",e.what());
+                        LOGWARN("Poll not acknowledged \r\n");
                         gotLogicalAddress = true;
                         break;
                     }
-                    catch(Exception &e)
+                    else if (result != CECRouter::SEND_OK)
                     {
-                        LOGWARN("Poll caught %s \r\n",e.what());
+                        LOGWARN("Poll result %d \r\n",result);
                         usleep(250000);
                     }
                 }
@@ -2669,6 +2666,18 @@ namespace WPEFramework
             LOGWARN("Logical Address for TV 0x%x \r\n",m_logicalAddressAllocated);
         }
 
+        void HdmiCecSink::subscribeFrames()
+        {
+            if (cecSubscription != 0)
+                return;
+
+            // The connection is shared, frames to the other logical addresses of the process are not for this one
+            cecSubscription = cecRouter->subscribe(CEC_ROUTER_ALL_OPCODES, [this](const CECRouter::Frame &frame) {
+                if (frame.destination == m_logicalAddressAllocated || frame.destination == LogicalAddress::BROADCAST)
+                    msgFrameListener->notify(CECFrame(frame.data, frame.len));
+            });
+        }
+
         void HdmiCecSink::allocateLogicalAddress(int deviceType)
         {
         	if( deviceType == DeviceType::TV )
@@ -2704,22 +2713,21 @@ namespace WPEFramework
             //Acquire CEC Addresses
             getPhysicalAddress();
 
-			smConnection = new Connection(LogicalAddress::UNREGISTERED,false,"ServiceManager::Connection::");
-            smConnection->open();
+            cecRouter = &CECFrameRouter::instance();
+            cecRouter->acquire();
             allocateLogicalAddress(DeviceType::TV);
             LOGINFO("logical address allocalted: %x  \n",m_logicalAddressAllocated);
-            if ( m_logicalAddressAllocated != LogicalAddress::UNREGISTERED && smConnection)
+            if ( m_logicalAddressAllocated != LogicalAddress::UNREGISTERED && cecRouter)
             {
                 logicalAddress = LogicalAddress(m_logicalAddressAllocated);
                 LOGINFO(" add logical address  %x  \n",m_logicalAddressAllocated);
                 LibCCEC::getInstance().addLogicalAddress(logicalAddress);
-                smConnection->setSource(logicalAddress);
             }
-            msgProcessor = new HdmiCecSinkProcessor(*smConnection);
+            msgProcessor = new HdmiCecSinkProcessor(*cecRouter);
             msgFrameListener = new HdmiCecSinkFrameListener(*msgProcessor);
-            if(smConnection)
+            if(cecRouter)
             {
-           		LOGWARN("Start Thread %p", smConnection );
+           		LOGWARN("Start Thread %p", cecRouter );
 			    m_pollThreadState = POLL_THREAD_STATE_POLL;
                             m_pollThreadExit = false;
 				m_pollThread = std::thread(threadRun);
@@ -2754,9 +2762,9 @@ namespace WPEFramework
 
              LOGINFO(" CECDisable ARC stopped ");
            cecEnableStatus = false;
-            if (smConnection != NULL)
+            if (cecRouter != NULL)
             {
-		LOGWARN("Stop Thread %p", smConnection );
+		LOGWARN("Stop Thread %p", cecRouter );
 		m_pollThreadExit = true;
 		m_ThreadExitCV.notify_one();
 
@@ -2764,7 +2772,7 @@ namespace WPEFramework
 		{
 			if (m_pollThread.joinable())
 			{
-				LOGWARN("Join Thread %p", smConnection );
+				LOGWARN("Join Thread %p", cecRouter );
 				m_pollThread.join();
 			}
 		}
@@ -2777,11 +2785,19 @@ namespace WPEFramework
 			LOGERR("exception in thread join %s", e.what());
 		}
 
-		LOGWARN("Deleted Thread %p", smConnection );
+		LOGWARN("Deleted Thread %p", cecRouter );
 
-                smConnection->close();
-                delete smConnection;
-                smConnection = NULL;
+                if (cecSubscription != 0)
+                {
+                    cecRouter->unsubscribe(cecSubscription);
+                    cecSubscription = 0;
+                }
+                delete msgFrameListener;
+                msgFrameListener = NULL;
+                delete msgProcessor;
+                msgProcessor = NULL;
+                cecRouter->release();
+                cecRouter = NULL;
             }
             
 	    m_logicalAddressAllocated = LogicalAddress::UNREGISTERED;
@@ -3095,19 +3111,19 @@ namespace WPEFramework
 	{
            if(!HdmiCecSink::_instance)
 	     return;
-           if(!(_instance->smConnection))
+           if(!(_instance->cecRouter))
                return;
           LOGINFO(" Send_Request_Arc_Initiation_Message ");
-           _instance->smConnection->sendTo(LogicalAddress::AUDIO_SYSTEM,MessageEncoder().encode(RequestArcInitiation()), 1000);
+           _instance->cecRouter->sendTo(_instance->m_logicalAddressAllocated, LogicalAddress::AUDIO_SYSTEM, MessageEncoder().encode(RequestArcInitiation()));
 
         }
         void HdmiCecSink::Send_Report_Arc_Initiated_Message()
         {   
             if(!HdmiCecSink::_instance)
 	    return;
-            if(!(_instance->smConnection))
+            if(!(_instance->cecRouter))
                return;
-            _instance->smConnection->sendTo(LogicalAddress::AUDIO_SYSTEM,MessageEncoder().encode(ReportArcInitiation()), 1000);
+            _instance->cecRouter->sendTo(_instance->m_logicalAddressAllocated, LogicalAddress::AUDIO_SYSTEM, MessageEncoder().encode(ReportArcInitiation()));
 
         }
         void HdmiCecSink::Send_Request_Arc_Termination_Message()
@@ -3115,18 +3131,18 @@ namespace WPEFramework
 
             if(!HdmiCecSink::_instance)
 	     return;
-            if(!(_instance->smConnection))
+            if(!(_instance->cecRouter))
                return;
-            _instance->smConnection->sendTo(LogicalAddress::AUDIO_SYSTEM,MessageEncoder().encode(RequestArcTermination()), 1000);
+            _instance->cecRouter->sendTo(_instance->m_logicalAddressAllocated, LogicalAddress::AUDIO_SYSTEM, MessageEncoder().encode(RequestArcTermination()));
         }
 
        void HdmiCecSink::Send_Report_Arc_Terminated_Message()
        {
             if(!HdmiCecSink::_instance)
 		return;
-            if(!(_instance->smConnection))
+            if(!(_instance->cecRouter))
                return;
-           _instance->smConnection->sendTo(LogicalAddress::AUDIO_SYSTEM,MessageEncoder().encode(ReportArcTermination()), 1000);
+           _instance->cecRouter->sendTo(_instance->m_logicalAddressAllocated, LogicalAddress::AUDIO_SYSTEM, MessageEncoder().encode(ReportArcTermination()));
 
        }
 
@@ -33,6 +33,7 @@
 
 #include "Module.h"
 #include "utils.h"
+#include "cecframerouter.h"
 #include "AbstractPlugin.h"
 #include "tptimer.h"
 #include <thread>
@@ -56,7 +57,7 @@ namespace WPEFramework {
         class HdmiCecSinkProcessor : public MessageProcessor
         {
         public:
-            HdmiCecSinkProcessor(Connection &conn) : conn(conn) {}
+            HdmiCecSinkProcessor(CECFrameRouter &router) : router(router) {}
                 void process (const ActiveSource &msg, const Header &header);
 	        void process (const InActiveSource &msg, const Header &header);
 	        void process (const ImageViewOn &msg, const Header &header);
@@ -88,7 +89,7 @@ namespace WPEFramework {
 		void process (const SetSystemAudioMode &msg, const Header &header);
 		void process (const ReportAudioStatus &msg, const Header &header);
         private:
-            Connection conn;
+            CECFrameRouter &router;
             void printHeader(const Header &header)
             {
                 printf("Header : From : %s \n", header.from.toString().c_str());
@@ -618,13 +619,15 @@ private:
             bool m_arcstarting;
             TpTimer m_arcStartStopTimer;
 
-            Connection *smConnection;
+            CECFrameRouter *cecRouter;
+            uint32_t cecSubscription;
 			std::vector<uint8_t> m_connectedDevices;
             HdmiCecSinkProcessor *msgProcessor;
             HdmiCecSinkFrameListener *msgFrameListener;
             const void InitializeIARM();
             void DeinitializeIARM();
 			void allocateLogicalAddress(int deviceType);
+			void subscribeFrames();
 			void allocateLAforTV();
 			void pingDevices(std::vector<int> &connected , std::vector<int> &disconnected);
 			void CheckHdmiInState();
@@ -37,6 +37,7 @@
 #include "websocket/URL.h"
 
 #include "utils.h"
+#include "settingsstore.h"
 
 #define HDMICEC2_METHOD_SET_ENABLED "setEnabled"
 #define HDMICEC2_METHOD_GET_ENABLED "getEnabled"
@@ -147,7 +148,7 @@ namespace WPEFramework
                   LOGINFO("sending  ActiveSource\n");
                   try
                   { 
-                      conn.sendTo(LogicalAddress::BROADCAST, MessageEncoder().encode(ActiveSource(physical_addr)));
+                      router.sendTo(logicalAddress, LogicalAddress::BROADCAST, MessageEncoder().encode(ActiveSource(physical_addr)));
                   } 
                   catch(...)
                   {
@@ -168,7 +169,7 @@ namespace WPEFramework
              LOGINFO("Command: GetCECVersion sending CECVersion response \n");
              try
              { 
-                 conn.sendTo(header.from, MessageEncoder().encode(CECVersion(Version::V_1_4)));
+                 router.sendTo(logicalAddress, header.from, MessageEncoder().encode(CECVersion(Version::V_1_4)));
              } 
              catch(...)
              {
@@ -194,7 +195,7 @@ namespace WPEFramework
                  LOGINFO("Command: GiveOSDName sending SetOSDName : %s\n",osdName.toString().c_str());
                  try
                  { 
-                     conn.sendTo(header.from, MessageEncoder().encode(SetOSDName(osdName)));
+                     router.sendTo(logicalAddress, header.from, MessageEncoder().encode(SetOSDName(osdName)));
                  }
                  catch(...)
                  {
@@ -208,7 +209,7 @@ namespace WPEFramework
              try
              { 
                  LOGINFO(" sending ReportPhysicalAddress response physical_addr :%s logicalAddress :%x \n",physical_addr.toString().c_str(), logicalAddress.toInt());
-                 conn.sendTo(LogicalAddress(LogicalAddress::BROADCAST), MessageEncoder().encode(ReportPhysicalAddress(physical_addr,logicalAddress.toInt()))); 
+                 router.sendTo(logicalAddress, LogicalAddress(LogicalAddress::BROADCAST), MessageEncoder().encode(ReportPhysicalAddress(physical_addr,logicalAddress.toInt()))); 
              } 
              catch(...)
              {
@@ -222,9 +223,9 @@ namespace WPEFramework
              {
                  LOGINFO("Command: GiveDeviceVendorID sending VendorID response :%s\n",(isLGTvConnected)?lgVendorId.toString().c_str():appVendorId.toString().c_str());
                  if(isLGTvConnected)
-                     conn.sendTo(LogicalAddress(LogicalAddress::BROADCAST), MessageEncoder().encode(DeviceVendorID(lgVendorId)));
+                     router.sendTo(logicalAddress, LogicalAddress(LogicalAddress::BROADCAST), MessageEncoder().encode(DeviceVendorID(lgVendorId)));
                  else 
-                     conn.sendTo(LogicalAddress(LogicalAddress::BROADCAST), MessageEncoder().encode(DeviceVendorID(appVendorId)));
+                     router.sendTo(logicalAddress, LogicalAddress(LogicalAddress::BROADCAST), MessageEncoder().encode(DeviceVendorID(appVendorId)));
              }
              catch(...)
              {
@@ -311,7 +312,7 @@ namespace WPEFramework
              LOGINFO("Command: GiveDevicePowerStatus sending powerState :%d \n",powerState);
              try
              { 
-                 conn.sendTo(header.from, MessageEncoder().encode(ReportPowerStatus(PowerStatus(powerState))));
+                 router.sendTo(logicalAddress, header.from, MessageEncoder().encode(ReportPowerStatus(PowerStatus(powerState))));
              } 
              catch(...)
              {
@@ -339,7 +340,7 @@ namespace WPEFramework
 		 LOGINFO("Command: Abort, sending FeatureAbort");
 		 try
 		 { 
-		     conn.sendTo(header.from, MessageEncoder().encode(FeatureAbort(OpCode(msg.opCode()),AbortReason(ABORT_REASON_ID))));
+		     router.sendTo(logicalAddress, header.from, MessageEncoder().encode(FeatureAbort(OpCode(msg.opCode()),AbortReason(ABORT_REASON_ID))));
 		 } 
 		 catch(...)
 		 {
@@ -387,7 +388,7 @@ namespace WPEFramework
            LOGWARN("Initlaizing CEC_2");
            string msg;
            HdmiCec_2::_instance = this;
-           smConnection = NULL;
+           cecRouter = NULL;
            IsCecMgrActivated = false;
            if (Utils::IARM::init()) {
 
@@ -481,8 +482,11 @@ namespace WPEFramework
                setEnabled(false,false);
            }
            HdmiCec_2::_instance = nullptr;
-           smConnection = NULL;
+           cecRouter = NULL;
            DeinitializeIARM();
+
+           // loadSettings reads the file, so it must not wait for SETTINGS_STORE_WRITE_DELAY_MS
+           SettingsStore::instance(CEC_SETTING_ENABLED_FILE).flush();
        }
 
        void HdmiCec_2::SendStandbyMsgEvent(const int logicalAddress)
@@ -513,10 +517,10 @@ namespace WPEFramework
             }
             if(true == cecEnableStatus)
             {
-                if (smConnection){
+                if (cecRouter){
                    try
                    {
-                       smConnection->sendTo(LogicalAddress(LogicalAddress::BROADCAST), MessageEncoder().encode(Standby()), 5000);
+                       cecRouter->sendTo(logicalAddress, LogicalAddress(LogicalAddress::BROADCAST), MessageEncoder().encode(Standby()));
 		       ret = true;
                    }
                    catch(...)
@@ -525,7 +529,7 @@ namespace WPEFramework
                    }
                 }
                 else {
-                    LOGWARN("smConnection is NULL");
+                    LOGWARN("cecRouter is NULL");
                 }
             }
             else
@@ -701,19 +705,19 @@ namespace WPEFramework
                  {
                     LOGWARN("Exception in getting edid info .\r\n");
                  }
-                 if(smConnection)
+                 if(cecRouter)
                  {
                      try
                      {
                          LOGINFO(" sending ReportPhysicalAddress response physical_addr :%s logicalAddress :%x \n",physical_addr.toString().c_str(), logicalAddress.toInt());
-                         smConnection->sendTo(LogicalAddress(LogicalAddress::BROADCAST), MessageEncoder().encode(ReportPhysicalAddress(physical_addr,logicalAddress.toInt()))); 
+                         cecRouter->sendTo(logicalAddress, LogicalAddress(LogicalAddress::BROADCAST), MessageEncoder().encode(ReportPhysicalAddress(physical_addr,logicalAddress.toInt()))); 
 
                          LOGINFO("Command: GiveDeviceVendorID sending VendorID response :%s\n", \
                              (isLGTvConnected)?lgVendorId.toString().c_str():appVendorId.toString().c_str());
                          if(isLGTvConnected)
-                             smConnection->sendTo(LogicalAddress(LogicalAddress::BROADCAST), MessageEncoder().encode(DeviceVendorID(lgVendorId)), 5000);
+                             cecRouter->sendTo(logicalAddress, LogicalAddress(LogicalAddress::BROADCAST), MessageEncoder().encode(DeviceVendorID(lgVendorId)));
                          else 
-                             smConnection->sendTo(LogicalAddress(LogicalAddress::BROADCAST), MessageEncoder().encode(DeviceVendorID(appVendorId)),5000);
+                             cecRouter->sendTo(logicalAddress, LogicalAddress(LogicalAddress::BROADCAST), MessageEncoder().encode(DeviceVendorID(appVendorId)));
                      } 
                      catch(...)
                      {
@@ -1023,35 +1027,39 @@ namespace WPEFramework
             getPhysicalAddress();
             getLogicalAddress();
 
-            smConnection = new Connection(logicalAddress.toInt(),false,"ServiceManager::Connection::");
-            smConnection->open();
-            msgProcessor = new HdmiCec_2Processor(*smConnection);
+            cecRouter = &CECFrameRouter::instance();
+            cecRouter->acquire();
+            msgProcessor = new HdmiCec_2Processor(*cecRouter);
             msgFrameListener = new HdmiCec_2FrameListener(*msgProcessor);
-            smConnection->addFrameListener(msgFrameListener);
+            // The connection is shared, frames to the other logical addresses of the process are not for this one
+            cecSubscription = cecRouter->subscribe(CEC_ROUTER_ALL_OPCODES, [this](const CECRouter::Frame &frame) {
+                if (frame.destination == logicalAddress.toInt() || frame.destination == LogicalAddress::BROADCAST)
+                    msgFrameListener->notify(CECFrame(frame.data, frame.len));
+            });
 
             cecEnableStatus = true;
 
-            if(smConnection)
+            if(cecRouter)
             {
                 LOGINFO("Command: sending GiveDevicePowerStatus \r\n");
-                smConnection->sendTo(LogicalAddress::TV, MessageEncoder().encode(GiveDevicePowerStatus()), 5000);
+                cecRouter->sendTo(logicalAddress, LogicalAddress::TV, MessageEncoder().encode(GiveDevicePowerStatus()));
                 LOGINFO("Command: sending request active Source isDeviceActiveSource is set to false\r\n");
-                smConnection->sendTo(LogicalAddress::BROADCAST, MessageEncoder().encode(RequestActiveSource()), 5000);
+                cecRouter->sendTo(logicalAddress, LogicalAddress::BROADCAST, MessageEncoder().encode(RequestActiveSource()));
                 isDeviceActiveSource = false;
                 LOGINFO("Command: GiveDeviceVendorID sending VendorID response :%s\n", \
                                                  (isLGTvConnected)?lgVendorId.toString().c_str():appVendorId.toString().c_str());
                 if(isLGTvConnected)
-                    smConnection->sendTo(LogicalAddress(LogicalAddress::BROADCAST), MessageEncoder().encode(DeviceVendorID(lgVendorId)), 5000);
+                    cecRouter->sendTo(logicalAddress, LogicalAddress(LogicalAddress::BROADCAST), MessageEncoder().encode(DeviceVendorID(lgVendorId)));
                 else 
-                    smConnection->sendTo(LogicalAddress(LogicalAddress::BROADCAST), MessageEncoder().encode(DeviceVendorID(appVendorId)),5000);
+                    cecRouter->sendTo(logicalAddress, LogicalAddress(LogicalAddress::BROADCAST), MessageEncoder().encode(DeviceVendorID(appVendorId)));
 
-                LOGWARN("Start Update thread %p", smConnection );
+                LOGWARN("Start Update thread %p", cecRouter );
                 m_updateThreadExit = false;
                 _instance->m_lockUpdate = PTHREAD_MUTEX_INITIALIZER;
                 _instance->m_condSigUpdate = PTHREAD_COND_INITIALIZER;
                 m_UpdateThread = std::thread(threadUpdateCheck);
 
-                LOGWARN("Start Thread %p", smConnection );
+                LOGWARN("Start Thread %p", cecRouter );
                 m_pollThreadExit = false;
                 _instance->m_numberOfDevices = 0;
                 _instance->m_lock = PTHREAD_MUTEX_INITIALIZER;
@@ -1078,16 +1086,16 @@ namespace WPEFramework
                 return;
             }
 
-            if (smConnection != NULL)
+            if (cecRouter != NULL)
             {
-                LOGWARN("Stop Thread %p", smConnection );
+                LOGWARN("Stop Thread %p", cecRouter );
 
                 m_updateThreadExit = true;
                 //Trigger codition to exit poll loop
                 pthread_cond_signal(&(_instance->m_condSigUpdate));
                 try {
                     if (m_UpdateThread.joinable()) {
-                       LOGWARN("Join update Thread %p", smConnection );
+                       LOGWARN("Join update Thread %p", cecRouter );
                        m_UpdateThread.join();
                     }
                 }
@@ -1097,14 +1105,14 @@ namespace WPEFramework
                 catch(const std::exception& e) {
                     LOGERR("exception in thread join %s", e.what());
                 }
-                LOGWARN("Deleted update Thread %p", smConnection );
+                LOGWARN("Deleted update Thread %p", cecRouter );
 
                 m_pollThreadExit = true;
                 //Trigger codition to exit poll loop
                 pthread_cond_signal(&(_instance->m_condSig));
                 try {
                     if (m_pollThread.joinable()) {
-                       LOGWARN("Join Thread %p", smConnection );
+                       LOGWARN("Join Thread %p", cecRouter );
                        m_pollThread.join();
                     }
                 }
@@ -1114,13 +1122,18 @@ namespace WPEFramework
                 catch(const std::exception& e) {
                     LOGERR("exception in thread join %s", e.what());
                 }
-                LOGWARN("Deleted Thread %p", smConnection );
+                LOGWARN("Deleted Thread %p", cecRouter );
                 //Clear cec device cache.
                 removeAllCecDevices();
 
-                smConnection->close();
-                delete smConnection;
-                smConnection = NULL;
+                cecRouter->unsubscribe(cecSubscription);
+                cecSubscription = 0;
+                delete msgFrameListener;
+                msgFrameListener = NULL;
+                delete msgProcessor;
+                msgProcessor = NULL;
+                cecRouter->release();
+                cecRouter = NULL;
             }
             cecEnableStatus = false;
 
@@ -1218,18 +1231,18 @@ namespace WPEFramework
             }
             if((true == cecEnableStatus) && (cecOTPSettingEnabled == true))
             {
-                if (smConnection)  {
+                if (cecRouter)  {
                     try
                     {
                         LOGINFO("Command: sending ImageViewOn TV \r\n");
-                        smConnection->sendTo(LogicalAddress::TV, MessageEncoder().encode(ImageViewOn()), 5000);
+                        cecRouter->sendTo(logicalAddress, LogicalAddress::TV, MessageEncoder().encode(ImageViewOn()));
                         usleep(10000);
                         LOGINFO("Command: sending ActiveSource  physical_addr :%s \r\n",physical_addr.toString().c_str());
-                        smConnection->sendTo(LogicalAddress::BROADCAST, MessageEncoder().encode(ActiveSource(physical_addr)), 5000);
+                        cecRouter->sendTo(logicalAddress, LogicalAddress::BROADCAST, MessageEncoder().encode(ActiveSource(physical_addr)));
                         usleep(10000);
                         isDeviceActiveSource = true;
                         LOGINFO("Command: sending GiveDevicePowerStatus \r\n");
-                        smConnection->sendTo(LogicalAddress::TV, MessageEncoder().encode(GiveDevicePowerStatus()), 5000);
+                        cecRouter->sendTo(logicalAddress, LogicalAddress::TV, MessageEncoder().encode(GiveDevicePowerStatus()));
                         ret = true;
                     }
                     catch(...)
@@ -1238,7 +1251,7 @@ namespace WPEFramework
                     }
                 }
                 else {
-                    LOGWARN("smConnection is NULL");
+                    LOGWARN("cecRouter is NULL");
                 }
             }
             else
@@ -1286,37 +1299,31 @@ namespace WPEFramework
 			LOGERR("HdmiCec_2::_instance not existing");
 			return isConnected;
 		}
-		if ( !(_instance->smConnection) || logicalAddress.toInt() == LogicalAddress::UNREGISTERED || (false==cecEnableStatus)){
-			LOGERR("Exiting from pingDeviceUpdateList _instance->smConnection:%p, logicalAddress:%d, cecEnableStatus=%d",
-					_instance->smConnection, logicalAddress.toInt(), cecEnableStatus);
+		if ( !(_instance->cecRouter) || logicalAddress.toInt() == LogicalAddress::UNREGISTERED || (false==cecEnableStatus)){
+			LOGERR("Exiting from pingDeviceUpdateList _instance->cecRouter:%p, logicalAddress:%d, cecEnableStatus=%d",
+					_instance->cecRouter, logicalAddress.toInt(), cecEnableStatus);
 			return isConnected;
 		}
 
 		LOGWARN("PING for  0x%x \r\n",idev);
-		try {
-			_instance->smConnection->ping(logicalAddress, LogicalAddress(idev), Throw_e());
-		}
-		catch(CECNoAckException &e)
+		CECRouter::SendResult result = _instance->cecRouter->ping(logicalAddress.toInt(), idev);
+		if (result == CECRouter::SEND_NO_ACK)
 		{
 			if (BIT_CHECK(_instance->deviceList[idev].m_deviceInfoStatus, BIT_DEVICE_PRESENT)) {
 				LOGINFO("Device disconnected: %d \r\n",idev);
 				removeDevice (idev);
 			} else {
-				LOGINFO("Device is not connected: %d. Ping caught %s\r\n",idev, e.what());
+				LOGINFO("Device is not connected: %d. Ping not acknowledged\r\n",idev);
 			}
 			isConnected = false;
 			return isConnected;;
 		}
-		catch(IOException &e)
+		else if (result != CECRouter::SEND_OK)
 		{
-			LOGINFO("Device is not reachable: %d. Ping caught %s\r\n",idev, e.what());
+			LOGINFO("Device is not reachable: %d. Ping result %d\r\n",idev, result);
 			isConnected = false;
 			return isConnected;;
 		}
-		catch(Exception &e)
-		{
-			LOGINFO("Ping caught %s \r\n",e.what());
-		}
 
 		/* If we get ACK, then the device is present in the network*/
 		isConnected = true;
@@ -1398,7 +1405,7 @@ namespace WPEFramework
 			CECFrame frame = CECFrame((const uint8_t *)buf.data(), size);
 			//      SVCLOG_WARN("Frame to be sent from servicemanager in %s \n",__FUNCTION__);
 			//      frame.hexDump();
-			smConnection->sendAsync(frame);
+			cecRouter->send(frame);
 		}
 		else
 			LOGWARN("cecEnableStatus=false");
@@ -1454,7 +1461,7 @@ namespace WPEFramework
 	{
 		if(!HdmiCec_2::_instance)
 			return;
-		if(!(_instance->smConnection))
+		if(!(_instance->cecRouter))
 			return;
 		LOGINFO("Entering ThreadRun: _instance->m_pollThreadExit %d",_instance->m_pollThreadExit);
 		int i = 0;
@@ -1484,7 +1491,7 @@ namespace WPEFramework
 	{
 		if(!HdmiCec_2::_instance)
 			return;
-		if(!(_instance->smConnection))
+		if(!(_instance->cecRouter))
 			return;
 		LOGINFO("Entering ThreadUpdate: _instance->m_updateThreadExit %d",_instance->m_updateThreadExit);
 		int i = 0;
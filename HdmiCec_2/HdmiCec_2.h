@@ -33,6 +33,7 @@
 
 #include "Module.h"
 #include "utils.h"
+#include "cecframerouter.h"
 #include "AbstractPlugin.h"
 
 namespace WPEFramework {
@@ -51,7 +52,7 @@ namespace WPEFramework {
         class HdmiCec_2Processor : public MessageProcessor
         {
         public:
-            HdmiCec_2Processor(Connection &conn) : conn(conn) {}
+            HdmiCec_2Processor(CECFrameRouter &router) : router(router) {}
                 void process (const ActiveSource &msg, const Header &header);
 	        void process (const InActiveSource &msg, const Header &header);
 	        void process (const ImageViewOn &msg, const Header &header);
@@ -78,7 +79,7 @@ namespace WPEFramework {
 	        void process (const Abort &msg, const Header &header);
 	        void process (const Polling &msg, const Header &header);
         private:
-            Connection conn;
+            CECFrameRouter &router;
             void printHeader(const Header &header)
             {
                 printf("Header : From : %s \n", header.from.toString().c_str());
@@ -198,7 +199,8 @@ namespace WPEFramework {
             bool cecOTPSettingEnabled;
             bool cecEnableStatus;
             bool IsCecMgrActivated;
-            Connection *smConnection;
+            CECFrameRouter *cecRouter;
+            uint32_t cecSubscription;
             int m_numberOfDevices;
             bool m_pollThreadExit;
             std::thread m_pollThread;
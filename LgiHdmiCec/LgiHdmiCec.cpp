@@ -40,6 +40,7 @@
 #include "websocket/URL.h"
 
 #include "utils.h"
+#include "settingsstore.h"
 
 #define HDMICEC_METHOD_SET_ENABLED "setEnabled"
 #define HDMICEC_METHOD_GET_ENABLED "getEnabled"
@@ -123,7 +124,7 @@ namespace WPEFramework
 
         LgiHdmiCec::LgiHdmiCec()
         : AbstractPluginWithApiAndIARMLock(),
-            cecSettingEnabled(false),cecEnableStatus(false),smConnection(nullptr),
+            cecSettingEnabled(false),cecEnableStatus(false),cecRouter(nullptr),cecSubscription(0),
             m_scan_id(0), m_updated(false), m_rescan_in_progress(true), m_system_audio_mode(false)
         {
             LgiHdmiCec::_instance = this;
@@ -171,6 +172,9 @@ namespace WPEFramework
 
             DeinitializeIARM();
 
+            // loadSettings reads the file, so it must not wait for SETTINGS_STORE_WRITE_DELAY_MS
+            SettingsStore::instance(CEC_SETTING_ENABLED_FILE).flush();
+
         }
 
         const void LgiHdmiCec::InitializeIARM()
@@ -661,9 +665,9 @@ namespace WPEFramework
             }
             libcecInitStatus++;
 
-            smConnection = new Connection(LogicalAddress::UNREGISTERED,false,"ServiceManager::Connection::");
-            smConnection->open();
-            smConnection->addFrameListener(this);
+            cecRouter = &CECFrameRouter::instance();
+            cecRouter->acquire();
+            cecSubscription = cecRouter->subscribe(CEC_ROUTER_ALL_OPCODES, [this](const CECRouter::Frame &frame) { onFrame(frame); });
 
             //Acquire CEC Addresses
             getPhysicalAddress();
@@ -692,11 +696,12 @@ namespace WPEFramework
             m_rescan_in_progress = false;
             m_scan_id = 0;
 
-            if (smConnection != NULL)
+            if (cecRouter != NULL)
             {
-                smConnection->close();
-                delete smConnection;
-                smConnection = NULL;
+                cecRouter->unsubscribe(cecSubscription);
+                cecSubscription = 0;
+                cecRouter->release();
+                cecRouter = NULL;
             }
             cecEnableStatus = false;
 
@@ -903,7 +908,7 @@ namespace WPEFramework
                 CECFrame frame = CECFrame((const uint8_t *)buf.data(), decodedLen);
         //      SVCLOG_WARN("Frame to be sent from servicemanager in %s \n",__FUNCTION__);
         //      frame.hexDump();
-                smConnection->sendAsync(frame);
+                cecRouter->send(frame);
             }
             else
                 LOGWARN("cecEnableStatus=false");
@@ -940,15 +945,11 @@ namespace WPEFramework
             return;
         }
 
-        void LgiHdmiCec::notify(const CECFrame &in) const
+        void LgiHdmiCec::onFrame(const CECRouter::Frame &frame)
         {
-            LOGINFO("Inside notify ");
-            size_t length;
-            const uint8_t *input_frameBuf = NULL;
-            CECFrame Frame = in;
-        //  SVCLOG_WARN("Frame received by servicemanager is \n");
-        //  Frame.hexDump();
-            Frame.getBuffer(&input_frameBuf,&length);
+            LOGINFO("Inside onFrame ");
+            size_t length = frame.len;
+            const uint8_t *input_frameBuf = frame.data;
 
             std::vector <char> buf;
             // base64 encoded string uses 4 characters for every 3 bytes (using padding if necessary) - so assume padding is used
@@ -960,7 +961,7 @@ namespace WPEFramework
             uint16_t encodedLen = Core::URL::Base64Encode(input_frameBuf, length, buf.data(), buf.size());
             buf[encodedLen] = 0;
 
-            (const_cast<LgiHdmiCec*>(this))->onMessage(buf.data());
+            onMessage(buf.data());
             return;
         }
 
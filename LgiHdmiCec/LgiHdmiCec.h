@@ -33,6 +33,7 @@
 
 #include "Module.h"
 #include "utils.h"
+#include "cecframerouter.h"
 #include "AbstractPluginWithApiAndIARMLock.h"
 
 namespace WPEFramework {
@@ -51,7 +52,7 @@ namespace WPEFramework {
 		// As the registration/unregistration of notifications is realized by the class PluginHost::JSONRPC,
 		// this class exposes a public method called, Notify(), using this methods, all subscribed clients
 		// will receive a JSONRPC message as a notification, in case this method is called.
-        class LgiHdmiCec : public AbstractPluginWithApiAndIARMLock, public FrameListener {
+        class LgiHdmiCec : public AbstractPluginWithApiAndIARMLock {
         private:
 
             // We do not allow this plugin to be copied !!
@@ -84,7 +85,8 @@ namespace WPEFramework {
             unsigned int physicalAddress;
             std::atomic_bool cecSettingEnabled;
             std::atomic_bool cecEnableStatus;
-            Connection *smConnection;
+            CECFrameRouter *cecRouter;
+            uint32_t cecSubscription;
 
             const void InitializeIARM();
             void DeinitializeIARM();
@@ -126,7 +128,7 @@ namespace WPEFramework {
             void sendMessage(std::string message);
             void cecAddressesChanged(int changeStatus);
 
-            void notify(const CECFrame &in) const;
+            void onFrame(const CECRouter::Frame &frame);
             void onMessage(const char *message);
 
             std::atomic<int> m_scan_id;
@@ -36,6 +36,14 @@
 #include <iomanip>
 #include <bits/stdc++.h>
 #include <algorithm>
+#include <spawn.h>
+#include <fcntl.h>
+#include <signal.h>
+#include <unistd.h>
+#include <strings.h>
+#include <sys/wait.h>
+#include <sys/resource.h>
+#include <sys/syscall.h>
 
 #include "MaintenanceManager.h"
 #include "utils.h"
@@ -70,6 +78,17 @@ using namespace std;
 #define TR181_AUTOREBOOT_ENABLE "Device.DeviceInfo.X_RDKCENTRAL-COM_RFC.Feature.AutoReboot.Enable"
 #define TR181_STOP_MAINTENANCE  "Device.DeviceInfo.X_RDKCENTRAL-COM_RFC.Feature.StopMaintenance.Enable"
 
+#define RDKSHELL_CALLSIGN_VER   "org.rdk.RDKShell.1"
+#define RESIDENT_APP_CLIENT     "residentapp"
+
+/* no glibc wrapper for ioprio_set */
+#define IOPRIO_WHO_PGRP         2
+#define IOPRIO_CLASS_SHIFT      13
+#define IOPRIO_CLASS_NONE       0
+#define IOPRIO_CLASS_IDLE       3
+
+extern char **environ;
+
 string notifyStatusToString(Maint_notify_status_t &status)
 {
     string ret_status="";
@@ -177,8 +196,6 @@ namespace WPEFramework {
             "/lib/rdk/Start_uploadSTBLogs.sh"
         };
 
-        vector<string> tasks;
-
         string script_names[]={
             "DCMscript_maintaince.sh",
             "RFCbase.sh",
@@ -191,6 +208,7 @@ namespace WPEFramework {
          */
         MaintenanceManager::MaintenanceManager()
             :AbstractPlugin()
+            ,m_stopping(false)
         {
             MaintenanceManager::_instance = this;
 
@@ -213,23 +231,154 @@ namespace WPEFramework {
             MaintenanceManager::m_task_map[task_names_foreground[1].c_str()]=false;
             MaintenanceManager::m_task_map[task_names_foreground[2].c_str()]=false;
 
-
+            /* RFC before swupdate; log upload only needs the DCM settings */
+            m_tasks.emplace_back("DCM", "/lib/rdk/StartDCM_maintaince.sh", "/lib/rdk/StartDCM_maintaince.sh", "", 0);
+            m_tasks.emplace_back("RFC", task_names_foreground[0], "/lib/rdk/RFCbase.sh", "", (1 << TASK_DCM));
+            m_tasks.emplace_back("SWUPDATE", task_names_foreground[1], "/lib/rdk/swupdate_utility.sh", "/opt/logs/swupdate.log", (1 << TASK_RFC));
+            m_tasks.emplace_back("LOGUPLOAD", task_names_foreground[2], "/lib/rdk/Start_uploadSTBLogs.sh", "", (1 << TASK_DCM));
          }
 
-        void MaintenanceManager::task_execution_thread(){
-            uint8_t i=0;
-            string cmd="";
-            bool internetConnectStatus=false;
+        MaintenanceManager::MaintenanceTask::MaintenanceTask(const std::string& name, const std::string& key,
+                const std::string& script, const std::string& log, uint32_t deps)
+            : taskName(name)
+            , taskKey(key)
+            , taskScript(script)
+            , taskLog(log)
+            , dependencies(deps)
+            , state(NOT_SCHEDULED)
+            , pid(-1)
+            , pgid(-1)
+            , throttled(false)
+            , startTime(0)
+            , throttledMs(0)
+        {
+        }
+
+        void MaintenanceManager::MaintenanceTask::reset(State initial)
+        {
+            state = initial;
+            pid = -1;
+            pgid = -1;
+            throttled = false;
+            startTime = 0;
+            throttledMs = 0;
+        }
+
+        /* Runs the script in its own process group, so that throttling
+         * and stopMaintenance reach the processes it starts as well */
+        bool MaintenanceManager::MaintenanceTask::startTask(bool throttle)
+        {
+            posix_spawnattr_t attr;
+            posix_spawn_file_actions_t actions;
+            sigset_t mask;
+            char *argv[] = { const_cast<char*>(taskScript.c_str()), NULL };
+            pid_t child = -1;
+
+            posix_spawnattr_init(&attr);
+            posix_spawn_file_actions_init(&actions);
+            sigemptyset(&mask);
+            posix_spawnattr_setsigmask(&attr, &mask);
+            posix_spawnattr_setpgroup(&attr, 0);
+            posix_spawnattr_setflags(&attr, POSIX_SPAWN_SETPGROUP | POSIX_SPAWN_SETSIGMASK);
+            if (!taskLog.empty()) {
+                posix_spawn_file_actions_addopen(&actions, STDOUT_FILENO, taskLog.c_str(), O_WRONLY | O_CREAT | O_APPEND, 0644);
+            }
+
+            int ret = posix_spawn(&child, taskScript.c_str(), &actions, &attr, argv, environ);
+
+            posix_spawn_file_actions_destroy(&actions);
+            posix_spawnattr_destroy(&attr);
+
+            started = std::chrono::steady_clock::now();
+            startTime = time(nullptr);
+            if (ret != 0) {
+                LOGERR("Failed to start %s: %s", taskScript.c_str(), strerror(ret));
+                return false;
+            }
+
+            LOGINFO("Started %s [pid %d]%s", taskScript.c_str(), child, throttle ? " throttled" : "");
+            state = RUNNING;
+            pid = child;
+            pgid = child;
+            this->throttle(throttle);
+            return true;
+        }
+
+        void MaintenanceManager::MaintenanceTask::finish(State result)
+        {
+            throttle(false);
+            state = result;
+            ended = std::chrono::steady_clock::now();
+            pgid = -1;
+        }
 
-            /* cleanup if not empty */
-            if(!tasks.empty()){
-                tasks.erase (tasks.begin(),tasks.end());
+        void MaintenanceManager::MaintenanceTask::reap()
+        {
+            if (pid <= 0) {
+                return;
+            }
+            int status = 0;
+            pid_t ret = waitpid(pid, &status, WNOHANG);
+            /* ECHILD: SIGCHLD is ignored and the child was reaped for us */
+            if (ret == pid || (ret < 0 && errno == ECHILD)) {
+                pid = -1;
             }
+        }
+
+        void MaintenanceManager::MaintenanceTask::throttle(bool enable)
+        {
+            if (state != RUNNING || pgid <= 0 || enable == throttled) {
+                return;
+            }
+            int ioprio = (enable ? IOPRIO_CLASS_IDLE : IOPRIO_CLASS_NONE) << IOPRIO_CLASS_SHIFT;
+            if (setpriority(PRIO_PGRP, pgid, enable ? TASK_THROTTLE_NICE : 0) != 0
+                    || syscall(SYS_ioprio_set, IOPRIO_WHO_PGRP, pgid, ioprio) != 0) {
+                LOGWARN("Failed to %s %s: %s", enable ? "throttle" : "unthrottle", taskName.c_str(), strerror(errno));
+            }
+
+            std::chrono::steady_clock::time_point now = std::chrono::steady_clock::now();
+            if (enable) {
+                throttledSince = now;
+            } else {
+                throttledMs += std::chrono::duration_cast<std::chrono::milliseconds>(now - throttledSince).count();
+            }
+            throttled = enable;
+        }
+
+        bool MaintenanceManager::MaintenanceTask::isDone() const
+        {
+            return state == NOT_SCHEDULED || state == SUCCEEDED || state == FAILED || state == SKIPPED;
+        }
+
+        void MaintenanceManager::MaintenanceTask::toJson(JsonObject& timing) const
+        {
+            static const char* states[] = { "NOT_SCHEDULED", "PENDING", "RUNNING", "SUCCESS", "ERROR", "SKIPPED" };
+            std::chrono::steady_clock::time_point now = std::chrono::steady_clock::now();
+            uint64_t duration = 0;
+            uint64_t throttledDuration = throttledMs;
+
+            if (startTime != 0) {
+                duration = std::chrono::duration_cast<std::chrono::milliseconds>((state == RUNNING ? now : ended) - started).count();
+            }
+            if (throttled) {
+                throttledDuration += std::chrono::duration_cast<std::chrono::milliseconds>(now - throttledSince).count();
+            }
+
+            timing["task"] = taskName;
+            timing["status"] = states[state];
+            timing["startTime"] = static_cast<uint64_t>(startTime);
+            timing["duration"] = duration;
+            timing["throttledDuration"] = throttledDuration;
+        }
+
+        void MaintenanceManager::task_execution_thread(){
+            bool internetConnectStatus=false;
+            bool runMaintenance=true;
+            bool skipFirmwareCheck=false;
 
             /* Controlled by CFLAGS */
 #if defined(SUPPRESS_MAINTENANCE)
             bool activationStatus=false;
-            bool skipFirmwareCheck=false;
 
             /* Activation check */
             activationStatus = getActivatedStatus(skipFirmwareCheck);
@@ -241,85 +390,227 @@ namespace WPEFramework {
                 /* Network check */
                 internetConnectStatus = isDeviceOnline();
             }
+            runMaintenance = activationStatus;
 #else
             internetConnectStatus = isDeviceOnline();
 #endif
             LOGINFO("Reboot_Pending :%s",g_is_reboot_pending.c_str());
 
-            MaintenanceManager::_instance->onMaintenanceStatusChange(MAINTENANCE_STARTED);
-#if defined(SUPPRESS_MAINTENANCE)
             /* decide which all tasks are needed based on the activation status */
-            if (activationStatus){
-                if(skipFirmwareCheck){
-                    /* set the task status of swupdate */
-                    SET_STATUS(g_task_status,DIFD_SUCCESS);
-                    SET_STATUS(g_task_status,DIFD_COMPLETE);
-
-                    /* Add tasks */
-                    tasks.push_back("/lib/rdk/RFCbase.sh");
-                    tasks.push_back("/lib/rdk/Start_uploadSTBLogs.sh");
-                }else{
-                    tasks.push_back("/lib/rdk/RFCbase.sh");
-                    tasks.push_back("/lib/rdk/swupdate_utility.sh >> /opt/logs/swupdate.log");
-                    tasks.push_back("/lib/rdk/Start_uploadSTBLogs.sh");
+            {
+                std::lock_guard<std::mutex> lck(m_taskMutex);
+                if (runMaintenance && internetConnectStatus) {
+                    /* Unsolicited maintenance waits for the DCM started on bootup,
+                     * in solicited we dont touch DCM (see runTasks) */
+                    if (SOLICITED_MAINTENANCE == g_maintenance_type && !m_tasks[TASK_DCM].isAlive()) {
+                        m_tasks[TASK_DCM].reset(MaintenanceTask::SKIPPED);
+                    }
+                    m_tasks[TASK_RFC].reset(MaintenanceTask::PENDING);
+                    if (skipFirmwareCheck) {
+                        /* set the task status of swupdate */
+                        SET_STATUS(g_task_status,DIFD_SUCCESS);
+                        SET_STATUS(g_task_status,DIFD_COMPLETE);
+                        m_tasks[TASK_SWUPDATE].reset(MaintenanceTask::SKIPPED);
+                    }
+                    else {
+                        m_tasks[TASK_SWUPDATE].reset(MaintenanceTask::PENDING);
+                    }
+                    m_tasks[TASK_LOGUPLOAD].reset(MaintenanceTask::PENDING);
                 }
-            }
-#else
-            tasks.push_back("/lib/rdk/RFCbase.sh");
-            tasks.push_back("/lib/rdk/swupdate_utility.sh >> /opt/logs/swupdate.log");
-            tasks.push_back("/lib/rdk/Start_uploadSTBLogs.sh");
-#endif
-            std::unique_lock<std::mutex> lck(m_callMutex);
-
-            // Unsolicited part comes here
-            if (UNSOLICITED_MAINTENANCE == g_maintenance_type && internetConnectStatus){
-                LOGINFO("---------------UNSOLICITED_MAINTENANCE--------------");
-                for( i = 0; i < tasks.size(); i++) {
-                    LOGINFO("waiting to unlock.. [%d/%d]",i,tasks.size());
-                    task_thread.wait(lck);
-                    cmd = tasks[i];
-                    cmd += " &";
-                    cmd += "\0";
-                    m_task_map[tasks[i]] = true;
-
-                    if ( !m_abort_flag ){
-                        LOGINFO("Starting Script (USM) :  %s \n", cmd.c_str());
-                        system(cmd.c_str());
+                else {
+                    for (int i = TASK_RFC; i < TASK_COUNT; i++) {
+                        m_tasks[i].reset(MaintenanceTask::NOT_SCHEDULED);
                     }
                 }
             }
-            /* Here in Solicited, we start with RFC so no
-             * need to wait for any DCM events */
-            else if( SOLICITED_MAINTENANCE == g_maintenance_type && internetConnectStatus){
-                LOGINFO("=============SOLICITED_MAINTENANCE===============");
-                cmd = tasks[0];
-                cmd += " &";
-                cmd += "\0";
-                m_task_map[tasks[0]] = true;
-                LOGINFO("Starting Script (SM) :  %s \n", cmd.c_str());
-                system(cmd.c_str());
-                cmd="";
-                for( i = 1; i < tasks.size(); i++){
-                    LOGINFO("Waiting to unlock.. [%d/%d]",i,tasks.size());
-                    task_thread.wait(lck);
-                    cmd = tasks[i];
-                    cmd += " &";
-                    cmd += "\0";
-                    m_task_map[tasks[i]]=true;
-                    if ( !m_abort_flag ){
-                        LOGINFO("Starting Script (SM) :  %s \n",cmd.c_str());
-                        system(cmd.c_str());
-                    }
+
+            if (m_shellClient == nullptr) {
+                subscribeToShellEvents();
+            }
+
+            onMaintenanceStatusChange(MAINTENANCE_STARTED);
+
+            if (internetConnectStatus) {
+                if (UNSOLICITED_MAINTENANCE == g_maintenance_type) {
+                    LOGINFO("---------------UNSOLICITED_MAINTENANCE--------------");
+                }
+                else {
+                    LOGINFO("=============SOLICITED_MAINTENANCE===============");
                 }
+                runTasks();
             }
+
             m_abort_flag=false;
             LOGINFO("Worker Thread Completed");
             if ( false == internetConnectStatus ) {
-                MaintenanceManager::_instance->onMaintenanceStatusChange(MAINTENANCE_ERROR);
+                onMaintenanceStatusChange(MAINTENANCE_ERROR);
                 LOGINFO("Maintenance completed as it is offline mode");
             }
         }
 
+        /* Starts every pending task once the tasks it depends on are done,
+         * so independent tasks run in parallel. Tasks are done when their
+         * IARM completion event arrives (taskFinished) */
+        void MaintenanceManager::runTasks()
+        {
+            std::unique_lock<std::mutex> lck(m_taskMutex);
+            uint32_t ignored = (SOLICITED_MAINTENANCE == g_maintenance_type) ? (1 << TASK_DCM) : 0;
+
+            while (!m_stopping) {
+                bool foreground = !m_foregroundApps.empty();
+                bool pending = false;
+                bool running = false;
+                bool alive = false;
+
+                for (int i = 0; i < TASK_COUNT; i++) {
+                    MaintenanceTask& task = m_tasks[i];
+                    task.reap();
+                    if (ignored & (1 << i)) {
+                        continue;
+                    }
+
+                    if (MaintenanceTask::PENDING == task.state && !m_abort_flag) {
+                        bool ready = true;
+                        for (int dep = 0; dep < TASK_COUNT; dep++) {
+                            if ((task.dependencies & ~ignored & (1 << dep)) && !m_tasks[dep].isDone()) {
+                                ready = false;
+                            }
+                        }
+                        if (ready) {
+                            m_task_map[task.taskKey] = true;
+                            if (!task.startTask(foreground)) {
+                                m_task_map[task.taskKey] = false;
+                                task.finish(MaintenanceTask::FAILED);
+                            }
+                        }
+                    }
+
+                    task.throttle(foreground);
+                    pending |= (MaintenanceTask::PENDING == task.state);
+                    running |= (MaintenanceTask::RUNNING == task.state);
+                    alive |= task.isAlive();
+                }
+
+                /* on abort we only wait for the stopped scripts to exit */
+                if (m_abort_flag && !alive) {
+                    for (int i = 0; i < TASK_COUNT; i++) {
+                        if (MaintenanceTask::PENDING == m_tasks[i].state) {
+                            m_tasks[i].finish(MaintenanceTask::SKIPPED);
+                        }
+                    }
+                    break;
+                }
+                if (!pending && !running) {
+                    break;
+                }
+
+                task_thread.wait_for(lck, std::chrono::seconds(TASK_POLL_INTERVAL_SEC));
+            }
+
+            /* scripts report completion just before they exit, give them some time */
+            for (int wait = 0; wait < TASK_EXIT_TIMEOUT_SEC * 10 && !m_stopping; wait++) {
+                bool alive = false;
+                for (int i = 0; i < TASK_COUNT; i++) {
+                    m_tasks[i].reap();
+                    alive |= m_tasks[i].isAlive();
+                }
+                if (!alive) {
+                    break;
+                }
+                task_thread.wait_for(lck, std::chrono::milliseconds(100));
+            }
+        }
+
+        void MaintenanceManager::taskFinished(Maint_task_t task, bool success, bool skipped)
+        {
+            std::lock_guard<std::mutex> lck(m_taskMutex);
+            if (MaintenanceTask::RUNNING == m_tasks[task].state || MaintenanceTask::PENDING == m_tasks[task].state) {
+                m_tasks[task].finish(skipped ? MaintenanceTask::SKIPPED : (success ? MaintenanceTask::SUCCEEDED : MaintenanceTask::FAILED));
+            }
+            task_thread.notify_all();
+        }
+
+        /* Retry delay that ends early when the plugin is deinitialized */
+        bool MaintenanceManager::waitForRetry(int seconds)
+        {
+            std::unique_lock<std::mutex> lck(m_taskMutex);
+            task_thread.wait_for(lck, std::chrono::seconds(seconds), [this]() { return m_stopping; });
+            return !m_stopping;
+        }
+
+        void MaintenanceManager::getTaskTimings(JsonArray& timings)
+        {
+            std::lock_guard<std::mutex> lck(m_taskMutex);
+            for (int i = 0; i < TASK_COUNT; i++) {
+                if (MaintenanceTask::NOT_SCHEDULED != m_tasks[i].state) {
+                    JsonObject timing;
+                    m_tasks[i].toJson(timing);
+                    timings.Add(timing);
+                }
+            }
+        }
+
+        bool MaintenanceManager::subscribeToShellEvents()
+        {
+            uint32_t err = Core::ERROR_NONE;
+
+            Core::SystemInfo::SetEnvironment(_T("THUNDER_ACCESS"), (_T(SERVER_DETAILS)));
+            m_shellClient = make_shared<WPEFramework::JSONRPC::LinkType<Core::JSON::IElement>>(_T(RDKSHELL_CALLSIGN_VER), (_T(RDKSHELL_CALLSIGN_VER)));
+
+            err = m_shellClient->Subscribe<JsonObject>(1000, _T("onLaunched"), &MaintenanceManager::onShellAppLaunched, this);
+            if (Core::ERROR_NONE == err) {
+                err = m_shellClient->Subscribe<JsonObject>(1000, _T("onSuspended"), &MaintenanceManager::onShellAppStopped, this);
+            }
+            if (Core::ERROR_NONE == err) {
+                err = m_shellClient->Subscribe<JsonObject>(1000, _T("onDestroyed"), &MaintenanceManager::onShellAppStopped, this);
+            }
+
+            if (Core::ERROR_NONE != err) {
+                LOGWARN("Failed to subscribe for RDKShell events with code %d, tasks will not be throttled", err);
+                unsubscribeFromShellEvents();
+                return false;
+            }
+            LOGINFO("Subscribed for RDKShell events");
+            return true;
+        }
+
+        void MaintenanceManager::unsubscribeFromShellEvents()
+        {
+            if (m_shellClient == nullptr) {
+                return;
+            }
+            m_shellClient->Unsubscribe(1000, _T("onLaunched"));
+            m_shellClient->Unsubscribe(1000, _T("onSuspended"));
+            m_shellClient->Unsubscribe(1000, _T("onDestroyed"));
+            m_shellClient.reset();
+        }
+
+        /* An app other than the resident app in the foreground means
+         * someone is watching, tasks are throttled until it goes away */
+        void MaintenanceManager::onShellAppLaunched(const JsonObject& parameters)
+        {
+            string client = parameters["client"].String();
+            if (0 == strcasecmp(client.c_str(), RESIDENT_APP_CLIENT)) {
+                return;
+            }
+
+            std::lock_guard<std::mutex> lck(m_taskMutex);
+            if (parameters["launchType"].String() == "suspend") {
+                m_foregroundApps.erase(client);
+            }
+            else {
+                m_foregroundApps.insert(client);
+            }
+            task_thread.notify_all();
+        }
+
+        void MaintenanceManager::onShellAppStopped(const JsonObject& parameters)
+        {
+            std::lock_guard<std::mutex> lck(m_taskMutex);
+            m_foregroundApps.erase(parameters["client"].String());
+            task_thread.notify_all();
+        }
+
         const string MaintenanceManager::checkActivatedStatus()
         {
             JsonObject joGetParams;
@@ -338,7 +629,9 @@ namespace WPEFramework {
                 do{
                     isAuthSerivcePluginActive = Utils::isPluginActivated("org.rdk.AuthService");
                     if ( !isAuthSerivcePluginActive ){
-                        sleep(10);
+                        if (!waitForRetry(10)) {
+                            break;
+                        }
                         i++;
                         LOGINFO("AuthService retries [%d/4] \n",i);
                     }
@@ -477,7 +770,9 @@ namespace WPEFramework {
             do{
                 network_available = checkNetwork();
                 if ( !network_available ){
-                    sleep(30);
+                    if (!waitForRetry(30)) {
+                        break;
+                    }
                     i++;
                     LOGINFO("Network retries [%d/4] \n",i);
                 }else{
@@ -499,6 +794,7 @@ namespace WPEFramework {
 
         const string MaintenanceManager::Initialize(PluginHost::IShell*)
         {
+            m_stopping = false;
 #if defined(USE_IARMBUS) || defined(USE_IARM_BUS)
             InitializeIARM();
 #endif /* defined(USE_IARMBUS) || defined(USE_IARM_BUS) */
@@ -508,9 +804,15 @@ namespace WPEFramework {
 
         void MaintenanceManager::Deinitialize(PluginHost::IShell*)
         {
+            {
+                std::lock_guard<std::mutex> lck(m_taskMutex);
+                m_stopping = true;
+                task_thread.notify_all();
+            }
 #if defined(USE_IARMBUS) || defined(USE_IARM_BUS)
             DeinitializeIARM();
 #endif /* defined(USE_IARMBUS) || defined(USE_IARM_BUS) */
+            unsubscribeFromShellEvents();
         }
 
 #if defined(USE_IARMBUS) || defined(USE_IARM_BUS)
@@ -560,21 +862,29 @@ namespace WPEFramework {
             /* we post just to tell that we are in idle at this moment */
             MaintenanceManager::_instance->onMaintenanceStatusChange(m_notify_status);
 
-            int32_t exec_status=E_NOK;
-
             /* we call dcmscript to get the new start time */
-            if (Utils::fileExists("/lib/rdk/StartDCM_maintaince.sh")) {
-                exec_status = system("/lib/rdk/StartDCM_maintaince.sh &");
-                if ( E_OK == exec_status ){
-                    LOGINFO("DBG:Succesfully executed StartDCM_maintaince.sh \n");
-                    m_task_map["/lib/rdk/StartDCM_maintaince.sh"]=true;
+            {
+                std::lock_guard<std::mutex> lck(m_taskMutex);
+                MaintenanceTask& dcm = m_tasks[TASK_DCM];
+                dcm.reset(MaintenanceTask::PENDING);
+                if (Utils::fileExists(dcm.taskScript.c_str())) {
+                    m_task_map[dcm.taskKey]=true;
+                    if (dcm.startTask(!m_foregroundApps.empty())){
+                        LOGINFO("DBG:Succesfully executed StartDCM_maintaince.sh \n");
+                    }
+                    else {
+                        LOGINFO("DBG:Failed to execute StartDCM_maintaince.sh !! \n");
+                        m_task_map[dcm.taskKey]=false;
+                    }
                 }
                 else {
-                    LOGINFO("DBG:Failed to execute StartDCM_maintaince.sh !! \n");
+                    LOGINFO("DBG: Unable to find StartDCM_maintaince.sh \n");
+                }
+                /* tasks waiting on DCM should not wait for an event that never comes */
+                if (MaintenanceTask::RUNNING != dcm.state) {
+                    dcm.finish(MaintenanceTask::FAILED);
+                    SET_STATUS(g_task_status,DCM_COMPLETE);
                 }
-            }
-            else {
-                LOGINFO("DBG: Unable to find StartDCM_maintaince.sh \n");
             }
 
             /* we moved every thing to a thread */
@@ -635,7 +945,7 @@ namespace WPEFramework {
                             else {
                                  SET_STATUS(g_task_status,RFC_SUCCESS);
                                  SET_STATUS(g_task_status,RFC_COMPLETE);
-                                 task_thread.notify_one();
+                                 taskFinished(TASK_RFC, true);
                                  m_task_map[task_names_foreground[0].c_str()]=false;
                             }
                             break;
@@ -647,7 +957,7 @@ namespace WPEFramework {
                             else {
                                 SET_STATUS(g_task_status,DCM_SUCCESS);
                                 SET_STATUS(g_task_status,DCM_COMPLETE);
-                                task_thread.notify_one();
+                                taskFinished(TASK_DCM, true);
                                 m_task_map["/lib/rdk/StartDCM_maintaince.sh"]=false;
                             }
                             break;
@@ -659,7 +969,7 @@ namespace WPEFramework {
                             else {
                                 SET_STATUS(g_task_status,DIFD_SUCCESS);
                                 SET_STATUS(g_task_status,DIFD_COMPLETE);
-                                task_thread.notify_one();
+                                taskFinished(TASK_SWUPDATE, true);
                                 m_task_map[task_names_foreground[1].c_str()]=false;
                             }
                             break;
@@ -671,6 +981,7 @@ namespace WPEFramework {
                             else {
                                 SET_STATUS(g_task_status,LOGUPLOAD_SUCCESS);
                                 SET_STATUS(g_task_status,LOGUPLOAD_COMPLETE);
+                                taskFinished(TASK_LOGUPLOAD, true);
                                 m_task_map[task_names_foreground[2].c_str()]=false;
                             }
 
@@ -686,7 +997,7 @@ namespace WPEFramework {
                             SET_STATUS(g_task_status,TASK_SKIPPED);
                             /* we say FW update task complete */
                             SET_STATUS(g_task_status,DIFD_COMPLETE);
-                            task_thread.notify_one();
+                            taskFinished(TASK_SWUPDATE, false, true);
                             m_task_map[task_names_foreground[1].c_str()]=false;
                             LOGINFO("FW Download task aborted \n");
                             break;
@@ -696,7 +1007,7 @@ namespace WPEFramework {
                             }
                             else {
                                 SET_STATUS(g_task_status,DCM_COMPLETE);
-                                task_thread.notify_one();
+                                taskFinished(TASK_DCM, false);
                                 LOGINFO("Error encountered in DCM script task \n");
                                 m_task_map["/lib/rdk/StartDCM_maintaince.sh"]=false;
                             }
@@ -708,7 +1019,7 @@ namespace WPEFramework {
                             }
                             else {
                                  SET_STATUS(g_task_status,RFC_COMPLETE);
-                                 task_thread.notify_one();
+                                 taskFinished(TASK_RFC, false);
                                  LOGINFO("Error encountered in RFC script task \n");
                                  m_task_map[task_names_foreground[0].c_str()]=false;
                             }
@@ -721,6 +1032,7 @@ namespace WPEFramework {
                             }
                             else {
                                 SET_STATUS(g_task_status,LOGUPLOAD_COMPLETE);
+                                taskFinished(TASK_LOGUPLOAD, false);
                                 LOGINFO("Error encountered in LOGUPLOAD script task \n");
                                 m_task_map[task_names_foreground[2].c_str()]=false;
                             }
@@ -733,7 +1045,7 @@ namespace WPEFramework {
                             }
                             else {
                                 SET_STATUS(g_task_status,DIFD_COMPLETE);
-                                task_thread.notify_one();
+                                taskFinished(TASK_SWUPDATE, false);
                                 LOGINFO("Error encountered in SWUPDATE script task \n");
                                 m_task_map[task_names_foreground[1].c_str()]=false;
                             }
@@ -1141,7 +1453,11 @@ namespace WPEFramework {
                 if ( MAINTENANCE_STARTED == m_notify_status  ){
 
                     // Set the condition flag m_abort_flag to true
-                    m_abort_flag = true;
+                    {
+                        std::lock_guard<std::mutex> lck(m_taskMutex);
+                        m_abort_flag = true;
+                        task_thread.notify_all();
+                    }
 
                     auto task_status_DCM=m_task_map.find("/lib/rdk/StartDCM_maintaince.sh");
                     auto task_status_RFC=m_task_map.find(task_names_foreground[0].c_str());
@@ -1155,15 +1471,22 @@ namespace WPEFramework {
 
                     for (i=0;i<4;i++)
                         LOGINFO("task status [%d]  = %s ScriptName %s",i,(task_status[i])? "true":"false",script_names[i].c_str());
+                    /* tasks run in parallel, stop every one that is running */
                     for (i=0;i<4;i++){
                         if(task_status[i]){
                             record = i;
+                            pid_t pgid=-1;
+                            {
+                                std::lock_guard<std::mutex> lck(m_taskMutex);
+                                pgid = m_tasks[i].pgid;
+                            }
                             LOGINFO("Checking the Task PID\n");
-                            pid_num=getTaskPID(script_names[i].c_str());
+                            pid_num=(pgid > 0) ? pgid : getTaskPID(script_names[i].c_str());
                             LOGINFO("PID of script_name [%d] = %s is %d \n", i,script_names[i].c_str(),pid_num);
                             if( pid_num != -1){
-                                /* send the signal to task to terminate */
-                                k_ret=kill(pid_num,SIGABRT);
+                                /* send the signal to task to terminate, with
+                                 * all it started when we spawned it ourselves */
+                                k_ret=kill((pgid > 0) ? -pid_num : pid_num,SIGABRT);
                                 if (k_ret == 0){
                                     LOGINFO(" %s Termimated\n",script_names[i].c_str());
                                     /*this means we killed the task currently running */
@@ -1176,9 +1499,6 @@ namespace WPEFramework {
                             else {
                                 LOGINFO("Didnt find PID for %s\n",script_names[i].c_str());
                             }
-
-                            /* No need to loop again */
-                            break;
                         }
                         else{
                             LOGINFO("Task[%d] is false \n",i);
@@ -1274,11 +1594,15 @@ namespace WPEFramework {
 
         void MaintenanceManager::onMaintenanceStatusChange(Maint_notify_status_t status) {
             JsonObject params;
+            JsonArray timings;
+            /* taken before m_statusMutex, stopMaintenance locks in that order */
+            getTaskTimings(timings);
             /* we store the updated value as well */
             m_statusMutex.lock();
             m_notify_status=status;
             m_statusMutex.unlock();
             params["maintenanceStatus"]=notifyStatusToString(status);
+            params["tasks"]=timings;
             sendNotify(EVT_ONMAINTENANCSTATUSCHANGE, params);
         }
 
@@ -21,8 +21,14 @@
 #define MAINTENANCEMANAGER_H
 
 #include <stdint.h>
+#include <sys/types.h>
 #include <thread>
 #include <map>
+#include <set>
+#include <vector>
+#include <chrono>
+#include <mutex>
+#include <condition_variable>
 
 #include "Module.h"
 #include "tracing/Logging.h"
@@ -71,6 +77,15 @@ typedef enum{
     UNSOLICITED_MAINTENANCE
 }Maintenance_Type_t;
 
+/* Maintenance tasks; same order as script_names */
+typedef enum {
+    TASK_DCM,
+    TASK_RFC,
+    TASK_SWUPDATE,
+    TASK_LOGUPLOAD,
+    TASK_COUNT
+} Maint_task_t;
+
 #define FOREGROUND_MODE "FOREGROUND"
 #define BACKGROUND_MODE "BACKGROUND"
 
@@ -81,6 +96,11 @@ typedef enum{
 #define MAX_NETWORK_RETRIES             4
 #define MAX_ACTIVATION_RETRIES          4
 
+/* Scheduling of maintenance tasks */
+#define TASK_POLL_INTERVAL_SEC          1
+#define TASK_EXIT_TIMEOUT_SEC           10
+#define TASK_THROTTLE_NICE              19
+
 #define DCM_SUCCESS                     0
 #define DCM_COMPLETE                    1
 #define RFC_SUCCESS                     2
@@ -146,6 +166,14 @@ namespace WPEFramework {
 
                 bool isDeviceOnline();
                 void task_execution_thread();
+                void runTasks();
+                void taskFinished(Maint_task_t task, bool success, bool skipped = false);
+                bool waitForRetry(int seconds);
+                void getTaskTimings(JsonArray& timings);
+                bool subscribeToShellEvents();
+                void unsubscribeFromShellEvents();
+                void onShellAppLaunched(const JsonObject& parameters);
+                void onShellAppStopped(const JsonObject& parameters);
                 void requestSystemReboot();
                 void maintenanceManagerOnBootup();
                 bool checkAutoRebootFlag();
@@ -164,12 +192,50 @@ namespace WPEFramework {
 
             private:
                 class MaintenanceTask{
-                    private:
+                    public:
+                        typedef enum {
+                            NOT_SCHEDULED,
+                            PENDING,
+                            RUNNING,
+                            SUCCEEDED,
+                            FAILED,
+                            SKIPPED
+                        } State;
+
+                        MaintenanceTask(const std::string& name, const std::string& key,
+                                const std::string& script, const std::string& log, uint32_t dependencies);
+
+                        void reset(State initial);
+                        bool startTask(bool throttle);
+                        void finish(State result);
+                        void reap();
+                        void throttle(bool enable);
+                        bool isDone() const;
+                        bool isAlive() const { return pid > 0; }
+                        void toJson(JsonObject& timing) const;
+
                         std::string taskName;
+                        std::string taskKey;        /* key in m_task_map */
                         std::string taskScript;
-                    public:
-                        void startTask();
+                        std::string taskLog;        /* stdout appended here when not empty */
+                        uint32_t dependencies;      /* bits of Maint_task_t that must be done first */
+                        State state;
+                        pid_t pid;                  /* script, until it exits */
+                        pid_t pgid;                 /* script and its children, until the task is done */
+                        bool throttled;
+                        time_t startTime;
+                        std::chrono::steady_clock::time_point started;
+                        std::chrono::steady_clock::time_point ended;
+                        std::chrono::steady_clock::time_point throttledSince;
+                        uint64_t throttledMs;
                 };
+
+                /* Guards m_tasks, m_foregroundApps and m_stopping, task_thread waits on it */
+                std::mutex m_taskMutex;
+                std::vector<MaintenanceTask> m_tasks;
+                std::set<std::string> m_foregroundApps;
+                bool m_stopping;
+                std::shared_ptr<WPEFramework::JSONRPC::LinkType<WPEFramework::Core::JSON::IElement>> m_shellClient;
             public:
                 MaintenanceManager();
                 virtual ~MaintenanceManager();
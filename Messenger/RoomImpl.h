@@ -22,6 +22,7 @@
 #include "Module.h"
 #include <interfaces/IMessenger.h>
 #include "RoomMaintainer.h"
+#include <memory>
 
 namespace WPEFramework {
 
@@ -29,6 +30,25 @@ namespace Plugin {
 
     class RoomImpl : public Exchange::IRoomAdministrator::IRoom {
     public:
+        // A message is built once per send and shared by all members of the room.
+        struct Message {
+            Message(const string& sender, const string& text)
+                : Sender(sender)
+                , Text(text)
+            {
+            }
+
+            const string Sender;
+            const string Text;
+        };
+        using MessagePtr = std::shared_ptr<const Message>;
+
+        // Pending messages per member; beyond this the oldest ones are dropped so
+        // that a member that does not keep up cannot grow without bounds.
+        static constexpr uint32_t MaxPendingMessages = 256;
+        // Messages delivered per job run before yielding the worker to other members.
+        static constexpr uint32_t MaxBatchMessages = 16;
+
         RoomImpl() = delete;
         RoomImpl(const RoomImpl&) = delete;
         RoomImpl& operator=(const RoomImpl&) = delete;
@@ -40,6 +60,10 @@ namespace Plugin {
             , _callback(nullptr)
             , _messageSink(messageSink)
             , _adminLock()
+            , _pending()
+            , _dropped(0)
+            , _queueLock()
+            , _job(*this)
         {
             ASSERT(admin != nullptr);
 
@@ -63,6 +87,13 @@ namespace Plugin {
             // Release the callback if necessary.
             SetCallback(nullptr);
 
+            // No new messages can be queued once we left the room, wait for a running delivery.
+            _job.Revoke();
+
+            _queueLock.Lock();
+            _pending.clear();
+            _queueLock.Unlock();
+
             if (_messageSink) {
                 _messageSink->Release();
             }
@@ -135,10 +166,23 @@ namespace Plugin {
             _adminLock.Unlock();
         }
 
-        void MessageReceived(const string& userId, const string& message)
+        // Called by the room maintainer for every member, delivery happens on the worker pool
+        // so that a slow sink does not hold up the sender or the other members.
+        void MessageReceived(const MessagePtr& message)
         {
             if (_messageSink != nullptr) {
-                _messageSink->Message(userId, message);
+                _queueLock.Lock();
+
+                if (_pending.size() >= MaxPendingMessages) {
+                    _pending.pop_front();
+                    _dropped++;
+                }
+
+                _pending.push_back(message);
+
+                _queueLock.Unlock();
+
+                _job.Submit();
             }
         }
 
@@ -150,6 +194,40 @@ namespace Plugin {
             INTERFACE_ENTRY(Exchange::IRoomAdministrator::IRoom)
         END_INTERFACE_MAP
 
+    private:
+        friend Core::ThreadPool::JobType<RoomImpl&>;
+
+        void Dispatch()
+        {
+            std::list<MessagePtr> batch;
+            uint32_t dropped;
+
+            _queueLock.Lock();
+
+            auto last = _pending.begin();
+            std::advance(last, std::min<size_t>(_pending.size(), MaxBatchMessages));
+            batch.splice(batch.end(), _pending, _pending.begin(), last);
+            bool more = (_pending.empty() == false);
+
+            dropped = _dropped;
+            _dropped = 0;
+
+            _queueLock.Unlock();
+
+            if (dropped != 0) {
+                TRACE(Trace::Warning, (_T("User '%s': dropped %u messages in room '%s', member is not keeping up"),
+                        UserId().c_str(), dropped, RoomId().c_str()));
+            }
+
+            for (const MessagePtr& message : batch) {
+                _messageSink->Message(message->Sender, message->Text);
+            }
+
+            if (more == true) {
+                _job.Submit();
+            }
+        }
+
     private:
         string _roomId;
         string _userId;
@@ -157,6 +235,10 @@ namespace Plugin {
         Exchange::IRoomAdministrator::IRoom::ICallback* _callback;
         Exchange::IRoomAdministrator::IRoom::IMsgNotification* _messageSink;
         mutable Core::CriticalSection _adminLock;
+        std::list<MessagePtr> _pending;
+        uint32_t _dropped;
+        Core::CriticalSection _queueLock;
+        Core::WorkerPool::JobType<RoomImpl&> _job;
     };
 
 } // namespace Plugin
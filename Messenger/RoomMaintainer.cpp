@@ -156,8 +156,11 @@ namespace Plugin {
         ASSERT(it != _roomMap.end());
 
         if (it != _roomMap.end()) {
+            // Copied once, every member only queues a reference.
+            RoomImpl::MessagePtr shared(std::make_shared<const RoomImpl::Message>(roomUser->UserId(), message));
+
             for (RoomImpl* user : (*it).second) {
-                user->MessageReceived(roomUser->UserId(), message);
+                user->MessageReceived(shared);
             }
         }
 
@@ -25,6 +25,7 @@
 #include <interfaces/json/JsonData_Monitor.h>
 #include <limits>
 #include <string>
+#include <vector>
 
 static uint32_t gcd(uint32_t a, uint32_t b)
 {
@@ -146,6 +147,242 @@ namespace Plugin {
             bool _operational;
         };
 
+        // Fixed size ring of memory samples, oldest samples are overwritten. Sizes
+        // are kept in KB so that a sample stays small enough to keep a long history
+        // for every observable.
+        class TimeSeries {
+        public:
+            struct Sample {
+                uint64_t Time; // ms since epoch
+                uint32_t Resident;
+                uint32_t Allocated;
+                uint32_t Shared;
+                uint16_t Process;
+            };
+
+        public:
+            TimeSeries() = delete;
+            TimeSeries& operator=(const TimeSeries&) = delete;
+
+            TimeSeries(const uint16_t capacity)
+                : _adminLock()
+                , _samples(capacity)
+                , _head(0)
+                , _count(0)
+            {
+            }
+            TimeSeries(const TimeSeries& copy)
+                : _adminLock()
+                , _samples(copy._samples)
+                , _head(copy._head)
+                , _count(copy._count)
+            {
+            }
+            ~TimeSeries()
+            {
+            }
+
+        public:
+            inline uint32_t Capacity() const
+            {
+                return (static_cast<uint32_t>(_samples.size()));
+            }
+            void Add(const MetaData& measurement)
+            {
+                if (_samples.size() != 0) {
+                    Sample sample;
+
+                    sample.Time = Core::Time::Now().Ticks() / Core::Time::TicksPerMillisecond;
+                    sample.Resident = static_cast<uint32_t>(measurement.Resident().Last() / 1024);
+                    sample.Allocated = static_cast<uint32_t>(measurement.Allocated().Last() / 1024);
+                    sample.Shared = static_cast<uint32_t>(measurement.Shared().Last() / 1024);
+                    sample.Process = measurement.Process().Last();
+
+                    _adminLock.Lock();
+                    _samples[_head] = sample;
+                    _head = (_head + 1) % _samples.size();
+                    if (_count < _samples.size()) {
+                        _count++;
+                    }
+                    _adminLock.Unlock();
+                }
+            }
+            void Clear()
+            {
+                _adminLock.Lock();
+                _head = 0;
+                _count = 0;
+                _adminLock.Unlock();
+            }
+            // Returns the samples within [from, to] in chronological order. If there are more than
+            // points of them, the range is split in points equal buckets and each bucket reports
+            // its peak values, so that short spikes survive the downsampling.
+            void Query(const uint64_t from, const uint64_t to, const uint16_t points, std::vector<Sample>& result) const
+            {
+                _adminLock.Lock();
+
+                const uint32_t capacity(static_cast<uint32_t>(_samples.size()));
+                const uint32_t oldest((_head + capacity - _count) % (capacity == 0 ? 1 : capacity));
+                uint32_t first(0);
+                uint32_t matches(0);
+
+                for (uint32_t index = 0; index < _count; index++) {
+                    const Sample& sample(_samples[(oldest + index) % capacity]);
+                    if ((sample.Time >= from) && (sample.Time <= to)) {
+                        if (matches == 0) {
+                            first = index;
+                        }
+                        matches++;
+                    }
+                }
+
+                if (matches != 0) {
+                    const uint64_t start(_samples[(oldest + first) % capacity].Time);
+                    const uint64_t span(_samples[(oldest + first + matches - 1) % capacity].Time - start + 1);
+                    uint32_t bucket(~0);
+
+                    result.reserve(std::min<uint32_t>(matches, points));
+
+                    for (uint32_t index = first; index < (first + matches); index++) {
+                        const Sample& sample(_samples[(oldest + index) % capacity]);
+
+                        if ((points == 0) || (matches <= points)) {
+                            result.push_back(sample);
+                        } else {
+                            uint32_t slot(static_cast<uint32_t>(((sample.Time - start) * points) / span));
+                            if (slot != bucket) {
+                                bucket = slot;
+                                result.push_back(sample);
+                            } else {
+                                Sample& peak(result.back());
+                                peak.Resident = std::max(peak.Resident, sample.Resident);
+                                peak.Allocated = std::max(peak.Allocated, sample.Allocated);
+                                peak.Shared = std::max(peak.Shared, sample.Shared);
+                                peak.Process = std::max(peak.Process, sample.Process);
+                            }
+                        }
+                    }
+                }
+
+                _adminLock.Unlock();
+            }
+
+        private:
+            // Samples are added from the probing job while queries come from JSON-RPC.
+            mutable Core::CriticalSection _adminLock;
+            std::vector<Sample> _samples;
+            uint32_t _head;
+            uint32_t _count;
+        };
+
+        class HistoryParams : public Core::JSON::Container {
+        public:
+            HistoryParams(const HistoryParams&) = delete;
+            HistoryParams& operator=(const HistoryParams&) = delete;
+
+            HistoryParams()
+                : Core::JSON::Container()
+            {
+                Add(_T("callsign"), &Callsign);
+                Add(_T("from"), &From);
+                Add(_T("to"), &To);
+                Add(_T("points"), &Points);
+            }
+            ~HistoryParams()
+            {
+            }
+
+        public:
+            Core::JSON::String Callsign;
+            Core::JSON::DecUInt64 From;
+            Core::JSON::DecUInt64 To;
+            Core::JSON::DecUInt16 Points;
+        };
+
+        class HistoryData : public Core::JSON::Container {
+        public:
+            class Sample : public Core::JSON::Container {
+            public:
+                Sample()
+                    : Core::JSON::Container()
+                {
+                    Init();
+                }
+                Sample(const TimeSeries::Sample& input)
+                    : Core::JSON::Container()
+                {
+                    Init();
+
+                    Time = input.Time;
+                    Resident = input.Resident;
+                    Allocated = input.Allocated;
+                    Shared = input.Shared;
+                    Process = input.Process;
+                }
+                Sample(const Sample& copy)
+                    : Core::JSON::Container()
+                    , Time(copy.Time)
+                    , Resident(copy.Resident)
+                    , Allocated(copy.Allocated)
+                    , Shared(copy.Shared)
+                    , Process(copy.Process)
+                {
+                    Init();
+                }
+                ~Sample()
+                {
+                }
+
+                Sample& operator=(const Sample& RHS)
+                {
+                    Time = RHS.Time;
+                    Resident = RHS.Resident;
+                    Allocated = RHS.Allocated;
+                    Shared = RHS.Shared;
+                    Process = RHS.Process;
+
+                    return (*this);
+                }
+
+            private:
+                void Init()
+                {
+                    Add(_T("time"), &Time);
+                    Add(_T("resident"), &Resident);
+                    Add(_T("allocated"), &Allocated);
+                    Add(_T("shared"), &Shared);
+                    Add(_T("process"), &Process);
+                }
+
+            public:
+                Core::JSON::DecUInt64 Time;
+                Core::JSON::DecUInt32 Resident;
+                Core::JSON::DecUInt32 Allocated;
+                Core::JSON::DecUInt32 Shared;
+                Core::JSON::DecUInt16 Process;
+            };
+
+        public:
+            HistoryData(const HistoryData&) = delete;
+            HistoryData& operator=(const HistoryData&) = delete;
+
+            HistoryData()
+                : Core::JSON::Container()
+            {
+                Add(_T("callsign"), &Callsign);
+                Add(_T("interval"), &Interval);
+                Add(_T("samples"), &Samples);
+            }
+            ~HistoryData()
+            {
+            }
+
+        public:
+            Core::JSON::String Callsign;
+            Core::JSON::DecUInt32 Interval;
+            Core::JSON::ArrayType<Sample> Samples;
+        };
+
         class Data : public Core::JSON::Container {
         public:
             class MetaData : public Core::JSON::Container {
@@ -403,6 +640,7 @@ namespace Plugin {
                     Add(_T("callsign"), &Callsign);
                     Add(_T("memory"), &MetaData);
                     Add(_T("memorylimit"), &MetaDataLimit);
+                    Add(_T("samplinginterval"), &SamplingInterval);
                     Add(_T("operational"), &Operational);
                     Add(_T("restart"), &Restart);
                 }
@@ -411,12 +649,14 @@ namespace Plugin {
                     , Callsign(copy.Callsign)
                     , MetaData(copy.MetaData)
                     , MetaDataLimit(copy.MetaDataLimit)
+                    , SamplingInterval(copy.SamplingInterval)
                     , Operational(copy.Operational)
                     , Restart(copy.Restart)
                 {
                     Add(_T("callsign"), &Callsign);
                     Add(_T("memory"), &MetaData);
                     Add(_T("memorylimit"), &MetaDataLimit);
+                    Add(_T("samplinginterval"), &SamplingInterval);
                     Add(_T("operational"), &Operational);
                     Add(_T("restart"), &Restart);
                 }
@@ -428,6 +668,7 @@ namespace Plugin {
                 Core::JSON::String Callsign;
                 Core::JSON::DecUInt32 MetaData;
                 Core::JSON::DecUInt32 MetaDataLimit;
+                Core::JSON::DecUInt32 SamplingInterval; // ms, overrides memory for sub-second sampling
                 Core::JSON::DecSInt32 Operational;
                 RestartInfo Restart;
             };
@@ -435,8 +676,10 @@ namespace Plugin {
         public:
             Config()
                 : Core::JSON::Container()
+                , History(720)
             {
                 Add(_T("observables"), &Observables);
+                Add(_T("history"), &History);
             }
             ~Config()
             {
@@ -444,6 +687,7 @@ namespace Plugin {
 
         public:
             Core::JSON::ArrayType<Entry> Observables;
+            Core::JSON::DecUInt16 History; // memory samples kept per observable
         };
 
         class MonitorObjects : public PluginHost::IPlugin::INotification {
@@ -474,7 +718,8 @@ namespace Plugin {
                     const uint64_t memoryThreshold,
                     const uint64_t absTime,
                     const uint16_t restartWindow,
-                    const uint8_t restartLimit)
+                    const uint8_t restartLimit,
+                    const uint16_t historySize)
                     : _operationalInterval(operationalInterval)
                     , _memoryInterval(memoryInterval)
                     , _memoryThreshold(memoryThreshold * 1024)
@@ -486,6 +731,7 @@ namespace Plugin {
                     , _restartCount(0)
                     , _restartLimit(restartLimit)
                     , _measurement()
+                    , _history(memoryInterval != 0 ? historySize : 0)
                     , _operationalEvaluate(actOnOperational)
                     , _source(nullptr)
                     , _active{ false }
@@ -505,6 +751,7 @@ namespace Plugin {
                     , _restartCount(copy._restartCount)
                     , _restartLimit(copy._restartLimit)
                     , _measurement(copy._measurement)
+                    , _history(copy._history)
                     , _operationalEvaluate(copy._operationalEvaluate)
                     , _source(copy._source)
                     , _interval(copy._interval)
@@ -570,6 +817,14 @@ namespace Plugin {
                 {
                     return (_measurement);
                 }
+                inline const TimeSeries& History() const
+                {
+                    return (_history);
+                }
+                inline uint32_t MemoryInterval() const
+                {
+                    return (_memoryInterval);
+                }
                 inline bool HasMeasurement() const
                 {
                     return (((_measurement.Allocated().Min() == Core::NumberType<uint64_t>::Max()) && 
@@ -621,6 +876,7 @@ namespace Plugin {
                         }
                         if ((_memoryInterval != 0) && (_memorySlots == 0)) {
                             _measurement.Measure(_source);
+                            _history.Add(_measurement);
 
                             if ((_memoryThreshold != 0) && (_measurement.Resident().Last() > _memoryThreshold)) {
                                 status |= EXCEEDED_MEMORY;
@@ -647,6 +903,7 @@ namespace Plugin {
                 uint32_t _restartCount;
                 uint8_t _restartLimit;
                 MetaData _measurement;
+                TimeSeries _history;
                 bool _operationalEvaluate;
                 Exchange::IMemory* _source;
                 uint32_t _interval; //!< The greatest possible interval to check both memory and processes.
@@ -697,7 +954,7 @@ namespace Plugin {
 
                 _adminLock.Unlock();
             }
-            inline void Open(PluginHost::IShell* service, Core::JSON::ArrayType<Config::Entry>::Iterator& index)
+            inline void Open(PluginHost::IShell* service, Core::JSON::ArrayType<Config::Entry>::Iterator& index, const uint16_t historySize)
             {
                 ASSERT((service != nullptr) && (_service == nullptr));
 
@@ -715,6 +972,11 @@ namespace Plugin {
                     uint32_t interval = abs(element.Operational.Value());
                     interval = interval * 1000 * 1000; // Move from Seconds to MicroSecond
                     uint32_t memory(element.MetaData.Value() * 1000 * 1000); // Move from Seconds to MicroSeconds
+                    // Every sample costs the IMemory calls of a measurement; what short intervals cost
+                    // across many observables has not been measured
+                    if (element.SamplingInterval.Value() != 0) {
+                        memory = element.SamplingInterval.Value() * 1000; // Move from MilliSeconds to MicroSeconds
+                    }
                     uint16_t restartWindow = 0;
                     uint8_t restartLimit = 0;
 
@@ -732,7 +994,8 @@ namespace Plugin {
                                 memoryThreshold, 
                                 baseTime, 
                                 restartWindow, 
-                                restartLimit)));
+                                restartLimit,
+                                historySize)));
                     }
                 }
 
@@ -885,6 +1148,33 @@ namespace Plugin {
                 _adminLock.Unlock();
             }
 
+            bool History(const string& name, const uint64_t from, const uint64_t to, const uint16_t points, Monitor::HistoryData& response)
+            {
+                bool found = false;
+                std::vector<TimeSeries::Sample> samples;
+
+                _adminLock.Lock();
+
+                std::map<string, MonitorObject>::iterator index(_monitor.find(name));
+
+                if (index != _monitor.end()) {
+                    index->second.History().Query(from, to, points, samples);
+                    response.Interval = index->second.MemoryInterval() / 1000;
+                    found = true;
+                }
+
+                _adminLock.Unlock();
+
+                if (found == true) {
+                    response.Callsign = name;
+                    for (const TimeSeries::Sample& sample : samples) {
+                        response.Samples.Add(HistoryData::Sample(sample));
+                    }
+                }
+
+                return (found);
+            }
+
             bool Reset(const string& name, Monitor::MetaData& result)
             {
                 bool found = false;
@@ -1079,6 +1369,7 @@ namespace Plugin {
         void UnregisterAll();
         uint32_t endpoint_restartlimits(const JsonData::Monitor::RestartlimitsParamsData& params);
         uint32_t endpoint_resetstats(const JsonData::Monitor::ResetstatsParamsData& params, JsonData::Monitor::InfoInfo& response);
+        uint32_t endpoint_history(const HistoryParams& params, HistoryData& response);
         uint32_t get_status(const string& index, Core::JSON::ArrayType<JsonData::Monitor::InfoInfo>& response) const;
         void event_action(const string& callsign, const string& action, const string& reason);
     };
@@ -34,12 +34,14 @@ namespace Plugin {
     {
         Register<RestartlimitsParamsData,void>(_T("restartlimits"), &Monitor::endpoint_restartlimits, this);
         Register<ResetstatsParamsData,InfoInfo>(_T("resetstats"), &Monitor::endpoint_resetstats, this);
+        Register<HistoryParams,HistoryData>(_T("history"), &Monitor::endpoint_history, this);
         Property<Core::JSON::ArrayType<InfoInfo>>(_T("status"), &Monitor::get_status, nullptr, this);
     }
 
     void Monitor::UnregisterAll()
     {
         Unregister(_T("resetstats"));
+        Unregister(_T("history"));
         Unregister(_T("restartlimits"));
         Unregister(_T("status"));
     }
@@ -75,6 +77,22 @@ namespace Plugin {
         return Core::ERROR_NONE;
     }
 
+    // Method: history - Returns the memory samples of a plugin watched by the Monitor, downsampled to at most points samples
+    // Return codes:
+    //  - ERROR_NONE: Success
+    //  - ERROR_UNKNOWN_KEY: The plugin is not watched by the Monitor
+    uint32_t Monitor::endpoint_history(const HistoryParams& params, HistoryData& response)
+    {
+        const uint64_t from = params.From.IsSet() ? params.From.Value() : 0;
+        const uint64_t to = params.To.IsSet() ? params.To.Value() : std::numeric_limits<uint64_t>::max();
+        const uint16_t points = params.Points.IsSet() ? params.Points.Value() : 100;
+
+        if (_monitor->History(params.Callsign.Value(), from, to, points, response) == false) {
+            return Core::ERROR_UNKNOWN_KEY;
+        }
+        return Core::ERROR_NONE;
+    }
+
     // Property: status - The memory and process statistics either for a single plugin or all plugins watched by the Monitor
     // Return codes:
     //  - ERROR_NONE: Success
@@ -150,6 +150,7 @@ namespace WPEFramework
         Network* Network::_instance = nullptr;
 
         Network::Network() : PluginHost::JSONRPC()
+            , m_iarmEvents("Network", [this](const char *owner, IARM_EventId_t eventId, void *data, size_t len) { iarmEventHandler(owner, eventId, data, len); })
         {
             Network::_instance = this;
             m_isPluginInited = false;
@@ -263,6 +264,7 @@ namespace WPEFramework
                 IARM_CHECK( IARM_Bus_UnRegisterEventHandler(IARM_BUS_NM_SRV_MGR_NAME, IARM_BUS_NETWORK_MANAGER_EVENT_INTERFACE_IPADDRESS) );
                 IARM_CHECK( IARM_Bus_UnRegisterEventHandler(IARM_BUS_NM_SRV_MGR_NAME, IARM_BUS_NETWORK_MANAGER_EVENT_DEFAULT_INTERFACE) );
             }
+            m_iarmEvents.stop();
             Unregister("getQuirks");
             Unregister("getInterfaces");
             Unregister("isInterfaceEnabled");
@@ -355,7 +357,7 @@ namespace WPEFramework
             {
                 char c;
                 uint32_t retry = 0;
-                retVal = IARM_Bus_Call(IARM_BUS_NM_SRV_MGR_NAME, IARM_BUS_NETSRVMGR_API_isAvailable, (void *)&c, sizeof(c));
+                retVal = IARM_BUS_CALL(IARM_BUS_NM_SRV_MGR_NAME, IARM_BUS_NETSRVMGR_API_isAvailable, (void *)&c, sizeof(c));
                 if(retVal != IARM_RESULT_SUCCESS){
                     LOGERR("threadEventRegistration: NetSrvMgr is not available. Failed to activate Network Plugin, retrying count = %d", retry);
                     usleep(500*1000);
@@ -395,7 +397,7 @@ namespace WPEFramework
 
             if(m_isPluginInited)
             {
-                if (IARM_RESULT_SUCCESS == IARM_Bus_Call(IARM_BUS_NM_SRV_MGR_NAME, IARM_BUS_NETSRVMGR_API_getInterfaceList, (void*)&list, sizeof(list)))
+                if (IARM_RESULT_SUCCESS == IARM_BUS_CALL(IARM_BUS_NM_SRV_MGR_NAME, IARM_BUS_NETSRVMGR_API_getInterfaceList, (void*)&list, sizeof(list)))
                 {
                     JsonArray networkInterfaces;
 
@@ -478,7 +480,7 @@ namespace WPEFramework
                     strncpy(iarmData.setInterface, interface.c_str(), INTERFACE_SIZE);
                     iarmData.persist = persist;
 
-                    if (IARM_RESULT_SUCCESS == IARM_Bus_Call (IARM_BUS_NM_SRV_MGR_NAME, IARM_BUS_NETSRVMGR_API_setDefaultInterface, (void *)&iarmData, sizeof(iarmData)))
+                    if (IARM_RESULT_SUCCESS == IARM_BUS_CALL(IARM_BUS_NM_SRV_MGR_NAME, IARM_BUS_NETSRVMGR_API_setDefaultInterface, (void *)&iarmData, sizeof(iarmData)))
                         result = true;
                     else
                         LOGWARN ("Call to %s for %s failed", IARM_BUS_NM_SRV_MGR_NAME, IARM_BUS_NETSRVMGR_API_setDefaultInterface);
@@ -501,7 +503,7 @@ namespace WPEFramework
 
             if(m_isPluginInited)
             {
-                if (IARM_RESULT_SUCCESS == IARM_Bus_Call(IARM_BUS_NM_SRV_MGR_NAME, IARM_BUS_NETSRVMGR_API_getSTBip, (void*)&param, sizeof(param)))
+                if (IARM_RESULT_SUCCESS == IARM_BUS_CALL(IARM_BUS_NM_SRV_MGR_NAME, IARM_BUS_NETSRVMGR_API_getSTBip, (void*)&param, sizeof(param)))
                 {
                     response["ip"] = string(param.activeIfaceIpaddr, MAX_IP_ADDRESS_LEN - 1);
                     result = true;
@@ -534,7 +536,7 @@ namespace WPEFramework
                     getStringParameter("family", ipfamily);
                     strncpy(param.ipfamily,ipfamily.c_str(),MAX_IP_FAMILY_SIZE);
 
-                    if (IARM_RESULT_SUCCESS == IARM_Bus_Call(IARM_BUS_NM_SRV_MGR_NAME, IARM_BUS_NETSRVMGR_API_getSTBip_family, (void*)&param, sizeof(param)))
+                    if (IARM_RESULT_SUCCESS == IARM_BUS_CALL(IARM_BUS_NM_SRV_MGR_NAME, IARM_BUS_NETSRVMGR_API_getSTBip_family, (void*)&param, sizeof(param)))
                     {
                         response["ip"] = string(param.activeIfaceIpaddr, MAX_IP_ADDRESS_LEN - 1);
                         result = true;
@@ -578,7 +580,7 @@ namespace WPEFramework
                     IARM_BUS_NetSrvMgr_Iface_EventData_t param = {0};
                     strncpy(param.setInterface, interface.c_str(), INTERFACE_SIZE);
 
-                    if (IARM_RESULT_SUCCESS == IARM_Bus_Call (IARM_BUS_NM_SRV_MGR_NAME, IARM_BUS_NETSRVMGR_API_isInterfaceEnabled, (void*)&param, sizeof(param)))
+                    if (IARM_RESULT_SUCCESS == IARM_BUS_CALL(IARM_BUS_NM_SRV_MGR_NAME, IARM_BUS_NETSRVMGR_API_isInterfaceEnabled, (void*)&param, sizeof(param)))
                     {
                         LOGINFO("%s :: Enabled = %d ",__FUNCTION__,param.isInterfaceEnabled);
                         response["enabled"] = param.isInterfaceEnabled;
@@ -624,7 +626,7 @@ namespace WPEFramework
                     iarmData.isInterfaceEnabled = enabled;
                     iarmData.persist = persist;
 
-                    if (IARM_RESULT_SUCCESS == IARM_Bus_Call (IARM_BUS_NM_SRV_MGR_NAME, IARM_BUS_NETSRVMGR_API_setInterfaceEnabled, (void *)&iarmData, sizeof(iarmData)))
+                    if (IARM_RESULT_SUCCESS == IARM_BUS_CALL(IARM_BUS_NM_SRV_MGR_NAME, IARM_BUS_NETSRVMGR_API_setInterfaceEnabled, (void *)&iarmData, sizeof(iarmData)))
                         result = true;
                     else
                         LOGWARN ("Call to %s for %s failed", IARM_BUS_NM_SRV_MGR_NAME, IARM_BUS_NETSRVMGR_API_setInterfaceEnabled);
@@ -879,7 +881,7 @@ namespace WPEFramework
                         }
                     }
                     if (IARM_RESULT_SUCCESS ==
-                            IARM_Bus_Call(IARM_BUS_NM_SRV_MGR_NAME, IARM_BUS_NETSRVMGR_API_setIPSettings, (void *) &iarmData,
+                            IARM_BUS_CALL(IARM_BUS_NM_SRV_MGR_NAME, IARM_BUS_NETSRVMGR_API_setIPSettings, (void *) &iarmData,
                                 sizeof(iarmData)))
                     {
                         response["supported"] = iarmData.isSupported;
@@ -914,7 +916,7 @@ namespace WPEFramework
                 strncpy(iarmData.ipversion, ipversion.c_str(), 16);
                 iarmData.isSupported = true;
 
-                if (IARM_RESULT_SUCCESS == IARM_Bus_Call (IARM_BUS_NM_SRV_MGR_NAME, IARM_BUS_NETSRVMGR_API_getIPSettings, (void *)&iarmData, sizeof(iarmData)))
+                if (IARM_RESULT_SUCCESS == IARM_BUS_CALL(IARM_BUS_NM_SRV_MGR_NAME, IARM_BUS_NETSRVMGR_API_getIPSettings, (void *)&iarmData, sizeof(iarmData)))
                 {
                     response["interface"] = string(iarmData.interface);
                     response["ipversion"] = string(iarmData.ipversion);
@@ -942,7 +944,7 @@ namespace WPEFramework
 
             if(m_isPluginInited)
             {
-                if (IARM_RESULT_SUCCESS == IARM_Bus_Call(IARM_BUS_NM_SRV_MGR_NAME, IARM_BUS_NETSRVMGR_API_isConnectedToInternet, (void*) &isconnected, sizeof(isconnected)))
+                if (IARM_RESULT_SUCCESS == IARM_BUS_CALL(IARM_BUS_NM_SRV_MGR_NAME, IARM_BUS_NETSRVMGR_API_isConnectedToInternet, (void*) &isconnected, sizeof(isconnected)))
                 {
                     LOGINFO("%s :: isconnected = %d \n",__FUNCTION__,isconnected);
                     response["connectedToInternet"] = isconnected;
@@ -987,7 +989,7 @@ namespace WPEFramework
                         returnResponse(result);
                     }
                 }
-                if (IARM_RESULT_SUCCESS == IARM_Bus_Call(IARM_BUS_NM_SRV_MGR_NAME, IARM_BUS_NETSRVMGR_API_setConnectivityTestEndpoints, (void*) &iarmData, sizeof(iarmData)))
+                if (IARM_RESULT_SUCCESS == IARM_BUS_CALL(IARM_BUS_NM_SRV_MGR_NAME, IARM_BUS_NETSRVMGR_API_setConnectivityTestEndpoints, (void*) &iarmData, sizeof(iarmData)))
                 {
                     result = true;
                 }
@@ -1083,7 +1085,7 @@ namespace WPEFramework
                 LOGWARN("getPublicIP called with server=%s port=%u iface=%s ipv6=%u sync=%u timeout=%u cache_timeout=%u\n", 
                         iarmData.server, iarmData.port, iarmData.interface, iarmData.ipv6, iarmData.sync, iarmData.bind_timeout, iarmData.cache_timeout);
 
-                if (IARM_RESULT_SUCCESS == IARM_Bus_Call (IARM_BUS_NM_SRV_MGR_NAME, IARM_BUS_NETSRVMGR_API_getPublicIP, (void *)&iarmData, sizeof(iarmData)))
+                if (IARM_RESULT_SUCCESS == IARM_BUS_CALL(IARM_BUS_NM_SRV_MGR_NAME, IARM_BUS_NETSRVMGR_API_getPublicIP, (void *)&iarmData, sizeof(iarmData)))
                 {
                     response["public_ip"] = string(iarmData.public_ip);
                     result = true;
@@ -1145,7 +1147,7 @@ namespace WPEFramework
         void Network::eventHandler(const char *owner, IARM_EventId_t eventId, void *data, size_t len)
         {
             if (Network::_instance)
-                Network::_instance->iarmEventHandler(owner, eventId, data, len);
+                Network::_instance->m_iarmEvents.post(owner, eventId, data, len);
             else
                 LOGWARN("WARNING - cannot handle IARM events without a Network plugin instance!");
         }
@@ -1289,7 +1291,7 @@ namespace WPEFramework
                     LOGINFO("Identified as mediaclient device type");
 
                     IARM_BUS_NetSrvMgr_DefaultRoute_t defaultRoute = {0};
-                    if (IARM_RESULT_SUCCESS == IARM_Bus_Call(IARM_BUS_NM_SRV_MGR_NAME, IARM_BUS_NETSRVMGR_API_getDefaultInterface
+                    if (IARM_RESULT_SUCCESS == IARM_BUS_CALL(IARM_BUS_NM_SRV_MGR_NAME, IARM_BUS_NETSRVMGR_API_getDefaultInterface
                                 , (void*)&defaultRoute, sizeof(defaultRoute)))
                     {
                         LOGWARN ("Call to %s for %s returned interface = %s, gateway = %s", IARM_BUS_NM_SRV_MGR_NAME
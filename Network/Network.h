@@ -25,6 +25,7 @@
 #include "Module.h"
 #include "NetUtils.h"
 #include "utils.h"
+#include "iarmeventdispatcher.h"
 #include "upnpdiscoverymanager.h"
 
 
@@ -133,6 +134,7 @@ namespace WPEFramework {
             uint16_t m_stunBindTimeout;
             uint16_t m_stunCacheTimeout;
             bool m_stunSync;
+            IARMEventDispatcher m_iarmEvents;
         };
     } // namespace Plugin
 } // namespace WPEFramework
@@ -0,0 +1,301 @@
+/**
+* If not stated otherwise in this file or this component's LICENSE
+* file the following copyright and licenses apply:
+*
+* Copyright 2020 RDK Management
+*
+* Licensed under the Apache License, Version 2.0 (the "License");
+* you may not use this file except in compliance with the License.
+* You may obtain a copy of the License at
+*
+* http://www.apache.org/licenses/LICENSE-2.0
+*
+* Unless required by applicable law or agreed to in writing, software
+* distributed under the License is distributed on an "AS IS" BASIS,
+* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+* See the License for the specific language governing permissions and
+* limitations under the License.
+**/
+
+#include "LaunchMetrics.h"
+
+#include <algorithm>
+#include <chrono>
+
+namespace WPEFramework
+{
+    namespace Plugin
+    {
+        static const double sBucketBoundsMs[] = LAUNCH_METRICS_BUCKET_BOUNDS_MS;
+        static_assert(sizeof(sBucketBoundsMs) / sizeof(sBucketBoundsMs[0]) + 1 == LAUNCH_METRICS_BUCKETS, "one bucket per bound and one for longer launches");
+
+        static const char* const sPhaseNames[LAUNCH_PHASE_COUNT] = {
+            "status", "display", "clone", "configuration", "activate", "bounds", "state", "url"
+        };
+
+        const char* launchPhaseName(LaunchPhase phase)
+        {
+            return (phase < LAUNCH_PHASE_COUNT) ? sPhaseNames[phase] : "unknown";
+        }
+
+        LaunchTimeline::LaunchTimeline()
+        : m_launchStartMs(now())
+        {
+            for (int i = 0; i < LAUNCH_PHASE_COUNT; i++)
+            {
+                m_beginMs[i] = -1;
+                m_startMs[i] = -1;
+                m_durationMs[i] = -1;
+            }
+        }
+
+        double LaunchTimeline::now()
+        {
+            return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now().time_since_epoch()).count();
+        }
+
+        void LaunchTimeline::begin(LaunchPhase phase)
+        {
+            m_beginMs[phase] = now();
+        }
+
+        void LaunchTimeline::end(LaunchPhase phase, double endMs)
+        {
+            if (m_beginMs[phase] < 0)
+            {
+                return;
+            }
+
+            double duration = std::max(0.0, ((endMs < 0) ? now() : endMs) - m_beginMs[phase]);
+            if (m_durationMs[phase] < 0)
+            {
+                m_startMs[phase] = m_beginMs[phase] - m_launchStartMs;
+                m_durationMs[phase] = duration;
+            }
+            else
+            {
+                m_durationMs[phase] += duration;
+            }
+            m_beginMs[phase] = -1;
+        }
+
+        double LaunchTimeline::elapsedMs() const
+        {
+            return now() - m_launchStartMs;
+        }
+
+        LaunchHistogram::LaunchHistogram()
+        : m_count(0), m_totalMs(0), m_minMs(0), m_maxMs(0)
+        {
+            std::fill(m_counts, m_counts + LAUNCH_METRICS_BUCKETS, 0);
+        }
+
+        double LaunchHistogram::boundOf(uint32_t bucket)
+        {
+            return (bucket < LAUNCH_METRICS_BUCKETS - 1) ? sBucketBoundsMs[bucket] : -1;
+        }
+
+        uint32_t LaunchHistogram::bucketOf(double ms)
+        {
+            const double* end = sBucketBoundsMs + LAUNCH_METRICS_BUCKETS - 1;
+            return std::lower_bound(sBucketBoundsMs, end, ms) - sBucketBoundsMs;
+        }
+
+        void LaunchHistogram::record(double ms)
+        {
+            m_counts[bucketOf(ms)]++;
+            if (m_count == 0 || ms < m_minMs)
+            {
+                m_minMs = ms;
+            }
+            if (m_count == 0 || ms > m_maxMs)
+            {
+                m_maxMs = ms;
+            }
+            m_count++;
+            m_totalMs += ms;
+        }
+
+        double LaunchHistogram::percentile(double percent) const
+        {
+            if (m_count == 0)
+            {
+                return 0;
+            }
+
+            double rank = m_count * percent / 100.0;
+            uint32_t below = 0;
+            for (uint32_t bucket = 0; bucket < LAUNCH_METRICS_BUCKETS; bucket++)
+            {
+                if (m_counts[bucket] == 0 || below + m_counts[bucket] < rank)
+                {
+                    below += m_counts[bucket];
+                    continue;
+                }
+
+                // Linear within the bucket, which is narrowed to the values actually seen
+                double lowest = std::max(m_minMs, bucket ? sBucketBoundsMs[bucket - 1] : 0.0);
+                double highest = std::min(m_maxMs, (bucket < LAUNCH_METRICS_BUCKETS - 1) ? sBucketBoundsMs[bucket] : m_maxMs);
+                double fraction = (rank - below) / m_counts[bucket];
+                return lowest + (highest - lowest) * std::min(1.0, std::max(0.0, fraction));
+            }
+            return m_maxMs;
+        }
+
+        void LaunchHistogram::report(LaunchHistogramReport& report) const
+        {
+            report.count = m_count;
+            report.minMs = m_minMs;
+            report.maxMs = m_maxMs;
+            report.meanMs = m_count ? m_totalMs / m_count : 0;
+            report.p50Ms = percentile(50);
+            report.p95Ms = percentile(95);
+            report.buckets.assign(m_counts, m_counts + LAUNCH_METRICS_BUCKETS);
+        }
+
+        LaunchMetrics::LaunchMetrics()
+        : m_launchCount(0)
+        {
+        }
+
+        void LaunchMetrics::started(const std::string& client, const LaunchTimeline& timeline)
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            appLocked(client).launchStartMs = timeline.startedAtMs();
+        }
+
+        void LaunchMetrics::record(const std::string& client, const std::string& launchType, const LaunchTimeline& timeline, bool pooled)
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            App& app = appLocked(client);
+            app.launches++;
+            app.lastLaunchType = launchType;
+            if (pooled)
+            {
+                app.pooledLaunches++;
+                if (app.launchStartMs >= 0)
+                {
+                    app.firstFramePooled.record(LaunchTimeline::now() - app.launchStartMs);
+                    app.launchStartMs = -1;
+                }
+            }
+            app.total.record(timeline.elapsedMs());
+            for (int i = 0; i < LAUNCH_PHASE_COUNT; i++)
+            {
+                LaunchPhase phase = static_cast<LaunchPhase>(i);
+                if (timeline.ran(phase))
+                {
+                    app.phases[i].record(timeline.durationMs(phase));
+                }
+            }
+        }
+
+        void LaunchMetrics::recordFailure(const std::string& client)
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            App& app = appLocked(client);
+            app.failures++;
+            app.launchStartMs = -1;
+        }
+
+        void LaunchMetrics::firstFrame(const std::string& client)
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            // Also while the launch is still in progress
+            App* app = findLocked(client);
+            if (app && app->launchStartMs >= 0)
+            {
+                app->firstFrame.record(LaunchTimeline::now() - app->launchStartMs);
+                app->launchStartMs = -1;
+            }
+        }
+
+        bool LaunchMetrics::report(const std::string& client, LaunchMetricsReport& report) const
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            for (const App& app : m_apps)
+            {
+                if (app.lastLaunch != 0 && app.client == client)
+                {
+                    reportOf(app, report);
+                    return true;
+                }
+            }
+            return false;
+        }
+
+        void LaunchMetrics::reports(std::vector<LaunchMetricsReport>& reports) const
+        {
+            std::vector<const App*> apps;
+            std::lock_guard<std::mutex> lock(m_mutex);
+            for (const App& app : m_apps)
+            {
+                if (app.lastLaunch != 0)
+                {
+                    apps.push_back(&app);
+                }
+            }
+            std::sort(apps.begin(), apps.end(), [](const App* a, const App* b) { return a->lastLaunch > b->lastLaunch; });
+
+            reports.resize(apps.size());
+            for (size_t i = 0; i < apps.size(); i++)
+            {
+                reportOf(*apps[i], reports[i]);
+            }
+        }
+
+        LaunchMetrics::App& LaunchMetrics::appLocked(const std::string& client)
+        {
+            App* slot = &m_apps[0];
+            for (App& app : m_apps)
+            {
+                if (app.lastLaunch != 0 && app.client == client)
+                {
+                    slot = &app;
+                    break;
+                }
+                if (app.lastLaunch < slot->lastLaunch)
+                {
+                    slot = &app;
+                }
+            }
+
+            if (slot->lastLaunch == 0 || slot->client != client)
+            {
+                *slot = App();
+                slot->client = client;
+            }
+            slot->lastLaunch = ++m_launchCount;
+            return *slot;
+        }
+
+        LaunchMetrics::App* LaunchMetrics::findLocked(const std::string& client)
+        {
+            for (App& app : m_apps)
+            {
+                if (app.lastLaunch != 0 && app.client == client)
+                {
+                    return &app;
+                }
+            }
+            return nullptr;
+        }
+
+        void LaunchMetrics::reportOf(const App& app, LaunchMetricsReport& report)
+        {
+            report.client = app.client;
+            report.lastLaunchType = app.lastLaunchType;
+            report.launches = app.launches;
+            report.pooledLaunches = app.pooledLaunches;
+            report.failures = app.failures;
+            app.total.report(report.total);
+            app.firstFrame.report(report.firstFrame);
+            app.firstFramePooled.report(report.firstFramePooled);
+            for (int i = 0; i < LAUNCH_PHASE_COUNT; i++)
+            {
+                app.phases[i].report(report.phases[i]);
+            }
+        }
+
+    } // namespace Plugin
+} // namespace WPEFramework
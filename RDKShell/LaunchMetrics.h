@@ -0,0 +1,189 @@
+/**
+* If not stated otherwise in this file or this component's LICENSE
+* file the following copyright and licenses apply:
+*
+* Copyright 2020 RDK Management
+*
+* Licensed under the Apache License, Version 2.0 (the "License");
+* you may not use this file except in compliance with the License.
+* You may obtain a copy of the License at
+*
+* http://www.apache.org/licenses/LICENSE-2.0
+*
+* Unless required by applicable law or agreed to in writing, software
+* distributed under the License is distributed on an "AS IS" BASIS,
+* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+* See the License for the specific language governing permissions and
+* limitations under the License.
+**/
+
+#pragma once
+
+#include <stdint.h>
+#include <mutex>
+#include <string>
+#include <vector>
+
+// Upper bounds of the histogram buckets in ms, launches longer than the last one are counted in an extra bucket
+#define LAUNCH_METRICS_BUCKET_BOUNDS_MS { 1, 2, 5, 10, 20, 50, 100, 200, 500, 1000, 2000, 5000, 10000, 20000 }
+#define LAUNCH_METRICS_BUCKETS 15
+// Apps with their own histograms; the least recently launched one gives its slot to a new one
+#define LAUNCH_METRICS_MAX_APPS 32
+
+namespace WPEFramework {
+
+    namespace Plugin {
+
+        // The phases of RDKShell::launchWrapper, in the order they start
+        enum LaunchPhase
+        {
+            LAUNCH_PHASE_STATUS = 0,        // controller status, to find the plugin or its type
+            LAUNCH_PHASE_DISPLAY,           // the render thread creating the display, runs alongside clone and configuration
+            LAUNCH_PHASE_CLONE,
+            LAUNCH_PHASE_CONFIGURATION,     // configuration@ get and set
+            LAUNCH_PHASE_ACTIVATE,          // status@ and activate
+            LAUNCH_PHASE_BOUNDS,
+            LAUNCH_PHASE_STATE,             // suspend/resume, visibility and focus
+            LAUNCH_PHASE_URL,
+            LAUNCH_PHASE_COUNT
+        };
+
+        const char* launchPhaseName(LaunchPhase phase);
+
+        /**
+        * @brief When each phase of one launch started and how long it took, in ms
+        * since the launch started. Phases that did not run are not set.
+        */
+        class LaunchTimeline
+        {
+        public:
+            LaunchTimeline();
+
+            // Steady clock, in ms
+            static double now();
+
+            void begin(LaunchPhase phase);
+            // endMs is a steady clock time for a phase that ended on another thread, now if not given
+            void end(LaunchPhase phase, double endMs = -1);
+
+            double startedAtMs() const { return m_launchStartMs; }
+            bool ran(LaunchPhase phase) const { return m_durationMs[phase] >= 0; }
+            double startMs(LaunchPhase phase) const { return m_startMs[phase]; }
+            double durationMs(LaunchPhase phase) const { return m_durationMs[phase]; }
+            double elapsedMs() const;
+
+        private:
+            double m_launchStartMs;
+            double m_beginMs[LAUNCH_PHASE_COUNT];
+            double m_startMs[LAUNCH_PHASE_COUNT];
+            double m_durationMs[LAUNCH_PHASE_COUNT];
+        };
+
+        struct LaunchHistogramReport
+        {
+            LaunchHistogramReport()
+            : count(0), minMs(0), maxMs(0), meanMs(0), p50Ms(0), p95Ms(0)
+            {
+            }
+
+            uint32_t count;
+            double minMs;
+            double maxMs;
+            double meanMs;
+            double p50Ms;           // interpolated within the bucket
+            double p95Ms;
+            std::vector<uint32_t> buckets;
+        };
+
+        class LaunchHistogram
+        {
+        public:
+            LaunchHistogram();
+
+            static double boundOf(uint32_t bucket);
+            static uint32_t bucketOf(double ms);
+
+            void record(double ms);
+            uint32_t count() const { return m_count; }
+            double percentile(double percent) const;
+            void report(LaunchHistogramReport& report) const;
+
+        private:
+            uint32_t m_counts[LAUNCH_METRICS_BUCKETS];
+            uint32_t m_count;
+            double m_totalMs;
+            double m_minMs;
+            double m_maxMs;
+        };
+
+        struct LaunchMetricsReport
+        {
+            LaunchMetricsReport() : launches(0), pooledLaunches(0), failures(0) {}
+
+            std::string client;
+            std::string lastLaunchType;
+            uint32_t launches;
+            uint32_t pooledLaunches;
+            uint32_t failures;
+            LaunchHistogramReport total;
+            LaunchHistogramReport phases[LAUNCH_PHASE_COUNT];
+            // From the launch request to the first frame of the app
+            LaunchHistogramReport firstFrame;
+            LaunchHistogramReport firstFramePooled;
+        };
+
+        /**
+        * @brief Per app histograms of the launch phases. Launches run on their own
+        * threads, so all calls are serialized.
+        */
+        class LaunchMetrics
+        {
+        public:
+            LaunchMetrics();
+
+            LaunchMetrics(const LaunchMetrics&) = delete;
+            LaunchMetrics& operator=(const LaunchMetrics&) = delete;
+
+            // A launch of the client began, its first frame is measured from then
+            void started(const std::string& client, const LaunchTimeline& timeline);
+            /**
+            * @brief A successful launch. The instance of a pooled launch has drawn its
+            * first frame already, while it was warmed up, so it is shown once launched.
+            */
+            void record(const std::string& client, const std::string& launchType, const LaunchTimeline& timeline, bool pooled = false);
+            void recordFailure(const std::string& client);
+            void firstFrame(const std::string& client);
+
+            bool report(const std::string& client, LaunchMetricsReport& report) const;
+            // Most recently launched first
+            void reports(std::vector<LaunchMetricsReport>& reports) const;
+
+        private:
+            struct App
+            {
+                App() : lastLaunch(0), launches(0), pooledLaunches(0), failures(0), launchStartMs(-1) {}
+
+                std::string client;
+                std::string lastLaunchType;
+                uint64_t lastLaunch;
+                uint32_t launches;
+                uint32_t pooledLaunches;
+                uint32_t failures;
+                double launchStartMs;       // of the launch waiting for its first frame
+                LaunchHistogram total;
+                LaunchHistogram phases[LAUNCH_PHASE_COUNT];
+                LaunchHistogram firstFrame;
+                LaunchHistogram firstFramePooled;
+            };
+
+            App& appLocked(const std::string& client);
+            App* findLocked(const std::string& client);
+            static void reportOf(const App& app, LaunchMetricsReport& report);
+
+            mutable std::mutex m_mutex;
+            App m_apps[LAUNCH_METRICS_MAX_APPS];
+            uint64_t m_launchCount;
+        };
+
+    } // namespace Plugin
+} // namespace WPEFramework
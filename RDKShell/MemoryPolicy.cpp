@@ -0,0 +1,432 @@
+/**
+* If not stated otherwise in this file or this component's LICENSE
+* file the following copyright and licenses apply:
+*
+* Copyright 2020 RDK Management
+*
+* Licensed under the Apache License, Version 2.0 (the "License");
+* you may not use this file except in compliance with the License.
+* You may obtain a copy of the License at
+*
+* http://www.apache.org/licenses/LICENSE-2.0
+*
+* Unless required by applicable law or agreed to in writing, software
+* distributed under the License is distributed on an "AS IS" BASIS,
+* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+* See the License for the specific language governing permissions and
+* limitations under the License.
+**/
+
+#include "MemoryPolicy.h"
+
+#include <dirent.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <algorithm>
+#include <fstream>
+#include <sstream>
+
+namespace WPEFramework
+{
+    namespace Plugin
+    {
+        MemoryPolicy::MemoryPolicy()
+        : m_enabled(false), m_hysteresisKb(MEMORY_POLICY_DEFAULT_HYSTERESIS_KB), m_protected(1, MEMORY_POLICY_DEFAULT_PROTECTED)
+        , m_lowRamKb(0), m_criticallyLowRamKb(0), m_running(false), m_shutdown(false), m_threads(0), m_level(NORMAL), m_pending(false), m_focusCount(0)
+        {
+        }
+
+        bool MemoryPolicy::configure(bool enabled, uint32_t hysteresisKb, const std::vector<std::string>& protectedCallsigns)
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            if (enabled && (m_lowRamKb == 0 || m_criticallyLowRamKb == 0))
+            {
+                return false;
+            }
+            m_enabled = enabled;
+            m_hysteresisKb = hysteresisKb;
+            m_protected = protectedCallsigns;
+            return true;
+        }
+
+        bool MemoryPolicy::enabled() const
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            return m_enabled;
+        }
+
+        uint32_t MemoryPolicy::hysteresisKb() const
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            return m_hysteresisKb;
+        }
+
+        std::vector<std::string> MemoryPolicy::protectedCallsigns() const
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            return m_protected;
+        }
+
+        void MemoryPolicy::setLowRamKb(uint32_t lowRamKb)
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_lowRamKb = lowRamKb;
+        }
+
+        void MemoryPolicy::setCriticallyLowRamKb(uint32_t criticallyLowRamKb)
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_criticallyLowRamKb = criticallyLowRamKb;
+        }
+
+        uint32_t MemoryPolicy::lowRamKb() const
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            return m_lowRamKb;
+        }
+
+        uint32_t MemoryPolicy::criticallyLowRamKb() const
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            return m_criticallyLowRamKb;
+        }
+
+        bool MemoryPolicy::start()
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            if (!m_enabled || m_running || m_shutdown)
+            {
+                return false;
+            }
+            m_running = true;
+            m_threads++;
+            return true;
+        }
+
+        void MemoryPolicy::leave()
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_threads--;
+            m_idle.notify_all();
+        }
+
+        void MemoryPolicy::shutdown()
+        {
+            std::unique_lock<std::mutex> lock(m_mutex);
+            m_shutdown = true;
+            m_idle.wait(lock, [this]() { return m_threads == 0; });
+        }
+
+        void MemoryPolicy::resume()
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_shutdown = false;
+        }
+
+        MemoryPolicy::Result MemoryPolicy::evaluate(double nowMs, uint32_t freeKb, const std::vector<App>& apps)
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            Result result;
+            if (m_shutdown)
+            {
+                m_running = false;
+                result.done = true;
+                return result;
+            }
+
+            m_level = levelLocked(freeKb);
+            result.level = m_level;
+
+            // A round settles after some time, or right away when it did not keep memory from getting worse
+            if (m_pending && (nowMs - m_round.startMs >= MEMORY_POLICY_SETTLE_MS || m_level > m_round.level))
+            {
+                m_round.reclaimedKb = static_cast<int64_t>(freeKb) - m_round.freeKb;
+                if (m_round.reclaimedKb > 0)
+                {
+                    m_stats.reclaimedKb += m_round.reclaimedKb;
+                }
+                result.settled = true;
+                result.round = m_round;
+                m_pending = false;
+            }
+
+            if (m_enabled && m_level != NORMAL && !m_pending)
+            {
+                decideLocked(freeKb, apps, result.decisions);
+                if (!result.decisions.empty())
+                {
+                    m_round = Round();
+                    m_round.level = m_level;
+                    m_round.startMs = nowMs;
+                    m_round.freeKb = freeKb;
+                    m_round.decisions = result.decisions;
+                    for (const Decision& decision : result.decisions)
+                    {
+                        m_round.estimatedKb += decision.estimatedKb;
+                        if (decision.action == SUSPEND)
+                        {
+                            m_stats.suspended++;
+                        }
+                        else
+                        {
+                            m_stats.destroyed++;
+                        }
+                    }
+                    m_stats.rounds++;
+                    m_pending = true;
+                }
+            }
+
+            // Sampled until the round settles, then only while it acted upon something: with memory back
+            // or nothing left to act upon the next warning, or a focus change while low, starts it again
+            if (!m_pending)
+            {
+                m_running = false;
+                result.done = true;
+            }
+            return result;
+        }
+
+        void MemoryPolicy::focused(const std::string& callsign)
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_lastFocus[callsign] = ++m_focusCount;
+        }
+
+        void MemoryPolicy::removed(const std::string& callsign)
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_lastFocus.erase(callsign);
+        }
+
+        MemoryPolicy::Level MemoryPolicy::level() const
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            return m_level;
+        }
+
+        MemoryPolicy::Stats MemoryPolicy::stats() const
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            return m_stats;
+        }
+
+        const char* MemoryPolicy::levelName(Level level)
+        {
+            switch (level)
+            {
+                case LOW: return "low";
+                case CRITICAL: return "critical";
+                default: return "normal";
+            }
+        }
+
+        const char* MemoryPolicy::actionName(Action action)
+        {
+            return (action == SUSPEND) ? "suspend" : "destroy";
+        }
+
+        MemoryPolicy::Level MemoryPolicy::levelLocked(uint32_t freeKb) const
+        {
+            // A level is entered below its threshold and only left above it plus the hysteresis
+            uint64_t freeRam = freeKb;
+            if (freeRam < m_criticallyLowRamKb || (m_level == CRITICAL && freeRam < static_cast<uint64_t>(m_criticallyLowRamKb) + m_hysteresisKb))
+            {
+                return CRITICAL;
+            }
+            if (freeRam < m_lowRamKb || (m_level != NORMAL && freeRam < static_cast<uint64_t>(m_lowRamKb) + m_hysteresisKb))
+            {
+                return LOW;
+            }
+            return NORMAL;
+        }
+
+        void MemoryPolicy::decideLocked(uint32_t freeKb, const std::vector<App>& apps, std::vector<Decision>& decisions)
+        {
+            int64_t neededKb = static_cast<int64_t>(m_lowRamKb) + m_hysteresisKb - freeKb;
+
+            std::vector<const App*> candidates;
+            for (const App& app : apps)
+            {
+                if (!app.focused && !isProtectedLocked(app.callsign))
+                {
+                    candidates.push_back(&app);
+                }
+            }
+
+            // Suspended apps first, then the least recently focused, then the largest
+            std::sort(candidates.begin(), candidates.end(), [this](const App* a, const App* b) {
+                if (a->suspended != b->suspended)
+                {
+                    return a->suspended;
+                }
+                auto aFocus = m_lastFocus.find(a->callsign);
+                auto bFocus = m_lastFocus.find(b->callsign);
+                uint64_t aLast = (aFocus != m_lastFocus.end()) ? aFocus->second : 0;
+                uint64_t bLast = (bFocus != m_lastFocus.end()) ? bFocus->second : 0;
+                if (aLast != bLast)
+                {
+                    return aLast < bLast;
+                }
+                return a->pssKb > b->pssKb;
+            });
+
+            int64_t plannedKb = 0;
+            for (const App* app : candidates)
+            {
+                if (plannedKb >= neededKb)
+                {
+                    break;
+                }
+
+                Decision decision;
+                decision.callsign = app->callsign;
+                if (app->suspended || m_level == CRITICAL)
+                {
+                    decision.action = DESTROY;
+                    decision.estimatedKb = app->pssKb;
+                }
+                else
+                {
+                    decision.action = SUSPEND;
+                    decision.estimatedKb = static_cast<uint32_t>(static_cast<uint64_t>(app->pssKb) * MEMORY_POLICY_SUSPEND_RECLAIM_PERCENT / 100);
+                }
+
+                // Not disrupting an app for memory it may not hold
+                if (decision.estimatedKb == 0)
+                {
+                    continue;
+                }
+                decisions.push_back(decision);
+                plannedKb += decision.estimatedKb;
+            }
+        }
+
+        bool MemoryPolicy::isProtectedLocked(const std::string& callsign) const
+        {
+            return std::find(m_protected.begin(), m_protected.end(), callsign) != m_protected.end();
+        }
+
+        ProcessMemory::ProcessMemory(const std::string& procRoot)
+        : m_procRoot(procRoot)
+        {
+        }
+
+        void ProcessMemory::refresh()
+        {
+            m_processes.clear();
+            DIR* proc = opendir(m_procRoot.c_str());
+            if (proc == nullptr)
+            {
+                return;
+            }
+
+            struct dirent* entry;
+            while ((entry = readdir(proc)) != nullptr)
+            {
+                char* end = nullptr;
+                long pid = strtol(entry->d_name, &end, 10);
+                if (pid <= 0 || *end != '\0')
+                {
+                    continue;
+                }
+
+                const std::string path = m_procRoot + "/" + entry->d_name;
+                std::ifstream statFile(path + "/stat");
+                std::string stat;
+                if (!std::getline(statFile, stat))
+                {
+                    continue;
+                }
+
+                // The name may hold spaces and parentheses, the state and parent follow the last one
+                size_t nameEnd = stat.rfind(')');
+                if (nameEnd == std::string::npos)
+                {
+                    continue;
+                }
+                Process process;
+                char state = 0;
+                std::istringstream fields(stat.substr(nameEnd + 1));
+                if (!(fields >> state >> process.ppid))
+                {
+                    continue;
+                }
+
+                // Thunder hosts out of process plugins in WPEProcess -C <callsign>
+                std::ifstream cmdlineFile(path + "/cmdline");
+                std::string argument;
+                bool callsignFollows = false;
+                while (std::getline(cmdlineFile, argument, '\0'))
+                {
+                    if (callsignFollows)
+                    {
+                        process.callsign = argument;
+                        break;
+                    }
+                    callsignFollows = (argument == "-C");
+                }
+                m_processes[static_cast<int>(pid)] = process;
+            }
+            closedir(proc);
+        }
+
+        std::vector<int> ProcessMemory::processesOf(const std::string& callsign) const
+        {
+            std::vector<int> pids;
+            for (const auto& process : m_processes)
+            {
+                if (process.second.callsign == callsign)
+                {
+                    pids.push_back(process.first);
+                }
+            }
+
+            for (size_t i = 0; i < pids.size(); i++)
+            {
+                for (const auto& process : m_processes)
+                {
+                    if (process.second.ppid == pids[i] && std::find(pids.begin(), pids.end(), process.first) == pids.end())
+                    {
+                        pids.push_back(process.first);
+                    }
+                }
+            }
+            return pids;
+        }
+
+        uint32_t ProcessMemory::pssKb(int pid) const
+        {
+            const std::string path = m_procRoot + "/" + std::to_string(pid);
+            // smaps_rollup is much cheaper, smaps is there on older kernels
+            std::ifstream smaps(path + "/smaps_rollup");
+            if (!smaps.is_open())
+            {
+                smaps.open(path + "/smaps");
+            }
+
+            uint64_t pss = 0;
+            std::string line;
+            while (std::getline(smaps, line))
+            {
+                if (line.compare(0, 4, "Pss:") == 0)
+                {
+                    pss += strtoull(line.c_str() + 4, nullptr, 10);
+                }
+            }
+            return static_cast<uint32_t>(std::min<uint64_t>(pss, UINT32_MAX));
+        }
+
+        uint32_t ProcessMemory::pssKb(const std::string& callsign) const
+        {
+            uint64_t pss = 0;
+            for (int pid : processesOf(callsign))
+            {
+                pss += pssKb(pid);
+            }
+            return static_cast<uint32_t>(std::min<uint64_t>(pss, UINT32_MAX));
+        }
+
+    } // namespace Plugin
+} // namespace WPEFramework
@@ -0,0 +1,204 @@
+/**
+* If not stated otherwise in this file or this component's LICENSE
+* file the following copyright and licenses apply:
+*
+* Copyright 2020 RDK Management
+*
+* Licensed under the Apache License, Version 2.0 (the "License");
+* you may not use this file except in compliance with the License.
+* You may obtain a copy of the License at
+*
+* http://www.apache.org/licenses/LICENSE-2.0
+*
+* Unless required by applicable law or agreed to in writing, software
+* distributed under the License is distributed on an "AS IS" BASIS,
+* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+* See the License for the specific language governing permissions and
+* limitations under the License.
+**/
+
+#pragma once
+
+#include <stdint.h>
+#include <condition_variable>
+#include <map>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#define MEMORY_POLICY_DEFAULT_HYSTERESIS_KB (16 * 1024)
+// Time given to the apps acted upon to release their memory before the next round
+#define MEMORY_POLICY_SETTLE_MS 3000
+// Part of its PSS a suspended app is expected to give back
+#define MEMORY_POLICY_SUSPEND_RECLAIM_PERCENT 30
+#define MEMORY_POLICY_DEFAULT_PROTECTED "ResidentApp"
+
+namespace WPEFramework {
+
+    namespace Plugin {
+
+        /**
+        * @brief Decides which apps RDKShell suspends or destroys while free memory is below
+        * the lowRam and criticallyLowRam thresholds of setMemoryMonitor, until it is back
+        * above lowRam plus the hysteresis. Only the decisions: RDKShell samples the memory
+        * and the apps and carries the decisions out. All calls are serialized.
+        */
+        class MemoryPolicy
+        {
+        public:
+            enum Level
+            {
+                NORMAL,
+                LOW,
+                CRITICAL
+            };
+
+            enum Action
+            {
+                SUSPEND,
+                DESTROY
+            };
+
+            // An app that may be acted upon, as sampled
+            struct App
+            {
+                std::string callsign;
+                bool focused;
+                bool suspended;
+                uint32_t pssKb;
+            };
+
+            struct Decision
+            {
+                std::string callsign;
+                Action action;
+                uint32_t estimatedKb;
+            };
+
+            // The decisions taken at once, and what they gave back once settled
+            struct Round
+            {
+                Round() : level(NORMAL), startMs(0), freeKb(0), estimatedKb(0), reclaimedKb(0) {}
+
+                Level level;
+                double startMs;
+                uint32_t freeKb;
+                uint32_t estimatedKb;
+                int64_t reclaimedKb;
+                std::vector<Decision> decisions;
+            };
+
+            struct Result
+            {
+                Result() : level(NORMAL), settled(false), done(false) {}
+
+                Level level;
+                std::vector<Decision> decisions;    // to carry out now
+                bool settled;                       // round holds the previous round
+                Round round;
+                bool done;                          // memory is back or nothing is left to act upon, no more samples needed
+            };
+
+            struct Stats
+            {
+                Stats() : rounds(0), suspended(0), destroyed(0), reclaimedKb(0) {}
+
+                uint32_t rounds;
+                uint32_t suspended;
+                uint32_t destroyed;
+                uint64_t reclaimedKb;
+            };
+
+            MemoryPolicy();
+
+            MemoryPolicy(const MemoryPolicy&) = delete;
+            MemoryPolicy& operator=(const MemoryPolicy&) = delete;
+
+            // Enabling fails, and changes nothing, while a threshold is not set
+            bool configure(bool enabled, uint32_t hysteresisKb, const std::vector<std::string>& protectedCallsigns);
+            bool enabled() const;
+            uint32_t hysteresisKb() const;
+            std::vector<std::string> protectedCallsigns() const;
+
+            // The thresholds of the memory monitor, 0 while not set
+            void setLowRamKb(uint32_t lowRamKb);
+            void setCriticallyLowRamKb(uint32_t criticallyLowRamKb);
+            uint32_t lowRamKb() const;
+            uint32_t criticallyLowRamKb() const;
+
+            // On a low memory warning; false if disabled, already sampling or shut down
+            bool start();
+            // The thread sampling after a successful start returns
+            void leave();
+            // Stops sampling and waits for the sampling thread to leave, start fails until resumed
+            void shutdown();
+            void resume();
+            /**
+            * @brief One memory sample, taken while started.
+            * @param apps the apps that may be acted upon, i.e. neither launching, destroying nor pooled
+            */
+            Result evaluate(double nowMs, uint32_t freeKb, const std::vector<App>& apps);
+
+            // Focus history, the least recently focused apps go first
+            void focused(const std::string& callsign);
+            void removed(const std::string& callsign);
+
+            Level level() const;
+            Stats stats() const;
+
+            static const char* levelName(Level level);
+            static const char* actionName(Action action);
+
+        private:
+            Level levelLocked(uint32_t freeKb) const;
+            void decideLocked(uint32_t freeKb, const std::vector<App>& apps, std::vector<Decision>& decisions);
+            bool isProtectedLocked(const std::string& callsign) const;
+
+            mutable std::mutex m_mutex;
+            bool m_enabled;
+            uint32_t m_hysteresisKb;
+            std::vector<std::string> m_protected;
+            uint32_t m_lowRamKb;
+            uint32_t m_criticallyLowRamKb;
+            bool m_running;
+            bool m_shutdown;
+            uint32_t m_threads;
+            std::condition_variable m_idle;
+            Level m_level;
+            bool m_pending;
+            Round m_round;
+            std::map<std::string, uint64_t> m_lastFocus;
+            uint64_t m_focusCount;
+            Stats m_stats;
+        };
+
+        /**
+        * @brief Proportional set size of the processes of out of process plugins, i.e. what
+        * destroying one gives back, from /proc.
+        */
+        class ProcessMemory
+        {
+        public:
+            explicit ProcessMemory(const std::string& procRoot = "/proc");
+
+            // Reads the process table, once per sample
+            void refresh();
+            // The WPEProcess hosting the callsign and its descendants, such as the web processes
+            std::vector<int> processesOf(const std::string& callsign) const;
+            uint32_t pssKb(int pid) const;
+            // 0 if the callsign is not hosted out of process
+            uint32_t pssKb(const std::string& callsign) const;
+
+        private:
+            struct Process
+            {
+                int ppid;
+                std::string callsign;
+            };
+
+            std::string m_procRoot;
+            std::map<int, Process> m_processes;
+        };
+
+    } // namespace Plugin
+} // namespace WPEFramework
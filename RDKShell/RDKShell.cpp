@@ -118,6 +118,11 @@ const string WPEFramework::Plugin::RDKShell::RDKSHELL_METHOD_GET_SCREENSHOT = "g
 const string WPEFramework::Plugin::RDKShell::RDKSHELL_METHOD_ENABLE_EASTER_EGGS = "enableEasterEggs";
 const string WPEFramework::Plugin::RDKShell::RDKSHELL_METHOD_ENABLE_LOGS_FLUSHING = "enableLogsFlushing";
 const string WPEFramework::Plugin::RDKShell::RDKSHELL_METHOD_GET_LOGS_FLUSHING_ENABLED = "getLogsFlushingEnabled";
+const string WPEFramework::Plugin::RDKShell::RDKSHELL_METHOD_GET_LAUNCH_METRICS = "getLaunchMetrics";
+const string WPEFramework::Plugin::RDKShell::RDKSHELL_METHOD_SET_WARM_POOL = "setWarmPool";
+const string WPEFramework::Plugin::RDKShell::RDKSHELL_METHOD_GET_WARM_POOL = "getWarmPool";
+const string WPEFramework::Plugin::RDKShell::RDKSHELL_METHOD_SET_MEMORY_POLICY = "setMemoryPolicy";
+const string WPEFramework::Plugin::RDKShell::RDKSHELL_METHOD_GET_MEMORY_POLICY = "getMemoryPolicy";
 
 const string WPEFramework::Plugin::RDKShell::RDKSHELL_EVENT_ON_USER_INACTIVITY = "onUserInactivity";
 const string WPEFramework::Plugin::RDKShell::RDKSHELL_EVENT_ON_APP_LAUNCHED = "onApplicationLaunched";
@@ -139,6 +144,10 @@ const string WPEFramework::Plugin::RDKShell::RDKSHELL_EVENT_DEVICE_CRITICALLY_LO
 const string WPEFramework::Plugin::RDKShell::RDKSHELL_EVENT_ON_EASTER_EGG = "onEasterEgg";
 const string WPEFramework::Plugin::RDKShell::RDKSHELL_EVENT_ON_WILL_DESTROY = "onWillDestroy";
 const string WPEFramework::Plugin::RDKShell::RDKSHELL_EVENT_ON_SCREENSHOT_COMPLETE = "onScreenshotComplete";
+const string WPEFramework::Plugin::RDKShell::RDKSHELL_EVENT_ON_BLUR = "onBlur";
+const string WPEFramework::Plugin::RDKShell::RDKSHELL_EVENT_ON_FOCUS = "onFocus";
+const string WPEFramework::Plugin::RDKShell::RDKSHELL_EVENT_ON_MEMORY_POLICY_ACTION = "onMemoryPolicyAction";
+const string WPEFramework::Plugin::RDKShell::RDKSHELL_EVENT_ON_MEMORY_RECLAIMED = "onMemoryReclaimed";
 
 using namespace std;
 using namespace RdkShell;
@@ -408,7 +417,7 @@ namespace WPEFramework {
 
         struct CreateDisplayRequest
         {
-            CreateDisplayRequest(std::string client, std::string displayName, uint32_t displayWidth=0, uint32_t displayHeight=0, bool virtualDisplayEnabled=false, uint32_t virtualWidth=0, uint32_t virtualHeight=0, bool topmost = false, bool focus = false): mClient(client), mDisplayName(displayName), mDisplayWidth(displayWidth), mDisplayHeight(displayHeight), mVirtualDisplayEnabled(virtualDisplayEnabled), mVirtualWidth(virtualWidth),mVirtualHeight(virtualHeight), mTopmost(topmost), mFocus(focus), mResult(false)
+            CreateDisplayRequest(std::string client, std::string displayName, uint32_t displayWidth=0, uint32_t displayHeight=0, bool virtualDisplayEnabled=false, uint32_t virtualWidth=0, uint32_t virtualHeight=0, bool topmost = false, bool focus = false): mClient(client), mDisplayName(displayName), mDisplayWidth(displayWidth), mDisplayHeight(displayHeight), mVirtualDisplayEnabled(virtualDisplayEnabled), mVirtualWidth(virtualWidth),mVirtualHeight(virtualHeight), mTopmost(topmost), mFocus(focus), mResult(false), mCreatedTime(0)
             {
                 sem_init(&mSemaphore, 0, 0);
             }
@@ -429,6 +438,7 @@ namespace WPEFramework {
             bool mFocus;
             sem_t mSemaphore;
             bool mResult;
+            double mCreatedTime;
         };
 
         struct KillClientRequest
@@ -450,6 +460,9 @@ namespace WPEFramework {
 
         std::vector<std::shared_ptr<CreateDisplayRequest>> gCreateDisplayRequests;
         std::vector<std::shared_ptr<KillClientRequest>> gKillClientRequests;
+        LaunchMetrics gLaunchMetrics;
+        WarmPool gWarmPool;
+        MemoryPolicy gMemoryPolicy;
 
         void RDKShell::launchRequestThread(RDKShellApiRequest apiRequest)
         {
@@ -476,6 +489,23 @@ namespace WPEFramework {
                 {
                     launchFactoryAppShortcutWrapper(apiRequest.mRequest, result);
                 }
+                else if (requestName.compare("fillWarmPool") == 0)
+                {
+                    fillWarmPool();
+                }
+                else if (requestName.compare("memoryPolicy") == 0)
+                {
+                    runMemoryPolicy();
+                }
+                else if (requestName.compare("evictWarmPool") == 0)
+                {
+                    const JsonArray callsigns = apiRequest.mRequest["callsigns"].Array();
+                    for (uint16_t i = 0; i < callsigns.Length(); i++)
+                    {
+                        destroyWarmInstance(callsigns[i].String());
+                    }
+                    gWarmPool.leave();
+                }
 		else if (requestName.compare("deactivateresidentapp") == 0)
                 {
                     auto thunderController = std::unique_ptr<JSONRPCDirectLink>(new JSONRPCDirectLink(mCurrentService));
@@ -793,6 +823,11 @@ namespace WPEFramework {
 
             registerMethod(RDKSHELL_METHOD_ENABLE_LOGS_FLUSHING, &RDKShell::enableLogsFlushingWrapper, this);
             registerMethod(RDKSHELL_METHOD_GET_LOGS_FLUSHING_ENABLED, &RDKShell::getLogsFlushingEnabledWrapper, this);
+            registerMethod(RDKSHELL_METHOD_GET_LAUNCH_METRICS, &RDKShell::getLaunchMetricsWrapper, this);
+            registerMethod(RDKSHELL_METHOD_SET_WARM_POOL, &RDKShell::setWarmPoolWrapper, this);
+            registerMethod(RDKSHELL_METHOD_GET_WARM_POOL, &RDKShell::getWarmPoolWrapper, this);
+            registerMethod(RDKSHELL_METHOD_SET_MEMORY_POLICY, &RDKShell::setMemoryPolicyWrapper, this);
+            registerMethod(RDKSHELL_METHOD_GET_MEMORY_POLICY, &RDKShell::getMemoryPolicyWrapper, this);
 	    m_timer.connect(std::bind(&RDKShell::onTimer, this));
         }
 
@@ -816,6 +851,8 @@ namespace WPEFramework {
             }
 
             mCurrentService = service;
+            gWarmPool.resume();
+            gMemoryPolicy.resume();
             CompositorController::setEventListener(mEventListener);
             bool factoryMacMatched = false;
 #ifdef RFC_ENABLED
@@ -971,6 +1008,7 @@ namespace WPEFramework {
                           continue;
                       }
                       request->mResult = CompositorController::createDisplay(request->mClient, request->mDisplayName, request->mDisplayWidth, request->mDisplayHeight, request->mVirtualDisplayEnabled, request->mVirtualWidth, request->mVirtualHeight, request->mTopmost, request->mFocus);
+                      request->mCreatedTime = LaunchTimeline::now();
                       gCreateDisplayRequests.erase(gCreateDisplayRequests.begin());
                       sem_post(&request->mSemaphore);
                   }
@@ -1273,6 +1311,9 @@ namespace WPEFramework {
         void RDKShell::Deinitialize(PluginHost::IShell* service)
         {
             LOGINFO("Deinitialize");
+            // Their request threads use mCurrentService
+            gMemoryPolicy.shutdown();
+            gWarmPool.shutdown();
             gRdkShellMutex.lock();
             sRunning = false;
             gRdkShellMutex.unlock();
@@ -1389,6 +1430,7 @@ namespace WPEFramework {
         void RDKShell::RdkShellListener::onApplicationFirstFrame(const std::string& client)
         {
           std::cout << "RDKShell onApplicationFirstFrame event received ..." << client << std::endl;
+          gLaunchMetrics.firstFrame(client);
           JsonObject params;
           params["client"] = client;
           mShell.notify(RDKSHELL_EVENT_ON_APP_FIRST_FRAME, params);
@@ -1429,6 +1471,8 @@ namespace WPEFramework {
         void RDKShell::RdkShellListener::onDeviceLowRamWarning(const int32_t freeKb)
         {
           std::cout << "RDKShell onDeviceLowRamWarning event received ..." << freeKb << std::endl;
+          mShell.evictWarmPool(gWarmPool.setLowMemory(true));
+          mShell.startMemoryPolicy();
           JsonObject params;
           params["ram"] = freeKb;
           mShell.notify(RDKSHELL_EVENT_DEVICE_LOW_RAM_WARNING, params);
@@ -1437,6 +1481,8 @@ namespace WPEFramework {
         void RDKShell::RdkShellListener::onDeviceCriticallyLowRamWarning(const int32_t freeKb)
         {
           std::cout << "RDKShell onDeviceCriticallyLowRamWarning event received ..." << freeKb << std::endl;
+          mShell.evictWarmPool(gWarmPool.setLowMemory(true));
+          mShell.startMemoryPolicy();
           JsonObject params;
           params["ram"] = freeKb;
           mShell.notify(RDKSHELL_EVENT_DEVICE_CRITICALLY_LOW_RAM_WARNING, params);
@@ -1445,6 +1491,8 @@ namespace WPEFramework {
         void RDKShell::RdkShellListener::onDeviceLowRamWarningCleared(const int32_t freeKb)
         {
           std::cout << "RDKShell onDeviceLowRamWarningCleared event received ..." << freeKb << std::endl;
+          gWarmPool.setLowMemory(false);
+          mShell.requestWarmPoolFill();
           JsonObject params;
           params["ram"] = freeKb;
           mShell.notify(RDKSHELL_EVENT_DEVICE_LOW_RAM_WARNING_CLEARED, params);
@@ -2910,7 +2958,7 @@ namespace WPEFramework {
         {
             LOGINFOMETHOD();
 
-            double launchStartTime = RdkShell::seconds();
+            LaunchTimeline timeline;
             bool result = true;
             if (!parameters.HasLabel("callsign"))
             {
@@ -2919,6 +2967,7 @@ namespace WPEFramework {
             }
 
             string appCallsign("");
+            bool pooled = false;
             /*if (result)
             {
                 bool launchInProgress = false;
@@ -2946,6 +2995,17 @@ namespace WPEFramework {
             if (result)
             {
                 appCallsign = parameters["callsign"].String();
+                // a ready instance of the type takes the launch instead of a new clone, it is activated already
+                if (parameters.HasLabel("pool") && parameters["pool"].Boolean() && parameters.HasLabel("type") && !parameters.HasLabel("configuration"))
+                {
+                    string warmCallsign;
+                    if (gWarmPool.take(parameters["type"].String(), warmCallsign))
+                    {
+                        std::cout << "launching " << appCallsign << " with the warm instance " << warmCallsign << std::endl;
+                        appCallsign = warmCallsign;
+                        pooled = true;
+                    }
+                }
                 bool isApplicationBeingDestroyed = false;
                 gLaunchDestroyMutex.lock();
                 if (gDestroyApplications.find(appCallsign) != gDestroyApplications.end())
@@ -2966,7 +3026,12 @@ namespace WPEFramework {
                     returnResponse(false);
                 }
                 RDKShellLaunchType launchType = RDKShellLaunchType::UNKNOWN;
-                const string callsign = parameters["callsign"].String();
+                const string callsign = appCallsign;
+                const bool warming = gWarmPool.isPooled(callsign);
+                if (!warming)
+                {
+                    gLaunchMetrics.started(callsign, timeline);
+                }
                 const string callsignWithVersion = callsign + ".1";
                 string type;
                 if (parameters.HasLabel("type"))
@@ -3095,6 +3160,7 @@ namespace WPEFramework {
                 //auto thunderController = getThunderControllerClient();
                 if ((false == newPluginFound) && (false == originalPluginFound))
                 {
+                    timeline.begin(LAUNCH_PHASE_STATUS);
                     Core::JSON::ArrayType<PluginHost::MetaData::Service> availablePluginResult;
                     uint32_t status = thunderController->Get<Core::JSON::ArrayType<PluginHost::MetaData::Service>>(RDKSHELL_THUNDER_TIMEOUT, "status", availablePluginResult);
 
@@ -3122,6 +3188,7 @@ namespace WPEFramework {
                         }
                     }
                     pluginsFound = availablePluginResult.Length();
+                    timeline.end(LAUNCH_PHASE_STATUS);
                 }
 
                 if (!newPluginFound && !originalPluginFound)
@@ -3137,31 +3204,9 @@ namespace WPEFramework {
                     std::cout << "new launch count loc1: 0\n";
                     returnResponse(false);
                 }
-                else if (!newPluginFound)
+                std::shared_ptr<CreateDisplayRequest> displayRequest;
+                if (!newPluginFound)
                 {
-                    std::cout << "attempting to clone type: " << type << " into " << callsign << std::endl;
-                    JsonObject joParams;
-                    joParams.Set("callsign", type);
-                    joParams.Set("newcallsign",callsign.c_str());
-                    JsonObject joResult;
-                    // setting wait Time to 2 seconds
-                    uint32_t status = thunderController->Invoke(RDKSHELL_THUNDER_TIMEOUT, "clone", joParams, joResult, true);
-
-                    std::cout << "clone status: " << status << std::endl;
-                    if (status > 0)
-                    {
-                        std::cout << "trying status one more time...\n";
-                        JsonObject joParams2;
-                        joParams2.Set("callsign", type);
-                        joParams2.Set("newcallsign",callsign.c_str());
-                        status = thunderController->Invoke(RDKSHELL_THUNDER_TIMEOUT, "clone", joParams2, joResult, true);
-                        std::cout << "clone status: " << status << std::endl;
-                    }
-
-                    string strParams;
-                    string strResult;
-                    joParams.ToString(strParams);
-                    joResult.ToString(strResult);
                     launchType = RDKShellLaunchType::CREATE;
                     {
                         bool lockAcquired = false;
@@ -3183,12 +3228,40 @@ namespace WPEFramework {
                     gRdkShellMutex.unlock();
                     if (!isClientExists(callsign))
                     {
-                        std::shared_ptr<CreateDisplayRequest> request = std::make_shared<CreateDisplayRequest>(callsign, displayName, width, height);
+                        // the display only depends on the callsign, the render thread creates it while the
+                        // plugin is cloned and configured and the launch waits for it before activating
+                        displayRequest = std::make_shared<CreateDisplayRequest>(callsign, displayName, width, height);
+                        timeline.begin(LAUNCH_PHASE_DISPLAY);
                         lockRdkShellMutex();
-                        gCreateDisplayRequests.push_back(request);
+                        gCreateDisplayRequests.push_back(displayRequest);
                         gRdkShellMutex.unlock();
-                        sem_wait(&request->mSemaphore);
                     }
+
+                    timeline.begin(LAUNCH_PHASE_CLONE);
+                    std::cout << "attempting to clone type: " << type << " into " << callsign << std::endl;
+                    JsonObject joParams;
+                    joParams.Set("callsign", type);
+                    joParams.Set("newcallsign",callsign.c_str());
+                    JsonObject joResult;
+                    // setting wait Time to 2 seconds
+                    uint32_t status = thunderController->Invoke(RDKSHELL_THUNDER_TIMEOUT, "clone", joParams, joResult, true);
+
+                    std::cout << "clone status: " << status << std::endl;
+                    if (status > 0)
+                    {
+                        std::cout << "trying status one more time...\n";
+                        JsonObject joParams2;
+                        joParams2.Set("callsign", type);
+                        joParams2.Set("newcallsign",callsign.c_str());
+                        status = thunderController->Invoke(RDKSHELL_THUNDER_TIMEOUT, "clone", joParams2, joResult, true);
+                        std::cout << "clone status: " << status << std::endl;
+                    }
+
+                    string strParams;
+                    string strResult;
+                    joParams.ToString(strParams);
+                    joResult.ToString(strResult);
+                    timeline.end(LAUNCH_PHASE_CLONE);
                 }
 
                 WPEFramework::Core::JSON::String configString;
@@ -3196,6 +3269,7 @@ namespace WPEFramework {
                 uint32_t status = 0;
                 string method = "configuration@" + callsign;
                 Core::JSON::ArrayType<PluginHost::MetaData::Service> joResult;
+                timeline.begin(LAUNCH_PHASE_CONFIGURATION);
                 status = thunderController->Get<WPEFramework::Core::JSON::String>(RDKSHELL_THUNDER_TIMEOUT, method.c_str(), configString);
 
                 std::cout << "config status: " << status << std::endl;
@@ -3277,7 +3351,15 @@ namespace WPEFramework {
                     status = thunderController->Set<JsonObject>(RDKSHELL_THUNDER_TIMEOUT, method.c_str(), configSet);
                     std::cout << "set status: " << status << std::endl;
                 }
+                timeline.end(LAUNCH_PHASE_CONFIGURATION);
+
+                if (displayRequest)
+                {
+                    sem_wait(&displayRequest->mSemaphore);
+                    timeline.end(LAUNCH_PHASE_DISPLAY, displayRequest->mCreatedTime);
+                }
 
+                timeline.begin(LAUNCH_PHASE_ACTIVATE);
                 if (launchType == RDKShellLaunchType::UNKNOWN)
                 {
                     status = 0;
@@ -3349,6 +3431,7 @@ namespace WPEFramework {
                         std::cout << "activate 3 status: " << status << std::endl;
                     }
                 }
+                timeline.end(LAUNCH_PHASE_ACTIVATE);
 
                 bool deferLaunch = false;
                 if (status > 0)
@@ -3362,6 +3445,7 @@ namespace WPEFramework {
                     uint32_t tempY = 0;
                     uint32_t screenWidth = 0;
                     uint32_t screenHeight = 0;
+                    timeline.begin(LAUNCH_PHASE_BOUNDS);
                     {
                         bool lockAcquired = false;
                         double startTime = RdkShell::milliseconds();
@@ -3447,7 +3531,9 @@ namespace WPEFramework {
                             std::cout << "unable to move behind " << behind << std::endl;
                         }
                     }
+                    timeline.end(LAUNCH_PHASE_BOUNDS);
 
+                    timeline.begin(LAUNCH_PHASE_STATE);
                     gPluginDataMutex.lock();
                     {
                       auto notificationIt = gStateNotifications.find(callsign);
@@ -3528,9 +3614,11 @@ namespace WPEFramework {
                     }
 
                     setTopmost(callsign, topmost, focus);
+                    timeline.end(LAUNCH_PHASE_STATE);
                     JsonObject urlResult;
                     if (!uri.empty())
                     {
+                        timeline.begin(LAUNCH_PHASE_URL);
                         WPEFramework::Core::JSON::String urlString;
                         urlString = uri;
                         status = JSONRPCDirectLink(mCurrentService, callsign).Set<WPEFramework::Core::JSON::String>(RDKSHELL_THUNDER_TIMEOUT, "url",urlString);
@@ -3538,6 +3626,7 @@ namespace WPEFramework {
                         {
                             std::cout << "failed to set url to " << uri << " with status code " << status << std::endl;
                         }
+                        timeline.end(LAUNCH_PHASE_URL);
                     }
                 }
 
@@ -3566,7 +3655,11 @@ namespace WPEFramework {
                             launchTypeString = "unknown";
                             break;
                     }
-                    std::cout << "Application:" << callsign << " took " << (RdkShell::seconds() - launchStartTime)*1000 << " milliseconds to launch " << std::endl;
+                    std::cout << "Application:" << callsign << " took " << timeline.elapsedMs() << " milliseconds to launch " << std::endl;
+                    if (!warming)
+                    {
+                        gLaunchMetrics.record(callsign, launchTypeString, timeline, pooled);
+                    }
                     gLaunchMutex.lock();
                     gLaunchCount = 0;
                     gLaunchMutex.unlock();
@@ -3574,17 +3667,30 @@ namespace WPEFramework {
                     {
                         std::cout << "deferring application launch " << std::endl;
                     }
+                    else if (warming)
+                    {
+                        std::cout << "warm instance " << callsign << " is ready" << std::endl;
+                    }
                     else
                     {
-                        onLaunched(callsign, launchTypeString);
+                        onLaunched(callsign, launchTypeString, &timeline);
                     }
                     response["launchType"] = launchTypeString;
+                    if (pooled)
+                    {
+                        response["callsign"] = callsign;
+                        response["pooled"] = true;
+                    }
                 }
                 
             }
             if (!result) 
             {
                 response["message"] = "failed to launch application";
+                if (!appCallsign.empty() && !gWarmPool.isPooled(appCallsign))
+                {
+                    gLaunchMetrics.recordFailure(appCallsign);
+                }
             }
             gLaunchMutex.lock();
             gLaunchCount = 0;
@@ -3593,6 +3699,10 @@ namespace WPEFramework {
             gLaunchApplications.erase(appCallsign);
 	    gLaunchDestroyMutex.unlock();
             std::cout << "new launch count at loc2 is 0\n";
+            if (pooled)
+            {
+                requestWarmPoolFill();
+            }
 
             returnResponse(result);
         }
@@ -3719,6 +3829,8 @@ namespace WPEFramework {
                         sFactoryModeStart = false;
                         sFactoryAppLaunchStatus = NOTLAUNCHED;
                     }
+                    gWarmPool.release(callsign);
+                    gMemoryPolicy.removed(callsign);
                     onDestroyed(callsign);
                 }
 		gLaunchDestroyMutex.lock();
@@ -4299,10 +4411,12 @@ namespace WPEFramework {
               if (parameters.HasLabel("lowRam"))
               {
                 configuration["lowRam"] = std::stod(parameters["lowRam"].String());
+                gMemoryPolicy.setLowRamKb(static_cast<uint32_t>(std::stod(parameters["lowRam"].String()) * 1024));
               }
               if (parameters.HasLabel("criticallyLowRam"))
               {
                 configuration["criticallyLowRam"] = std::stod(parameters["criticallyLowRam"].String());
+                gMemoryPolicy.setCriticallyLowRamKb(static_cast<uint32_t>(std::stod(parameters["criticallyLowRam"].String()) * 1024));
               }
               RdkShell::setMemoryMonitor(configuration);
             }
@@ -5084,6 +5198,211 @@ namespace WPEFramework {
             returnResponse(result);
         }
 
+        static JsonObject launchHistogramToJson(const LaunchHistogramReport& report)
+        {
+            // in microseconds, as the phases of onLaunched
+            JsonObject json;
+            json["count"] = report.count;
+            json["min"] = static_cast<uint64_t>(report.minMs * 1000);
+            json["max"] = static_cast<uint64_t>(report.maxMs * 1000);
+            json["average"] = static_cast<uint64_t>(report.meanMs * 1000);
+            json["p50"] = static_cast<uint64_t>(report.p50Ms * 1000);
+            json["p95"] = static_cast<uint64_t>(report.p95Ms * 1000);
+            JsonArray buckets;
+            for (uint32_t count : report.buckets)
+            {
+                buckets.Add(count);
+            }
+            json["buckets"] = buckets;
+            return json;
+        }
+
+        static JsonObject launchMetricsToJson(const LaunchMetricsReport& report)
+        {
+            JsonObject json;
+            json["client"] = report.client;
+            json["launches"] = report.launches;
+            json["pooledLaunches"] = report.pooledLaunches;
+            json["failures"] = report.failures;
+            json["lastLaunchType"] = report.lastLaunchType;
+            json["total"] = launchHistogramToJson(report.total);
+            json["firstFrame"] = launchHistogramToJson(report.firstFrame);
+            json["firstFramePooled"] = launchHistogramToJson(report.firstFramePooled);
+            JsonObject phases;
+            for (int i = 0; i < LAUNCH_PHASE_COUNT; i++)
+            {
+                if (report.phases[i].count > 0)
+                {
+                    phases[launchPhaseName(static_cast<LaunchPhase>(i))] = launchHistogramToJson(report.phases[i]);
+                }
+            }
+            json["phases"] = phases;
+            return json;
+        }
+
+        uint32_t RDKShell::getLaunchMetricsWrapper(const JsonObject& parameters, JsonObject& response)
+        {
+            LOGINFOMETHOD();
+            bool result = true;
+
+            std::vector<LaunchMetricsReport> reports;
+            if (parameters.HasLabel("callsign"))
+            {
+                LaunchMetricsReport report;
+                if (gLaunchMetrics.report(parameters["callsign"].String(), report))
+                {
+                    reports.push_back(report);
+                }
+            }
+            else
+            {
+                gLaunchMetrics.reports(reports);
+            }
+
+            JsonArray bucketBounds;
+            for (uint32_t bucket = 0; bucket < LAUNCH_METRICS_BUCKETS - 1; bucket++)
+            {
+                bucketBounds.Add(static_cast<uint64_t>(LaunchHistogram::boundOf(bucket) * 1000));
+            }
+            JsonArray apps;
+            for (const LaunchMetricsReport& report : reports)
+            {
+                apps.Add(launchMetricsToJson(report));
+            }
+            response["bucketBounds"] = bucketBounds;
+            response["apps"] = apps;
+            returnResponse(result);
+        }
+
+        uint32_t RDKShell::setWarmPoolWrapper(const JsonObject& parameters, JsonObject& response)
+        {
+            LOGINFOMETHOD();
+            bool result = true;
+            if (!parameters.HasLabel("types"))
+            {
+                result = false;
+                response["message"] = "please specify types";
+            }
+            if (result)
+            {
+                std::map<std::string, uint32_t> counts;
+                const JsonArray types = parameters["types"].Array();
+                for (uint16_t i = 0; i < types.Length(); i++)
+                {
+                    const JsonObject type = types[i].Object();
+                    if (!type.HasLabel("type") || !type.HasLabel("count"))
+                    {
+                        result = false;
+                        response["message"] = "please specify type and count of each type";
+                        break;
+                    }
+                    counts[type["type"].String()] = type["count"].Number();
+                }
+                if (result)
+                {
+                    uint32_t minFreeKb = WARM_POOL_DEFAULT_MIN_FREE_KB;
+                    if (parameters.HasLabel("minFreeRam"))
+                    {
+                        minFreeKb = parameters["minFreeRam"].Number();
+                    }
+                    evictWarmPool(gWarmPool.configure(counts, minFreeKb));
+                    requestWarmPoolFill();
+                }
+            }
+            returnResponse(result);
+        }
+
+        uint32_t RDKShell::getWarmPoolWrapper(const JsonObject& parameters, JsonObject& response)
+        {
+            LOGINFOMETHOD();
+            bool result = true;
+            JsonArray types;
+            for (const auto& count : gWarmPool.counts())
+            {
+                JsonObject type;
+                type["type"] = count.first;
+                type["count"] = count.second;
+                types.Add(type);
+            }
+            JsonArray instances;
+            for (const WarmPool::Instance& instance : gWarmPool.instances())
+            {
+                JsonObject instanceObject;
+                instanceObject["callsign"] = instance.callsign;
+                instanceObject["type"] = instance.type;
+                instanceObject["state"] = (instance.state == WarmPool::READY) ? "ready" : ((instance.state == WarmPool::STARTING) ? "starting" : "evicting");
+                instances.Add(instanceObject);
+            }
+            WarmPool::Stats stats = gWarmPool.stats();
+            response["types"] = types;
+            response["minFreeRam"] = gWarmPool.minFreeKb();
+            response["lowRam"] = gWarmPool.lowMemory();
+            response["instances"] = instances;
+            response["hits"] = stats.hits;
+            response["misses"] = stats.misses;
+            response["evictions"] = stats.evictions;
+            response["failures"] = stats.failures;
+            returnResponse(result);
+        }
+
+        uint32_t RDKShell::setMemoryPolicyWrapper(const JsonObject& parameters, JsonObject& response)
+        {
+            LOGINFOMETHOD();
+            bool result = true;
+            if (!parameters.HasLabel("enable"))
+            {
+                result = false;
+                response["message"] = "please specify enable parameter";
+            }
+            if (result)
+            {
+                uint32_t hysteresisKb = MEMORY_POLICY_DEFAULT_HYSTERESIS_KB;
+                if (parameters.HasLabel("hysteresis"))
+                {
+                    hysteresisKb = static_cast<uint32_t>(std::stod(parameters["hysteresis"].String()) * 1024);
+                }
+                std::vector<std::string> protectedCallsigns(1, MEMORY_POLICY_DEFAULT_PROTECTED);
+                if (parameters.HasLabel("protected"))
+                {
+                    protectedCallsigns.clear();
+                    const JsonArray callsigns = parameters["protected"].Array();
+                    for (uint16_t i = 0; i < callsigns.Length(); i++)
+                    {
+                        protectedCallsigns.push_back(callsigns[i].String());
+                    }
+                }
+                if (!gMemoryPolicy.configure(parameters["enable"].Boolean(), hysteresisKb, protectedCallsigns))
+                {
+                    result = false;
+                    response["message"] = "set lowRam and criticallyLowRam with setMemoryMonitor first";
+                }
+            }
+            returnResponse(result);
+        }
+
+        uint32_t RDKShell::getMemoryPolicyWrapper(const JsonObject& parameters, JsonObject& response)
+        {
+            LOGINFOMETHOD();
+            bool result = true;
+            JsonArray protectedCallsigns;
+            for (const std::string& callsign : gMemoryPolicy.protectedCallsigns())
+            {
+                protectedCallsigns.Add(callsign);
+            }
+            MemoryPolicy::Stats stats = gMemoryPolicy.stats();
+            response["enabled"] = gMemoryPolicy.enabled();
+            response["lowRam"] = gMemoryPolicy.lowRamKb() / 1024;
+            response["criticallyLowRam"] = gMemoryPolicy.criticallyLowRamKb() / 1024;
+            response["hysteresis"] = gMemoryPolicy.hysteresisKb() / 1024;
+            response["protected"] = protectedCallsigns;
+            response["level"] = MemoryPolicy::levelName(gMemoryPolicy.level());
+            response["rounds"] = stats.rounds;
+            response["suspended"] = stats.suspended;
+            response["destroyed"] = stats.destroyed;
+            response["reclaimedRam"] = stats.reclaimedKb;
+            returnResponse(result);
+        }
+
         uint32_t RDKShell::enableLogsFlushingWrapper(const JsonObject& parameters, JsonObject& response)
         {
             LOGINFOMETHOD();
@@ -5352,6 +5671,25 @@ namespace WPEFramework {
                         std::cout << "result of set focus to true: " << status << std::endl;
                     }
                 }
+
+                if (ret)
+                {
+                    gMemoryPolicy.focused(client);
+                    // The previously focused app may be acted upon now
+                    if (gMemoryPolicy.level() != MemoryPolicy::NORMAL)
+                    {
+                        startMemoryPolicy();
+                    }
+                    if (!previousFocusedClient.empty())
+                    {
+                        JsonObject params;
+                        params["client"] = previousFocusedClient;
+                        notify(RDKSHELL_EVENT_ON_BLUR, params);
+                    }
+                    JsonObject params;
+                    params["client"] = client;
+                    notify(RDKSHELL_EVENT_ON_FOCUS, params);
+                }
             }
             return ret;
         }
@@ -6062,12 +6400,30 @@ namespace WPEFramework {
             return true;
         }
 
-        void RDKShell::onLaunched(const std::string& client, const string& launchType)
+        void RDKShell::onLaunched(const std::string& client, const string& launchType, const LaunchTimeline* timeline)
         {
             std::cout << "RDKShell onLaunched event received for " << client << std::endl;
             JsonObject params;
             params["client"] = client;
             params["launchType"] = launchType;
+            if (timeline)
+            {
+                // in microseconds since the launch request
+                JsonObject phases;
+                for (int i = 0; i < LAUNCH_PHASE_COUNT; i++)
+                {
+                    LaunchPhase phase = static_cast<LaunchPhase>(i);
+                    if (timeline->ran(phase))
+                    {
+                        JsonObject timing;
+                        timing["start"] = static_cast<uint64_t>(timeline->startMs(phase) * 1000);
+                        timing["duration"] = static_cast<uint64_t>(timeline->durationMs(phase) * 1000);
+                        phases[launchPhaseName(phase)] = timing;
+                    }
+                }
+                params["phases"] = phases;
+                params["duration"] = static_cast<uint64_t>(timeline->elapsedMs() * 1000);
+            }
             notify(RDKSHELL_EVENT_ON_LAUNCHED, params);
         }
 
@@ -6096,6 +6452,204 @@ namespace WPEFramework {
             return ret;
         }
 
+        void RDKShell::requestWarmPoolFill()
+        {
+            if (gWarmPool.requestFill())
+            {
+                RDKShellApiRequest apiRequest;
+                apiRequest.mName = "fillWarmPool";
+                launchRequestThread(apiRequest);
+            }
+        }
+
+        void RDKShell::evictWarmPool(const std::vector<std::string>& callsigns)
+        {
+            if (callsigns.empty() || !gWarmPool.enter())
+            {
+                return;
+            }
+
+            RDKShellApiRequest apiRequest;
+            apiRequest.mName = "evictWarmPool";
+            JsonArray callsignArray;
+            for (const std::string& callsign : callsigns)
+            {
+                callsignArray.Add(callsign);
+            }
+            apiRequest.mRequest["callsigns"] = callsignArray;
+            launchRequestThread(apiRequest);
+        }
+
+        // How much sooner a pooled launch shows its first frame has not been measured on a device yet,
+        // getLaunchMetrics reports firstFrame and firstFramePooled for that comparison
+        void RDKShell::fillWarmPool()
+        {
+            // one instance at a time, and only while there is memory for it
+            WarmPool::Instance instance;
+            while (true)
+            {
+                uint32_t freeKb = 0;
+                uint32_t totalKb = 0;
+                uint32_t usedSwapKb = 0;
+                systemMemory(freeKb, totalKb, usedSwapKb);
+                if (!gWarmPool.next(freeKb, instance))
+                {
+                    break;
+                }
+
+                std::cout << "warming up " << instance.callsign << " of type " << instance.type << std::endl;
+                JsonObject launchParameters;
+                launchParameters["callsign"] = instance.callsign;
+                launchParameters["type"] = instance.type;
+                launchParameters["suspend"] = true;
+                launchParameters["visible"] = false;
+                launchParameters["focused"] = false;
+                JsonObject launchResponse;
+                launchWrapper(launchParameters, launchResponse);
+                if (!gWarmPool.started(instance.callsign, launchResponse["success"].Boolean()))
+                {
+                    destroyWarmInstance(instance.callsign);
+                }
+            }
+            gWarmPool.leave();
+        }
+
+        void RDKShell::destroyWarmInstance(const std::string& callsign)
+        {
+            std::cout << "evicting warm instance " << callsign << std::endl;
+            JsonObject destroyParameters;
+            destroyParameters["callsign"] = callsign;
+            JsonObject destroyResponse;
+            destroyWrapper(destroyParameters, destroyResponse);
+            gWarmPool.release(callsign);
+        }
+
+        void RDKShell::startMemoryPolicy()
+        {
+            if (gMemoryPolicy.start())
+            {
+                RDKShellApiRequest apiRequest;
+                apiRequest.mName = "memoryPolicy";
+                launchRequestThread(apiRequest);
+            }
+        }
+
+        void RDKShell::runMemoryPolicy()
+        {
+            // sampled until free memory is back above lowRam plus the hysteresis, or nothing is left to act upon
+            ProcessMemory processMemory;
+            while (true)
+            {
+                uint32_t freeKb = 0;
+                uint32_t totalKb = 0;
+                uint32_t usedSwapKb = 0;
+                systemMemory(freeKb, totalKb, usedSwapKb);
+                std::vector<MemoryPolicy::App> apps;
+                memoryPolicyApps(processMemory, apps);
+
+                MemoryPolicy::Result result = gMemoryPolicy.evaluate(LaunchTimeline::now(), freeKb, apps);
+                if (result.settled)
+                {
+                    std::cout << "memory policy reclaimed " << result.round.reclaimedKb << " KB of the estimated " << result.round.estimatedKb << " KB" << std::endl;
+                    JsonObject params;
+                    params["level"] = MemoryPolicy::levelName(result.round.level);
+                    params["actions"] = static_cast<uint32_t>(result.round.decisions.size());
+                    params["estimatedRam"] = result.round.estimatedKb;
+                    params["reclaimedRam"] = result.round.reclaimedKb;
+                    params["ram"] = freeKb;
+                    notify(RDKSHELL_EVENT_ON_MEMORY_RECLAIMED, params);
+                }
+
+                for (const MemoryPolicy::Decision& decision : result.decisions)
+                {
+                    std::cout << "memory policy " << MemoryPolicy::levelName(result.level) << ": " << MemoryPolicy::actionName(decision.action)
+                              << " " << decision.callsign << " for an estimated " << decision.estimatedKb << " KB" << std::endl;
+                    JsonObject params;
+                    params["client"] = decision.callsign;
+                    params["action"] = MemoryPolicy::actionName(decision.action);
+                    params["level"] = MemoryPolicy::levelName(result.level);
+                    params["estimatedRam"] = decision.estimatedKb;
+                    params["ram"] = freeKb;
+                    notify(RDKSHELL_EVENT_ON_MEMORY_POLICY_ACTION, params);
+
+                    JsonObject actionParameters;
+                    actionParameters["callsign"] = decision.callsign;
+                    JsonObject actionResponse;
+                    if (decision.action == MemoryPolicy::SUSPEND)
+                    {
+                        suspendWrapper(actionParameters, actionResponse);
+                    }
+                    else
+                    {
+                        destroyWrapper(actionParameters, actionResponse);
+                    }
+                }
+
+                if (result.done)
+                {
+                    break;
+                }
+                usleep(MEMORY_POLICY_SETTLE_MS * 1000 / 3);
+            }
+            gMemoryPolicy.leave();
+        }
+
+        void RDKShell::memoryPolicyApps(ProcessMemory& processMemory, std::vector<MemoryPolicy::App>& apps)
+        {
+            std::map<std::string, PluginData> activePluginsData;
+            gPluginDataMutex.lock();
+            activePluginsData = gActivePluginsData;
+            gPluginDataMutex.unlock();
+
+            std::string focusedClient;
+            lockRdkShellMutex();
+            CompositorController::getFocused(focusedClient);
+            gRdkShellMutex.unlock();
+
+            processMemory.refresh();
+            for (const auto& pluginData : activePluginsData)
+            {
+                const std::string& callsign = pluginData.first;
+                bool launchingOrDestroying = false;
+                gLaunchDestroyMutex.lock();
+                if (gLaunchApplications.find(callsign) != gLaunchApplications.end() || gDestroyApplications.find(callsign) != gDestroyApplications.end())
+                {
+                    launchingOrDestroying = true;
+                }
+                gLaunchDestroyMutex.unlock();
+                if (launchingOrDestroying || gWarmPool.isPooled(callsign))
+                {
+                    continue;
+                }
+
+                MemoryPolicy::App app;
+                app.callsign = callsign;
+                app.focused = (toLower(callsign) == focusedClient);
+                app.suspended = false;
+                gDestroyMutex.lock();
+                PluginHost::IStateControl* stateControl(mCurrentService->QueryInterfaceByCallsign<PluginHost::IStateControl>(callsign));
+                if (stateControl)
+                {
+                    app.suspended = (stateControl->State() == PluginHost::IStateControl::SUSPENDED);
+                    stateControl->Release();
+                }
+                gDestroyMutex.unlock();
+
+                // in process, only what the plugin reports holding
+                app.pssKb = processMemory.pssKb(callsign);
+                if (app.pssKb == 0)
+                {
+                    Exchange::IMemory* pluginMemoryInterface(mCurrentService->QueryInterfaceByCallsign<Exchange::IMemory>(callsign.c_str()));
+                    if (nullptr != pluginMemoryInterface)
+                    {
+                        app.pssKb = pluginMemoryInterface->Resident() / 1024;
+                        pluginMemoryInterface->Release();
+                    }
+                }
+                apps.push_back(app);
+            }
+        }
+
         bool RDKShell::pluginMemoryUsage(const string callsign, JsonArray& memoryInfo)
         {
             JsonObject memoryDetails;
@@ -27,6 +27,9 @@
 #include <rdkshell/linuxkeys.h>
 #include "AbstractPlugin.h"
 #include "tptimer.h"
+#include "LaunchMetrics.h"
+#include "WarmPool.h"
+#include "MemoryPolicy.h"
 
 namespace WPEFramework {
 
@@ -125,6 +128,11 @@ namespace WPEFramework {
             static const string RDKSHELL_METHOD_ENABLE_EASTER_EGGS;
             static const string RDKSHELL_METHOD_ENABLE_LOGS_FLUSHING;
             static const string RDKSHELL_METHOD_GET_LOGS_FLUSHING_ENABLED;
+            static const string RDKSHELL_METHOD_GET_LAUNCH_METRICS;
+            static const string RDKSHELL_METHOD_SET_WARM_POOL;
+            static const string RDKSHELL_METHOD_GET_WARM_POOL;
+            static const string RDKSHELL_METHOD_SET_MEMORY_POLICY;
+            static const string RDKSHELL_METHOD_GET_MEMORY_POLICY;
 
             // events
             static const string RDKSHELL_EVENT_ON_USER_INACTIVITY;
@@ -147,6 +155,10 @@ namespace WPEFramework {
             static const string RDKSHELL_EVENT_ON_EASTER_EGG;
             static const string RDKSHELL_EVENT_ON_WILL_DESTROY;
             static const string RDKSHELL_EVENT_ON_SCREENSHOT_COMPLETE;
+            static const string RDKSHELL_EVENT_ON_BLUR;
+            static const string RDKSHELL_EVENT_ON_FOCUS;
+            static const string RDKSHELL_EVENT_ON_MEMORY_POLICY_ACTION;
+            static const string RDKSHELL_EVENT_ON_MEMORY_RECLAIMED;
 
             void notify(const std::string& event, const JsonObject& parameters);
             void pluginEventHandler(const JsonObject& parameters);
@@ -227,6 +239,11 @@ namespace WPEFramework {
             uint32_t enableEasterEggsWrapper(const JsonObject& parameters, JsonObject& response);
             uint32_t enableLogsFlushingWrapper(const JsonObject& parameters, JsonObject& response);
             uint32_t getLogsFlushingEnabledWrapper(const JsonObject& parameters, JsonObject& response);
+            uint32_t getLaunchMetricsWrapper(const JsonObject& parameters, JsonObject& response);
+            uint32_t setWarmPoolWrapper(const JsonObject& parameters, JsonObject& response);
+            uint32_t getWarmPoolWrapper(const JsonObject& parameters, JsonObject& response);
+            uint32_t setMemoryPolicyWrapper(const JsonObject& parameters, JsonObject& response);
+            uint32_t getMemoryPolicyWrapper(const JsonObject& parameters, JsonObject& response);
 
         private/*internal methods*/:
             RDKShell(const RDKShell&) = delete;
@@ -269,11 +286,18 @@ namespace WPEFramework {
             bool enableInactivityReporting(const bool enable);
             bool setInactivityInterval(const uint32_t interval);
             bool resetInactivityTime();
-            void onLaunched(const std::string& client, const string& launchType);
+            void onLaunched(const std::string& client, const string& launchType, const LaunchTimeline* timeline = nullptr);
             void onSuspended(const std::string& client);
             void onDestroyed(const std::string& client);
             bool systemMemory(uint32_t &freeKb, uint32_t & totalKb, uint32_t & usedSwapKb);
             bool pluginMemoryUsage(const string callsign, JsonArray& memoryInfo);
+            void requestWarmPoolFill();
+            void evictWarmPool(const std::vector<std::string>& callsigns);
+            void fillWarmPool();
+            void destroyWarmInstance(const std::string& callsign);
+            void startMemoryPolicy();
+            void runMemoryPolicy();
+            void memoryPolicyApps(ProcessMemory& processMemory, std::vector<MemoryPolicy::App>& apps);
             bool showWatermark(const bool enable);
             bool showFullScreenImage(std::string& path);
             void killAllApps(bool enableDestroyEvent=false);
@@ -0,0 +1,296 @@
+/**
+* If not stated otherwise in this file or this component's LICENSE
+* file the following copyright and licenses apply:
+*
+* Copyright 2020 RDK Management
+*
+* Licensed under the Apache License, Version 2.0 (the "License");
+* you may not use this file except in compliance with the License.
+* You may obtain a copy of the License at
+*
+* http://www.apache.org/licenses/LICENSE-2.0
+*
+* Unless required by applicable law or agreed to in writing, software
+* distributed under the License is distributed on an "AS IS" BASIS,
+* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+* See the License for the specific language governing permissions and
+* limitations under the License.
+**/
+
+#include "WarmPool.h"
+
+#include <algorithm>
+
+namespace WPEFramework
+{
+    namespace Plugin
+    {
+        WarmPool::WarmPool()
+        : m_minFreeKb(WARM_POOL_DEFAULT_MIN_FREE_KB), m_lowMemory(false), m_filling(false), m_shutdown(false), m_threads(0)
+        {
+        }
+
+        std::vector<std::string> WarmPool::configure(const std::map<std::string, uint32_t>& counts, uint32_t minFreeKb)
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_counts.clear();
+            for (const auto& count : counts)
+            {
+                if (count.second > 0)
+                {
+                    m_counts[count.first] = std::min<uint32_t>(count.second, WARM_POOL_MAX_INSTANCES_PER_TYPE);
+                }
+            }
+            m_minFreeKb = minFreeKb;
+            m_failed.clear();
+            return evictLocked(false);
+        }
+
+        std::map<std::string, uint32_t> WarmPool::counts() const
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            return m_counts;
+        }
+
+        uint32_t WarmPool::minFreeKb() const
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            return m_minFreeKb;
+        }
+
+        bool WarmPool::requestFill()
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            if (m_filling || m_lowMemory || m_shutdown)
+            {
+                return false;
+            }
+
+            for (const auto& count : m_counts)
+            {
+                if (readyOrStartingLocked(count.first) < count.second)
+                {
+                    m_filling = true;
+                    m_threads++;
+                    m_failed.clear();
+                    return true;
+                }
+            }
+            return false;
+        }
+
+        bool WarmPool::next(uint32_t freeKb, Instance& instance)
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            if (!m_lowMemory && !m_shutdown && freeKb >= m_minFreeKb)
+            {
+                for (const auto& count : m_counts)
+                {
+                    if (m_failed.find(count.first) == m_failed.end() && readyOrStartingLocked(count.first) < count.second)
+                    {
+                        instance.callsign = callsignLocked(count.first);
+                        instance.type = count.first;
+                        instance.state = STARTING;
+                        m_instances[instance.callsign] = instance;
+                        return true;
+                    }
+                }
+            }
+
+            // Checked under the same lock as requestFill, so a take right now starts a new fill
+            m_filling = false;
+            return false;
+        }
+
+        bool WarmPool::started(const std::string& callsign, bool success)
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            auto it = m_instances.find(callsign);
+            if (it == m_instances.end())
+            {
+                return false;
+            }
+
+            Instance& instance = it->second;
+            if (!success)
+            {
+                // Whatever is left of it is destroyed
+                m_failed[instance.type] = true;
+                m_stats.failures++;
+                instance.state = EVICTING;
+                return false;
+            }
+
+            auto count = m_counts.find(instance.type);
+            uint32_t ready = 0;
+            for (const auto& other : m_instances)
+            {
+                if (other.second.type == instance.type && other.second.state == READY)
+                {
+                    ready++;
+                }
+            }
+            if (m_lowMemory || count == m_counts.end() || ready >= count->second)
+            {
+                instance.state = EVICTING;
+                m_stats.evictions++;
+                return false;
+            }
+
+            instance.state = READY;
+            return true;
+        }
+
+        bool WarmPool::enter()
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            if (m_shutdown)
+            {
+                return false;
+            }
+            m_threads++;
+            return true;
+        }
+
+        void WarmPool::leave()
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_threads--;
+            m_idle.notify_all();
+        }
+
+        void WarmPool::shutdown()
+        {
+            std::unique_lock<std::mutex> lock(m_mutex);
+            m_shutdown = true;
+            m_idle.wait(lock, [this]() { return m_threads == 0; });
+        }
+
+        void WarmPool::resume()
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_shutdown = false;
+        }
+
+        bool WarmPool::take(const std::string& type, std::string& callsign)
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            if (m_counts.find(type) == m_counts.end())
+            {
+                return false;
+            }
+
+            for (auto it = m_instances.begin(); it != m_instances.end(); ++it)
+            {
+                if (it->second.type == type && it->second.state == READY)
+                {
+                    callsign = it->first;
+                    m_bound[callsign] = type;
+                    m_instances.erase(it);
+                    m_stats.hits++;
+                    return true;
+                }
+            }
+            m_stats.misses++;
+            return false;
+        }
+
+        std::vector<std::string> WarmPool::setLowMemory(bool low)
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_lowMemory = low;
+            if (!low)
+            {
+                return std::vector<std::string>();
+            }
+            return evictLocked(true);
+        }
+
+        bool WarmPool::lowMemory() const
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            return m_lowMemory;
+        }
+
+        void WarmPool::release(const std::string& callsign)
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_instances.erase(callsign);
+            m_bound.erase(callsign);
+        }
+
+        bool WarmPool::isPooled(const std::string& callsign) const
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            return m_instances.find(callsign) != m_instances.end();
+        }
+
+        std::vector<WarmPool::Instance> WarmPool::instances() const
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            std::vector<Instance> instances;
+            for (const auto& instance : m_instances)
+            {
+                instances.push_back(instance.second);
+            }
+            return instances;
+        }
+
+        WarmPool::Stats WarmPool::stats() const
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            return m_stats;
+        }
+
+        uint32_t WarmPool::readyOrStartingLocked(const std::string& type) const
+        {
+            uint32_t instances = 0;
+            for (const auto& instance : m_instances)
+            {
+                if (instance.second.type == type && instance.second.state != EVICTING)
+                {
+                    instances++;
+                }
+            }
+            return instances;
+        }
+
+        std::string WarmPool::callsignLocked(const std::string& type) const
+        {
+            // The lowest free one, so the clones Thunder keeps around get reused
+            for (uint32_t index = 0; ; index++)
+            {
+                std::string callsign = type + WARM_POOL_CALLSIGN_INFIX + std::to_string(index);
+                if (m_instances.find(callsign) == m_instances.end() && m_bound.find(callsign) == m_bound.end())
+                {
+                    return callsign;
+                }
+            }
+        }
+
+        std::vector<std::string> WarmPool::evictLocked(bool all)
+        {
+            std::map<std::string, uint32_t> kept;
+            std::vector<std::string> evicted;
+            for (auto& instance : m_instances)
+            {
+                if (instance.second.state != READY)
+                {
+                    continue;
+                }
+
+                auto count = m_counts.find(instance.second.type);
+                if (!all && count != m_counts.end() && kept[instance.second.type] < count->second)
+                {
+                    kept[instance.second.type]++;
+                    continue;
+                }
+                instance.second.state = EVICTING;
+                evicted.push_back(instance.first);
+                m_stats.evictions++;
+            }
+            return evicted;
+        }
+
+    } // namespace Plugin
+} // namespace WPEFramework
@@ -0,0 +1,145 @@
+/**
+* If not stated otherwise in this file or this component's LICENSE
+* file the following copyright and licenses apply:
+*
+* Copyright 2020 RDK Management
+*
+* Licensed under the Apache License, Version 2.0 (the "License");
+* you may not use this file except in compliance with the License.
+* You may obtain a copy of the License at
+*
+* http://www.apache.org/licenses/LICENSE-2.0
+*
+* Unless required by applicable law or agreed to in writing, software
+* distributed under the License is distributed on an "AS IS" BASIS,
+* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+* See the License for the specific language governing permissions and
+* limitations under the License.
+**/
+
+#pragma once
+
+#include <stdint.h>
+#include <condition_variable>
+#include <map>
+#include <mutex>
+#include <string>
+#include <vector>
+
+// Instances of a type are cloned as <type>_warm<n>
+#define WARM_POOL_CALLSIGN_INFIX "_warm"
+#define WARM_POOL_MAX_INSTANCES_PER_TYPE 4
+#define WARM_POOL_DEFAULT_MIN_FREE_KB (200 * 1024)
+
+namespace WPEFramework {
+
+    namespace Plugin {
+
+        /**
+        * @brief Which pre-cloned, activated and suspended app instances RDKShell keeps
+        * per type, and their state. Only the bookkeeping: RDKShell launches and destroys
+        * the instances, on a request thread, as the pool asks. All calls are serialized.
+        */
+        class WarmPool
+        {
+        public:
+            enum State
+            {
+                STARTING,       // being launched
+                READY,          // activated and suspended, waiting for a launch
+                EVICTING        // being destroyed
+            };
+
+            struct Instance
+            {
+                std::string callsign;
+                std::string type;
+                State state;
+            };
+
+            struct Stats
+            {
+                Stats() : hits(0), misses(0), evictions(0), failures(0) {}
+
+                uint32_t hits;          // launches served by an instance
+                uint32_t misses;        // launches of a pooled type without a ready instance
+                uint32_t evictions;
+                uint32_t failures;      // instances that failed to launch
+            };
+
+            WarmPool();
+
+            WarmPool(const WarmPool&) = delete;
+            WarmPool& operator=(const WarmPool&) = delete;
+
+            /**
+            * @brief Sets the instances to keep per type, types not given are not pooled anymore.
+            * @return the ready instances that are not wanted anymore, now evicting
+            */
+            std::vector<std::string> configure(const std::map<std::string, uint32_t>& counts, uint32_t minFreeKb);
+            std::map<std::string, uint32_t> counts() const;
+            uint32_t minFreeKb() const;
+
+            // Whether a fill should be started; false if one is running, nothing is missing or shut down
+            bool requestFill();
+            /**
+            * @brief The next instance to launch, now starting. Ends the fill when false.
+            * @param freeKb free memory now, no instance is started below the configured minimum
+            */
+            bool next(uint32_t freeKb, Instance& instance);
+            /**
+            * @brief The launch of an instance completed.
+            * @return false if the instance is not wanted anymore (low memory, or the policy
+            * changed meanwhile) and must be destroyed; it is then evicting
+            */
+            bool started(const std::string& callsign, bool success);
+
+            // A thread working on the instances, other than a fill, starts; false once shut down
+            bool enter();
+            // A fill, or a thread that entered, returns
+            void leave();
+            // Ends the fill and waits for the threads to leave, fills and enter fail until resumed
+            void shutdown();
+            void resume();
+
+            /**
+            * @brief Hands out a ready instance of the type for a launch. The instance is
+            * not part of the pool anymore but its callsign stays in use until released.
+            */
+            bool take(const std::string& type, std::string& callsign);
+
+            // Low memory stops filling and evicts all ready instances, returned as evicting
+            std::vector<std::string> setLowMemory(bool low);
+            bool lowMemory() const;
+
+            // The instance is destroyed, its callsign can be reused
+            void release(const std::string& callsign);
+
+            // Starting, ready or evicting, i.e. not launched by a client
+            bool isPooled(const std::string& callsign) const;
+            std::vector<Instance> instances() const;
+            Stats stats() const;
+
+        private:
+            uint32_t readyOrStartingLocked(const std::string& type) const;
+            std::string callsignLocked(const std::string& type) const;
+            std::vector<std::string> evictLocked(bool all);
+
+            mutable std::mutex m_mutex;
+            std::map<std::string, uint32_t> m_counts;
+            uint32_t m_minFreeKb;
+            bool m_lowMemory;
+            bool m_filling;
+            bool m_shutdown;
+            uint32_t m_threads;
+            std::condition_variable m_idle;
+            std::map<std::string, Instance> m_instances;
+            // Callsigns of instances handed out to a launch and not destroyed yet
+            std::map<std::string, std::string> m_bound;
+            // Types whose instance failed to launch in the current fill
+            std::map<std::string, bool> m_failed;
+            Stats m_stats;
+        };
+
+    } // namespace Plugin
+} // namespace WPEFramework
@@ -0,0 +1,120 @@
+/**
+* If not stated otherwise in this file or this component's LICENSE
+* file the following copyright and licenses apply:
+*
+* Copyright 2020 RDK Management
+*
+* Licensed under the Apache License, Version 2.0 (the "License");
+* you may not use this file except in compliance with the License.
+* You may obtain a copy of the License at
+*
+* http://www.apache.org/licenses/LICENSE-2.0
+*
+* Unless required by applicable law or agreed to in writing, software
+* distributed under the License is distributed on an "AS IS" BASIS,
+* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+* See the License for the specific language governing permissions and
+* limitations under the License.
+**/
+
+#include "Fixtures.h"
+
+#include <iostream>
+
+namespace RdkServicesTest {
+
+Fixtures* Fixtures::_instance = nullptr;
+
+Fixtures::Fixtures()
+        :_engine(WPEFramework::Core::ProxyType<WorkerPoolImplementation>::Create(2, WPEFramework::Core::Thread::DefaultStackSize(), 16)),
+         _persistentStore(WPEFramework::Core::ProxyType<WPEFramework::Plugin::PersistentStore>::Create()),
+         _securityAgent(WPEFramework::Core::ProxyType<WPEFramework::Plugin::SecurityAgent>::Create()),
+         _service(),
+         _token()
+{
+    WPEFramework::Core::IWorkerPool::Assign(&(*_engine));
+    _engine->Run();
+}
+
+Fixtures::~Fixtures()
+{
+    _securityAgent.Release();
+    _persistentStore.Release();
+    _service.Release();
+
+    WPEFramework::Core::IWorkerPool::Assign(nullptr);
+    _engine.Release();
+}
+
+bool Fixtures::SetUp()
+{
+    _instance = new Fixtures();
+    if (_instance->Initialize() == false) {
+        TearDown();
+        return (false);
+    }
+    return (true);
+}
+
+void Fixtures::TearDown()
+{
+    if (_instance != nullptr) {
+        _instance->Deinitialize();
+        delete _instance;
+        _instance = nullptr;
+    }
+}
+
+Fixtures& Fixtures::Instance()
+{
+    ASSERT(_instance != nullptr);
+    return (*_instance);
+}
+
+bool Fixtures::Initialize()
+{
+    // as PersistentStoreTest
+
+    if (_persistentStore->Initialize(nullptr) != string("")) {
+        std::cerr << "PersistentStore failed to initialize" << std::endl;
+        return (false);
+    }
+
+    // as SecurityAgentTest, run from the RdkServicesTest directory
+
+    WPEFramework::Core::File serverConf(string("thunder/install/etc/WPEFramework/config.json"), false);
+    WPEFramework::Core::File pluginConf(string("thunder/install/etc/WPEFramework/plugins/SecurityAgent.json"), false);
+    if ((serverConf.Open(true) == false) || (pluginConf.Open(true) == false)) {
+        std::cerr << "run from the RdkServicesTest directory, after Scripts/build.sh" << std::endl;
+        return (false);
+    }
+
+    WPEFramework::Core::OptionalType<WPEFramework::Core::JSON::Error> error;
+
+    Config server(serverConf, error);
+    WPEFramework::Plugin::Config plugin;
+    plugin.IElement::FromFile(pluginConf, error);
+    if (error.IsSet() == true) {
+        std::cerr << "failed to read the SecurityAgent configuration" << std::endl;
+        return (false);
+    }
+
+    _service = WPEFramework::Core::ProxyType<Service>::Create(server, plugin);
+    if (_securityAgent->Initialize(&(*_service)) != string("")) {
+        std::cerr << "SecurityAgent failed to initialize" << std::endl;
+        return (false);
+    }
+
+    string payload = "http://localhost";
+    return (_securityAgent->CreateToken(static_cast<uint16_t>(payload.length()), reinterpret_cast<const uint8_t*>(payload.c_str()), _token) == WPEFramework::Core::ERROR_NONE);
+}
+
+void Fixtures::Deinitialize()
+{
+    if (_service.IsValid() == true) {
+        _securityAgent->Deinitialize(&(*_service));
+    }
+    _persistentStore->Deinitialize(nullptr);
+}
+
+} // namespace RdkServicesTest
@@ -0,0 +1,74 @@
+/**
+* If not stated otherwise in this file or this component's LICENSE
+* file the following copyright and licenses apply:
+*
+* Copyright 2020 RDK Management
+*
+* Licensed under the Apache License, Version 2.0 (the "License");
+* you may not use this file except in compliance with the License.
+* You may obtain a copy of the License at
+*
+* http://www.apache.org/licenses/LICENSE-2.0
+*
+* Unless required by applicable law or agreed to in writing, software
+* distributed under the License is distributed on an "AS IS" BASIS,
+* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+* See the License for the specific language governing permissions and
+* limitations under the License.
+**/
+
+#pragma once
+
+#include "Module.h"
+
+#include "PersistentStore.h"
+#include "SecurityAgent.h"
+
+#include "Source/WorkerPoolImplementation.h"
+#include "Source/Config.h"
+#include "Source/Service.h"
+
+namespace RdkServicesTest {
+
+// The plugins under benchmark, initialized as in their tests, once for all threads of all benchmarks
+class Fixtures {
+public:
+    Fixtures(const Fixtures&) = delete;
+    Fixtures& operator=(const Fixtures&) = delete;
+
+    // Around the benchmark run, from main()
+    static bool SetUp();
+    static void TearDown();
+    static Fixtures& Instance();
+
+    WPEFramework::Core::JSONRPC::Handler& PersistentStore()
+    {
+        return (*_persistentStore);
+    }
+    WPEFramework::Plugin::SecurityAgent& SecurityAgent()
+    {
+        return (*_securityAgent);
+    }
+    // Created by the SecurityAgent for http://localhost
+    const string& Token() const
+    {
+        return (_token);
+    }
+
+private:
+    Fixtures();
+    ~Fixtures();
+
+    bool Initialize();
+    void Deinitialize();
+
+    WPEFramework::Core::ProxyType<WorkerPoolImplementation> _engine;
+    WPEFramework::Core::ProxyType<WPEFramework::Plugin::PersistentStore> _persistentStore;
+    WPEFramework::Core::ProxyType<WPEFramework::Plugin::SecurityAgent> _securityAgent;
+    WPEFramework::Core::ProxyType<Service> _service;
+    string _token;
+
+    static Fixtures* _instance;
+};
+
+} // namespace RdkServicesTest
@@ -0,0 +1,61 @@
+/**
+* If not stated otherwise in this file or this component's LICENSE
+* file the following copyright and licenses apply:
+*
+* Copyright 2020 RDK Management
+*
+* Licensed under the Apache License, Version 2.0 (the "License");
+* you may not use this file except in compliance with the License.
+* You may obtain a copy of the License at
+*
+* http://www.apache.org/licenses/LICENSE-2.0
+*
+* Unless required by applicable law or agreed to in writing, software
+* distributed under the License is distributed on an "AS IS" BASIS,
+* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+* See the License for the specific language governing permissions and
+* limitations under the License.
+**/
+
+#include <benchmark/benchmark.h>
+
+#include "iarmcallstats.h"
+
+#include <unistd.h>
+#include <string>
+
+namespace RdkServicesTest {
+
+namespace {
+
+using WPEFramework::Plugin::IARMCallStats;
+
+// A table of its own, standing in for IARM_CALL_STATS_PATH, mapped once for all threads
+IARMCallStats& Stats()
+{
+    static const std::string path = "/tmp/RdkServicesBenchmark.iarmcalls." + std::to_string(getpid());
+    static IARMCallStats stats(path);
+    static int unlinked = unlink(path.c_str());
+    (void) unlinked;
+    return stats;
+}
+
+// What IARM_BUS_CALL adds around IARM_Bus_Call, from a single site on 1 to 8 threads
+void IARMCallStatsCall(benchmark::State& state)
+{
+    static IARMCallStats::Site site;
+    IARMCallStats& stats = Stats();
+    IARMCallStats::Scope scope("Plugin_Network", "getIPSettings");
+
+    for (auto _ : state) {
+        IARMCallStats::Call call(stats, site, "NET_SRV_MGR", "getIPSettings");
+        benchmark::DoNotOptimize(call.end(true));
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+
+} // namespace
+
+BENCHMARK(IARMCallStatsCall)->ThreadRange(1, 8);
+
+} // namespace RdkServicesTest
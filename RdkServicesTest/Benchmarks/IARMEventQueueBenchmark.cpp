@@ -0,0 +1,119 @@
+/**
+* If not stated otherwise in this file or this component's LICENSE
+* file the following copyright and licenses apply:
+*
+* Copyright 2020 RDK Management
+*
+* Licensed under the Apache License, Version 2.0 (the "License");
+* you may not use this file except in compliance with the License.
+* You may obtain a copy of the License at
+*
+* http://www.apache.org/licenses/LICENSE-2.0
+*
+* Unless required by applicable law or agreed to in writing, software
+* distributed under the License is distributed on an "AS IS" BASIS,
+* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+* See the License for the specific language governing permissions and
+* limitations under the License.
+**/
+
+#include <benchmark/benchmark.h>
+
+#include "iarmeventqueue.h"
+
+#include <chrono>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+
+namespace RdkServicesTest {
+
+namespace {
+
+using WPEFramework::Plugin::IARMEventQueue;
+
+// As an IARM event payload
+struct Payload {
+    int32_t value;
+    char name[60];
+};
+
+// A subscriber taking range(0) us per event
+void Handle(const benchmark::State& state)
+{
+    if (state.range(0) != 0) {
+        std::this_thread::sleep_for(std::chrono::microseconds(state.range(0)));
+    }
+}
+
+// How long the IARM callback is held, handling the event in place as before
+void IARMEventInCallback(benchmark::State& state)
+{
+    Payload payload = {};
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(&payload);
+        Handle(state);
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+
+// How long the IARM callback is held, queueing the event for a worker as IARMEventDispatcher does
+void IARMEventQueued(benchmark::State& state)
+{
+    IARMEventQueue queue;
+    std::mutex mutex;
+    std::condition_variable cond;
+    int pending = 0;
+    bool exit = false;
+
+    std::thread worker([&]() {
+        std::unique_lock<std::mutex> lock(mutex);
+        while (!exit || pending > 0) {
+            cond.wait(lock, [&]() { return exit || pending > 0; });
+            if (pending > 0) {
+                pending--;
+                lock.unlock();
+                queue.drain([&](const char*, int32_t, void*, size_t) { Handle(state); });
+                lock.lock();
+            }
+        }
+    });
+
+    // Only the post is timed; events come no faster than they are handled, so none is dropped
+    Payload payload = {};
+    int32_t eventId = 0;
+    for (auto _ : state) {
+        while (queue.size() >= IARM_EVENT_QUEUE_MAX_EVENTS / 2) {
+            std::this_thread::yield();
+        }
+
+        uint64_t startNs = IARMEventQueue::nowNs();
+        if (queue.push("owner", eventId++, &payload, sizeof(payload))) {
+            {
+                std::lock_guard<std::mutex> lock(mutex);
+                pending++;
+            }
+            cond.notify_one();
+        }
+        state.SetIterationTime((IARMEventQueue::nowNs() - startNs) / 1e9);
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        exit = true;
+    }
+    cond.notify_one();
+    worker.join();
+
+    IARMEventQueue::Stats stats = queue.stats();
+    state.counters["dropped"] = stats.dropped;
+    state.counters["allocations"] = stats.allocations;
+    state.SetItemsProcessed(state.iterations());
+}
+
+} // namespace
+
+BENCHMARK(IARMEventInCallback)->Arg(0)->Arg(2000)->UseRealTime();
+BENCHMARK(IARMEventQueued)->Arg(0)->Arg(2000)->UseManualTime()->Iterations(2000);
+
+} // namespace RdkServicesTest
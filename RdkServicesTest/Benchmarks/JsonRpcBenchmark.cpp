@@ -0,0 +1,87 @@
+/**
+* If not stated otherwise in this file or this component's LICENSE
+* file the following copyright and licenses apply:
+*
+* Copyright 2020 RDK Management
+*
+* Licensed under the Apache License, Version 2.0 (the "License");
+* you may not use this file except in compliance with the License.
+* You may obtain a copy of the License at
+*
+* http://www.apache.org/licenses/LICENSE-2.0
+*
+* Unless required by applicable law or agreed to in writing, software
+* distributed under the License is distributed on an "AS IS" BASIS,
+* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+* See the License for the specific language governing permissions and
+* limitations under the License.
+**/
+
+#include <benchmark/benchmark.h>
+
+#include "Module.h"
+
+namespace RdkServicesTest {
+
+namespace {
+
+// A plugin with a single method, so that what is measured is the dispatch and the JSON
+class Echo : public WPEFramework::PluginHost::JSONRPC {
+public:
+    Echo(const Echo&) = delete;
+    Echo& operator=(const Echo&) = delete;
+
+    Echo()
+        : WPEFramework::PluginHost::JSONRPC()
+    {
+        Register<WPEFramework::Core::JSON::VariantContainer, WPEFramework::Core::JSON::VariantContainer>(_T("echo"), &Echo::echo, this);
+    }
+    ~Echo() override
+    {
+        Unregister(_T("echo"));
+    }
+
+private:
+    uint32_t echo(const WPEFramework::Core::JSON::VariantContainer& parameters, WPEFramework::Core::JSON::VariantContainer& response)
+    {
+        response = parameters;
+        return (WPEFramework::Core::ERROR_NONE);
+    }
+};
+
+// A request as received from a websocket: parsed, dispatched to the handler, answered
+void JsonRpcDispatch(benchmark::State& state)
+{
+    static Echo echo;
+    WPEFramework::Core::JSONRPC::Handler& handler = echo;
+    WPEFramework::Core::JSONRPC::Connection connection(1, 0);
+
+    const string request = _T("{\"jsonrpc\":\"2.0\",\"id\":") + std::to_string(state.thread_index())
+        + _T(",\"method\":\"Echo.1.echo\",\"params\":{\"data\":\"") + string(state.range(0), 'x') + _T("\"}}");
+
+    string result;
+    string reply;
+
+    for (auto _ : state) {
+        WPEFramework::Core::JSONRPC::Message message;
+        message.FromString(request);
+
+        WPEFramework::Core::JSONRPC::Message response;
+        response.JSONRPC = message.JSONRPC;
+        response.Id = message.Id;
+        if (handler.Invoke(connection, message.Method(), message.Parameters.Value(), result) != WPEFramework::Core::ERROR_NONE) {
+            state.SkipWithError("echo failed");
+            break;
+        }
+        response.Result = result;
+        response.ToString(reply);
+    }
+    state.SetItemsProcessed(state.iterations());
+    state.SetBytesProcessed(state.iterations() * (request.length() + reply.length()));
+}
+
+} // namespace
+
+BENCHMARK(JsonRpcDispatch)->RangeMultiplier(16)->Range(16, 4096)->ThreadRange(1, 8)->UseRealTime();
+
+} // namespace RdkServicesTest
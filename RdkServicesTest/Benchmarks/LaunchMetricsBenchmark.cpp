@@ -0,0 +1,91 @@
+/**
+* If not stated otherwise in this file or this component's LICENSE
+* file the following copyright and licenses apply:
+*
+* Copyright 2020 RDK Management
+*
+* Licensed under the Apache License, Version 2.0 (the "License");
+* you may not use this file except in compliance with the License.
+* You may obtain a copy of the License at
+*
+* http://www.apache.org/licenses/LICENSE-2.0
+*
+* Unless required by applicable law or agreed to in writing, software
+* distributed under the License is distributed on an "AS IS" BASIS,
+* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+* See the License for the specific language governing permissions and
+* limitations under the License.
+**/
+
+#include <benchmark/benchmark.h>
+
+#include "LaunchMetrics.h"
+
+#include <chrono>
+#include <thread>
+
+namespace RdkServicesTest {
+
+namespace {
+
+using namespace WPEFramework::Plugin;
+
+// Per phase of a cold launch, in ms; the render thread picks a request up on its next frame
+const int cloneMs = 30;
+const int configurationMs = 15;
+const int frameMs = 16;
+const int createDisplayMs = 25;
+const int activateMs = 40;
+
+void Sleep(int ms)
+{
+    std::this_thread::sleep_for(std::chrono::milliseconds(ms));
+}
+
+// As RDKShell::launchWrapper creates a new app, waiting for the display right away (0) or only before activating (1)
+void LaunchOverlap(benchmark::State& state)
+{
+    const bool overlapped = state.range(0) != 0;
+    LaunchMetrics metrics;
+
+    for (auto _ : state) {
+        LaunchTimeline timeline;
+        double createdMs = 0;
+        timeline.begin(LAUNCH_PHASE_DISPLAY);
+        std::thread renderThread([&createdMs]() {
+            Sleep(frameMs + createDisplayMs);
+            createdMs = LaunchTimeline::now();
+        });
+        if (!overlapped)
+            renderThread.join();
+
+        timeline.begin(LAUNCH_PHASE_CLONE);
+        Sleep(cloneMs);
+        timeline.end(LAUNCH_PHASE_CLONE);
+        timeline.begin(LAUNCH_PHASE_CONFIGURATION);
+        Sleep(configurationMs);
+        timeline.end(LAUNCH_PHASE_CONFIGURATION);
+
+        if (overlapped)
+            renderThread.join();
+        timeline.end(LAUNCH_PHASE_DISPLAY, createdMs);
+
+        timeline.begin(LAUNCH_PHASE_ACTIVATE);
+        Sleep(activateMs);
+        timeline.end(LAUNCH_PHASE_ACTIVATE);
+        metrics.record("app", "create", timeline);
+    }
+
+    LaunchMetricsReport report;
+    if (metrics.report("app", report)) {
+        state.counters["launchMs"] = report.total.meanMs;
+        state.counters["launchP95Ms"] = report.total.p95Ms;
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+
+} // namespace
+
+BENCHMARK(LaunchOverlap)->Arg(0)->Arg(1)->UseRealTime()->Unit(benchmark::kMillisecond);
+
+} // namespace RdkServicesTest
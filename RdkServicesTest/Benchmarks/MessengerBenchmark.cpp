@@ -0,0 +1,240 @@
+/**
+* If not stated otherwise in this file or this component's LICENSE
+* file the following copyright and licenses apply:
+*
+* Copyright 2020 RDK Management
+*
+* Licensed under the Apache License, Version 2.0 (the "License");
+* you may not use this file except in compliance with the License.
+* You may obtain a copy of the License at
+*
+* http://www.apache.org/licenses/LICENSE-2.0
+*
+* Unless required by applicable law or agreed to in writing, software
+* distributed under the License is distributed on an "AS IS" BASIS,
+* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+* See the License for the specific language governing permissions and
+* limitations under the License.
+**/
+
+
+#include <benchmark/benchmark.h>
+
+#include "Fixtures.h"
+
+#include "RoomMaintainer.h"
+#include "RoomImpl.h"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <thread>
+#include <vector>
+
+namespace RdkServicesTest {
+
+namespace {
+
+const uint32_t RoomMembers = 100;
+// Fixed, so the latencies of every message can be kept
+const uint32_t RoomMessages = 2000;
+
+uint64_t NowNs()
+{
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+double PercentileUs(std::vector<uint64_t>& latenciesNs, const double percent)
+{
+    if (latenciesNs.empty()) {
+        return (0);
+    }
+    size_t index = static_cast<size_t>(percent / 100 * (latenciesNs.size() - 1));
+    std::nth_element(latenciesNs.begin(), latenciesNs.begin() + index, latenciesNs.end());
+    return (latenciesNs[index] / 1000.0);
+}
+
+// A member's message sink, optionally taking some time per message as a busy client would
+class Member : public WPEFramework::Exchange::IRoomAdministrator::IRoom::IMsgNotification {
+public:
+    Member(const Member&) = delete;
+    Member& operator=(const Member&) = delete;
+
+    explicit Member(const uint32_t costUs)
+        : _costUs(costUs)
+        , _received(0)
+        , _last(0)
+        , _receivedNs(RoomMessages, 0)
+    {
+    }
+
+    // Messages are numbered from 1, a member gets them one at a time and in order
+    void Message(const string&, const string& text) override
+    {
+        uint32_t number = std::stoul(text);
+        if (number <= RoomMessages) {
+            _receivedNs[number - 1] = NowNs();
+        }
+        _last = number;
+        if (_costUs != 0) {
+            std::this_thread::sleep_for(std::chrono::microseconds(_costUs));
+        }
+        _received++;
+    }
+
+    uint32_t Received() const
+    {
+        return (_received);
+    }
+    uint32_t Last() const
+    {
+        return (_last);
+    }
+    // When each message arrived, 0 if it was dropped; valid up to Last()
+    const std::vector<uint64_t>& ReceivedNs() const
+    {
+        return (_receivedNs);
+    }
+
+    BEGIN_INTERFACE_MAP(Member)
+        INTERFACE_ENTRY(WPEFramework::Exchange::IRoomAdministrator::IRoom::IMsgNotification)
+    END_INTERFACE_MAP
+
+private:
+    const uint32_t _costUs;
+    std::atomic<uint32_t> _received;
+    std::atomic<uint32_t> _last;
+    std::vector<uint64_t> _receivedNs;
+};
+
+class Room {
+public:
+    Room(const Room&) = delete;
+    Room& operator=(const Room&) = delete;
+
+    // The first member is the slow one, if any
+    Room(const uint32_t members, const uint32_t slowCostUs)
+        : _admin(WPEFramework::Core::Service<WPEFramework::Plugin::RoomMaintainer>::Create<WPEFramework::Plugin::RoomMaintainer>())
+    {
+        for (uint32_t i = 0; i < members; i++) {
+            Member* member = WPEFramework::Core::Service<Member>::Create<Member>(i == 0 ? slowCostUs : 0);
+            _members.push_back(member);
+            _rooms.push_back(_admin->Join(_T("benchmark"), _T("user") + std::to_string(i), member));
+        }
+    }
+    ~Room()
+    {
+        for (auto room : _rooms) {
+            room->Release();
+        }
+        for (auto member : _members) {
+            member->Release();
+        }
+        _admin->Release();
+    }
+
+    WPEFramework::Exchange::IRoomAdministrator::IRoom& Sender()
+    {
+        return (*_rooms.back());
+    }
+    const std::vector<Member*>& Members() const
+    {
+        return (_members);
+    }
+
+    // Until every member but the slow one has the last message; a member that fell behind drops the oldest
+    void Drain(const uint32_t messages) const
+    {
+        for (uint32_t i = 1; i < _members.size(); i++) {
+            while (_members[i]->Last() < messages) {
+                std::this_thread::sleep_for(std::chrono::microseconds(100));
+            }
+        }
+    }
+
+    // From the send of each message to its arrival at every member but the slow one, once drained
+    void Report(benchmark::State& state, const std::vector<uint64_t>& sentNs) const
+    {
+        std::vector<uint64_t> latenciesNs;
+        uint32_t dropped = 0;
+        latenciesNs.reserve(sentNs.size() * (_members.size() - 1));
+        for (uint32_t i = 1; i < _members.size(); i++) {
+            const std::vector<uint64_t>& receivedNs = _members[i]->ReceivedNs();
+            for (uint32_t message = 0; message < sentNs.size(); message++) {
+                if (receivedNs[message] == 0) {
+                    dropped++;
+                } else {
+                    latenciesNs.push_back(receivedNs[message] - sentNs[message]);
+                }
+            }
+        }
+        state.counters["dropped"] = dropped;
+        state.counters["deliveryP50Us"] = PercentileUs(latenciesNs, 50);
+        state.counters["deliveryP99Us"] = PercentileUs(latenciesNs, 99);
+    }
+
+private:
+    WPEFramework::Plugin::RoomMaintainer* _admin;
+    std::vector<Member*> _members;
+    std::vector<WPEFramework::Exchange::IRoomAdministrator::IRoom*> _rooms;
+};
+
+// How long SendMessage holds up the sender in a room of 100, with all members
+// quick and with one member taking range(0) us per message
+void MessengerRoomSend(benchmark::State& state)
+{
+    Room room(RoomMembers, state.range(0));
+    std::vector<uint64_t> sentNs;
+    std::vector<uint64_t> sendNs;
+    sentNs.reserve(RoomMessages);
+    sendNs.reserve(RoomMessages);
+
+    for (auto _ : state) {
+        const string message(std::to_string(sentNs.size() + 1));
+        uint64_t start = NowNs();
+        sentNs.push_back(start);
+        room.Sender().SendMessage(message);
+        sendNs.push_back(NowNs() - start);
+    }
+
+    auto start = std::chrono::steady_clock::now();
+    room.Drain(sentNs.size());
+    state.counters["drainMs"] = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - start).count();
+    state.counters["slowReceived"] = room.Members()[0]->Received();
+    state.counters["sendP99Us"] = PercentileUs(sendNs, 99);
+    room.Report(state, sentNs);
+    state.SetItemsProcessed(state.iterations() * RoomMembers);
+}
+
+// What Send did before the member queues: every sink called in turn, under the room lock
+void MessengerRoomSendInline(benchmark::State& state)
+{
+    Room room(RoomMembers, state.range(0));
+    WPEFramework::Core::CriticalSection roomLock;
+    std::vector<uint64_t> sentNs;
+    std::vector<uint64_t> sendNs;
+    sentNs.reserve(RoomMessages);
+    sendNs.reserve(RoomMessages);
+
+    for (auto _ : state) {
+        const string message(std::to_string(sentNs.size() + 1));
+        uint64_t start = NowNs();
+        sentNs.push_back(start);
+        roomLock.Lock();
+        for (auto member : room.Members()) {
+            member->Message(_T("user99"), message);
+        }
+        roomLock.Unlock();
+        sendNs.push_back(NowNs() - start);
+    }
+    state.counters["sendP99Us"] = PercentileUs(sendNs, 99);
+    room.Report(state, sentNs);
+    state.SetItemsProcessed(state.iterations() * RoomMembers);
+}
+
+} // namespace
+
+BENCHMARK(MessengerRoomSend)->Arg(0)->Arg(1000)->Iterations(RoomMessages)->UseRealTime();
+BENCHMARK(MessengerRoomSendInline)->Arg(0)->Arg(1000)->Iterations(RoomMessages)->UseRealTime();
+
+} // namespace RdkServicesTest
@@ -0,0 +1,75 @@
+/**
+* If not stated otherwise in this file or this component's LICENSE
+* file the following copyright and licenses apply:
+*
+* Copyright 2020 RDK Management
+*
+* Licensed under the Apache License, Version 2.0 (the "License");
+* you may not use this file except in compliance with the License.
+* You may obtain a copy of the License at
+*
+* http://www.apache.org/licenses/LICENSE-2.0
+*
+* Unless required by applicable law or agreed to in writing, software
+* distributed under the License is distributed on an "AS IS" BASIS,
+* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+* See the License for the specific language governing permissions and
+* limitations under the License.
+**/
+
+#include <benchmark/benchmark.h>
+
+#include "Fixtures.h"
+
+namespace RdkServicesTest {
+
+namespace {
+
+// One key per thread, so that threads contend on the store and not on a single key
+string Key(const benchmark::State& state)
+{
+    return (_T("key") + std::to_string(state.thread_index()));
+}
+
+void PersistentStoreSetValue(benchmark::State& state)
+{
+    WPEFramework::Core::JSONRPC::Handler& handler = Fixtures::Instance().PersistentStore();
+    WPEFramework::Core::JSONRPC::Connection connection(1, 0);
+
+    const string parameters = _T("{\"namespace\":\"benchmark\",\"key\":\"") + Key(state) + _T("\",\"value\":\"1\"}");
+    string response;
+
+    for (auto _ : state) {
+        if (handler.Invoke(connection, _T("setValue"), parameters, response) != WPEFramework::Core::ERROR_NONE) {
+            state.SkipWithError("setValue failed");
+            break;
+        }
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+
+void PersistentStoreGetValue(benchmark::State& state)
+{
+    WPEFramework::Core::JSONRPC::Handler& handler = Fixtures::Instance().PersistentStore();
+    WPEFramework::Core::JSONRPC::Connection connection(1, 0);
+
+    string response;
+    handler.Invoke(connection, _T("setValue"), _T("{\"namespace\":\"benchmark\",\"key\":\"") + Key(state) + _T("\",\"value\":\"1\"}"), response);
+
+    const string parameters = _T("{\"namespace\":\"benchmark\",\"key\":\"") + Key(state) + _T("\"}");
+
+    for (auto _ : state) {
+        if (handler.Invoke(connection, _T("getValue"), parameters, response) != WPEFramework::Core::ERROR_NONE) {
+            state.SkipWithError("getValue failed");
+            break;
+        }
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+
+} // namespace
+
+BENCHMARK(PersistentStoreSetValue)->ThreadRange(1, 8)->UseRealTime();
+BENCHMARK(PersistentStoreGetValue)->ThreadRange(1, 8)->UseRealTime();
+
+} // namespace RdkServicesTest
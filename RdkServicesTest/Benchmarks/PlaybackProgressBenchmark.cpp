@@ -0,0 +1,67 @@
+/**
+* If not stated otherwise in this file or this component's LICENSE
+* file the following copyright and licenses apply:
+*
+* Copyright 2020 RDK Management
+*
+* Licensed under the Apache License, Version 2.0 (the "License");
+* you may not use this file except in compliance with the License.
+* You may obtain a copy of the License at
+*
+* http://www.apache.org/licenses/LICENSE-2.0
+*
+* Unless required by applicable law or agreed to in writing, software
+* distributed under the License is distributed on an "AS IS" BASIS,
+* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+* See the License for the specific language governing permissions and
+* limitations under the License.
+**/
+
+#include <benchmark/benchmark.h>
+
+#include "PlaybackProgress.h"
+
+namespace RdkServicesTest {
+
+namespace {
+
+// A progress tick as AampEventListener hands it to the stream, sending every tick
+// (progressEventInterval 0) and with the default interval; range(0) is the tick interval in ms
+void PlaybackProgressTick(benchmark::State& state, const uint32_t intervalMs)
+{
+    WPEFramework::Plugin::ProgressTracker tracker;
+    tracker.Create("benchmark");
+    tracker.Interval(intervalMs);
+
+    const uint32_t tickMs = state.range(0);
+    WPEFramework::Plugin::PlaybackProgress tick;
+    tick.durationMs = 600000;
+    tick.endMs = 600000;
+    tick.rate = 100;
+    std::string parameters;
+
+    for (auto _ : state) {
+        tick.positionMs += tickMs;
+        tick.updatedMs += tickMs;
+        benchmark::DoNotOptimize(tracker.Tick(tick, parameters));
+    }
+    state.counters["eventsPerMinute"] = (tracker.Sent() * 60000.0) / (static_cast<double>(tracker.Ticks()) * tickMs);
+    state.SetItemsProcessed(state.iterations());
+}
+
+void PlaybackProgressEveryTick(benchmark::State& state)
+{
+    PlaybackProgressTick(state, 0);
+}
+
+void PlaybackProgressCoalesced(benchmark::State& state)
+{
+    PlaybackProgressTick(state, PROGRESS_EVENT_INTERVAL_MS);
+}
+
+} // namespace
+
+BENCHMARK(PlaybackProgressEveryTick)->Arg(100)->Arg(250)->Arg(1000);
+BENCHMARK(PlaybackProgressCoalesced)->Arg(100)->Arg(250)->Arg(1000);
+
+} // namespace RdkServicesTest
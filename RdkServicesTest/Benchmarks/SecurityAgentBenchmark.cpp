@@ -0,0 +1,99 @@
+/**
+* If not stated otherwise in this file or this component's LICENSE
+* file the following copyright and licenses apply:
+*
+* Copyright 2020 RDK Management
+*
+* Licensed under the Apache License, Version 2.0 (the "License");
+* you may not use this file except in compliance with the License.
+* You may obtain a copy of the License at
+*
+* http://www.apache.org/licenses/LICENSE-2.0
+*
+* Unless required by applicable law or agreed to in writing, software
+* distributed under the License is distributed on an "AS IS" BASIS,
+* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+* See the License for the specific language governing permissions and
+* limitations under the License.
+**/
+
+#include <benchmark/benchmark.h>
+
+#include "Fixtures.h"
+
+#include "AccessControlList.h"
+
+namespace RdkServicesTest {
+
+namespace {
+
+void SecurityAgentValidate(benchmark::State& state)
+{
+    WPEFramework::Core::JSONRPC::Handler& handler = Fixtures::Instance().SecurityAgent();
+    WPEFramework::Core::JSONRPC::Connection connection(1, 0);
+
+    const string parameters = _T("{\"token\":\"") + Fixtures::Instance().Token() + _T("\"}");
+    string response;
+
+    for (auto _ : state) {
+        if (handler.Invoke(connection, _T("validate"), parameters, response) != WPEFramework::Core::ERROR_NONE) {
+            state.SkipWithError("validate failed");
+            break;
+        }
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+
+// What Thunder does for every JSON-RPC request carrying a token: decode it, then check the method
+void SecurityAgentOfficer(benchmark::State& state)
+{
+    WPEFramework::Plugin::SecurityAgent& securityAgent = Fixtures::Instance().SecurityAgent();
+    const string& token = Fixtures::Instance().Token();
+
+    WPEFramework::Core::JSONRPC::Message message;
+    message.Designator = _T("org.rdk.PersistentStore.1.getValue");
+
+    for (auto _ : state) {
+        WPEFramework::PluginHost::ISecurity* officer = securityAgent.Officer(token);
+        if (officer == nullptr) {
+            state.SkipWithError("invalid token");
+            break;
+        }
+        benchmark::DoNotOptimize(officer->Allowed(message));
+        officer->Release();
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+
+// The ACL check alone, a regular expression per url in the list until one matches the origin
+void AccessControlListAllowed(benchmark::State& state)
+{
+    WPEFramework::Plugin::AccessControlList acl;
+
+    WPEFramework::Core::File file(string(BENCHMARK_ACL_FILE), false);
+    if (file.Open(true) == false) {
+        state.SkipWithError("failed to open " BENCHMARK_ACL_FILE);
+        return;
+    }
+    // Incomplete as far as unreferenced roles go, which does not matter here
+    acl.Load(file);
+
+    // First in the example list, last before the catch-all, and the catch-all
+    static const char* urls[] = { "http://localhost", "https://metrological.com", "http://unlisted.example.com" };
+    const string url(urls[state.range(0)]);
+
+    for (auto _ : state) {
+        const WPEFramework::Plugin::AccessControlList::Filter* filter = acl.FilterMapFromURL(url);
+        benchmark::DoNotOptimize(filter != nullptr && filter->Allowed(_T("org.rdk.PersistentStore"), _T("getValue")));
+    }
+    state.SetItemsProcessed(state.iterations());
+    state.SetLabel(url);
+}
+
+} // namespace
+
+BENCHMARK(SecurityAgentValidate)->ThreadRange(1, 8)->UseRealTime();
+BENCHMARK(SecurityAgentOfficer)->ThreadRange(1, 8)->UseRealTime();
+BENCHMARK(AccessControlListAllowed)->DenseRange(0, 2)->ThreadRange(1, 8)->UseRealTime();
+
+} // namespace RdkServicesTest
@@ -0,0 +1,208 @@
+/**
+* If not stated otherwise in this file or this component's LICENSE
+* file the following copyright and licenses apply:
+*
+* Copyright 2020 RDK Management
+*
+* Licensed under the Apache License, Version 2.0 (the "License");
+* you may not use this file except in compliance with the License.
+* You may obtain a copy of the License at
+*
+* http://www.apache.org/licenses/LICENSE-2.0
+*
+* Unless required by applicable law or agreed to in writing, software
+* distributed under the License is distributed on an "AS IS" BASIS,
+* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+* See the License for the specific language governing permissions and
+* limitations under the License.
+**/
+
+#include <benchmark/benchmark.h>
+
+#include "BufferQueue.h"
+
+#include <algorithm>
+#include <cstring>
+#include <queue>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <semaphore.h>
+
+namespace RdkServicesTest {
+
+namespace {
+
+// As in AudioPlayer.cpp
+const int poolBufferSize = 24 * 1024;
+const int poolMaxFree = 64;
+const int maxBuffersPerCall = 64 - 16;
+
+const char alphabet[] = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+
+std::string Encode(const std::vector<uint8_t>& data)
+{
+    std::string out;
+    out.reserve((data.size() + 2) / 3 * 4);
+    for (size_t i = 0; i < data.size(); i += 3) {
+        uint32_t n = data[i] << 16;
+        if (i + 1 < data.size()) n |= data[i + 1] << 8;
+        if (i + 2 < data.size()) n |= data[i + 2];
+        out += alphabet[(n >> 18) & 63];
+        out += alphabet[(n >> 12) & 63];
+        out += (i + 1 < data.size()) ? alphabet[(n >> 6) & 63] : '=';
+        out += (i + 2 < data.size()) ? alphabet[n & 63] : '=';
+    }
+    return out;
+}
+
+// Stands in for b64_decode, which is not part of this tree
+size_t Decode(const uint8_t* in, size_t len, uint8_t* out)
+{
+    static int8_t table[256];
+    if (table['B'] == 0) {
+        std::fill(table, table + 256, -1);
+        for (int i = 0; i < 64; i++) {
+            table[static_cast<uint8_t>(alphabet[i])] = i;
+        }
+    }
+    size_t written = 0;
+    for (size_t i = 0; i + 3 < len; i += 4) {
+        uint32_t n = (table[in[i]] << 18) | (table[in[i + 1]] << 12);
+        out[written++] = n >> 16;
+        if (in[i + 2] == '=') break;
+        n |= table[in[i + 2]] << 6;
+        out[written++] = (n >> 8) & 0xff;
+        if (in[i + 3] == '=') break;
+        n |= table[in[i + 3]];
+        out[written++] = n & 0xff;
+    }
+    return written;
+}
+
+// The largest request PlayBuffer accepts
+std::string Request()
+{
+    std::vector<uint8_t> pcm(static_cast<size_t>(maxBuffersPerCall) * poolBufferSize);
+    for (size_t i = 0; i < pcm.size(); i++) {
+        pcm[i] = static_cast<uint8_t>(i * 7 + (i >> 9));
+    }
+    return Encode(pcm);
+}
+
+// What the playbuffer path did before the pool: the plugin decoded into its
+// own allocation, push_data copied that into a new Buffer, and the appsrc
+// thread copied each Buffer into a freshly allocated GstBuffer
+void PlayBufferCopying(benchmark::State& state)
+{
+    const std::string data = Request();
+    std::vector<char> sink;
+    for (auto _ : state) {
+        std::vector<uint8_t> decoded(data.size() / 4 * 3);
+        decoded.resize(Decode(reinterpret_cast<const uint8_t*>(data.data()), data.size(), decoded.data()));
+
+        char* buffer = new char[decoded.size()];
+        memcpy(buffer, decoded.data(), decoded.size());
+        for (size_t offset = 0; offset < decoded.size(); offset += poolBufferSize) {
+            size_t len = std::min(decoded.size() - offset, static_cast<size_t>(poolBufferSize));
+            std::vector<char> gstBuffer(buffer + offset, buffer + offset + len);
+            sink.swap(gstBuffer);
+        }
+        delete[] buffer;
+    }
+    state.SetBytesProcessed(state.iterations() * data.size());
+}
+
+// PlayBuffer now: decode straight into pooled buffers, and the appsrc thread
+// wraps them without copying before they go back to the pool
+void PlayBufferPooled(benchmark::State& state)
+{
+    const std::string data = Request();
+    BufferPool pool(poolBufferSize, poolMaxFree);
+    BufferQueue queue(1000);
+    for (auto _ : state) {
+        pool.decode(&queue, reinterpret_cast<const uint8_t*>(data.data()), data.size(), Decode);
+        while (!queue.isEmpty()) {
+            queue.remove()->release();
+        }
+    }
+    state.SetBytesProcessed(state.iterations() * data.size());
+}
+
+// BufferQueue before the ring: a std::queue behind a mutex, with a pair of
+// counting semaphores for blocking, so every add and remove is at least
+// two semaphore operations and a lock
+class LockedQueue {
+public:
+    explicit LockedQueue(int size)
+    {
+        pthread_mutex_init(&m_mutex, NULL);
+        sem_init(&m_sem_full, 0, 0);
+        sem_init(&m_sem_empty, 0, size);
+    }
+    ~LockedQueue()
+    {
+        pthread_mutex_destroy(&m_mutex);
+        sem_destroy(&m_sem_empty);
+        sem_destroy(&m_sem_full);
+    }
+    void add(Buffer* data)
+    {
+        sem_wait(&m_sem_empty);
+        pthread_mutex_lock(&m_mutex);
+        m_buffer.push(data);
+        sem_post(&m_sem_full);
+        pthread_mutex_unlock(&m_mutex);
+    }
+    Buffer* remove()
+    {
+        Buffer* item = NULL;
+        sem_wait(&m_sem_full);
+        pthread_mutex_lock(&m_mutex);
+        if (!m_buffer.empty()) {
+            item = m_buffer.front();
+            m_buffer.pop();
+            sem_post(&m_sem_empty);
+        }
+        pthread_mutex_unlock(&m_mutex);
+        return item;
+    }
+
+private:
+    std::queue<Buffer*> m_buffer;
+    pthread_mutex_t m_mutex;
+    sem_t m_sem_full;
+    sem_t m_sem_empty;
+};
+
+// One producer and one consumer, as PlayBuffer and the appsrc push thread, through range(0) slots
+template <typename Queue>
+void BufferQueuePump(benchmark::State& state)
+{
+    const int items = 10000;
+    Queue queue(state.range(0));
+    Buffer buffer(NULL, 16);
+    for (auto _ : state) {
+        std::thread consumer([&]() {
+            for (int i = 0; i < items; i++) {
+                benchmark::DoNotOptimize(queue.remove());
+            }
+        });
+        for (int i = 0; i < items; i++) {
+            queue.add(&buffer);
+        }
+        consumer.join();
+    }
+    state.SetItemsProcessed(state.iterations() * items);
+}
+
+} // namespace
+
+BENCHMARK(PlayBufferCopying)->Unit(benchmark::kMicrosecond);
+BENCHMARK(PlayBufferPooled)->Unit(benchmark::kMicrosecond);
+// The capacity AudioPlayer uses, and a small one that keeps both sides waiting
+BENCHMARK_TEMPLATE(BufferQueuePump, LockedQueue)->Arg(1000)->Arg(16)->UseRealTime();
+BENCHMARK_TEMPLATE(BufferQueuePump, BufferQueue)->Arg(1000)->Arg(16)->UseRealTime();
+
+} // namespace RdkServicesTest
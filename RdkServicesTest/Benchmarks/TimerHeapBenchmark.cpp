@@ -0,0 +1,108 @@
+/**
+* If not stated otherwise in this file or this component's LICENSE
+* file the following copyright and licenses apply:
+*
+* Copyright 2020 RDK Management
+*
+* Licensed under the Apache License, Version 2.0 (the "License");
+* you may not use this file except in compliance with the License.
+* You may obtain a copy of the License at
+*
+* http://www.apache.org/licenses/LICENSE-2.0
+*
+* Unless required by applicable law or agreed to in writing, software
+* distributed under the License is distributed on an "AS IS" BASIS,
+* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+* See the License for the specific language governing permissions and
+* limitations under the License.
+**/
+
+#include <benchmark/benchmark.h>
+
+#include "TimerHeap.h"
+
+#include <algorithm>
+#include <list>
+#include <random>
+#include <vector>
+
+namespace RdkServicesTest {
+
+namespace {
+
+using WPEFramework::Plugin::TimerHeap;
+
+TimerHeap::TimePoint At(uint32_t ms)
+{
+    return TimerHeap::TimePoint(std::chrono::milliseconds(ms));
+}
+
+// What the Timer plugin did before the heap: a list of running IDs, searched on
+// cancel and scanned for the nearest event after every change
+class TimerList {
+public:
+    int allocate()
+    {
+        return m_next++;
+    }
+    void push(int id, const TimerHeap::TimePoint& nextEvent)
+    {
+        if ((size_t)id >= m_events.size())
+            m_events.resize(id + 1);
+        m_events[id] = nextEvent;
+        m_running.push_back(id);
+        benchmark::DoNotOptimize(nearest());
+    }
+    bool remove(int id)
+    {
+        auto it = std::find(m_running.begin(), m_running.end(), id);
+        if (it == m_running.end())
+            return false;
+        m_running.erase(it);
+        benchmark::DoNotOptimize(nearest());
+        return true;
+    }
+    TimerHeap::TimePoint nearest() const
+    {
+        TimerHeap::TimePoint result = TimerHeap::TimePoint::max();
+        for (int id : m_running)
+            result = std::min(result, m_events[id]);
+        return result;
+    }
+
+private:
+    int m_next = 0;
+    std::list<int> m_running;
+    std::vector<TimerHeap::TimePoint> m_events;
+};
+
+// Starts range(0) timers at random times, then cancels them in random order
+template <typename Queue>
+void TimerStartCancel(benchmark::State& state)
+{
+    const uint32_t count = state.range(0);
+    Queue queue;
+    std::vector<int> ids;
+    for (uint32_t i = 0; i < count; i++)
+        ids.push_back(queue.allocate());
+
+    std::mt19937 random(42);
+    for (auto _ : state) {
+        for (uint32_t i = 0; i < count; i++)
+            queue.push(ids[i], At(random() % 86400000));
+        state.PauseTiming();
+        std::shuffle(ids.begin(), ids.end(), random);
+        state.ResumeTiming();
+        for (uint32_t i = 0; i < count; i++)
+            queue.remove(ids[i]);
+    }
+    state.SetItemsProcessed(state.iterations() * 2 * count);
+}
+
+} // namespace
+
+// The list is quadratic, it is only run with fewer timers
+BENCHMARK_TEMPLATE(TimerStartCancel, TimerList)->Arg(1000)->Arg(10000)->Unit(benchmark::kMicrosecond);
+BENCHMARK_TEMPLATE(TimerStartCancel, TimerHeap)->Arg(1000)->Arg(10000)->Arg(100000)->Unit(benchmark::kMicrosecond);
+
+} // namespace RdkServicesTest
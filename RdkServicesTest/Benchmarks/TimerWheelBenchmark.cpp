@@ -0,0 +1,118 @@
+/**
+* If not stated otherwise in this file or this component's LICENSE
+* file the following copyright and licenses apply:
+*
+* Copyright 2020 RDK Management
+*
+* Licensed under the Apache License, Version 2.0 (the "License");
+* you may not use this file except in compliance with the License.
+* You may obtain a copy of the License at
+*
+* http://www.apache.org/licenses/LICENSE-2.0
+*
+* Unless required by applicable law or agreed to in writing, software
+* distributed under the License is distributed on an "AS IS" BASIS,
+* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+* See the License for the specific language governing permissions and
+* limitations under the License.
+**/
+
+#include <benchmark/benchmark.h>
+
+#include "Module.h"
+
+#include "timerwheel.h"
+
+#include <fstream>
+#include <memory>
+#include <vector>
+
+namespace RdkServicesTest {
+
+namespace {
+
+const uint32_t TimerDelayMs = 60000;
+
+// Threads and resident kB of this process, from /proc/self/status
+void ProcessStatus(uint32_t& threads, uint32_t& rssKb)
+{
+    std::ifstream status("/proc/self/status");
+    string line;
+    while (std::getline(status, line)) {
+        if (line.compare(0, 8, "Threads:") == 0) {
+            threads = std::stoul(line.substr(8));
+        } else if (line.compare(0, 6, "VmRSS:") == 0) {
+            rssKb = std::stoul(line.substr(6));
+        }
+    }
+}
+
+// The job of a TpTimer before the wheel: a Core::TimerType, and its thread, per timer
+class TimerJob {
+public:
+    TimerJob() = default;
+    TimerJob(const TimerJob&) = default;
+    TimerJob& operator=(const TimerJob&) = delete;
+
+    bool operator==(const TimerJob& RHS) const
+    {
+        return (this == &RHS);
+    }
+    uint64_t Timed(const uint64_t)
+    {
+        return (0);
+    }
+};
+
+// Threads and memory added by range(0) armed timers, each with its own timer thread
+void TimerThreadPerTimer(benchmark::State& state)
+{
+    uint32_t threads = 0, rssKb = 0, beforeThreads = 0, beforeRssKb = 0;
+    TimerJob job;
+
+    for (auto _ : state) {
+        ProcessStatus(beforeThreads, beforeRssKb);
+        {
+            std::vector<std::unique_ptr<WPEFramework::Core::TimerType<TimerJob>>> timers;
+            for (int64_t i = 0; i < state.range(0); i++) {
+                timers.emplace_back(new WPEFramework::Core::TimerType<TimerJob>(64 * 1024, "ThunderPluginBaseTimer"));
+                timers.back()->Schedule(WPEFramework::Core::Time::Now().Add(TimerDelayMs), job);
+            }
+            ProcessStatus(threads, rssKb);
+        }
+    }
+    state.counters["threads"] = static_cast<int64_t>(threads) - beforeThreads;
+    state.counters["rssKb"] = static_cast<int64_t>(rssKb) - beforeRssKb;
+}
+
+// The same timers on the shared wheel
+void TimerWheelTimers(benchmark::State& state)
+{
+    uint32_t threads = 0, rssKb = 0, beforeThreads = 0, beforeRssKb = 0;
+
+    // The wheel thread is started by the first timer of the process, not measured
+    {
+        TimerWheel::Timer first([]() {});
+        TimerWheel::instance().schedule(first, TimerDelayMs);
+    }
+    for (auto _ : state) {
+        ProcessStatus(beforeThreads, beforeRssKb);
+        {
+            std::vector<std::unique_ptr<TimerWheel::Timer>> timers;
+            for (int64_t i = 0; i < state.range(0); i++) {
+                timers.emplace_back(new TimerWheel::Timer([]() {}));
+                TimerWheel::instance().schedule(*timers.back(), TimerDelayMs);
+            }
+            ProcessStatus(threads, rssKb);
+        }
+    }
+    state.counters["threads"] = static_cast<int64_t>(threads) - beforeThreads;
+    state.counters["rssKb"] = static_cast<int64_t>(rssKb) - beforeRssKb;
+}
+
+} // namespace
+
+BENCHMARK(TimerThreadPerTimer)->Arg(16)->Arg(64)->Iterations(10)->UseRealTime();
+BENCHMARK(TimerWheelTimers)->Arg(16)->Arg(64)->Iterations(10)->UseRealTime();
+
+} // namespace RdkServicesTest
@@ -0,0 +1,127 @@
+/**
+* If not stated otherwise in this file or this component's LICENSE
+* file the following copyright and licenses apply:
+*
+* Copyright 2020 RDK Management
+*
+* Licensed under the Apache License, Version 2.0 (the "License");
+* you may not use this file except in compliance with the License.
+* You may obtain a copy of the License at
+*
+* http://www.apache.org/licenses/LICENSE-2.0
+*
+* Unless required by applicable law or agreed to in writing, software
+* distributed under the License is distributed on an "AS IS" BASIS,
+* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+* See the License for the specific language governing permissions and
+* limitations under the License.
+**/
+
+#include <benchmark/benchmark.h>
+
+#include "UsbFileIndex.h"
+
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <ftw.h>
+#include <unistd.h>
+#include <dirent.h>
+
+#include <string>
+
+namespace RdkServicesTest {
+
+namespace {
+
+using WPEFramework::Plugin::UsbFileIndex;
+
+const char* kPattern = "[\\w-]*\\.{0,1}[\\w-]*\\.(png|jpg|jpeg|tiff|tif|bmp|mp4|mov|avi|mp3|wav|m4a|flac|mp4|aac|wma|txt|bin|enc|ts)";
+
+// A USB folder of range(0) files, every other one matching the pattern; removed with everything in it
+class UsbFolder {
+public:
+    UsbFolder(const UsbFolder&) = delete;
+    UsbFolder& operator=(const UsbFolder&) = delete;
+
+    explicit UsbFolder(const int files)
+    {
+        char path[] = "/tmp/UsbFileIndexBenchmarkXXXXXX";
+        _root = mkdtemp(path);
+        for (int i = 0; i < files; i++) {
+            std::string file = _root + "/file" + std::to_string(i) + ((i % 2) == 0 ? ".jpg" : ".dat");
+            int fd = ::open(file.c_str(), O_CREAT | O_WRONLY, 0644);
+            if (fd >= 0) {
+                ::close(fd);
+            }
+        }
+    }
+    ~UsbFolder()
+    {
+        nftw(_root.c_str(), [](const char* path, const struct stat*, int, struct FTW*) { return ::remove(path); }, 16, FTW_DEPTH | FTW_PHYS);
+    }
+
+    const std::string& Root() const
+    {
+        return _root;
+    }
+
+private:
+    std::string _root;
+};
+
+// The listing as it was made before, with the pattern compiled for every entry
+void UsbListingPerEntry(benchmark::State& state)
+{
+    UsbFolder folder(state.range(0));
+    for (auto _ : state) {
+        size_t matched = 0;
+        DIR* dirp = opendir(folder.Root().c_str());
+        struct dirent* dp;
+        while ((dirp != nullptr) && ((dp = readdir(dirp)) != nullptr)) {
+            if ((dp->d_type == DT_DIR) || std::regex_match(dp->d_name, std::regex(kPattern, std::regex_constants::icase))) {
+                matched++;
+            }
+        }
+        if (dirp != nullptr) {
+            closedir(dirp);
+        }
+        benchmark::DoNotOptimize(matched);
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+// UsbFileIndex reading the folder with the pattern compiled once
+void UsbListingPrecompiled(benchmark::State& state)
+{
+    UsbFolder folder(state.range(0));
+    UsbFileIndex index(kPattern, true);
+    UsbFileIndex::SnapshotPtr snapshot;
+    for (auto _ : state) {
+        index.invalidate();
+        index.list(folder.Root(), snapshot);
+    }
+    state.counters["files"] = snapshot ? snapshot->files.size() : 0;
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+// UsbFileIndex answering from its cache, the folder being unchanged
+void UsbListingCached(benchmark::State& state)
+{
+    UsbFolder folder(state.range(0));
+    UsbFileIndex index(kPattern, true);
+    UsbFileIndex::SnapshotPtr snapshot;
+    index.list(folder.Root(), snapshot);
+    for (auto _ : state) {
+        index.list(folder.Root(), snapshot);
+    }
+    state.counters["files"] = snapshot ? snapshot->files.size() : 0;
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+} // namespace
+
+BENCHMARK(UsbListingPerEntry)->Arg(20000)->Unit(benchmark::kMicrosecond);
+BENCHMARK(UsbListingPrecompiled)->Arg(20000)->Unit(benchmark::kMicrosecond);
+BENCHMARK(UsbListingCached)->Arg(20000)->Unit(benchmark::kMicrosecond);
+
+} // namespace RdkServicesTest
@@ -0,0 +1,14 @@
+#!/bin/sh
+
+set -e
+
+THUNDER_ROOT=$(pwd)/thunder
+THUNDER_INSTALL_DIR=${THUNDER_ROOT}/install
+
+PATH=${THUNDER_INSTALL_DIR}/usr/bin:${PATH} \
+LD_LIBRARY_PATH=${THUNDER_INSTALL_DIR}/usr/lib:${THUNDER_INSTALL_DIR}/usr/lib/wpeframework/plugins:${LD_LIBRARY_PATH} \
+RdkServicesBenchmark --benchmark_out=${BENCHMARK_OUT:-benchmark.json} --benchmark_out_format=json "$@"
+
+echo "==== DONE ===="
+
+exit 0
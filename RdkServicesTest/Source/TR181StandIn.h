@@ -0,0 +1,231 @@
+/**
+* If not stated otherwise in this file or this component's LICENSE
+* file the following copyright and licenses apply:
+*
+* Copyright 2020 RDK Management
+*
+* Licensed under the Apache License, Version 2.0 (the "License");
+* you may not use this file except in compliance with the License.
+* You may obtain a copy of the License at
+*
+* http://www.apache.org/licenses/LICENSE-2.0
+*
+* Unless required by applicable law or agreed to in writing, software
+* distributed under the License is distributed on an "AS IS" BASIS,
+* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+* See the License for the specific language governing permissions and
+* limitations under the License.
+**/
+
+#pragma once
+
+#include "Module.h"
+
+#include <sys/socket.h>
+#include <netinet/in.h>
+#include <arpa/inet.h>
+#include <unistd.h>
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <list>
+#include <mutex>
+#include <thread>
+
+namespace RdkServicesTest {
+
+// Minimal stand-in for the tr69hostif JSON interface: answers every POSTed
+// {"paramList":[{"name":..}]} with "value-of-<name>", over keep-alive connections.
+class TR181StandIn {
+public:
+    TR181StandIn(const TR181StandIn&) = delete;
+    TR181StandIn& operator=(const TR181StandIn&) = delete;
+
+    TR181StandIn()
+        : _socket(-1)
+        , _port(0)
+        , _stop(false)
+        , _delayMs(0)
+        , _held(false)
+        , _requests(0)
+        , _parameters(0)
+        , _connections(0)
+    {
+        _socket = ::socket(AF_INET, SOCK_STREAM, 0);
+
+        struct sockaddr_in address = {};
+        address.sin_family = AF_INET;
+        address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+        address.sin_port = 0;
+        socklen_t length = sizeof(address);
+
+        if ((_socket >= 0)
+            && (::bind(_socket, reinterpret_cast<struct sockaddr*>(&address), sizeof(address)) == 0)
+            && (::listen(_socket, 16) == 0)
+            && (::getsockname(_socket, reinterpret_cast<struct sockaddr*>(&address), &length) == 0)) {
+            _port = ntohs(address.sin_port);
+            _acceptor = std::thread(&TR181StandIn::Accept, this);
+        }
+    }
+    ~TR181StandIn()
+    {
+        Release();
+        _stop = true;
+        if (_socket >= 0) {
+            ::shutdown(_socket, SHUT_RDWR);
+            ::close(_socket);
+        }
+        if (_acceptor.joinable()) {
+            _acceptor.join();
+        }
+        for (auto& connection : _connectionThreads) {
+            connection.join();
+        }
+    }
+
+    string Url() const
+    {
+        return "http://127.0.0.1:" + std::to_string(_port) + "/";
+    }
+    void Delay(const uint32_t delayMs)
+    {
+        _delayMs = delayMs;
+    }
+    // Requests received from now on are counted, and answered once released
+    void Hold()
+    {
+        std::lock_guard<std::mutex> lock(_holdLock);
+        _held = true;
+    }
+    void Release()
+    {
+        std::lock_guard<std::mutex> lock(_holdLock);
+        _held = false;
+        _released.notify_all();
+    }
+    uint32_t Requests() const
+    {
+        return _requests;
+    }
+    uint32_t Parameters() const
+    {
+        return _parameters;
+    }
+    uint32_t Connections() const
+    {
+        return _connections;
+    }
+
+private:
+    void Accept()
+    {
+        while (!_stop) {
+            int connection = ::accept(_socket, nullptr, nullptr);
+            if (connection < 0) {
+                break;
+            }
+            _connections++;
+            _connectionThreads.emplace_back(&TR181StandIn::Serve, this, connection);
+        }
+    }
+
+    void Serve(int connection)
+    {
+        string buffer;
+        char chunk[1024];
+
+        while (!_stop) {
+            size_t headerEnd = buffer.find("\r\n\r\n");
+            if (headerEnd == string::npos) {
+                ssize_t received = ::recv(connection, chunk, sizeof(chunk), 0);
+                if (received <= 0) {
+                    break;
+                }
+                buffer.append(chunk, received);
+                continue;
+            }
+
+            size_t contentLength = 0;
+            size_t field = buffer.find("Content-Length:");
+            if ((field == string::npos) || (field > headerEnd)) {
+                field = buffer.find("content-length:");
+            }
+            if ((field != string::npos) && (field < headerEnd)) {
+                contentLength = std::stoul(buffer.substr(field + 15));
+            }
+
+            while (buffer.size() < headerEnd + 4 + contentLength) {
+                ssize_t received = ::recv(connection, chunk, sizeof(chunk), 0);
+                if (received <= 0) {
+                    ::close(connection);
+                    return;
+                }
+                buffer.append(chunk, received);
+            }
+
+            string body = buffer.substr(headerEnd + 4, contentLength);
+            buffer.erase(0, headerEnd + 4 + contentLength);
+
+            string response = Answer(body);
+            string reply = "HTTP/1.1 200 OK\r\nContent-Type: application/json\r\nConnection: keep-alive\r\nContent-Length: "
+                + std::to_string(response.size()) + "\r\n\r\n" + response;
+            if (::send(connection, reply.c_str(), reply.size(), MSG_NOSIGNAL) < 0) {
+                break;
+            }
+        }
+        ::close(connection);
+    }
+
+    string Answer(const string& body)
+    {
+        JsonObject request;
+        request.FromString(body);
+        JsonArray names = request["paramList"].Array();
+
+        _requests++;
+        _parameters += names.Length();
+        {
+            std::unique_lock<std::mutex> lock(_holdLock);
+            _released.wait(lock, [this]() { return !_held; });
+        }
+        if (_delayMs > 0) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(_delayMs));
+        }
+
+        JsonArray paramList;
+        for (int i = 0; i < names.Length(); i++) {
+            string name = names[i].Object()["name"].String();
+            // Unknown parameters are left out, the way tr69hostif does
+            if (name.find("Unknown") != string::npos) {
+                continue;
+            }
+            JsonObject param;
+            param["name"] = name;
+            param["value"] = "value-of-" + name;
+            paramList.Add(param);
+        }
+
+        JsonObject response;
+        response["paramList"] = paramList;
+        string result;
+        response.ToString(result);
+        return result;
+    }
+
+private:
+    int _socket;
+    uint16_t _port;
+    std::atomic<bool> _stop;
+    std::atomic<uint32_t> _delayMs;
+    std::mutex _holdLock;
+    std::condition_variable _released;
+    bool _held;
+    std::atomic<uint32_t> _requests;
+    std::atomic<uint32_t> _parameters;
+    std::atomic<uint32_t> _connections;
+    std::thread _acceptor;
+    std::list<std::thread> _connectionThreads;
+};
+
+} // namespace RdkServicesTest
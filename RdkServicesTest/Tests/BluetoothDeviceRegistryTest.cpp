@@ -0,0 +1,268 @@
+/**
+* If not stated otherwise in this file or this component's LICENSE
+* file the following copyright and licenses apply:
+*
+* Copyright 2020 RDK Management
+*
+* Licensed under the Apache License, Version 2.0 (the "License");
+* you may not use this file except in compliance with the License.
+* You may obtain a copy of the License at
+*
+* http://www.apache.org/licenses/LICENSE-2.0
+*
+* Unless required by applicable law or agreed to in writing, software
+* distributed under the License is distributed on an "AS IS" BASIS,
+* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+* See the License for the specific language governing permissions and
+* limitations under the License.
+**/
+
+#include "gtest/gtest.h"
+
+#include "BluetoothDeviceRegistry.h"
+
+#include <algorithm>
+#include <vector>
+
+namespace RdkServicesTest {
+
+using WPEFramework::Plugin::BluetoothDevice;
+using WPEFramework::Plugin::BluetoothDeviceRegistry;
+
+namespace {
+
+BluetoothDevice Device(uint64_t handle, bool discovered, bool paired, bool connected)
+{
+    BluetoothDevice device;
+    device.handle = handle;
+    device.name = "device" + std::to_string(handle);
+    device.deviceType = "HEADPHONES";
+    device.discovered = discovered;
+    device.paired = paired;
+    device.connected = connected;
+    return device;
+}
+
+std::vector<uint64_t> Handles(const BluetoothDeviceRegistry& registry, BluetoothDeviceRegistry::List list)
+{
+    std::vector<BluetoothDevice> devices;
+    registry.list(list, devices);
+    std::vector<uint64_t> handles;
+    for (auto& device : devices) {
+        handles.push_back(device.handle);
+    }
+    std::sort(handles.begin(), handles.end());
+    return handles;
+}
+
+// What BTRMGR knows, and what its list queries would return
+struct Btrmgr {
+    std::vector<BluetoothDevice> devices;
+    uint32_t queries = 0;
+
+    std::vector<BluetoothDevice> query(BluetoothDeviceRegistry::List list)
+    {
+        queries++;
+        std::vector<BluetoothDevice> result;
+        for (auto& device : devices) {
+            if ((list == BluetoothDeviceRegistry::LIST_DISCOVERED && device.discovered)
+                || (list == BluetoothDeviceRegistry::LIST_PAIRED && device.paired)
+                || (list == BluetoothDeviceRegistry::LIST_CONNECTED && device.connected)) {
+                result.push_back(device);
+            }
+        }
+        return result;
+    }
+
+    std::vector<uint64_t> handles(BluetoothDeviceRegistry::List list)
+    {
+        std::vector<uint64_t> handles;
+        for (auto& device : query(list)) {
+            handles.push_back(device.handle);
+        }
+        queries--;
+        std::sort(handles.begin(), handles.end());
+        return handles;
+    }
+};
+
+// As Bluetooth::syncDeviceList does before serving a list
+void Sync(BluetoothDeviceRegistry& registry, Btrmgr& btrmgr, BluetoothDeviceRegistry::List list, uint64_t nowMs)
+{
+    if (registry.isStale(list, nowMs)) {
+        registry.replace(list, btrmgr.query(list), nowMs);
+    }
+}
+
+} // namespace
+
+TEST(BluetoothDeviceRegistryTest, listsFollowEvents) {
+    BluetoothDeviceRegistry registry;
+    const auto discovered = BluetoothDeviceRegistry::LIST_DISCOVERED;
+    const auto paired = BluetoothDeviceRegistry::LIST_PAIRED;
+    const auto connected = BluetoothDeviceRegistry::LIST_CONNECTED;
+
+    EXPECT_TRUE(registry.isStale(paired, 0));
+    registry.replace(paired, { Device(1, false, true, true), Device(2, false, true, false) }, 0);
+    EXPECT_FALSE(registry.isStale(paired, 1000));
+    EXPECT_TRUE(registry.isStale(paired, BLUETOOTH_REGISTRY_MAX_AGE_MS));
+    EXPECT_EQ(std::vector<uint64_t>({ 1, 2 }), Handles(registry, paired));
+    // The paired list says which of them are connected
+    EXPECT_EQ(std::vector<uint64_t>({ 1 }), Handles(registry, connected));
+
+    // Discovery update
+    registry.update(Device(3, true, false, false), BluetoothDeviceRegistry::FIELD_DISCOVERED | BluetoothDeviceRegistry::FIELD_PAIRED);
+    EXPECT_EQ(std::vector<uint64_t>({ 3 }), Handles(registry, discovered));
+    // Pairing complete
+    registry.update(Device(3, false, true, false), BluetoothDeviceRegistry::FIELD_PAIRED | BluetoothDeviceRegistry::FIELD_CONNECTED);
+    EXPECT_EQ(std::vector<uint64_t>({ 1, 2, 3 }), Handles(registry, paired));
+    EXPECT_EQ(std::vector<uint64_t>({ 3 }), Handles(registry, discovered));
+    // Disconnect complete
+    registry.update(Device(1, false, true, false), BluetoothDeviceRegistry::FIELD_CONNECTED);
+    EXPECT_TRUE(Handles(registry, connected).empty());
+    // Lost before we knew of it
+    registry.update(Device(4, false, false, false), BluetoothDeviceRegistry::FIELD_DISCOVERED);
+    EXPECT_EQ(3u, registry.size());
+
+    // The connected list query carries the active state
+    BluetoothDevice active = Device(2, false, false, true);
+    active.activeState = 2;
+    registry.replace(connected, { active }, 0);
+    std::vector<BluetoothDevice> devices;
+    registry.list(connected, devices);
+    ASSERT_EQ(1u, devices.size());
+    EXPECT_EQ(2u, devices[0].activeState);
+    EXPECT_TRUE(devices[0].paired);
+
+    // Unpaired and not discovered, it is gone
+    registry.update(Device(2, false, false, false), BluetoothDeviceRegistry::FIELD_PAIRED | BluetoothDeviceRegistry::FIELD_CONNECTED);
+    EXPECT_EQ(2u, registry.size());
+
+    registry.invalidate(paired);
+    EXPECT_TRUE(registry.isStale(paired, 1000));
+    EXPECT_FALSE(registry.isStale(connected, 1000));
+}
+
+TEST(BluetoothDeviceRegistryTest, changesSinceSeq) {
+    BluetoothDeviceRegistry registry;
+    std::vector<BluetoothDevice> devices;
+    std::vector<uint64_t> removed;
+
+    registry.replace(BluetoothDeviceRegistry::LIST_DISCOVERED, { Device(1, true, false, false), Device(2, true, false, false) }, 0);
+    EXPECT_FALSE(registry.changes(0, devices, removed));
+    EXPECT_EQ(2u, devices.size());
+
+    uint64_t seq = registry.seq();
+    EXPECT_TRUE(registry.changes(seq, devices, removed));
+    EXPECT_TRUE(devices.empty());
+    EXPECT_TRUE(removed.empty());
+
+    // Renamed, lost and found
+    BluetoothDevice renamed = Device(1, true, false, false);
+    renamed.name = "Headphones";
+    registry.update(renamed, BluetoothDeviceRegistry::FIELD_DISCOVERED);
+    registry.update(Device(2, false, false, false), BluetoothDeviceRegistry::FIELD_DISCOVERED);
+    registry.update(Device(3, true, false, false), BluetoothDeviceRegistry::FIELD_DISCOVERED);
+    // Nothing new
+    registry.update(Device(3, true, false, false), BluetoothDeviceRegistry::FIELD_DISCOVERED);
+
+    EXPECT_TRUE(registry.changes(seq, devices, removed));
+    ASSERT_EQ(2u, devices.size());
+    EXPECT_EQ("Headphones", devices[0].name);
+    EXPECT_EQ(3u, devices[1].handle);
+    EXPECT_EQ(std::vector<uint64_t>({ 2 }), removed);
+
+    // Found again, it is not removed any more
+    seq = registry.seq();
+    registry.update(Device(2, true, false, false), BluetoothDeviceRegistry::FIELD_DISCOVERED);
+    EXPECT_TRUE(registry.changes(seq - 1, devices, removed));
+    EXPECT_TRUE(removed.empty());
+
+    // A rescan that finds none of them
+    seq = registry.seq();
+    registry.replace(BluetoothDeviceRegistry::LIST_DISCOVERED, {}, 1000);
+    EXPECT_TRUE(registry.changes(seq, devices, removed));
+    EXPECT_TRUE(devices.empty());
+    EXPECT_EQ(3u, removed.size());
+
+    // Too many removals since, or a sequence number from before a restart
+    for (uint64_t handle = 100; handle < 100 + BLUETOOTH_REGISTRY_MAX_REMOVED; handle++) {
+        registry.update(Device(handle, true, false, false), BluetoothDeviceRegistry::FIELD_DISCOVERED);
+        registry.update(Device(handle, false, false, false), BluetoothDeviceRegistry::FIELD_DISCOVERED);
+    }
+    EXPECT_FALSE(registry.changes(seq, devices, removed));
+    EXPECT_TRUE(removed.empty());
+    EXPECT_FALSE(registry.changes(registry.seq() + 1, devices, removed));
+}
+
+TEST(BluetoothDeviceRegistryTest, scanBenchmark) {
+    const auto discovered = BluetoothDeviceRegistry::LIST_DISCOVERED;
+    const auto paired = BluetoothDeviceRegistry::LIST_PAIRED;
+    const auto connected = BluetoothDeviceRegistry::LIST_CONNECTED;
+
+    Btrmgr btrmgr;
+    btrmgr.devices.push_back(Device(1, false, true, true));
+    btrmgr.devices.push_back(Device(2, false, true, false));
+
+    BluetoothDeviceRegistry registry;
+    uint32_t pollQueries = 0;
+    uint32_t mismatches = 0;
+    bool eventDropped = false;
+
+    // A 60 s scan: a device shows up every 2 s and one in four of them is lost again, while
+    // the settings page polls the discovered devices every 500 ms and the paired and connected ones every 2 s
+    for (uint64_t nowMs = 0; nowMs < 60000; nowMs += 100) {
+        if (nowMs % 2000 == 1000) {
+            uint64_t handle = 10 + nowMs / 2000;
+            btrmgr.devices.push_back(Device(handle, true, false, false));
+            // BTRMGR_EVENT_DEVICE_DISCOVERY_UPDATE, one of them never arrives
+            if (handle == 20) {
+                eventDropped = true;
+            } else {
+                registry.update(btrmgr.devices.back(), BluetoothDeviceRegistry::FIELD_DISCOVERED | BluetoothDeviceRegistry::FIELD_PAIRED);
+            }
+            if (handle % 4 == 0) {
+                btrmgr.devices[btrmgr.devices.size() - 2].discovered = false;
+                registry.update(btrmgr.devices[btrmgr.devices.size() - 2], BluetoothDeviceRegistry::FIELD_DISCOVERED | BluetoothDeviceRegistry::FIELD_PAIRED);
+            }
+        }
+
+        const bool pollDiscovered = (nowMs % 500 == 0);
+        const bool pollOthers = (nowMs % 2000 == 0);
+        if (pollDiscovered) {
+            pollQueries++;
+            uint32_t syncs = registry.syncs();
+            Sync(registry, btrmgr, discovered, nowMs);
+            if (registry.syncs() != syncs) {
+                eventDropped = false;
+            }
+            if (!eventDropped && Handles(registry, discovered) != btrmgr.handles(discovered)) {
+                mismatches++;
+            }
+        }
+        if (pollOthers) {
+            pollQueries += 2;
+            Sync(registry, btrmgr, paired, nowMs);
+            Sync(registry, btrmgr, connected, nowMs);
+            if (Handles(registry, paired) != btrmgr.handles(paired) || Handles(registry, connected) != btrmgr.handles(connected)) {
+                mismatches++;
+            }
+        }
+    }
+
+    // The dropped event was picked up by the resync after BLUETOOTH_REGISTRY_MAX_AGE_MS
+    EXPECT_FALSE(eventDropped);
+    EXPECT_EQ(btrmgr.handles(discovered), Handles(registry, discovered));
+    EXPECT_EQ(0u, mismatches);
+
+    printf("Bluetooth 60 s scan: %u BTRMGR list queries answering every call, %u with the registry\n", pollQueries, btrmgr.queries);
+    RecordProperty("queriesPolling", static_cast<int>(pollQueries));
+    RecordProperty("queriesRegistry", static_cast<int>(btrmgr.queries));
+
+    EXPECT_EQ(180u, pollQueries);
+    // Seeding the three lists, then once every BLUETOOTH_REGISTRY_MAX_AGE_MS
+    EXPECT_LE(btrmgr.queries, 3u * (60000 / BLUETOOTH_REGISTRY_MAX_AGE_MS + 1));
+    EXPECT_EQ(btrmgr.queries, registry.syncs());
+}
+
+} // namespace RdkServicesTest
@@ -0,0 +1,290 @@
+/**
+* If not stated otherwise in this file or this component's LICENSE
+* file the following copyright and licenses apply:
+*
+* Copyright 2020 RDK Management
+*
+* Licensed under the Apache License, Version 2.0 (the "License");
+* you may not use this file except in compliance with the License.
+* You may obtain a copy of the License at
+*
+* http://www.apache.org/licenses/LICENSE-2.0
+*
+* Unless required by applicable law or agreed to in writing, software
+* distributed under the License is distributed on an "AS IS" BASIS,
+* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+* See the License for the specific language governing permissions and
+* limitations under the License.
+**/
+
+#include "gtest/gtest.h"
+
+#include "cecrouter.h"
+
+#include <dirent.h>
+
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace RdkServicesTest {
+
+using WPEFramework::Plugin::CECRouter;
+
+namespace {
+
+// TV to a playback device
+const uint8_t giveOsdName[] = { 0x04, 0x46 };
+const uint8_t setOsdName[] = { 0x40, 0x47, 'S', 'T', 'B' };
+const uint8_t reportPowerStatus[] = { 0x04, 0x90, 0x00 };
+const uint8_t poll[] = { 0x44 };
+
+size_t Threads()
+{
+    size_t threads = 0;
+    DIR* tasks = opendir("/proc/self/task");
+    if (tasks != nullptr) {
+        struct dirent* entry;
+        while ((entry = readdir(tasks)) != nullptr) {
+            if (entry->d_name[0] != '.') {
+                threads++;
+            }
+        }
+        closedir(tasks);
+    }
+    return threads;
+}
+
+// The frames as they went on the bus
+class Bus {
+public:
+    explicit Bus(CECRouter::SendResult result = CECRouter::SEND_OK)
+        : m_result(result)
+    {
+    }
+
+    CECRouter::Transport transport()
+    {
+        return [this](const uint8_t* data, size_t len) {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_frames.push_back(std::vector<uint8_t>(data, data + len));
+            m_times.push_back(std::chrono::steady_clock::now());
+            return m_result;
+        };
+    }
+    std::vector<std::vector<uint8_t>> frames()
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        return m_frames;
+    }
+    std::vector<std::chrono::steady_clock::time_point> times()
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        return m_times;
+    }
+
+private:
+    CECRouter::SendResult m_result;
+    std::mutex m_mutex;
+    std::vector<std::vector<uint8_t>> m_frames;
+    std::vector<std::chrono::steady_clock::time_point> m_times;
+};
+
+} // namespace
+
+TEST(CECRouterTest, routesByOpcode)
+{
+    CECRouter router;
+    std::vector<std::string> calls;
+
+    router.subscribe(0x46, [&](const CECRouter::Frame& frame) {
+        EXPECT_EQ(0, frame.initiator);
+        EXPECT_EQ(4, frame.destination);
+        EXPECT_EQ(0x46, frame.opcode);
+        EXPECT_EQ(giveOsdName, frame.data);
+        EXPECT_EQ(sizeof(giveOsdName), frame.len);
+        calls.push_back("giveOsdName");
+    });
+    router.subscribe(0x90, [&](const CECRouter::Frame&) { calls.push_back("reportPowerStatus"); });
+    router.subscribe(CEC_ROUTER_ALL_OPCODES, [&](const CECRouter::Frame& frame) { calls.push_back("all " + std::to_string(frame.opcode)); });
+    router.subscribe(CEC_ROUTER_POLL, [&](const CECRouter::Frame& frame) {
+        EXPECT_EQ(4, frame.initiator);
+        EXPECT_EQ(4, frame.destination);
+        calls.push_back("poll");
+    });
+    EXPECT_EQ(4u, router.subscriptions());
+    EXPECT_EQ(0u, router.subscribe(CEC_ROUTER_POLL + 1, [](const CECRouter::Frame&) {}));
+
+    EXPECT_EQ(2u, router.route(giveOsdName, sizeof(giveOsdName)));
+    EXPECT_EQ(1u, router.route(setOsdName, sizeof(setOsdName)));
+    EXPECT_EQ(1u, router.route(poll, sizeof(poll)));
+    EXPECT_EQ(0u, router.route(nullptr, 0));
+
+    std::vector<std::string> expected = { "giveOsdName", "all 70", "all 71", "poll" };
+    EXPECT_EQ(expected, calls);
+
+    CECRouter::Stats stats = router.stats();
+    EXPECT_EQ(3u, stats.received);
+    EXPECT_EQ(4u, stats.delivered);
+    EXPECT_EQ(0u, stats.unhandled);
+}
+
+TEST(CECRouterTest, unsubscribes)
+{
+    CECRouter router;
+    int first = 0;
+    int second = 0;
+    uint32_t subscription = 0;
+
+    subscription = router.subscribe(0x46, [&](const CECRouter::Frame&) {
+        // From its own handler, as when a plugin is disabled on a frame
+        first++;
+        router.unsubscribe(subscription);
+    });
+    router.subscribe(0x46, [&](const CECRouter::Frame&) { second++; });
+
+    router.route(giveOsdName, sizeof(giveOsdName));
+    router.route(giveOsdName, sizeof(giveOsdName));
+    EXPECT_EQ(1, first);
+    EXPECT_EQ(2, second);
+    EXPECT_EQ(1u, router.subscriptions());
+
+    // From another thread, it waits for the frame being routed
+    std::atomic<bool> inHandler(false);
+    std::atomic<bool> handled(false);
+    uint32_t slow = router.subscribe(0x90, [&](const CECRouter::Frame&) {
+        inHandler = true;
+        std::this_thread::sleep_for(std::chrono::milliseconds(50));
+        handled = true;
+    });
+    std::thread connection([&]() { router.route(reportPowerStatus, sizeof(reportPowerStatus)); });
+    while (!inHandler) {
+        std::this_thread::yield();
+    }
+    router.unsubscribe(slow);
+    EXPECT_TRUE(handled);
+    connection.join();
+
+    EXPECT_EQ(0u, router.route(reportPowerStatus, sizeof(reportPowerStatus)));
+    EXPECT_EQ(1u, router.stats().unhandled);
+}
+
+TEST(CECRouterTest, sendsInOrderAndPaced)
+{
+    Bus bus;
+    CECRouter router(10);
+
+    EXPECT_FALSE(router.send(giveOsdName, sizeof(giveOsdName)));
+
+    router.start(bus.transport());
+    EXPECT_TRUE(router.send(giveOsdName, sizeof(giveOsdName)));
+    EXPECT_TRUE(router.send(setOsdName, sizeof(setOsdName)));
+    EXPECT_EQ(CECRouter::SEND_OK, router.sendAndWait(poll, sizeof(poll)));
+    router.stop();
+
+    std::vector<std::vector<uint8_t>> frames = bus.frames();
+    ASSERT_EQ(3u, frames.size());
+    EXPECT_EQ(std::vector<uint8_t>(giveOsdName, giveOsdName + sizeof(giveOsdName)), frames[0]);
+    EXPECT_EQ(std::vector<uint8_t>(setOsdName, setOsdName + sizeof(setOsdName)), frames[1]);
+    EXPECT_EQ(std::vector<uint8_t>(poll, poll + sizeof(poll)), frames[2]);
+
+    std::vector<std::chrono::steady_clock::time_point> times = bus.times();
+    for (size_t i = 1; i < times.size(); i++) {
+        EXPECT_GE(times[i] - times[i - 1], std::chrono::milliseconds(10));
+    }
+    EXPECT_EQ(3u, router.stats().sent);
+}
+
+TEST(CECRouterTest, reportsSendResults)
+{
+    Bus bus(CECRouter::SEND_NO_ACK);
+    CECRouter router(0);
+
+    router.start(bus.transport());
+    EXPECT_EQ(CECRouter::SEND_NO_ACK, router.sendAndWait(poll, sizeof(poll)));
+    router.stop();
+    EXPECT_EQ(CECRouter::SEND_DROPPED, router.sendAndWait(poll, sizeof(poll)));
+
+    CECRouter::Stats stats = router.stats();
+    EXPECT_EQ(1u, stats.notAcked);
+    EXPECT_EQ(1u, stats.dropped);
+}
+
+TEST(CECRouterTest, dropsWhenFullAndOnStop)
+{
+    Bus bus;
+    CECRouter router(1000, 2);
+
+    router.start(bus.transport());
+    // The first goes on the bus right away, the next wait for the interval
+    EXPECT_TRUE(router.send(giveOsdName, sizeof(giveOsdName)));
+    while (bus.frames().empty()) {
+        std::this_thread::yield();
+    }
+    EXPECT_TRUE(router.send(giveOsdName, sizeof(giveOsdName)));
+    EXPECT_TRUE(router.send(giveOsdName, sizeof(giveOsdName)));
+    EXPECT_FALSE(router.send(giveOsdName, sizeof(giveOsdName)));
+    router.stop();
+
+    CECRouter::Stats stats = router.stats();
+    EXPECT_EQ(1u, stats.sent);
+    EXPECT_EQ(3u, stats.dropped);
+    EXPECT_EQ(2u, stats.maxQueued);
+}
+
+TEST(CECRouterTest, oneThreadForAllPlugins)
+{
+    const int plugins = 4;
+    Bus bus;
+    CECRouter router(0);
+
+    size_t before = Threads();
+    router.start(bus.transport());
+    for (int plugin = 0; plugin < plugins; plugin++) {
+        router.subscribe(CEC_ROUTER_ALL_OPCODES, [](const CECRouter::Frame&) {});
+    }
+    size_t running = Threads();
+    router.stop();
+
+    printf("CEC router threads for %d plugins: %zu\n", plugins, running - before);
+    RecordProperty("threads", static_cast<int>(running - before));
+    EXPECT_EQ(1u, running - before);
+    EXPECT_EQ(before, Threads());
+}
+
+TEST(CECRouterTest, routesToEverySubscriber)
+{
+    // Four plugins, two of them processing a few opcodes; the rate is measured by RdkServicesBenchmark
+    const int plugins = 4;
+    const int frames = 20000;
+    const uint8_t* traffic[] = { giveOsdName, setOsdName, reportPowerStatus, poll };
+    const size_t lengths[] = { sizeof(giveOsdName), sizeof(setOsdName), sizeof(reportPowerStatus), sizeof(poll) };
+
+    CECRouter router;
+    std::atomic<uint64_t> handled(0);
+    for (int plugin = 0; plugin < plugins; plugin++) {
+        router.subscribe(CEC_ROUTER_ALL_OPCODES, [&](const CECRouter::Frame& frame) { handled += frame.len; });
+        if (plugin % 2 == 0) {
+            router.subscribe(0x47, [&](const CECRouter::Frame& frame) { handled += frame.len; });
+            router.subscribe(0x90, [&](const CECRouter::Frame& frame) { handled += frame.len; });
+        }
+    }
+
+    for (int i = 0; i < frames; i++) {
+        router.route(traffic[i % 4], lengths[i % 4]);
+    }
+
+    // Every frame but polls to the four plugins, <Set OSD Name> and <Report Power Status> to two more subscribers
+    CECRouter::Stats stats = router.stats();
+    EXPECT_EQ(static_cast<uint64_t>(frames), stats.received);
+    EXPECT_EQ(static_cast<uint64_t>(frames / 4) * (3 * plugins + 2 * 2), stats.delivered);
+    EXPECT_EQ(static_cast<uint64_t>(frames / 4), stats.unhandled);
+    uint64_t bytesPerRound = (sizeof(giveOsdName) + sizeof(setOsdName) + sizeof(reportPowerStatus)) * plugins
+        + (sizeof(setOsdName) + sizeof(reportPowerStatus)) * 2;
+    EXPECT_EQ((frames / 4) * bytesPerRound, handled.load());
+}
+
+} // namespace RdkServicesTest
@@ -0,0 +1,200 @@
+/**
+* If not stated otherwise in this file or this component's LICENSE
+* file the following copyright and licenses apply:
+*
+* Copyright 2020 RDK Management
+*
+* Licensed under the Apache License, Version 2.0 (the "License");
+* you may not use this file except in compliance with the License.
+* You may obtain a copy of the License at
+*
+* http://www.apache.org/licenses/LICENSE-2.0
+*
+* Unless required by applicable law or agreed to in writing, software
+* distributed under the License is distributed on an "AS IS" BASIS,
+* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+* See the License for the specific language governing permissions and
+* limitations under the License.
+**/
+
+#include "gtest/gtest.h"
+
+#include "FrameTiming.h"
+
+#include <malloc.h>
+
+#include <algorithm>
+#include <chrono>
+#include <vector>
+
+namespace RdkServicesTest {
+
+using WPEFramework::Plugin::FrameTiming;
+using WPEFramework::Plugin::FrameTimingHistogram;
+using WPEFramework::Plugin::FrameTimingReport;
+
+namespace {
+
+size_t HeapInUse()
+{
+#if __GLIBC_PREREQ(2, 33)
+    return mallinfo2().uordblks;
+#else
+    return mallinfo().uordblks;
+#endif
+}
+
+// 60 Hz with a 3 frame hitch every second and a 100 ms stall every 10 seconds
+uint32_t FrameInterval(uint32_t frame)
+{
+    if ((frame % 600) == 599) {
+        return 100000;
+    }
+    if ((frame % 60) >= 57) {
+        return 50000;
+    }
+    return 16000 + (frame * 7919) % 1400;
+}
+
+uint32_t ExactPercentile(std::vector<uint32_t> intervals, double percent)
+{
+    std::sort(intervals.begin(), intervals.end());
+    size_t rank = static_cast<size_t>(percent * intervals.size() / 100.0 + 0.5);
+    return intervals[std::max<size_t>(rank, 1) - 1];
+}
+
+} // namespace
+
+TEST(FrameTimingTest, bucketsCoverEveryValue) {
+    uint32_t previous = 0;
+    for (uint32_t value = 0; value < (1u << 20); value++) {
+        uint32_t bucket = FrameTimingHistogram::bucketOf(value);
+        ASSERT_LT(bucket, static_cast<uint32_t>(FRAME_TIMING_BUCKETS));
+        ASSERT_GE(bucket, previous);
+        ASSERT_LE(FrameTimingHistogram::lowestOf(bucket), value);
+        ASSERT_GE(FrameTimingHistogram::highestOf(bucket), value);
+        // Each bucket is within 1/8 of its lowest value
+        ASSERT_LE(FrameTimingHistogram::highestOf(bucket) - FrameTimingHistogram::lowestOf(bucket), std::max(value / 8, 1u));
+        previous = bucket;
+    }
+    EXPECT_EQ(static_cast<uint32_t>(FRAME_TIMING_BUCKETS - 1), FrameTimingHistogram::bucketOf(UINT32_MAX));
+}
+
+TEST(FrameTimingTest, percentilesAndLongFrames) {
+    FrameTiming timing;
+    timing.setVsyncInterval(16667);
+
+    std::vector<uint32_t> intervals;
+    for (uint32_t frame = 0; frame < 6000; frame++) {
+        intervals.push_back(FrameInterval(frame));
+        timing.record(intervals.back());
+    }
+
+    FrameTimingReport report;
+    timing.totalReport(report);
+    EXPECT_EQ(6000u, report.frames);
+    // 3 hitches a second, one of them the stall every 10 seconds
+    EXPECT_EQ(300u, report.longFrames);
+    EXPECT_EQ(100000u, report.maxUs);
+    EXPECT_GE(report.minUs, 16000u);
+
+    const double percents[] = { 50, 95, 99 };
+    const uint32_t reported[] = { report.p50Us, report.p95Us, report.p99Us };
+    for (int i = 0; i < 3; i++) {
+        double exact = ExactPercentile(intervals, percents[i]);
+        EXPECT_NEAR(exact, reported[i], exact / 16) << "p" << percents[i];
+    }
+
+    // The window starts over, the total does not
+    timing.resetWindow();
+    timing.record(16667);
+    timing.windowReport(report);
+    EXPECT_EQ(1u, report.frames);
+    timing.totalReport(report);
+    EXPECT_EQ(6001u, report.frames);
+
+    // At 30 Hz the 50 ms hitches are not long frames any more
+    timing.reset();
+    timing.setVsyncInterval(33333);
+    for (uint32_t frame = 0; frame < 6000; frame++) {
+        timing.record(FrameInterval(frame));
+    }
+    timing.totalReport(report);
+    EXPECT_EQ(10u, report.longFrames);
+}
+
+TEST(FrameTimingTest, perAppBreakdown) {
+    FrameTiming timing;
+    FrameTimingReport report;
+
+    timing.record(16667);
+    timing.setFocusedApp("YouTube");
+    timing.record(16667);
+    timing.record(50000);
+    timing.setFocusedApp("Netflix");
+    timing.record(16667);
+
+    ASSERT_TRUE(timing.appReport("YouTube", report));
+    EXPECT_EQ(2u, report.frames);
+    EXPECT_EQ(1u, report.longFrames);
+    ASSERT_TRUE(timing.appReport("Netflix", report));
+    EXPECT_EQ(1u, report.frames);
+    EXPECT_FALSE(timing.appReport("", report));
+    timing.totalReport(report);
+    EXPECT_EQ(4u, report.frames);
+
+    // The least recently focused app gives its slot up
+    for (int i = 0; i < FRAME_TIMING_MAX_APPS - 1; i++) {
+        timing.setFocusedApp("app" + std::to_string(i));
+    }
+    EXPECT_FALSE(timing.appReport("YouTube", report));
+    EXPECT_TRUE(timing.appReport("Netflix", report));
+    EXPECT_EQ("app6", timing.focusedApp());
+
+    size_t apps = 0;
+    std::string app;
+    for (size_t i = 0; i < timing.apps(); i++) {
+        if (timing.appAt(i, app, report)) {
+            apps++;
+        }
+    }
+    EXPECT_EQ(static_cast<size_t>(FRAME_TIMING_MAX_APPS), apps);
+}
+
+TEST(FrameTimingTest, recordingBenchmark) {
+    const uint32_t frames = 1000000;
+    FrameTiming timing;
+    timing.setFocusedApp("YouTube");
+
+    size_t heap = HeapInUse();
+    auto start = std::chrono::steady_clock::now();
+    for (uint32_t frame = 0; frame < frames; frame++) {
+        timing.record(FrameInterval(frame));
+    }
+    auto recordNs = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start).count();
+    EXPECT_EQ(heap, HeapInUse());
+
+    FrameTimingReport report;
+    start = std::chrono::steady_clock::now();
+    timing.totalReport(report);
+    auto reportNs = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start).count();
+    EXPECT_EQ(frames, report.frames);
+
+    // Keeping every interval to sort them at the end of the window, for comparison
+    std::vector<uint32_t> intervals;
+    start = std::chrono::steady_clock::now();
+    for (uint32_t frame = 0; frame < frames; frame++) {
+        intervals.push_back(FrameInterval(frame));
+    }
+    uint32_t p99 = ExactPercentile(intervals, 99);
+    auto sortedNs = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start).count();
+    EXPECT_NEAR(p99, report.p99Us, p99 / 16);
+
+    RecordProperty("recordNsPerFrame", static_cast<int>(recordNs / frames));
+    RecordProperty("reportNs", static_cast<int>(reportNs));
+    RecordProperty("sortedNs", static_cast<int>(sortedNs));
+    printf("FrameTiming %u frames: %d ns per frame recorded, %d us for the report, %d us keeping and sorting them, %zu bytes\n",
+        frames, static_cast<int>(recordNs / frames), static_cast<int>(reportNs / 1000), static_cast<int>(sortedNs / 1000), sizeof(timing));
+}
+
+} // namespace RdkServicesTest
@@ -0,0 +1,296 @@
+/**
+* If not stated otherwise in this file or this component's LICENSE
+* file the following copyright and licenses apply:
+*
+* Copyright 2020 RDK Management
+*
+* Licensed under the Apache License, Version 2.0 (the "License");
+* you may not use this file except in compliance with the License.
+* You may obtain a copy of the License at
+*
+* http://www.apache.org/licenses/LICENSE-2.0
+*
+* Unless required by applicable law or agreed to in writing, software
+* distributed under the License is distributed on an "AS IS" BASIS,
+* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+* See the License for the specific language governing permissions and
+* limitations under the License.
+**/
+
+#include "gtest/gtest.h"
+
+#include "iarmcallstats.h"
+
+#include <stdlib.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <chrono>
+#include <cstdio>
+#include <fstream>
+#include <thread>
+#include <vector>
+
+namespace RdkServicesTest {
+
+using WPEFramework::Plugin::IARMCallStats;
+
+namespace {
+
+// A table per test, standing in for IARM_CALL_STATS_PATH
+class TableFile {
+public:
+    TableFile()
+    {
+        char path[] = "/tmp/iarmcallstatsXXXXXX";
+        int fd = mkstemp(path);
+        close(fd);
+        unlink(path);
+        m_path = path;
+    }
+    ~TableFile()
+    {
+        unlink(m_path.c_str());
+    }
+    const std::string& path() const
+    {
+        return m_path;
+    }
+
+private:
+    std::string m_path;
+};
+
+// A call taking the given time, as IARM_BUS_CALL makes it
+bool Call(IARMCallStats& stats, IARMCallStats::Site& site, const char* owner, const char* method, uint32_t us, bool succeeded = true)
+{
+    IARMCallStats::Call call(stats, site, owner, method);
+    if (us > 0) {
+        std::this_thread::sleep_for(std::chrono::microseconds(us));
+    }
+    return call.end(succeeded);
+}
+
+const IARMCallStats::Entry* Find(const std::vector<IARMCallStats::Entry>& entries, const std::string& owner, const std::string& method)
+{
+    for (const auto& entry : entries) {
+        if (entry.owner == owner && entry.method == method) {
+            return &entry;
+        }
+    }
+    return nullptr;
+}
+
+} // namespace
+
+TEST(IARMCallStatsTest, sharedAcrossInstances) {
+    TableFile file;
+    // As two plugins, in the same process or not
+    IARMCallStats network(file.path());
+    IARMCallStats system(file.path());
+    ASSERT_TRUE(network.shared());
+    ASSERT_TRUE(system.shared());
+
+    IARMCallStats::Site networkSite, systemSite, otherSite;
+    Call(network, networkSite, "NET_SRV_MGR", "getIPSettings", 0);
+    Call(network, networkSite, "NET_SRV_MGR", "getIPSettings", 0, false);
+    Call(system, systemSite, "PWRMgr", "GetPowerState", 0);
+    Call(system, otherSite, "NET_SRV_MGR", "getIPSettings", 0);
+
+    auto entries = network.snapshot();
+    EXPECT_EQ(2u, entries.size());
+    const IARMCallStats::Entry* ip = Find(entries, "NET_SRV_MGR", "getIPSettings");
+    ASSERT_NE(nullptr, ip);
+    EXPECT_EQ(3u, ip->calls);
+    EXPECT_EQ(1u, ip->failures);
+    EXPECT_EQ(0, ip->inFlight);
+    const IARMCallStats::Entry* power = Find(entries, "PWRMgr", "GetPowerState");
+    ASSERT_NE(nullptr, power);
+    EXPECT_EQ(1u, power->calls);
+
+    // The threshold is shared too
+    system.setSlowThresholdUs(5000);
+    EXPECT_EQ(5000u, network.slowThresholdUs());
+
+    // A site passing its names in variables gets the entry of the names
+    Call(network, networkSite, "PWRMgr", "GetPowerState", 0);
+    EXPECT_EQ(2u, Find(system.snapshot(), "PWRMgr", "GetPowerState")->calls);
+    EXPECT_EQ(3u, Find(system.snapshot(), "NET_SRV_MGR", "getIPSettings")->calls);
+
+    network.reset();
+    entries = system.snapshot();
+    EXPECT_EQ(2u, entries.size());
+    EXPECT_EQ(0u, Find(entries, "NET_SRV_MGR", "getIPSettings")->calls);
+}
+
+TEST(IARMCallStatsTest, inFlight) {
+    TableFile file;
+    IARMCallStats stats(file.path());
+    IARMCallStats::Site site;
+
+    IARMCallStats::Call first(stats, site, "DSMgr", "GetResolution");
+    {
+        IARMCallStats::Call second(stats, site, "DSMgr", "GetResolution");
+        EXPECT_EQ(2, stats.snapshot()[0].inFlight);
+        second.end(true);
+    }
+    EXPECT_EQ(1, stats.snapshot()[0].inFlight);
+    first.end(true);
+    EXPECT_EQ(0, stats.snapshot()[0].inFlight);
+    EXPECT_EQ(2u, stats.snapshot()[0].calls);
+}
+
+TEST(IARMCallStatsTest, histogramAndSlowCalls) {
+    TableFile file;
+    IARMCallStats stats(file.path());
+    EXPECT_EQ(static_cast<uint32_t>(IARM_CALL_STATS_DEFAULT_SLOW_US), stats.slowThresholdUs());
+    stats.setSlowThresholdUs(20000);
+
+    IARMCallStats::Site site;
+    for (int i = 0; i < 98; i++) {
+        EXPECT_FALSE(Call(stats, site, "CTRLM", "STATUS_GET", 0));
+    }
+    {
+        IARMCallStats::Scope scope("Plugin_ControlService", "getAllRemoteData");
+        EXPECT_FALSE(Call(stats, site, "CTRLM", "STATUS_GET", 3000));
+        EXPECT_TRUE(Call(stats, site, "CTRLM", "STATUS_GET", 30000));
+    }
+    EXPECT_STREQ("", IARMCallStats::Scope::plugin());
+
+    auto entries = stats.snapshot();
+    ASSERT_EQ(1u, entries.size());
+    const IARMCallStats::Entry& entry = entries[0];
+    EXPECT_EQ(100u, entry.calls);
+    EXPECT_EQ(1u, entry.slow);
+    EXPECT_EQ("Plugin_ControlService getAllRemoteData", entry.lastSlowCaller);
+    EXPECT_GE(entry.lastSlowUs, 30000u);
+    EXPECT_EQ(entry.lastSlowUs, entry.maxUs);
+    ASSERT_EQ(static_cast<size_t>(IARM_CALL_STATS_BUCKETS), entry.buckets.size());
+
+    // Bucket i holds 2^(i-1) to 2^i us: the two sleeps are in buckets 12 to 13 and 15 to 16
+    uint64_t counted = 0;
+    for (size_t bucket = 0; bucket < entry.buckets.size(); bucket++) {
+        counted += entry.buckets[bucket];
+    }
+    EXPECT_EQ(100u, counted);
+    EXPECT_GE(entry.buckets[12] + entry.buckets[13], 1u);
+    EXPECT_GE(entry.buckets[15] + entry.buckets[16], 1u);
+
+    EXPECT_LE(IARMCallStats::percentileUs(entry, 0.5), 64u);
+    EXPECT_GE(IARMCallStats::percentileUs(entry, 0.995), 30000u);
+    EXPECT_EQ(entry.maxUs, IARMCallStats::percentileUs(entry, 1.0));
+    EXPECT_EQ(1u, IARMCallStats::bucketUpperUs(0));
+    EXPECT_EQ(4096u, IARMCallStats::bucketUpperUs(12));
+    EXPECT_EQ(UINT64_MAX, IARMCallStats::bucketUpperUs(IARM_CALL_STATS_BUCKETS - 1));
+}
+
+TEST(IARMCallStatsTest, fullTableAndOtherLayout) {
+    TableFile file;
+    IARMCallStats stats(file.path());
+
+    std::vector<IARMCallStats::Site> sites(IARM_CALL_STATS_SLOTS + 1);
+    for (size_t i = 0; i < sites.size(); i++) {
+        Call(stats, sites[i], "Owner", ("method" + std::to_string(i)).c_str(), 0);
+    }
+    EXPECT_EQ(static_cast<size_t>(IARM_CALL_STATS_SLOTS), stats.snapshot().size());
+    EXPECT_EQ(1u, stats.dropped());
+
+    // A table written by another version of the layout is left alone
+    TableFile other;
+    {
+        std::ofstream out(other.path(), std::ios::binary);
+        out << std::string(64, 'x');
+    }
+    IARMCallStats privateStats(other.path());
+    EXPECT_FALSE(privateStats.shared());
+    IARMCallStats::Site site;
+    Call(privateStats, site, "Owner", "method", 0);
+    EXPECT_EQ(1u, privateStats.snapshot().size());
+    struct stat st;
+    ASSERT_EQ(0, stat(other.path().c_str(), &st));
+    EXPECT_EQ(64, st.st_size);
+}
+
+TEST(IARMCallStatsTest, abandonedClaims) {
+    TableFile file;
+    IARMCallStats stats(file.path());
+    ASSERT_TRUE(stats.shared());
+
+    // Every slot claimed by a process killed before it named it: the slots start after a 16 byte
+    // header, the claim state first in each
+    struct stat st;
+    ASSERT_EQ(0, stat(file.path().c_str(), &st));
+    const size_t slotSize = (st.st_size - 16) / IARM_CALL_STATS_SLOTS;
+    ASSERT_EQ(16 + slotSize * IARM_CALL_STATS_SLOTS, static_cast<size_t>(st.st_size));
+    {
+        std::fstream table(file.path(), std::ios::in | std::ios::out | std::ios::binary);
+        const uint32_t claiming = 1;
+        for (size_t i = 0; i < IARM_CALL_STATS_SLOTS; i++) {
+            table.seekp(16 + i * slotSize);
+            table.write(reinterpret_cast<const char*>(&claiming), sizeof(claiming));
+        }
+    }
+
+    // Not waited for, the call goes unrecorded
+    IARMCallStats::Site site;
+    Call(stats, site, "PWRMgr", "GetPowerState", 0);
+    EXPECT_EQ(1u, stats.dropped());
+    EXPECT_EQ(0u, stats.snapshot().size());
+}
+
+TEST(IARMCallStatsTest, onlyPrivateFiles) {
+    // Created private to the user
+    TableFile file;
+    {
+        IARMCallStats stats(file.path());
+        EXPECT_TRUE(stats.shared());
+    }
+    struct stat st;
+    ASSERT_EQ(0, lstat(file.path().c_str(), &st));
+    EXPECT_TRUE(S_ISREG(st.st_mode));
+    EXPECT_EQ(0600u, st.st_mode & 0777u);
+
+    // Nor through a link, nor writable by others
+    TableFile link;
+    ASSERT_EQ(0, symlink(file.path().c_str(), link.path().c_str()));
+    IARMCallStats linked(link.path());
+    EXPECT_FALSE(linked.shared());
+
+    ASSERT_EQ(0, chmod(file.path().c_str(), 0666));
+    IARMCallStats writable(file.path());
+    EXPECT_FALSE(writable.shared());
+    ASSERT_EQ(0, chmod(file.path().c_str(), 0640));
+    IARMCallStats readable(file.path());
+    EXPECT_TRUE(readable.shared());
+}
+
+TEST(IARMCallStatsTest, concurrentCalls) {
+    TableFile file;
+    IARMCallStats stats(file.path());
+
+    const uint32_t calls = 100000;
+    const unsigned threads = 4;
+
+    // From a single site on several threads, none lost; the cost per call is measured by RdkServicesBenchmark
+    IARMCallStats::Site site;
+    std::vector<std::thread> workers;
+    for (unsigned t = 0; t < threads; t++) {
+        workers.emplace_back([&]() {
+            IARMCallStats::Scope scope("Plugin_Network", "getIPSettings");
+            for (uint32_t i = 0; i < calls; i++) {
+                IARMCallStats::Call call(stats, site, "NET_SRV_MGR", "getIPSettings");
+                call.end(true);
+            }
+        });
+    }
+    for (auto& worker : workers) {
+        worker.join();
+    }
+
+    auto entries = stats.snapshot();
+    ASSERT_EQ(1u, entries.size());
+    EXPECT_EQ(static_cast<uint64_t>(calls) * threads, entries[0].calls);
+    EXPECT_EQ(0, entries[0].inFlight);
+}
+
+} // namespace RdkServicesTest
@@ -0,0 +1,234 @@
+/**
+* If not stated otherwise in this file or this component's LICENSE
+* file the following copyright and licenses apply:
+*
+* Copyright 2020 RDK Management
+*
+* Licensed under the Apache License, Version 2.0 (the "License");
+* you may not use this file except in compliance with the License.
+* You may obtain a copy of the License at
+*
+* http://www.apache.org/licenses/LICENSE-2.0
+*
+* Unless required by applicable law or agreed to in writing, software
+* distributed under the License is distributed on an "AS IS" BASIS,
+* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+* See the License for the specific language governing permissions and
+* limitations under the License.
+**/
+
+#include "gtest/gtest.h"
+
+#include "iarmeventqueue.h"
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdio>
+#include <cstring>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace RdkServicesTest {
+
+using WPEFramework::Plugin::IARMEventQueue;
+
+namespace {
+
+// As an IARM event payload
+struct Payload {
+    int32_t value;
+    char name[60];
+};
+
+// The worker pool of IARMEventDispatcher: drains whenever a push asks for it
+class Worker {
+public:
+    explicit Worker(IARMEventQueue& queue, const IARMEventQueue::Handler& handler)
+        : m_queue(queue)
+        , m_handler(handler)
+        , m_pending(0)
+        , m_exit(false)
+        , m_thread(&Worker::run, this)
+    {
+    }
+    ~Worker()
+    {
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_exit = true;
+        }
+        m_cond.notify_one();
+        m_thread.join();
+    }
+
+    void post(const char* owner, int32_t eventId, const void* data, size_t len)
+    {
+        if (m_queue.push(owner, eventId, data, len)) {
+            {
+                std::lock_guard<std::mutex> lock(m_mutex);
+                m_pending++;
+            }
+            m_cond.notify_one();
+        }
+    }
+
+private:
+    void run()
+    {
+        std::unique_lock<std::mutex> lock(m_mutex);
+        while (true) {
+            m_cond.wait(lock, [this]() { return m_exit || m_pending > 0; });
+            if (m_pending == 0) {
+                break;
+            }
+            m_pending--;
+            lock.unlock();
+            m_queue.drain(m_handler);
+            lock.lock();
+        }
+        lock.unlock();
+        m_queue.drain(m_handler);
+    }
+
+    IARMEventQueue& m_queue;
+    IARMEventQueue::Handler m_handler;
+    std::mutex m_mutex;
+    std::condition_variable m_cond;
+    int m_pending;
+    bool m_exit;
+    std::thread m_thread;
+};
+
+} // namespace
+
+TEST(IARMEventQueueTest, handlesInOrderWithCopiedPayload)
+{
+    IARMEventQueue queue;
+
+    for (int32_t i = 0; i < 10; i++) {
+        Payload payload;
+        payload.value = i;
+        snprintf(payload.name, sizeof(payload.name), "event %d", i);
+        queue.push((i % 2) ? "DSMgr" : "CECMgr", i, &payload, sizeof(payload));
+        // The caller's buffer is gone once the IARM callback returns
+        memset(&payload, 0xff, sizeof(payload));
+    }
+    EXPECT_EQ(10u, queue.size());
+
+    int32_t expected = 0;
+    size_t handled = queue.drain([&](const char* owner, int32_t eventId, void* data, size_t len) {
+        EXPECT_EQ(expected, eventId);
+        EXPECT_STREQ((expected % 2) ? "DSMgr" : "CECMgr", owner);
+        ASSERT_EQ(sizeof(Payload), len);
+        const Payload* payload = static_cast<const Payload*>(data);
+        EXPECT_EQ(expected, payload->value);
+        EXPECT_EQ("event " + std::to_string(expected), std::string(payload->name));
+        expected++;
+    });
+    EXPECT_EQ(10u, handled);
+    EXPECT_EQ(0u, queue.size());
+}
+
+TEST(IARMEventQueueTest, schedulesOneDrainAtATime)
+{
+    IARMEventQueue queue;
+    int32_t id = 0;
+
+    EXPECT_TRUE(queue.push("owner", id++, nullptr, 0));
+    EXPECT_FALSE(queue.push("owner", id++, nullptr, 0));
+
+    // Events pushed from a handler are handled by the same drain
+    size_t handled = queue.drain([&](const char*, int32_t eventId, void* data, size_t len) {
+        EXPECT_EQ(nullptr, data);
+        EXPECT_EQ(0u, len);
+        if (eventId == 1) {
+            EXPECT_FALSE(queue.push("owner", id++, nullptr, 0));
+        }
+    });
+    EXPECT_EQ(3u, handled);
+
+    EXPECT_TRUE(queue.push("owner", id++, nullptr, 0));
+}
+
+TEST(IARMEventQueueTest, reusesPayloadBuffers)
+{
+    IARMEventQueue queue;
+    Payload payload = {};
+    auto ignore = [](const char*, int32_t, void*, size_t) {};
+
+    for (int i = 0; i < 4; i++) {
+        queue.push("owner", 1, &payload, sizeof(payload));
+    }
+    queue.drain(ignore);
+    uint64_t warm = queue.stats().allocations;
+    EXPECT_EQ(4u, warm);
+
+    for (int round = 0; round < 100; round++) {
+        for (int i = 0; i < 4; i++) {
+            queue.push("owner", 1, &payload, sizeof(payload) - round % 8);
+        }
+        queue.drain(ignore);
+    }
+    EXPECT_EQ(warm, queue.stats().allocations);
+    EXPECT_EQ(404u, queue.stats().events);
+}
+
+TEST(IARMEventQueueTest, dropsWhenFullAndOnClear)
+{
+    IARMEventQueue queue(3);
+
+    EXPECT_TRUE(queue.push("owner", 1, nullptr, 0));
+    queue.push("owner", 2, nullptr, 0);
+    queue.push("owner", 3, nullptr, 0);
+    EXPECT_FALSE(queue.push("owner", 4, nullptr, 0));
+
+    IARMEventQueue::Stats stats = queue.stats();
+    EXPECT_EQ(3u, stats.events);
+    EXPECT_EQ(1u, stats.dropped);
+    EXPECT_EQ(3u, stats.maxDepth);
+
+    queue.clear();
+    EXPECT_EQ(0u, queue.size());
+    EXPECT_TRUE(queue.push("owner", 5, nullptr, 0));
+}
+
+TEST(IARMEventQueueTest, keepsTheCallbackShort)
+{
+    // A notify to a subscriber that blocks, as it was handled in the IARM callback before;
+    // the time a post takes is measured by RdkServicesBenchmark
+    const int events = 50;
+    Payload payload = {};
+
+    IARMEventQueue queue;
+    std::mutex mutex;
+    std::condition_variable cond;
+    bool blocked = true;
+    std::atomic<int> handled(0);
+    {
+        Worker worker(queue, [&](const char*, int32_t, void*, size_t) {
+            std::unique_lock<std::mutex> lock(mutex);
+            cond.wait(lock, [&]() { return !blocked; });
+            handled++;
+        });
+
+        // Every post returns while the handler is still held up by the first event
+        for (int i = 0; i < events; i++) {
+            worker.post("owner", i, &payload, sizeof(payload));
+        }
+        EXPECT_EQ(0, handled.load());
+        EXPECT_GE(queue.size(), static_cast<size_t>(events - 1));
+
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            blocked = false;
+        }
+        cond.notify_all();
+    }
+    EXPECT_EQ(events, handled.load());
+    EXPECT_EQ(0u, queue.size());
+    EXPECT_EQ(static_cast<uint64_t>(events), queue.stats().events);
+}
+
+} // namespace RdkServicesTest
@@ -0,0 +1,253 @@
+/**
+* If not stated otherwise in this file or this component's LICENSE
+* file the following copyright and licenses apply:
+*
+* Copyright 2020 RDK Management
+*
+* Licensed under the Apache License, Version 2.0 (the "License");
+* you may not use this file except in compliance with the License.
+* You may obtain a copy of the License at
+*
+* http://www.apache.org/licenses/LICENSE-2.0
+*
+* Unless required by applicable law or agreed to in writing, software
+* distributed under the License is distributed on an "AS IS" BASIS,
+* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+* See the License for the specific language governing permissions and
+* limitations under the License.
+**/
+
+#include "gtest/gtest.h"
+
+#include "LaunchMetrics.h"
+
+#include <chrono>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+
+namespace RdkServicesTest {
+
+using namespace WPEFramework::Plugin;
+
+namespace {
+
+// Per phase of a cold launch, in ms; the render thread picks a request up on its next frame
+const int cloneMs = 30;
+const int configurationMs = 15;
+const int frameMs = 16;
+const int createDisplayMs = 25;
+const int activateMs = 40;
+
+void Sleep(int ms)
+{
+    std::this_thread::sleep_for(std::chrono::milliseconds(ms));
+}
+
+// As the render thread serves gCreateDisplayRequests
+struct DisplayRequest {
+    std::mutex mutex;
+    std::condition_variable cond;
+    bool cloning = false;
+    bool created = false;
+    double createdMs = 0;
+
+    // Overlapped, the display is only done once the clone started, as when it takes longer to create
+    std::thread submit(bool overlapped)
+    {
+        return std::thread([this, overlapped]() {
+            Sleep(frameMs + createDisplayMs);
+            std::unique_lock<std::mutex> lock(mutex);
+            if (overlapped)
+                cond.wait(lock, [this]() { return cloning; });
+            createdMs = LaunchTimeline::now();
+            created = true;
+            cond.notify_all();
+        });
+    }
+    void cloneStarted()
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        cloning = true;
+        cond.notify_all();
+    }
+    void wait()
+    {
+        std::unique_lock<std::mutex> lock(mutex);
+        cond.wait(lock, [this]() { return created; });
+    }
+};
+
+// As RDKShell::launchWrapper creates a new app, waiting for the display right away or only before activating
+void Launch(LaunchTimeline& timeline, bool overlapped)
+{
+    DisplayRequest display;
+    timeline.begin(LAUNCH_PHASE_DISPLAY);
+    std::thread renderThread = display.submit(overlapped);
+    if (!overlapped)
+        display.wait();
+
+    timeline.begin(LAUNCH_PHASE_CLONE);
+    display.cloneStarted();
+    Sleep(cloneMs);
+    timeline.end(LAUNCH_PHASE_CLONE);
+    timeline.begin(LAUNCH_PHASE_CONFIGURATION);
+    Sleep(configurationMs);
+    timeline.end(LAUNCH_PHASE_CONFIGURATION);
+
+    display.wait();
+    timeline.end(LAUNCH_PHASE_DISPLAY, display.createdMs);
+    renderThread.join();
+
+    timeline.begin(LAUNCH_PHASE_ACTIVATE);
+    Sleep(activateMs);
+    timeline.end(LAUNCH_PHASE_ACTIVATE);
+}
+
+double EndMs(const LaunchTimeline& timeline, LaunchPhase phase)
+{
+    return timeline.startMs(phase) + timeline.durationMs(phase);
+}
+
+} // namespace
+
+TEST(LaunchMetricsTest, timeline) {
+    LaunchTimeline timeline;
+    Launch(timeline, true);
+
+    EXPECT_FALSE(timeline.ran(LAUNCH_PHASE_STATUS));
+    EXPECT_FALSE(timeline.ran(LAUNCH_PHASE_URL));
+    EXPECT_TRUE(timeline.ran(LAUNCH_PHASE_DISPLAY));
+
+    // The display is created while the plugin is cloned, and before it is activated
+    EXPECT_LE(timeline.startMs(LAUNCH_PHASE_DISPLAY), timeline.startMs(LAUNCH_PHASE_CLONE));
+    EXPECT_GE(timeline.durationMs(LAUNCH_PHASE_DISPLAY), frameMs + createDisplayMs);
+    EXPECT_LE(timeline.startMs(LAUNCH_PHASE_DISPLAY) + timeline.durationMs(LAUNCH_PHASE_DISPLAY), timeline.startMs(LAUNCH_PHASE_ACTIVATE));
+    EXPECT_GE(timeline.startMs(LAUNCH_PHASE_CONFIGURATION), timeline.startMs(LAUNCH_PHASE_CLONE) + cloneMs);
+    EXPECT_GE(timeline.elapsedMs(), cloneMs + configurationMs + activateMs);
+
+    // Not begun
+    timeline.end(LAUNCH_PHASE_URL);
+    EXPECT_FALSE(timeline.ran(LAUNCH_PHASE_URL));
+}
+
+TEST(LaunchMetricsTest, histogram) {
+    EXPECT_EQ(0u, LaunchHistogram::bucketOf(0.5));
+    EXPECT_EQ(0u, LaunchHistogram::bucketOf(1.0));
+    EXPECT_EQ(1u, LaunchHistogram::bucketOf(1.5));
+    EXPECT_EQ(9u, LaunchHistogram::bucketOf(800.0));
+    EXPECT_EQ(static_cast<uint32_t>(LAUNCH_METRICS_BUCKETS - 1), LaunchHistogram::bucketOf(60000.0));
+    EXPECT_EQ(1000.0, LaunchHistogram::boundOf(9));
+
+    LaunchHistogram histogram;
+    EXPECT_EQ(0.0, histogram.percentile(50));
+    for (int i = 1; i <= 100; i++)
+        histogram.record(i * 10.0);
+
+    LaunchHistogramReport report;
+    histogram.report(report);
+    EXPECT_EQ(100u, report.count);
+    EXPECT_EQ(10.0, report.minMs);
+    EXPECT_EQ(1000.0, report.maxMs);
+    EXPECT_DOUBLE_EQ(505.0, report.meanMs);
+    // Within the bucket of the exact value
+    EXPECT_GT(report.p50Ms, 200.0);
+    EXPECT_LE(report.p50Ms, 500.0);
+    EXPECT_GT(report.p95Ms, 500.0);
+    EXPECT_LE(report.p95Ms, 1000.0);
+    ASSERT_EQ(static_cast<size_t>(LAUNCH_METRICS_BUCKETS), report.buckets.size());
+    EXPECT_EQ(50u, report.buckets[9]);
+}
+
+TEST(LaunchMetricsTest, apps) {
+    LaunchMetrics metrics;
+    LaunchTimeline timeline;
+    timeline.begin(LAUNCH_PHASE_ACTIVATE);
+    timeline.end(LAUNCH_PHASE_ACTIVATE);
+
+    metrics.record("YouTube", "create", timeline);
+    metrics.record("YouTube", "resume", timeline);
+    metrics.recordFailure("YouTube");
+
+    LaunchMetricsReport report;
+    ASSERT_TRUE(metrics.report("YouTube", report));
+    EXPECT_EQ(2u, report.launches);
+    EXPECT_EQ(1u, report.failures);
+    EXPECT_EQ("resume", report.lastLaunchType);
+    EXPECT_EQ(2u, report.total.count);
+    EXPECT_EQ(2u, report.phases[LAUNCH_PHASE_ACTIVATE].count);
+    EXPECT_EQ(0u, report.phases[LAUNCH_PHASE_CLONE].count);
+    EXPECT_FALSE(metrics.report("Netflix", report));
+
+    // The least recently launched app gives its slot away
+    for (int i = 0; i < LAUNCH_METRICS_MAX_APPS; i++)
+        metrics.record("app" + std::to_string(i), "create", timeline);
+    EXPECT_FALSE(metrics.report("YouTube", report));
+
+    std::vector<LaunchMetricsReport> reports;
+    metrics.reports(reports);
+    ASSERT_EQ(static_cast<size_t>(LAUNCH_METRICS_MAX_APPS), reports.size());
+    EXPECT_EQ("app" + std::to_string(LAUNCH_METRICS_MAX_APPS - 1), reports.front().client);
+    EXPECT_EQ("app0", reports.back().client);
+}
+
+TEST(LaunchMetricsTest, firstFrame) {
+    LaunchMetrics metrics;
+
+    // Cold, the first frame comes after the launch completed
+    LaunchTimeline cold;
+    metrics.started("YouTube", cold);
+    metrics.record("YouTube", "create", cold);
+    Sleep(5);
+    metrics.firstFrame("YouTube");
+    // Only the first one after a launch
+    metrics.firstFrame("YouTube");
+
+    // A warm instance drew its first frame before the launch
+    metrics.firstFrame("HtmlApp_warm0");
+    LaunchTimeline pooled;
+    metrics.started("HtmlApp_warm0", pooled);
+    metrics.record("HtmlApp_warm0", "resume", pooled, true);
+
+    LaunchMetricsReport report;
+    ASSERT_TRUE(metrics.report("YouTube", report));
+    EXPECT_EQ(1u, report.firstFrame.count);
+    EXPECT_GE(report.firstFrame.minMs, 5.0);
+    EXPECT_EQ(0u, report.firstFramePooled.count);
+    ASSERT_TRUE(metrics.report("HtmlApp_warm0", report));
+    EXPECT_EQ(0u, report.firstFrame.count);
+    EXPECT_EQ(1u, report.firstFramePooled.count);
+    EXPECT_EQ(1u, report.pooledLaunches);
+}
+
+TEST(LaunchMetricsTest, overlapFromTimestamps) {
+    // How much sooner the app is activated is measured by RdkServicesBenchmark
+    LaunchTimeline sequential;
+    Launch(sequential, false);
+    LaunchTimeline overlapped;
+    Launch(overlapped, true);
+
+    // Waiting for the display first, it is created before the clone starts
+    EXPECT_LE(EndMs(sequential, LAUNCH_PHASE_DISPLAY), sequential.startMs(LAUNCH_PHASE_CLONE));
+
+    // Alongside, the display is still being created when the clone starts
+    EXPECT_LE(overlapped.startMs(LAUNCH_PHASE_DISPLAY), overlapped.startMs(LAUNCH_PHASE_CLONE));
+    EXPECT_GE(EndMs(overlapped, LAUNCH_PHASE_DISPLAY), overlapped.startMs(LAUNCH_PHASE_CLONE));
+
+    // Either way the phases on the launch thread follow each other, and activation waits for the display
+    for (const LaunchTimeline* timeline : { &sequential, &overlapped }) {
+        EXPECT_LE(EndMs(*timeline, LAUNCH_PHASE_CLONE), timeline->startMs(LAUNCH_PHASE_CONFIGURATION));
+        EXPECT_LE(EndMs(*timeline, LAUNCH_PHASE_CONFIGURATION), timeline->startMs(LAUNCH_PHASE_ACTIVATE));
+        EXPECT_LE(EndMs(*timeline, LAUNCH_PHASE_DISPLAY), timeline->startMs(LAUNCH_PHASE_ACTIVATE));
+    }
+
+    LaunchMetrics metrics;
+    metrics.record("app", "create", sequential);
+    metrics.record("app", "create", overlapped);
+    LaunchMetricsReport report;
+    ASSERT_TRUE(metrics.report("app", report));
+    EXPECT_EQ(2u, report.launches);
+    EXPECT_EQ(2u, report.phases[LAUNCH_PHASE_DISPLAY].count);
+}
+
+} // namespace RdkServicesTest
@@ -0,0 +1,403 @@
+/**
+* If not stated otherwise in this file or this component's LICENSE
+* file the following copyright and licenses apply:
+*
+* Copyright 2020 RDK Management
+*
+* Licensed under the Apache License, Version 2.0 (the "License");
+* you may not use this file except in compliance with the License.
+* You may obtain a copy of the License at
+*
+* http://www.apache.org/licenses/LICENSE-2.0
+*
+* Unless required by applicable law or agreed to in writing, software
+* distributed under the License is distributed on an "AS IS" BASIS,
+* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+* See the License for the specific language governing permissions and
+* limitations under the License.
+**/
+
+#include "gtest/gtest.h"
+
+#include "MemoryPolicy.h"
+
+#include <stdlib.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <fstream>
+#include <thread>
+
+namespace RdkServicesTest {
+
+using WPEFramework::Plugin::MemoryPolicy;
+using WPEFramework::Plugin::ProcessMemory;
+
+namespace {
+
+const uint32_t MB = 1024;
+
+void WriteFile(const std::string& path, const std::string& content)
+{
+    std::ofstream file(path, std::ios::binary);
+    file << content;
+}
+
+// NUL separated, as /proc/<pid>/cmdline
+template <size_t N>
+std::string Cmdline(const char (&arguments)[N])
+{
+    return std::string(arguments, N - 1);
+}
+
+void AddProcess(const std::string& root, int pid, int ppid, const std::string& name, const std::string& cmdline, const std::string& smapsName, const std::string& smaps)
+{
+    const std::string path = root + "/" + std::to_string(pid);
+    mkdir(path.c_str(), 0755);
+    WriteFile(path + "/stat", std::to_string(pid) + " (" + name + ") S " + std::to_string(ppid) + " 1 1 0 -1\n");
+    WriteFile(path + "/cmdline", cmdline);
+    WriteFile(path + "/" + smapsName, smaps);
+}
+
+MemoryPolicy::App App(const std::string& callsign, bool focused, bool suspended, uint32_t pssKb)
+{
+    MemoryPolicy::App app;
+    app.callsign = callsign;
+    app.focused = focused;
+    app.suspended = suspended;
+    app.pssKb = pssKb;
+    return app;
+}
+
+// The apps of a device, as RDKShell carries the decisions out
+struct Device {
+    struct SimApp {
+        std::string callsign;
+        uint32_t pssKb;
+        bool suspended;
+        bool alive;
+    };
+
+    uint32_t totalKb = 1024 * MB;
+    std::vector<SimApp> apps;
+    std::string focused;
+    uint32_t focusedDecisions = 0;
+    uint32_t protectedDecisions = 0;
+
+    uint32_t freeKb(uint32_t otherKb) const
+    {
+        uint64_t usedKb = otherKb;
+        for (const SimApp& app : apps)
+        {
+            if (app.alive)
+                usedKb += app.suspended ? app.pssKb - app.pssKb * MEMORY_POLICY_SUSPEND_RECLAIM_PERCENT / 100 : app.pssKb;
+        }
+        return (usedKb < totalKb) ? static_cast<uint32_t>(totalKb - usedKb) : 0;
+    }
+
+    std::vector<MemoryPolicy::App> sample() const
+    {
+        std::vector<MemoryPolicy::App> sampled;
+        for (const SimApp& app : apps)
+        {
+            if (app.alive)
+                sampled.push_back(App(app.callsign, app.callsign == focused, app.suspended, app.pssKb));
+        }
+        return sampled;
+    }
+
+    void launch(MemoryPolicy* policy, const std::string& callsign, uint32_t pssKb)
+    {
+        auto it = std::find_if(apps.begin(), apps.end(), [&](const SimApp& app) { return app.callsign == callsign; });
+        if (it == apps.end())
+            it = apps.insert(apps.end(), SimApp{ callsign, pssKb, false, true });
+        it->alive = true;
+        it->suspended = false;
+        focused = callsign;
+        if (policy)
+            policy->focused(callsign);
+    }
+
+    void apply(MemoryPolicy& policy, const std::vector<MemoryPolicy::Decision>& decisions)
+    {
+        for (const MemoryPolicy::Decision& decision : decisions)
+        {
+            if (decision.callsign == focused)
+                focusedDecisions++;
+            if (decision.callsign == MEMORY_POLICY_DEFAULT_PROTECTED)
+                protectedDecisions++;
+            for (SimApp& app : apps)
+            {
+                if (app.callsign != decision.callsign)
+                    continue;
+                if (decision.action == MemoryPolicy::DESTROY)
+                {
+                    app.alive = false;
+                    policy.removed(app.callsign);
+                }
+                else
+                {
+                    app.suspended = true;
+                }
+            }
+        }
+    }
+};
+
+struct TraceResult {
+    uint32_t secondsBelowLowRam = 0;
+    uint32_t secondsBelowCriticallyLowRam = 0;
+    uint32_t minFreeKb = UINT32_MAX;
+    uint32_t destroyed = 0;
+    uint32_t suspended = 0;
+    uint32_t rounds = 0;
+    uint64_t reclaimedKb = 0;
+    uint32_t focusedDecisions = 0;
+    uint32_t protectedDecisions = 0;
+};
+
+// Ten minutes of an evening, sampled every second: an app launched every 40 s, the rest of the
+// system jittering by a few MB around 300 MB, and a 150 MB spike (a 4K playback starting) at 400 s
+TraceResult RunTrace(bool withPolicy, uint32_t hysteresisKb)
+{
+    const char* const callsigns[] = { "YouTube", "Netflix", "Prime", "HtmlApp", "LightningApp", "Cobalt", "Spotify" };
+    const uint32_t pssKb[] = { 220 * MB, 200 * MB, 180 * MB, 90 * MB, 120 * MB, 160 * MB, 80 * MB };
+    const uint32_t lowRamKb = 200 * MB;
+    const uint32_t criticallyLowRamKb = 100 * MB;
+
+    MemoryPolicy policy;
+    policy.setLowRamKb(lowRamKb);
+    policy.setCriticallyLowRamKb(criticallyLowRamKb);
+    policy.configure(true, hysteresisKb, { MEMORY_POLICY_DEFAULT_PROTECTED });
+
+    Device device;
+    device.launch(nullptr, MEMORY_POLICY_DEFAULT_PROTECTED, 60 * MB);
+
+    TraceResult result;
+    bool sampling = false;
+    for (int second = 0; second < 600; second++)
+    {
+        if (second % 40 == 0)
+            device.launch(withPolicy ? &policy : nullptr, callsigns[(second / 40) % 7], pssKb[(second / 40) % 7]);
+
+        uint32_t otherKb = 300 * MB + ((second * 7919) % 17) * MB / 2;
+        if (second >= 400 && second < 430)
+            otherKb += 150 * MB;
+
+        uint32_t freeKb = device.freeKb(otherKb);
+        // The memory monitor warns once below lowRam, the policy samples from then on
+        if (withPolicy && !sampling && freeKb < lowRamKb)
+            sampling = policy.start();
+        if (sampling)
+        {
+            MemoryPolicy::Result evaluated = policy.evaluate(second * 1000.0, freeKb, device.sample());
+            device.apply(policy, evaluated.decisions);
+            sampling = !evaluated.done;
+            freeKb = device.freeKb(otherKb);
+        }
+
+        result.secondsBelowLowRam += (freeKb < lowRamKb) ? 1 : 0;
+        result.secondsBelowCriticallyLowRam += (freeKb < criticallyLowRamKb) ? 1 : 0;
+        result.minFreeKb = std::min(result.minFreeKb, freeKb);
+    }
+
+    MemoryPolicy::Stats stats = policy.stats();
+    result.destroyed = stats.destroyed;
+    result.suspended = stats.suspended;
+    result.rounds = stats.rounds;
+    result.reclaimedKb = stats.reclaimedKb;
+    result.focusedDecisions = device.focusedDecisions;
+    result.protectedDecisions = device.protectedDecisions;
+    return result;
+}
+
+} // namespace
+
+TEST(MemoryPolicyTest, processMemory) {
+    char root[] = "/tmp/MemoryPolicyTestXXXXXX";
+    ASSERT_NE(nullptr, mkdtemp(root));
+
+    AddProcess(root, 100, 1, "WPEProcess", Cmdline("WPEProcess\0-l\0libWebKitBrowser.so\0-C\0YouTube\0-a\0/usr/bin\0"), "smaps_rollup", "55d0-7ffd ---p 00000000 00:00 0 [rollup]\nRss: 90000 kB\nPss: 81000 kB\nPss_Anon: 70000 kB\n");
+    // No smaps_rollup on older kernels
+    AddProcess(root, 101, 100, "WPEWebProcess", Cmdline("WPEWebProcess\0"), "smaps", "Rss: 50000 kB\nPss: 30000 kB\nRss: 20000 kB\nPss: 12000 kB\n");
+    AddProcess(root, 102, 101, "WPENetwork) S 7", Cmdline("WPENetworkProcess\0"), "smaps_rollup", "Pss: 3000 kB\n");
+    AddProcess(root, 200, 1, "WPEProcess", Cmdline("WPEProcess\0-C\0Netflix\0"), "smaps_rollup", "Pss: 150000 kB\n");
+
+    ProcessMemory memory(root);
+    memory.refresh();
+    std::vector<int> pids = memory.processesOf("YouTube");
+    std::sort(pids.begin(), pids.end());
+    ASSERT_EQ(3u, pids.size());
+    EXPECT_EQ(100, pids[0]);
+    EXPECT_EQ(102, pids[2]);
+    EXPECT_EQ(81000u, memory.pssKb(100));
+    EXPECT_EQ(42000u, memory.pssKb(101));
+    EXPECT_EQ(126000u, memory.pssKb("YouTube"));
+    EXPECT_EQ(150000u, memory.pssKb("Netflix"));
+    // In process
+    EXPECT_EQ(0u, memory.pssKb("HtmlApp"));
+
+    std::string command = std::string("rm -rf ") + root;
+    EXPECT_EQ(0, system(command.c_str()));
+}
+
+TEST(MemoryPolicyTest, levelsAndRanking) {
+    MemoryPolicy policy;
+    EXPECT_FALSE(policy.start());
+
+    // Not enabled before setMemoryMonitor set both thresholds
+    EXPECT_FALSE(policy.configure(true, 16 * MB, { "ResidentApp" }));
+    policy.setLowRamKb(100 * MB);
+    EXPECT_FALSE(policy.configure(true, 16 * MB, { "ResidentApp" }));
+    EXPECT_FALSE(policy.enabled());
+    EXPECT_FALSE(policy.start());
+    policy.setCriticallyLowRamKb(50 * MB);
+    EXPECT_TRUE(policy.configure(true, 16 * MB, { "ResidentApp" }));
+    policy.focused("Netflix");
+    policy.focused("HtmlApp");
+    policy.focused("YouTube");
+
+    std::vector<MemoryPolicy::App> apps = {
+        App("YouTube", true, false, 200000),
+        App("Netflix", false, true, 60000),
+        App("HtmlApp", false, false, 80000),
+        App("Cobalt", false, false, 50000),
+        App("ResidentApp", false, false, 40000)
+    };
+
+    ASSERT_TRUE(policy.start());
+    EXPECT_FALSE(policy.start());
+    MemoryPolicy::Result result = policy.evaluate(0, 110000, apps);
+    EXPECT_EQ(MemoryPolicy::NORMAL, result.level);
+    EXPECT_TRUE(result.decisions.empty());
+    EXPECT_TRUE(result.done);
+
+    // The suspended app goes first, destroying it is enough
+    ASSERT_TRUE(policy.start());
+    result = policy.evaluate(0, 90000, apps);
+    EXPECT_EQ(MemoryPolicy::LOW, result.level);
+    ASSERT_EQ(1u, result.decisions.size());
+    EXPECT_EQ("Netflix", result.decisions[0].callsign);
+    EXPECT_EQ(MemoryPolicy::DESTROY, result.decisions[0].action);
+    EXPECT_EQ(60000u, result.decisions[0].estimatedKb);
+    apps.erase(apps.begin() + 1);
+
+    // Given time to settle
+    result = policy.evaluate(1000, 95000, apps);
+    EXPECT_FALSE(result.settled);
+    EXPECT_TRUE(result.decisions.empty());
+
+    // Still below lowRam plus the hysteresis, the app never focused is suspended
+    result = policy.evaluate(3000, 110000, apps);
+    EXPECT_EQ(MemoryPolicy::LOW, result.level);
+    ASSERT_TRUE(result.settled);
+    EXPECT_EQ(20000, result.round.reclaimedKb);
+    EXPECT_EQ(60000u, result.round.estimatedKb);
+    ASSERT_EQ(1u, result.decisions.size());
+    EXPECT_EQ("Cobalt", result.decisions[0].callsign);
+    EXPECT_EQ(MemoryPolicy::SUSPEND, result.decisions[0].action);
+    EXPECT_EQ(15000u, result.decisions[0].estimatedKb);
+    apps[2].suspended = true;
+
+    result = policy.evaluate(6000, 120000, apps);
+    EXPECT_EQ(MemoryPolicy::NORMAL, result.level);
+    EXPECT_TRUE(result.settled);
+    EXPECT_TRUE(result.done);
+
+    // Critically low, background apps are destroyed too, never the focused or a protected one
+    ASSERT_TRUE(policy.start());
+    result = policy.evaluate(10000, 40000, apps);
+    EXPECT_EQ(MemoryPolicy::CRITICAL, result.level);
+    ASSERT_EQ(2u, result.decisions.size());
+    EXPECT_EQ("Cobalt", result.decisions[0].callsign);
+    EXPECT_EQ("HtmlApp", result.decisions[1].callsign);
+    EXPECT_EQ(MemoryPolicy::DESTROY, result.decisions[1].action);
+    apps = { App("YouTube", true, false, 200000), App("ResidentApp", false, false, 40000) };
+
+    // Above criticallyLowRam, not above it plus the hysteresis, and nothing left to act upon
+    result = policy.evaluate(13000, 60000, apps);
+    EXPECT_EQ(MemoryPolicy::CRITICAL, result.level);
+    EXPECT_TRUE(result.settled);
+    EXPECT_TRUE(result.decisions.empty());
+    EXPECT_TRUE(result.done);
+    ASSERT_TRUE(policy.start());
+    result = policy.evaluate(14000, 70000, apps);
+    EXPECT_EQ(MemoryPolicy::LOW, result.level);
+    EXPECT_TRUE(result.done);
+    ASSERT_TRUE(policy.start());
+    EXPECT_TRUE(policy.evaluate(15000, 125000, apps).done);
+
+    MemoryPolicy::Stats stats = policy.stats();
+    EXPECT_EQ(3u, stats.rounds);
+    EXPECT_EQ(3u, stats.destroyed);
+    EXPECT_EQ(1u, stats.suspended);
+    EXPECT_EQ(50000u, stats.reclaimedKb);
+}
+
+TEST(MemoryPolicyTest, shutdown) {
+    MemoryPolicy policy;
+    policy.setLowRamKb(100 * MB);
+    policy.setCriticallyLowRamKb(50 * MB);
+    policy.configure(true, 16 * MB, { "ResidentApp" });
+    std::vector<MemoryPolicy::App> apps = { App("HtmlApp", false, false, 80000) };
+
+    // As RDKShell::runMemoryPolicy does, still below lowRam whatever is done
+    ASSERT_TRUE(policy.start());
+    std::atomic<int> samples(0);
+    std::thread sampling([&]() {
+        while (true) {
+            samples++;
+            if (policy.evaluate(samples * 1000.0, 90000, apps).done)
+                break;
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+        policy.leave();
+    });
+    while (samples < 3)
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+
+    policy.shutdown();
+    const int sampled = samples;
+    EXPECT_FALSE(policy.start());
+    std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    EXPECT_EQ(sampled, samples);
+    sampling.join();
+
+    policy.resume();
+    EXPECT_TRUE(policy.start());
+}
+
+TEST(MemoryPolicyTest, traceSimulation) {
+    TraceResult without = RunTrace(false, 16 * MB);
+    TraceResult with = RunTrace(true, 16 * MB);
+    TraceResult noHysteresis = RunTrace(true, 0);
+
+    printf("600 s trace, lowRam 200 MB, criticallyLowRam 100 MB: %u s below lowRam and %u s below criticallyLowRam "
+        "(min %u MB free) leaving it to the apps; %u s and %u s (min %u MB free) with the policy, %u rounds "
+        "suspending %u and destroying %u apps for %llu MB; %u rounds, %u apps and %u s below lowRam without hysteresis\n",
+        without.secondsBelowLowRam, without.secondsBelowCriticallyLowRam, without.minFreeKb / MB,
+        with.secondsBelowLowRam, with.secondsBelowCriticallyLowRam, with.minFreeKb / MB,
+        with.rounds, with.suspended, with.destroyed, static_cast<unsigned long long>(with.reclaimedKb / MB),
+        noHysteresis.rounds, noHysteresis.suspended + noHysteresis.destroyed, noHysteresis.secondsBelowLowRam);
+    RecordProperty("secondsBelowCriticallyLowRamWithout", static_cast<int>(without.secondsBelowCriticallyLowRam));
+    RecordProperty("secondsBelowCriticallyLowRamWith", static_cast<int>(with.secondsBelowCriticallyLowRam));
+    RecordProperty("roundsWithHysteresis", static_cast<int>(with.rounds));
+    RecordProperty("roundsWithoutHysteresis", static_cast<int>(noHysteresis.rounds));
+
+    EXPECT_GT(without.secondsBelowCriticallyLowRam, 100u);
+    EXPECT_LT(with.secondsBelowCriticallyLowRam * 10, without.secondsBelowCriticallyLowRam);
+    EXPECT_GT(with.minFreeKb, without.minFreeKb);
+    EXPECT_GT(with.reclaimedKb, 0u);
+    EXPECT_EQ(0u, with.focusedDecisions);
+    EXPECT_EQ(0u, with.protectedDecisions);
+    // Reclaiming past lowRam takes fewer rounds and disrupts fewer apps than hovering around it
+    EXPECT_LT(with.rounds, noHysteresis.rounds);
+    EXPECT_LT(with.suspended + with.destroyed, noHysteresis.suspended + noHysteresis.destroyed);
+    EXPECT_LT(with.secondsBelowLowRam, noHysteresis.secondsBelowLowRam);
+}
+
+} // namespace RdkServicesTest
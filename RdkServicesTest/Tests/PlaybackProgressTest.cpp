@@ -0,0 +1,255 @@
+/**
+* If not stated otherwise in this file or this component's LICENSE
+* file the following copyright and licenses apply:
+*
+* Copyright 2020 RDK Management
+*
+* Licensed under the Apache License, Version 2.0 (the "License");
+* you may not use this file except in compliance with the License.
+* You may obtain a copy of the License at
+*
+* http://www.apache.org/licenses/LICENSE-2.0
+*
+* Unless required by applicable law or agreed to in writing, software
+* distributed under the License is distributed on an "AS IS" BASIS,
+* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+* See the License for the specific language governing permissions and
+* limitations under the License.
+**/
+
+#include "gtest/gtest.h"
+
+#include "PlaybackProgress.h"
+
+#include <plugins/plugins.h>
+
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <atomic>
+#include <thread>
+
+namespace RdkServicesTest {
+
+using WPEFramework::Plugin::PlaybackProgress;
+using WPEFramework::Plugin::PlaybackSnapshot;
+using WPEFramework::Plugin::ProgressCoalescer;
+using WPEFramework::Plugin::ProgressTracker;
+
+namespace {
+
+PlaybackProgress Tick(int64_t positionMs, int32_t rate, uint64_t updatedMs)
+{
+    PlaybackProgress progress;
+    progress.durationMs = 600000;
+    progress.positionMs = positionMs;
+    progress.endMs = 600000;
+    progress.rate = rate;
+    progress.updatedMs = updatedMs;
+    return progress;
+}
+
+// One minute of playback, as AampEventListener hands it to the stream: plays, pauses
+// for 10 s, seeks 2 minutes ahead and plays on. Returns the events sent.
+uint32_t PlayOneMinute(ProgressTracker& tracker, uint32_t tickMs)
+{
+    uint32_t events = 0;
+    int64_t positionMs = 0;
+    for (uint64_t nowMs = 0; nowMs < 60000; nowMs += tickMs) {
+        int32_t rate = (nowMs >= 20000 && nowMs < 30000) ? 0 : 100;
+        if (nowMs == 40000) {
+            positionMs += 120000;
+        }
+
+        string parameters;
+        if (tracker.Tick(Tick(positionMs, rate, nowMs), parameters)) {
+            events++;
+        }
+        positionMs += (tickMs * rate) / 100;
+    }
+    return events;
+}
+
+} // namespace
+
+TEST(PlaybackProgressTest, snapshotSharedBetweenMappings) {
+    PlaybackSnapshot writer;
+    PlaybackSnapshot reader;
+    PlaybackProgress progress;
+
+    writer.Create("snapshot test");
+    ASSERT_TRUE(reader.Open("snapshot test"));
+    EXPECT_FALSE(reader.Read(progress));
+
+    writer.Write(Tick(1234, 100, 42));
+    ASSERT_TRUE(reader.Read(progress));
+    EXPECT_EQ(1234, progress.positionMs);
+    EXPECT_EQ(100, progress.rate);
+    EXPECT_EQ(42u, progress.updatedMs);
+
+    writer.Close();
+    PlaybackSnapshot late;
+    EXPECT_FALSE(late.Open("snapshot test"));
+}
+
+TEST(PlaybackProgressTest, readsAreConsistent) {
+    PlaybackSnapshot writer;
+    PlaybackSnapshot reader;
+    writer.Create("consistency test");
+    ASSERT_TRUE(reader.Open("consistency test"));
+    writer.Write(PlaybackProgress());
+
+    std::atomic<bool> stop(false);
+    std::thread writing([&]() {
+        for (int64_t i = 1; !stop; i++) {
+            PlaybackProgress progress = Tick(i, static_cast<int32_t>(i), i);
+            progress.durationMs = progress.startMs = progress.endMs = i;
+            writer.Write(progress);
+        }
+    });
+
+    uint32_t torn = 0;
+    uint32_t read = 0;
+    for (int i = 0; i < 100000; i++) {
+        PlaybackProgress progress;
+        // A writer that never stops may keep a read from ever completing, it then fails
+        if (!reader.Read(progress)) {
+            continue;
+        }
+        read++;
+        if (progress.positionMs != progress.durationMs || progress.positionMs != progress.endMs
+            || progress.positionMs != progress.rate || static_cast<uint64_t>(progress.positionMs) != progress.updatedMs) {
+            torn++;
+        }
+    }
+    stop = true;
+    writing.join();
+
+    EXPECT_EQ(0u, torn);
+    EXPECT_GT(read, 0u);
+}
+
+TEST(PlaybackProgressTest, readFailsWhileWriterIsHalfway) {
+    PlaybackSnapshot writer;
+    PlaybackSnapshot reader;
+    PlaybackProgress progress;
+    writer.Create("halfway test");
+    ASSERT_TRUE(reader.Open("halfway test"));
+    writer.Write(Tick(1234, 100, 42));
+    ASSERT_TRUE(reader.Read(progress));
+
+    // As a player that died in the middle of Write leaves it: the sequence, after the magic, odd
+    int fd = shm_open(PlaybackSnapshot::Name("halfway test").c_str(), O_RDWR, 0);
+    ASSERT_GE(fd, 0);
+    void* memory = mmap(nullptr, 2 * sizeof(uint32_t), PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    close(fd);
+    ASSERT_NE(MAP_FAILED, memory);
+    std::atomic<uint32_t>* sequence = reinterpret_cast<std::atomic<uint32_t>*>(static_cast<uint32_t*>(memory) + 1);
+    uint32_t written = sequence->load();
+    sequence->store(written + 1);
+
+    EXPECT_FALSE(reader.Read(progress));
+
+    sequence->store(written);
+    EXPECT_TRUE(reader.Read(progress));
+    munmap(memory, 2 * sizeof(uint32_t));
+}
+
+TEST(PlaybackProgressTest, onlyPrivateSegments) {
+    const string name = PlaybackSnapshot::Name("private test");
+    shm_unlink(name.c_str());
+
+    // Left behind by a player that died: replaced
+    int fd = shm_open(name.c_str(), O_CREAT | O_EXCL | O_RDWR, 0644);
+    ASSERT_GE(fd, 0);
+    close(fd);
+    PlaybackSnapshot writer;
+    EXPECT_TRUE(writer.Create("private test"));
+    writer.Write(Tick(1234, 100, 42));
+
+    PlaybackSnapshot reader;
+    PlaybackProgress progress;
+    EXPECT_TRUE(reader.Open("private test"));
+    EXPECT_TRUE(reader.Read(progress));
+    reader.Close();
+
+    // Writable by others: not read from
+    fd = shm_open(name.c_str(), O_RDWR, 0);
+    ASSERT_GE(fd, 0);
+    fchmod(fd, 0666);
+    close(fd);
+    EXPECT_FALSE(reader.Open("private test"));
+}
+
+TEST(PlaybackProgressTest, coalescerSendsChanges) {
+    ProgressCoalescer coalescer(1000);
+
+    EXPECT_TRUE(coalescer.Update(Tick(0, 100, 0)));
+    EXPECT_FALSE(coalescer.Update(Tick(250, 100, 250)));
+    EXPECT_FALSE(coalescer.Update(Tick(500, 100, 500)));
+    // Early by less than the slack
+    EXPECT_TRUE(coalescer.Update(Tick(950, 100, 950)));
+    // Paused
+    EXPECT_TRUE(coalescer.Update(Tick(1000, 0, 1000)));
+    EXPECT_FALSE(coalescer.Update(Tick(1000, 0, 1250)));
+    // Seek while paused
+    EXPECT_TRUE(coalescer.Update(Tick(90000, 0, 1500)));
+    EXPECT_FALSE(coalescer.Update(Tick(90000, 0, 1750)));
+
+    coalescer.Reset();
+    EXPECT_TRUE(coalescer.Update(Tick(90000, 0, 2000)));
+
+    coalescer.Interval(0);
+    EXPECT_TRUE(coalescer.Update(Tick(90000, 0, 2250)));
+    EXPECT_EQ(10u, coalescer.Ticks());
+    EXPECT_EQ(6u, coalescer.Sent());
+}
+
+TEST(PlaybackProgressTest, trackerSendsProgressEvents) {
+    const uint32_t tickIntervals[] = { 1000, 250, 100 };
+
+    for (uint32_t tickMs : tickIntervals) {
+        ProgressTracker everyTick;
+        everyTick.Create("every tick test");
+        everyTick.Interval(0);
+        ProgressTracker coalesced;
+        coalesced.Create("coalesced test");
+
+        EXPECT_EQ(60000u / tickMs, PlayOneMinute(everyTick, tickMs));
+        uint32_t events = PlayOneMinute(coalesced, tickMs);
+        // Once a second, plus pausing, resuming and the seek
+        EXPECT_LE(events, 64u);
+        EXPECT_GE(events, 60u);
+        EXPECT_EQ(60000u / tickMs, coalesced.Ticks());
+        EXPECT_EQ(events, coalesced.Sent());
+    }
+}
+
+TEST(PlaybackProgressTest, trackerWritesSnapshotAndEvent) {
+    ProgressTracker tracker;
+    tracker.Create("tracker test");
+    PlaybackSnapshot reader;
+    ASSERT_TRUE(reader.Open("tracker test"));
+
+    string parameters;
+    ASSERT_TRUE(tracker.Tick(Tick(1234, 200, 42), parameters));
+    JsonObject event;
+    event.FromString(parameters);
+    EXPECT_EQ(1234, event[_T("positionMiliseconds")].Number());
+    EXPECT_EQ(2, event[_T("playbackSpeed")].Number());
+    EXPECT_EQ(600000, event[_T("durationMiliseconds")].Number());
+
+    // Not an event, but in the snapshot
+    EXPECT_FALSE(tracker.Tick(Tick(1734, 200, 292), parameters));
+    tracker.State(8);
+    tracker.Buffering(true);
+
+    PlaybackProgress progress;
+    ASSERT_TRUE(reader.Read(progress));
+    EXPECT_EQ(1734, progress.positionMs);
+    EXPECT_EQ(8, progress.state);
+    EXPECT_TRUE(progress.buffering);
+}
+
+} // namespace RdkServicesTest
@@ -0,0 +1,239 @@
+/**
+* If not stated otherwise in this file or this component's LICENSE
+* file the following copyright and licenses apply:
+*
+* Copyright 2020 RDK Management
+*
+* Licensed under the Apache License, Version 2.0 (the "License");
+* you may not use this file except in compliance with the License.
+* You may obtain a copy of the License at
+*
+* http://www.apache.org/licenses/LICENSE-2.0
+*
+* Unless required by applicable law or agreed to in writing, software
+* distributed under the License is distributed on an "AS IS" BASIS,
+* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+* See the License for the specific language governing permissions and
+* limitations under the License.
+**/
+
+#include "gtest/gtest.h"
+
+#include "settingsstore.h"
+
+#include <fcntl.h>
+#include <signal.h>
+#include <stdlib.h>
+#include <unistd.h>
+#include <sys/stat.h>
+#include <sys/wait.h>
+#include <chrono>
+#include <cstdio>
+#include <fstream>
+#include <functional>
+#include <sstream>
+#include <thread>
+
+namespace RdkServicesTest {
+
+using WPEFramework::Plugin::SettingsStore;
+
+namespace {
+
+struct TempDir {
+    std::string path;
+
+    TempDir()
+    {
+        char dir[] = "/tmp/SettingsStoreTest.XXXXXX";
+        path = mkdtemp(dir);
+    }
+    ~TempDir()
+    {
+        std::string command = "rm -rf " + path;
+        EXPECT_EQ(0, system(command.c_str()));
+    }
+};
+
+std::string ReadFile(const std::string& path)
+{
+    std::ifstream file(path.c_str());
+    std::ostringstream contents;
+    contents << file.rdbuf();
+    return contents.str();
+}
+
+// As persistJsonSettings did: truncate the file, write it, then sync it
+void WriteInPlace(const std::string& path, const std::string& contents)
+{
+    int fd = open(path.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+    ASSERT_GE(fd, 0);
+    for (size_t done = 0; done < contents.size(); ) {
+        // In pieces, as a JSON writer would
+        ssize_t written = write(fd, contents.data() + done, std::min<size_t>(4096, contents.size() - done));
+        ASSERT_GT(written, 0);
+        done += written;
+    }
+    fsync(fd);
+    close(fd);
+}
+
+// Kills a process that keeps rewriting the file with one of two contents, returns whether the file was torn
+bool KillMidWrite(const std::string& path, bool atomically, int afterUs)
+{
+    const std::string a(256 * 1024, 'a');
+    const std::string b(256 * 1024, 'b');
+    WriteInPlace(path, a);
+
+    pid_t pid = fork();
+    if (pid == 0) {
+        for (int i = 0; ; i++) {
+            const std::string& contents = (i % 2) ? a : b;
+            if (atomically)
+                SettingsStore::writeAtomically(path, contents);
+            else
+                WriteInPlace(path, contents);
+        }
+    }
+    usleep(afterUs);
+    kill(pid, SIGKILL);
+    int status = 0;
+    waitpid(pid, &status, 0);
+
+    std::string contents = ReadFile(path);
+    return contents != a && contents != b;
+}
+
+// Sets a key=value line, as persistJsonSettings sets a key of the JSON object
+std::function<void(std::string&)> SetKey(const std::string& key, const std::string& value)
+{
+    return [key, value](std::string& image) {
+        std::istringstream lines(image);
+        std::ostringstream result;
+        std::string line;
+        while (std::getline(lines, line)) {
+            if (line.compare(0, key.size() + 1, key + "=") != 0)
+                result << line << "\n";
+        }
+        result << key << "=" << value << "\n";
+        image = result.str();
+    };
+}
+
+} // namespace
+
+TEST(SettingsStoreTest, imageAndExternalChanges) {
+    TempDir dir;
+    const std::string path = dir.path + "/settings.json";
+    SettingsStore store(path, 0);
+
+    std::string contents;
+    EXPECT_FALSE(store.read(contents));
+    store.write("{\"enabled\":true}");
+    EXPECT_EQ(1u, store.writes());
+    EXPECT_EQ("{\"enabled\":true}", ReadFile(path));
+
+    store.update([](std::string& image) { image += "\n"; });
+    EXPECT_TRUE(store.read(contents));
+    EXPECT_EQ("{\"enabled\":true}\n", contents);
+
+    // Written by someone else, e.g. the plugin's loadSettings
+    std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    WriteInPlace(path, "{\"enabled\":false}");
+    EXPECT_TRUE(store.read(contents));
+    EXPECT_EQ("{\"enabled\":false}", contents);
+
+    // No temporary file left behind
+    EXPECT_NE(0, access((path + ".tmp").c_str(), F_OK));
+}
+
+TEST(SettingsStoreTest, storesOfOneFileMerge) {
+    TempDir dir;
+    const std::string path = dir.path + "/cecData_2.json";
+
+    // As HdmiCec_2 and HdmiCecSink, each with the store of its own plugin library
+    SettingsStore cec(path, 60000);
+    SettingsStore sink(path, 60000);
+
+    cec.update(SetKey("CECEnabled", "true"));
+    sink.update(SetKey("OSDName", "TV"));
+    cec.update(SetKey("CECEnabled", "false"));
+    EXPECT_TRUE(cec.flush());
+    EXPECT_TRUE(sink.flush());
+    EXPECT_EQ("CECEnabled=false\nOSDName=TV\n", ReadFile(path));
+
+    // Each store sees the other's keys once it wrote
+    std::string contents;
+    EXPECT_TRUE(sink.read(contents));
+    EXPECT_EQ("CECEnabled=false\nOSDName=TV\n", contents);
+
+    sink.update(SetKey("VendorId", "0019fb"));
+    cec.update(SetKey("CECEnabled", "true"));
+    EXPECT_TRUE(sink.flush());
+    EXPECT_TRUE(cec.flush());
+    EXPECT_EQ("OSDName=TV\nVendorId=0019fb\nCECEnabled=true\n", ReadFile(path));
+    EXPECT_EQ(2u, cec.writes());
+    EXPECT_EQ(2u, sink.writes());
+}
+
+TEST(SettingsStoreTest, killedMidWrite) {
+    TempDir dir;
+    const std::string path = dir.path + "/settings.json";
+
+    int tornInPlace = 0;
+    int tornAtomically = 0;
+    for (int i = 0; i < 20; i++) {
+        if (KillMidWrite(path, false, 2000 + i * 500))
+            tornInPlace++;
+        if (KillMidWrite(path, true, 2000 + i * 500))
+            tornAtomically++;
+    }
+
+    printf("Settings file killed mid-write 20 times: %d torn written in place, %d written atomically\n", tornInPlace, tornAtomically);
+    RecordProperty("tornInPlace", tornInPlace);
+    EXPECT_EQ(0, tornAtomically);
+}
+
+TEST(SettingsStoreTest, togglesCoalesced) {
+    TempDir dir;
+    const std::string path = dir.path + "/cecData.json";
+    const int toggles = 100;
+
+    SettingsStore store(path, 60000);
+    for (int i = 0; i < toggles; i++) {
+        store.update([i](std::string& image) {
+            image = std::string("{\"CECEnabled\":") + ((i % 2) ? "false" : "true") + ",\"CECOTPEnabled\":true}";
+        });
+    }
+    // Nothing written within the delay, then all the toggles in one write
+    EXPECT_EQ(0u, store.writes());
+    EXPECT_TRUE(store.flush());
+    EXPECT_EQ(1u, store.writes());
+    EXPECT_TRUE(store.flush());
+    EXPECT_EQ(1u, store.writes());
+    EXPECT_EQ("{\"CECEnabled\":false,\"CECOTPEnabled\":true}", ReadFile(path));
+}
+
+TEST(SettingsStoreTest, failedWriteKept) {
+    TempDir dir;
+    const std::string path = dir.path + "/cec/cecData.json";
+    SettingsStore store(path, 60000);
+
+    // No directory to write in yet
+    store.update(SetKey("CECEnabled", "false"));
+    EXPECT_FALSE(store.flush());
+    EXPECT_EQ(0u, store.writes());
+
+    std::string contents;
+    EXPECT_TRUE(store.read(contents));
+    EXPECT_EQ("CECEnabled=false\n", contents);
+
+    // Written with the next change, in order
+    ASSERT_EQ(0, mkdir((dir.path + "/cec").c_str(), 0755));
+    store.update(SetKey("OSDName", "TV"));
+    EXPECT_TRUE(store.flush());
+    EXPECT_EQ(1u, store.writes());
+    EXPECT_EQ("CECEnabled=false\nOSDName=TV\n", ReadFile(path));
+}
+
+} // namespace RdkServicesTest
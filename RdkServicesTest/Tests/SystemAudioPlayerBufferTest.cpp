@@ -0,0 +1,175 @@
+/**
+* If not stated otherwise in this file or this component's LICENSE
+* file the following copyright and licenses apply:
+*
+* Copyright 2020 RDK Management
+*
+* Licensed under the Apache License, Version 2.0 (the "License");
+* you may not use this file except in compliance with the License.
+* You may obtain a copy of the License at
+*
+* http://www.apache.org/licenses/LICENSE-2.0
+*
+* Unless required by applicable law or agreed to in writing, software
+* distributed under the License is distributed on an "AS IS" BASIS,
+* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+* See the License for the specific language governing permissions and
+* limitations under the License.
+**/
+
+#include "gtest/gtest.h"
+
+#include "BufferQueue.h"
+
+#include <algorithm>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace RdkServicesTest {
+
+namespace {
+
+// As in AudioPlayer.cpp
+const int poolBufferSize = 24 * 1024;
+const int poolMaxFree = 64;
+
+const char alphabet[] = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+
+std::string Encode(const std::vector<uint8_t>& data)
+{
+    std::string out;
+    out.reserve((data.size() + 2) / 3 * 4);
+    for (size_t i = 0; i < data.size(); i += 3) {
+        uint32_t n = data[i] << 16;
+        if (i + 1 < data.size()) n |= data[i + 1] << 8;
+        if (i + 2 < data.size()) n |= data[i + 2];
+        out += alphabet[(n >> 18) & 63];
+        out += alphabet[(n >> 12) & 63];
+        out += (i + 1 < data.size()) ? alphabet[(n >> 6) & 63] : '=';
+        out += (i + 2 < data.size()) ? alphabet[n & 63] : '=';
+    }
+    return out;
+}
+
+// Stands in for b64_decode, which is not part of this tree
+size_t Decode(const uint8_t* in, size_t len, uint8_t* out)
+{
+    static int8_t table[256];
+    if (table['B'] == 0) {
+        std::fill(table, table + 256, -1);
+        for (int i = 0; i < 64; i++) {
+            table[static_cast<uint8_t>(alphabet[i])] = i;
+        }
+    }
+    size_t written = 0;
+    for (size_t i = 0; i + 3 < len; i += 4) {
+        uint32_t n = (table[in[i]] << 18) | (table[in[i + 1]] << 12);
+        out[written++] = n >> 16;
+        if (in[i + 2] == '=') break;
+        n |= table[in[i + 2]] << 6;
+        out[written++] = (n >> 8) & 0xff;
+        if (in[i + 3] == '=') break;
+        n |= table[in[i + 3]];
+        out[written++] = n & 0xff;
+    }
+    return written;
+}
+
+std::vector<uint8_t> Pcm(size_t size)
+{
+    std::vector<uint8_t> pcm(size);
+    for (size_t i = 0; i < size; i++) {
+        pcm[i] = static_cast<uint8_t>(i * 7 + (i >> 9));
+    }
+    return pcm;
+}
+
+// Fails on the second segment, as b64_decode does on invalid input
+size_t DecodeOnce(const uint8_t* in, size_t len, uint8_t* out)
+{
+    static int calls = 0;
+    return (calls++ == 0) ? Decode(in, len, out) : 0;
+}
+
+} // namespace
+
+TEST(SystemAudioPlayerBufferTest, pooledDecode) {
+    BufferPool pool(poolBufferSize, poolMaxFree);
+    BufferQueue queue(1000);
+
+    std::vector<uint8_t> pcm = Pcm(3 * poolBufferSize + 100);
+    std::string data = Encode(pcm);
+
+    // As PlayBuffer, one pool buffer per segment of input
+    EXPECT_EQ(4, pool.decode(&queue, reinterpret_cast<const uint8_t*>(data.data()), data.size(), Decode));
+    EXPECT_EQ(4, pool.inUse());
+    EXPECT_EQ(4, queue.count());
+
+    // As PushDataAppSrc, the buffers go back to the pool once gstreamer is done with them
+    std::vector<uint8_t> played;
+    while (!queue.isEmpty()) {
+        Buffer* buffer = queue.remove();
+        EXPECT_LE(buffer->getLength(), buffer->getCapacity());
+        played.insert(played.end(), buffer->getBuffer(), buffer->getBuffer() + buffer->getLength());
+        buffer->release();
+    }
+    EXPECT_EQ(pcm, played);
+    EXPECT_EQ(0, pool.inUse());
+
+    // Released buffers are handed out again rather than allocated
+    Buffer* first = pool.acquire();
+    Buffer* second = pool.acquire();
+    EXPECT_NE(first, second);
+    first->release();
+    EXPECT_EQ(first, pool.acquire());
+    first->release();
+    second->release();
+}
+
+TEST(SystemAudioPlayerBufferTest, decodeFailure) {
+    BufferPool pool(poolBufferSize, poolMaxFree);
+    BufferQueue queue(1000);
+    std::string data = Encode(Pcm(2 * poolBufferSize));
+
+    // The buffer that did not decode goes back to the pool, the one before it stays queued
+    EXPECT_EQ(-1, pool.decode(&queue, reinterpret_cast<const uint8_t*>(data.data()), data.size(), DecodeOnce));
+    EXPECT_EQ(1, queue.count());
+    EXPECT_EQ(1, pool.inUse());
+
+    queue.remove()->release();
+    EXPECT_EQ(0, pool.inUse());
+}
+
+TEST(SystemAudioPlayerBufferTest, ringOrder) {
+    const int items = 100000;
+    // Small enough that both sides wait on each other
+    BufferQueue queue(16);
+    std::vector<Buffer*> buffers;
+    for (int i = 0; i < 64; i++) {
+        buffers.push_back(new Buffer(NULL, 16));
+    }
+
+    // As PlayBuffer and the appsrc push thread, one producer and one consumer
+    int outOfOrder = 0;
+    std::thread consumer([&]() {
+        for (int i = 0; i < items; i++) {
+            if (queue.remove() != buffers[i % buffers.size()]) {
+                outOfOrder++;
+            }
+        }
+    });
+    for (int i = 0; i < items; i++) {
+        queue.add(buffers[i % buffers.size()]);
+    }
+    consumer.join();
+
+    EXPECT_EQ(0, outOfOrder);
+    EXPECT_TRUE(queue.isEmpty());
+    EXPECT_EQ(0, queue.count());
+    for (Buffer* buffer : buffers) {
+        buffer->release();
+    }
+}
+
+} // namespace RdkServicesTest
@@ -0,0 +1,210 @@
+/**
+* If not stated otherwise in this file or this component's LICENSE
+* file the following copyright and licenses apply:
+*
+* Copyright 2020 RDK Management
+*
+* Licensed under the Apache License, Version 2.0 (the "License");
+* you may not use this file except in compliance with the License.
+* You may obtain a copy of the License at
+*
+* http://www.apache.org/licenses/LICENSE-2.0
+*
+* Unless required by applicable law or agreed to in writing, software
+* distributed under the License is distributed on an "AS IS" BASIS,
+* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+* See the License for the specific language governing permissions and
+* limitations under the License.
+**/
+
+#include "gtest/gtest.h"
+
+#include "tr181client.h"
+
+#include "Source/TR181StandIn.h"
+
+namespace RdkServicesTest {
+
+using WPEFramework::Plugin::TR181Client;
+
+TEST(TR181ClientTest, immutableCached) {
+    TR181StandIn server;
+    TR181Client client(server.Url());
+
+    string value;
+    EXPECT_TRUE(client.getParameter("Device.DeviceInfo.SerialNumber", value));
+    EXPECT_EQ(string("value-of-Device.DeviceInfo.SerialNumber"), value);
+    EXPECT_TRUE(client.getParameter("Device.DeviceInfo.SerialNumber", value));
+    EXPECT_TRUE(client.getParameter("Device.DeviceInfo.X_COMCAST-COM_STB_MAC", value));
+    EXPECT_TRUE(client.getParameter("Device.DeviceInfo.X_COMCAST-COM_STB_MAC", value));
+    EXPECT_EQ(2u, server.Requests());
+
+    client.invalidate();
+    EXPECT_TRUE(client.getParameter("Device.DeviceInfo.SerialNumber", value));
+    EXPECT_EQ(3u, server.Requests());
+}
+
+TEST(TR181ClientTest, volatileExpires) {
+    TR181StandIn server;
+    TR181Client client(server.Url(), 100);
+
+    string value;
+    EXPECT_TRUE(client.getParameter("Device.DeviceInfo.UpTime", value));
+    EXPECT_TRUE(client.getParameter("Device.DeviceInfo.UpTime", value));
+    EXPECT_EQ(1u, server.Requests());
+
+    std::this_thread::sleep_for(std::chrono::milliseconds(150));
+    EXPECT_TRUE(client.getParameter("Device.DeviceInfo.UpTime", value));
+    EXPECT_EQ(2u, server.Requests());
+}
+
+TEST(TR181ClientTest, partialPathNotCached) {
+    TR181StandIn server;
+    TR181Client client(server.Url());
+
+    JsonArray paramList;
+    EXPECT_TRUE(client.getParameters({ "Device.DeviceInfo." }, paramList));
+    EXPECT_TRUE(client.getParameters({ "Device.DeviceInfo." }, paramList));
+    EXPECT_EQ(2u, server.Requests());
+}
+
+TEST(TR181ClientTest, unknownParameter) {
+    TR181StandIn server;
+    TR181Client client(server.Url());
+
+    JsonArray paramList;
+    EXPECT_TRUE(client.getParameters({ "Device.DeviceInfo.ModelName", "Device.Unknown" }, paramList));
+    EXPECT_EQ(1, paramList.Length());
+
+    string value;
+    EXPECT_FALSE(client.getParameter("Device.Unknown", value));
+}
+
+TEST(TR181ClientTest, serverDown) {
+    string url;
+    {
+        TR181StandIn server;
+        url = server.Url();
+    }
+    TR181Client client(url, TR181_DEFAULT_TTL_MS, 1);
+
+    JsonArray paramList;
+    EXPECT_FALSE(client.getParameters({ "Device.DeviceInfo.ModelName" }, paramList));
+    EXPECT_EQ(0, paramList.Length());
+}
+
+TEST(TR181ClientTest, onlyListedParametersImmutable) {
+    TR181StandIn server;
+    TR181Client client(server.Url(), 100);
+
+    // Dynamic table rows are not device identity, even if they hold a MAC address
+    string value;
+    EXPECT_FALSE(TR181Client::isImmutable("Device.WiFi.AccessPoint.1.AssociatedDevice.3.MACAddress"));
+    EXPECT_FALSE(TR181Client::isImmutable("Device.Ethernet.Interface.1.MACAddress"));
+    EXPECT_TRUE(client.getParameter("Device.Ethernet.Interface.1.MACAddress", value));
+    std::this_thread::sleep_for(std::chrono::milliseconds(150));
+    EXPECT_TRUE(client.getParameter("Device.Ethernet.Interface.1.MACAddress", value));
+    EXPECT_EQ(2u, server.Requests());
+}
+
+TEST(TR181ClientTest, requestOrder) {
+    TR181StandIn server;
+    TR181Client client(server.Url());
+
+    string value;
+    EXPECT_TRUE(client.getParameter("Device.DeviceInfo.ModelName", value));
+
+    // Cached, fetched and partial path parameters come back in the order asked for
+    JsonArray paramList;
+    EXPECT_TRUE(client.getParameters({ "Device.DeviceInfo.UpTime", "Device.Test.", "Device.DeviceInfo.ModelName", "Device.DeviceInfo.SerialNumber" }, paramList));
+    ASSERT_EQ(4, paramList.Length());
+    EXPECT_EQ(string("Device.DeviceInfo.UpTime"), paramList[0].Object()["name"].String());
+    EXPECT_EQ(string("Device.Test."), paramList[1].Object()["name"].String());
+    EXPECT_EQ(string("Device.DeviceInfo.ModelName"), paramList[2].Object()["name"].String());
+    EXPECT_EQ(string("Device.DeviceInfo.SerialNumber"), paramList[3].Object()["name"].String());
+}
+
+TEST(TR181ClientTest, entriesCapped) {
+    TR181StandIn server;
+    TR181Client client(server.Url(), TR181_DEFAULT_TTL_MS, TR181_DEFAULT_TIMEOUT_S, 2);
+
+    string value;
+    EXPECT_TRUE(client.getParameter("Device.DeviceInfo.SerialNumber", value));
+    EXPECT_TRUE(client.getParameter("Device.Test.A", value));
+    // Used again, so the serial number is not the least recently used anymore
+    EXPECT_TRUE(client.getParameter("Device.DeviceInfo.SerialNumber", value));
+    EXPECT_TRUE(client.getParameter("Device.Test.B", value));
+    EXPECT_EQ(3u, server.Requests());
+
+    EXPECT_TRUE(client.getParameter("Device.DeviceInfo.SerialNumber", value));
+    EXPECT_EQ(3u, server.Requests());
+    EXPECT_TRUE(client.getParameter("Device.Test.A", value));
+    EXPECT_EQ(4u, server.Requests());
+}
+
+TEST(TR181ClientTest, concurrentRequestsCoalesced) {
+    TR181StandIn server;
+    TR181Client client(server.Url());
+    server.Hold();
+
+    const int threads = 16;
+    std::atomic<int> succeeded(0);
+    std::list<std::thread> callers;
+    auto call = [&client, &succeeded](int i) {
+        string name = "Device.Test.Parameter" + std::to_string(i);
+        string value;
+        if (client.getParameter(name, value) && (value == "value-of-" + name)) {
+            succeeded++;
+        }
+    };
+
+    // The first caller's request is held by the server, every other caller queues behind it
+    callers.emplace_back(call, 0);
+    while (server.Requests() < 1) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    for (int i = 1; i < threads; i++) {
+        callers.emplace_back(call, i);
+    }
+    while (client.pending() < static_cast<size_t>(threads - 1)) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    server.Release();
+    for (auto& caller : callers) {
+        caller.join();
+    }
+
+    EXPECT_EQ(threads, succeeded.load());
+    EXPECT_EQ(static_cast<uint32_t>(threads), server.Parameters());
+    // The first caller's request, then one batch for all that queued behind it
+    EXPECT_EQ(2u, server.Requests());
+    EXPECT_EQ(1u, server.Connections());
+}
+
+TEST(TR181ClientTest, latency) {
+    TR181StandIn server;
+    TR181Client client(server.Url(), 0);
+    const int iterations = 200;
+    string value;
+
+    auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < iterations; i++) {
+        EXPECT_TRUE(client.getParameter("Device.DeviceInfo.UpTime", value));
+    }
+    auto uncached = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start).count() / iterations;
+
+    start = std::chrono::steady_clock::now();
+    for (int i = 0; i < iterations; i++) {
+        EXPECT_TRUE(client.getParameter("Device.DeviceInfo.SerialNumber", value));
+    }
+    auto cached = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start).count() / iterations;
+
+    RecordProperty("uncachedUs", static_cast<int>(uncached));
+    RecordProperty("cachedUs", static_cast<int>(cached));
+    printf("TR181Client latency: %d us per request, %d us per cached parameter\n", static_cast<int>(uncached), static_cast<int>(cached));
+
+    EXPECT_EQ(static_cast<uint32_t>(iterations + 1), server.Requests());
+    EXPECT_EQ(1u, server.Connections());
+}
+
+} // namespace RdkServicesTest
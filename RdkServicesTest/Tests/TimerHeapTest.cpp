@@ -0,0 +1,154 @@
+/**
+* If not stated otherwise in this file or this component's LICENSE
+* file the following copyright and licenses apply:
+*
+* Copyright 2020 RDK Management
+*
+* Licensed under the Apache License, Version 2.0 (the "License");
+* you may not use this file except in compliance with the License.
+* You may obtain a copy of the License at
+*
+* http://www.apache.org/licenses/LICENSE-2.0
+*
+* Unless required by applicable law or agreed to in writing, software
+* distributed under the License is distributed on an "AS IS" BASIS,
+* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+* See the License for the specific language governing permissions and
+* limitations under the License.
+**/
+
+
+#include "gtest/gtest.h"
+
+#include "TimerHeap.h"
+
+#include <algorithm>
+#include <chrono>
+#include <random>
+#include <set>
+#include <vector>
+
+namespace RdkServicesTest {
+
+using WPEFramework::Plugin::TimerHeap;
+
+namespace {
+
+TimerHeap::TimePoint At(uint32_t ms)
+{
+    return TimerHeap::TimePoint(std::chrono::milliseconds(ms));
+}
+
+} // namespace
+
+TEST(TimerHeapTest, heapOrdering) {
+    TimerHeap heap;
+    std::mt19937 random(7);
+
+    std::vector<int> ids;
+    for (int i = 0; i < 1000; i++) {
+        ids.push_back(heap.allocate());
+        heap.push(ids.back(), At(random() % 100000));
+    }
+    EXPECT_EQ(1000u, heap.size());
+
+    // Cancelled from the middle of the heap, and re-armed with a new event
+    for (int i = 0; i < 1000; i += 3) {
+        EXPECT_TRUE(heap.remove(ids[i]));
+        EXPECT_FALSE(heap.isQueued(ids[i]));
+        EXPECT_FALSE(heap.remove(ids[i]));
+    }
+    for (int i = 0; i < 1000; i += 6) {
+        heap.push(ids[i], At(random() % 100000));
+    }
+    heap.push(ids[1], At(5));
+    EXPECT_EQ(ids[1], heap.top());
+    EXPECT_EQ(1000u - 334u + 167u, heap.size());
+
+    TimerHeap::TimePoint last = At(0);
+    size_t popped = 0;
+    while (!heap.empty()) {
+        int id = heap.top();
+        EXPECT_GE(heap.topEvent(), last);
+        last = heap.topEvent();
+        EXPECT_TRUE(heap.remove(id));
+        popped++;
+    }
+    EXPECT_EQ(1000u - 334u + 167u, popped);
+}
+
+TEST(TimerHeapTest, idRecycling) {
+    TimerHeap heap;
+
+    int first = heap.allocate();
+    heap.push(first, At(10));
+    heap.remove(first);
+    heap.retire(first);
+
+    // Finished timers stay valid until TIMER_HEAP_RETIRED_MAX newer ones finished
+    std::vector<int> ids;
+    for (int i = 0; i < TIMER_HEAP_RETIRED_MAX; i++) {
+        ids.push_back(heap.allocate());
+        EXPECT_NE(first, ids.back());
+    }
+    for (int id : ids) {
+        EXPECT_TRUE(heap.isValid(id));
+        heap.retire(id);
+    }
+    EXPECT_TRUE(heap.isValid(ids.front()));
+    EXPECT_FALSE(heap.isValid(first));
+    EXPECT_FALSE(heap.isValid(heap.ids()));
+
+    int recycled = heap.allocate();
+    EXPECT_EQ(first, recycled);
+    EXPECT_TRUE(heap.isValid(recycled));
+    EXPECT_FALSE(heap.isQueued(recycled));
+
+    // Starting and finishing timers forever does not grow the table
+    for (int i = 0; i < 10000; i++) {
+        int id = heap.allocate();
+        heap.push(id, At(i));
+        heap.remove(id);
+        heap.retire(id);
+    }
+    EXPECT_LE(heap.ids(), static_cast<size_t>(TIMER_HEAP_RETIRED_MAX + 2));
+    EXPECT_TRUE(heap.empty());
+}
+
+TEST(TimerHeapTest, insertCancel) {
+    // The cost per operation, against the list the Timer plugin used before, is measured by RdkServicesBenchmark
+    const uint32_t timers = 100000;
+    TimerHeap heap;
+    std::mt19937 random(42);
+
+    std::vector<int> ids;
+    std::vector<TimerHeap::TimePoint> events;
+    std::multiset<TimerHeap::TimePoint> running;
+    for (uint32_t i = 0; i < timers; i++) {
+        ids.push_back(heap.allocate());
+        TimerHeap::TimePoint nextEvent = At(random() % 86400000);
+        if ((size_t)ids.back() >= events.size())
+            events.resize(ids.back() + 1);
+        events[ids.back()] = nextEvent;
+        running.insert(nextEvent);
+        heap.push(ids.back(), nextEvent);
+    }
+    EXPECT_EQ(timers, heap.size());
+
+    // Cancelled in random order, the nearest left stays on top
+    std::shuffle(ids.begin(), ids.end(), random);
+    uint32_t removed = 0;
+    for (uint32_t i = 0; i < timers; i++) {
+        if (heap.remove(ids[i]))
+            removed++;
+        running.erase(running.find(events[ids[i]]));
+        if ((i % 1000) == 0 && !heap.empty()) {
+            EXPECT_FALSE(heap.isQueued(ids[i]));
+            EXPECT_TRUE(*running.begin() == events[heap.top()]);
+        }
+    }
+    EXPECT_EQ(timers, removed);
+    EXPECT_TRUE(heap.empty());
+}
+
+} // namespace RdkServicesTest
@@ -0,0 +1,181 @@
+/**
+* If not stated otherwise in this file or this component's LICENSE
+* file the following copyright and licenses apply:
+*
+* Copyright 2020 RDK Management
+*
+* Licensed under the Apache License, Version 2.0 (the "License");
+* you may not use this file except in compliance with the License.
+* You may obtain a copy of the License at
+*
+* http://www.apache.org/licenses/LICENSE-2.0
+*
+* Unless required by applicable law or agreed to in writing, software
+* distributed under the License is distributed on an "AS IS" BASIS,
+* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+* See the License for the specific language governing permissions and
+* limitations under the License.
+**/
+
+#include "gtest/gtest.h"
+
+#include "UsbFileIndex.h"
+
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <ftw.h>
+#include <unistd.h>
+#include <dirent.h>
+
+#include <chrono>
+#include <set>
+#include <thread>
+
+namespace RdkServicesTest {
+
+using WPEFramework::Plugin::UsbFileIndex;
+
+namespace {
+
+const char* kPattern = "[\\w-]*\\.{0,1}[\\w-]*\\.(png|jpg|jpeg|tiff|tif|bmp|mp4|mov|avi|mp3|wav|m4a|flac|mp4|aac|wma|txt|bin|enc|ts)";
+
+// Temporary directory tree, removed with everything in it
+class GeneratedTree {
+public:
+    GeneratedTree()
+    {
+        char path[] = "/tmp/UsbFileIndexTestXXXXXX";
+        _root = mkdtemp(path);
+    }
+    ~GeneratedTree()
+    {
+        nftw(_root.c_str(), [](const char* path, const struct stat*, int, struct FTW*) { return ::remove(path); }, 16, FTW_DEPTH | FTW_PHYS);
+    }
+
+    const std::string& Root() const
+    {
+        return _root;
+    }
+    std::string Directory(const std::string& name)
+    {
+        std::string path = _root + "/" + name;
+        mkdir(path.c_str(), 0755);
+        return path;
+    }
+    static void Touch(const std::string& path)
+    {
+        int fd = ::open(path.c_str(), O_CREAT | O_WRONLY, 0644);
+        if (fd >= 0) {
+            ::close(fd);
+        }
+    }
+    // Every other file matches the pattern
+    static void Populate(const std::string& directory, int count)
+    {
+        for (int i = 0; i < count; i++) {
+            Touch(directory + "/file" + std::to_string(i) + ((i % 2) == 0 ? ".jpg" : ".dat"));
+        }
+    }
+
+private:
+    std::string _root;
+};
+
+} // namespace
+
+TEST(UsbFileIndexTest, pagesFromOneSnapshot) {
+    GeneratedTree tree;
+    GeneratedTree::Populate(tree.Root(), 100);
+    UsbFileIndex index(kPattern, false);
+
+    UsbFileIndex::SnapshotPtr first;
+    ASSERT_TRUE(index.list(tree.Root(), first));
+    EXPECT_EQ(50u, first->files.size());
+
+    // Changes after the first page do not show up in the pages taken with its cursor
+    GeneratedTree::Touch(tree.Root() + "/added.jpg");
+
+    UsbFileIndex::SnapshotPtr paged;
+    ASSERT_TRUE(index.find(first->cursor, paged));
+    EXPECT_EQ(first.get(), paged.get());
+
+    UsbFileIndex::SnapshotPtr current;
+    ASSERT_TRUE(index.list(tree.Root(), current));
+    EXPECT_NE(first->cursor, current->cursor);
+    EXPECT_EQ(51u, current->files.size());
+    EXPECT_TRUE(index.find(first->cursor, paged));
+}
+
+TEST(UsbFileIndexTest, unchangedDirectoryCached) {
+    GeneratedTree tree;
+    GeneratedTree::Populate(tree.Root(), 10);
+    UsbFileIndex index(kPattern, true);
+
+    UsbFileIndex::SnapshotPtr first, second;
+    ASSERT_TRUE(index.list(tree.Root(), first));
+    ASSERT_TRUE(index.list(tree.Root(), second));
+    EXPECT_EQ(first.get(), second.get());
+    EXPECT_EQ(1u, index.cachedDirectories());
+
+    EXPECT_FALSE(index.list(tree.Root() + "/missing", second));
+}
+
+TEST(UsbFileIndexTest, invalidateDropsCursors) {
+    GeneratedTree tree;
+    GeneratedTree::Populate(tree.Root(), 10);
+    UsbFileIndex index(kPattern, true);
+
+    UsbFileIndex::SnapshotPtr snapshot;
+    ASSERT_TRUE(index.list(tree.Root(), snapshot));
+    index.invalidate();
+
+    UsbFileIndex::SnapshotPtr found;
+    EXPECT_FALSE(index.find(snapshot->cursor, found));
+    EXPECT_EQ(0u, index.cachedDirectories());
+}
+
+TEST(UsbFileIndexTest, indexerReadsSubdirectories) {
+    GeneratedTree tree;
+    GeneratedTree::Populate(tree.Directory("photos"), 10);
+    GeneratedTree::Populate(tree.Directory("music"), 10);
+    UsbFileIndex index(kPattern, true);
+
+    index.index({ tree.Root() });
+    for (int i = 0; i < 100 && index.cachedDirectories() < 3; i++) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    }
+    EXPECT_EQ(3u, index.cachedDirectories());
+}
+
+TEST(UsbFileIndexTest, matchesPerEntryListing) {
+    // How much sooner the precompiled and cached listings are is measured by RdkServicesBenchmark
+    const int files = 2000;
+    GeneratedTree tree;
+    GeneratedTree::Populate(tree.Root(), files);
+    GeneratedTree::Touch(tree.Root() + "/no-extension");
+    tree.Directory("photos");
+    UsbFileIndex index(kPattern, true);
+
+    // The listing as it was made before, with the pattern compiled for every entry
+    std::set<std::string> expected;
+    DIR* dirp = opendir(tree.Root().c_str());
+    ASSERT_NE(nullptr, dirp);
+    struct dirent* dp;
+    while ((dp = readdir(dirp)) != nullptr) {
+        if ((dp->d_type == DT_DIR) || std::regex_match(dp->d_name, std::regex(kPattern, std::regex_constants::icase))) {
+            expected.insert(dp->d_name);
+        }
+    }
+    closedir(dirp);
+
+    UsbFileIndex::SnapshotPtr snapshot;
+    ASSERT_TRUE(index.list(tree.Root(), snapshot));
+    std::set<std::string> listed;
+    for (const UsbFileIndex::FileEnt& file : snapshot->files) {
+        listed.insert(file.filename);
+    }
+    EXPECT_EQ(expected, listed);
+    EXPECT_EQ(expected.size(), snapshot->files.size());
+}
+
+} // namespace RdkServicesTest
@@ -0,0 +1,211 @@
+/**
+* If not stated otherwise in this file or this component's LICENSE
+* file the following copyright and licenses apply:
+*
+* Copyright 2020 RDK Management
+*
+* Licensed under the Apache License, Version 2.0 (the "License");
+* you may not use this file except in compliance with the License.
+* You may obtain a copy of the License at
+*
+* http://www.apache.org/licenses/LICENSE-2.0
+*
+* Unless required by applicable law or agreed to in writing, software
+* distributed under the License is distributed on an "AS IS" BASIS,
+* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+* See the License for the specific language governing permissions and
+* limitations under the License.
+**/
+
+#include "gtest/gtest.h"
+
+#include "WarmPool.h"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <thread>
+
+namespace RdkServicesTest {
+
+using WPEFramework::Plugin::WarmPool;
+
+namespace {
+
+const uint32_t plentyKb = 1024 * 1024;
+
+// As RDKShell::fillWarmPool does, every launch succeeding
+uint32_t Fill(WarmPool& pool, uint32_t freeKb, uint32_t instanceKb = 0)
+{
+    uint32_t started = 0;
+    if (!pool.requestFill())
+        return started;
+
+    WarmPool::Instance instance;
+    while (pool.next(freeKb, instance)) {
+        if (pool.started(instance.callsign, true)) {
+            started++;
+            freeKb -= std::min(freeKb, instanceKb);
+        } else {
+            pool.release(instance.callsign);
+        }
+    }
+    pool.leave();
+    return started;
+}
+
+} // namespace
+
+TEST(WarmPoolTest, fillAndTake) {
+    WarmPool pool;
+    EXPECT_TRUE(pool.configure({ { "HtmlApp", 2 }, { "LightningApp", 1 } }, 100000).empty());
+
+    // Not below the free memory minimum
+    EXPECT_EQ(0u, Fill(pool, 50000));
+    EXPECT_EQ(3u, Fill(pool, plentyKb));
+    EXPECT_FALSE(pool.requestFill());
+    EXPECT_TRUE(pool.isPooled("HtmlApp_warm0"));
+    EXPECT_TRUE(pool.isPooled("HtmlApp_warm1"));
+    EXPECT_TRUE(pool.isPooled("LightningApp_warm0"));
+
+    std::string callsign;
+    EXPECT_TRUE(pool.take("HtmlApp", callsign));
+    EXPECT_EQ("HtmlApp_warm0", callsign);
+    EXPECT_FALSE(pool.isPooled(callsign));
+    EXPECT_FALSE(pool.take("Cobalt", callsign));
+    EXPECT_TRUE(pool.take("LightningApp", callsign));
+    EXPECT_FALSE(pool.take("LightningApp", callsign));
+
+    // The callsign of a launched instance is not reused until it is destroyed
+    EXPECT_EQ(2u, Fill(pool, plentyKb));
+    EXPECT_TRUE(pool.isPooled("HtmlApp_warm2"));
+    pool.release("HtmlApp_warm0");
+    EXPECT_TRUE(pool.take("HtmlApp", callsign));
+    EXPECT_EQ(1u, Fill(pool, plentyKb));
+    EXPECT_TRUE(pool.isPooled("HtmlApp_warm0"));
+
+    WarmPool::Stats stats = pool.stats();
+    EXPECT_EQ(3u, stats.hits);
+    EXPECT_EQ(1u, stats.misses);
+
+    // Memory used by each instance
+    WarmPool limited;
+    limited.configure({ { "HtmlApp", 4 } }, 100000);
+    EXPECT_EQ(3u, Fill(limited, 250000, 70000));
+}
+
+TEST(WarmPoolTest, lowMemoryAndPolicy) {
+    WarmPool pool;
+    pool.configure({ { "HtmlApp", 2 }, { "LightningApp", 1 } }, 0);
+    EXPECT_EQ(3u, Fill(pool, plentyKb));
+
+    // One starting while the warning arrives
+    std::string callsign;
+    pool.take("LightningApp", callsign);
+    ASSERT_TRUE(pool.requestFill());
+    WarmPool::Instance instance;
+    ASSERT_TRUE(pool.next(plentyKb, instance));
+
+    std::vector<std::string> evicted = pool.setLowMemory(true);
+    EXPECT_EQ(2u, evicted.size());
+    EXPECT_FALSE(pool.started(instance.callsign, true));
+    EXPECT_FALSE(pool.next(plentyKb, instance));
+    for (const std::string& evictedCallsign : evicted)
+        pool.release(evictedCallsign);
+    pool.release(instance.callsign);
+    EXPECT_FALSE(pool.requestFill());
+    EXPECT_FALSE(pool.take("HtmlApp", callsign));
+
+    pool.setLowMemory(false);
+    EXPECT_EQ(3u, Fill(pool, plentyKb));
+
+    // Fewer instances, and a type not pooled anymore
+    evicted = pool.configure({ { "HtmlApp", 1 } }, 0);
+    EXPECT_EQ(2u, evicted.size());
+    // Two on low RAM, the one started meanwhile and these two
+    EXPECT_EQ(5u, pool.stats().evictions);
+
+    // A type that fails to launch is not retried within the fill
+    WarmPool failing;
+    failing.configure({ { "HtmlApp", 2 } }, 0);
+    ASSERT_TRUE(failing.requestFill());
+    ASSERT_TRUE(failing.next(plentyKb, instance));
+    EXPECT_FALSE(failing.started(instance.callsign, false));
+    failing.release(instance.callsign);
+    EXPECT_FALSE(failing.next(plentyKb, instance));
+    EXPECT_EQ(1u, failing.stats().failures);
+}
+
+TEST(WarmPoolTest, shutdown) {
+    WarmPool pool;
+    pool.configure({ { "HtmlApp", 2 } }, 0);
+
+    // A fill launching its first instance while the plugin goes down
+    ASSERT_TRUE(pool.requestFill());
+    WarmPool::Instance instance;
+    ASSERT_TRUE(pool.next(plentyKb, instance));
+    ASSERT_TRUE(pool.enter());
+
+    std::atomic<bool> down(false);
+    std::thread deinitialize([&]() {
+        pool.shutdown();
+        down = true;
+    });
+    std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    EXPECT_FALSE(down);
+
+    EXPECT_TRUE(pool.started(instance.callsign, true));
+    EXPECT_FALSE(pool.next(plentyKb, instance));
+    pool.leave();
+    std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    EXPECT_FALSE(down);
+    pool.leave();
+    deinitialize.join();
+    EXPECT_TRUE(down);
+
+    EXPECT_FALSE(pool.requestFill());
+    EXPECT_FALSE(pool.enter());
+    pool.resume();
+    EXPECT_EQ(1u, Fill(pool, plentyKb));
+}
+
+TEST(WarmPoolTest, sessionBenchmark) {
+    // An evening of launches from the home screen, a new app every few minutes. Between launches
+    // the pool is refilled, unless a low RAM warning is active (launches 12-17).
+    const char* const types[] = { "HtmlApp", "LightningApp", "HtmlApp", "HtmlApp", "LightningApp" };
+    const int launches = 40;
+
+    WarmPool pool;
+    pool.configure({ { "HtmlApp", 1 }, { "LightningApp", 1 } }, 0);
+    Fill(pool, plentyKb);
+
+    uint32_t coldLaunches = 0;
+    for (int i = 0; i < launches; i++) {
+        bool lowRam = (i >= 12 && i < 18);
+        for (const std::string& callsign : pool.setLowMemory(lowRam))
+            pool.release(callsign);
+
+        std::string callsign;
+        if (!pool.take(types[i % 5], callsign))
+            coldLaunches++;
+        else
+            // The app is closed before the next one is launched
+            pool.release(callsign);
+        Fill(pool, plentyKb);
+    }
+
+    WarmPool::Stats stats = pool.stats();
+    printf("%d launches of pooled types: %d cold launches (clone, activate, process spin-up) without the pool, "
+        "%u with one warm HtmlApp and LightningApp; %u instances evicted on low RAM\n",
+        launches, launches, coldLaunches, stats.evictions);
+    RecordProperty("coldLaunchesWithoutPool", launches);
+    RecordProperty("coldLaunchesWithPool", static_cast<int>(coldLaunches));
+
+    EXPECT_EQ(static_cast<uint32_t>(launches), stats.hits + stats.misses);
+    // Those while the warning is active and the first one after it, before the refill
+    EXPECT_EQ(7u, coldLaunches);
+    EXPECT_EQ(2u, stats.evictions);
+}
+
+} // namespace RdkServicesTest
@@ -0,0 +1,234 @@
+/**
+* If not stated otherwise in this file or this component's LICENSE
+* file the following copyright and licenses apply:
+*
+* Copyright 2020 RDK Management
+*
+* Licensed under the Apache License, Version 2.0 (the "License");
+* you may not use this file except in compliance with the License.
+* You may obtain a copy of the License at
+*
+* http://www.apache.org/licenses/LICENSE-2.0
+*
+* Unless required by applicable law or agreed to in writing, software
+* distributed under the License is distributed on an "AS IS" BASIS,
+* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+* See the License for the specific language governing permissions and
+* limitations under the License.
+**/
+
+#include "gtest/gtest.h"
+
+#include "WifiManagerScanStore.h"
+
+#include <cstdio>
+#include <regex>
+#include <vector>
+
+namespace RdkServicesTest {
+
+using WPEFramework::Plugin::WifiManagerScanStore;
+using WPEFramework::Plugin::WifiNetwork;
+using WPEFramework::Plugin::WifiScanFilter;
+
+namespace {
+
+WifiNetwork Network(const std::string& bssid, const std::string& ssid, int signal, const std::string& frequency = "2.437000")
+{
+    WifiNetwork network;
+    network.bssid = bssid;
+    network.ssid = ssid;
+    network.security = 6;
+    network.signalStrength = std::to_string(signal) + ".000000";
+    network.frequency = frequency;
+    return network;
+}
+
+// A block of flats: 240 access points, most of them with an ISP's default SSID, on both bands
+struct Apartment {
+    struct AccessPoint {
+        WifiNetwork network;
+        int signal;
+    };
+    std::vector<AccessPoint> accessPoints;
+
+    Apartment()
+    {
+        const char* const isps[] = { "SKY", "BTHub6-", "VM", "TALKTALK", "EE-", "PLUSNET-" };
+        for (int i = 0; i < 240; i++) {
+            char bssid[18];
+            snprintf(bssid, sizeof(bssid), "a4:%02x:%02x:%02x:%02x:%02x", i % 6, (i * 37) & 0xff, (i * 101) & 0xff, i & 0xff, (i % 2) ? 0x1f : 0x1e);
+            char ssid[32];
+            snprintf(ssid, sizeof(ssid), "%s%04X", isps[i % 6], (i / 2) * 2654435761u >> 16);
+            AccessPoint accessPoint;
+            // Dual band routers share the SSID
+            accessPoint.network = Network(bssid, (i % 10 == 9) ? "Guest" : ssid, 0, (i % 2) ? "5.180000" : "2.437000");
+            accessPoint.signal = -35 - static_cast<int>((i * 7919) % 58);
+            accessPoints.push_back(accessPoint);
+        }
+    }
+
+    // The three events of an incremental scan (high priority 5 GHz, 2.4 GHz, low priority 5 GHz), each
+    // with the networks found so far. Signals jitter by up to 3 dBm and the weakest are missed now and then.
+    std::vector<std::vector<WifiNetwork>> scan(uint32_t scanNumber) const
+    {
+        std::vector<std::vector<WifiNetwork>> events(3);
+        std::vector<WifiNetwork> found;
+        for (int stage = 0; stage < 3; stage++) {
+            for (size_t i = 0; i < accessPoints.size(); i++) {
+                const AccessPoint& accessPoint = accessPoints[i];
+                bool fiveGhz = (i % 2) == 1;
+                bool highPriority = accessPoint.signal > -70;
+                int inStage = fiveGhz ? (highPriority ? 0 : 2) : 1;
+                if (inStage != stage) {
+                    continue;
+                }
+                uint32_t noise = (scanNumber * 2654435761u) ^ (static_cast<uint32_t>(i) * 40503u);
+                if (accessPoint.signal < -85 && (noise % 5) < 2) {
+                    continue;
+                }
+                WifiNetwork network = accessPoint.network;
+                network.signalStrength = std::to_string(accessPoint.signal + static_cast<int>(noise % 7) - 3) + ".000000";
+                found.push_back(network);
+            }
+            events[stage] = found;
+        }
+        return events;
+    }
+};
+
+} // namespace
+
+TEST(WifiManagerScanStoreTest, filter) {
+    WifiScanFilter filter;
+    EXPECT_TRUE(filter.matches(Network("", "anything", -40)));
+
+    filter.set("SKY.*", "");
+    EXPECT_TRUE(filter.isRegex());
+    EXPECT_TRUE(filter.matches(Network("", "SKY1234", -40)));
+    EXPECT_FALSE(filter.matches(Network("", "BTHub6-1234", -40)));
+
+    // Not a regular expression, so a literal SSID
+    filter.set("Cafe (Free", "");
+    EXPECT_FALSE(filter.isRegex());
+    EXPECT_TRUE(filter.matches(Network("", "Cafe (Free", -40)));
+    EXPECT_FALSE(filter.matches(Network("", "Cafe", -40)));
+
+    filter.set("", "5.180000");
+    EXPECT_TRUE(filter.matches(Network("", "SKY1234", -40, "5.180000")));
+    EXPECT_FALSE(filter.matches(Network("", "SKY1234", -40, "2.437000")));
+}
+
+TEST(WifiManagerScanStoreTest, mergeAndAge) {
+    WifiManagerScanStore store;
+    WifiManagerScanStore::Delta delta;
+
+    // Incremental events overlap
+    store.merge({ Network("01", "Home", -40), Network("02", "Home", -60, "5.180000") }, true, 0, delta);
+    EXPECT_EQ(2u, delta.added.size());
+    store.merge({ Network("01", "Home", -42), Network("02", "Home", -60, "5.180000"), Network("03", "Neighbour", -80) }, false, 100, delta);
+    EXPECT_EQ(3u, delta.matched.size());
+    ASSERT_EQ(1u, delta.added.size());
+    EXPECT_EQ("03", delta.added[0].bssid);
+    EXPECT_TRUE(delta.changed.empty());
+    EXPECT_TRUE(delta.removed.empty());
+    EXPECT_EQ(1u, store.completeScans());
+
+    // A 2 dBm wobble is no change, 10 dBm is; the neighbour is missed once
+    store.merge({ Network("01", "Home", -44), Network("02", "Home", -70, "5.180000") }, false, 10000, delta);
+    ASSERT_EQ(1u, delta.changed.size());
+    EXPECT_EQ("02", delta.changed[0].bssid);
+    EXPECT_TRUE(delta.removed.empty());
+    EXPECT_EQ(3u, store.size());
+
+    // ...and missed twice it is gone
+    store.merge({ Network("01", "Home", -44), Network("02", "Home", -70, "5.180000") }, false, 20000, delta);
+    EXPECT_TRUE(delta.changed.empty());
+    ASSERT_EQ(1u, delta.removed.size());
+    EXPECT_EQ("03", delta.removed[0].bssid);
+    EXPECT_EQ(2u, store.size());
+
+    // Without BSSIDs, keyed by SSID and frequency
+    store.merge({ Network("", "Cafe", -50), Network("", "Cafe", -55, "5.180000") }, false, 30000, delta);
+    EXPECT_EQ(2u, delta.added.size());
+    EXPECT_EQ(4u, store.size());
+
+    // Not seen for WIFI_SCAN_MAX_AGE_MS, and not in the latest scan either
+    store.merge({ Network("01", "Home", -44) }, false, 30000 + WIFI_SCAN_MAX_AGE_MS, delta);
+    EXPECT_EQ(3u, delta.removed.size());
+    EXPECT_EQ(1u, store.size());
+
+    // The filter applies to what is reported; the next scan reports everything again
+    EXPECT_TRUE(store.setFilter("Ho.*", ""));
+    EXPECT_FALSE(store.setFilter("Ho.*", ""));
+    store.resetReported();
+    store.merge({ Network("01", "Home", -44), Network("04", "Office", -50) }, false, 40000 + WIFI_SCAN_MAX_AGE_MS, delta);
+    ASSERT_EQ(1u, delta.added.size());
+    EXPECT_EQ("01", delta.added[0].bssid);
+    EXPECT_EQ(1u, delta.matched.size());
+}
+
+TEST(WifiManagerScanStoreTest, replay) {
+    const uint32_t scans = 20;
+    const std::string ssidFilter = "[A-Z]+-?[0-9A-F]{4}";
+    Apartment apartment;
+
+    std::vector<std::vector<std::vector<WifiNetwork>>> replay;
+    size_t events = 0;
+    size_t received = 0;
+    for (uint32_t scan = 0; scan < scans; scan++) {
+        replay.push_back(apartment.scan(scan));
+        for (auto& event : replay.back()) {
+            events++;
+            received += event.size();
+        }
+    }
+
+    // As applyFilter did: a regular expression built for each event, and every matching network sent again
+    size_t sentBefore = 0;
+    size_t regexRunsBefore = 0;
+    for (auto& scan : replay) {
+        for (auto& event : scan) {
+            std::regex re(ssidFilter);
+            std::vector<WifiNetwork> result;
+            for (auto& network : event) {
+                regexRunsBefore++;
+                if (std::regex_match(network.ssid, re)) {
+                    result.push_back(network);
+                }
+            }
+            sentBefore += result.size();
+        }
+    }
+
+    WifiManagerScanStore store;
+    WifiManagerScanStore::Delta delta;
+    size_t sentMatched = 0;
+    size_t sentDelta = 0;
+    store.setFilter(ssidFilter, "");
+    uint64_t nowMs = 0;
+    for (auto& scan : replay) {
+        for (size_t i = 0; i < scan.size(); i++) {
+            store.merge(scan[i], i + 1 < scan.size(), nowMs, delta);
+            sentMatched += delta.matched.size();
+            sentDelta += delta.added.size() + delta.changed.size() + delta.removed.size();
+        }
+        nowMs += 10000;
+    }
+
+    printf("WifiManager scan replay, %u scans of %zu access points, %zu events with %zu networks: "
+        "%zu regex matches and %zu networks sent before; %u regex matches and %zu networks sent (%zu as deltas) with the store\n",
+        scans, apartment.accessPoints.size(), events, received,
+        regexRunsBefore, sentBefore, store.filterRuns(), sentMatched, sentDelta);
+    RecordProperty("regexRunsBefore", static_cast<int>(regexRunsBefore));
+    RecordProperty("regexRunsStore", static_cast<int>(store.filterRuns()));
+    RecordProperty("networksSentDelta", static_cast<int>(sentDelta));
+
+    // The store filters the same networks
+    EXPECT_EQ(sentBefore, sentMatched);
+    // An access point's SSID is matched once, and again only if it was gone for a while
+    EXPECT_LT(store.filterRuns() * 10, regexRunsBefore);
+    EXPECT_LT(sentDelta * 5, sentBefore);
+}
+
+} // namespace RdkServicesTest
@@ -0,0 +1,162 @@
+/**
+* If not stated otherwise in this file or this component's LICENSE
+* file the following copyright and licenses apply:
+*
+* Copyright 2020 RDK Management
+*
+* Licensed under the Apache License, Version 2.0 (the "License");
+* you may not use this file except in compliance with the License.
+* You may obtain a copy of the License at
+*
+* http://www.apache.org/licenses/LICENSE-2.0
+*
+* Unless required by applicable law or agreed to in writing, software
+* distributed under the License is distributed on an "AS IS" BASIS,
+* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+* See the License for the specific language governing permissions and
+* limitations under the License.
+**/
+
+#include "gtest/gtest.h"
+
+#include "WifiManagerSignalMonitor.h"
+
+#include <cstdio>
+#include <string>
+
+namespace RdkServicesTest {
+
+using WPEFramework::Plugin::WifiManagerSignalMonitor;
+
+namespace {
+
+const int hourMs = 3600 * 1000;
+
+// An hour of a TV connected to the same access point: the signal jitters by up to 3 dB around -56 dBm,
+// sits on the 'Good'/'Excellent' threshold for ten minutes while a door is open, and drops for a minute
+// while the microwave is on. The second half hour the device is in standby.
+float SignalAt(int nowMs)
+{
+    int minute = nowMs / 60000;
+    int jitter = static_cast<int>((static_cast<uint32_t>(nowMs / 100) * 2654435761u) >> 29) - 3; // -3..4
+    if (minute >= 10 && minute < 20)
+        return -50.0f + jitter * 0.5f;
+    if (minute == 25)
+        return -72.0f + jitter;
+    return -56.0f + jitter;
+}
+
+struct Hour {
+    uint32_t samples = 0;
+    uint32_t samplesStandby = 0;
+    uint32_t reported = 0;
+};
+
+// As WifiManagerSignalThreshold::loop does
+Hour Simulate(int intervalMs, bool adaptive)
+{
+    WifiManagerSignalMonitor monitor;
+    monitor.reset(intervalMs, adaptive);
+
+    Hour hour;
+    for (int nowMs = 0; nowMs < hourMs; nowMs += monitor.nextIntervalMs()) {
+        bool standby = nowMs >= hourMs / 2;
+        monitor.setStandby(standby);
+        if (monitor.sample(SignalAt(nowMs)))
+            hour.reported++;
+        hour.samples++;
+        if (standby)
+            hour.samplesStandby++;
+    }
+    EXPECT_EQ(hour.samples, monitor.samples());
+    return hour;
+}
+
+} // namespace
+
+TEST(WifiManagerSignalMonitorTest, strength) {
+    EXPECT_EQ(std::string("Excellent"), WifiManagerSignalMonitor::strengthOf(-50.0f));
+    EXPECT_EQ(std::string("Good"), WifiManagerSignalMonitor::strengthOf(-50.5f));
+    EXPECT_EQ(std::string("Good"), WifiManagerSignalMonitor::strengthOf(-60.0f));
+    EXPECT_EQ(std::string("Fair"), WifiManagerSignalMonitor::strengthOf(-67.0f));
+    EXPECT_EQ(std::string("Weak"), WifiManagerSignalMonitor::strengthOf(-67.5f));
+    // No signal strength reported
+    EXPECT_EQ(std::string("Weak"), WifiManagerSignalMonitor::strengthOf(0.0f));
+
+    WifiManagerSignalMonitor monitor;
+    monitor.reset(2000, false);
+    EXPECT_TRUE(monitor.sample(-51.0f));
+    EXPECT_EQ("Good", monitor.strength());
+    EXPECT_FALSE(monitor.sample(-52.0f));
+    EXPECT_TRUE(monitor.sample(-49.0f));
+    EXPECT_TRUE(monitor.sample(-51.0f));
+    EXPECT_EQ(2000, monitor.nextIntervalMs());
+
+    // Adaptive, the signal has to be WIFI_SIGNAL_HYSTERESIS_DBM into another band
+    monitor.reset(2000, true);
+    EXPECT_TRUE(monitor.sample(-51.0f));
+    EXPECT_FALSE(monitor.sample(-49.0f));
+    EXPECT_EQ("Good", monitor.strength());
+    EXPECT_TRUE(monitor.sample(-47.0f));
+    EXPECT_EQ("Excellent", monitor.strength());
+    EXPECT_FALSE(monitor.sample(-51.0f));
+    // Straight from 'Excellent' to 'Fair'
+    EXPECT_TRUE(monitor.sample(-64.0f));
+    EXPECT_EQ("Fair", monitor.strength());
+    EXPECT_TRUE(monitor.sample(0.0f));
+    EXPECT_EQ("Weak", monitor.strength());
+}
+
+TEST(WifiManagerSignalMonitorTest, interval) {
+    WifiManagerSignalMonitor monitor;
+    monitor.reset(2000, true);
+
+    EXPECT_TRUE(monitor.sample(-56.0f));
+    EXPECT_EQ(2000, monitor.nextIntervalMs());
+    for (int i = 0; i < WIFI_SIGNAL_STABLE_SAMPLES; i++)
+        monitor.sample(-56.0f);
+    EXPECT_EQ(4000, monitor.nextIntervalMs());
+    for (int i = 0; i < 10 * WIFI_SIGNAL_STABLE_SAMPLES; i++)
+        monitor.sample(-56.0f);
+    EXPECT_EQ(2000 * WIFI_SIGNAL_MAX_BACKOFF, monitor.nextIntervalMs());
+
+    // Close to a threshold
+    monitor.sample(-59.0f);
+    EXPECT_EQ(2000, monitor.nextIntervalMs());
+    monitor.sample(-56.0f);
+    EXPECT_EQ(2000 * WIFI_SIGNAL_MAX_BACKOFF, monitor.nextIntervalMs());
+
+    monitor.setStandby(true);
+    EXPECT_EQ(WIFI_SIGNAL_STANDBY_INTERVAL_MS, monitor.nextIntervalMs());
+    monitor.setStandby(false);
+    EXPECT_EQ(2000, monitor.nextIntervalMs());
+
+    // A long interval is not shortened
+    monitor.reset(WIFI_SIGNAL_MAX_INTERVAL_MS * 2, true);
+    for (int i = 0; i < 10 * WIFI_SIGNAL_STABLE_SAMPLES; i++)
+        monitor.sample(-56.0f);
+    EXPECT_EQ(WIFI_SIGNAL_MAX_INTERVAL_MS * 2, monitor.nextIntervalMs());
+}
+
+TEST(WifiManagerSignalMonitorTest, hourBenchmark) {
+    const int intervalMs = 2000;
+    Hour fixed = Simulate(intervalMs, false);
+    Hour adaptive = Simulate(intervalMs, true);
+
+    printf("WifiManager signal threshold, an hour at a %d ms interval, half of it in standby: "
+        "%u getConnectedSSID IARM calls (%u in standby), %u events with a fixed interval; "
+        "%u IARM calls (%u in standby), %u events adaptive; %u IARM calls saved per hour\n",
+        intervalMs, fixed.samples, fixed.samplesStandby, fixed.reported,
+        adaptive.samples, adaptive.samplesStandby, adaptive.reported, fixed.samples - adaptive.samples);
+    RecordProperty("iarmCallsFixed", static_cast<int>(fixed.samples));
+    RecordProperty("iarmCallsAdaptive", static_cast<int>(adaptive.samples));
+
+    EXPECT_EQ(static_cast<uint32_t>(hourMs / intervalMs), fixed.samples);
+    EXPECT_LE(adaptive.samplesStandby, static_cast<uint32_t>(hourMs / 2 / WIFI_SIGNAL_STANDBY_INTERVAL_MS + 1));
+    EXPECT_LT(adaptive.samples * 4, fixed.samples);
+    // The microwave is still noticed, the door is not reported over and over
+    EXPECT_GE(adaptive.reported, 3u);
+    EXPECT_LT(adaptive.reported, fixed.reported);
+}
+
+} // namespace RdkServicesTest
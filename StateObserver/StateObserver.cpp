@@ -32,6 +32,7 @@
 #include <vector>
 #include <string>
 #include <algorithm>
+#include <unordered_map>
 
 #include "StateObserver.h"
 #include "libIARM.h"
@@ -93,14 +94,14 @@ namespace WPEFramework {
 
 		const string StateObserver::EVT_STATE_OBSERVER_PROPERTY_CHANGED = "propertyChanged";
 
-		std::vector<string> registeredPropertyNames;
-
 
 		StateObserver::StateObserver()
 		: AbstractPlugin()
 		, m_apiVersionNumber((uint32_t)-1)
+		, m_systemStatesValid(false)
 		{
 			StateObserver::_instance = this;
+			memset(&m_systemStates, 0, sizeof(m_systemStates));
 			Register("getValues", &StateObserver::getValues, this);
 			Register("registerListeners", &StateObserver::registerListeners, this);
 			Register("unregisterListeners", &StateObserver::unregisterListeners, this);
@@ -136,6 +137,10 @@ namespace WPEFramework {
             {
                 IARM_Result_t res;
 			    IARM_CHECK( IARM_Bus_RegisterEventHandler(IARM_BUS_SYSMGR_NAME, IARM_BUS_SYSMGR_EVENT_SYSTEMSTATE, onReportStateObserverEvents) );
+
+                // Registered first, so no change is missed between the two
+                std::lock_guard<std::mutex> lock(m_stateMutex);
+                refreshSystemStates();
             }
 		}
 
@@ -176,7 +181,8 @@ namespace WPEFramework {
 		uint32_t StateObserver::getRegisteredPropertyNames(const JsonObject &parameters, JsonObject &response)
 		{
 			JsonArray response_arr;
-			for(const auto &propertyName: registeredPropertyNames)
+			std::lock_guard<std::mutex> lock(m_stateMutex);
+			for(const auto &propertyName: m_registeredPropertyNames)
 			{
         		response_arr.Add(propertyName);
 			}
@@ -248,7 +254,7 @@ namespace WPEFramework {
 		 *
 		 * @return Core::ERROR_NONE
 		 *
-		 *Request example: curl -d '{"jsonrpc":"2.0","id":"3","method": "StateObserver.1.getValues" ,"params":{"PropertyNames":["com.comcast.channel_map"]}}' http://127.0.0.1:9998/jsonrpc
+		 *Request example: curl -d '{"jsonrpc":"2.0","id":"3","method": "StateObserver.1.getValues" ,"params":{"PropertyNames":["com.comcast.channel_map"],"refresh":false}}' http://127.0.0.1:9998/jsonrpc
 		 *Response success:{"jsonrpc":"2.0","id":3,"result":{"properties":[{"propertyName":"com.comcast.channel_map","value":2}],"success":true}}
 		 *Response failure:{"jsonrpc":"2.0","id":3,"result":{"success":false}}
 		 */
@@ -287,7 +293,8 @@ namespace WPEFramework {
 					string prop_str =elem->valuestring;
 					pname.push_back(prop_str);
 				}
-				getVal(pname,response);
+				bool refresh = parameters.HasLabel("refresh") && parameters["refresh"].Boolean();
+				getVal(pname,response,refresh);
 			}
 			LOGTRACEMETHODFIN();
 			cJSON_Delete(root);
@@ -296,15 +303,116 @@ namespace WPEFramework {
 
 
 		/**
-		 * @brief This function retrieves the values of the properties using IARM.
+		 * @brief Property names resolved once, getVal looks them up instead of
+		 * comparing against every name in turn.
+		 */
+		enum PropertyId
+		{
+			PROPERTY_CHANNEL_MAP,
+			PROPERTY_CARD_DISCONNECTED,
+			PROPERTY_TUNE_READY,
+			PROPERTY_EXIT_OK,
+			PROPERTY_CMAC,
+			PROPERTY_MOTO_ENTITLEMENT,
+			PROPERTY_DAC_INIT_TIMESTAMP,
+			PROPERTY_CARD_SERIAL_NO,
+			PROPERTY_STB_SERIAL_NO,
+			PROPERTY_ECM_MAC,
+			PROPERTY_MOTO_HRV_RX,
+			PROPERTY_CARD_CISCO_STATUS,
+			PROPERTY_VIDEO_PRESENTING,
+			PROPERTY_HDMI_OUT,
+			PROPERTY_HDCP_ENABLED,
+			PROPERTY_HDMI_EDID_READ,
+			PROPERTY_FIRMWARE_DWNLD,
+			PROPERTY_TIME_SOURCE,
+			PROPERTY_TIME_ZONE,
+			PROPERTY_CA_SYSTEM,
+			PROPERTY_ESTB_IP,
+			PROPERTY_ECM_IP,
+			PROPERTY_LAN_IP,
+			PROPERTY_DOCSIS,
+			PROPERTY_DSG_CA_TUNNEL,
+			PROPERTY_CABLE_CARD,
+			PROPERTY_VOD_AD,
+			PROPERTY_IP_MODE
+		};
+
+		static bool findProperty(const string& name, PropertyId& id)
+		{
+			static const std::unordered_map<string, PropertyId> properties = {
+				{ SYSTEM_CHANNEL_MAP, PROPERTY_CHANNEL_MAP },
+				{ SYSTEM_CARD_DISCONNECTED, PROPERTY_CARD_DISCONNECTED },
+				{ SYSTEM_TUNE_READY, PROPERTY_TUNE_READY },
+				{ SYSTEM_EXIT_OK, PROPERTY_EXIT_OK },
+				{ SYSTEM_CMAC, PROPERTY_CMAC },
+				{ SYSTEM_MOTO_ENTITLEMENT, PROPERTY_MOTO_ENTITLEMENT },
+				{ SYSTEM_DAC_INIT_TIMESTAMP, PROPERTY_DAC_INIT_TIMESTAMP },
+				{ SYSTEM_CARD_SERIAL_NO, PROPERTY_CARD_SERIAL_NO },
+				{ SYSTEM_STB_SERIAL_NO, PROPERTY_STB_SERIAL_NO },
+				{ SYSTEM_ECM_MAC, PROPERTY_ECM_MAC },
+				{ SYSTEM_MOTO_HRV_RX, PROPERTY_MOTO_HRV_RX },
+				{ SYSTEM_CARD_CISCO_STATUS, PROPERTY_CARD_CISCO_STATUS },
+				{ SYSTEM_VIDEO_PRESENTING, PROPERTY_VIDEO_PRESENTING },
+				{ SYSTEM_HDMI_OUT, PROPERTY_HDMI_OUT },
+				{ SYSTEM_HDCP_ENABLED, PROPERTY_HDCP_ENABLED },
+				{ SYSTEM_HDMI_EDID_READ, PROPERTY_HDMI_EDID_READ },
+				{ SYSTEM_FIRMWARE_DWNLD, PROPERTY_FIRMWARE_DWNLD },
+				{ SYSTEM_TIME_SOURCE, PROPERTY_TIME_SOURCE },
+				{ SYSTEM_TIME_ZONE, PROPERTY_TIME_ZONE },
+				{ SYSTEM_CA_SYSTEM, PROPERTY_CA_SYSTEM },
+				{ SYSTEM_ESTB_IP, PROPERTY_ESTB_IP },
+				{ SYSTEM_ECM_IP, PROPERTY_ECM_IP },
+				{ SYSTEM_LAN_IP, PROPERTY_LAN_IP },
+				{ SYSTEM_DOCSIS, PROPERTY_DOCSIS },
+				{ SYSTEM_DSG_CA_TUNNEL, PROPERTY_DSG_CA_TUNNEL },
+				{ SYSTEM_CABLE_CARD, PROPERTY_CABLE_CARD },
+				{ SYSTEM_VOD_AD, PROPERTY_VOD_AD },
+				{ SYSTEM_IP_MODE, PROPERTY_IP_MODE }
+			};
+
+			auto it = properties.find(name);
+			if (it == properties.end())
+				return false;
+			id = it->second;
+			return true;
+		}
+
+		/**
+		 * @brief This function reads all the system states from the system manager into the snapshot.
+		 * Called with m_stateMutex held.
+		 *
+		 * @return true if the snapshot is valid.
+		 */
+		bool StateObserver::refreshSystemStates()
+		{
+			IARM_Bus_SYSMgr_GetSystemStates_Param_t param;
+			memset(&param, 0, sizeof(param));
+			IARM_Result_t res = IARM_BUS_CALL(IARM_BUS_SYSMGR_NAME, IARM_BUS_SYSMGR_API_GetSystemStates, &param, sizeof(param));
+			if (res != IARM_RESULT_SUCCESS)
+			{
+				LOGWARN("GetSystemStates failed: %d", res);
+				return m_systemStatesValid;
+			}
+
+			m_systemStates = param;
+			m_systemStatesValid = true;
+			return true;
+		}
+
+		/**
+		 * @brief This function retrieves the values of the properties from the snapshot of the
+		 * system states, which the system manager events keep up to date. IARM is only called
+		 * when there is no snapshot yet, or when a refresh is requested.
 		 *
 		 * param[in] pname vector of strings having the names of the properties whose value needs to be fetched.
+		 * param[in] refresh read the system states from the system manager first.
 		 *
 		 * param[out] The state and error values of the properties.
 		 *
 		 */
 
-		void StateObserver::getVal(std::vector<string> pname,JsonObject& response)
+		void StateObserver::getVal(const std::vector<string>& pname,JsonObject& response,bool refresh)
 		{
 			static bool checkForStandalone = true;
 			static bool stbStandAloneMode = false;
@@ -324,288 +432,174 @@ namespace WPEFramework {
 				checkForStandalone = false;
 			}
 			IARM_Bus_SYSMgr_GetSystemStates_Param_t param;
-			IARM_Bus_Call(IARM_BUS_SYSMGR_NAME, IARM_BUS_SYSMGR_API_GetSystemStates, &param, sizeof(param));
+			{
+				std::lock_guard<std::mutex> lock(m_stateMutex);
+				if (refresh || !m_systemStatesValid)
+					refreshSystemStates();
+				param = m_systemStates;
+			}
 			JsonArray response_arr;
-			for( std::vector<string>::iterator it = pname.begin(); it!= pname.end(); ++it )
+			for( std::vector<string>::const_iterator it = pname.begin(); it!= pname.end(); ++it )
 			{
 				string err_str="none";
 				JsonObject devProp;
-				if(*it == SYSTEM_CHANNEL_MAP)
+				PropertyId id;
+				if (!findProperty(*it, id))
 				{
-					int channelMapState = param.channel_map.state;
-					int channelMapError = param.channel_map.error;
-					if (stbStandAloneMode)
-					{
-						LOGINFO("stand alone mode true\n");
-						channelMapState = 2;
-						channelMapError = 0;
-					}
-					devProp["propertyName"]=SYSTEM_CHANNEL_MAP;
-					devProp["value"]=channelMapState;
-					if(channelMapError == 1)
-					{
-						err_str="RDK-03005";
-					}
-					devProp["error"]=err_str;
+					LOGINFO("Invalid property Name\n");
+					string res="Invalid property Name";
+ 					devProp["propertyName"] = *it;
+					devProp["error"]=res;
 					response_arr.Add(devProp);
+					continue;
 				}
 
-				else if(*it == SYSTEM_CARD_DISCONNECTED)
-				{
-					int systemCardState = param.disconnect_mgr_state.state;
-					int systemCardError = param.disconnect_mgr_state.error;
-					if (stbStandAloneMode)
-					{
-						systemCardState = 0;
-						systemCardError = 0;
-					}
-					devProp["propertyName"]=SYSTEM_CARD_DISCONNECTED;
-					devProp["value"]=systemCardState;
-					if(systemCardError==1)
-					{
-						err_str = "RDK-03007";
-					}
-					devProp["error"]=err_str;
-					response_arr.Add(devProp);
-				}
-				else if(*it  == SYSTEM_TUNE_READY)
+				devProp["propertyName"]=*it;
+				switch (id)
 				{
-					int tuneReadyState = param.TuneReadyStatus.state;
-					if (stbStandAloneMode)
+					case PROPERTY_CHANNEL_MAP:
 					{
-						tuneReadyState = 1;
-					}
-					devProp["propertyName"]=SYSTEM_TUNE_READY;
-					devProp["value"]=tuneReadyState;
-					devProp["error"]=err_str;
-					response_arr.Add(devProp);
-				}
-				else if(*it  == SYSTEM_EXIT_OK)
-				{
-					devProp["propertyName"]=SYSTEM_EXIT_OK;
-					devProp["value"]=param.exit_ok_key_sequence.state;
-					devProp["error"]=err_str;
-					response_arr.Add(devProp);
-				}
-				else if(*it ==SYSTEM_CMAC )
-				{
-					devProp["propertyName"]=SYSTEM_CMAC ;
-					devProp["value"]=param.cmac.state;
-					if(param.cmac.error == 1)
-					{
-						err_str  = "RDK-03002";
-					}
-					devProp["error"]=err_str;
-					response_arr.Add(devProp);
-				}
-				else if(*it ==SYSTEM_MOTO_ENTITLEMENT )
-				{
-					devProp["propertyName"]=SYSTEM_MOTO_ENTITLEMENT;
-					devProp["value"]=param.card_moto_entitlements.state;
-					devProp["error"]=err_str;
-					response_arr.Add(devProp);
-				}
-				else if(*it == SYSTEM_DAC_INIT_TIMESTAMP)
-				{
-					devProp["propertyName"]=SYSTEM_DAC_INIT_TIMESTAMP;
-					string dac_init_str(param.dac_init_timestamp.payload);
-					devProp["value"]=dac_init_str;
-					devProp["error"]=err_str;
-					response_arr.Add(devProp);
-				}
-				else if(*it == SYSTEM_CARD_SERIAL_NO )
-				{
-					string card_serial_str(param.card_serial_no.payload);
-					devProp["propertyName"]=SYSTEM_CARD_SERIAL_NO;
-					devProp["value"]=card_serial_str;
-					devProp["error"]=err_str;
-					response_arr.Add(devProp);
-				}
-				else if(*it == SYSTEM_STB_SERIAL_NO )
-				{
-					string stb_string(param.stb_serial_no.payload);
-					devProp["propertyName"]=SYSTEM_STB_SERIAL_NO;
-					devProp["value"]=stb_string;
-					devProp["error"]=err_str;
-					response_arr.Add(devProp);
-				}
-				else if(*it ==SYSTEM_ECM_MAC )
-				{
-					string ecm_mac_str(param.ecm_mac.payload);
-					devProp["propertyName"]=SYSTEM_ECM_MAC;
-					devProp["value"]=ecm_mac_str;
-					devProp["error"]=err_str;
-					response_arr.Add(devProp);
-				}
-				else if(*it == SYSTEM_MOTO_HRV_RX)
-				{
-					devProp["propertyName"]=SYSTEM_MOTO_HRV_RX;
-					devProp["value"]=param.card_moto_hrv_rx.state;
-					devProp["error"]=err_str;
-					response_arr.Add(devProp);
-				}
-				else if(*it == SYSTEM_CARD_CISCO_STATUS )
-				{
-					LOGINFO("property SYSTEM_CARD_CISCO_STATUS \n");
-					devProp["propertyName"]=SYSTEM_CARD_CISCO_STATUS;
-					devProp["value"]=param.card_cisco_status.state;
-					devProp["error"]=err_str;
-					response_arr.Add(devProp);
-				}
-				else if(*it == SYSTEM_VIDEO_PRESENTING)
-				{
-					devProp["propertyName"]=SYSTEM_VIDEO_PRESENTING;
-					devProp["value"]=param.video_presenting.state;
-					devProp["error"]=err_str;
-					response_arr.Add(devProp);
-				}
-				else if(*it == SYSTEM_HDMI_OUT )
-				{
-					devProp["propertyName"]=SYSTEM_HDMI_OUT;
-					devProp["value"]=param.hdmi_out.state;
-					devProp["error"]=err_str;
-					response_arr.Add(devProp);
-				}
-				else if(*it == SYSTEM_HDCP_ENABLED )
-				{
-					devProp["propertyName"]=SYSTEM_HDCP_ENABLED;
-					devProp["value"]=param.hdcp_enabled.state;
-					devProp["error"]=err_str;
-					response_arr.Add(devProp);
-				}
-				else if(*it == SYSTEM_HDMI_EDID_READ )
-				{
-					devProp["propertyName"]=SYSTEM_HDMI_EDID_READ;
-					devProp["value"]=param.hdmi_edid_read.state;
-					devProp["error"]=err_str;
-					response_arr.Add(devProp);
-				}
-				else if(*it == SYSTEM_FIRMWARE_DWNLD )
-				{
-					devProp["propertyName"]=SYSTEM_FIRMWARE_DWNLD;
-					devProp["value"]=param.firmware_download.state;
-					devProp["error"]=err_str;
-					response_arr.Add(devProp);
-				}
-				else if(*it == SYSTEM_TIME_SOURCE)
-				{
-					LOGWARN("%s PropertyName: %s Time source state: %d, time source error: %d",
-						__FUNCTION__,
-						SYSTEM_TIME_SOURCE.c_str(),
-						param.time_source.state,
-						param.time_source.error);
-
-					devProp["propertyName"]=SYSTEM_TIME_SOURCE;
-					devProp["value"]=param.time_source.state;
-					if(param.time_source.error == 1)
-					{
-						err_str  = "RDK-03006";
-					}
-					devProp["error"]=err_str;
-
-					std::string json;
-					devProp.ToString(json);
-					LOGWARN("%s devProp=%s", __FUNCTION__, json.c_str());
-					response_arr.Add(devProp);
-				}
-				else if(*it == SYSTEM_TIME_ZONE)
-				{
-					devProp["propertyName"]=SYSTEM_TIME_ZONE;
-					devProp["value"]=param.time_zone_available.state;
-					devProp["error"]=err_str;
-					response_arr.Add(devProp);
-				}
-				else if(*it == SYSTEM_CA_SYSTEM)
-				{
-					devProp["propertyName"]=SYSTEM_CA_SYSTEM;
-					devProp["value"]=param.ca_system.state;
-					devProp["error"]=err_str;
-					response_arr.Add(devProp);
-				}
-				else if(*it == SYSTEM_ESTB_IP)
-				{
-					devProp["propertyName"]=SYSTEM_ESTB_IP;
-					devProp["value"]=param.estb_ip.state;
-					if(param.estb_ip.error == 1)
-					{
-						err_str  = "RDK-03009";
-					}
-					devProp["error"]=err_str;
-					response_arr.Add(devProp);
-				}
-				else if(*it == SYSTEM_ECM_IP)
-				{
-					devProp["propertyName"]=SYSTEM_ECM_IP;
-					devProp["value"]=param.ecm_ip.state;
-					if(param.ecm_ip.error == 1)
-					{
-						err_str  = "RDK-03004";
-					}
-					devProp["error"]=err_str;
-					response_arr.Add(devProp);
-				}
-				else if(*it == SYSTEM_LAN_IP)
-				{
-					devProp["propertyName"]=SYSTEM_LAN_IP;
-					devProp["value"]=param.lan_ip.state;
-					devProp["error"]=err_str;
-					response_arr.Add(devProp);
-				}
-				else if(*it == SYSTEM_DOCSIS)
-				{
-					devProp["propertyName"]=SYSTEM_DOCSIS;
-					devProp["value"]=param.docsis.state;
-					devProp["error"]=err_str;
-					response_arr.Add(devProp);
-				}
-				else if(*it == SYSTEM_DSG_CA_TUNNEL)
-				{
-					devProp["propertyName"]=SYSTEM_DSG_CA_TUNNEL;
-					devProp["value"]=param.dsg_ca_tunnel.state;
-					if(param.dsg_ca_tunnel.error == 1)
-					{
-						err_str  = "RDK-03003";
+						int channelMapState = param.channel_map.state;
+						int channelMapError = param.channel_map.error;
+						if (stbStandAloneMode)
+						{
+							LOGINFO("stand alone mode true\n");
+							channelMapState = 2;
+							channelMapError = 0;
+						}
+						devProp["value"]=channelMapState;
+						if(channelMapError == 1)
+						{
+							err_str="RDK-03005";
+						}
+						break;
 					}
-					devProp["error"]=err_str;
-					response_arr.Add(devProp);
-				}
-				else if(*it == SYSTEM_CABLE_CARD )
-				{
-					devProp["propertyName"]=SYSTEM_CABLE_CARD;
-					devProp["value"]=param.cable_card.state;
-					if(param.cable_card.error == 1)
+					case PROPERTY_CARD_DISCONNECTED:
 					{
-						err_str  = "RDK-03001";
+						int systemCardState = param.disconnect_mgr_state.state;
+						int systemCardError = param.disconnect_mgr_state.error;
+						if (stbStandAloneMode)
+						{
+							systemCardState = 0;
+							systemCardError = 0;
+						}
+						devProp["value"]=systemCardState;
+						if(systemCardError==1)
+						{
+							err_str = "RDK-03007";
+						}
+						break;
 					}
-					devProp["error"]=err_str;
-					response_arr.Add(devProp);
-				}
-				else if(*it == SYSTEM_VOD_AD)
-				{
-					devProp["propertyName"]=SYSTEM_VOD_AD;
-					devProp["value"]=param.vod_ad.state;
-					devProp["error"]=err_str;
-					response_arr.Add(devProp);
-				}
-				else if(*it == SYSTEM_IP_MODE)
-				{
-					int ipState=param.ip_mode.state;
-					int ipError=param.ip_mode.error;
-					devProp["propertyName"]=SYSTEM_IP_MODE;
-					devProp["value"]=ipState;
-					devProp["error"]=ipError;
-					response_arr.Add(devProp);
+					case PROPERTY_TUNE_READY:
+						devProp["value"]=(stbStandAloneMode ? 1 : param.TuneReadyStatus.state);
+						break;
+					case PROPERTY_EXIT_OK:
+						devProp["value"]=param.exit_ok_key_sequence.state;
+						break;
+					case PROPERTY_CMAC:
+						devProp["value"]=param.cmac.state;
+						if(param.cmac.error == 1)
+						{
+							err_str  = "RDK-03002";
+						}
+						break;
+					case PROPERTY_MOTO_ENTITLEMENT:
+						devProp["value"]=param.card_moto_entitlements.state;
+						break;
+					case PROPERTY_DAC_INIT_TIMESTAMP:
+						devProp["value"]=string(param.dac_init_timestamp.payload);
+						break;
+					case PROPERTY_CARD_SERIAL_NO:
+						devProp["value"]=string(param.card_serial_no.payload);
+						break;
+					case PROPERTY_STB_SERIAL_NO:
+						devProp["value"]=string(param.stb_serial_no.payload);
+						break;
+					case PROPERTY_ECM_MAC:
+						devProp["value"]=string(param.ecm_mac.payload);
+						break;
+					case PROPERTY_MOTO_HRV_RX:
+						devProp["value"]=param.card_moto_hrv_rx.state;
+						break;
+					case PROPERTY_CARD_CISCO_STATUS:
+						devProp["value"]=param.card_cisco_status.state;
+						break;
+					case PROPERTY_VIDEO_PRESENTING:
+						devProp["value"]=param.video_presenting.state;
+						break;
+					case PROPERTY_HDMI_OUT:
+						devProp["value"]=param.hdmi_out.state;
+						break;
+					case PROPERTY_HDCP_ENABLED:
+						devProp["value"]=param.hdcp_enabled.state;
+						break;
+					case PROPERTY_HDMI_EDID_READ:
+						devProp["value"]=param.hdmi_edid_read.state;
+						break;
+					case PROPERTY_FIRMWARE_DWNLD:
+						devProp["value"]=param.firmware_download.state;
+						break;
+					case PROPERTY_TIME_SOURCE:
+						devProp["value"]=param.time_source.state;
+						if(param.time_source.error == 1)
+						{
+							err_str  = "RDK-03006";
+						}
+						break;
+					case PROPERTY_TIME_ZONE:
+						devProp["value"]=param.time_zone_available.state;
+						break;
+					case PROPERTY_CA_SYSTEM:
+						devProp["value"]=param.ca_system.state;
+						break;
+					case PROPERTY_ESTB_IP:
+						devProp["value"]=param.estb_ip.state;
+						if(param.estb_ip.error == 1)
+						{
+							err_str  = "RDK-03009";
+						}
+						break;
+					case PROPERTY_ECM_IP:
+						devProp["value"]=param.ecm_ip.state;
+						if(param.ecm_ip.error == 1)
+						{
+							err_str  = "RDK-03004";
+						}
+						break;
+					case PROPERTY_LAN_IP:
+						devProp["value"]=param.lan_ip.state;
+						break;
+					case PROPERTY_DOCSIS:
+						devProp["value"]=param.docsis.state;
+						break;
+					case PROPERTY_DSG_CA_TUNNEL:
+						devProp["value"]=param.dsg_ca_tunnel.state;
+						if(param.dsg_ca_tunnel.error == 1)
+						{
+							err_str  = "RDK-03003";
+						}
+						break;
+					case PROPERTY_CABLE_CARD:
+						devProp["value"]=param.cable_card.state;
+						if(param.cable_card.error == 1)
+						{
+							err_str  = "RDK-03001";
+						}
+						break;
+					case PROPERTY_VOD_AD:
+						devProp["value"]=param.vod_ad.state;
+						break;
+					case PROPERTY_IP_MODE:
+						devProp["value"]=param.ip_mode.state;
+						break;
 				}
 
+				// ip_mode reports the error number itself
+				if (id == PROPERTY_IP_MODE)
+					devProp["error"]=param.ip_mode.error;
 				else
-				{
-					LOGINFO("Invalid property Name\n");
-					string res="Invalid property Name";
- 					devProp["propertyName"] = *it;
-					devProp["error"]=res;
-					response_arr.Add(devProp);
-				}
-
+					devProp["error"]=err_str;
+				response_arr.Add(devProp);
 			}
 
 			response["properties"]=response_arr;
@@ -663,12 +657,15 @@ namespace WPEFramework {
 					pname.push_back(prop_str);
 				}
 
-				for( std::vector<string>::iterator it = pname.begin(); it!= pname.end(); ++it )
 				{
-					if (std::find(registeredPropertyNames.begin(), registeredPropertyNames.end(), *it) == registeredPropertyNames.end())
+					std::lock_guard<std::mutex> lock(m_stateMutex);
+					for( std::vector<string>::iterator it = pname.begin(); it!= pname.end(); ++it )
 					{
-						LOGINFO("prop being added to listeners %s",it->c_str());
-						registeredPropertyNames.push_back(*it);
+						if (m_registeredPropertySet.insert(*it).second)
+						{
+							m_registeredPropertyNames.push_back(*it);
+							LOGINFO("prop being added to listeners %s",it->c_str());
+						}
 					}
 				}
 				getVal(pname,response);
@@ -724,14 +721,14 @@ namespace WPEFramework {
 					string prop_str =elem->valuestring;
 					pname.push_back(prop_str);
 				}
+				std::lock_guard<std::mutex> lock(m_stateMutex);
 				for( std::vector<string>::iterator it = pname.begin(); it!= pname.end(); ++it )
 				{
-					std::vector<string>::iterator itr=std::find(registeredPropertyNames.begin(), registeredPropertyNames.end(), *it);
-					if(itr!=registeredPropertyNames.end())
+					if(m_registeredPropertySet.erase(*it) != 0)
 					{
 						//property found hence remove it
+						m_registeredPropertyNames.erase(std::find(m_registeredPropertyNames.begin(), m_registeredPropertyNames.end(), *it));
 						LOGINFO("prop being removed %s",it->c_str());
-						registeredPropertyNames.erase(itr);
 					}
 				}
 			}
@@ -741,12 +738,16 @@ namespace WPEFramework {
 		}
 
 		 /**
-		 * @brief This function is an event handler for property change event.
+		 * @brief This function is an event handler for property change event. It also applies the
+		 * change to the snapshot of the system states that getValues is served from.
 		 *
 		 */
 		void StateObserver::onReportStateObserverEvents(const char *owner, IARM_EventId_t eventId, void *data, size_t len)
 		{
-			IARM_Bus_SYSMgr_GetSystemStates_Param_t systemStates;
+			StateObserver* observer = StateObserver::_instance;
+			if (observer == nullptr)
+				return;
+
 			JsonObject params;
 			int state=0;
 			int error=0;
@@ -768,6 +769,8 @@ namespace WPEFramework {
 					LOGINFO("stateId is %d state is %d error is %d \n",stateId,state,error);
 					LOGINFO("payload is %s\n",payload);
 				#endif
+				std::unique_lock<std::mutex> lock(observer->m_stateMutex);
+				IARM_Bus_SYSMgr_GetSystemStates_Param_t& systemStates = observer->m_systemStates;
 				switch(stateId)
 				{
 
@@ -831,8 +834,8 @@ namespace WPEFramework {
 						{
 						systemStates.dac_init_timestamp.state = state;
 						systemStates.dac_init_timestamp.error = error;
-						strncpy(systemStates.dac_init_timestamp.payload,payload,strlen(payload));
-						systemStates.dac_init_timestamp.payload[strlen(payload)]='\0';
+						strncpy(systemStates.dac_init_timestamp.payload,payload,sizeof(systemStates.dac_init_timestamp.payload) - 1);
+						systemStates.dac_init_timestamp.payload[sizeof(systemStates.dac_init_timestamp.payload) - 1]='\0';
 						if(StateObserver::_instance)
 							StateObserver::_instance->setProp(params,SYSTEM_DAC_INIT_TIMESTAMP,state,error);
 						string payload_str(payload);
@@ -843,8 +846,8 @@ namespace WPEFramework {
 					case IARM_BUS_SYSMGR_SYSSTATE_CABLE_CARD_SERIAL_NO:
 						{
 						systemStates.card_serial_no.error =error;
-						strncpy(systemStates.card_serial_no.payload,payload,strlen(payload));
-						systemStates.card_serial_no.payload[strlen(payload)]='\0';
+						strncpy(systemStates.card_serial_no.payload,payload,sizeof(systemStates.card_serial_no.payload) - 1);
+						systemStates.card_serial_no.payload[sizeof(systemStates.card_serial_no.payload) - 1]='\0';
 						params["propertyName"]=SYSTEM_CARD_SERIAL_NO;
 						params["error"]=error;
 						string payload_str(payload);
@@ -855,8 +858,8 @@ namespace WPEFramework {
 					 case IARM_BUS_SYSMGR_SYSSTATE_STB_SERIAL_NO:
 						{
 						systemStates.stb_serial_no.error =error;
-						strncpy(systemStates.stb_serial_no.payload,payload,strlen(payload));
-						systemStates.stb_serial_no.payload[strlen(payload)]='\0';
+						strncpy(systemStates.stb_serial_no.payload,payload,sizeof(systemStates.stb_serial_no.payload) - 1);
+						systemStates.stb_serial_no.payload[sizeof(systemStates.stb_serial_no.payload) - 1]='\0';
 						params["propertyName"]=SYSTEM_STB_SERIAL_NO;
 						params["error"]=error;
 						string payload_str(payload);
@@ -991,8 +994,8 @@ namespace WPEFramework {
 					case IARM_BUS_SYSMGR_SYSSTATE_ECM_MAC:
 						{
 						systemStates.ecm_mac.error =error;
-						strncpy(systemStates.ecm_mac.payload,payload,strlen(payload));
-						systemStates.ecm_mac.payload[strlen(payload)]='\0';
+						strncpy(systemStates.ecm_mac.payload,payload,sizeof(systemStates.ecm_mac.payload) - 1);
+						systemStates.ecm_mac.payload[sizeof(systemStates.ecm_mac.payload) - 1]='\0';
 						params["propertyName"]=SYSTEM_ECM_MAC;
 						params["error"]=error;
 						string payload_str(payload);
@@ -1004,8 +1007,8 @@ namespace WPEFramework {
 						{
 						systemStates.ip_mode.state=state;
 						systemStates.ip_mode.error =error;
-						strncpy(systemStates.ip_mode.payload,payload,strlen(payload));
-						systemStates.ip_mode.payload[strlen(payload)]='\0';
+						strncpy(systemStates.ip_mode.payload,payload,sizeof(systemStates.ip_mode.payload) - 1);
+						systemStates.ip_mode.payload[sizeof(systemStates.ip_mode.payload) - 1]='\0';
 						if(StateObserver::_instance)
 							StateObserver::_instance->setProp(params,SYSTEM_IP_MODE,state,error);
 						string payload_str(payload);
@@ -1015,6 +1018,7 @@ namespace WPEFramework {
 					default:
 						break;
 				}
+				lock.unlock();
 
 				//notify the params
 				if(StateObserver::_instance)
@@ -1041,7 +1045,12 @@ namespace WPEFramework {
 		void StateObserver::notify(string eventname, JsonObject& params)
 		{
 			string property_name=params["propertyName"].String();
-			if(std::find(registeredPropertyNames.begin(), registeredPropertyNames.end(), property_name) != registeredPropertyNames.end())
+			bool registered;
+			{
+				std::lock_guard<std::mutex> lock(m_stateMutex);
+				registered = (m_registeredPropertySet.count(property_name) != 0);
+			}
+			if(registered)
 			{
 				LOGINFO("calling send notify\n");
 				#if(DEBUG_INFO)
@@ -31,9 +31,13 @@
 #ifndef STATEOBSERVER_H
 #define STATEOBSERVER_H
 #include <cjson/cJSON.h>
+#include <mutex>
+#include <unordered_set>
+#include <vector>
 
 #include "Module.h"
 #include "libIBus.h"
+#include "sysMgr.h"
 #include "utils.h"
 #include "utils.h"
 #include "AbstractPlugin.h"
@@ -120,7 +124,8 @@ namespace WPEFramework {
 			uint32_t getApiVersionNumberWrapper(const JsonObject& parameters, JsonObject& response);
             uint32_t getRegisteredPropertyNames(const JsonObject &parameters, JsonObject &response);
 			uint32_t getNameWrapper(const JsonObject& parameters, JsonObject& response);
-			void getVal(std::vector<string> pname,JsonObject& response);
+			void getVal(const std::vector<string>& pname,JsonObject& response,bool refresh = false);
+			bool refreshSystemStates();
 			void InitializeIARM();
 			void DeinitializeIARM();
 			//End methods
@@ -146,6 +151,13 @@ namespace WPEFramework {
 			static StateObserver* _instance;
 		private:
 			uint32_t m_apiVersionNumber;
+
+			std::mutex m_stateMutex;
+			IARM_Bus_SYSMgr_GetSystemStates_Param_t m_systemStates;
+			bool m_systemStatesValid;
+			// In registration order, as getRegisteredPropertyNames returns them; the set is for lookups
+			std::vector<string> m_registeredPropertyNames;
+			std::unordered_set<string> m_registeredPropertySet;
 		};
 
 	} // namespace Plugin
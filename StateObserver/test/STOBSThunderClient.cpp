@@ -42,6 +42,7 @@ void showMenu()
 	cout<<"4.getName\n";
 	cout<<"5.getApiVersionNumber\n";
 	cout<<"6.setApiVersionNumber\n";
+	cout<<"7.getValues benchmark\n";
 }
 
 
@@ -217,6 +218,35 @@ int main(int argc, char** argv)
 				}
                         	break;
 			
+				case 7:
+				{
+					cout<<"Enter the number of calls\n";
+					int calls;
+					cin>>calls;
+					JsonObject benchParam;
+					benchParam["PropertyNames"].FromString("[\"com.comcast.channel_map\",\"com.comcast.time_source\",\"com.comcast.estb_ip\",\"com.comcast.hdmi_out\"]");
+					//From the snapshot, then with a system manager call every time as before
+					for (int refresh = 0; refresh < 2; refresh++)
+					{
+						benchParam["refresh"] = (refresh == 1);
+						long long total = 0;
+						long long worst = 0;
+						int failed = 0;
+						for (i = 0; i < calls; i++)
+						{
+							auto start = std::chrono::steady_clock::now();
+							uint32_t ret = remoteObject->Invoke<JsonObject, JsonObject>(1000, _T("getValues"), benchParam, result);
+							long long us = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start).count();
+							if (ret != Core::ERROR_NONE || !result["success"].Boolean())
+								failed++;
+							total += us;
+							worst = std::max(worst, us);
+						}
+						if (calls > 0)
+							cout<<"getValues "<<(refresh ? "refresh" : "snapshot")<<": "<<calls<<" calls, average "<<(total / calls)<<" us, max "<<worst<<" us, "<<failed<<" failed\n";
+					}
+				}
+				break;
 				default:
 				
 				break;
@@ -20,7 +20,6 @@
 #include "SystemAudioPlayerImplementation.h"
 #include <sys/prctl.h>
 #include "impl/Helper.h"
-#include "base64.h"
 
 #define SAP_MAJOR_VERSION 1
 #define SAP_MINOR_VERSION 0
@@ -232,16 +231,8 @@ namespace Plugin {
         _adminLock.Unlock();
         if(player != NULL)
         {           
-            std::vector<uint8_t> dectokenVec(data.begin(), data.end());
-            uint8_t *e = &dectokenVec[0];
-            size_t decworkspace_size = b64_get_decoded_buffer_size(dectokenVec.size());
-            uint8_t *decworkspace = new uint8_t[decworkspace_size];
-            size_t decnum_chars = b64_decode(e, dectokenVec.size(),decworkspace);
-            LOGINFO("decode size %d\n", decworkspace_size);
-            player->PlayBuffer((const char*)decworkspace,decnum_chars);
-            delete []decworkspace;
-            
-            returnResponse(true);
+            //Decoded straight into the player's buffer pool, false when the player is full (ENOUGH_DATA)
+            returnResponse(player->PlayBuffer(data));
         }
         returnResponse(false);
     }
@@ -1,9 +1,18 @@
 #include "AudioPlayer.h"
 #include "logger.h"
 #include <gst/app/gstappsrc.h>
+#include "base64.h"
 
 #include <cmath>
-#define AUDIO_GST_FRAGMENT_MAX_SIZE     (128 * 1024)
+#include <algorithm>
+//Multiple of 3 so that base64 input can be decoded straight into pool buffers, 4 chars -> 3 bytes
+#define AUDIO_POOL_BUFFER_SIZE          (24 * 1024)
+#define AUDIO_POOL_MAX_FREE             64
+//Buffers in flight (queued or owned by gstreamer) before the producer is throttled
+#define AUDIO_HIGH_WATERMARK            64
+#define AUDIO_LOW_WATERMARK             16
+//One playbuffer request fits the pool once NEED_DATA is sent (~1.1 MB decoded)
+#define AUDIO_MAX_BUFFERS_PER_CALL      (AUDIO_HIGH_WATERMARK - AUDIO_LOW_WATERMARK)
 #define PLAYBACK_STARTED "PLAYBACK_STARTED"
 #define PLAYBACK_FINISHED "PLAYBACK_FINISHED"
 #define PLAYBACK_PAUSED "PLAYBACK_PAUSED"
@@ -11,6 +20,7 @@
 #define NETWORK_ERROR "NETWORK_ERROR"
 #define PLAYBACK_ERROR "PLAYBACK_ERROR"
 #define NEED_DATA "NEED_DATA"
+#define ENOUGH_DATA "ENOUGH_DATA"
 
 GMainLoop* AudioPlayer::m_main_loop=NULL;
 GThread* AudioPlayer::m_main_loop_thread=NULL;
@@ -33,8 +43,11 @@ AudioPlayer::AudioPlayer(AudioType audioType,SourceType sourceType,PlayMode play
     {
         m_running = true;
         appsrc_firstpacket = true;
+        m_enoughData = false;
+        m_flushing = false;
         webClient = NULL;
         bufferQueue = new BufferQueue(1000);
+        bufferPool = new BufferPool(AUDIO_POOL_BUFFER_SIZE,AUDIO_POOL_MAX_FREE);
         m_thread= new std::thread(&AudioPlayer::PushDataAppSrc, this);
     }
 
@@ -70,15 +83,23 @@ AudioPlayer::~AudioPlayer()
     if(sourceType == DATA || sourceType == WEBSOCKET)
     {   
         m_running = false;       
+        //appsrc blocks when full, flush it first so that the push thread can exit
+        gst_element_set_state (m_pipeline, GST_STATE_NULL);
         bufferQueue->preDelete();
 	SAPLOG_INFO("SAP: AudioPlayer Destructor before Pushapp src thread join player id %d\n",getObjectIdentifier());
 	m_thread->join();
 	SAPLOG_INFO("SAP: AudioPlayer Destructor after Pushapp src thread join player id %d\n",getObjectIdentifier());
+        bufferQueue->clear();
         delete bufferQueue;
         delete m_thread;
     }  
     gst_element_set_state (m_pipeline, GST_STATE_NULL);
     gst_object_unref (m_pipeline);  
+    //Pool goes last, gstreamer may hold pool buffers until the pipeline is gone
+    if(sourceType == DATA || sourceType == WEBSOCKET)
+    {
+        delete bufferPool;
+    }
 }
 
 void AudioPlayer::Init(SAPEventCallback *callback)
@@ -248,6 +269,8 @@ void AudioPlayer::createPipeline()
        //appsrc
        m_source = gst_element_factory_make ("appsrc", NULL);
        gst_app_src_set_max_bytes((GstAppSrc *)m_source,512000);
+       //Block the push thread instead of growing the appsrc queue, pool watermarks then throttle the producer
+       g_object_set(m_source, "block", TRUE, NULL);
     }
 
     bool result = TRUE; 
@@ -381,6 +404,11 @@ int AudioPlayer::GstBusCallback(GstBus *, GstMessage *message, gpointer data)
 }
 
 
+static void releasePoolBuffer(gpointer data)
+{
+    ((Buffer*)data)->release();
+}
+
 gboolean AudioPlayer::PushDataAppSrc()
 {
     while(m_running)
@@ -393,62 +421,56 @@ gboolean AudioPlayer::PushDataAppSrc()
 	         //event -->Underflow
                  if(sourceType == DATA)
                  { 
+                     m_enoughData = false;
                      m_callback->onSAPEvent(getObjectIdentifier(),NEED_DATA);
                  }
              }
         }
-        size_t maxBytes = AUDIO_GST_FRAGMENT_MAX_SIZE;
         //package should be played as soon as it arrived
-        //GstClockTime pts = 0;
-        //GstClockTime dts = 0;
         buffer = bufferQueue->remove();  //blocking call
 	if(buffer == NULL)
 	{
             continue;		
 	}
-        int length = buffer->getLength();
-        char *ptr = buffer->getBuffer();
-
-        while(length != 0)
-        {               
-            int lenToSend = length;
-        
-            if(lenToSend > maxBytes)
-            {
-                lenToSend = maxBytes;
-            }
-     
-            GstBuffer *gbuffer = gst_buffer_new_and_alloc((guint)lenToSend);
-            GstMapInfo map;
-            gst_buffer_map(gbuffer, &map, GST_MAP_WRITE);
-            memcpy(map.data,ptr,lenToSend);
-            gst_buffer_unmap(gbuffer, &map);
-            //GST_BUFFER_PTS(gbuffer) = pts;
-            //GST_BUFFER_DTS(gbuffer) = dts;
-            //GstFlowReturn ret = gst_app_src_push_buffer(GST_APP_SRC(player->m_source), gbuffer);
-            GstFlowReturn ret;
-            g_signal_emit_by_name (m_source, "push-buffer", gbuffer, &ret);
-
-            gst_buffer_unref (gbuffer);
-
-            if (ret != GST_FLOW_OK)
-            {
-	        SAPLOG_WARNING("SAP: appsrc not accepting buffer\n");
-            }
-            if(appsrc_firstpacket)
-            {
-                appsrc_firstpacket = false;
-                m_callback->onSAPEvent(getObjectIdentifier(),PLAYBACK_STARTED);
-                setPrimaryVolume(m_primVolume);
-                setVolume(m_thisVolume);
-            }
-            ptr = lenToSend + (char *)ptr;
-            length -= lenToSend;
+
+        //Wrap the pool buffer as is, it goes back to the pool once gstreamer releases it
+        GstBuffer *gbuffer = gst_buffer_new_wrapped_full((GstMemoryFlags)0, buffer->getBuffer(), buffer->getCapacity(),
+                                                         0, buffer->getLength(), buffer, releasePoolBuffer);
+        //blocks while appsrc holds more than max-bytes
+        GstFlowReturn ret = gst_app_src_push_buffer(GST_APP_SRC(m_source), gbuffer);
+
+        if (ret != GST_FLOW_OK)
+        {
+	    SAPLOG_WARNING("SAP: appsrc not accepting buffer\n");
+        }
+        if(appsrc_firstpacket)
+        {
+            appsrc_firstpacket = false;
+            m_callback->onSAPEvent(getObjectIdentifier(),PLAYBACK_STARTED);
+            setPrimaryVolume(m_primVolume);
+            setVolume(m_thisVolume);
         }
-        buffer->deleteBuffer();
-	delete buffer;        
+        notifyNeedData();
+    }
+    return TRUE;
+}
+
+void AudioPlayer::notifyEnoughData()
+{
+    if(sourceType == DATA && !m_enoughData.exchange(true))
+    {
+        SAPLOG_INFO("SAP: Enough data buffered on player id %d\n",getObjectIdentifier());
+        m_callback->onSAPEvent(getObjectIdentifier(),ENOUGH_DATA);
+    }
+}
+
+void AudioPlayer::notifyNeedData()
+{
+    if(m_enoughData && bufferPool->inUse() <= AUDIO_LOW_WATERMARK && m_enoughData.exchange(false))
+    {
+        SAPLOG_INFO("SAP: Buffer level low on player id %d\n",getObjectIdentifier());
+        m_callback->onSAPEvent(getObjectIdentifier(),NEED_DATA);
     }
-   
 }
 static gboolean pop_data(AudioPlayer *player)
 {
@@ -465,14 +487,31 @@ void AudioPlayer::wsConnectionStatus(WSStatus status)
     } 
 }
 
-void AudioPlayer::push_data(const void *ptr,int length)
+bool AudioPlayer::push_data(const void *ptr,int length)
 {
-    if(!bufferQueue->isFull())
+    const char *data = (const char*)ptr;
+    while(length > 0)
     {
-	Buffer *buffer = new Buffer();
-        buffer->fillBuffer(ptr,length);
+        //Throttle the sender instead of dropping audio, websocket
+        //is not serviced while we wait so TCP pushes back on the server
+        while(!bufferPool->waitForSpace(AUDIO_HIGH_WATERMARK,100))
+        {
+            if(!m_running || m_flushing)
+            {
+                SAPLOG_WARNING("SAP: Player id %d stopping, dropping %d bytes\n",getObjectIdentifier(),length);
+                return false;
+            }
+        }
+
+        Buffer *buffer = bufferPool->acquire();
+        int len = std::min(length,buffer->getCapacity());
+        memcpy(buffer->getBuffer(),data,len);
+        buffer->setLength(len);
         bufferQueue->add(buffer);
+        data += len;
+        length -= len;
     }
+    return true;
 }
 
 bool AudioPlayer::handleMessage(GstMessage *message) 
@@ -709,16 +748,46 @@ void AudioPlayer::Play(std::string url)
     }    
 }
    
-void AudioPlayer::PlayBuffer(const char *data,int length)
+bool AudioPlayer::PlayBuffer(const std::string &data)
 {  
     std::lock_guard<std::mutex> lock(m_apiMutex);
     SAPLOG_INFO("SAP: AudioPlayer PlayBuffer invoked Playerid %d\n",getObjectIdentifier());
-    if(m_pipeline)
+    if(!m_pipeline)
     {
-        if(state != PLAYING)
-            gst_element_set_state(m_pipeline, GST_STATE_PLAYING);      
-        push_data(data,length);
+        return false;
+    }
+
+    //Decode base64 straight into pool buffers, one buffer worth of input at a time
+    const size_t segment = (bufferPool->bufferSize() / 3) * 4;
+    const int needed = (data.size() + segment - 1) / segment;
+    if(needed > AUDIO_MAX_BUFFERS_PER_CALL)
+    {
+        SAPLOG_ERROR("SAP: Player id %d rejecting %d bytes, more than %d buffers in one request\n",getObjectIdentifier(),data.size(),AUDIO_MAX_BUFFERS_PER_CALL);
+        return false;
     }
+
+    //Caller has to wait for NEED_DATA before sending more
+    if(bufferPool->inUse() + needed > AUDIO_HIGH_WATERMARK)
+    {
+        SAPLOG_WARNING("SAP: Player id %d buffer full, rejecting %d bytes\n",getObjectIdentifier(),data.size());
+        notifyEnoughData();
+        return false;
+    }
+
+    if(state != PLAYING)
+        gst_element_set_state(m_pipeline, GST_STATE_PLAYING);      
+
+    if(bufferPool->decode(bufferQueue,(const uint8_t*)data.c_str(),data.size(),b64_decode) < 0)
+    {
+        SAPLOG_ERROR("SAP: Player id %d base64 decode failed\n",getObjectIdentifier());
+        return false;
+    }
+
+    if(bufferPool->inUse() >= AUDIO_HIGH_WATERMARK)
+    {
+        notifyEnoughData();
+    }
+    return true;
 }
 
 bool AudioPlayer::Pause()
@@ -749,6 +818,8 @@ void AudioPlayer::Stop()
     std::lock_guard<std::mutex> lock(m_apiMutex);
     if(sourceType == DATA || sourceType == WEBSOCKET )
     {
+        //Release a websocket thread waiting for buffer space before joining it
+        m_flushing = true;
         if(webClient != NULL)
         {
             webClient->disconnect();
@@ -757,12 +828,14 @@ void AudioPlayer::Stop()
         }
 
         appsrc_firstpacket = true;
+        m_enoughData = false;
         bufferQueue->clear();
 	SAPLOG_INFO("size of Buffer queue after clear %d\n",bufferQueue->count());
 	  
     }
     resetPipeline();
     state = READY;
+    m_flushing = false;
     
 }
 bool AudioPlayer::Resume()
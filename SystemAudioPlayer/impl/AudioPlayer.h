@@ -99,6 +99,9 @@ class AudioPlayer
 #endif
     WebSocketClient *webClient;
     BufferQueue *bufferQueue;
+    BufferPool *bufferPool;
+    std::atomic<bool> m_enoughData;
+    std::atomic<bool> m_flushing;
     GstElement  *m_source;
     AudioType audioType;
     SourceType sourceType;
@@ -120,6 +123,8 @@ class AudioPlayer
     void setVolume( int Vol);
     void setPrimaryVolume( int Vol);
     bool waitForStatus(GstState expected_state, uint32_t timeout_ms);
+    void notifyEnoughData();
+    void notifyNeedData();
     GstCaps * getPCMAudioCaps( const std::string format, int rate, int channels, const std::string layout);
 
     public:
@@ -127,7 +132,7 @@ class AudioPlayer
     AudioPlayer(AudioType,SourceType,PlayMode,int objectIdentifier);
     ~AudioPlayer();
     void Play(std::string url);
-    void PlayBuffer(const char*,int);
+    bool PlayBuffer(const std::string &data);
     bool Resume();
     bool Pause();
     void Stop();
@@ -135,7 +140,7 @@ class AudioPlayer
     AudioType getAudioType();
     PlayMode  getPlayMode();
     SourceType getSourceType();
-    void push_data(const void *ptr,int length);
+    bool push_data(const void *ptr,int length);
     void wsConnectionStatus(WSStatus status);
     bool handleMessage(GstMessage*);
     gboolean PushDataAppSrc();
@@ -1,11 +1,22 @@
 #include "BufferQueue.h"
+#include <algorithm>
 #include <cstring>
+#include <time.h>
+#include <linux/futex.h>
+#include <sys/syscall.h>
 
-void Buffer::fillBuffer(const void *ptr,int len)
+Buffer::Buffer(BufferPool *pool,int capacity)
+    : buff(new char[capacity])
+    , length(0)
+    , capacity(capacity)
+    , pool(pool)
 {
-    this->length = len;
-    buff = new char[length];
-    std::memcpy(buff,ptr,length);
+}
+
+Buffer::~Buffer()
+{
+    delete[] buff;
+    buff = NULL;
 }
 
 int Buffer::getLength()
@@ -13,112 +24,303 @@ int Buffer::getLength()
     return length;
 }
 
+void Buffer::setLength(int len)
+{
+    length = len;
+}
+
+int Buffer::getCapacity()
+{
+    return capacity;
+}
+
 char* Buffer::getBuffer()
 {
     return buff;
 }
 
-void Buffer::deleteBuffer()
-{  
-    SAPLOG_TRACE("SAP: delete Buffer..."); 
-    if(buff != NULL)
+void Buffer::release()
+{
+    if(pool != NULL)
+    {
+        pool->release(this);
+    }
+    else
     {
-       delete[] buff;
-       buff = NULL;
+        delete this;
     }
 }
 
-BufferQueue::BufferQueue(int size)
+BufferPool::BufferPool(int bufferSize,int maxFree)
+    : m_bufferSize(bufferSize)
+    , m_maxFree(maxFree)
+    , m_inUse(0)
 {
     pthread_mutex_init(&m_mutex, NULL);
-    sem_init(&m_sem_full,0,0);
-    sem_init(&m_sem_empty,0,size);
+    pthread_cond_init(&m_cond, NULL);
+    m_free.reserve(maxFree);
 }
 
-BufferQueue::~BufferQueue()
+BufferPool::~BufferPool()
 {
+    pthread_mutex_lock(&m_mutex);
+    if(m_inUse != 0)
+    {
+        SAPLOG_ERROR("SAP: BufferPool destroyed with %d buffers in use\n",m_inUse);
+    }
+    for(Buffer *item : m_free)
+    {
+        delete item;
+    }
+    m_free.clear();
+    pthread_mutex_unlock(&m_mutex);
+    pthread_cond_destroy(&m_cond);
     pthread_mutex_destroy(&m_mutex);
-    sem_destroy(&m_sem_empty);
-    sem_destroy(&m_sem_full);
 }
-void BufferQueue::preDelete()
+
+Buffer* BufferPool::acquire()
 {
-    clear();
-    sem_post(&m_sem_full);           
+    Buffer *item = NULL;
+    pthread_mutex_lock(&m_mutex);
+    if(!m_free.empty())
+    {
+        item = m_free.back();
+        m_free.pop_back();
+    }
+    m_inUse++;
+    pthread_mutex_unlock(&m_mutex);
+
+    if(item == NULL)
+    {
+        item = new Buffer(this,m_bufferSize);
+    }
+    item->setLength(0);
+    return item;
 }
 
-void BufferQueue::add(Buffer *data)
+void BufferPool::release(Buffer *item)
 {
-    sem_wait(&m_sem_empty);
     pthread_mutex_lock(&m_mutex);
-    m_buffer.push(data);
-    sem_post(&m_sem_full);
+    m_inUse--;
+    if((int)m_free.size() < m_maxFree)
+    {
+        m_free.push_back(item);
+        item = NULL;
+    }
+    pthread_cond_broadcast(&m_cond);
     pthread_mutex_unlock(&m_mutex);
+
+    if(item != NULL)
+    {
+        SAPLOG_TRACE("SAP: delete Buffer...");
+        delete item;
+    }
 }
 
-int BufferQueue::count()
+bool BufferPool::waitForSpace(int level,int timeout_ms)
+{
+    struct timespec deadline;
+    clock_gettime(CLOCK_REALTIME, &deadline);
+    deadline.tv_sec += timeout_ms / 1000;
+    deadline.tv_nsec += (timeout_ms % 1000) * 1000000L;
+    if(deadline.tv_nsec >= 1000000000L)
+    {
+        deadline.tv_sec++;
+        deadline.tv_nsec -= 1000000000L;
+    }
+
+    pthread_mutex_lock(&m_mutex);
+    while(m_inUse >= level)
+    {
+        if(pthread_cond_timedwait(&m_cond, &m_mutex, &deadline) != 0)
+            break;
+    }
+    bool space = m_inUse < level;
+    pthread_mutex_unlock(&m_mutex);
+    return space;
+}
+
+int BufferPool::inUse()
 {
-    int count;
     pthread_mutex_lock(&m_mutex);
-    //count = m_buffer.size();
-    sem_getvalue(&m_sem_full,&count); 
+    int count = m_inUse;
     pthread_mutex_unlock(&m_mutex);
     return count;
 }
 
+int BufferPool::bufferSize()
+{
+    return m_bufferSize;
+}
+
+//Decodes base64 straight into pool buffers, one buffer worth of input
+//(4 chars -> 3 bytes) at a time, and queues them. Returns the number of
+//buffers queued, or -1 if a segment does not decode.
+int BufferPool::decode(BufferQueue *queue,const uint8_t *data,size_t size,Decoder decoder)
+{
+    const size_t segment = (m_bufferSize / 3) * 4;
+    int queued = 0;
+    while(size > 0)
+    {
+        size_t len = std::min(size,segment);
+        Buffer *buffer = acquire();
+        size_t decoded = decoder(data,len,(uint8_t*)buffer->getBuffer());
+        if(decoded == 0)
+        {
+            buffer->release();
+            return -1;
+        }
+        buffer->setLength(decoded);
+        queue->add(buffer);
+        data += len;
+        size -= len;
+        queued++;
+    }
+    return queued;
+}
+
+static void futexWait(std::atomic<int> &word,int expected)
+{
+    syscall(SYS_futex, reinterpret_cast<int*>(&word), FUTEX_WAIT_PRIVATE, expected, NULL, NULL, 0);
+}
+
+static void futexWake(std::atomic<int> &word)
+{
+    syscall(SYS_futex, reinterpret_cast<int*>(&word), FUTEX_WAKE_PRIVATE, INT32_MAX, NULL, NULL, 0);
+}
+
+BufferQueue::BufferQueue(int size)
+    : m_head(0)
+    , m_tail(0)
+    , m_interrupted(false)
+    , m_dataSeq(0)
+    , m_spaceSeq(0)
+    , m_dataWaiters(0)
+    , m_spaceWaiters(0)
+{
+    //Power of two so that the free running indices wrap with a mask
+    uint32_t capacity = 1;
+    while(capacity < (uint32_t)size)
+        capacity <<= 1;
+    m_slots = new std::atomic<Buffer*>[capacity];
+    m_mask = capacity - 1;
+}
+
+BufferQueue::~BufferQueue()
+{
+    clear();
+    delete[] m_slots;
+}
+
+void BufferQueue::preDelete()
+{
+    clear();
+    //Let a blocked remove()/add() return so that its thread can exit
+    m_interrupted = true;
+    wake(m_dataSeq, m_dataWaiters);
+    wake(m_spaceSeq, m_spaceWaiters);
+}
+
+bool BufferQueue::canRemove()
+{
+    return m_interrupted || m_head.load() != m_tail.load();
+}
+
+bool BufferQueue::canAdd()
+{
+    return m_interrupted || m_head.load() - m_tail.load() <= m_mask;
+}
+
+void BufferQueue::wait(std::atomic<int> &seq,std::atomic<int> &waiters,bool (BufferQueue::*ready)())
+{
+    while(true)
+    {
+        int value = seq.load();
+        waiters++;
+        //Re-check after announcing ourselves, the other side only wakes if it sees a waiter
+        if((this->*ready)())
+        {
+            waiters--;
+            return;
+        }
+        futexWait(seq, value);
+        waiters--;
+    }
+}
+
+void BufferQueue::wake(std::atomic<int> &seq,std::atomic<int> &waiters)
+{
+    if(waiters.load() > 0)
+    {
+        seq++;
+        futexWake(seq);
+    }
+}
+
+void BufferQueue::add(Buffer *data)
+{
+    if(!canAdd())
+        wait(m_spaceSeq, m_spaceWaiters, &BufferQueue::canAdd);
+
+    if(m_interrupted)
+    {
+        data->release();
+        return;
+    }
+
+    uint32_t head = m_head.load(std::memory_order_relaxed);
+    m_slots[head & m_mask].store(data, std::memory_order_relaxed);
+    m_head.store(head + 1);
+    wake(m_dataSeq, m_dataWaiters);
+}
+
+Buffer* BufferQueue::take()
+{
+    uint32_t tail = m_tail.load();
+    while(tail != m_head.load())
+    {
+        //Slot stays valid until tail moves past it, a failed CAS means clear() got it first
+        Buffer *item = m_slots[tail & m_mask].load(std::memory_order_relaxed);
+        if(m_tail.compare_exchange_weak(tail, tail + 1))
+        {
+            wake(m_spaceSeq, m_spaceWaiters);
+            return item;
+        }
+    }
+    return NULL;
+}
+
+int BufferQueue::count()
+{
+    return (int)(m_head.load() - m_tail.load());
+}
+
 void BufferQueue::clear()
 {
     Buffer *item;
-    int value;
-    pthread_mutex_lock(&m_mutex);
-    while(!m_buffer.empty())
+    while((item = take()) != NULL)
     {
-        item = m_buffer.front();
-        m_buffer.pop();
-        item->deleteBuffer();
-	delete item;
-        sem_getvalue(&m_sem_full,&value);
-        if(value != 0)
-            sem_wait(&m_sem_full);
-        sem_post(&m_sem_empty);
+        item->release();
     }
-    pthread_mutex_unlock(&m_mutex);
 }
 
 bool BufferQueue::isFull()
 {
-    int value;
-    sem_getvalue(&m_sem_empty,&value);
-    if(value == 0)
-    {
-       return true;
-    }
-    return false;
+    return !canAdd();
 }
 
 bool BufferQueue::isEmpty()
 {
-    pthread_mutex_lock(&m_mutex);
-    if(m_buffer.empty())
-    {
-       pthread_mutex_unlock(&m_mutex);
-       return true;
-    }  
-    pthread_mutex_unlock(&m_mutex);
-    return false;
+    return m_head.load() == m_tail.load();
 }
 
 Buffer* BufferQueue::remove()
 {
-    Buffer *item = NULL;
-    sem_wait(&m_sem_full);
-    pthread_mutex_lock(&m_mutex);
-    if(!m_buffer.empty())
+    Buffer *item = take();
+    if(item == NULL && !m_interrupted)
     {
-        item = m_buffer.front();
-        m_buffer.pop();
-        sem_post(&m_sem_empty);
+        wait(m_dataSeq, m_dataWaiters, &BufferQueue::canRemove);
+        item = take();
     }
-    pthread_mutex_unlock(&m_mutex);
     return item;
 }
@@ -2,27 +2,64 @@
 #define BUFFERQUEUE_H_
 
 #include <pthread.h>
-#include <semaphore.h>
 #include <stdlib.h>
+#include <stdint.h>
 #include <cstring>
-#include <queue>
+#include <atomic>
+#include <vector>
 #include <stdio.h>
 #include <unistd.h>
 #include "logger.h"
 
+class BufferPool;
+class BufferQueue;
+
 struct Buffer
 {
-    Buffer()
-    {
-    }
-    void fillBuffer(const void *ptr,int len);
+    Buffer(BufferPool *pool,int capacity);
+    ~Buffer();
     int getLength();
+    void setLength(int len);
+    int getCapacity();
     char *getBuffer();   
-    void deleteBuffer();
+    void release();
     char *buff;
     int length;
+    int capacity;
+    BufferPool *pool;
 };
 
+//Recycles fixed size Buffers so that audio chunks can be handed to
+//gstreamer without a copy and without an allocation per chunk.
+//Buffers beyond maxFree are freed on release instead of being kept.
+class BufferPool
+{
+    public:
+    typedef size_t (*Decoder)(const uint8_t *input,size_t inputSize,uint8_t *output);
+
+    BufferPool(int bufferSize,int maxFree);
+    ~BufferPool();
+    Buffer* acquire();
+    void release(Buffer* item);
+    int decode(BufferQueue *queue,const uint8_t *data,size_t size,Decoder decoder);
+    bool waitForSpace(int level,int timeout_ms);
+    int inUse();
+    int bufferSize();
+
+    private:
+    std::vector<Buffer*> m_free;
+    pthread_mutex_t m_mutex;
+    pthread_cond_t m_cond;
+    int m_bufferSize;
+    int m_maxFree;
+    int m_inUse;
+};
+
+//Bounded ring of Buffer pointers between one producer (PlayBuffer or the
+//websocket thread) and the appsrc push thread. Slots are claimed with plain
+//atomics and waiters sleep on futexes, so the audio path takes no lock and
+//makes no syscall unless one side actually has to wait. The consumer side
+//claims slots with a CAS so that clear() may drain from the API thread.
 class BufferQueue
 {
     public:
@@ -37,9 +74,21 @@ class BufferQueue
     ~BufferQueue();
 
     private:
-    std::queue<Buffer*> m_buffer;
-    pthread_mutex_t m_mutex;
-    sem_t m_sem_full;
-    sem_t m_sem_empty;
+    Buffer* take();
+    void wait(std::atomic<int> &seq,std::atomic<int> &waiters,bool (BufferQueue::*ready)());
+    void wake(std::atomic<int> &seq,std::atomic<int> &waiters);
+    bool canRemove();
+    bool canAdd();
+
+    std::atomic<Buffer*> *m_slots;
+    uint32_t m_mask;
+    std::atomic<uint32_t> m_head;
+    std::atomic<uint32_t> m_tail;
+    std::atomic<bool> m_interrupted;
+    //futex words, bumped on every add/remove that may have a waiter
+    std::atomic<int> m_dataSeq;
+    std::atomic<int> m_spaceSeq;
+    std::atomic<int> m_dataWaiters;
+    std::atomic<int> m_spaceWaiters;
 };
 #endif
@@ -41,6 +41,7 @@
 #include "StateObserverHelper.h"
 #include "utils.h"
 #include "uploadlogs.h"
+#include "tr181client.h"
 
 #if defined(USE_IARMBUS) || defined(USE_IARM_BUS)
 #include "libIARM.h"
@@ -542,7 +543,7 @@ namespace WPEFramework {
             LOGINFO("requestSystemReboot: custom reason: %s, other reason: %s\n", rebootParam.reboot_reason_custom,
                 rebootParam.reboot_reason_other);
 
-            IARM_Result_t iarmcallstatus = IARM_Bus_Call(IARM_BUS_PWRMGR_NAME,
+            IARM_Result_t iarmcallstatus = IARM_BUS_CALL(IARM_BUS_PWRMGR_NAME,
                     IARM_BUS_PWRMGR_API_Reboot, &rebootParam, sizeof(rebootParam));
             if(IARM_RESULT_SUCCESS != iarmcallstatus) {
                 LOGWARN("requestSystemReboot: IARM_BUS_PWRMGR_API_Reboot failed with code %d.\n", iarmcallstatus); 
@@ -948,7 +949,7 @@ namespace WPEFramework {
 		IARM_Bus_MFRLib_GetSerializedData_Param_t param;
 		param.bufLen = 0;
 		param.type = mfrSERIALIZED_TYPE_SKYMODELNAME;
-		IARM_Result_t result = IARM_Bus_Call(IARM_BUS_MFRLIB_NAME, IARM_BUS_MFRLIB_API_GetSerializedData, &param, sizeof(param));
+		IARM_Result_t result = IARM_BUS_CALL(IARM_BUS_MFRLIB_NAME, IARM_BUS_MFRLIB_API_GetSerializedData, &param, sizeof(param));
 		param.buffer[param.bufLen] = '\0';
 		LOGWARN("SystemService getDeviceInfo param type %d result %s", param.type, param.buffer);
 		bool status = false;
@@ -980,7 +981,7 @@ namespace WPEFramework {
             IARM_Bus_MFRLib_GetSerializedData_Param_t param;
             param.bufLen = 0;
             param.type = mfrSERIALIZED_TYPE_MANUFACTURING_SERIALNUMBER;
-            IARM_Result_t result = IARM_Bus_Call(IARM_BUS_MFRLIB_NAME, IARM_BUS_MFRLIB_API_GetSerializedData, &param, sizeof(param));
+            IARM_Result_t result = IARM_BUS_CALL(IARM_BUS_MFRLIB_NAME, IARM_BUS_MFRLIB_API_GetSerializedData, &param, sizeof(param));
             param.buffer[param.bufLen] = '\0';
 
             bool status = false;
@@ -1017,7 +1018,7 @@ namespace WPEFramework {
             } else if (!parameter.compare(HARDWARE_ID)) {
                 param.type = mfrSERIALIZED_TYPE_HWID;
             }
-            IARM_Result_t result = IARM_Bus_Call(IARM_BUS_MFRLIB_NAME, IARM_BUS_MFRLIB_API_GetSerializedData, &param, sizeof(param));
+            IARM_Result_t result = IARM_BUS_CALL(IARM_BUS_MFRLIB_NAME, IARM_BUS_MFRLIB_API_GetSerializedData, &param, sizeof(param));
             param.buffer[param.bufLen] = '\0';
 
             LOGWARN("SystemService getDeviceInfo param type %d result %s", param.type, param.buffer);
@@ -1154,7 +1155,7 @@ namespace WPEFramework {
                         stringToIarmMode(oldMode, modeParam.oldMode);
                         stringToIarmMode(m_currentMode, modeParam.newMode);
 
-                        if (IARM_RESULT_SUCCESS == IARM_Bus_Call(IARM_BUS_DAEMON_NAME,
+                        if (IARM_RESULT_SUCCESS == IARM_BUS_CALL(IARM_BUS_DAEMON_NAME,
                                     "DaemonSysModeChange", &modeParam, sizeof(modeParam))) {
                             LOGWARN("switched to mode '%s'\n", m_currentMode.c_str());
 
@@ -1457,7 +1458,7 @@ namespace WPEFramework {
 			if (param.timeout < 0) {
 				param.timeout = 0;
 			}
-			IARM_Result_t res = IARM_Bus_Call(IARM_BUS_PWRMGR_NAME,
+			IARM_Result_t res = IARM_BUS_CALL(IARM_BUS_PWRMGR_NAME,
 					IARM_BUS_PWRMGR_API_SetDeepSleepTimeOut, (void *)&param,
 					sizeof(param));
 
@@ -1489,7 +1490,7 @@ namespace WPEFramework {
                  param.bStandbyMode = parameters["nwStandby"].Boolean();
                  LOGWARN("setNetworkStandbyMode called, with NwStandbyMode : %s\n",
                           (param.bStandbyMode)?("Enabled"):("Disabled"));
-                 IARM_Result_t res = IARM_Bus_Call(IARM_BUS_PWRMGR_NAME,
+                 IARM_Result_t res = IARM_BUS_CALL(IARM_BUS_PWRMGR_NAME,
                                         IARM_BUS_PWRMGR_API_SetNetworkStandbyMode, (void *)&param,
                                         sizeof(param));
 
@@ -1523,7 +1524,7 @@ namespace WPEFramework {
             }
             else {
                 IARM_Bus_PWRMgr_NetworkStandbyMode_Param_t param;
-                IARM_Result_t res = IARM_Bus_Call(IARM_BUS_PWRMGR_NAME,
+                IARM_Result_t res = IARM_BUS_CALL(IARM_BUS_PWRMGR_NAME,
                                        IARM_BUS_PWRMGR_API_GetNetworkStandbyMode, (void *)&param,
                                        sizeof(param));
                 bool nwStandby = param.bStandbyMode;
@@ -1620,7 +1621,7 @@ namespace WPEFramework {
 	    DeepSleep_WakeupReason_t param;
 	    std::string wakeupReason = "WAKEUP_REASON_UNKNOWN";
 
-	    IARM_Result_t res = IARM_Bus_Call(IARM_BUS_DEEPSLEEPMGR_NAME,
+	    IARM_Result_t res = IARM_BUS_CALL(IARM_BUS_DEEPSLEEPMGR_NAME,
 			IARM_BUS_DEEPSLEEPMGR_API_GetLastWakeupReason, (void *)&param,
 			sizeof(param));
 
@@ -1686,7 +1687,7 @@ namespace WPEFramework {
               IARM_Bus_DeepSleepMgr_WakeupKeyCode_Param_t param;
               uint32_t wakeupKeyCode = 0;
 
-              IARM_Result_t res = IARM_Bus_Call(IARM_BUS_DEEPSLEEPMGR_NAME,
+              IARM_Result_t res = IARM_BUS_CALL(IARM_BUS_DEEPSLEEPMGR_NAME,
                          IARM_BUS_DEEPSLEEPMGR_API_GetLastWakeupKeyCode, (void *)&param,
                          sizeof(param));
               if (IARM_RESULT_SUCCESS == res)
@@ -1774,63 +1775,15 @@ namespace WPEFramework {
          */
         bool SystemServices::getSerialNumberTR069(JsonObject& response)
         {
-            bool ret = false;
-            std::string curlResponse;
-            struct write_result write_result_buf;
-            CURLcode res = CURLE_OK;
-            CURL *curl = curl_easy_init();
-            char *data;
-            long http_code = 0;
-            struct curl_slist *headers = NULL;
-
-            data = (char*)malloc(CURL_BUFFER_SIZE);
-            if (!data) {
-                LOGERR("Error allocating %d bytes.\n", CURL_BUFFER_SIZE);
-                populateResponseWithError(SysSrv_DynamicMemoryAllocationFailed, response);
-                return ret;
-            }
-            write_result_buf.data = data;
-            write_result_buf.pos = 0;
-
-            if (curl) {
-                curl_easy_setopt(curl, CURLOPT_CUSTOMREQUEST, "POST");
-                curl_easy_setopt(curl, CURLOPT_URL, "http://127.0.0.1:10999/");
-                headers = curl_slist_append(headers, "cache-control: no-cache");
-                headers = curl_slist_append(headers, "content-type: application/json");
-                curl_easy_setopt(curl, CURLOPT_HTTPHEADER, headers);
-                curl_easy_setopt(curl, CURLOPT_POSTFIELDS,
-                        "{\"paramList\":[{\"name\":\"Device.DeviceInfo.SerialNumber\"}]}");
-                curl_easy_setopt(curl, CURLOPT_FOLLOWLOCATION, 1);
-                curl_easy_setopt(curl, CURLOPT_WRITEFUNCTION, curl_write);
-                curl_easy_setopt(curl, CURLOPT_WRITEDATA, &write_result_buf);
-                res = curl_easy_perform(curl);
-                curl_easy_getinfo(curl, CURLINFO_RESPONSE_CODE, &http_code);
-
-                /* null terminate the string */
-                data[write_result_buf.pos] = '\0';
-                curlResponse = data;
-                free(data);
-                curl_easy_cleanup(curl);
-            }
-            if (CURLE_OK == res) {
-                /* Eg: {"paramList":[{"name":"Device.DeviceInfo.SerialNumber",
-                   "value":"M11806TK0519"}]} */
-                LOGWARN("curl response : %s\n", curlResponse.c_str());
-                JsonObject curlRespJson;
-                JsonArray paramListJson;
-                curlRespJson.FromString(curlResponse);
-                paramListJson = curlRespJson["paramList"].Array();
-
-                for (int i = 0; i < paramListJson.Length(); i++) {
-                    curlRespJson = paramListJson[i].Object();
-                    response["serialNumber"] = curlRespJson["value"].String();
-                    ret = true;
-                    break;
-                }
-            } else {
+            /* Eg: {"paramList":[{"name":"Device.DeviceInfo.SerialNumber",
+               "value":"M11806TK0519"}]}, cached by the client after the first query */
+            std::string serialNumber;
+            if (!TR181Client::instance().getParameter("Device.DeviceInfo.SerialNumber", serialNumber)) {
                 populateResponseWithError(SysSrv_LibcurlError, response);
+                return false;
             }
-            return ret;
+            response["serialNumber"] = serialNumber;
+            return true;
         }
 
         /***
@@ -2940,7 +2893,7 @@ namespace WPEFramework {
                 methodType = parameters["param"].String();
                 if (SYSTEM_CHANNEL_MAP == methodType) {
                     LOGERR("methodType : %s\n", methodType.c_str());
-                    IARM_Bus_Call(IARM_BUS_SYSMGR_NAME, IARM_BUS_SYSMGR_API_GetSystemStates,
+                    IARM_BUS_CALL(IARM_BUS_SYSMGR_NAME, IARM_BUS_SYSMGR_API_GetSystemStates,
                             &paramGetSysState, sizeof(paramGetSysState));
                     response[SYSTEM_CHANNEL_MAP] = paramGetSysState.channel_map.state;
                     LOGWARN("SystemService querying channel_map, return\
@@ -3039,7 +2992,7 @@ namespace WPEFramework {
         {
            IARM_Result_t ret = IARM_RESULT_SUCCESS;
            TimerMsg param;
-           ret = IARM_Bus_Call(IARM_BUS_SYSTIME_MGR_NAME, TIMER_STATUS_MSG, (void*)&param, sizeof(param));
+           ret = IARM_BUS_CALL(IARM_BUS_SYSTIME_MGR_NAME, TIMER_STATUS_MSG, (void*)&param, sizeof(param));
            if (ret != IARM_RESULT_SUCCESS ) {
               LOGWARN ("Query to get Timer Status Failed..\n");
               returnResponse(false);
@@ -3418,7 +3371,7 @@ namespace WPEFramework {
                 LOGINFO("Got cached powerStateBeforeReboot: '%s'", m_powerStateBeforeReboot.c_str());
             } else {
                 IARM_Bus_PWRMgr_GetPowerStateBeforeReboot_Param_t param;
-                IARM_Result_t res = IARM_Bus_Call(IARM_BUS_PWRMGR_NAME,
+                IARM_Result_t res = IARM_BUS_CALL(IARM_BUS_PWRMGR_NAME,
                                        IARM_BUS_PWRMGR_API_GetPowerStateBeforeReboot, (void *)&param,
                                        sizeof(param));
     
@@ -3480,7 +3433,7 @@ namespace WPEFramework {
 
                 if(paramErr == 0) {
 
-                    IARM_Result_t res = IARM_Bus_Call(IARM_BUS_PWRMGR_NAME,
+                    IARM_Result_t res = IARM_BUS_CALL(IARM_BUS_PWRMGR_NAME,
                                            IARM_BUS_PWRMGR_API_SetWakeupSrcConfig, (void *)&param,
                                            sizeof(param));
 
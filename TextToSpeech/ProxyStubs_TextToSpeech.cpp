@@ -37,6 +37,7 @@ namespace ProxyStubs {
     //  (11) virtual uint32_t Resume(const string&, string&) = 0
     //  (12) virtual uint32_t IsSpeaking(const string&, string&) = 0
     //  (13) virtual uint32_t GetSpeechState(const string&, string&) = 0
+    //  (14) virtual uint32_t GetMetrics(const string&, string&) = 0
     //
 
     ProxyStub::MethodHandler TextToSpeechStubMethods[] = {
@@ -362,6 +363,27 @@ namespace ProxyStubs {
             writer.Text(param1);
         },
 
+        // virtual uint32_t GetMetrics(const string&, string&) = 0
+        //
+        [](Core::ProxyType<Core::IPCChannel>& channel VARIABLE_IS_NOT_USED, Core::ProxyType<RPC::InvokeMessage>& message) {
+            RPC::Data::Input& input(message->Parameters());
+
+            // read parameters
+            RPC::Data::Frame::Reader reader(input.Reader());
+            const string param0 = reader.Text();
+            string param1{}; // storage
+
+            // call implementation
+            ITextToSpeech* implementation = reinterpret_cast<ITextToSpeech*>(input.Implementation());
+            ASSERT((implementation != nullptr) && "Null ITextToSpeech implementation pointer");
+            const uint32_t output = implementation->GetMetrics(param0, param1);
+
+            // write return values
+            RPC::Data::Frame::Writer writer(message->Response().Writer());
+            writer.Number<const uint32_t>(output);
+            writer.Text(param1);
+        },
+
         nullptr
     }; // TextToSpeechStubMethods[]
 
@@ -573,6 +595,7 @@ namespace ProxyStubs {
     //  (11) virtual uint32_t Resume(const string&, string&) = 0
     //  (12) virtual uint32_t IsSpeaking(const string&, string&) = 0
     //  (13) virtual uint32_t GetSpeechState(const string&, string&) = 0
+    //  (14) virtual uint32_t GetMetrics(const string&, string&) = 0
     //
 
     class TextToSpeechProxy final : public ProxyStub::UnknownProxyType<ITextToSpeech> {
@@ -854,6 +877,26 @@ namespace ProxyStubs {
 
             return output;
         }
+
+        uint32_t GetMetrics(const string& param0, string& /* out */ param1) override
+        {
+            IPCMessage newMessage(BaseClass::Message(14));
+
+            // write parameters
+            RPC::Data::Frame::Writer writer(newMessage->Parameters().Writer());
+            writer.Text(param0);
+
+            // invoke the method handler
+            uint32_t output{};
+            if ((output = Invoke(newMessage)) == Core::ERROR_NONE) {
+                // read return values
+                RPC::Data::Frame::Reader reader(newMessage->Response().Reader());
+                output = reader.Number<uint32_t>();
+                param1 = reader.Text();
+            }
+
+            return output;
+        }
     }; // class TextToSpeechProxy
 
     //
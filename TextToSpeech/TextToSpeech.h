@@ -159,6 +159,7 @@ namespace Plugin {
         uint32_t Resume(const JsonObject& parameters, JsonObject& response);
         uint32_t IsSpeaking(const JsonObject& parameters, JsonObject& response);
         uint32_t GetSpeechState(const JsonObject& parameters, JsonObject& response);
+        uint32_t GetMetrics(const JsonObject& parameters, JsonObject& response);
         uint32_t SetACL(const JsonObject& parameters, JsonObject& response);
 
         //version number API's
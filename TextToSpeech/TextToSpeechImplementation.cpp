@@ -356,6 +356,46 @@ namespace Plugin {
         returnResponse(status == TTS::TTS_OK);
     }
 
+    uint32_t TextToSpeechImplementation::GetMetrics(const string &input, string &output)
+    {
+        CONVERT_PARAMETERS_TOJSON();
+        CHECK_TTS_MANAGER_RETURN_ON_FAIL();
+
+        _adminLock.Lock();
+
+        TTS::SpeechMetrics metrics;
+        auto status = _ttsManager->getMetrics(metrics);
+
+        _adminLock.Unlock();
+
+        if(status == TTS::TTS_OK) {
+            JsonObject timeToFirstAudio;
+            timeToFirstAudio["last"] = metrics.lastTimeToFirstAudio;
+            timeToFirstAudio["min"] = metrics.minTimeToFirstAudio;
+            timeToFirstAudio["max"] = metrics.maxTimeToFirstAudio;
+            timeToFirstAudio["average"] = metrics.spoken ?
+                (uint32_t) (metrics.totalTimeToFirstAudio / metrics.spoken) : 0;
+            timeToFirstAudio["averagecached"] = metrics.cacheHits ?
+                (uint32_t) (metrics.totalCachedTimeToFirstAudio / metrics.cacheHits) : 0;
+            timeToFirstAudio["averageuncached"] = (metrics.spoken > metrics.cacheHits) ?
+                (uint32_t) ((metrics.totalTimeToFirstAudio - metrics.totalCachedTimeToFirstAudio) / (metrics.spoken - metrics.cacheHits)) : 0;
+
+            JsonObject cache;
+            cache["entries"] = (uint32_t) metrics.cacheEntries;
+            cache["bytes"] = (uint32_t) metrics.cacheBytes;
+            cache["capacity"] = (uint32_t) metrics.cacheCapacity;
+
+            response["spoken"] = metrics.spoken;
+            response["cachehits"] = metrics.cacheHits;
+            response["prefetched"] = metrics.prefetched;
+            response["timetofirstaudio"] = timeToFirstAudio;
+            response["cache"] = cache;
+        }
+
+        logResponse(status, response);
+        returnResponse(status == TTS::TTS_OK);
+    }
+
     void TextToSpeechImplementation::setResponseArray(JsonObject& response, const char* key, const std::vector<std::string>& items)
     {
         JsonArray arr;
@@ -104,6 +104,7 @@ namespace Plugin {
         virtual uint32_t Resume(const string &input, string &output /* @out */) override ;
         virtual uint32_t IsSpeaking(const string &input, string &output /* @out */) override ;
         virtual uint32_t GetSpeechState(const string &input, string &output /* @out */) override ;
+        virtual uint32_t GetMetrics(const string &input, string &output /* @out */) override ;
 
         virtual void onTTSStateChanged(bool enabled) override ;
         virtual void onVoiceChanged(std::string voice) override ;
@@ -0,0 +1,98 @@
+/*
+ * If not stated otherwise in this file or this component's LICENSE file the
+ * following copyright and licenses apply:
+ *
+ * Copyright 2020 RDK Management
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "TTSAudioCache.h"
+
+namespace TTS {
+
+TTSAudioCache::TTSAudioCache(size_t capacity) :
+    m_bytes(0),
+    m_capacity(capacity) {
+}
+
+TTSAudioCache::~TTSAudioCache() {
+    clear();
+}
+
+TTSAudioCache::AudioData TTSAudioCache::get(const std::string &key) {
+    std::lock_guard<std::mutex> lock(m_mutex);
+
+    auto it = m_index.find(key);
+    if(it == m_index.end())
+        return AudioData();
+
+    // Move to front (most recently used)
+    m_entries.splice(m_entries.begin(), m_entries, it->second);
+    return it->second->second;
+}
+
+bool TTSAudioCache::contains(const std::string &key) {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_index.find(key) != m_index.end();
+}
+
+void TTSAudioCache::put(const std::string &key, AudioData audio) {
+    if(!audio || audio->empty() || audio->size() > m_capacity)
+        return;
+
+    std::lock_guard<std::mutex> lock(m_mutex);
+
+    auto it = m_index.find(key);
+    if(it != m_index.end()) {
+        m_bytes -= it->second->second->size();
+        m_entries.erase(it->second);
+        m_index.erase(it);
+    }
+
+    evict(audio->size());
+
+    m_entries.emplace_front(key, audio);
+    m_index[key] = m_entries.begin();
+    m_bytes += audio->size();
+}
+
+void TTSAudioCache::clear() {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_index.clear();
+    m_entries.clear();
+    m_bytes = 0;
+}
+
+size_t TTSAudioCache::bytes() {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_bytes;
+}
+
+size_t TTSAudioCache::entries() {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_entries.size();
+}
+
+void TTSAudioCache::evict(size_t required) {
+    // Entries are shared_ptr's, audio that is currently being played
+    // stays alive until the GstBuffer wrapping it is released
+    while(!m_entries.empty() && m_bytes + required > m_capacity) {
+        auto &last = m_entries.back();
+        m_bytes -= last.second->size();
+        m_index.erase(last.first);
+        m_entries.pop_back();
+    }
+}
+
+} // namespace TTS
@@ -0,0 +1,66 @@
+/*
+ * If not stated otherwise in this file or this component's LICENSE file the
+ * following copyright and licenses apply:
+ *
+ * Copyright 2020 RDK Management
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef _TTS_AUDIO_CACHE_H_
+#define _TTS_AUDIO_CACHE_H_
+
+#include <list>
+#include <mutex>
+#include <string>
+#include <vector>
+#include <memory>
+#include <unordered_map>
+
+namespace TTS {
+
+// Byte-bounded LRU of synthesized audio. The key is the fully constructed
+// TTS request URL, which already encodes endpoint, voice, language, rate and
+// the sanitized text, so two requests share an entry only if the TTS engine
+// would have returned the same audio for both.
+class TTSAudioCache {
+public:
+    typedef std::shared_ptr<const std::vector<char>> AudioData;
+
+    TTSAudioCache(size_t capacity);
+    ~TTSAudioCache();
+
+    AudioData get(const std::string &key);
+    bool contains(const std::string &key);
+    void put(const std::string &key, AudioData audio);
+    void clear();
+
+    size_t capacity() const { return m_capacity; }
+    size_t bytes();
+    size_t entries();
+
+private:
+    typedef std::list<std::pair<std::string, AudioData>> EntryList;
+
+    void evict(size_t required);
+
+    std::mutex m_mutex;
+    EntryList m_entries; // most recently used first
+    std::unordered_map<std::string, EntryList::iterator> m_index;
+    size_t m_bytes;
+    const size_t m_capacity;
+};
+
+} // namespace TTS
+
+#endif
@@ -202,6 +202,16 @@ TTS_Error TTSManager::getSpeechState(uint32_t id, SpeechState &state) {
     return TTS_OK;
 }
 
+TTS_Error TTSManager::getMetrics(SpeechMetrics &metrics) {
+    TTSLOG_TRACE("getMetrics");
+
+    if(!m_speaker)
+        return TTS_FAIL;
+
+    m_speaker->getMetrics(metrics);
+    return TTS_OK;
+}
+
 void TTSManager::willSpeak(uint32_t speech_id, std::string text) {
     TTSLOG_TRACE(" [%d, %s]", speech_id, text.c_str());
 
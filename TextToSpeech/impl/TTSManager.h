@@ -77,6 +77,7 @@ public:
     TTS_Error shut(uint32_t id);
     TTS_Error isSpeaking(uint32_t id, bool &speaking);
     TTS_Error getSpeechState(uint32_t id, SpeechState &state);
+    TTS_Error getMetrics(SpeechMetrics &metrics);
     TTS_Error clearAudioPipeline();
 
     virtual TTSConfiguration *configuration() {return &m_defaultConfiguration;}
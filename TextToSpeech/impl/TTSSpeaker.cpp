@@ -22,8 +22,12 @@
 #include <curl/curl.h>
 #include <unistd.h>
 #include <regex>
+#include <algorithm>
 
 #define INT_FROM_ENV(env, default_value) ((getenv(env) ? atoi(getenv(env)) : 0) > 0 ? atoi(getenv(env)) : default_value)
+#define TTS_AUDIO_CACHE_SIZE_KB 2048
+#define TTS_CACHEABLE_TEXT_LENGTH 64
+#define TTS_PREFETCH_TIMEOUT_S 10
 #define TTS_CONFIGURATION_STORE "/opt/persistent/tts.setting.ini"
 #define UPDATE_AND_RETURN(o, n) if(o != n) { o = n; return true; }
 
@@ -171,8 +175,16 @@ TTSSpeaker::TTSSpeaker(TTSConfiguration &config) :
     m_currentSpeech(NULL),
     m_isSpeaking(false),
     m_isPaused(false),
+    m_audioCache(NULL),
+    m_prefetchThread(NULL),
+    m_cacheableTextLength(INT_FROM_ENV("TTS_CACHEABLE_TEXT_LENGTH", TTS_CACHEABLE_TEXT_LENGTH)),
+    m_firstAudioPending(false),
+    m_playingFromCache(false),
     m_pipeline(NULL),
     m_source(NULL),
+    m_cacheSource(NULL),
+    m_sourcePeer(NULL),
+    m_cacheSourceActive(false),
     m_audioSink(NULL),
     m_audioVolume(NULL),
     m_main_loop(NULL),
@@ -198,6 +210,13 @@ TTSSpeaker::TTSSpeaker(TTSConfiguration &config) :
         setenv("GST_REGISTRY_UPDATE", "no", 0);
         setenv("GST_REGISTRY_FORK", "no", 0);
 
+        // TTS_AUDIO_CACHE_SIZE_KB=0 disables the audio cache along with prefetching
+        const char *cacheSize = getenv("TTS_AUDIO_CACHE_SIZE_KB");
+        if(!cacheSize || atoi(cacheSize) > 0) {
+            m_audioCache = new TTSAudioCache(INT_FROM_ENV("TTS_AUDIO_CACHE_SIZE_KB", TTS_AUDIO_CACHE_SIZE_KB) * 1024);
+            m_prefetchThread = new std::thread(PrefetchThreadFunc, this);
+        }
+
         m_main_loop_thread = g_thread_new("BusWatch", (void* (*)(void*)) event_loop, this);
         m_gstThread = new std::thread(GStreamerThreadFunc, this);
 
@@ -222,6 +241,21 @@ TTSSpeaker::~TTSSpeaker() {
         m_gstThread = NULL;
     }
 
+    if(m_prefetchThread) {
+        {
+            std::lock_guard<std::mutex> lock(m_prefetchMutex);
+            m_prefetchList.clear();
+            m_prefetchCondition.notify_one();
+        }
+        m_prefetchThread->join();
+        m_prefetchThread = NULL;
+    }
+
+    if(m_audioCache) {
+        delete m_audioCache;
+        m_audioCache = NULL;
+    }
+
     if(g_main_loop_is_running(m_main_loop))
         g_main_loop_quit(m_main_loop);
     g_thread_join(m_main_loop_thread);
@@ -242,6 +276,10 @@ int TTSSpeaker::speak(TTSSpeakerClient *client, uint32_t id, std::string text, b
         reset();
 
     SpeechData data(client, id, text, secure);
+    // Built here, under the API lock that configuration changes take too,
+    // the prefetch thread never reads the client configuration
+    if(m_audioCache)
+        data.url = constructURL(*client->configuration(), data);
     queueData(data);
 
     return 0;
@@ -298,6 +336,7 @@ bool TTSSpeaker::reset() {
     TTSLOG_VERBOSE("Resetting Speaker");
     cancelSpeech();
     flushQueue();
+    flushPrefetch();
 
     return true;
 }
@@ -345,9 +384,18 @@ void TTSSpeaker::setSpeakingState(bool state, TTSSpeakerClient *client) {
 }
 
 void TTSSpeaker::queueData(SpeechData data) {
-    std::lock_guard<std::mutex> lock(m_queueMutex);
-    m_queue.push_back(data);
-    m_condition.notify_one();
+    bool busy = false;
+    {
+        std::lock_guard<std::mutex> lock(m_queueMutex);
+        m_queue.push_back(data);
+        busy = m_isSpeaking || m_queue.size() > 1;
+        m_condition.notify_one();
+    }
+
+    // Speaker will pick this up right away if it is idle, fetching ahead
+    // only helps when something else is playing
+    if(busy)
+        prefetchNext();
 }
 
 void TTSSpeaker::flushQueue() {
@@ -581,11 +629,13 @@ void TTSSpeaker::createPipeline() {
         gst_bin_add_many(GST_BIN(m_pipeline), m_source, decodebin, m_audioSink, NULL);
         result &= gst_element_link (m_source, decodebin);
         result &= gst_element_link (decodebin, m_audioSink);
+        m_sourcePeer = decodebin;
     }
     else {
         TTSLOG_INFO("PCM audio capsfilter added to sink");
         gst_bin_add_many(GST_BIN(m_pipeline), m_source, capsfilter, m_audioSink,NULL);
         result = gst_element_link_many (m_source,capsfilter,m_audioSink,NULL);
+        m_sourcePeer = capsfilter;
     }
 #elif defined(PLATFORM_AMLOGIC)
     if(!m_pcmAudioEnabled) {
@@ -597,11 +647,13 @@ void TTSSpeaker::createPipeline() {
         result &= gst_element_link (decodebin, convert);
         result &= gst_element_link (convert, resample);
         result &= gst_element_link (resample, m_audioSink);
+        m_sourcePeer = parser;
     }
     else {
         TTSLOG_INFO("PCM audio capsfilter  added to sink");
         gst_bin_add_many(GST_BIN(m_pipeline), m_source, capsfilter, convert, resample, m_audioSink, NULL);
         result = gst_element_link_many (m_source,capsfilter,convert,resample,m_audioSink,NULL);
+        m_sourcePeer = capsfilter;
     }
 #elif defined(PLATFORM_REALTEK)
     audiocaps = gst_caps_new_simple("audio/x-raw", "channels", G_TYPE_INT, 2, "rate", G_TYPE_INT, 48000, NULL);
@@ -609,11 +661,13 @@ void TTSSpeaker::createPipeline() {
     if(!m_pcmAudioEnabled) {
         gst_bin_add_many(GST_BIN(m_pipeline), m_source, parse, convert, resample, audiofilter, decodebin, m_audioSink, m_audioVolume, NULL);
         gst_element_link_many (m_source, parse, decodebin, convert, resample, audiofilter, m_audioVolume, m_audioSink, NULL);
+        m_sourcePeer = parse;
     }
     else {
         TTSLOG_INFO("PCM audio capsfilter added to sink");
         gst_bin_add_many(GST_BIN(m_pipeline), m_source, m_audioVolume, convert, resample, m_audioSink,  NULL);
         gst_element_link_many (m_source, convert, resample, audiofilter, m_audioVolume, m_audioSink, NULL);
+        m_sourcePeer = convert;
     }
 #endif
 
@@ -621,10 +675,37 @@ void TTSSpeaker::createPipeline() {
         TTSLOG_ERROR("failed to link elements!");
         gst_object_unref(m_pipeline);
         m_pipeline = NULL;
+        m_sourcePeer = NULL;
         m_pipelineConstructionFailures++;
         return;
     }
 
+    // Alternate source for utterances found in the audio cache. It sits
+    // unlinked & state-locked in the bin until selectSource() swaps it in
+    // place of the http source.
+    if(m_audioCache && m_source && m_sourcePeer) {
+        m_cacheSource = gst_element_factory_make("appsrc", NULL);
+        if(m_cacheSource) {
+            g_object_set(G_OBJECT(m_cacheSource),
+                    "stream-type", GST_APP_STREAM_TYPE_STREAM,
+                    "format", GST_FORMAT_BYTES, NULL);
+            gst_element_set_locked_state(m_cacheSource, TRUE);
+            gst_bin_add(GST_BIN(m_pipeline), m_cacheSource);
+        } else {
+            TTSLOG_WARNING("Unable to create appsrc, audio cache will not be used for playback");
+        }
+    }
+    m_cacheSourceActive = false;
+
+    // Short phrases are kept as they stream from the http source
+    if(m_audioCache && m_source) {
+        GstPad *pad = gst_element_get_static_pad(m_source, "src");
+        if(pad) {
+            gst_pad_add_probe(pad, GST_PAD_PROBE_TYPE_BUFFER, captureProbe, this, NULL);
+            gst_object_unref(pad);
+        }
+    }
+
     TTSLOG_WARNING ("gst_element_get_bus\n");
     GstBus *bus = gst_element_get_bus(m_pipeline);
     m_busWatch = gst_bus_add_watch(bus, GstBusCallback, (gpointer)(this));
@@ -673,11 +754,58 @@ void TTSSpeaker::destroyPipeline() {
 
     m_busWatch = 0;
     m_pipeline = NULL;
+    m_cacheSource = NULL;
+    m_sourcePeer = NULL;
+    m_cacheSourceActive = false;
     m_pipelineConstructionFailures = 0;
     m_condition.notify_one();
 }
 
-void TTSSpeaker::waitForAudioToFinishTimeout(float timeout_s) {
+bool TTSSpeaker::selectSource(bool cached) {
+    if(!m_cacheSource || !m_source || !m_sourcePeer)
+        return !cached;
+
+    if(cached == m_cacheSourceActive)
+        return true;
+
+    // Must be called only while the pipeline is in NULL state
+    GstElement *from = cached ? m_source : m_cacheSource;
+    GstElement *to = cached ? m_cacheSource : m_source;
+
+    gst_element_unlink(from, m_sourcePeer);
+    gst_element_set_locked_state(from, TRUE);
+    gst_element_set_locked_state(to, FALSE);
+
+    if(!gst_element_link(to, m_sourcePeer)) {
+        TTSLOG_ERROR("Failed to link %s source", cached ? "cache" : "http");
+        gst_element_set_locked_state(to, TRUE);
+        gst_element_set_locked_state(from, FALSE);
+        gst_element_link(from, m_sourcePeer);
+        return false;
+    }
+
+    m_cacheSourceActive = cached;
+    return true;
+}
+
+static void releaseCachedAudio(gpointer data) {
+    delete (TTSAudioCache::AudioData*) data;
+}
+
+void TTSSpeaker::pushCachedAudio(TTSAudioCache::AudioData &audio) {
+    // Wrap the cached bytes without copying, the buffer holds a reference
+    // to the cache entry so eviction while playing is harmless
+    TTSAudioCache::AudioData *ref = new TTSAudioCache::AudioData(audio);
+    GstBuffer *buffer = gst_buffer_new_wrapped_full(GST_MEMORY_FLAG_READONLY,
+            (gpointer) audio->data(), audio->size(), 0, audio->size(), ref, releaseCachedAudio);
+
+    g_object_set(G_OBJECT(m_cacheSource), "size", (gint64) audio->size(), NULL);
+    if(gst_app_src_push_buffer(GST_APP_SRC(m_cacheSource), buffer) != GST_FLOW_OK)
+        TTSLOG_ERROR("Failed to push cached audio to appsrc");
+    gst_app_src_end_of_stream(GST_APP_SRC(m_cacheSource));
+}
+
+bool TTSSpeaker::waitForAudioToFinishTimeout(float timeout_s) {
     TTSLOG_TRACE("timeout_s=%f", timeout_s);
 
     auto timeout = std::chrono::system_clock::now() + std::chrono::seconds((unsigned long)timeout_s);
@@ -727,9 +855,11 @@ void TTSSpeaker::waitForAudioToFinishTimeout(float timeout_s) {
     if(m_pipeline)
         gst_element_set_state(m_pipeline, GST_STATE_NULL);
 
-    if(!m_isEOS)
+    bool eos = m_isEOS;
+    if(!eos)
         TTSLOG_ERROR("Stopped waiting for audio to finish without hitting EOS!");
     m_isEOS = false;
+    return eos;
 }
 
 void TTSSpeaker::replaceIfIsolated(std::string& text, const std::string& search, const std::string& replace) {
@@ -857,10 +987,36 @@ void TTSSpeaker::speakText(TTSConfiguration config, SpeechData &data) {
     if(m_pipeline && !m_pipelineError && !m_flushed) {
         m_currentSpeech = &data;
 
-        g_object_set(G_OBJECT(m_source), "location", constructURL(config, data).c_str(), NULL);
+        std::string url = constructURL(config, data);
+        TTSAudioCache::AudioData audio;
+        if(m_audioCache && !url.empty())
+            audio = m_audioCache->get(url);
+
+        bool cached = audio && selectSource(true);
+        if(!cached) {
+            selectSource(false);
+            g_object_set(G_OBJECT(m_source), "location", url.c_str(), NULL);
+        }
+
+        // Short phrases (menu items, button labels...) tend to be repeated by
+        // screen readers, keep them around for the next time
+        if(!cached && m_audioCache && data.text.length() <= m_cacheableTextLength)
+            startCapture();
+
+        {
+            std::lock_guard<std::mutex> lock(m_metricsMutex);
+            m_speechStartTime = std::chrono::steady_clock::now();
+            m_firstAudioPending = true;
+            m_playingFromCache = cached;
+        }
+
         // PCM Sink seems to be accepting volume change before PLAYING state
         g_object_set(G_OBJECT(m_audioVolume), "volume", (double) (data.client->configuration()->volume() / MAX_VOLUME), NULL);
         gst_element_set_state(m_pipeline, GST_STATE_PLAYING);
+        if(cached) {
+            TTSLOG_INFO("Playing speech %d from audio cache", data.id);
+            pushCachedAudio(audio);
+        }
 #if defined(PLATFORM_AMLOGIC)
         //-12db is almost 25%
         setMixGain(MIXGAIN_PRIM,-12);
@@ -868,19 +1024,220 @@ void TTSSpeaker::speakText(TTSConfiguration config, SpeechData &data) {
         TTSLOG_VERBOSE("Speaking.... ( %d, \"%s\")", data.id, data.text.c_str());
 
         //Wait for EOS with a timeout incase EOS never comes
+        bool completed = false;
         if(m_pcmAudioEnabled) {
             //FIXME, find out way to EOS or position for raw PCM audio
-            waitForAudioToFinishTimeout(60);
+            completed = waitForAudioToFinishTimeout(60);
         }
         else {
-            waitForAudioToFinishTimeout(10);
+            completed = waitForAudioToFinishTimeout(10);
         }
+
+        {
+            std::lock_guard<std::mutex> lock(m_metricsMutex);
+            m_firstAudioPending = false;
+        }
+
+        std::shared_ptr<std::vector<char>> captured = stopCapture();
+        if(captured && !captured->empty() && completed && !m_flushed && !m_pipelineError)
+            m_audioCache->put(url, captured);
     } else {
         TTSLOG_WARNING("m_pipeline=%p, m_pipelineError=%d", m_pipeline, m_pipelineError);
     }
     m_currentSpeech = NULL;
 }
 
+void TTSSpeaker::prefetchNext() {
+    if(!m_audioCache)
+        return;
+
+    std::string url;
+    {
+        std::lock_guard<std::mutex> lock(m_queueMutex);
+        if(m_queue.empty())
+            return;
+        url = m_queue.front().url;
+    }
+
+    if(!url.empty())
+        schedulePrefetch(url);
+}
+
+void TTSSpeaker::schedulePrefetch(const std::string &url) {
+    if(!m_audioCache || m_audioCache->contains(url))
+        return;
+
+    std::lock_guard<std::mutex> lock(m_prefetchMutex);
+    if(std::find(m_prefetchList.begin(), m_prefetchList.end(), url) != m_prefetchList.end())
+        return;
+
+    m_prefetchList.push_back(url);
+    m_prefetchCondition.notify_one();
+}
+
+void TTSSpeaker::flushPrefetch() {
+    std::lock_guard<std::mutex> lock(m_prefetchMutex);
+    m_prefetchList.clear();
+}
+
+struct FetchContext {
+    std::vector<char> *audio;
+    size_t limit;
+};
+
+static size_t appendAudio(char *ptr, size_t size, size_t nmemb, void *userdata) {
+    FetchContext *ctx = (FetchContext*) userdata;
+    size_t bytes = size * nmemb;
+
+    // Too large to be worth caching, abort the transfer
+    if(ctx->audio->size() + bytes > ctx->limit)
+        return 0;
+
+    ctx->audio->insert(ctx->audio->end(), ptr, ptr + bytes);
+    return bytes;
+}
+
+bool TTSSpeaker::fetchAudio(void *handle, const std::string &url, std::vector<char> &audio) {
+    CURL *curl = (CURL*) handle;
+    FetchContext ctx = { &audio, m_audioCache->capacity() / 4 };
+
+    curl_easy_setopt(curl, CURLOPT_URL, url.c_str());
+    curl_easy_setopt(curl, CURLOPT_WRITEFUNCTION, appendAudio);
+    curl_easy_setopt(curl, CURLOPT_WRITEDATA, &ctx);
+    curl_easy_setopt(curl, CURLOPT_TIMEOUT, TTS_PREFETCH_TIMEOUT_S);
+    curl_easy_setopt(curl, CURLOPT_NOSIGNAL, 1L);
+    curl_easy_setopt(curl, CURLOPT_FOLLOWLOCATION, 1L);
+
+    CURLcode res = curl_easy_perform(curl);
+    long httpCode = 0;
+    curl_easy_getinfo(curl, CURLINFO_RESPONSE_CODE, &httpCode);
+    if(res != CURLE_OK || httpCode != 200) {
+        TTSLOG_WARNING("Prefetch failed, curl=%d (%s), http=%ld", res, curl_easy_strerror(res), httpCode);
+        return false;
+    }
+
+    return !audio.empty();
+}
+
+void TTSSpeaker::PrefetchThreadFunc(void *ctx) {
+    TTSLOG_INFO("Starting PrefetchThread");
+    TTSSpeaker *speaker = (TTSSpeaker*) ctx;
+
+    // Handle is reused for every request so that the connection to the
+    // TTS endpoint is kept alive between utterances
+    CURL *curl = curl_easy_init();
+    if(!curl) {
+        TTSLOG_ERROR("Unable to create curl handle, prefetching is disabled");
+        return;
+    }
+
+    while(speaker->m_runThread) {
+        std::string url;
+        {
+            std::unique_lock<std::mutex> lock(speaker->m_prefetchMutex);
+            speaker->m_prefetchCondition.wait(lock, [speaker] () {
+                    return !speaker->m_prefetchList.empty() || !speaker->m_runThread;
+                });
+
+            if(!speaker->m_runThread)
+                break;
+
+            url = speaker->m_prefetchList.front();
+            speaker->m_prefetchList.pop_front();
+        }
+
+        if(speaker->m_audioCache->contains(url))
+            continue;
+
+        auto start = std::chrono::steady_clock::now();
+        std::shared_ptr<std::vector<char>> audio = std::make_shared<std::vector<char>>();
+        if(speaker->fetchAudio(curl, url, *audio)) {
+            speaker->m_audioCache->put(url, audio);
+
+            std::lock_guard<std::mutex> lock(speaker->m_metricsMutex);
+            speaker->m_metrics.prefetched++;
+            TTSLOG_INFO("Prefetched %zu bytes in %lld ms", audio->size(), (long long)
+                    std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - start).count());
+        }
+    }
+
+    curl_easy_cleanup(curl);
+    TTSLOG_INFO("Stopping PrefetchThread");
+}
+
+void TTSSpeaker::startCapture() {
+    std::lock_guard<std::mutex> lock(m_captureMutex);
+    m_captured = std::make_shared<std::vector<char>>();
+}
+
+std::shared_ptr<std::vector<char>> TTSSpeaker::stopCapture() {
+    std::lock_guard<std::mutex> lock(m_captureMutex);
+    std::shared_ptr<std::vector<char>> captured;
+    captured.swap(m_captured);
+    return captured;
+}
+
+GstPadProbeReturn TTSSpeaker::captureProbe(GstPad *, GstPadProbeInfo *info, gpointer data) {
+    TTSSpeaker *speaker = (TTSSpeaker*) data;
+    GstBuffer *buffer = GST_PAD_PROBE_INFO_BUFFER(info);
+    if(!buffer)
+        return GST_PAD_PROBE_OK;
+
+    std::lock_guard<std::mutex> lock(speaker->m_captureMutex);
+    if(!speaker->m_captured)
+        return GST_PAD_PROBE_OK;
+
+    // Too large to be worth caching, same limit as prefetching
+    size_t size = gst_buffer_get_size(buffer);
+    size_t offset = speaker->m_captured->size();
+    if(offset + size > speaker->m_audioCache->capacity() / 4) {
+        speaker->m_captured.reset();
+        return GST_PAD_PROBE_OK;
+    }
+
+    speaker->m_captured->resize(offset + size);
+    gst_buffer_extract(buffer, 0, speaker->m_captured->data() + offset, size);
+    return GST_PAD_PROBE_OK;
+}
+
+void TTSSpeaker::recordFirstAudio() {
+    std::lock_guard<std::mutex> lock(m_metricsMutex);
+    if(!m_firstAudioPending)
+        return;
+
+    m_firstAudioPending = false;
+    uint32_t elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(
+            std::chrono::steady_clock::now() - m_speechStartTime).count();
+
+    m_metrics.spoken++;
+    if(m_playingFromCache) {
+        m_metrics.cacheHits++;
+        m_metrics.totalCachedTimeToFirstAudio += elapsed;
+    }
+
+    m_metrics.lastTimeToFirstAudio = elapsed;
+    if(m_metrics.spoken == 1 || elapsed < m_metrics.minTimeToFirstAudio)
+        m_metrics.minTimeToFirstAudio = elapsed;
+    if(elapsed > m_metrics.maxTimeToFirstAudio)
+        m_metrics.maxTimeToFirstAudio = elapsed;
+    m_metrics.totalTimeToFirstAudio += elapsed;
+
+    TTSLOG_INFO("Time to first audio %u ms (%s)", elapsed, m_playingFromCache ? "cache" : "http");
+}
+
+void TTSSpeaker::getMetrics(SpeechMetrics &metrics) {
+    {
+        std::lock_guard<std::mutex> lock(m_metricsMutex);
+        metrics = m_metrics;
+    }
+
+    if(m_audioCache) {
+        metrics.cacheEntries = m_audioCache->entries();
+        metrics.cacheBytes = m_audioCache->bytes();
+        metrics.cacheCapacity = m_audioCache->capacity();
+    }
+}
+
 void TTSSpeaker::event_loop(void *data)
 {
     TTSSpeaker *speaker= (TTSSpeaker*) data;
@@ -939,6 +1296,9 @@ void TTSSpeaker::GStreamerThreadFunc(void *ctx) {
         TTSLOG_INFO("Got text input, list size=%d", speaker->m_queue.size());
         SpeechData data = speaker->dequeueData();
 
+        // Fetch the following utterance while this one is being spoken
+        speaker->prefetchNext();
+
         speaker->setSpeakingState(true, data.client);
         // Inform the client before speaking
         if(!speaker->m_flushed)
@@ -1057,6 +1417,7 @@ bool TTSSpeaker::handleMessage(GstMessage *message) {
                             m_clientSpeaking->resumed(m_currentSpeech->id);
                             m_condition.notify_one();
                         } else {
+                            recordFirstAudio();
                             m_clientSpeaking->started(m_currentSpeech->id, m_currentSpeech->text);
                         }
                     }
@@ -23,15 +23,18 @@
 #include <gst/gst.h>
 #include <gst/audio/audio.h>
 #include <gst/app/gstappsink.h>
+#include <gst/app/gstappsrc.h>
 
 #include <map>
 #include <list>
 #include <mutex>
+#include <chrono>
 #include <thread>
 #include <vector>
 #include <condition_variable>
 
 #include "TTSCommon.h"
+#include "TTSAudioCache.h"
 
 #if defined(PLATFORM_AMLOGIC)
 #include "audio_if.h"
@@ -114,6 +117,7 @@ struct SpeechData {
             id = n.id;
             text = n.text;
             secure = n.secure;
+            url = n.url;
         }
         ~SpeechData() {}
 
@@ -121,6 +125,31 @@ struct SpeechData {
         bool secure;
         uint32_t id;
         std::string text;
+        std::string url; // Built when queued, for prefetching only
+};
+
+struct SpeechMetrics {
+    SpeechMetrics() :
+        spoken(0), cacheHits(0), prefetched(0),
+        lastTimeToFirstAudio(0), minTimeToFirstAudio(0), maxTimeToFirstAudio(0),
+        totalTimeToFirstAudio(0), totalCachedTimeToFirstAudio(0),
+        cacheEntries(0), cacheBytes(0), cacheCapacity(0) {}
+
+    uint32_t spoken;        // Utterances that reached PLAYING
+    uint32_t cacheHits;     // ...of which were played from the audio cache
+    uint32_t prefetched;    // Utterances fetched into the audio cache in the background
+
+    // Time to first audio in milliseconds, measured from the moment the
+    // speaker picks an utterance from the queue until the pipeline reaches PLAYING
+    uint32_t lastTimeToFirstAudio;
+    uint32_t minTimeToFirstAudio;
+    uint32_t maxTimeToFirstAudio;
+    uint64_t totalTimeToFirstAudio;
+    uint64_t totalCachedTimeToFirstAudio;
+
+    size_t cacheEntries;
+    size_t cacheBytes;
+    size_t cacheCapacity;
 };
 
 class TTSSpeaker {
@@ -140,6 +169,8 @@ public:
     bool pause(uint32_t id = 0);
     bool resume(uint32_t id = 0);
 
+    void getMetrics(SpeechMetrics &metrics);
+
 private:
 
     // Private Data
@@ -161,9 +192,40 @@ private:
     // Private functions
     inline void setSpeakingState(bool state, TTSSpeakerClient *client=NULL);
 
+    // Audio cache & prefetching of queued utterances
+    TTSAudioCache *m_audioCache;
+    std::list<std::string> m_prefetchList;
+    std::mutex m_prefetchMutex;
+    std::condition_variable m_prefetchCondition;
+    std::thread *m_prefetchThread;
+    const size_t m_cacheableTextLength;
+    void prefetchNext();
+    void schedulePrefetch(const std::string &url);
+    void flushPrefetch();
+    bool fetchAudio(void *curl, const std::string &url, std::vector<char> &audio);
+    static void PrefetchThreadFunc(void *ctx);
+
+    // Audio of the utterance being fetched over http, cached once it played to the end
+    std::shared_ptr<std::vector<char>> m_captured;
+    std::mutex m_captureMutex;
+    void startCapture();
+    std::shared_ptr<std::vector<char>> stopCapture();
+    static GstPadProbeReturn captureProbe(GstPad *pad, GstPadProbeInfo *info, gpointer data);
+
+    // Time to first audio metrics
+    SpeechMetrics m_metrics;
+    std::mutex m_metricsMutex;
+    std::chrono::steady_clock::time_point m_speechStartTime;
+    bool m_firstAudioPending;
+    bool m_playingFromCache;
+    void recordFirstAudio();
+
     // GStreamer Releated members
     GstElement  *m_pipeline;
     GstElement  *m_source;
+    GstElement  *m_cacheSource;
+    GstElement  *m_sourcePeer;
+    bool        m_cacheSourceActive;
     GstElement  *m_audioSink;
     GstElement  *m_audioVolume;
     GMainLoop   *m_main_loop;
@@ -199,6 +261,8 @@ private:
     void createPipeline();
     void resetPipeline();
     void destroyPipeline();
+    bool selectSource(bool cached);
+    void pushCachedAudio(TTSAudioCache::AudioData &audio);
 
     // GStreamer Helper functions
     bool needsPipelineUpdate();
@@ -210,7 +274,7 @@ private:
     void sanitizeString(std::string &input, std::string &sanitizedString);
     void speakText(TTSConfiguration config, SpeechData &data);
     bool waitForStatus(GstState expected_state, uint32_t timeout_ms);
-    void waitForAudioToFinishTimeout(float timeout_s);
+    bool waitForAudioToFinishTimeout(float timeout_s);
     bool handleMessage(GstMessage*);
     static int GstBusCallback(GstBus *bus, GstMessage *message, gpointer data);
     static void event_loop(void *data);
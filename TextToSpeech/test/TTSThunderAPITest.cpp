@@ -65,6 +65,7 @@ static int currentSpeechId = 0;
 #define OPT_EXIT                  12
 #define OPT_BLOCK_TILL_INPUT      13
 #define OPT_SLEEP                 14
+#define OPT_METRICS               15
 
 /* Declare module name */
 MODULE_NAME_DECLARATION(BUILD_REFERENCE)
@@ -87,6 +88,7 @@ void showMenu()
     cout << OPT_EXIT                 << ".exit" << endl;
     cout << OPT_BLOCK_TILL_INPUT     << ".dummyInput" << endl;
     cout << OPT_SLEEP                << ".sleep" << endl;
+    cout << OPT_METRICS              << ".getttsmetrics" << endl;
     cout << "------------------------" << endl;
 }
 
@@ -461,6 +463,26 @@ int main(int argc, char *argv[]) {
                     }
                     break;
 
+                    case OPT_METRICS:
+                    {
+                        JsonObject params;
+                        ret = remoteObject->Invoke<JsonObject, JsonObject>(1000,
+                                _T("getttsmetrics"), params, result);
+                        if (result["success"].Boolean()) {
+                            string timings, cache;
+                            result["timetofirstaudio"].Object().ToString(timings);
+                            result["cache"].Object().ToString(cache);
+                            cout << "spoken : " << result["spoken"].Number() << endl;
+                            cout << "cachehits : " << result["cachehits"].Number() << endl;
+                            cout << "prefetched : " << result["prefetched"].Number() << endl;
+                            cout << "timetofirstaudio : " << timings << endl;
+                            cout << "cache : " << cache << endl;
+                        } else {
+                            cout << "getttsmetrics call failed. TTS_Status: " << result["TTS_Status"].String() << endl;
+                        }
+                    }
+                    break;
+
                     case OPT_EXIT: {
                         cout << "Test app is exiting" <<endl;
                         exit(0);
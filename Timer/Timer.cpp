@@ -89,89 +89,93 @@ namespace WPEFramework
             Timer::_instance = nullptr;
         }
 
-        void Timer::checkTimers()
+        int Timer::allocateTimer(const TimerItem& item)
         {
-            double minTimeout = 100000;
-            for (auto it = m_runningItems.cbegin(); it != m_runningItems.cend(); ++it)
-            {
-                unsigned int timerId = *it;
-                if (timerId < 0 || timerId >= m_timerItems.size())
-                {
-                    LOGERR("Internal error: wrong timerId");
-                    continue;
-                }
-                if (m_timerItems[timerId].state != RUNNING)
-                {
-                    LOGERR("Internal error: timer %d has wrong state", timerId);
-                    continue;
-                }
+            int timerId = m_heap.allocate();
+            if ((size_t)timerId < m_timerItems.size())
+                m_timerItems[timerId] = item;
+            else
+                m_timerItems.push_back(item);
+            return timerId;
+        }
 
-                std::chrono::duration<double> elapsed = std::chrono::system_clock::now() - m_timerItems[timerId].lastExpired;
-                double timeout =  m_timerItems[timerId].interval - elapsed.count();
+        bool Timer::isValidTimer(unsigned int timerId) const
+        {
+            return m_heap.isValid(timerId);
+        }
 
-                if (!m_timerItems[timerId].reminderSent && m_timerItems[timerId].remindBefore > TIMER_ACCURACY)
-                {
-                    if (timeout > m_timerItems[timerId].remindBefore)
-                    {
-                        timeout -= m_timerItems[timerId].remindBefore;
-                    }
-                    else
-                    {
-                        sendTimerExpiryReminder(timerId);
-                        m_timerItems[timerId].reminderSent = true;
-                    }
-                }
+        std::chrono::system_clock::time_point Timer::nextEvent(int timerId) const
+        {
+            const TimerItem& item = m_timerItems[timerId];
+            std::chrono::duration<double> offset(item.interval);
+
+            if (!item.reminderSent && item.remindBefore > TIMER_ACCURACY)
+                offset -= std::chrono::duration<double>(std::min(item.remindBefore, item.interval));
 
-                if (timeout < minTimeout)
-                    minTimeout = timeout;
+            return item.lastExpired + std::chrono::duration_cast<std::chrono::system_clock::duration>(offset);
+        }
+
+        void Timer::checkTimers()
+        {
+            if (m_heap.empty())
+            {
+                m_timer.stop();
+                return;
             }
 
+            std::chrono::duration<double> timeout = m_heap.topEvent() - std::chrono::system_clock::now();
+            double minTimeout = timeout.count();
+
             if (minTimeout < TIMER_ACCURACY)
                 minTimeout = TIMER_ACCURACY;
 
             if (minTimeout < 100000)
                 m_timer.start(int(minTimeout * 1000));
             else
-                m_timer.stop();
+                m_timer.start(100000 * 1000); // re-evaluated then, keeps the delay within int range
         }
 
         void Timer::startTimer(int timerId)
         {
-            m_runningItems.push_back(timerId);
             m_timerItems[timerId].state = RUNNING;
 
             m_timerItems[timerId].lastExpired = std::chrono::system_clock::now();
             m_timerItems[timerId].lastExpiryReminder = std::chrono::system_clock::now();
             m_timerItems[timerId].reminderSent = false;
 
+            if (m_timerItems[timerId].remindBefore > TIMER_ACCURACY && m_timerItems[timerId].interval <= m_timerItems[timerId].remindBefore)
+            {
+                sendTimerExpiryReminder(timerId);
+                m_timerItems[timerId].reminderSent = true;
+            }
+
+            m_heap.push(timerId, nextEvent(timerId));
+
             checkTimers();
         }
 
         bool Timer::cancelTimer(int timerId)
         {
+            bool wasRunning = (RUNNING == m_timerItems[timerId].state || SUSPENDED == m_timerItems[timerId].state);
+            bool removed = m_heap.remove(timerId);
+
             m_timerItems[timerId].state = CANCELED;
 
-            auto it = std::find(m_runningItems.begin(), m_runningItems.end(), timerId);
-            if (m_runningItems.end() != it)
-            {
-                m_runningItems.erase(it);
-                m_timer.stop();
+            if (wasRunning)
+                m_heap.retire(timerId);
+
+            if (removed)
                 checkTimers();
-                return true;
-            }
 
-            return false;
+            return removed;
         }
 
         bool Timer::suspendTimer(int timerId)
         {
             m_timerItems[timerId].state = SUSPENDED;
 
-            auto it = std::find(m_runningItems.begin(), m_runningItems.end(), timerId);
-            if (m_runningItems.end() != it)
+            if (m_heap.remove(timerId))
             {
-                m_runningItems.erase(it);
-                m_timer.stop();
                 checkTimers();
                 return true;
             }
@@ -183,23 +187,17 @@ namespace WPEFramework
         {
             std::lock_guard<std::mutex> guard(m_callMutex);
 
-            std::list <int> itemsToDelete;
+            std::vector <int> itemsToRequeue;
+            auto now = std::chrono::system_clock::now();
+            auto due = now + std::chrono::duration_cast<std::chrono::system_clock::duration>(std::chrono::duration<double>(TIMER_ACCURACY));
 
-            for (auto it = m_runningItems.cbegin(); it != m_runningItems.cend(); ++it)
+            // Only the heap top can be due, each due timer is handled once per callback
+            while (!m_heap.empty() && m_heap.topEvent() <= due)
             {
-                unsigned int timerId = *it;
-                if (timerId < 0 || timerId >= m_timerItems.size())
-                {
-                    LOGERR("Internal error: wrong timerId");
-                    continue;
-                }
-                if (m_timerItems[timerId].state != RUNNING)
-                {
-                    LOGERR("Internal error: timer %d has wrong state", timerId);
-                    continue;
-                }
+                int timerId = m_heap.top();
+                m_heap.remove(timerId);
 
-                std::chrono::duration<double> elapsed = std::chrono::system_clock::now() - m_timerItems[timerId].lastExpired;
+                std::chrono::duration<double> elapsed = now - m_timerItems[timerId].lastExpired;
                 double timeout =  m_timerItems[timerId].interval - elapsed.count();
 
                 if (!m_timerItems[timerId].reminderSent && m_timerItems[timerId].remindBefore > TIMER_ACCURACY)
@@ -224,19 +222,19 @@ namespace WPEFramework
                     else
                     {
                         m_timerItems[timerId].state = EXPIRED;
-                        itemsToDelete.push_back(timerId);
+                        m_heap.retire(timerId);
+                        continue;
                     }
 
                     m_timerItems[timerId].reminderSent = false;
                 }
+
+                itemsToRequeue.push_back(timerId);
             }
 
-            for (auto delIt = itemsToDelete.cbegin(); delIt != itemsToDelete.cend(); ++delIt)
+            for (int timerId : itemsToRequeue)
             {
-                auto it = std::find(m_runningItems.begin(), m_runningItems.end(), *delIt);
-                if (m_runningItems.end() != it)
-                    m_runningItems.erase(it);
-
+                m_heap.push(timerId, nextEvent(timerId));
             }
 
             checkTimers();
@@ -294,10 +292,10 @@ namespace WPEFramework
             item.repeatInterval = parameters.HasLabel("repeatInterval") ? std::stod(parameters["repeatInterval"].String()) : 0.0;
             item.remindBefore = parameters.HasLabel("remindBefore") ? std::stod(parameters["remindBefore"].String()) : 0.0;
 
-            m_timerItems.push_back(item);
+            int timerId = allocateTimer(item);
 
-            startTimer(m_timerItems.size() - 1);
-            response["timerId"] = m_timerItems.size() - 1;
+            startTimer(timerId);
+            response["timerId"] = timerId;
 
             returnResponse(true);
         }
@@ -317,7 +315,7 @@ namespace WPEFramework
             unsigned int timerId;
             getNumberParameter("timerId", timerId);
 
-            if (timerId >=0 && timerId < m_timerItems.size())
+            if (isValidTimer(timerId))
             {
                 if (CANCELED != m_timerItems[timerId].state)
                 {
@@ -347,7 +345,7 @@ namespace WPEFramework
             unsigned int timerId;
             getNumberParameter("timerId", timerId);
 
-            if (timerId >=0 && timerId < m_timerItems.size())
+            if (isValidTimer(timerId))
             {
                 if (RUNNING == m_timerItems[timerId].state)
                 {
@@ -377,7 +375,7 @@ namespace WPEFramework
             unsigned int timerId;
             getNumberParameter("timerId", timerId);
 
-            if (timerId >=0 && timerId < m_timerItems.size())
+            if (isValidTimer(timerId))
             {
                 if (SUSPENDED == m_timerItems[timerId].state)
                 {
@@ -408,7 +406,7 @@ namespace WPEFramework
             unsigned int timerId;
             getNumberParameter("timerId", timerId);
 
-            if (timerId >= 0 && timerId < m_timerItems.size())
+            if (isValidTimer(timerId))
             {
                 getTimerStatus(timerId, response);
             }
@@ -430,6 +428,9 @@ namespace WPEFramework
             JsonArray timers;
             for (unsigned int n = 0; n < m_timerItems.size(); n++)
             {
+                if (!m_heap.isValid(n))
+                    continue;
+
                 JsonObject timer;
                 getTimerStatus(n, timer, true);
                 timers.Add(timer);
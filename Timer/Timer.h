@@ -27,6 +27,7 @@
 
 
 #include "tptimer.h"
+#include "TimerHeap.h"
 
 namespace WPEFramework {
 
@@ -92,6 +93,11 @@ namespace WPEFramework {
 
             void checkTimers();
 
+            int allocateTimer(const TimerItem& item);
+            bool isValidTimer(unsigned int timerId) const;
+            // The reminder or the expiry, whichever comes first
+            std::chrono::system_clock::time_point nextEvent(int timerId) const;
+
             void startTimer(int timerId);
             bool cancelTimer(int timerId);
             bool suspendTimer(int timerId);
@@ -108,8 +114,9 @@ namespace WPEFramework {
             static Timer* _instance;
         private:
             TpTimer m_timer;
+            // Indexed by timer ID, the IDs and the running timers are kept by m_heap
             std::vector <TimerItem> m_timerItems;
-            std::list <int> m_runningItems;
+            TimerHeap m_heap;
             std::mutex m_callMutex;
         };
 	} // namespace Plugin
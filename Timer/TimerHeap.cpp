@@ -0,0 +1,173 @@
+/**
+* If not stated otherwise in this file or this component's LICENSE
+* file the following copyright and licenses apply:
+*
+* Copyright 2020 RDK Management
+*
+* Licensed under the Apache License, Version 2.0 (the "License");
+* you may not use this file except in compliance with the License.
+* You may obtain a copy of the License at
+*
+* http://www.apache.org/licenses/LICENSE-2.0
+*
+* Unless required by applicable law or agreed to in writing, software
+* distributed under the License is distributed on an "AS IS" BASIS,
+* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+* See the License for the specific language governing permissions and
+* limitations under the License.
+**/
+
+
+#include "TimerHeap.h"
+
+#include <algorithm>
+
+#define TIMER_HEAP_NOT_QUEUED ((size_t)-1)
+
+namespace WPEFramework {
+
+    namespace Plugin {
+
+        TimerHeap::TimerHeap()
+        {
+        }
+
+        int TimerHeap::allocate()
+        {
+            int id;
+            if (!m_freeIds.empty())
+            {
+                id = m_freeIds.back();
+                m_freeIds.pop_back();
+            }
+            else
+            {
+                id = m_entries.size();
+                m_entries.push_back(Entry());
+            }
+
+            m_entries[id].heapIndex = TIMER_HEAP_NOT_QUEUED;
+            m_entries[id].inUse = true;
+            return id;
+        }
+
+        void TimerHeap::retire(int id)
+        {
+            m_retiredIds.push_back(id);
+
+            if (m_retiredIds.size() > TIMER_HEAP_RETIRED_MAX)
+            {
+                int oldest = m_retiredIds.front();
+                m_retiredIds.pop_front();
+                m_entries[oldest].inUse = false;
+                m_freeIds.push_back(oldest);
+            }
+        }
+
+        bool TimerHeap::isValid(unsigned int id) const
+        {
+            return id < m_entries.size() && m_entries[id].inUse;
+        }
+
+        size_t TimerHeap::ids() const
+        {
+            return m_entries.size();
+        }
+
+        bool TimerHeap::earlier(size_t a, size_t b) const
+        {
+            return m_entries[m_heap[a]].nextEvent < m_entries[m_heap[b]].nextEvent;
+        }
+
+        void TimerHeap::swap(size_t a, size_t b)
+        {
+            std::swap(m_heap[a], m_heap[b]);
+            m_entries[m_heap[a]].heapIndex = a;
+            m_entries[m_heap[b]].heapIndex = b;
+        }
+
+        void TimerHeap::siftUp(size_t index)
+        {
+            while (index > 0 && earlier(index, (index - 1) / 2))
+            {
+                swap(index, (index - 1) / 2);
+                index = (index - 1) / 2;
+            }
+        }
+
+        void TimerHeap::siftDown(size_t index)
+        {
+            while (true)
+            {
+                size_t smallest = index;
+                size_t left = 2 * index + 1;
+                size_t right = left + 1;
+
+                if (left < m_heap.size() && earlier(left, smallest))
+                    smallest = left;
+                if (right < m_heap.size() && earlier(right, smallest))
+                    smallest = right;
+                if (smallest == index)
+                    break;
+
+                swap(index, smallest);
+                index = smallest;
+            }
+        }
+
+        void TimerHeap::push(int id, const TimePoint& nextEvent)
+        {
+            remove(id);
+
+            m_entries[id].nextEvent = nextEvent;
+            m_heap.push_back(id);
+            m_entries[id].heapIndex = m_heap.size() - 1;
+            siftUp(m_heap.size() - 1);
+        }
+
+        bool TimerHeap::remove(int id)
+        {
+            size_t index = m_entries[id].heapIndex;
+            if (index == TIMER_HEAP_NOT_QUEUED)
+                return false;
+
+            swap(index, m_heap.size() - 1);
+            m_heap.pop_back();
+            m_entries[id].heapIndex = TIMER_HEAP_NOT_QUEUED;
+
+            if (index < m_heap.size())
+            {
+                siftUp(index);
+                siftDown(index);
+            }
+            return true;
+        }
+
+        bool TimerHeap::isQueued(int id) const
+        {
+            return m_entries[id].heapIndex != TIMER_HEAP_NOT_QUEUED;
+        }
+
+        bool TimerHeap::empty() const
+        {
+            return m_heap.empty();
+        }
+
+        size_t TimerHeap::size() const
+        {
+            return m_heap.size();
+        }
+
+        int TimerHeap::top() const
+        {
+            return m_heap.front();
+        }
+
+        const TimerHeap::TimePoint& TimerHeap::topEvent() const
+        {
+            return m_entries[m_heap.front()].nextEvent;
+        }
+
+    } // namespace Plugin
+
+} // namespace WPEFramework
@@ -0,0 +1,90 @@
+/**
+* If not stated otherwise in this file or this component's LICENSE
+* file the following copyright and licenses apply:
+*
+* Copyright 2020 RDK Management
+*
+* Licensed under the Apache License, Version 2.0 (the "License");
+* you may not use this file except in compliance with the License.
+* You may obtain a copy of the License at
+*
+* http://www.apache.org/licenses/LICENSE-2.0
+*
+* Unless required by applicable law or agreed to in writing, software
+* distributed under the License is distributed on an "AS IS" BASIS,
+* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+* See the License for the specific language governing permissions and
+* limitations under the License.
+**/
+
+
+#pragma once
+
+#include <stddef.h>
+#include <chrono>
+#include <deque>
+#include <vector>
+
+// Finished timers stay queryable until this many newer ones finished
+#define TIMER_HEAP_RETIRED_MAX 256
+
+namespace WPEFramework {
+
+    namespace Plugin {
+
+        /**
+        * @brief The running timers of the Timer plugin in a binary min-heap ordered on their
+        * next event, and the IDs they are known by. Every ID records its heap index, so
+        * that push and remove are O(log n) and the next due timer is the top. Finished IDs
+        * are reused once TIMER_HEAP_RETIRED_MAX newer ones finished. Not thread safe.
+        */
+        class TimerHeap
+        {
+        public:
+            typedef std::chrono::system_clock::time_point TimePoint;
+
+            TimerHeap();
+
+            TimerHeap(const TimerHeap&) = delete;
+            TimerHeap& operator=(const TimerHeap&) = delete;
+
+            // A recycled ID if there is one, else the next one
+            int allocate();
+            // The timer finished, its ID stays valid until it is recycled
+            void retire(int id);
+            bool isValid(unsigned int id) const;
+            // IDs handed out so far, valid or not
+            size_t ids() const;
+
+            void push(int id, const TimePoint& nextEvent);
+            // False if the timer was not queued
+            bool remove(int id);
+            bool isQueued(int id) const;
+
+            bool empty() const;
+            size_t size() const;
+            int top() const;
+            const TimePoint& topEvent() const;
+
+        private:
+            struct Entry
+            {
+                TimePoint nextEvent;
+                size_t heapIndex;
+                bool inUse;
+            };
+
+            bool earlier(size_t a, size_t b) const;
+            void swap(size_t a, size_t b);
+            void siftUp(size_t index);
+            void siftDown(size_t index);
+
+            std::vector<Entry> m_entries;
+            std::vector<int> m_heap;
+            std::vector<int> m_freeIds;
+            std::deque<int> m_retiredIds;
+        };
+
+    } // namespace Plugin
+
+} // namespace WPEFramework
@@ -102,6 +102,11 @@ namespace Plugin {
             return result;
         }
 
+        const std::regex& deviceSpecificPatternBin() {
+            static const std::regex pattern(deviceSpecificRegexBin(), std::regex_constants::icase | std::regex_constants::optimize);
+            return pattern;
+        }
+
         time_t fileModTime(const char* filename) {
             struct stat st;
             time_t mod_time;
@@ -117,6 +122,8 @@ namespace Plugin {
 
     UsbAccess::UsbAccess()
     : AbstractPlugin(UsbAccess::API_VERSION_NUMBER_MAJOR)
+    , fileIndex(REGEX_FILE, true)
+    , indexerEnabled(false)
     {
         UsbAccess::_instance = this;
 
@@ -137,9 +144,17 @@ namespace Plugin {
             archiveLogsThread.join();
     }
 
-    const string UsbAccess::Initialize(PluginHost::IShell * /* service */)
+    const string UsbAccess::Initialize(PluginHost::IShell* service)
     {
+        Config config;
+        config.FromString(service->ConfigLine());
+        indexerEnabled = config.Indexer.Value();
+
         InitializeIARM();
+
+        if (indexerEnabled)
+            indexMounted();
+
         return "";
     }
 
@@ -164,25 +179,50 @@ namespace Plugin {
         if (parameters.HasLabel("path"))
             pathParam = parameters["path"].String();
 
-        FileList files;
-        std::list<string> paths;
-        getMounted(paths);
-        if (!paths.empty())
-            result = getFileList(joinPaths(*paths.begin(), pathParam), files, REGEX_FILE, true);
+        uint32_t offset = 0;
+        uint32_t limit = 0;
+        if (parameters.HasLabel("offset"))
+            offset = parameters["offset"].Number();
+        if (parameters.HasLabel("limit"))
+            limit = parameters["limit"].Number();
 
-        if (!result)
-            response["error"] = "not found";
+        UsbFileIndex::SnapshotPtr snapshot;
+        if (parameters.HasLabel("cursor"))
+        {
+            // Further pages come from the listing the first page was taken from
+            result = fileIndex.find(parameters["cursor"].Number(), snapshot);
+            if (!result)
+                response["error"] = "cursor expired";
+        }
         else
         {
+            std::list<string> paths;
+            getMounted(paths);
+            if (!paths.empty())
+                result = fileIndex.list(joinPaths(*paths.begin(), pathParam), snapshot);
+
+            if (!result)
+                response["error"] = "not found";
+        }
+
+        if (result)
+        {
+            const UsbFileIndex::FileList& files = snapshot->files;
+            size_t end = files.size();
+            if (limit > 0 && static_cast<size_t>(offset) + limit < end)
+                end = offset + limit;
+
             JsonArray arr;
-            for_each(files.begin(), files.end(), [&arr](const FileEnt& it)
+            for (size_t i = offset; i < end; i++)
             {
                 JsonObject ent;
-                ent["name"] = it.filename;
-                ent["t"] = string(1, it.fileType);
+                ent["name"] = files[i].filename;
+                ent["t"] = string(1, files[i].fileType);
                 arr.Add(ent);
-            });
+            }
             response["contents"] = arr;
+            response["total"] = static_cast<uint32_t>(files.size());
+            response["cursor"] = snapshot->cursor;
         }
 
         returnResponse(result);
@@ -237,9 +277,9 @@ namespace Plugin {
         std::list<string> allFiles;
         for_each(paths.begin(), paths.end(), [&allFiles](const string& it)
         {
-            FileList files;
-            getFileList(it, files, deviceSpecificRegexBin(), false);
-            for_each(files.begin(), files.end(), [&allFiles, &it](const FileEnt& jt) {
+            UsbFileIndex::FileList files;
+            UsbFileIndex::readDirectory(it, deviceSpecificPatternBin(), false, files);
+            for_each(files.begin(), files.end(), [&allFiles, &it](const UsbFileIndex::FileEnt& jt) {
                 allFiles.emplace_back(joinPaths(it, jt.filename));
             });
         });
@@ -270,7 +310,7 @@ namespace Plugin {
         string name = fileName.substr(fileName.find_last_of("/\\") + 1);
         string path = fileName.substr(0, fileName.find_last_of("/\\"));
         if (!name.empty() && !path.empty() &&
-            std::regex_match(name, std::regex(deviceSpecificRegexBin(), std::regex_constants::icase)) == true)
+            std::regex_match(name, deviceSpecificPatternBin()) == true)
         {
             char buff[1000];
             size_t n = sizeof(buff);
@@ -411,6 +451,10 @@ namespace Plugin {
 
     void UsbAccess::onUSBMountChanged(bool mounted, const string& device)
     {
+        fileIndex.invalidate();
+        if (indexerEnabled && mounted)
+            indexMounted();
+
         JsonObject params;
         params["mounted"] = mounted;
         params["device"] = device;
@@ -418,42 +462,21 @@ namespace Plugin {
     }
 
     // internal methods
-    bool UsbAccess::getFileList(const string& path, FileList& files, const string& fileRegex, bool includeFolders)
+    void UsbAccess::indexMounted()
     {
-        bool result = false;
-
-        if (!path.empty())
+        std::list<string> paths;
+        if (getMounted(paths) && !paths.empty())
         {
-            DIR *dirp = opendir(path.c_str());
-            if (dirp != nullptr)
-            {
-                files.clear();
-
-                struct dirent *dp;
-                while ((dp = readdir(dirp)) != nullptr)
-                {
-                    if (((dp->d_type == DT_DIR) && includeFolders) ||
-                        ((dp->d_type != DT_DIR) && (fileRegex.empty() ||
-                            std::regex_match(dp->d_name, std::regex(fileRegex, std::regex_constants::icase)) == true)))
-                        files.push_back(
-                                {
-                                    dp->d_type == DT_DIR ? 'd' : 'f',
-                                    dp->d_name
-                                });
-                }
-                closedir(dirp);
-
-                result = true;
-            }
+            LOGINFO("indexing %d mounted drive(s)", (int)paths.size());
+            fileIndex.index(paths);
         }
-
-        return result;
     }
 
     bool UsbAccess::getMounted(std::list <std::string>& paths)
     {
         bool result = false;
 
+        static const std::regex devtypePattern("(partition|disk)");
         std::list<std::string> devnodes;
 
         struct udev *udev = udev_new();
@@ -473,7 +496,7 @@ namespace Plugin {
                 const char *path = udev_list_entry_get_name(entry);
                 struct udev_device *dev = udev_device_new_from_syspath(udev, path);
                 struct udev_device *usb = udev_device_get_parent_with_subsystem_devtype(dev, "usb", "usb_device");
-                if (usb != nullptr && std::regex_match(udev_device_get_devtype(dev), std::regex("(partition|disk)")))
+                if (usb != nullptr && std::regex_match(udev_device_get_devtype(dev), devtypePattern))
                     devnodes.emplace_back(udev_device_get_devnode(dev));
 
                 udev_device_unref(dev);
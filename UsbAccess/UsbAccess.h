@@ -3,6 +3,7 @@
 #include "Module.h"
 #include "utils.h"
 #include "AbstractPlugin.h"
+#include "UsbFileIndex.h"
 
 #include <thread>
 
@@ -72,23 +73,36 @@ namespace Plugin {
         void iarmEventHandler(const char *owner, IARM_EventId_t eventId, void *data, size_t len);
         void onUSBMountChanged(bool mounted, const string& device);
 
+    private/*config*/:
+        class Config : public Core::JSON::Container {
+        private:
+            Config(const Config&) = delete;
+            Config& operator=(const Config&) = delete;
+
+        public:
+            Config()
+                : Indexer(false)
+            {
+                Add(_T("indexer"), &Indexer);
+            }
+
+        public:
+            Core::JSON::Boolean Indexer;
+        };
+
     private/*internal methods*/:
         UsbAccess(const UsbAccess&) = delete;
         UsbAccess& operator=(const UsbAccess&) = delete;
 
-        struct FileEnt
-        {
-            char fileType; // 'f' or 'd'
-            string filename;
-        };
-        typedef std::list<FileEnt> FileList;
-
-        static bool getFileList(const string& path, FileList& files, const string& fileRegex, bool includeFolders);
         static bool getMounted(std::list<string>& paths);
+        void indexMounted();
 
         void archiveLogsInternal();
         void onArchiveLogs(ArchiveLogsError error);
         std::thread archiveLogsThread;
+
+        UsbFileIndex fileIndex;
+        bool indexerEnabled;
     };
 
 } // namespace Plugin
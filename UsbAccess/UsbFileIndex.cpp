@@ -0,0 +1,228 @@
+#include "UsbFileIndex.h"
+
+#include <sys/stat.h>
+#include <dirent.h>
+#include <pthread.h>
+
+namespace WPEFramework {
+namespace Plugin {
+
+    UsbFileIndex::UsbFileIndex(const std::string& pattern, bool includeFolders)
+    : m_pattern(pattern, std::regex_constants::icase | std::regex_constants::optimize)
+    , m_includeFolders(includeFolders)
+    , m_nextCursor(1)
+    , m_generation(0)
+    , m_useCount(0)
+    , m_stopIndexer(false)
+    {
+    }
+
+    UsbFileIndex::~UsbFileIndex()
+    {
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_stopIndexer = true;
+        }
+        m_indexerCond.notify_all();
+
+        if (m_indexerThread.joinable())
+            m_indexerThread.join();
+    }
+
+    bool UsbFileIndex::readDirectory(const std::string& path, const std::regex& pattern, bool includeFolders, FileList& files)
+    {
+        if (path.empty())
+            return false;
+
+        DIR *dirp = opendir(path.c_str());
+        if (dirp == nullptr)
+            return false;
+
+        files.clear();
+
+        struct dirent *dp;
+        while ((dp = readdir(dirp)) != nullptr)
+        {
+            if (((dp->d_type == DT_DIR) && includeFolders) ||
+                ((dp->d_type != DT_DIR) && std::regex_match(dp->d_name, pattern)))
+                files.push_back(
+                        {
+                            dp->d_type == DT_DIR ? 'd' : 'f',
+                            dp->d_name
+                        });
+        }
+        closedir(dirp);
+
+        return true;
+    }
+
+    bool UsbFileIndex::list(const std::string& path, SnapshotPtr& snapshot)
+    {
+        struct stat st;
+        if (path.empty() || stat(path.c_str(), &st) != 0 || !S_ISDIR(st.st_mode))
+            return false;
+
+        uint64_t generation;
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+
+            auto it = m_cache.find(path);
+            if (it != m_cache.end() &&
+                it->second.snapshot->mtime.tv_sec == st.st_mtim.tv_sec &&
+                it->second.snapshot->mtime.tv_nsec == st.st_mtim.tv_nsec)
+            {
+                it->second.lastUsed = ++m_useCount;
+                snapshot = it->second.snapshot;
+                return true;
+            }
+            generation = m_generation;
+        }
+
+        // Read unlocked; the mtime is taken before, so a change during the read is picked up next time
+        std::shared_ptr<Snapshot> fresh = std::make_shared<Snapshot>();
+        fresh->path = path;
+        fresh->mtime = st.st_mtim;
+        if (!readDirectory(path, m_pattern, m_includeFolders, fresh->files))
+            return false;
+
+        std::lock_guard<std::mutex> lock(m_mutex);
+
+        fresh->cursor = m_nextCursor++;
+        if (m_nextCursor == 0)
+            m_nextCursor = 1;
+
+        m_recent.push_back(fresh);
+        if (m_recent.size() > USB_INDEX_MAX_SNAPSHOTS)
+            m_recent.pop_front();
+
+        // Not cached if the mounts changed while reading
+        if (generation == m_generation)
+        {
+            Cached& cached = m_cache[path];
+            cached.snapshot = fresh;
+            cached.lastUsed = ++m_useCount;
+            evict();
+        }
+
+        snapshot = fresh;
+        return true;
+    }
+
+    bool UsbFileIndex::find(uint32_t cursor, SnapshotPtr& snapshot)
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+
+        for (auto& it : m_recent)
+        {
+            if (it->cursor == cursor)
+            {
+                snapshot = it;
+                return true;
+            }
+        }
+        // A listing served from the cache for long enough drops out of the recent ones
+        for (auto& it : m_cache)
+        {
+            if (it.second.snapshot->cursor == cursor)
+            {
+                snapshot = it.second.snapshot;
+                return true;
+            }
+        }
+        return false;
+    }
+
+    void UsbFileIndex::invalidate()
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+
+        m_cache.clear();
+        m_recent.clear();
+        m_indexQueue.clear();
+        m_generation++;
+    }
+
+    void UsbFileIndex::index(const std::list<std::string>& roots)
+    {
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+
+            if (m_stopIndexer)
+                return;
+
+            m_indexQueue.insert(m_indexQueue.end(), roots.begin(), roots.end());
+
+            if (!m_indexerThread.joinable())
+                m_indexerThread = std::thread(&UsbFileIndex::indexer, this);
+        }
+        m_indexerCond.notify_one();
+    }
+
+    size_t UsbFileIndex::cachedDirectories()
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        return m_cache.size();
+    }
+
+    // Called with m_mutex held
+    void UsbFileIndex::evict()
+    {
+        while (m_cache.size() > USB_INDEX_MAX_DIRECTORIES)
+        {
+            auto oldest = m_cache.begin();
+            for (auto it = m_cache.begin(); it != m_cache.end(); ++it)
+            {
+                if (it->second.lastUsed < oldest->second.lastUsed)
+                    oldest = it;
+            }
+            m_cache.erase(oldest);
+        }
+    }
+
+    void UsbFileIndex::indexer()
+    {
+        pthread_setname_np(pthread_self(), "UsbFileIndex");
+
+        std::unique_lock<std::mutex> lock(m_mutex);
+
+        while (!m_stopIndexer)
+        {
+            if (m_indexQueue.empty())
+            {
+                m_indexerCond.wait(lock);
+                continue;
+            }
+
+            std::list<std::string> directories;
+            directories.push_back(m_indexQueue.front());
+            m_indexQueue.pop_front();
+            uint64_t generation = m_generation;
+
+            // Breadth first, so the directories closest to the root are ready first
+            size_t count = 0;
+            while (!directories.empty() && count < USB_INDEX_MAX_DIRECTORIES &&
+                   !m_stopIndexer && generation == m_generation)
+            {
+                std::string path = directories.front();
+                directories.pop_front();
+                count++;
+
+                lock.unlock();
+
+                SnapshotPtr snapshot;
+                if (list(path, snapshot))
+                {
+                    for (auto& it : snapshot->files)
+                    {
+                        if (it.fileType == 'd' && it.filename != "." && it.filename != "..")
+                            directories.push_back(path + (path[path.size() - 1] == '/' ? "" : "/") + it.filename);
+                    }
+                }
+
+                lock.lock();
+            }
+        }
+    }
+
+} // namespace Plugin
+} // namespace WPEFramework
@@ -0,0 +1,109 @@
+#pragma once
+
+#include <sys/types.h>
+#include <time.h>
+
+#include <string>
+#include <vector>
+#include <list>
+#include <map>
+#include <deque>
+#include <memory>
+#include <regex>
+#include <mutex>
+#include <condition_variable>
+#include <thread>
+
+#define USB_INDEX_MAX_DIRECTORIES 64
+#define USB_INDEX_MAX_SNAPSHOTS 8
+
+namespace WPEFramework {
+namespace Plugin {
+
+    /***
+     * Directory listings of the USB drives, filtered with a pattern compiled once.
+     * A listing is read once and kept until the directory changes (its mtime) or
+     * the mounts change (invalidate). Every listing read is a snapshot with its own
+     * cursor, so a client paging through a large directory sees a stable list even
+     * if the directory is read again in between. The optional indexer reads the
+     * mount roots and their subdirectories in the background.
+     */
+    class UsbFileIndex
+    {
+    public:
+        struct FileEnt
+        {
+            char fileType; // 'f' or 'd'
+            std::string filename;
+        };
+        typedef std::vector<FileEnt> FileList;
+
+        struct Snapshot
+        {
+            uint32_t cursor;
+            std::string path;
+            struct timespec mtime;
+            FileList files;
+        };
+        typedef std::shared_ptr<const Snapshot> SnapshotPtr;
+
+        UsbFileIndex(const std::string& pattern, bool includeFolders);
+        ~UsbFileIndex();
+
+        UsbFileIndex(const UsbFileIndex&) = delete;
+        UsbFileIndex& operator=(const UsbFileIndex&) = delete;
+
+        /***
+         * @brief        : Get the listing of a directory, read again only if the directory changed.
+         * @return       : false if the directory cannot be opened
+         */
+        bool list(const std::string& path, SnapshotPtr& snapshot);
+
+        /***
+         * @brief        : Get a listing handed out earlier.
+         * @return       : false if the cursor is unknown, or too old
+         */
+        bool find(uint32_t cursor, SnapshotPtr& snapshot);
+
+        /***
+         * @brief        : Drop all listings and cursors, when a drive is mounted or unmounted.
+         */
+        void invalidate();
+
+        /***
+         * @brief        : Read the given mount roots and their subdirectories in the background.
+         */
+        void index(const std::list<std::string>& roots);
+
+        size_t cachedDirectories();
+
+        static bool readDirectory(const std::string& path, const std::regex& pattern, bool includeFolders, FileList& files);
+
+    private:
+        struct Cached
+        {
+            SnapshotPtr snapshot;
+            uint64_t lastUsed;
+        };
+
+        void indexer();
+        void evict();
+
+        const std::regex m_pattern;
+        const bool m_includeFolders;
+
+        std::mutex m_mutex;
+        std::map<std::string, Cached> m_cache;
+        std::deque<SnapshotPtr> m_recent;
+        uint32_t m_nextCursor;
+        uint64_t m_generation;
+        uint64_t m_useCount;
+
+        std::condition_variable m_indexerCond;
+        std::list<std::string> m_indexQueue;
+        std::thread m_indexerThread;
+        bool m_stopIndexer;
+    };
+
+} // namespace Plugin
+} // namespace WPEFramework
@@ -356,6 +356,11 @@ namespace WPEFramework
             sendNotify("onSSIDsChanged", JsonObject());
         }
 
+        void WifiManager::onPowerStateChanged(bool standby)
+        {
+            wifiSignalThreshold.setStandby(standby);
+        }
+
         void WifiManager::onWifiSignalThresholdChanged(float signalStrength, const std::string &strength)
         {
             JsonObject params;
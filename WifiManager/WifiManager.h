@@ -102,6 +102,7 @@ namespace WPEFramework {
 
             //Internal methods
             static WifiManager& getInstance();
+            void onPowerStateChanged(bool standby);
 
         private:
             uint32_t apiVersionNumber;
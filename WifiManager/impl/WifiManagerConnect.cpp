@@ -72,7 +72,7 @@ uint32_t WifiManagerConnect::disconnect(const JsonObject &parameters, JsonObject
     IARM_Bus_WiFiSrvMgr_Param_t param;
     memset(&param, 0, sizeof(param));
 
-    IARM_Result_t retVal = IARM_Bus_Call(IARM_BUS_NM_SRV_MGR_NAME, IARM_BUS_WIFI_MGR_API_disconnectSSID, (void *)&param, sizeof(param));
+    IARM_Result_t retVal = IARM_BUS_CALL(IARM_BUS_NM_SRV_MGR_NAME, IARM_BUS_WIFI_MGR_API_disconnectSSID, (void *)&param, sizeof(param));
     LOGINFO("[%s] : retVal:%d status:%d", IARM_BUS_WIFI_MGR_API_disconnectSSID, retVal, param.status);
 
     response["result"] = string();
@@ -93,7 +93,7 @@ bool WifiManagerConnect::connect(const std::string &ssid, const std::string &pas
         param.data.connect.security_mode = (SsidSecurity)securityMode;
     }
 
-    retVal = IARM_Bus_Call( IARM_BUS_NM_SRV_MGR_NAME, IARM_BUS_WIFI_MGR_API_connect, (void *)&param, sizeof(param));
+    retVal = IARM_BUS_CALL( IARM_BUS_NM_SRV_MGR_NAME, IARM_BUS_WIFI_MGR_API_connect, (void *)&param, sizeof(param));
 
     if(retVal == IARM_RESULT_SUCCESS && param.status)
     {
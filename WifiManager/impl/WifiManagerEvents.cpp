@@ -29,6 +29,7 @@
 // RDK
 #include "rdk/iarmbus/libIBus.h"
 #include "wifiSrvMgrIarmIf.h"
+#include "pwrMgr.h"
 
 using namespace WPEFramework;
 using namespace WPEFramework::Plugin;
@@ -46,6 +47,8 @@ std::string WifiManagerEvents::Initialize(PluginHost::IShell*)
     IARM_CHECK(IARM_Bus_RegisterEventHandler(IARM_BUS_NM_SRV_MGR_NAME, IARM_BUS_WIFI_MGR_EVENT_onWIFIStateChanged, WifiManagerEvents::iarmEventHandler));
     IARM_CHECK(IARM_Bus_RegisterEventHandler(IARM_BUS_NM_SRV_MGR_NAME, IARM_BUS_WIFI_MGR_EVENT_onError, WifiManagerEvents::iarmEventHandler));
     IARM_CHECK(IARM_Bus_RegisterEventHandler(IARM_BUS_NM_SRV_MGR_NAME, IARM_BUS_WIFI_MGR_EVENT_onSSIDsChanged, WifiManagerEvents::iarmEventHandler));
+    // The signal threshold monitor backs off in standby
+    IARM_CHECK(IARM_Bus_RegisterEventHandler(IARM_BUS_PWRMGR_NAME, IARM_BUS_PWRMGR_EVENT_MODECHANGED, WifiManagerEvents::iarmEventHandler));
 
     // Successful
     return string();
@@ -63,6 +66,7 @@ void WifiManagerEvents::Deinitialize(PluginHost::IShell*)
     IARM_CHECK(IARM_Bus_UnRegisterEventHandler(IARM_BUS_NM_SRV_MGR_NAME, IARM_BUS_WIFI_MGR_EVENT_onWIFIStateChanged));
     IARM_CHECK(IARM_Bus_UnRegisterEventHandler(IARM_BUS_NM_SRV_MGR_NAME, IARM_BUS_WIFI_MGR_EVENT_onError));
     IARM_CHECK(IARM_Bus_UnRegisterEventHandler(IARM_BUS_NM_SRV_MGR_NAME, IARM_BUS_WIFI_MGR_EVENT_onSSIDsChanged));
+    IARM_CHECK(IARM_Bus_UnRegisterEventHandler(IARM_BUS_PWRMGR_NAME, IARM_BUS_PWRMGR_EVENT_MODECHANGED));
 }
 
 /**
@@ -70,7 +74,7 @@ void WifiManagerEvents::Deinitialize(PluginHost::IShell*)
  *
  * Relevant events are converted into WifiManager notifications.
  *
- * \param owner   The issuer of the event, should be network server manager.
+ * \param owner   The issuer of the event, network server manager or power manager.
  * \param eventId The event id.
  * \param data    Data associated with the event.
  * \param len     Length of 'data'.
@@ -78,7 +82,17 @@ void WifiManagerEvents::Deinitialize(PluginHost::IShell*)
  */
 void WifiManagerEvents::iarmEventHandler(char const* owner, IARM_EventId_t eventId, void* data, size_t len)
 {
-    // Only care about events originating from the network server manager
+    if (strcmp(owner, IARM_BUS_PWRMGR_NAME) == 0) {
+        if (eventId == IARM_BUS_PWRMGR_EVENT_MODECHANGED) {
+            IARM_Bus_PWRMgr_EventData_t* eventData = reinterpret_cast<IARM_Bus_PWRMgr_EventData_t *>(data);
+            LOGINFO("Event IARM_BUS_PWRMGR_EVENT_MODECHANGED received; %d -> %d", eventData->data.state.curState, eventData->data.state.newState);
+
+            WifiManager::getInstance().onPowerStateChanged(eventData->data.state.newState != IARM_BUS_PWRMGR_POWERSTATE_ON);
+        }
+        return;
+    }
+
+    // Otherwise only care about events originating from the network server manager
     if (strcmp(owner, IARM_BUS_NM_SRV_MGR_NAME) != 0)
         return;
 
@@ -25,14 +25,15 @@
 #include "WifiManagerScan.h"
 #include "../WifiManager.h" // Need access to WifiManager::getInstance so can't use 'WifiManagerInterface.h'
 #include "utils.h"
+#include "iarmeventdispatcher.h"
 
 // RDK
 #include "rdk/iarmbus/libIBus.h"
 #include "wifiSrvMgrIarmIf.h"
 
 // std
+#include <memory>
 #include <sstream>
-#include <regex>
 
 using namespace WPEFramework;
 using namespace WPEFramework::Plugin;
@@ -43,19 +44,33 @@ namespace WPEJ = WPEFramework::Core::JSON;
 namespace
 {
     // Commonly used strings to avoid typos
+    char const* const g_bssid = "bssid";
+    char const* const g_delta = "delta";
     char const* const g_error = "error";
+    char const* const g_full = "full";
     char const* const g_ssid = "ssid";
     char const* const g_incremental = "incremental";
     char const* const g_frequency = "frequency";
     char const* const g_getAvailableSSIDs = "getAvailableSSIDs";
     char const* const g_getAvailableSSIDsWithName = "getAvailableSSIDsWithName";
     char const* const g_moreData = "moreData";
+    char const* const g_removed = "removed";
+    char const* const g_security = "security";
+    char const* const g_signalStrength = "signalStrength";
     char const* const g_ssids = "ssids";
     char const* const g_SSID_name = "SSID_name";
     char const* const g_timeout = "timeout";
 }
 
-WifiManagerScan::Filter WifiManagerScan::filter = {};
+std::mutex WifiManagerScan::storeMutex;
+WifiManagerScanStore WifiManagerScan::store;
+bool WifiManagerScan::deltaScan = false;
+bool WifiManagerScan::deltaFull = false;
+
+namespace {
+    // Between Initialize and Deinitialize
+    std::unique_ptr<IARMEventDispatcher> iarmEvents;
+}
 
 /**
  * \brief Register event handlers.
@@ -65,6 +80,10 @@ std::string WifiManagerScan::Initialize(PluginHost::IShell*)
 {
     LOGINFO("initializing");
 
+    iarmEvents.reset(new IARMEventDispatcher("WifiManagerScan", [](char const* owner, IARM_EventId_t eventId, void* data, size_t len) {
+        handleEvent(owner, eventId, data, len);
+    }));
+
     // Register event handlers for wireless scan related events
     IARM_Result_t res;
     IARM_CHECK(IARM_Bus_RegisterEventHandler(IARM_BUS_NM_SRV_MGR_NAME, IARM_BUS_WIFI_MGR_EVENT_onAvailableSSIDs, WifiManagerScan::iarmEventHandler));
@@ -85,6 +104,8 @@ void WifiManagerScan::Deinitialize(PluginHost::IShell* service)
     IARM_Result_t res;
     IARM_CHECK(IARM_Bus_UnRegisterEventHandler(IARM_BUS_NM_SRV_MGR_NAME, IARM_BUS_WIFI_MGR_EVENT_onAvailableSSIDs));
     IARM_CHECK(IARM_Bus_UnRegisterEventHandler(IARM_BUS_NM_SRV_MGR_NAME, IARM_BUS_WIFI_MGR_EVENT_onAvailableSSIDsIncr));
+
+    iarmEvents.reset();
 }
 
 /**
@@ -92,7 +113,7 @@ void WifiManagerScan::Deinitialize(PluginHost::IShell* service)
  *
  * The results are published on via the "onAvailableSSIDs" event.
  *
- * \param parameters        Must include 'incremental'. Optionally includes 'ssid' and/or 'frequency'.
+ * \param parameters        Must include 'incremental'. Optionally includes 'ssid' and/or 'frequency', and 'delta'.
  * \param[out] response     Always includes 'success' if successful.
  * \return                  A code indicating success.
  *
@@ -104,23 +125,32 @@ uint32_t WifiManagerScan::startScan(const JsonObject &parameters, JsonObject &re
     returnIfBooleanParamNotFound(parameters, g_incremental);
     const bool incremental = parameters[g_incremental].Boolean();
 
-    filter = {};
-
+    std::string ssid;
+    std::string frequency;
+    bool delta = false;
     if (parameters.HasLabel(g_ssid)) {
-        std::string ssid;
         getStringParameter(g_ssid, ssid);
-        if (ssid.length()) {
-            filter.onSsid = true;
-            filter.ssid = ssid;
-        }
     }
     if (parameters.HasLabel(g_frequency)) {
-        std::string frequency;
         getStringParameter(g_frequency, frequency);
-        if (frequency.length()) {
-            filter.onFrequency = true;
-            filter.frequency = frequency;
+    }
+    if (parameters.HasLabel(g_delta)) {
+        getBoolParameter(g_delta, delta);
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(storeMutex);
+        bool filterChanged = store.setFilter(ssid, frequency);
+        if (filterChanged && !ssid.empty() && !store.filter().isRegex()) {
+            LOGWARN("Incorrect regex: %s, matching the SSID literally", ssid.c_str());
         }
+
+        // A delta scan carries on from the networks the previous one reported, unless the filter changed
+        if (!delta || !deltaScan || filterChanged) {
+            store.resetReported();
+            deltaFull = true;
+        }
+        deltaScan = delta;
     }
 
     if (incremental)
@@ -153,7 +183,7 @@ uint32_t WifiManagerScan::getAvailableSSIDsAsync(const JsonObject& parameters, J
 
     // Issue the query via IARM bus, the response will be sent as an event
     IARM_Result_t res;
-    IARM_CHECK( IARM_Bus_Call(
+    IARM_CHECK( IARM_BUS_CALL(
                     IARM_BUS_NM_SRV_MGR_NAME,
                     IARM_BUS_WIFI_MGR_API_getAvailableSSIDsAsync,
                     reinterpret_cast<void *>(&param),
@@ -190,7 +220,7 @@ uint32_t WifiManagerScan::getAvailableSSIDsAsyncIncr(const JsonObject &parameter
 
     // Issue the query via IARM bus, the response will be sent as an event
     IARM_Result_t res;
-    IARM_CHECK( IARM_Bus_Call(
+    IARM_CHECK( IARM_BUS_CALL(
                     IARM_BUS_NM_SRV_MGR_NAME,
                     IARM_BUS_WIFI_MGR_API_getAvailableSSIDsAsyncIncr,
                     reinterpret_cast<void *>(&param),
@@ -223,7 +253,7 @@ uint32_t WifiManagerScan::stopScan(const JsonObject& parameters, JsonObject& res
     memset(&param, 0, sizeof(param));
 
     IARM_Result_t res;
-    IARM_CHECK( IARM_Bus_Call(
+    IARM_CHECK( IARM_BUS_CALL(
                     IARM_BUS_NM_SRV_MGR_NAME,
                     IARM_BUS_WIFI_MGR_API_stopProgressiveWifiScanning,
                     reinterpret_cast<void*>(&param),
@@ -232,6 +262,16 @@ uint32_t WifiManagerScan::stopScan(const JsonObject& parameters, JsonObject& res
     returnResponse(res == IARM_RESULT_SUCCESS);
 }
 
+/**
+ * \brief Queue events from the IARM bus relating to wireless scanning, for 'handleEvent'.
+ *
+ */
+void WifiManagerScan::iarmEventHandler(char const* owner, IARM_EventId_t eventId, void* data, size_t len)
+{
+    if (iarmEvents)
+        iarmEvents->post(owner, eventId, data, len);
+}
+
 /**
  * \brief Handle events from the IARM bus relating to wireless scanning.
  *
@@ -241,7 +281,7 @@ uint32_t WifiManagerScan::stopScan(const JsonObject& parameters, JsonObject& res
  * \param len     Length of 'data' in bytes.
  *
  */
-void WifiManagerScan::iarmEventHandler(char const* owner, IARM_EventId_t eventId, void* data, size_t len)
+void WifiManagerScan::handleEvent(char const* owner, IARM_EventId_t eventId, void* data, size_t len)
 {
     // Only care about events originating from the network server manager
     if (strcmp(owner, IARM_BUS_NM_SRV_MGR_NAME) != 0)
@@ -250,7 +290,7 @@ void WifiManagerScan::iarmEventHandler(char const* owner, IARM_EventId_t eventId
     if ((eventId == IARM_BUS_WIFI_MGR_EVENT_onAvailableSSIDs) || (eventId == IARM_BUS_WIFI_MGR_EVENT_onAvailableSSIDsIncr)) {
         IARM_BUS_WiFiSrvMgr_EventData_t const* eventData = reinterpret_cast<IARM_BUS_WiFiSrvMgr_EventData_t*>(data);
 
-        LOGINFO("Event IARM_BUS_WIFI_MGR_EVENT_onAvailableSSIDs[Incr] received. '%s'", eventData->data.wifiSSIDList.ssid_list);
+        LOGINFO("Event IARM_BUS_WIFI_MGR_EVENT_onAvailableSSIDs[Incr] received. %zu bytes", strlen(eventData->data.wifiSSIDList.ssid_list));
 
         // The returned SSIDs are in a JSON document
         std::string const serialized(eventData->data.wifiSSIDList.ssid_list);
@@ -265,48 +305,65 @@ void WifiManagerScan::iarmEventHandler(char const* owner, IARM_EventId_t eventId
             return;
         }
 
-        JsonArray ssids = eventDocument[g_getAvailableSSIDs].Array();
-        applyFilter(ssids, filter);
+        std::vector<WifiNetwork> networks;
+        toNetworks(eventDocument[g_getAvailableSSIDs].Array(), networks);
 
+        const bool moreData = eventData->data.wifiSSIDList.more_data;
         JsonObject params;
+        JsonArray ssids;
+        {
+            std::lock_guard<std::mutex> lock(storeMutex);
+            WifiManagerScanStore::Delta delta;
+            store.merge(networks, moreData, WifiManagerScanStore::nowMs(), delta);
+            LOGINFO("%zu networks known, %zu in the event, %zu added, %zu changed, %zu removed",
+                store.size(), networks.size(), delta.added.size(), delta.changed.size(), delta.removed.size());
+
+            if (deltaScan) {
+                // Only what was added, changed or removed since the networks were last reported
+                delta.added.insert(delta.added.end(), delta.changed.begin(), delta.changed.end());
+                toJson(delta.added, ssids);
+                JsonArray removed;
+                toJson(delta.removed, removed);
+                params[g_removed] = removed;
+                params[g_full] = deltaFull;
+                deltaFull = false;
+            } else {
+                toJson(delta.matched, ssids);
+            }
+        }
+
         params[g_ssids] = ssids;
-        params[g_moreData] = eventData->data.wifiSSIDList.more_data;
+        params[g_moreData] = moreData;
         WifiManager::getInstance().onAvailableSSIDs(params);
     }
 }
 
-void WifiManagerScan::applyFilter(JsonArray &ssids, const WifiManagerScan::Filter &filter) {
-    JsonArray result;
-    std::regex re;
-    std::smatch m;
-    if(filter.onSsid)
-    {
-        try
-        {
-            re = std::regex(filter.ssid);
-        }
-        catch(const std::regex_error &e)
-        {
-           LOGERR("Incorrect regex: %s", e.what());
-        }
+void WifiManagerScan::toNetworks(const JsonArray& ssids, std::vector<WifiNetwork>& networks)
+{
+    networks.reserve(ssids.Length());
+    for (int i = 0; i < ssids.Length(); i++) {
+        const JsonObject object = ssids[i].Object();
+        WifiNetwork network;
+        if (object.HasLabel(g_bssid))
+            network.bssid = object[g_bssid].String();
+        network.ssid = object[g_ssid].String();
+        network.security = object[g_security].Number();
+        network.signalStrength = object[g_signalStrength].String();
+        network.frequency = object[g_frequency].String();
+        networks.push_back(std::move(network));
     }
+}
 
-    for(int i=0; i<ssids.Length(); i++) {
-        JsonObject object = ssids[i].Object();
-        if(filter.onSsid) {
-            std::string str = object[g_ssid].String();
-
-            if(!std::regex_match(str, m, re)){
-                LOGINFO("SSID filter out %s ~= %s", str.c_str(), filter.ssid.c_str());
-                continue;
-            }
-        }
-        if(filter.onFrequency && object[g_frequency].String() != filter.frequency) {
-            LOGINFO("Frequency filter out %s != %s", object[g_frequency].String().c_str(), filter.frequency.c_str());
-            continue;
-        }
-
-        result.Add(object);
+void WifiManagerScan::toJson(const std::vector<WifiNetwork>& networks, JsonArray& ssids)
+{
+    for (const auto& network : networks) {
+        JsonObject object;
+        object[g_ssid] = network.ssid;
+        if (!network.bssid.empty())
+            object[g_bssid] = network.bssid;
+        object[g_security] = network.security;
+        object[g_signalStrength] = network.signalStrength;
+        object[g_frequency] = network.frequency;
+        ssids.Add(object);
     }
-    ssids = result;
 }
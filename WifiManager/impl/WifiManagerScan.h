@@ -20,7 +20,9 @@
 #pragma once
 
 #include "../Module.h"
+#include "WifiManagerScanStore.h"
 
+#include <mutex>
 #include <string>
 
 // Forward declaration
@@ -50,16 +52,17 @@ namespace WPEFramework {
             uint32_t getAvailableSSIDsAsyncIncr(const JsonObject& parameters, JsonObject& response) const;
 
             static void iarmEventHandler(char const* owner, IARM_EventId_t eventId, void* data, size_t len);
+            // The events, off the IARM thread
+            static void handleEvent(char const* owner, IARM_EventId_t eventId, void* data, size_t len);
 
-            struct Filter {
-                bool onSsid = false;
-                std::string ssid;
-                bool onFrequency = false;
-                std::string frequency;
-            };
+            static void toNetworks(const JsonArray& ssids, std::vector<WifiNetwork>& networks);
+            static void toJson(const std::vector<WifiNetwork>& networks, JsonArray& ssids);
 
-            static void applyFilter(JsonArray &object, const WifiManagerScan::Filter &filter);
-            static Filter filter;
+            // The event handler is static, so is what it shares with 'startScan'
+            static std::mutex storeMutex;
+            static WifiManagerScanStore store;
+            static bool deltaScan;
+            static bool deltaFull;
         };
     } // namespace Plugin
 } // namespace WPEFramework
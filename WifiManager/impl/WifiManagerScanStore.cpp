@@ -0,0 +1,188 @@
+/**
+* If not stated otherwise in this file or this component's LICENSE
+* file the following copyright and licenses apply:
+*
+* Copyright 2020 RDK Management
+*
+* Licensed under the Apache License, Version 2.0 (the "License");
+* you may not use this file except in compliance with the License.
+* You may obtain a copy of the License at
+*
+* http://www.apache.org/licenses/LICENSE-2.0
+*
+* Unless required by applicable law or agreed to in writing, software
+* distributed under the License is distributed on an "AS IS" BASIS,
+* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+* See the License for the specific language governing permissions and
+* limitations under the License.
+**/
+
+/**
+ * Merges the results of wireless network scans.
+ *
+ */
+
+#include "WifiManagerScanStore.h"
+
+// std
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+
+using namespace WPEFramework::Plugin;
+
+namespace
+{
+    double signalOf(const WifiNetwork& network)
+    {
+        return std::strtod(network.signalStrength.c_str(), nullptr);
+    }
+}
+
+void WifiScanFilter::set(const std::string& ssid, const std::string& frequency)
+{
+    _ssid = ssid;
+    _frequency = frequency;
+    _isRegex = false;
+
+    if (!_ssid.empty()) {
+        try {
+            _regex = std::regex(_ssid);
+            _isRegex = true;
+        } catch (const std::regex_error&) {
+            // Matched literally
+        }
+    }
+}
+
+bool WifiScanFilter::matches(const WifiNetwork& network) const
+{
+    if (!_ssid.empty()) {
+        if (_isRegex ? !std::regex_match(network.ssid, _regex) : (network.ssid != _ssid))
+            return false;
+    }
+    if (!_frequency.empty() && network.frequency != _frequency)
+        return false;
+    return true;
+}
+
+void WifiManagerScanStore::Delta::clear()
+{
+    matched.clear();
+    added.clear();
+    changed.clear();
+    removed.clear();
+}
+
+uint64_t WifiManagerScanStore::nowMs()
+{
+    return std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+/**
+ * \brief Set the filter of the scan that is starting.
+ *
+ * The SSID regular expression is compiled here, once, rather than for each event.
+ *
+ * \return Whether the filter changed.
+ *
+ */
+bool WifiManagerScanStore::setFilter(const std::string& ssid, const std::string& frequency)
+{
+    if (ssid == _filter.ssid() && frequency == _filter.frequency())
+        return false;
+
+    _filter.set(ssid, frequency);
+    _filterGeneration++;
+    return true;
+}
+
+/**
+ * \brief Merge the networks of one scan event.
+ *
+ * \param networks      The networks in the event.
+ * \param moreData      Whether more events of this scan follow.
+ * \param nowMs         The current time.
+ * \param[out] delta    The networks of the event that pass the filter, and those added, changed and removed since they were last reported.
+ *
+ */
+void WifiManagerScanStore::merge(const std::vector<WifiNetwork>& networks, bool moreData, uint64_t nowMs, Delta& delta)
+{
+    delta.clear();
+
+    for (const auto& network : networks) {
+        Entry& entry = _entries[keyOf(network)];
+        bool isNew = !entry.seen;
+        bool isDifferent = !isNew && (entry.network.ssid != network.ssid
+            || entry.network.frequency != network.frequency || entry.network.security != network.security);
+        if (isNew || isDifferent)
+            entry.filterGeneration = 0;
+
+        entry.network = network;
+        entry.seen = true;
+        entry.lastScan = _scan;
+        entry.lastSeenMs = nowMs;
+
+        if (!matches(entry)) {
+            if (entry.reported) {
+                delta.removed.push_back(entry.network);
+                entry.reported = false;
+            }
+            continue;
+        }
+
+        delta.matched.push_back(network);
+
+        double signal = signalOf(network);
+        if (!entry.reported) {
+            delta.added.push_back(network);
+            entry.reported = true;
+            entry.reportedSignal = signal;
+        } else if (isDifferent || std::fabs(signal - entry.reportedSignal) >= WIFI_SCAN_SIGNAL_HYSTERESIS_DBM) {
+            delta.changed.push_back(network);
+            entry.reportedSignal = signal;
+        }
+    }
+
+    if (moreData)
+        return;
+
+    // The scan is complete
+    _scan++;
+    for (auto it = _entries.begin(); it != _entries.end(); ) {
+        const Entry& entry = it->second;
+        uint32_t missed = _scan - 1 - entry.lastScan;
+        bool gone = (missed >= WIFI_SCAN_MAX_MISSED_SCANS)
+            || (missed > 0 && nowMs - entry.lastSeenMs >= WIFI_SCAN_MAX_AGE_MS);
+        if (gone) {
+            if (entry.reported)
+                delta.removed.push_back(entry.network);
+            it = _entries.erase(it);
+        } else {
+            ++it;
+        }
+    }
+}
+
+void WifiManagerScanStore::resetReported()
+{
+    for (auto& it : _entries)
+        it.second.reported = false;
+}
+
+std::string WifiManagerScanStore::keyOf(const WifiNetwork& network)
+{
+    if (!network.bssid.empty())
+        return network.bssid;
+    return network.ssid + '\n' + network.frequency;
+}
+
+bool WifiManagerScanStore::matches(Entry& entry)
+{
+    if (entry.filterGeneration != _filterGeneration) {
+        entry.matches = _filter.matches(entry.network);
+        entry.filterGeneration = _filterGeneration;
+        _filterRuns++;
+    }
+    return entry.matches;
+}
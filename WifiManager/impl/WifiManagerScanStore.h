@@ -0,0 +1,130 @@
+/**
+* If not stated otherwise in this file or this component's LICENSE
+* file the following copyright and licenses apply:
+*
+* Copyright 2020 RDK Management
+*
+* Licensed under the Apache License, Version 2.0 (the "License");
+* you may not use this file except in compliance with the License.
+* You may obtain a copy of the License at
+*
+* http://www.apache.org/licenses/LICENSE-2.0
+*
+* Unless required by applicable law or agreed to in writing, software
+* distributed under the License is distributed on an "AS IS" BASIS,
+* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+* See the License for the specific language governing permissions and
+* limitations under the License.
+**/
+
+#pragma once
+
+#include <stdint.h>
+#include <regex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+// A network that was not in this many complete scans in a row is gone
+#define WIFI_SCAN_MAX_MISSED_SCANS 2
+// ...as is one not in the latest complete scan and not seen for this long
+#define WIFI_SCAN_MAX_AGE_MS 120000
+// Smaller signal strength changes are not reported as a change
+#define WIFI_SCAN_SIGNAL_HYSTERESIS_DBM 5.0
+
+namespace WPEFramework {
+    namespace Plugin {
+        /**
+         * An access point as wifimgr reports it in 'getAvailableSSIDs'.
+         *
+         */
+        struct WifiNetwork {
+            std::string bssid;              // Not in every wifimgr version
+            std::string ssid;
+            int security = 0;
+            std::string signalStrength;     // dBm, as text
+            std::string frequency;          // GHz, as text
+        };
+
+        /**
+         * The 'ssid' and 'frequency' filter of 'startScan', with the SSID regular expression compiled once.
+         *
+         */
+        class WifiScanFilter {
+        public:
+            WifiScanFilter() = default;
+
+            // An SSID that is not a valid regular expression is matched literally
+            void set(const std::string& ssid, const std::string& frequency);
+            bool matches(const WifiNetwork& network) const;
+
+            const std::string& ssid() const { return _ssid; }
+            const std::string& frequency() const { return _frequency; }
+            bool isRegex() const { return _isRegex; }
+
+        private:
+            std::string _ssid;
+            std::string _frequency;
+            bool _isRegex = false;
+            std::regex _regex;
+        };
+
+        /**
+         * The networks found by the scans, keyed by BSSID (or SSID and frequency when there is none).
+         * Merges the incremental scan events and works out what changed. Not thread safe.
+         *
+         */
+        class WifiManagerScanStore {
+        public:
+            struct Delta {
+                std::vector<WifiNetwork> matched;    // The networks of the event that pass the filter
+                std::vector<WifiNetwork> added;
+                std::vector<WifiNetwork> changed;
+                std::vector<WifiNetwork> removed;
+
+                void clear();
+            };
+
+            WifiManagerScanStore() = default;
+            WifiManagerScanStore(WifiManagerScanStore const&) = delete;
+            WifiManagerScanStore& operator=(WifiManagerScanStore const&) = delete;
+
+            static uint64_t nowMs();
+
+            // False if it is the filter already set
+            bool setFilter(const std::string& ssid, const std::string& frequency);
+            const WifiScanFilter& filter() const { return _filter; }
+
+            // One scan event; a scan is complete when there is no more data, then the networks that are gone age out
+            void merge(const std::vector<WifiNetwork>& networks, bool moreData, uint64_t nowMs, Delta& delta);
+            // Forgets what was reported, the next delta adds every network again
+            void resetReported();
+
+            size_t size() const { return _entries.size(); }
+            uint32_t completeScans() const { return _scan; }
+            // Regular expression matches run, for the benchmark
+            uint32_t filterRuns() const { return _filterRuns; }
+
+        private:
+            struct Entry {
+                WifiNetwork network;
+                double reportedSignal = 0;  // Signal strength last reported as added or changed
+                uint32_t lastScan = 0;
+                uint64_t lastSeenMs = 0;
+                uint32_t filterGeneration = 0;
+                bool matches = false;
+                bool seen = false;
+                bool reported = false;
+            };
+
+            static std::string keyOf(const WifiNetwork& network);
+            bool matches(Entry& entry);
+
+            WifiScanFilter _filter;
+            uint32_t _filterGeneration = 1;
+            std::unordered_map<std::string, Entry> _entries;
+            uint32_t _scan = 0;
+            uint32_t _filterRuns = 0;
+        };
+    } // namespace Plugin
+} // namespace WPEFramework
@@ -0,0 +1,153 @@
+/**
+* If not stated otherwise in this file or this component's LICENSE
+* file the following copyright and licenses apply:
+*
+* Copyright 2020 RDK Management
+*
+* Licensed under the Apache License, Version 2.0 (the "License");
+* you may not use this file except in compliance with the License.
+* You may obtain a copy of the License at
+*
+* http://www.apache.org/licenses/LICENSE-2.0
+*
+* Unless required by applicable law or agreed to in writing, software
+* distributed under the License is distributed on an "AS IS" BASIS,
+* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+* See the License for the specific language governing permissions and
+* limitations under the License.
+**/
+
+/**
+ * Signal strength sampling policy.
+ *
+ */
+
+#include "WifiManagerSignalMonitor.h"
+
+// std
+#include <algorithm>
+#include <cmath>
+
+using namespace WPEFramework::Plugin;
+
+namespace
+{
+    // The lowest signal strength of 'Fair', 'Good' and 'Excellent'
+    const float signalStrengthThresholds[] = { -67.0f, -60.0f, -50.0f };
+    const char* const strengthNames[] = { "Weak", "Fair", "Good", "Excellent" };
+
+    int levelOf(float signalStrength)
+    {
+        // No signal strength reported
+        if (signalStrength >= 0)
+            return 0;
+
+        int level = 0;
+        for (float threshold : signalStrengthThresholds) {
+            if (signalStrength >= threshold)
+                level++;
+        }
+        return level;
+    }
+
+    bool isNearThreshold(float signalStrength)
+    {
+        for (float threshold : signalStrengthThresholds) {
+            if (std::fabs(signalStrength - threshold) < WIFI_SIGNAL_HYSTERESIS_DBM)
+                return true;
+        }
+        return false;
+    }
+}
+
+WifiManagerSignalMonitor::WifiManagerSignalMonitor()
+    : _intervalMs(0)
+    , _adaptive(false)
+    , _level(-1)
+    , _stableSamples(0)
+    , _samples(0)
+    , _nearThreshold(false)
+    , _standby(false)
+{
+}
+
+const char* WifiManagerSignalMonitor::strengthOf(float signalStrength)
+{
+    return strengthNames[levelOf(signalStrength)];
+}
+
+void WifiManagerSignalMonitor::reset(int intervalMs, bool adaptive)
+{
+    _intervalMs = intervalMs;
+    _adaptive = adaptive;
+    _level = -1;
+    _stableSamples = 0;
+    _nearThreshold = false;
+    _strength.clear();
+}
+
+/**
+ * \brief Take a signal strength sample.
+ *
+ * The strength only moves to another band once the signal is WIFI_SIGNAL_HYSTERESIS_DBM into it,
+ * so a signal wobbling around a threshold is not reported over and over.
+ *
+ * \param signalStrength    The signal strength in dBm.
+ *
+ * \return Whether the strength changed.
+ *
+ */
+bool WifiManagerSignalMonitor::sample(float signalStrength)
+{
+    _samples++;
+
+    int level = levelOf(signalStrength);
+    if (_adaptive && _level >= 0 && signalStrength < 0) {
+        if (level > _level)
+            level = std::max(_level, levelOf(signalStrength - WIFI_SIGNAL_HYSTERESIS_DBM));
+        else if (level < _level)
+            level = std::min(_level, levelOf(signalStrength + WIFI_SIGNAL_HYSTERESIS_DBM));
+    }
+    _nearThreshold = (signalStrength < 0) && isNearThreshold(signalStrength);
+
+    if (level == _level) {
+        _stableSamples++;
+        return false;
+    }
+
+    _level = level;
+    _strength = strengthNames[level];
+    _stableSamples = 0;
+    return true;
+}
+
+void WifiManagerSignalMonitor::setStandby(bool standby)
+{
+    if (_standby && !standby)
+        _stableSamples = 0;
+    _standby = standby;
+}
+
+/**
+ * \brief The time until the next sample.
+ *
+ * The requested interval while the strength changes or the signal is close to a threshold, backing off
+ * while it is stable, and WIFI_SIGNAL_STANDBY_INTERVAL_MS in standby.
+ *
+ */
+int WifiManagerSignalMonitor::nextIntervalMs() const
+{
+    if (!_adaptive)
+        return _intervalMs;
+    if (_standby)
+        return std::max(_intervalMs, WIFI_SIGNAL_STANDBY_INTERVAL_MS);
+    if (_nearThreshold)
+        return _intervalMs;
+
+    int64_t backoff = 1;
+    for (uint32_t stable = _stableSamples; stable >= WIFI_SIGNAL_STABLE_SAMPLES && backoff < WIFI_SIGNAL_MAX_BACKOFF; stable -= WIFI_SIGNAL_STABLE_SAMPLES)
+        backoff *= 2;
+
+    int64_t interval = std::min<int64_t>(_intervalMs * backoff, WIFI_SIGNAL_MAX_INTERVAL_MS);
+    return static_cast<int>(std::max<int64_t>(interval, _intervalMs));
+}
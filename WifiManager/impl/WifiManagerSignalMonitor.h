@@ -0,0 +1,74 @@
+/**
+* If not stated otherwise in this file or this component's LICENSE
+* file the following copyright and licenses apply:
+*
+* Copyright 2020 RDK Management
+*
+* Licensed under the Apache License, Version 2.0 (the "License");
+* you may not use this file except in compliance with the License.
+* You may obtain a copy of the License at
+*
+* http://www.apache.org/licenses/LICENSE-2.0
+*
+* Unless required by applicable law or agreed to in writing, software
+* distributed under the License is distributed on an "AS IS" BASIS,
+* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+* See the License for the specific language governing permissions and
+* limitations under the License.
+**/
+
+#pragma once
+
+#include <stdint.h>
+#include <string>
+
+// The signal has to be this far into another strength band before it is reported as changed
+#define WIFI_SIGNAL_HYSTERESIS_DBM 2.0f
+// The polling interval doubles after this many samples in a row that did not change the strength...
+#define WIFI_SIGNAL_STABLE_SAMPLES 3
+// ...up to this many times the requested interval, and no more than WIFI_SIGNAL_MAX_INTERVAL_MS
+#define WIFI_SIGNAL_MAX_BACKOFF 8
+#define WIFI_SIGNAL_MAX_INTERVAL_MS 60000
+// The polling interval while the device is in standby
+#define WIFI_SIGNAL_STANDBY_INTERVAL_MS 300000
+
+namespace WPEFramework {
+    namespace Plugin {
+        /**
+         * Decides when the signal strength of the connected access point is sampled, and when a sample
+         * is a change of strength ('Excellent', 'Good', 'Fair' or 'Weak') worth reporting.
+         * Not thread safe.
+         *
+         */
+        class WifiManagerSignalMonitor {
+        public:
+            WifiManagerSignalMonitor();
+            WifiManagerSignalMonitor(WifiManagerSignalMonitor const&) = delete;
+            WifiManagerSignalMonitor& operator=(WifiManagerSignalMonitor const&) = delete;
+
+            // The strength band of a signal, without hysteresis
+            static const char* strengthOf(float signalStrength);
+
+            // A new connection or a new interval: forgets the strength, the next sample is reported.
+            // Not adaptive, every interval is the requested one and there is no hysteresis.
+            void reset(int intervalMs, bool adaptive);
+            // Returns true if the strength changed and is to be reported
+            bool sample(float signalStrength);
+            void setStandby(bool standby);
+
+            const std::string& strength() const { return _strength; }
+            int nextIntervalMs() const;
+            uint32_t samples() const { return _samples; }
+
+        private:
+            int _intervalMs;
+            bool _adaptive;
+            int _level;             // Index of the strength band, -1 before the first sample
+            uint32_t _stableSamples;
+            uint32_t _samples;
+            bool _nearThreshold;
+            bool _standby;
+            std::string _strength;
+        };
+    } // namespace Plugin
+} // namespace WPEFramework
@@ -18,6 +18,7 @@
 **/
 
 #include "WifiManagerSignalThreshold.h"
+#include "WifiManagerSignalMonitor.h"
 
 #include "utils.h"
 
@@ -26,42 +27,24 @@
 using namespace WPEFramework::Plugin;
 
 namespace {
-    const float signalStrengthThresholdExcellent = -50.0f;
-    const float signalStrengthThresholdGood = -60.0f;
-    const float signalStrengthThresholdFair = -67.0f;
-
-    void getSignalData(WifiManagerInterface &wifiManager, float &signalStrengthOut, std::string &strengthOut) {
+    float getSignalStrength(WifiManagerInterface &wifiManager) {
         JsonObject response;
         wifiManager.getConnectedSSID(JsonObject(), response);
 
-        signalStrengthOut = 0.0f;
+        float signalStrength = 0.0f;
         if (response.HasLabel("signalStrength")) {
-            signalStrengthOut = std::stof(response["signalStrength"].String());
-        }
-
-        if (signalStrengthOut >= signalStrengthThresholdExcellent && signalStrengthOut < 0)
-        {
-            strengthOut = "Excellent";
-        }
-        else if (signalStrengthOut >= signalStrengthThresholdGood && signalStrengthOut < signalStrengthThresholdExcellent)
-        {
-            strengthOut = "Good";
-        }
-        else if (signalStrengthOut >= signalStrengthThresholdFair && signalStrengthOut < signalStrengthThresholdGood)
-        {
-            strengthOut = "Fair";
+            signalStrength = std::stof(response["signalStrength"].String());
         }
-        else
-        {
-            strengthOut = "Weak";
-        };
+        return signalStrength;
     }
 }
 
 WifiManagerSignalThreshold::WifiManagerSignalThreshold(WifiManagerInterface &wifiManager):
     changeEnabled(false),
     wifiManager(wifiManager),
-    running(false)
+    running(false),
+    standby(false),
+    wakeup(false)
 {
 }
 
@@ -78,8 +61,10 @@ uint32_t WifiManagerSignalThreshold::setSignalThresholdChangeEnabled(const JsonO
 
     bool enabled = parameters["enabled"].Boolean();
     int interval = parameters["interval"].Number();
+    bool adaptive;
+    getDefaultBoolParameter("adaptive", adaptive, false);
 
-    setSignalThresholdChangeEnabled(enabled, interval);
+    setSignalThresholdChangeEnabled(enabled, interval, adaptive);
 
     returnResponse(true);
 }
@@ -100,9 +85,9 @@ uint32_t WifiManagerSignalThreshold::isSignalThresholdChangeEnabled(const JsonOb
     returnResponse(true);
 }
 
-void WifiManagerSignalThreshold::setSignalThresholdChangeEnabled(bool enabled, int interval)
+void WifiManagerSignalThreshold::setSignalThresholdChangeEnabled(bool enabled, int interval, bool adaptive)
 {
-    LOGINFO("setSignalThresholdChangeEnabled: enabled %s, interval %d", enabled ? "true":"false", interval);
+    LOGINFO("setSignalThresholdChangeEnabled: enabled %s, interval %d, adaptive %s", enabled ? "true":"false", interval, adaptive ? "true":"false");
 
     stopThread();
 
@@ -132,7 +117,7 @@ void WifiManagerSignalThreshold::setSignalThresholdChangeEnabled(bool enabled, i
     {
         if (state == WifiState::CONNECTED)
             running = true;
-        startThread(interval);
+        startThread(interval, adaptive);
     }
 }
 
@@ -141,34 +126,46 @@ bool WifiManagerSignalThreshold::isSignalThresholdChangeEnabled() const
     return changeEnabled;
 }
 
-void WifiManagerSignalThreshold::loop(int interval)
+void WifiManagerSignalThreshold::loop(int interval, bool adaptive)
 {
-    std::unique_lock<std::mutex> lk(cv_mutex);
-    std::string lastStrength = "";
+    WifiManagerSignalMonitor monitor;
+    monitor.reset(interval, adaptive);
 
+    std::unique_lock<std::mutex> lk(cv_mutex);
     while(changeEnabled)
     {
-        float signalStrength;
-        std::string strength;
-        if (running)
+        monitor.setStandby(standby);
+        if (!running)
         {
-            getSignalData(wifiManager, signalStrength, strength);
-
+            // Nothing to sample until connected
+            cv.wait(lk, [this](){ return changeEnabled == false || wakeup; });
+            wakeup = false;
+            continue;
+        }
 
-            if (strength != lastStrength)
-            {
-                LOGINFO("Triggering onWifiSignalThresholdChanged notification");
-                wifiManager.onWifiSignalThresholdChanged(signalStrength, strength);
-                lastStrength = strength;
-            }
+        // getConnectedSSID is an IARM call, the event handlers should not wait for it
+        lk.unlock();
+        float signalStrength = getSignalStrength(wifiManager);
+        if (monitor.sample(signalStrength))
+        {
+            LOGINFO("Triggering onWifiSignalThresholdChanged notification");
+            wifiManager.onWifiSignalThresholdChanged(signalStrength, monitor.strength());
         }
-        cv.wait_for(lk, std::chrono::milliseconds(interval), [this](){ return changeEnabled == false; });
+        lk.lock();
+
+        cv.wait_for(lk, std::chrono::milliseconds(monitor.nextIntervalMs()), [this](){ return changeEnabled == false || wakeup; });
+        wakeup = false;
     }
+
+    LOGINFO("%u signal strength samples", monitor.samples());
 }
 
 void WifiManagerSignalThreshold::stopThread()
 {
-    changeEnabled = false;
+    {
+        std::lock_guard<std::mutex> lk(cv_mutex);
+        changeEnabled = false;
+    }
     cv.notify_one();
     if(thread.joinable()) {
         thread.join();
@@ -180,12 +177,36 @@ void WifiManagerSignalThreshold::stopThread()
 void WifiManagerSignalThreshold::setSignalThresholdChangeEnabled(bool enable)
 {
     LOGINFO("setSignalThresholdChangeEnabled: enable %s", enable ? "true":"false");
-    running = enable;
+    {
+        std::lock_guard<std::mutex> lk(cv_mutex);
+        running = enable;
+        wakeup = true;
+    }
+    cv.notify_one();
+}
+
+/**
+ * \brief Back off sampling the signal strength while the device is in standby.
+ *
+ * Only in the adaptive mode; on wake up the signal strength is sampled right away.
+ *
+ */
+void WifiManagerSignalThreshold::setStandby(bool standby)
+{
+    LOGINFO("setStandby: standby %s", standby ? "true":"false");
+    {
+        std::lock_guard<std::mutex> lk(cv_mutex);
+        this->standby = standby;
+        if (!standby)
+            wakeup = true;
+    }
+    cv.notify_one();
 }
 
-void WifiManagerSignalThreshold::startThread(int interval)
+void WifiManagerSignalThreshold::startThread(int interval, bool adaptive)
 {
-    thread = std::thread([interval, this](){
-        loop(interval);
+    wakeup = false;
+    thread = std::thread([interval, adaptive, this](){
+        loop(interval, adaptive);
     });
 }
@@ -39,7 +39,8 @@ namespace WPEFramework {
             // From WifiManager module.
             //
             // As the onWifiSignalTresholdChanged event is signalled periodically,
-            // it has to be handled with an additional thread.
+            // it has to be handled with an additional thread. In the adaptive mode
+            // WifiManagerSignalMonitor decides when it samples the signal strength.
         public:
             WifiManagerSignalThreshold(WifiManagerInterface &wifiManager);
             virtual ~WifiManagerSignalThreshold();
@@ -49,14 +50,15 @@ namespace WPEFramework {
             uint32_t setSignalThresholdChangeEnabled(const JsonObject& parameters, JsonObject& response);
             void setSignalThresholdChangeEnabled(bool enable);
             uint32_t isSignalThresholdChangeEnabled(const JsonObject& parameters, JsonObject& response) const;
+            void setStandby(bool standby);
 
         private:
-            void setSignalThresholdChangeEnabled(bool enabled, int interval);
+            void setSignalThresholdChangeEnabled(bool enabled, int interval, bool adaptive);
             bool isSignalThresholdChangeEnabled() const;
 
-            void loop(int interval);
+            void loop(int interval, bool adaptive);
             void stopThread();
-            void startThread(int interval);
+            void startThread(int interval, bool adaptive);
 
         private:
             std::thread thread;
@@ -64,7 +66,10 @@ namespace WPEFramework {
             std::mutex cv_mutex;
             std::condition_variable cv;
             WifiManagerInterface &wifiManager;
+            // Guarded by cv_mutex
             bool running;
+            bool standby;
+            bool wakeup;
         };
     }
 }
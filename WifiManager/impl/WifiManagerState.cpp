@@ -52,7 +52,7 @@ uint32_t WifiManagerState::getCurrentState(const JsonObject &parameters, JsonObj
 
     memset(&param, 0, sizeof(param));
 
-    retVal = IARM_Bus_Call(IARM_BUS_NM_SRV_MGR_NAME, IARM_BUS_WIFI_MGR_API_getCurrentState, (void *)&param, sizeof(param));
+    retVal = IARM_BUS_CALL(IARM_BUS_NM_SRV_MGR_NAME, IARM_BUS_WIFI_MGR_API_getCurrentState, (void *)&param, sizeof(param));
 
     if(retVal == IARM_RESULT_SUCCESS)
     {
@@ -71,7 +71,7 @@ uint32_t WifiManagerState::getConnectedSSID(const JsonObject &parameters, JsonOb
 
     memset(&param, 0, sizeof(param));
 
-    retVal = IARM_Bus_Call(IARM_BUS_NM_SRV_MGR_NAME, IARM_BUS_WIFI_MGR_API_getConnectedSSID, (void *)&param, sizeof(param));
+    retVal = IARM_BUS_CALL(IARM_BUS_NM_SRV_MGR_NAME, IARM_BUS_WIFI_MGR_API_getConnectedSSID, (void *)&param, sizeof(param));
 
     if(retVal == IARM_RESULT_SUCCESS)
     {
@@ -100,7 +100,7 @@ uint32_t WifiManagerState::setEnabled(const JsonObject &parameters, JsonObject &
     param.isInterfaceEnabled = parameters["enable"].Boolean();
 
     // disables wifi interface when ethernet interface is active
-    IARM_Result_t retVal = IARM_Bus_Call(IARM_BUS_NM_SRV_MGR_NAME, IARM_BUS_NETSRVMGR_API_setInterfaceEnabled, (void *)&param, sizeof(param));
+    IARM_Result_t retVal = IARM_BUS_CALL(IARM_BUS_NM_SRV_MGR_NAME, IARM_BUS_NETSRVMGR_API_setInterfaceEnabled, (void *)&param, sizeof(param));
 
     returnResponse(retVal == IARM_RESULT_SUCCESS);
 }
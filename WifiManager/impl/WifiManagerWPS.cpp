@@ -40,7 +40,7 @@ namespace WPEFramework
             IARM_Bus_WiFiSrvMgr_Param_t param;
             memset(&param, 0, sizeof(param));
 
-            IARM_Result_t retVal = IARM_Bus_Call(IARM_BUS_NM_SRV_MGR_NAME, IARM_BUS_WIFI_MGR_API_initiateWPSPairing, (void *)&param, sizeof(param));
+            IARM_Result_t retVal = IARM_BUS_CALL(IARM_BUS_NM_SRV_MGR_NAME, IARM_BUS_WIFI_MGR_API_initiateWPSPairing, (void *)&param, sizeof(param));
             LOGINFO("[%s] : retVal:%d status:%d", IARM_BUS_WIFI_MGR_API_initiateWPSPairing, retVal, param.status);
 
             response["result"] = string();
@@ -93,7 +93,7 @@ namespace WPEFramework
                 returnResponse(false);
             }
 
-            IARM_Result_t retVal = IARM_Bus_Call(IARM_BUS_NM_SRV_MGR_NAME,
+            IARM_Result_t retVal = IARM_BUS_CALL(IARM_BUS_NM_SRV_MGR_NAME,
                     IARM_BUS_WIFI_MGR_API_initiateWPSPairing2,
                     (void *)&wps_parameters, sizeof(wps_parameters));
             LOGINFO("[%s] : retVal:%d status:%d",
@@ -114,7 +114,7 @@ namespace WPEFramework
             IARM_Bus_WiFiSrvMgr_Param_t param;
             memset(&param, 0, sizeof(param));
 
-            IARM_Result_t retVal = IARM_Bus_Call(IARM_BUS_NM_SRV_MGR_NAME, IARM_BUS_WIFI_MGR_API_cancelWPSPairing, (void *)&param, sizeof(param));
+            IARM_Result_t retVal = IARM_BUS_CALL(IARM_BUS_NM_SRV_MGR_NAME, IARM_BUS_WIFI_MGR_API_cancelWPSPairing, (void *)&param, sizeof(param));
             LOGINFO("[%s] : retVal:%d status:%d", IARM_BUS_WIFI_MGR_API_cancelWPSPairing, retVal, param.status);
 
             response["result"] = string();
@@ -137,7 +137,7 @@ namespace WPEFramework
             strncpy(param.data.connect.passphrase, parameters["passphrase"].String().c_str(), PASSPHRASE_BUFF - 1);
             param.data.connect.security_mode = static_cast<SsidSecurity>(parameters["securityMode"].Number());
 
-            IARM_Result_t retVal = IARM_Bus_Call(IARM_BUS_NM_SRV_MGR_NAME, IARM_BUS_WIFI_MGR_API_saveSSID, (void *)&param, sizeof(param));
+            IARM_Result_t retVal = IARM_BUS_CALL(IARM_BUS_NM_SRV_MGR_NAME, IARM_BUS_WIFI_MGR_API_saveSSID, (void *)&param, sizeof(param));
             saved = (retVal == IARM_RESULT_SUCCESS) && param.status;
             LOGINFO("[%s] : retVal:%d status:%d", IARM_BUS_WIFI_MGR_API_saveSSID, retVal, param.status);
 
@@ -153,7 +153,7 @@ namespace WPEFramework
             IARM_Bus_WiFiSrvMgr_Param_t param;
             memset(&param, 0, sizeof(param));
 
-            IARM_Result_t retVal = IARM_Bus_Call(IARM_BUS_NM_SRV_MGR_NAME, IARM_BUS_WIFI_MGR_API_clearSSID, (void *)&param, sizeof(param));
+            IARM_Result_t retVal = IARM_BUS_CALL(IARM_BUS_NM_SRV_MGR_NAME, IARM_BUS_WIFI_MGR_API_clearSSID, (void *)&param, sizeof(param));
             cleared = (retVal == IARM_RESULT_SUCCESS) && param.status;
             LOGINFO("[%s] : retVal:%d status:%d", IARM_BUS_WIFI_MGR_API_clearSSID, retVal, param.status);
 
@@ -167,7 +167,7 @@ namespace WPEFramework
             IARM_Bus_WiFiSrvMgr_Param_t param;
             memset(&param, 0, sizeof(param));
 
-            IARM_Result_t retVal = IARM_Bus_Call(IARM_BUS_NM_SRV_MGR_NAME, IARM_BUS_WIFI_MGR_API_getPairedSSID, (void *)&param, sizeof(param));
+            IARM_Result_t retVal = IARM_BUS_CALL(IARM_BUS_NM_SRV_MGR_NAME, IARM_BUS_WIFI_MGR_API_getPairedSSID, (void *)&param, sizeof(param));
             if (retVal == IARM_RESULT_SUCCESS)
             {
                 response["ssid"] = string(param.data.getPairedSSID.ssid, SSID_SIZE);
@@ -183,7 +183,7 @@ namespace WPEFramework
             IARM_Bus_WiFiSrvMgr_Param_t param;
             memset(&param, 0, sizeof(param));
 
-            IARM_Result_t retVal = IARM_Bus_Call(IARM_BUS_NM_SRV_MGR_NAME, IARM_BUS_WIFI_MGR_API_getPairedSSIDInfo, (void *)&param, sizeof(param));
+            IARM_Result_t retVal = IARM_BUS_CALL(IARM_BUS_NM_SRV_MGR_NAME, IARM_BUS_WIFI_MGR_API_getPairedSSIDInfo, (void *)&param, sizeof(param));
             if (retVal == IARM_RESULT_SUCCESS)
             {
                 response["ssid"] = string(param.data.getPairedSSIDInfo.ssid, SSID_SIZE);
@@ -202,7 +202,7 @@ namespace WPEFramework
             IARM_Bus_WiFiSrvMgr_Param_t param;
             memset(&param, 0, sizeof(param));
 
-            IARM_Result_t retVal = IARM_Bus_Call(IARM_BUS_NM_SRV_MGR_NAME, IARM_BUS_WIFI_MGR_API_isPaired, (void *)&param, sizeof(param));
+            IARM_Result_t retVal = IARM_BUS_CALL(IARM_BUS_NM_SRV_MGR_NAME, IARM_BUS_WIFI_MGR_API_isPaired, (void *)&param, sizeof(param));
             paired = (retVal == IARM_RESULT_SUCCESS) && param.data.isPaired;
             LOGINFO("[%s] : retVal:%d paired:%d", IARM_BUS_WIFI_MGR_API_isPaired, retVal, param.data.isPaired);
 
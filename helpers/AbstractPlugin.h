@@ -19,6 +19,7 @@
 
 #pragma once
 
+#include <functional>
 #include <unordered_map>
 #include "utils.h"
 
@@ -56,6 +57,19 @@ namespace WPEFramework {
 
         protected:
 
+            //the method, run with the plugin and method name known to IARM_BUS_CALL
+            template <typename METHOD, typename REALOBJECT>
+            static std::function<uint32_t(const WPEFramework::Core::JSON::VariantContainer&, WPEFramework::Core::JSON::VariantContainer&)>
+            scopedMethod(const string& methodName, const METHOD& method, REALOBJECT* objectPtr)
+            {
+                std::function<uint32_t(const WPEFramework::Core::JSON::VariantContainer&, WPEFramework::Core::JSON::VariantContainer&)> actualMethod =
+                    std::bind(method, objectPtr, std::placeholders::_1, std::placeholders::_2);
+                return [actualMethod, methodName](const WPEFramework::Core::JSON::VariantContainer& in, WPEFramework::Core::JSON::VariantContainer& out) -> uint32_t {
+                    WPEFramework::Plugin::IARMCallStats::Scope scope(EXPAND_AND_QUOTE(MODULE_NAME), methodName.c_str());
+                    return actualMethod(in, out);
+                };
+            }
+
             //registerMethod to register a method in all versions
             template <typename METHOD, typename REALOBJECT>
             void registerMethod(const string& methodName, const METHOD& method, REALOBJECT* objectPtr)
@@ -65,7 +79,7 @@ namespace WPEFramework {
                     auto handler = m_versionHandlers.find(ver);
                     if(handler != m_versionHandlers.end())
                     {
-                        handler->second->Register<WPEFramework::Core::JSON::VariantContainer, WPEFramework::Core::JSON::VariantContainer, METHOD, REALOBJECT>(methodName, method, objectPtr);
+                        handler->second->Register<WPEFramework::Core::JSON::VariantContainer, WPEFramework::Core::JSON::VariantContainer>(methodName, scopedMethod(methodName, method, objectPtr));
                         m_versionAPIs[ver].push_back(methodName);
                     }
                 }
@@ -80,7 +94,7 @@ namespace WPEFramework {
                     auto handler = m_versionHandlers.find(ver);
                     if(handler != m_versionHandlers.end())
                     {
-                        handler->second->Register<WPEFramework::Core::JSON::VariantContainer, WPEFramework::Core::JSON::VariantContainer, METHOD, REALOBJECT>(methodName, method, objectPtr);
+                        handler->second->Register<WPEFramework::Core::JSON::VariantContainer, WPEFramework::Core::JSON::VariantContainer>(methodName, scopedMethod(methodName, method, objectPtr));
                         m_versionAPIs[ver].push_back(methodName);
                     }
                 } 
@@ -0,0 +1,89 @@
+/**
+* If not stated otherwise in this file or this component's LICENSE
+* file the following copyright and licenses apply:
+*
+* Copyright 2019 RDK Management
+*
+* Licensed under the Apache License, Version 2.0 (the "License");
+* you may not use this file except in compliance with the License.
+* You may obtain a copy of the License at
+*
+* http://www.apache.org/licenses/LICENSE-2.0
+*
+* Unless required by applicable law or agreed to in writing, software
+* distributed under the License is distributed on an "AS IS" BASIS,
+* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+* See the License for the specific language governing permissions and
+* limitations under the License.
+**/
+
+#pragma once
+
+// The logging macros and telemetry of utils.h, for helpers that are built
+// without the rest of it (RFC, IARM), e.g. into RdkServicesTest
+
+#include <stdarg.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <syscall.h>
+#include <unistd.h>
+#include <string>
+#include <plugins/plugins.h>
+#include <tracing/tracing.h>
+
+// telemetry
+#ifdef ENABLE_TELEMETRY_LOGGING
+#include <telemetry_busmessage_sender.h>
+#endif
+
+#define LOGINFO(fmt, ...) do { fprintf(stderr, "[%d] INFO [%s:%d] %s: " fmt "\n", (int)syscall(SYS_gettid), Core::FileNameOnly(__FILE__), __LINE__, __FUNCTION__, ##__VA_ARGS__); fflush(stderr); } while (0)
+#define LOGDBG(fmt, ...) do { fprintf(stderr, "[%d] DEBUG [%s:%d] %s: " fmt "\n", (int)syscall(SYS_gettid), Core::FileNameOnly(__FILE__), __LINE__, __FUNCTION__, ##__VA_ARGS__); fflush(stderr); } while (0)
+#define LOGWARN(fmt, ...) do { fprintf(stderr, "[%d] WARN [%s:%d] %s: " fmt "\n", (int)syscall(SYS_gettid), Core::FileNameOnly(__FILE__), __LINE__, __FUNCTION__, ##__VA_ARGS__); fflush(stderr); } while (0)
+#define LOGERR(fmt, ...) do { fprintf(stderr, "[%d] ERROR [%s:%d] %s: " fmt "\n", (int)syscall(SYS_gettid), Core::FileNameOnly(__FILE__), __LINE__, __FUNCTION__, ##__VA_ARGS__); fflush(stderr); Utils::Telemetry::sendError(fmt, ##__VA_ARGS__); } while (0)
+
+namespace Utils
+{
+    struct Telemetry
+    {
+        static void init()
+        {
+#ifdef ENABLE_TELEMETRY_LOGGING
+            t2_init("Thunder_Plugins");
+#endif
+        };
+
+        static void sendMessage(const char* message)
+        {
+#ifdef ENABLE_TELEMETRY_LOGGING
+            t2_event_s("THUNDER_MESSAGE", message);
+#endif
+        };
+
+        static void sendMessage(const char *marker, const char* message)
+        {
+#ifdef ENABLE_TELEMETRY_LOGGING
+            t2_event_s(marker, message);
+#endif
+        };
+
+        static void sendError(const char* format, ...)
+        {
+#ifdef ENABLE_TELEMETRY_LOGGING
+            va_list parameters;
+            va_start(parameters, format);
+            std::string message;
+            WPEFramework::Trace::Format(message, format, parameters);
+            va_end(parameters);
+
+            // get rid of const for t2_event_s
+            char* error = strdup(message.c_str());
+            t2_event_s("THUNDER_ERROR", error);
+            if (error)
+            {
+                free(error);
+            }
+#endif
+        };
+    };
+} // namespace Utils
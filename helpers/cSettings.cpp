@@ -20,7 +20,9 @@
 
 #include <iostream>
 #include <fstream>
+#include <sstream>
 #include "cSettings.h"
+#include "settingsstore.h"
 #include "SystemServicesHelper.h"
 
 /***
@@ -81,29 +83,26 @@ bool cSettings::readFromFile()
 
 /***
  * @brief    : Update new inserts into the json object onto file.
- * @return  : <bool> False if timer thread couldn't be started.
+ *             The file is written by its SettingsStore, a burst of
+ *             changes at once and atomically.
+ * @return  : <bool> False if the file does not exist.
  */
 bool cSettings::writeToFile()
 {
     bool status = false;
 
     if (Utils::fileExists(filename.c_str())) {
-        ofstream ofile;
-        ofile.open(filename.c_str(),ios::out);
-        if (ofile) {
-            JsonObject::Iterator iterator = data.Variants();
-            while (iterator.Next()) {
-                if (!data[iterator.Label()].String().empty()) {
-                    ofile << iterator.Label() << "=" << data[iterator.Label()].String() << endl;
-                } else {
-                    continue;
-                }
+        std::ostringstream contents;
+        JsonObject::Iterator iterator = data.Variants();
+        while (iterator.Next()) {
+            if (!data[iterator.Label()].String().empty()) {
+                contents << iterator.Label() << "=" << data[iterator.Label()].String() << endl;
+            } else {
+                continue;
             }
-            status = true;
-            ofile.close();
-        } else {
-            status = false;
         }
+        WPEFramework::Plugin::SettingsStore::instance(filename).write(contents.str());
+        status = true;
     }
     return status;
 }
@@ -24,9 +24,11 @@
  * @return   : nil.
  */
 cTimer::cTimer()
+    : timer([this]() { timed(); })
 {
     clear = false;
     interval = 0;
+    callBack_function = NULL;
 }
 
 /***
@@ -36,6 +38,7 @@ cTimer::cTimer()
 cTimer::~cTimer()
 {
     this->clear = true;
+    TimerWheel::instance().cancel(timer, true);
 }
 
 /***
@@ -48,18 +51,22 @@ bool cTimer::start()
         return false;
     }
     this->clear = false;
-    std::thread timerThread([=]() {
-            while (true) {
-            if (this->clear) return;
-            std::this_thread::sleep_for(std::chrono::milliseconds(interval));
-            if (this->clear) return;
-            this->callBack_function();
-            }
-            });
-    timerThread.detach();
+    TimerWheel::instance().schedule(timer, interval);
     return true;
 }
 
+/***
+ * @brief : invoke the callback and re-arm, the next interval starts once the callback returned.
+ * @return   : nil
+ */
+void cTimer::timed()
+{
+    if (this->clear) return;
+    this->callBack_function();
+    if (this->clear) return;
+    TimerWheel::instance().schedule(timer, interval);
+}
+
 /***
  * @brief : stop timer thread.
  * @return   : nil
@@ -67,6 +74,7 @@ bool cTimer::start()
 void cTimer::stop()
 {
     this->clear = true;
+    TimerWheel::instance().cancel(timer);
 }
 
 /***
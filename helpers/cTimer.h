@@ -19,14 +19,19 @@
 
 #include <thread>
 #include <chrono>
+#include <atomic>
+#include "timerwheel.h"
 
 using namespace std;
 
 class cTimer{
     private:
-        bool clear;
+        std::atomic<bool> clear;
         int interval;
         void (*callBack_function)();
+        TimerWheel::Timer timer;
+
+        void timed();
     public:
         /***
          * @brief    : Constructor.
@@ -53,7 +58,9 @@ class cTimer{
         void stop();
 
         /***
-         * @brief        : Set interval in which the given function should be invoked.
+         * @brief        : Set interval in which the given function should be invoked. It runs on
+         *                 the shared TimerWheel thread: keep it short, use TpTimer for anything
+         *                 that blocks.
          * @param1[in]   : function which has to be invoked on timed intervals
          * @param2[in]   : timer interval val.
          * @return       : nil
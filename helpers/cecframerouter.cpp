@@ -0,0 +1,134 @@
+/**
+* If not stated otherwise in this file or this component's LICENSE
+* file the following copyright and licenses apply:
+*
+* Copyright 2020 RDK Management
+*
+* Licensed under the Apache License, Version 2.0 (the "License");
+* you may not use this file except in compliance with the License.
+* You may obtain a copy of the License at
+*
+* http://www.apache.org/licenses/LICENSE-2.0
+*
+* Unless required by applicable law or agreed to in writing, software
+* distributed under the License is distributed on an "AS IS" BASIS,
+* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+* See the License for the specific language governing permissions and
+* limitations under the License.
+**/
+
+#include "cecframerouter.h"
+
+#include <stdio.h>
+#include <algorithm>
+#include <vector>
+
+// Kept free of utils.h, the library is not a plugin
+#define CECROUTERLOG(fmt, ...) fprintf(stderr, "[%s:%d] CECFrameRouter: " fmt "\n", __FUNCTION__, __LINE__, ##__VA_ARGS__)
+
+namespace WPEFramework
+{
+
+    namespace Plugin
+    {
+
+        CECFrameRouter& CECFrameRouter::instance()
+        {
+            static CECFrameRouter router;
+            return router;
+        }
+
+        CECFrameRouter::CECFrameRouter()
+            : m_users(0)
+            , m_connection(nullptr)
+        {
+        }
+
+        void CECFrameRouter::acquire()
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            if (m_users++ > 0)
+                return;
+
+            m_connection = new Connection(LogicalAddress::UNREGISTERED, false, "CECFrameRouter::Connection::");
+            m_connection->open();
+            m_connection->addFrameListener(this);
+            m_router.start([this](const uint8_t* data, size_t len) { return transmit(data, len); });
+        }
+
+        void CECFrameRouter::release()
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            if (m_users == 0 || --m_users > 0)
+                return;
+
+            m_router.stop();
+            m_connection->close();
+            delete m_connection;
+            m_connection = nullptr;
+
+            CECRouter::Stats stats = m_router.stats();
+            CECROUTERLOG("frames: %llu received, %llu delivered, %llu unhandled; %llu sent, %llu not acked, %llu failed, %llu dropped, up to %u queued and %llu us waiting",
+                (unsigned long long)stats.received, (unsigned long long)stats.delivered, (unsigned long long)stats.unhandled,
+                (unsigned long long)stats.sent, (unsigned long long)stats.notAcked, (unsigned long long)stats.failed,
+                (unsigned long long)stats.dropped, stats.maxQueued, (unsigned long long)stats.maxSendWaitUs);
+        }
+
+        bool CECFrameRouter::send(const CECFrame& frame)
+        {
+            const uint8_t* data = nullptr;
+            size_t len = 0;
+            CECFrame copy = frame;
+            copy.getBuffer(&data, &len);
+            return m_router.send(data, len);
+        }
+
+        CECRouter::SendResult CECFrameRouter::sendTo(const LogicalAddress& from, const LogicalAddress& to, const CECFrame& frame)
+        {
+            const uint8_t* body = nullptr;
+            size_t len = 0;
+            CECFrame copy = frame;
+            copy.getBuffer(&body, &len);
+
+            std::vector<uint8_t> data(1 + len);
+            data[0] = ((from.toInt() & 0x0F) << 4) | (to.toInt() & 0x0F);
+            std::copy(body, body + len, data.begin() + 1);
+            return m_router.sendAndWait(data.data(), data.size());
+        }
+
+        CECRouter::SendResult CECFrameRouter::ping(uint8_t from, uint8_t to)
+        {
+            uint8_t header = ((from & 0x0F) << 4) | (to & 0x0F);
+            return m_router.sendAndWait(&header, 1);
+        }
+
+        void CECFrameRouter::notify(const CECFrame& in) const
+        {
+            const uint8_t* data = nullptr;
+            size_t len = 0;
+            CECFrame frame = in;
+            frame.getBuffer(&data, &len);
+            const_cast<CECFrameRouter*>(this)->m_router.route(data, len);
+        }
+
+        CECRouter::SendResult CECFrameRouter::transmit(const uint8_t* data, size_t len)
+        {
+            try
+            {
+                m_connection->send(CECFrame(data, len), CEC_FRAME_ROUTER_SEND_TIMEOUT_MS, Throw_e());
+            }
+            catch (CECNoAckException& e)
+            {
+                return CECRouter::SEND_NO_ACK;
+            }
+            catch (Exception& e)
+            {
+                CECROUTERLOG("send failed: %s", e.what());
+                return CECRouter::SEND_FAILED;
+            }
+            return CECRouter::SEND_OK;
+        }
+
+    } // namespace Plugin
+
+} // namespace WPEFramework
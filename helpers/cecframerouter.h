@@ -0,0 +1,106 @@
+/**
+* If not stated otherwise in this file or this component's LICENSE
+* file the following copyright and licenses apply:
+*
+* Copyright 2020 RDK Management
+*
+* Licensed under the Apache License, Version 2.0 (the "License");
+* you may not use this file except in compliance with the License.
+* You may obtain a copy of the License at
+*
+* http://www.apache.org/licenses/LICENSE-2.0
+*
+* Unless required by applicable law or agreed to in writing, software
+* distributed under the License is distributed on an "AS IS" BASIS,
+* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+* See the License for the specific language governing permissions and
+* limitations under the License.
+**/
+
+#pragma once
+
+#include "ccec/Connection.hpp"
+#include "ccec/FrameListener.hpp"
+#include "ccec/CECFrame.hpp"
+
+#undef Assert // this define from Connection.hpp conflicts with WPEFramework
+
+#include <mutex>
+
+#include "cecrouter.h"
+
+// For a frame to be acknowledged, or not
+#define CEC_FRAME_ROUTER_SEND_TIMEOUT_MS 250
+
+namespace WPEFramework
+{
+
+    namespace Plugin
+    {
+
+        /***
+         * The CEC connection of the process, shared by the HdmiCec plugins: one listener
+         * on it and one thread sending, instead of a connection per plugin. Frames are
+         * routed by opcode, see CECRouter; LibCCEC is initialized by the plugins.
+         * Built into a library of its own, which the plugins link against, so that the
+         * process has a single instance whichever plugin libraries are loaded.
+         */
+        class CECFrameRouter : public FrameListener
+        {
+        public:
+            static CECFrameRouter& instance();
+
+            // The first plugin to acquire opens the connection, the last to release closes it
+            void acquire();
+            void release();
+
+            uint32_t subscribe(int opcode, const CECRouter::Handler& handler)
+            {
+                return m_router.subscribe(opcode, handler);
+            }
+            void unsubscribe(uint32_t subscription)
+            {
+                m_router.unsubscribe(subscription);
+            }
+
+            // A whole frame, header included
+            bool send(const uint8_t* data, size_t len)
+            {
+                return m_router.send(data, len);
+            }
+            bool send(const CECFrame& frame);
+            /***
+             * @brief        : As Connection::sendTo from the given logical address, for the plugins
+             *                 that allocated one: the header is built from both, and the frame is
+             *                 queued and waited for.
+             * @param frame  : the opcode and operands, as MessageEncoder gives them
+             */
+            CECRouter::SendResult sendTo(const LogicalAddress& from, const LogicalAddress& to, const CECFrame& frame);
+            // A polling message, acknowledged by a device at that address
+            CECRouter::SendResult ping(uint8_t from, uint8_t to);
+
+            CECRouter::Stats stats() const
+            {
+                return m_router.stats();
+            }
+
+            void notify(const CECFrame& in) const override;
+
+        private:
+            CECFrameRouter();
+
+            CECFrameRouter(const CECFrameRouter&) = delete;
+            CECFrameRouter& operator=(const CECFrameRouter&) = delete;
+
+            // On the sending thread, the connection is there until it is stopped
+            CECRouter::SendResult transmit(const uint8_t* data, size_t len);
+
+            std::mutex m_mutex;
+            uint32_t m_users;
+            Connection* m_connection;
+            CECRouter m_router;
+        };
+
+    } // namespace Plugin
+
+} // namespace WPEFramework
@@ -0,0 +1,278 @@
+/**
+* If not stated otherwise in this file or this component's LICENSE
+* file the following copyright and licenses apply:
+*
+* Copyright 2020 RDK Management
+*
+* Licensed under the Apache License, Version 2.0 (the "License");
+* you may not use this file except in compliance with the License.
+* You may obtain a copy of the License at
+*
+* http://www.apache.org/licenses/LICENSE-2.0
+*
+* Unless required by applicable law or agreed to in writing, software
+* distributed under the License is distributed on an "AS IS" BASIS,
+* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+* See the License for the specific language governing permissions and
+* limitations under the License.
+**/
+#include "cecrouter.h"
+
+namespace WPEFramework
+{
+
+    namespace Plugin
+    {
+
+        CECRouter::CECRouter(uint32_t minSendIntervalMs, size_t maxQueued)
+            : m_minSendInterval(minSendIntervalMs)
+            , m_maxQueued(maxQueued)
+            , m_nextId(1)
+            , m_subscriptions(0)
+            , m_routing(0)
+            , m_running(false)
+        {
+        }
+
+        CECRouter::~CECRouter()
+        {
+            stop();
+        }
+
+        uint32_t CECRouter::subscribe(int opcode, const Handler& handler)
+        {
+            if (opcode < 0 || opcode > CEC_ROUTER_POLL || !handler)
+                return 0;
+
+            std::lock_guard<std::mutex> lock(m_tableMutex);
+            std::shared_ptr<Subscribers> subscribers = m_table[opcode] ? std::make_shared<Subscribers>(*m_table[opcode]) : std::make_shared<Subscribers>();
+            // The opcode is kept in the subscription, for unsubscribe to find it
+            if ((m_nextId & 0xFFFFF) == 0)
+                m_nextId++;
+            Subscriber subscriber;
+            subscriber.id = (static_cast<uint32_t>(opcode) << 20) | (m_nextId++ & 0xFFFFF);
+            subscriber.handler = handler;
+            subscribers->push_back(subscriber);
+            m_table[opcode] = subscribers;
+            m_subscriptions++;
+            return subscriber.id;
+        }
+
+        void CECRouter::unsubscribe(uint32_t subscription)
+        {
+            int opcode = static_cast<int>(subscription >> 20);
+            if (subscription == 0 || opcode > CEC_ROUTER_POLL)
+                return;
+
+            std::unique_lock<std::mutex> lock(m_tableMutex);
+            if (!m_table[opcode])
+                return;
+            std::shared_ptr<Subscribers> subscribers = std::make_shared<Subscribers>();
+            for (const Subscriber& subscriber : *m_table[opcode])
+            {
+                if (subscriber.id != subscription)
+                    subscribers->push_back(subscriber);
+            }
+            if (subscribers->size() == m_table[opcode]->size())
+                return;
+            m_subscriptions--;
+            m_table[opcode] = subscribers->empty() ? nullptr : subscribers;
+
+            // A frame being routed may still have the handler, unless it is the one calling
+            if (m_routingThread != std::this_thread::get_id())
+                m_routed.wait(lock, [this]() { return m_routing == 0; });
+        }
+
+        size_t CECRouter::route(const uint8_t* data, size_t len)
+        {
+            if (data == nullptr || len == 0)
+                return 0;
+
+            Frame frame;
+            frame.initiator = (data[0] >> 4) & 0x0F;
+            frame.destination = data[0] & 0x0F;
+            frame.opcode = (len > 1) ? data[1] : CEC_ROUTER_POLL;
+            frame.data = data;
+            frame.len = len;
+
+            std::shared_ptr<const Subscribers> subscribers;
+            std::shared_ptr<const Subscribers> all;
+            {
+                std::lock_guard<std::mutex> lock(m_tableMutex);
+                subscribers = m_table[frame.opcode];
+                if (frame.opcode != CEC_ROUTER_POLL)
+                    all = m_table[CEC_ROUTER_ALL_OPCODES];
+                m_routing++;
+                m_routingThread = std::this_thread::get_id();
+            }
+
+            size_t delivered = 0;
+            deliver(subscribers, frame, delivered);
+            deliver(all, frame, delivered);
+
+            {
+                std::lock_guard<std::mutex> lock(m_tableMutex);
+                m_stats.received++;
+                m_stats.delivered += delivered;
+                if (delivered == 0)
+                    m_stats.unhandled++;
+                if (--m_routing == 0)
+                {
+                    m_routingThread = std::thread::id();
+                    m_routed.notify_all();
+                }
+            }
+            return delivered;
+        }
+
+        void CECRouter::deliver(const std::shared_ptr<const Subscribers>& subscribers, const Frame& frame, size_t& delivered)
+        {
+            if (!subscribers)
+                return;
+            for (const Subscriber& subscriber : *subscribers)
+            {
+                subscriber.handler(frame);
+                delivered++;
+            }
+        }
+
+        void CECRouter::start(const Transport& transport)
+        {
+            std::lock_guard<std::mutex> lock(m_sendMutex);
+            if (m_running)
+                return;
+            m_transport = transport;
+            m_running = true;
+            m_sender = std::thread(&CECRouter::sender, this);
+        }
+
+        void CECRouter::stop()
+        {
+            {
+                std::lock_guard<std::mutex> lock(m_sendMutex);
+                if (!m_running)
+                    return;
+                m_running = false;
+            }
+            m_sendCond.notify_all();
+            if (m_sender.joinable())
+                m_sender.join();
+
+            // Not sent, those waiting get to know
+            std::lock_guard<std::mutex> lock(m_sendMutex);
+            for (Outgoing& outgoing : m_queue)
+            {
+                m_stats.dropped++;
+                if (outgoing.result)
+                    outgoing.result->set_value(SEND_DROPPED);
+            }
+            m_queue.clear();
+            m_transport = nullptr;
+        }
+
+        bool CECRouter::send(const uint8_t* data, size_t len)
+        {
+            return enqueue(data, len, nullptr);
+        }
+
+        CECRouter::SendResult CECRouter::sendAndWait(const uint8_t* data, size_t len)
+        {
+            std::shared_ptr<std::promise<SendResult>> result = std::make_shared<std::promise<SendResult>>();
+            std::future<SendResult> sent = result->get_future();
+            if (!enqueue(data, len, result))
+                return SEND_DROPPED;
+            return sent.get();
+        }
+
+        bool CECRouter::enqueue(const uint8_t* data, size_t len, const std::shared_ptr<std::promise<SendResult>>& result)
+        {
+            {
+                std::lock_guard<std::mutex> lock(m_sendMutex);
+                if (!m_running || data == nullptr || len == 0 || m_queue.size() >= m_maxQueued)
+                {
+                    m_stats.dropped++;
+                    return false;
+                }
+
+                Outgoing outgoing;
+                outgoing.data.assign(data, data + len);
+                outgoing.queued = std::chrono::steady_clock::now();
+                outgoing.result = result;
+                m_queue.push_back(std::move(outgoing));
+                if (m_queue.size() > m_stats.maxQueued)
+                    m_stats.maxQueued = static_cast<uint32_t>(m_queue.size());
+            }
+            m_sendCond.notify_one();
+            return true;
+        }
+
+        void CECRouter::sender()
+        {
+            std::chrono::steady_clock::time_point lastSent;
+            std::unique_lock<std::mutex> lock(m_sendMutex);
+            while (true)
+            {
+                m_sendCond.wait(lock, [this]() { return !m_running || !m_queue.empty(); });
+                if (!m_running)
+                    break;
+
+                // Paced from the end of the previous frame, whoever queued it
+                std::chrono::steady_clock::time_point next = lastSent + m_minSendInterval;
+                if (std::chrono::steady_clock::now() < next)
+                {
+                    m_sendCond.wait_until(lock, next, [this]() { return !m_running; });
+                    if (!m_running)
+                        break;
+                }
+
+                Outgoing outgoing(std::move(m_queue.front()));
+                m_queue.pop_front();
+                lock.unlock();
+
+                std::chrono::steady_clock::time_point started = std::chrono::steady_clock::now();
+                SendResult result = m_transport(outgoing.data.data(), outgoing.data.size());
+                lastSent = std::chrono::steady_clock::now();
+
+                lock.lock();
+                uint64_t waitUs = std::chrono::duration_cast<std::chrono::microseconds>(started - outgoing.queued).count();
+                if (waitUs > m_stats.maxSendWaitUs)
+                    m_stats.maxSendWaitUs = waitUs;
+                if (result == SEND_OK)
+                    m_stats.sent++;
+                else if (result == SEND_NO_ACK)
+                    m_stats.notAcked++;
+                else
+                    m_stats.failed++;
+                if (outgoing.result)
+                    outgoing.result->set_value(result);
+            }
+        }
+
+        size_t CECRouter::subscriptions() const
+        {
+            std::lock_guard<std::mutex> lock(m_tableMutex);
+            return m_subscriptions;
+        }
+
+        CECRouter::Stats CECRouter::stats() const
+        {
+            Stats stats;
+            {
+                std::lock_guard<std::mutex> lock(m_tableMutex);
+                stats.received = m_stats.received;
+                stats.delivered = m_stats.delivered;
+                stats.unhandled = m_stats.unhandled;
+            }
+            std::lock_guard<std::mutex> lock(m_sendMutex);
+            stats.sent = m_stats.sent;
+            stats.notAcked = m_stats.notAcked;
+            stats.failed = m_stats.failed;
+            stats.dropped = m_stats.dropped;
+            stats.maxQueued = m_stats.maxQueued;
+            stats.maxSendWaitUs = m_stats.maxSendWaitUs;
+            return stats;
+        }
+
+    } // namespace Plugin
+
+} // namespace WPEFramework
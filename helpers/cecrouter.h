@@ -0,0 +1,174 @@
+/**
+* If not stated otherwise in this file or this component's LICENSE
+* file the following copyright and licenses apply:
+*
+* Copyright 2020 RDK Management
+*
+* Licensed under the Apache License, Version 2.0 (the "License");
+* you may not use this file except in compliance with the License.
+* You may obtain a copy of the License at
+*
+* http://www.apache.org/licenses/LICENSE-2.0
+*
+* Unless required by applicable law or agreed to in writing, software
+* distributed under the License is distributed on an "AS IS" BASIS,
+* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+* See the License for the specific language governing permissions and
+* limitations under the License.
+**/
+
+#ifndef CECROUTER_H
+#define CECROUTER_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// Subscribes to every frame, after the subscribers of its opcode
+#define CEC_ROUTER_ALL_OPCODES 256
+// Subscribes to polling messages, the frames with no opcode
+#define CEC_ROUTER_POLL 257
+// Frames queued beyond are dropped, the bus is not keeping up anyway
+#define CEC_ROUTER_MAX_QUEUED 64
+// Between the frames sent, a 2 byte frame alone takes some 50 ms on the bus
+#define CEC_ROUTER_MIN_SEND_INTERVAL_MS 20
+
+namespace WPEFramework
+{
+
+    namespace Plugin
+    {
+
+        /***
+         * Routes the CEC frames of a connection to the plugins: the header and opcode of a
+         * frame are read once and the frame goes only to the subscribers of that opcode.
+         * Frames sent go through a single queue, one at a time and no closer than the send
+         * interval. The connection itself is behind the transport, see CECFrameRouter.
+         */
+        class CECRouter
+        {
+        public:
+            struct Frame
+            {
+                uint8_t initiator;
+                uint8_t destination;
+                int opcode;             // CEC_ROUTER_POLL for a polling message
+                const uint8_t* data;    // the whole frame, header included
+                size_t len;
+            };
+
+            enum SendResult
+            {
+                SEND_OK,
+                SEND_NO_ACK,
+                SEND_FAILED,
+                SEND_DROPPED
+            };
+
+            struct Stats
+            {
+                Stats() : received(0), delivered(0), unhandled(0), sent(0), notAcked(0), failed(0), dropped(0), maxQueued(0), maxSendWaitUs(0) {}
+
+                uint64_t received;
+                uint64_t delivered;     // to a subscriber, a frame may go to several
+                uint64_t unhandled;     // with no subscriber
+                uint64_t sent;
+                uint64_t notAcked;
+                uint64_t failed;
+                uint64_t dropped;
+                uint32_t maxQueued;
+                uint64_t maxSendWaitUs; // from queued to on the bus
+            };
+
+            typedef std::function<void(const Frame& frame)> Handler;
+            typedef std::function<SendResult(const uint8_t* data, size_t len)> Transport;
+
+            explicit CECRouter(uint32_t minSendIntervalMs = CEC_ROUTER_MIN_SEND_INTERVAL_MS, size_t maxQueued = CEC_ROUTER_MAX_QUEUED);
+            ~CECRouter();
+
+            CECRouter(const CECRouter&) = delete;
+            CECRouter& operator=(const CECRouter&) = delete;
+
+            /***
+             * @brief        : Subscribe to an opcode, CEC_ROUTER_ALL_OPCODES or CEC_ROUTER_POLL.
+             * @return       : the subscription, 0 for an invalid opcode
+             */
+            uint32_t subscribe(int opcode, const Handler& handler);
+
+            // Once it returns, the handler is not called any more, unless from the handler itself
+            void unsubscribe(uint32_t subscription);
+
+            /***
+             * @brief        : Deliver a frame received, on the thread of the connection.
+             * @return       : the subscribers it went to
+             */
+            size_t route(const uint8_t* data, size_t len);
+
+            // The send queue, between start and stop
+            void start(const Transport& transport);
+            void stop();
+
+            // Queues the frame, false if dropped
+            bool send(const uint8_t* data, size_t len);
+            // Queues the frame and waits for it to be sent, as for a ping
+            SendResult sendAndWait(const uint8_t* data, size_t len);
+
+            // The subscriptions to any opcode
+            size_t subscriptions() const;
+            Stats stats() const;
+
+        private:
+            struct Subscriber
+            {
+                uint32_t id;
+                Handler handler;
+            };
+            typedef std::vector<Subscriber> Subscribers;
+
+            struct Outgoing
+            {
+                std::vector<uint8_t> data;
+                std::chrono::steady_clock::time_point queued;
+                std::shared_ptr<std::promise<SendResult>> result;
+            };
+
+            bool enqueue(const uint8_t* data, size_t len, const std::shared_ptr<std::promise<SendResult>>& result);
+            void deliver(const std::shared_ptr<const Subscribers>& subscribers, const Frame& frame, size_t& delivered);
+            void sender();
+
+            const std::chrono::milliseconds m_minSendInterval;
+            const size_t m_maxQueued;
+
+            // Replaced, not changed, so that a frame is routed without holding the lock
+            mutable std::mutex m_tableMutex;
+            std::shared_ptr<const Subscribers> m_table[CEC_ROUTER_POLL + 1];
+            uint32_t m_nextId;
+            size_t m_subscriptions;
+            std::condition_variable m_routed;
+            uint32_t m_routing;
+            std::thread::id m_routingThread;
+
+            mutable std::mutex m_sendMutex;
+            std::condition_variable m_sendCond;
+            std::deque<Outgoing> m_queue;
+            Transport m_transport;
+            bool m_running;
+            std::thread m_sender;
+
+            // The receiving side under m_tableMutex, the sending side under m_sendMutex
+            Stats m_stats;
+        };
+
+    } // namespace Plugin
+
+} // namespace WPEFramework
+
+#endif
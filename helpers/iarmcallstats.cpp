@@ -0,0 +1,416 @@
+/**
+* If not stated otherwise in this file or this component's LICENSE
+* file the following copyright and licenses apply:
+*
+* Copyright 2020 RDK Management
+*
+* Licensed under the Apache License, Version 2.0 (the "License");
+* you may not use this file except in compliance with the License.
+* You may obtain a copy of the License at
+*
+* http://www.apache.org/licenses/LICENSE-2.0
+*
+* Unless required by applicable law or agreed to in writing, software
+* distributed under the License is distributed on an "AS IS" BASIS,
+* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+* See the License for the specific language governing permissions and
+* limitations under the License.
+**/
+
+#include "iarmcallstats.h"
+
+#include <errno.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <fcntl.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <algorithm>
+#include <thread>
+
+// Kept free of utils.h so the stats link without the plugin helpers
+#define IARMSTATSLOG(fmt, ...) fprintf(stderr, "[%s:%d] IARMCallStats: " fmt "\n", __FUNCTION__, __LINE__, ##__VA_ARGS__)
+
+namespace WPEFramework
+{
+
+    namespace Plugin
+    {
+
+        namespace
+        {
+            enum SlotState : uint32_t
+            {
+                SLOT_FREE = 0,
+                SLOT_CLAIMING,
+                SLOT_READY
+            };
+
+            uint64_t nowNs()
+            {
+                struct timespec ts;
+                clock_gettime(CLOCK_MONOTONIC, &ts);
+                return static_cast<uint64_t>(ts.tv_sec) * 1000000000ULL + ts.tv_nsec;
+            }
+
+            size_t bucketOf(uint64_t us)
+            {
+                if (us == 0)
+                    return 0;
+                size_t bucket = 64 - __builtin_clzll(us);
+                return (bucket < IARM_CALL_STATS_BUCKETS) ? bucket : IARM_CALL_STATS_BUCKETS - 1;
+            }
+
+            uint32_t hashOf(const char* owner, const char* method)
+            {
+                uint32_t hash = 2166136261u;
+                for (const char* c = owner; *c; c++)
+                    hash = (hash ^ static_cast<uint8_t>(*c)) * 16777619u;
+                hash = (hash ^ '.') * 16777619u;
+                for (const char* c = method; *c; c++)
+                    hash = (hash ^ static_cast<uint8_t>(*c)) * 16777619u;
+                return hash;
+            }
+
+            /***
+             * The table file, only if it is a regular file of the process user that nobody
+             * else can write, of the given size. A missing one is created complete under a
+             * temporary name and linked in, so no process ever sees it half sized and an
+             * existing file is never resized.
+             */
+            int openTable(const std::string& path, size_t size)
+            {
+                int fd = open(path.c_str(), O_RDWR | O_NOFOLLOW | O_CLOEXEC);
+                if (fd < 0 && errno == ENOENT)
+                {
+                    std::string temporary = path + ".XXXXXX";
+                    int created = mkostemp(&temporary[0], O_CLOEXEC);
+                    if (created < 0)
+                        return -1;
+                    // Zero filled, mkostemp creates it 0600
+                    int error = 0;
+                    if (ftruncate(created, size) == 0 && link(temporary.c_str(), path.c_str()) == 0)
+                        fd = created;
+                    else
+                        error = errno;
+                    unlink(temporary.c_str());
+
+                    if (fd < 0)
+                    {
+                        close(created);
+                        // Unless another process linked its table in first
+                        if (error != EEXIST)
+                        {
+                            errno = error;
+                            return -1;
+                        }
+                        fd = open(path.c_str(), O_RDWR | O_NOFOLLOW | O_CLOEXEC);
+                    }
+                }
+                if (fd < 0)
+                    return -1;
+
+                struct stat st;
+                if (fstat(fd, &st) != 0 || !S_ISREG(st.st_mode) || st.st_uid != geteuid()
+                    || (st.st_mode & (S_IWGRP | S_IWOTH)) != 0 || static_cast<size_t>(st.st_size) != size)
+                {
+                    close(fd);
+                    errno = EPERM;
+                    return -1;
+                }
+                return fd;
+            }
+        }
+
+        // Only lock free atomics in here, they work across processes
+        struct IARMCallStats::Slot
+        {
+            std::atomic<uint32_t> state;
+            char owner[IARM_CALL_STATS_NAME_SIZE];
+            char method[IARM_CALL_STATS_NAME_SIZE];
+            std::atomic<int32_t> inFlight;
+            std::atomic<uint64_t> calls;
+            std::atomic<uint64_t> failures;
+            std::atomic<uint64_t> slow;
+            std::atomic<uint64_t> totalUs;
+            std::atomic<uint64_t> maxUs;
+            std::atomic<uint64_t> buckets[IARM_CALL_STATS_BUCKETS];
+            // Slow calls only, the text is written under the flag
+            std::atomic<uint32_t> lastSlowLock;
+            std::atomic<uint64_t> lastSlowUs;
+            char lastSlowCaller[IARM_CALL_STATS_CALLER_SIZE];
+
+            bool is(const char* o, const char* m) const
+            {
+                return strncmp(owner, o, sizeof(owner)) == 0 && strncmp(method, m, sizeof(method)) == 0;
+            }
+        };
+
+        struct IARMCallStats::Table
+        {
+            std::atomic<uint32_t> magic;
+            std::atomic<uint32_t> slowThresholdUs;
+            std::atomic<uint64_t> dropped;
+            Slot slots[IARM_CALL_STATS_SLOTS];
+        };
+
+        IARMCallStats& IARMCallStats::instance()
+        {
+            static IARMCallStats stats(IARM_CALL_STATS_PATH);
+            return stats;
+        }
+
+        IARMCallStats::IARMCallStats(const std::string& path)
+            : m_table(nullptr)
+            , m_shared(false)
+        {
+            static_assert(sizeof(std::atomic<uint64_t>) == sizeof(uint64_t), "atomics must be plain memory to be shared");
+
+            int fd = openTable(path, sizeof(Table));
+            if (fd >= 0)
+            {
+                void* table = mmap(nullptr, sizeof(Table), PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+                if (table != MAP_FAILED)
+                    m_table = static_cast<Table*>(table);
+                close(fd);
+            }
+
+            if (m_table != nullptr)
+            {
+                // Changes with the layout, a table of another layout is not shared
+                const uint32_t tableMagic = 0x49415243u ^ static_cast<uint32_t>(sizeof(Table));
+                uint32_t magic = 0;
+                if (m_table->magic.compare_exchange_strong(magic, tableMagic) || magic == tableMagic)
+                {
+                    m_shared = true;
+                }
+                else
+                {
+                    IARMSTATSLOG("%s holds another layout, keeping the stats private", path.c_str());
+                    munmap(m_table, sizeof(Table));
+                    m_table = nullptr;
+                }
+            }
+            else
+            {
+                IARMSTATSLOG("cannot map %s (%s), keeping the stats private", path.c_str(), strerror(errno));
+            }
+
+            if (m_table == nullptr)
+            {
+                void* table = mmap(nullptr, sizeof(Table), PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+                if (table != MAP_FAILED)
+                    m_table = static_cast<Table*>(table);
+            }
+        }
+
+        IARMCallStats::~IARMCallStats()
+        {
+            if (m_table != nullptr)
+                munmap(m_table, sizeof(Table));
+        }
+
+        void IARMCallStats::setSlowThresholdUs(uint32_t thresholdUs)
+        {
+            if (m_table != nullptr)
+                m_table->slowThresholdUs.store(thresholdUs, std::memory_order_relaxed);
+        }
+
+        uint32_t IARMCallStats::slowThresholdUs() const
+        {
+            // 0 until set, as the table starts zero filled
+            uint32_t thresholdUs = (m_table != nullptr) ? m_table->slowThresholdUs.load(std::memory_order_relaxed) : 0;
+            return (thresholdUs != 0) ? thresholdUs : IARM_CALL_STATS_DEFAULT_SLOW_US;
+        }
+
+        IARMCallStats::Slot* IARMCallStats::resolve(Site& site, const char* owner, const char* method)
+        {
+            // Names are checked as some sites pass them in variables
+            Slot* slot = site.slot.load(std::memory_order_acquire);
+            if (slot == nullptr || !slot->is(owner, method))
+            {
+                slot = find(owner, method);
+                site.slot.store(slot, std::memory_order_release);
+            }
+            return slot;
+        }
+
+        IARMCallStats::Slot* IARMCallStats::find(const char* owner, const char* method)
+        {
+            if (m_table == nullptr)
+                return nullptr;
+
+            uint32_t hash = hashOf(owner, method);
+            for (uint32_t probe = 0; probe < IARM_CALL_STATS_SLOTS; probe++)
+            {
+                Slot& slot = m_table->slots[(hash + probe) % IARM_CALL_STATS_SLOTS];
+
+                uint32_t state = slot.state.load(std::memory_order_acquire);
+                if (state == SLOT_FREE)
+                {
+                    if (slot.state.compare_exchange_strong(state, SLOT_CLAIMING, std::memory_order_acquire))
+                    {
+                        strncpy(slot.owner, owner, sizeof(slot.owner) - 1);
+                        strncpy(slot.method, method, sizeof(slot.method) - 1);
+                        slot.state.store(SLOT_READY, std::memory_order_release);
+                        return &slot;
+                    }
+                }
+                // Names are written once, right after the claim. A slot that stays claimed was left
+                // by a process killed in between, it is skipped and never named.
+                if (state == SLOT_CLAIMING)
+                {
+                    uint64_t deadlineNs = nowNs() + IARM_CALL_STATS_CLAIM_WAIT_US * 1000ULL;
+                    do
+                    {
+                        std::this_thread::yield();
+                        state = slot.state.load(std::memory_order_acquire);
+                    } while (state == SLOT_CLAIMING && nowNs() < deadlineNs);
+                    if (state == SLOT_CLAIMING)
+                        continue;
+                }
+                if (slot.is(owner, method))
+                    return &slot;
+            }
+            return nullptr;
+        }
+
+        IARMCallStats::Call::Call(IARMCallStats& stats, Site& site, const char* owner, const char* method)
+            : m_slot(stats.resolve(site, owner, method))
+            , m_startNs(0)
+            , m_elapsedUs(0)
+            , m_slowUs(stats.slowThresholdUs())
+        {
+            if (m_slot != nullptr)
+                m_slot->inFlight.fetch_add(1, std::memory_order_relaxed);
+            else if (stats.m_table != nullptr)
+                stats.m_table->dropped.fetch_add(1, std::memory_order_relaxed);
+            m_startNs = nowNs();
+        }
+
+        bool IARMCallStats::Call::end(bool succeeded)
+        {
+            m_elapsedUs = (nowNs() - m_startNs) / 1000;
+            bool slow = m_elapsedUs > m_slowUs;
+            if (m_slot == nullptr)
+                return slow;
+
+            m_slot->inFlight.fetch_sub(1, std::memory_order_relaxed);
+            m_slot->calls.fetch_add(1, std::memory_order_relaxed);
+            if (!succeeded)
+                m_slot->failures.fetch_add(1, std::memory_order_relaxed);
+            m_slot->totalUs.fetch_add(m_elapsedUs, std::memory_order_relaxed);
+            m_slot->buckets[bucketOf(m_elapsedUs)].fetch_add(1, std::memory_order_relaxed);
+
+            uint64_t maxUs = m_slot->maxUs.load(std::memory_order_relaxed);
+            while (m_elapsedUs > maxUs && !m_slot->maxUs.compare_exchange_weak(maxUs, m_elapsedUs, std::memory_order_relaxed))
+                ;
+
+            if (slow)
+            {
+                m_slot->slow.fetch_add(1, std::memory_order_relaxed);
+                // Another slow call recording meanwhile wins, no waiting here
+                if (m_slot->lastSlowLock.exchange(1, std::memory_order_acquire) == 0)
+                {
+                    snprintf(m_slot->lastSlowCaller, sizeof(m_slot->lastSlowCaller), "%s %s", Scope::plugin(), Scope::method());
+                    m_slot->lastSlowUs.store(m_elapsedUs, std::memory_order_relaxed);
+                    m_slot->lastSlowLock.store(0, std::memory_order_release);
+                }
+            }
+            return slow;
+        }
+
+        std::vector<IARMCallStats::Entry> IARMCallStats::snapshot() const
+        {
+            std::vector<Entry> entries;
+            if (m_table == nullptr)
+                return entries;
+
+            for (const Slot& slot : m_table->slots)
+            {
+                if (slot.state.load(std::memory_order_acquire) != SLOT_READY)
+                    continue;
+
+                Entry entry;
+                entry.owner.assign(slot.owner, strnlen(slot.owner, sizeof(slot.owner)));
+                entry.method.assign(slot.method, strnlen(slot.method, sizeof(slot.method)));
+                entry.inFlight = slot.inFlight.load(std::memory_order_relaxed);
+                entry.calls = slot.calls.load(std::memory_order_relaxed);
+                entry.failures = slot.failures.load(std::memory_order_relaxed);
+                entry.slow = slot.slow.load(std::memory_order_relaxed);
+                entry.totalUs = slot.totalUs.load(std::memory_order_relaxed);
+                entry.maxUs = slot.maxUs.load(std::memory_order_relaxed);
+                for (const std::atomic<uint64_t>& bucket : slot.buckets)
+                    entry.buckets.push_back(bucket.load(std::memory_order_relaxed));
+
+                entry.lastSlowUs = 0;
+                uint32_t unlocked = 0;
+                if (const_cast<Slot&>(slot).lastSlowLock.compare_exchange_strong(unlocked, 1, std::memory_order_acquire))
+                {
+                    entry.lastSlowCaller.assign(slot.lastSlowCaller, strnlen(slot.lastSlowCaller, sizeof(slot.lastSlowCaller)));
+                    entry.lastSlowUs = slot.lastSlowUs.load(std::memory_order_relaxed);
+                    const_cast<Slot&>(slot).lastSlowLock.store(0, std::memory_order_release);
+                }
+                entries.push_back(entry);
+            }
+            return entries;
+        }
+
+        void IARMCallStats::reset()
+        {
+            if (m_table == nullptr)
+                return;
+
+            for (Slot& slot : m_table->slots)
+            {
+                if (slot.state.load(std::memory_order_acquire) != SLOT_READY)
+                    continue;
+
+                slot.calls.store(0, std::memory_order_relaxed);
+                slot.failures.store(0, std::memory_order_relaxed);
+                slot.slow.store(0, std::memory_order_relaxed);
+                slot.totalUs.store(0, std::memory_order_relaxed);
+                slot.maxUs.store(0, std::memory_order_relaxed);
+                for (std::atomic<uint64_t>& bucket : slot.buckets)
+                    bucket.store(0, std::memory_order_relaxed);
+            }
+            m_table->dropped.store(0, std::memory_order_relaxed);
+        }
+
+        uint64_t IARMCallStats::dropped() const
+        {
+            return (m_table != nullptr) ? m_table->dropped.load(std::memory_order_relaxed) : 0;
+        }
+
+        uint64_t IARMCallStats::bucketUpperUs(size_t bucket)
+        {
+            return (bucket + 1 < IARM_CALL_STATS_BUCKETS) ? (1ULL << bucket) : UINT64_MAX;
+        }
+
+        uint64_t IARMCallStats::percentileUs(const Entry& entry, double fraction)
+        {
+            uint64_t calls = 0;
+            for (uint64_t count : entry.buckets)
+                calls += count;
+            if (calls == 0)
+                return 0;
+
+            uint64_t rank = static_cast<uint64_t>(fraction * calls + 0.5);
+            if (rank == 0)
+                rank = 1;
+            uint64_t seen = 0;
+            for (size_t bucket = 0; bucket < entry.buckets.size(); bucket++)
+            {
+                seen += entry.buckets[bucket];
+                if (seen >= rank)
+                    return std::min(bucketUpperUs(bucket), entry.maxUs);
+            }
+            return entry.maxUs;
+        }
+
+    } // namespace Plugin
+
+} // namespace WPEFramework
@@ -0,0 +1,189 @@
+/**
+* If not stated otherwise in this file or this component's LICENSE
+* file the following copyright and licenses apply:
+*
+* Copyright 2020 RDK Management
+*
+* Licensed under the Apache License, Version 2.0 (the "License");
+* you may not use this file except in compliance with the License.
+* You may obtain a copy of the License at
+*
+* http://www.apache.org/licenses/LICENSE-2.0
+*
+* Unless required by applicable law or agreed to in writing, software
+* distributed under the License is distributed on an "AS IS" BASIS,
+* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+* See the License for the specific language governing permissions and
+* limitations under the License.
+**/
+
+#ifndef IARMCALLSTATS_H
+#define IARMCALLSTATS_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include <atomic>
+#include <string>
+#include <vector>
+
+// Shared by the plugins of all processes of one user, so that one of them can report on all
+#define IARM_CALL_STATS_PATH "/dev/shm/rdkservices_iarm_calls"
+#define IARM_CALL_STATS_SLOTS 256
+// Bucket 0 is under 1us, bucket i from 2^(i-1)us to under 2^i us, the last one everything above
+#define IARM_CALL_STATS_BUCKETS 24
+#define IARM_CALL_STATS_NAME_SIZE 64
+#define IARM_CALL_STATS_CALLER_SIZE 128
+#define IARM_CALL_STATS_DEFAULT_SLOW_US (100 * 1000)
+// An entry still being claimed after this long was left by a process killed while claiming it
+#define IARM_CALL_STATS_CLAIM_WAIT_US 1000
+
+namespace WPEFramework
+{
+
+    namespace Plugin
+    {
+
+        /***
+         * Latency histograms and in-flight counts of IARM bus calls, per (owner, method).
+         * The counters live in a table mapped from IARM_CALL_STATS_PATH by every plugin
+         * making calls, in or out of process, and are updated with relaxed atomics; a call
+         * site resolves its entry once, so a call costs two clock reads and a few atomic
+         * adds. Calls slower than the threshold are reported to the caller, which logs them.
+         */
+        class IARMCallStats
+        {
+            struct Slot;
+            struct Table;
+
+        public:
+            /***
+             * The entry of a call site, cached by the site.
+             */
+            struct Site
+            {
+                Site() : slot(nullptr) {}
+                std::atomic<Slot*> slot;
+            };
+
+            /***
+             * The plugin and JSON-RPC method the calling thread is handling, set by AbstractPlugin.
+             */
+            class Scope
+            {
+            public:
+                Scope(const char* plugin, const char* method)
+                    : m_previous(current())
+                {
+                    current() = Context(plugin, method);
+                }
+                ~Scope()
+                {
+                    current() = m_previous;
+                }
+
+                Scope(const Scope&) = delete;
+                Scope& operator=(const Scope&) = delete;
+
+                static const char* plugin() { return current().plugin; }
+                static const char* method() { return current().method; }
+
+            private:
+                struct Context
+                {
+                    Context(const char* p = "", const char* m = "") : plugin(p), method(m) {}
+                    const char* plugin;
+                    const char* method;
+                };
+
+                static Context& current()
+                {
+                    static thread_local Context context;
+                    return context;
+                }
+
+                Context m_previous;
+            };
+
+            /***
+             * One call, timed from construction to end().
+             */
+            class Call
+            {
+            public:
+                Call(IARMCallStats& stats, Site& site, const char* owner, const char* method);
+
+                Call(const Call&) = delete;
+                Call& operator=(const Call&) = delete;
+
+                /***
+                 * @brief        : Record the call.
+                 * @return       : true if it took longer than the threshold
+                 */
+                bool end(bool succeeded);
+                uint64_t elapsedUs() const { return m_elapsedUs; }
+
+            private:
+                Slot* m_slot;
+                uint64_t m_startNs;
+                uint64_t m_elapsedUs;
+                uint32_t m_slowUs;
+            };
+
+            struct Entry
+            {
+                std::string owner;
+                std::string method;
+                int32_t inFlight;
+                uint64_t calls;
+                uint64_t failures;
+                uint64_t slow;
+                uint64_t totalUs;
+                uint64_t maxUs;
+                std::vector<uint64_t> buckets;
+                std::string lastSlowCaller;     // "<plugin> <JSON-RPC method>", if any
+                uint64_t lastSlowUs;
+            };
+
+            /***
+             * @brief        : The stats of the process, shared through IARM_CALL_STATS_PATH.
+             */
+            static IARMCallStats& instance();
+
+            /***
+             * @brief        : Maps the table from the path, or keeps it private if that fails or the
+             *                 file is not a regular file of the process user, writable only by it.
+             */
+            explicit IARMCallStats(const std::string& path);
+            ~IARMCallStats();
+
+            IARMCallStats(const IARMCallStats&) = delete;
+            IARMCallStats& operator=(const IARMCallStats&) = delete;
+
+            bool shared() const { return m_shared; }
+
+            void setSlowThresholdUs(uint32_t thresholdUs);
+            uint32_t slowThresholdUs() const;
+
+            std::vector<Entry> snapshot() const;
+            // Calls since the last reset, the in-flight counts are kept
+            void reset();
+            // Calls not recorded as the table was full, or the slots left were never named
+            uint64_t dropped() const;
+
+            static uint64_t bucketUpperUs(size_t bucket);
+            // The upper bound of the bucket holding the given fraction of the calls
+            static uint64_t percentileUs(const Entry& entry, double fraction);
+
+        private:
+            Slot* resolve(Site& site, const char* owner, const char* method);
+            Slot* find(const char* owner, const char* method);
+
+            Table* m_table;
+            bool m_shared;
+        };
+
+    } // namespace Plugin
+
+} // namespace WPEFramework
+
+#endif
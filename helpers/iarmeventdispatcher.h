@@ -0,0 +1,105 @@
+/**
+* If not stated otherwise in this file or this component's LICENSE
+* file the following copyright and licenses apply:
+*
+* Copyright 2020 RDK Management
+*
+* Licensed under the Apache License, Version 2.0 (the "License");
+* you may not use this file except in compliance with the License.
+* You may obtain a copy of the License at
+*
+* http://www.apache.org/licenses/LICENSE-2.0
+*
+* Unless required by applicable law or agreed to in writing, software
+* distributed under the License is distributed on an "AS IS" BASIS,
+* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+* See the License for the specific language governing permissions and
+* limitations under the License.
+**/
+
+#pragma once
+
+#include "utils.h"
+#include "iarmeventqueue.h"
+
+namespace WPEFramework
+{
+
+    namespace Plugin
+    {
+
+        /***
+         * Handles the IARM events of a plugin on the worker pool, one at a time and in
+         * order, instead of on the IARM callback thread: that thread is shared with every
+         * other event of the process and the bus waits for it, so building JSON and
+         * notifying slow subscribers there holds up the bus for everyone.
+         */
+        class IARMEventDispatcher
+        {
+        public:
+            typedef std::function<void(const char* owner, IARM_EventId_t eventId, void* data, size_t len)> Handler;
+
+            IARMEventDispatcher(const char* name, const Handler& handler)
+                : m_name(name)
+                , m_handler(handler)
+                , m_job(*this)
+            {
+            }
+            ~IARMEventDispatcher()
+            {
+                stop();
+            }
+
+            IARMEventDispatcher(const IARMEventDispatcher&) = delete;
+            IARMEventDispatcher& operator=(const IARMEventDispatcher&) = delete;
+
+            // From the IARM event handler, returns once the event is copied
+            void post(const char* owner, IARM_EventId_t eventId, void* data, size_t len)
+            {
+                uint64_t startNs = IARMEventQueue::nowNs();
+                // A drain running now still gets this one, Submit resubmits a job that is executing
+                if (m_queue.push(owner, eventId, data, len))
+                    m_job.Submit();
+                m_queue.recordPost(IARMEventQueue::nowNs() - startNs);
+            }
+
+            // Once the IARM event handlers are removed: waits for the event being handled, drops the others
+            void stop()
+            {
+                m_job.Revoke();
+                m_queue.clear();
+
+                IARMEventQueue::Stats stats = m_queue.stats();
+                if (stats.events > 0)
+                {
+                    LOGINFO("%s: %llu IARM events, %llu dropped, up to %u queued, %llu ns average and %llu ns max in the IARM callback, "
+                        "up to %llu us queued and %llu us handling",
+                        m_name, (unsigned long long)stats.events, (unsigned long long)stats.dropped, stats.maxDepth,
+                        (unsigned long long)(stats.postNs / stats.events), (unsigned long long)stats.maxPostNs,
+                        (unsigned long long)(stats.maxWaitNs / 1000), (unsigned long long)(stats.maxHandlerNs / 1000));
+                }
+            }
+
+            IARMEventQueue::Stats stats() const
+            {
+                return m_queue.stats();
+            }
+
+        private:
+            friend Core::ThreadPool::JobType<IARMEventDispatcher&>;
+            void Dispatch()
+            {
+                m_queue.drain([this](const char* owner, int32_t eventId, void* data, size_t len) {
+                    m_handler(owner, static_cast<IARM_EventId_t>(eventId), data, len);
+                });
+            }
+
+            const char* m_name;
+            Handler m_handler;
+            IARMEventQueue m_queue;
+            Core::WorkerPool::JobType<IARMEventDispatcher&> m_job;
+        };
+
+    } // namespace Plugin
+
+} // namespace WPEFramework
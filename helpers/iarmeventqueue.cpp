@@ -0,0 +1,137 @@
+/**
+* If not stated otherwise in this file or this component's LICENSE
+* file the following copyright and licenses apply:
+*
+* Copyright 2020 RDK Management
+*
+* Licensed under the Apache License, Version 2.0 (the "License");
+* you may not use this file except in compliance with the License.
+* You may obtain a copy of the License at
+*
+* http://www.apache.org/licenses/LICENSE-2.0
+*
+* Unless required by applicable law or agreed to in writing, software
+* distributed under the License is distributed on an "AS IS" BASIS,
+* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+* See the License for the specific language governing permissions and
+* limitations under the License.
+**/
+
+#include "iarmeventqueue.h"
+
+#include <time.h>
+
+namespace WPEFramework
+{
+
+    namespace Plugin
+    {
+
+        IARMEventQueue::IARMEventQueue(size_t maxEvents)
+            : m_maxEvents(maxEvents)
+            , m_scheduled(false)
+        {
+        }
+
+        uint64_t IARMEventQueue::nowNs()
+        {
+            struct timespec ts;
+            clock_gettime(CLOCK_MONOTONIC, &ts);
+            return static_cast<uint64_t>(ts.tv_sec) * 1000000000ULL + ts.tv_nsec;
+        }
+
+        bool IARMEventQueue::push(const char* owner, int32_t eventId, const void* data, size_t len)
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            if (m_events.size() >= m_maxEvents)
+            {
+                m_stats.dropped++;
+                return false;
+            }
+
+            Event event;
+            event.owner = (owner != nullptr) ? owner : "";
+            event.eventId = eventId;
+            if (!m_pool.empty())
+            {
+                event.data.swap(m_pool.back());
+                m_pool.pop_back();
+            }
+            // Allocates only for a payload larger than any before, or when the pool ran dry
+            if (event.data.capacity() < len)
+                m_stats.allocations++;
+            if (data != nullptr && len > 0)
+                event.data.assign(static_cast<const uint8_t*>(data), static_cast<const uint8_t*>(data) + len);
+            else
+                event.data.clear();
+            event.len = event.data.size();
+            event.queuedNs = nowNs();
+            m_events.push_back(std::move(event));
+
+            m_stats.events++;
+            if (m_events.size() > m_stats.maxDepth)
+                m_stats.maxDepth = static_cast<uint32_t>(m_events.size());
+
+            bool schedule = !m_scheduled;
+            m_scheduled = true;
+            return schedule;
+        }
+
+        size_t IARMEventQueue::drain(const Handler& handler)
+        {
+            size_t handled = 0;
+            std::unique_lock<std::mutex> lock(m_mutex);
+            while (!m_events.empty())
+            {
+                Event event(std::move(m_events.front()));
+                m_events.pop_front();
+                lock.unlock();
+
+                uint64_t startNs = nowNs();
+                handler(event.owner.c_str(), event.eventId, event.len > 0 ? event.data.data() : nullptr, event.len);
+                uint64_t endNs = nowNs();
+                handled++;
+
+                lock.lock();
+                if (startNs - event.queuedNs > m_stats.maxWaitNs)
+                    m_stats.maxWaitNs = startNs - event.queuedNs;
+                if (endNs - startNs > m_stats.maxHandlerNs)
+                    m_stats.maxHandlerNs = endNs - startNs;
+                if (m_pool.size() < IARM_EVENT_QUEUE_POOL_SIZE)
+                    m_pool.push_back(std::move(event.data));
+            }
+            // Under the lock, so that a push from now on schedules the next drain
+            m_scheduled = false;
+            return handled;
+        }
+
+        void IARMEventQueue::clear()
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_events.clear();
+            m_scheduled = false;
+        }
+
+        void IARMEventQueue::recordPost(uint64_t ns)
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_stats.postNs += ns;
+            if (ns > m_stats.maxPostNs)
+                m_stats.maxPostNs = ns;
+        }
+
+        size_t IARMEventQueue::size() const
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            return m_events.size();
+        }
+
+        IARMEventQueue::Stats IARMEventQueue::stats() const
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            return m_stats;
+        }
+
+    } // namespace Plugin
+
+} // namespace WPEFramework
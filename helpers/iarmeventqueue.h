@@ -0,0 +1,117 @@
+/**
+* If not stated otherwise in this file or this component's LICENSE
+* file the following copyright and licenses apply:
+*
+* Copyright 2020 RDK Management
+*
+* Licensed under the Apache License, Version 2.0 (the "License");
+* you may not use this file except in compliance with the License.
+* You may obtain a copy of the License at
+*
+* http://www.apache.org/licenses/LICENSE-2.0
+*
+* Unless required by applicable law or agreed to in writing, software
+* distributed under the License is distributed on an "AS IS" BASIS,
+* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+* See the License for the specific language governing permissions and
+* limitations under the License.
+**/
+
+#ifndef IARMEVENTQUEUE_H
+#define IARMEVENTQUEUE_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <vector>
+
+// Events queued beyond are dropped, a handler this far behind is not coming back soon
+#define IARM_EVENT_QUEUE_MAX_EVENTS 256
+// Payload buffers kept for reuse once handled
+#define IARM_EVENT_QUEUE_POOL_SIZE 16
+
+namespace WPEFramework
+{
+
+    namespace Plugin
+    {
+
+        /***
+         * IARM events copied out of the IARM callback, to be handled in order on another
+         * thread. The payloads are copied into buffers that are reused once handled.
+         * See IARMEventDispatcher for the worker pool side.
+         */
+        class IARMEventQueue
+        {
+        public:
+            typedef std::function<void(const char* owner, int32_t eventId, void* data, size_t len)> Handler;
+
+            struct Stats
+            {
+                Stats() : events(0), dropped(0), allocations(0), maxDepth(0), postNs(0), maxPostNs(0), maxWaitNs(0), maxHandlerNs(0) {}
+
+                uint64_t events;
+                uint64_t dropped;
+                uint64_t allocations;   // payload buffers that had to be allocated or grown
+                uint32_t maxDepth;
+                uint64_t postNs;        // time spent in the IARM callback, in total
+                uint64_t maxPostNs;
+                uint64_t maxWaitNs;     // from queued to handled
+                uint64_t maxHandlerNs;
+            };
+
+            explicit IARMEventQueue(size_t maxEvents = IARM_EVENT_QUEUE_MAX_EVENTS);
+
+            IARMEventQueue(const IARMEventQueue&) = delete;
+            IARMEventQueue& operator=(const IARMEventQueue&) = delete;
+
+            /***
+             * @brief        : Queue a copy of the event, from the IARM callback.
+             * @return       : true if the queue needs a drain scheduled, i.e. none is pending
+             */
+            bool push(const char* owner, int32_t eventId, const void* data, size_t len);
+
+            /***
+             * @brief        : Handle the queued events in order, until there are none left.
+             * @return       : the events handled
+             */
+            size_t drain(const Handler& handler);
+
+            // Drops the queued events, the next push schedules a drain
+            void clear();
+
+            // The time a post to the queue kept the IARM callback
+            void recordPost(uint64_t ns);
+
+            size_t size() const;
+            Stats stats() const;
+
+            static uint64_t nowNs();
+
+        private:
+            struct Event
+            {
+                std::string owner;
+                int32_t eventId;
+                std::vector<uint8_t> data;
+                size_t len;
+                uint64_t queuedNs;
+            };
+
+            const size_t m_maxEvents;
+
+            mutable std::mutex m_mutex;
+            std::deque<Event> m_events;
+            std::vector<std::vector<uint8_t>> m_pool;
+            bool m_scheduled;
+            Stats m_stats;
+        };
+
+    } // namespace Plugin
+
+} // namespace WPEFramework
+
+#endif
@@ -0,0 +1,308 @@
+/**
+* If not stated otherwise in this file or this component's LICENSE
+* file the following copyright and licenses apply:
+*
+* Copyright 2020 RDK Management
+*
+* Licensed under the Apache License, Version 2.0 (the "License");
+* you may not use this file except in compliance with the License.
+* You may obtain a copy of the License at
+*
+* http://www.apache.org/licenses/LICENSE-2.0
+*
+* Unless required by applicable law or agreed to in writing, software
+* distributed under the License is distributed on an "AS IS" BASIS,
+* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+* See the License for the specific language governing permissions and
+* limitations under the License.
+**/
+
+#include "settingsstore.h"
+
+#include <stdio.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <string.h>
+#include <unistd.h>
+#include <sys/file.h>
+#include <sys/stat.h>
+#include <chrono>
+#include <fstream>
+#include <map>
+#include <memory>
+#include <sstream>
+
+#include <plugins/plugins.h>
+
+// Kept free of utils.h so the store links without the plugin helpers
+#define SETTINGSLOG(fmt, ...) fprintf(stderr, "[%s:%d] SettingsStore: " fmt "\n", __FUNCTION__, __LINE__, ##__VA_ARGS__)
+
+namespace WPEFramework
+{
+
+    namespace Plugin
+    {
+
+        SettingsStore& SettingsStore::instance(const std::string& path)
+        {
+            static std::mutex mutex;
+            static std::map<std::string, std::unique_ptr<SettingsStore>> stores;
+
+            std::lock_guard<std::mutex> lock(mutex);
+            std::unique_ptr<SettingsStore>& store = stores[path];
+            if (!store)
+                store.reset(new SettingsStore(path));
+            return *store;
+        }
+
+        SettingsStore::SettingsStore(const std::string& path, uint32_t delayMs)
+            : m_path(path)
+            , m_delayMs(delayMs)
+            , m_loaded(false)
+            , m_exists(false)
+            , m_writing(false)
+            , m_stopping(false)
+            , m_writes(0)
+        {
+        }
+
+        SettingsStore::~SettingsStore()
+        {
+            {
+                std::lock_guard<std::mutex> lock(m_mutex);
+                m_stopping = true;
+            }
+            m_cond.notify_all();
+            if (m_thread.joinable())
+                m_thread.join();
+
+            // Do not lose the last changes to the delay
+            writePending();
+        }
+
+        bool SettingsStore::read(std::string& contents)
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            if (m_pending.empty() && !m_writing && (!m_loaded || !(fileId(m_path) == m_written)))
+                loadLocked();
+            contents = m_image;
+            return m_exists;
+        }
+
+        void SettingsStore::update(const std::function<void(std::string&)>& modify)
+        {
+            {
+                std::lock_guard<std::mutex> lock(m_mutex);
+                // Changes not written yet are newer than the file
+                if (m_pending.empty() && !m_writing && (!m_loaded || !(fileId(m_path) == m_written)))
+                    loadLocked();
+
+                modify(m_image);
+                m_pending.push_back(modify);
+                m_exists = true;
+
+                if (m_delayMs != 0 && !m_thread.joinable())
+                    m_thread = std::thread(&SettingsStore::writer, this);
+            }
+
+            if (m_delayMs == 0)
+                writePending();
+            else
+                m_cond.notify_all();
+        }
+
+        void SettingsStore::write(const std::string& contents)
+        {
+            update([contents](std::string& image) { image = contents; });
+        }
+
+        bool SettingsStore::flush()
+        {
+            return writePending();
+        }
+
+        uint32_t SettingsStore::writes() const
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            return m_writes;
+        }
+
+        bool SettingsStore::writeAtomically(const std::string& path, const std::string& contents)
+        {
+            std::string tmp = path + ".tmp";
+            int fd = open(tmp.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+            if (fd < 0) {
+                SETTINGSLOG("cannot create %s: %s", tmp.c_str(), strerror(errno));
+                return false;
+            }
+
+            const char* data = contents.data();
+            size_t left = contents.size();
+            bool result = true;
+            while (left > 0) {
+                ssize_t written = ::write(fd, data, left);
+                if (written < 0) {
+                    if (errno == EINTR)
+                        continue;
+                    result = false;
+                    break;
+                }
+                data += written;
+                left -= written;
+            }
+            if (result && fsync(fd) != 0)
+                result = false;
+            if (close(fd) != 0)
+                result = false;
+
+            if (!result || rename(tmp.c_str(), path.c_str()) != 0) {
+                SETTINGSLOG("cannot write %s: %s", path.c_str(), strerror(errno));
+                unlink(tmp.c_str());
+                return false;
+            }
+
+            // The rename itself is only durable once the directory is synced
+            size_t slash = path.find_last_of('/');
+            std::string dir = (slash == std::string::npos) ? "." : (slash == 0 ? "/" : path.substr(0, slash));
+            int dirFd = open(dir.c_str(), O_RDONLY | O_DIRECTORY | O_CLOEXEC);
+            if (dirFd >= 0) {
+                fsync(dirFd);
+                close(dirFd);
+            }
+            return true;
+        }
+
+        bool SettingsStore::FileId::operator==(const FileId& other) const
+        {
+            return exists == other.exists && ino == other.ino && size == other.size && mtimeNs == other.mtimeNs;
+        }
+
+        SettingsStore::FileId SettingsStore::fileId(const std::string& path)
+        {
+            FileId id;
+            struct stat st;
+            if (stat(path.c_str(), &st) == 0) {
+                id.exists = true;
+                id.ino = st.st_ino;
+                id.size = st.st_size;
+                id.mtimeNs = static_cast<int64_t>(st.st_mtim.tv_sec) * 1000000000 + st.st_mtim.tv_nsec;
+            }
+            return id;
+        }
+
+        bool SettingsStore::readFile(const std::string& path, std::string& contents)
+        {
+            contents.clear();
+
+            std::ifstream file(path.c_str(), std::ios::in | std::ios::binary);
+            if (!file)
+                return false;
+
+            std::ostringstream stream;
+            stream << file.rdbuf();
+            contents = stream.str();
+            return true;
+        }
+
+        void SettingsStore::loadLocked()
+        {
+            m_written = fileId(m_path);
+            m_exists = readFile(m_path, m_image);
+            m_loaded = true;
+        }
+
+        bool SettingsStore::writePending()
+        {
+            std::lock_guard<std::mutex> writeLock(m_writeMutex);
+
+            std::vector<Modify> pending;
+            {
+                std::lock_guard<std::mutex> lock(m_mutex);
+                if (m_pending.empty())
+                    return true;
+                pending.swap(m_pending);
+                m_writing = true;
+            }
+
+            // Stores of this file in other plugin libraries write it the same way, the lock on the
+            // directory keeps their read, modify and rename from interleaving with this one
+            size_t slash = m_path.find_last_of('/');
+            std::string dir = (slash == std::string::npos) ? "." : (slash == 0 ? "/" : m_path.substr(0, slash));
+            int dirFd = open(dir.c_str(), O_RDONLY | O_DIRECTORY | O_CLOEXEC);
+            if (dirFd >= 0 && flock(dirFd, LOCK_EX) != 0) {
+                SETTINGSLOG("cannot lock %s: %s", dir.c_str(), strerror(errno));
+            }
+
+            // Only this store's changes are applied, keys changed by other writers stay as they are
+            std::string contents;
+            readFile(m_path, contents);
+            for (auto& modify : pending)
+                modify(contents);
+
+            bool result = writeAtomically(m_path, contents);
+            FileId written = fileId(m_path);
+
+            if (dirFd >= 0)
+                close(dirFd);
+
+            {
+                std::lock_guard<std::mutex> lock(m_mutex);
+                m_writing = false;
+                if (result) {
+                    m_writes++;
+                    m_written = written;
+                    // The file as now written, with the changes made meanwhile on top
+                    m_image = contents;
+                    for (auto& modify : m_pending)
+                        modify(m_image);
+                    m_exists = true;
+                } else {
+                    // Still to be written, before the changes made meanwhile; the image keeps them all
+                    pending.insert(pending.end(), m_pending.begin(), m_pending.end());
+                    m_pending.swap(pending);
+                }
+            }
+
+            // The writer tries again after the delay
+            if (!result)
+                m_cond.notify_all();
+            return result;
+        }
+
+        void SettingsStore::writer()
+        {
+            std::unique_lock<std::mutex> lock(m_mutex);
+            while (!m_stopping) {
+                if (m_pending.empty()) {
+                    m_cond.wait(lock);
+                    continue;
+                }
+
+                // The changes that follow within the delay are written along
+                m_cond.wait_for(lock, std::chrono::milliseconds(m_delayMs), [this]() { return m_stopping; });
+
+                lock.unlock();
+                writePending();
+                lock.lock();
+            }
+        }
+
+    } // namespace Plugin
+
+} // namespace WPEFramework
+
+namespace Utils
+{
+    // Declared in utils.h
+    void persistJsonSettings(const string strFile, const string strKey, const JsonValue& jsValue)
+    {
+        // Replayed on the file as it is at write time, so it keeps its own copies
+        WPEFramework::Plugin::SettingsStore::instance(strFile).update([strKey, jsValue](std::string& contents) {
+            JsonObject settings;
+            settings.FromString(contents);
+            settings[strKey.c_str()] = jsValue;
+            contents.clear();
+            settings.ToString(contents);
+        });
+    }
+}
@@ -0,0 +1,148 @@
+/**
+* If not stated otherwise in this file or this component's LICENSE
+* file the following copyright and licenses apply:
+*
+* Copyright 2020 RDK Management
+*
+* Licensed under the Apache License, Version 2.0 (the "License");
+* you may not use this file except in compliance with the License.
+* You may obtain a copy of the License at
+*
+* http://www.apache.org/licenses/LICENSE-2.0
+*
+* Unless required by applicable law or agreed to in writing, software
+* distributed under the License is distributed on an "AS IS" BASIS,
+* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+* See the License for the specific language governing permissions and
+* limitations under the License.
+**/
+
+#ifndef SETTINGSSTORE_H
+#define SETTINGSSTORE_H
+
+#include <stdint.h>
+#include <sys/types.h>
+#include <string>
+#include <functional>
+#include <vector>
+#include <mutex>
+#include <condition_variable>
+#include <thread>
+
+#define SETTINGS_STORE_WRITE_DELAY_MS 500
+
+namespace WPEFramework
+{
+
+    namespace Plugin
+    {
+
+        /***
+         * The in-memory image of a settings file. Changes are written back after
+         * SETTINGS_STORE_WRITE_DELAY_MS, so a burst of them costs one write, and
+         * atomically: to a temporary file that is synced and then renamed over the
+         * settings file, which holds either the old or the new contents after a
+         * power cut. The image is read again if another writer changed the file.
+         *
+         * Every plugin library builds its own copy of this helper, so plugins sharing
+         * a file (HdmiCec_2 and HdmiCecSink, HdmiCec and LgiHdmiCec) each have a store
+         * of it. To not overwrite each other's keys, a store keeps its changes as the
+         * modifications that made them: at write time, with the directory locked
+         * against the other writers, it reads the file again and replays them on it.
+         * Changes that failed to be written are kept and written with the next ones.
+         */
+        class SettingsStore
+        {
+        public:
+            /***
+             * @brief        : The store of a file, shared by everyone in this plugin library that writes it.
+             */
+            static SettingsStore& instance(const std::string& path);
+
+            SettingsStore(const std::string& path, uint32_t delayMs = SETTINGS_STORE_WRITE_DELAY_MS);
+            ~SettingsStore();
+
+            SettingsStore(const SettingsStore&) = delete;
+            SettingsStore& operator=(const SettingsStore&) = delete;
+
+            /***
+             * @brief        : Get the contents, from the image once the file has been read.
+             * @param1[out]  : contents
+             * @return       : false if there is no such file and nothing was written yet
+             */
+            bool read(std::string& contents);
+
+            /***
+             * @brief        : Change the contents and schedule the write.
+             * @param1[in]   : called with the contents under the store lock, and again with the file
+             *                 contents when the change is written: keep no references to the caller
+             */
+            void update(const std::function<void(std::string&)>& modify);
+
+            /***
+             * @brief        : Replace the contents and schedule the write.
+             */
+            void write(const std::string& contents);
+
+            /***
+             * @brief        : Write a scheduled change now.
+             * @return       : false if writing the file failed
+             */
+            bool flush();
+
+            /***
+             * @brief        : Files written (and synced) so far.
+             */
+            uint32_t writes() const;
+
+            /***
+             * @brief        : Write a file through a synced temporary file and a rename.
+             * @return       : false if any step failed, the file is then unchanged
+             */
+            static bool writeAtomically(const std::string& path, const std::string& contents);
+
+        private:
+            struct FileId
+            {
+                FileId() : exists(false), ino(0), size(0), mtimeNs(0) {}
+                bool operator==(const FileId& other) const;
+
+                bool exists;
+                ino_t ino;
+                off_t size;
+                int64_t mtimeNs;
+            };
+
+            typedef std::function<void(std::string&)> Modify;
+
+            static FileId fileId(const std::string& path);
+            static bool readFile(const std::string& path, std::string& contents);
+            void loadLocked();
+            bool writePending();
+            void writer();
+
+            const std::string m_path;
+            const uint32_t m_delayMs;
+
+            mutable std::mutex m_mutex;
+            std::condition_variable m_cond;
+            std::string m_image;
+            bool m_loaded;
+            bool m_exists;
+            // Not written yet, in order
+            std::vector<Modify> m_pending;
+            bool m_writing;
+            bool m_stopping;
+            FileId m_written;       // The file as last read or written by the store
+            uint32_t m_writes;
+            std::thread m_thread;
+
+            // Held while a write is in progress, by the writer thread or a flush
+            std::mutex m_writeMutex;
+        };
+
+    } // namespace Plugin
+
+} // namespace WPEFramework
+
+#endif
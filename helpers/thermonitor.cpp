@@ -66,7 +66,7 @@ namespace WPEFramework {
             bool result = false;
             IARM_Bus_PWRMgr_GetThermalState_Param_t param;
 
-            IARM_Result_t res = IARM_Bus_Call(IARM_BUS_PWRMGR_NAME,
+            IARM_Result_t res = IARM_BUS_CALL(IARM_BUS_PWRMGR_NAME,
                     IARM_BUS_PWRMGR_API_GetThermalState, (void *)&param, sizeof(param));
 
             if (res == IARM_RESULT_SUCCESS) {
@@ -85,7 +85,7 @@ namespace WPEFramework {
             bool result = false;
             IARM_Bus_PWRMgr_GetTempThresholds_Param_t param;
 
-            IARM_Result_t res = IARM_Bus_Call(IARM_BUS_PWRMGR_NAME,
+            IARM_Result_t res = IARM_BUS_CALL(IARM_BUS_PWRMGR_NAME,
                     IARM_BUS_PWRMGR_API_GetTemperatureThresholds,
                     (void *)&param,
                     sizeof(param));
@@ -110,7 +110,7 @@ namespace WPEFramework {
             param.tempHigh = high;
             param.tempCritical = critical;
 
-            IARM_Result_t res = IARM_Bus_Call(IARM_BUS_PWRMGR_NAME,
+            IARM_Result_t res = IARM_BUS_CALL(IARM_BUS_PWRMGR_NAME,
                     IARM_BUS_PWRMGR_API_SetTemperatureThresholds,
                     (void *)&param,
                     sizeof(param));
@@ -130,7 +130,7 @@ namespace WPEFramework {
             bool result = false;
             IARM_Bus_PWRMgr_GetOvertempGraceInterval_Param_t param;
 
-            IARM_Result_t res = IARM_Bus_Call(IARM_BUS_PWRMGR_NAME,
+            IARM_Result_t res = IARM_BUS_CALL(IARM_BUS_PWRMGR_NAME,
                     IARM_BUS_PWRMGR_API_GetOvertempGraceInterval,
                     (void *)&param,
                     sizeof(param));
@@ -153,7 +153,7 @@ namespace WPEFramework {
             IARM_Bus_PWRMgr_SetOvertempGraceInterval_Param_t param;
             param.graceInterval = graceInterval;
 
-            IARM_Result_t res = IARM_Bus_Call(IARM_BUS_PWRMGR_NAME,
+            IARM_Result_t res = IARM_BUS_CALL(IARM_BUS_PWRMGR_NAME,
                     IARM_BUS_PWRMGR_API_SetOvertempGraceInterval,
                     (void *)&param,
                     sizeof(param));
@@ -0,0 +1,290 @@
+/**
+* If not stated otherwise in this file or this component's LICENSE
+* file the following copyright and licenses apply:
+*
+* Copyright 2019 RDK Management
+*
+* Licensed under the Apache License, Version 2.0 (the "License");
+* you may not use this file except in compliance with the License.
+* You may obtain a copy of the License at
+*
+* http://www.apache.org/licenses/LICENSE-2.0
+*
+* Unless required by applicable law or agreed to in writing, software
+* distributed under the License is distributed on an "AS IS" BASIS,
+* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+* See the License for the specific language governing permissions and
+* limitations under the License.
+**/
+
+#include "timerwheel.h"
+#include <pthread.h>
+
+TimerWheel::Timer::Timer()
+    : prev(this)
+    , next(this)
+    , expiry(0)
+    , level(-1)
+    , slot(-1)
+{
+}
+
+TimerWheel::Timer::Timer(std::function<void()> cb)
+    : prev(this)
+    , next(this)
+    , expiry(0)
+    , level(-1)
+    , slot(-1)
+    , callback(cb)
+{
+    // Constructed before the timer completes, so the wheel outlives static timers
+    TimerWheel::instance();
+}
+
+TimerWheel::Timer::~Timer()
+{
+    // Slot heads have no callback and belong to the wheel itself
+    if (callback) {
+        TimerWheel::instance().cancel(*this, true);
+    }
+}
+
+TimerWheel& TimerWheel::instance()
+{
+    static TimerWheel wheel;
+    return wheel;
+}
+
+TimerWheel::TimerWheel()
+    : m_stop(false)
+    , m_now(0)
+    , m_count(0)
+    , m_running(NULL)
+    , m_start(std::chrono::steady_clock::now())
+{
+    for (int level = 0; level < LEVELS; level++) {
+        m_occupied[level] = 0;
+    }
+}
+
+TimerWheel::~TimerWheel()
+{
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_stop = true;
+    }
+    m_cond.notify_all();
+    if (m_thread.joinable()) {
+        m_thread.join();
+    }
+}
+
+uint64_t TimerWheel::now()
+{
+    return std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - m_start).count();
+}
+
+void TimerWheel::link(Timer &list, Timer &timer)
+{
+    timer.prev = list.prev;
+    timer.next = &list;
+    list.prev->next = &timer;
+    list.prev = &timer;
+}
+
+void TimerWheel::unlink(Timer &timer)
+{
+    if (timer.next == &timer) {
+        return;
+    }
+
+    timer.prev->next = timer.next;
+    timer.next->prev = timer.prev;
+
+    if (timer.level >= 0) {
+        Timer &list = m_slots[timer.level][timer.slot];
+        if (list.next == &list) {
+            m_occupied[timer.level] &= ~(1ULL << timer.slot);
+        }
+        m_count--;
+    }
+
+    timer.prev = timer.next = &timer;
+    timer.level = timer.slot = -1;
+}
+
+// Level n holds timers expiring within SLOTS^(n+1) ticks, indexed by the matching bits of the expiry
+void TimerWheel::insert(Timer &timer)
+{
+    uint64_t expiry = timer.expiry;
+    if (expiry <= m_now) {
+        expiry = m_now + 1;
+    } else if (expiry - m_now > MAX_DELAY) {
+        // Parked at the far end, reinserted with the real expiry when cascaded
+        expiry = m_now + MAX_DELAY;
+    }
+
+    int level = 0;
+    while (level < LEVELS - 1 && (expiry - m_now) >= (1ULL << ((level + 1) * SLOT_BITS))) {
+        level++;
+    }
+    int slot = (expiry >> (level * SLOT_BITS)) & (SLOTS - 1);
+
+    link(m_slots[level][slot], timer);
+    timer.level = level;
+    timer.slot = slot;
+    m_occupied[level] |= (1ULL << slot);
+    m_count++;
+}
+
+void TimerWheel::cascade(int level)
+{
+    int slot = (m_now >> (level * SLOT_BITS)) & (SLOTS - 1);
+    Timer &list = m_slots[level][slot];
+
+    while (list.next != &list) {
+        Timer &timer = *list.next;
+        unlink(timer);
+        insert(timer);
+    }
+}
+
+void TimerWheel::advance(uint64_t target)
+{
+    std::unique_lock<std::mutex> lock(m_mutex);
+
+    while (m_now < target && !m_stop) {
+        if (m_count == 0) {
+            m_now = target;
+            break;
+        }
+
+        // Skip ahead to the next boundary of the lowest occupied level, nothing fires before it
+        int empty = 0;
+        while (empty < LEVELS && m_occupied[empty] == 0) {
+            empty++;
+        }
+        if (empty > 0) {
+            uint64_t boundary = ((m_now >> (empty * SLOT_BITS)) + 1) << (empty * SLOT_BITS);
+            if (empty == LEVELS || boundary - 1 > target) {
+                m_now = target;
+                break;
+            }
+            m_now = boundary - 1;
+        }
+
+        m_now++;
+        for (int level = 1; level < LEVELS; level++) {
+            if ((m_now & ((1ULL << (level * SLOT_BITS)) - 1)) != 0) {
+                break;
+            }
+            cascade(level);
+        }
+
+        Timer expired;
+        Timer &list = m_slots[0][m_now & (SLOTS - 1)];
+        while (list.next != &list) {
+            Timer &timer = *list.next;
+            unlink(timer);
+            if (timer.expiry > m_now) {
+                insert(timer);
+            } else {
+                link(expired, timer);
+            }
+        }
+
+        // Callbacks run unlocked, they may reschedule or cancel any timer including their own
+        while (expired.next != &expired) {
+            Timer &timer = *expired.next;
+            unlink(timer);
+            m_running = &timer;
+            lock.unlock();
+            timer.callback();
+            lock.lock();
+            m_running = NULL;
+            m_idle.notify_all();
+        }
+    }
+}
+
+// Tick at which the first occupied slot fires (level 0) or is cascaded (higher levels)
+uint64_t TimerWheel::nextEvent()
+{
+    uint64_t next = UINT64_MAX;
+
+    for (int level = 0; level < LEVELS; level++) {
+        if (m_occupied[level] != 0) {
+            uint64_t current = m_now >> (level * SLOT_BITS);
+            int start = (current + 1) & (SLOTS - 1);
+            uint64_t rotated = (m_occupied[level] >> start) | (start ? (m_occupied[level] << (SLOTS - start)) : 0);
+            uint64_t event = (current + 1 + __builtin_ctzll(rotated)) << (level * SLOT_BITS);
+            if (event < next) {
+                next = event;
+            }
+        }
+    }
+    return next;
+}
+
+void TimerWheel::run()
+{
+    pthread_setname_np(pthread_self(), "TimerWheel");
+
+    while (true) {
+        advance(now());
+
+        std::unique_lock<std::mutex> lock(m_mutex);
+        if (m_stop) {
+            break;
+        }
+
+        uint64_t next = nextEvent();
+        if (next == UINT64_MAX) {
+            m_cond.wait(lock);
+        } else {
+            m_cond.wait_until(lock, m_start + std::chrono::milliseconds(next));
+        }
+    }
+}
+
+void TimerWheel::schedule(Timer &timer, uint32_t delayMs)
+{
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+
+        if (!m_thread.joinable()) {
+            m_thread = std::thread(&TimerWheel::run, this);
+            m_threadId = m_thread.get_id();
+        }
+
+        unlink(timer);
+        uint64_t current = now();
+        if (m_count == 0 && m_now < current) {
+            m_now = current;
+        }
+        timer.expiry = current + delayMs;
+        // The wheel may lag behind the clock while it runs callbacks
+        if (timer.expiry < m_now) {
+            timer.expiry = m_now;
+        }
+        insert(timer);
+    }
+    m_cond.notify_one();
+}
+
+void TimerWheel::cancel(Timer &timer, bool wait)
+{
+    std::unique_lock<std::mutex> lock(m_mutex);
+
+    unlink(timer);
+
+    if (wait && std::this_thread::get_id() != m_threadId) {
+        m_idle.wait(lock, [&]() { return m_running != &timer; });
+    }
+}
+
+bool TimerWheel::isScheduled(const Timer &timer)
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return timer.next != &timer;
+}
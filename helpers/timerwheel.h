@@ -0,0 +1,127 @@
+/**
+* If not stated otherwise in this file or this component's LICENSE
+* file the following copyright and licenses apply:
+*
+* Copyright 2019 RDK Management
+*
+* Licensed under the Apache License, Version 2.0 (the "License");
+* you may not use this file except in compliance with the License.
+* You may obtain a copy of the License at
+*
+* http://www.apache.org/licenses/LICENSE-2.0
+*
+* Unless required by applicable law or agreed to in writing, software
+* distributed under the License is distributed on an "AS IS" BASIS,
+* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+* See the License for the specific language governing permissions and
+* limitations under the License.
+**/
+
+#ifndef TIMERWHEEL_H
+#define TIMERWHEEL_H
+
+#include <stdint.h>
+#include <chrono>
+#include <functional>
+#include <mutex>
+#include <condition_variable>
+#include <thread>
+
+/***
+ * Hierarchical timer wheel shared by all timers of the process (TpTimer, cTimer): it is
+ * built into lib<namespace>TimerWheel, which every plugin library using it links, so
+ * there is one instance however many plugins are loaded. One thread sleeps until the
+ * next expiry and runs the callbacks, instead of one thread per timer. Resolution is
+ * 1 ms, schedule and cancel are O(1).
+ *
+ * Callbacks run one after the other on that thread, so a callback that blocks delays
+ * every other timer of the process. They must not wait on IARM, CEC or other IPC:
+ * TpTimer only submits a worker pool job from its callback. cTimer runs its function
+ * on the wheel thread and is only meant for short work: its only user is SystemServices'
+ * once a second mode countdown, which calls setMode once when the countdown ends.
+ */
+class TimerWheel
+{
+    public:
+        class Timer
+        {
+            public:
+                /***
+                 * @brief    : Create a timer, the callback runs on the wheel thread each time it expires
+                 *             and must return quickly (see above).
+                 */
+                Timer(std::function<void()> callback);
+
+                /***
+                 * @brief    : Cancel the timer and wait for a running callback to finish.
+                 */
+                ~Timer();
+
+                Timer(const Timer&) = delete;
+                Timer& operator=(const Timer&) = delete;
+
+            private:
+                friend class TimerWheel;
+
+                // List head of a wheel slot
+                Timer();
+
+                Timer *prev;
+                Timer *next;
+                uint64_t expiry;
+                int level;
+                int slot;
+                std::function<void()> callback;
+        };
+
+        static TimerWheel& instance();
+
+        /***
+         * @brief    : (Re)arm a timer to expire once, delayMs from now. May be called from its own callback.
+         */
+        void schedule(Timer &timer, uint32_t delayMs);
+
+        /***
+         * @brief    : Disarm a timer. With wait set, also waits for a running callback of this timer
+         *             unless called from that callback.
+         */
+        void cancel(Timer &timer, bool wait = false);
+
+        bool isScheduled(const Timer &timer);
+
+        ~TimerWheel();
+
+    private:
+        static const int LEVELS = 5;
+        static const int SLOT_BITS = 6;
+        static const int SLOTS = 1 << SLOT_BITS;
+        static const uint64_t MAX_DELAY = (1ULL << (LEVELS * SLOT_BITS)) - 1;
+
+        TimerWheel();
+        TimerWheel(const TimerWheel&) = delete;
+        TimerWheel& operator=(const TimerWheel&) = delete;
+
+        uint64_t now();
+        void link(Timer &list, Timer &timer);
+        void unlink(Timer &timer);
+        void insert(Timer &timer);
+        void cascade(int level);
+        void advance(uint64_t target);
+        uint64_t nextEvent();
+        void run();
+
+        std::mutex m_mutex;
+        std::condition_variable m_cond;
+        std::condition_variable m_idle;
+        std::thread m_thread;
+        bool m_stop;
+        uint64_t m_now;
+        uint32_t m_count;
+        Timer *m_running;
+        std::thread::id m_threadId;
+        Timer m_slots[LEVELS][SLOTS];
+        uint64_t m_occupied[LEVELS];
+        std::chrono::steady_clock::time_point m_start;
+};
+
+#endif
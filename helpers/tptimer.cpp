@@ -25,8 +25,8 @@ namespace WPEFramework
     namespace Plugin
     {    
         TpTimer::TpTimer() :
-                baseTimer(64 * 1024, "ThunderPluginBaseTimer")
-                , m_timerJob(this)
+                baseTimer([this]() { m_job.Submit(); })
+        , m_job(*this)
         , m_isActive(false)
         , m_isSingleShot(false)
         , m_intervalInMs(-1)
@@ -34,7 +34,10 @@ namespace WPEFramework
 
         TpTimer::~TpTimer()
         {
-            stop();
+            // Wait for a pending or running callback, members it may use are about to go away
+            m_isActive = false;
+            TimerWheel::instance().cancel(baseTimer, true);
+            m_job.Revoke();
         }
 
         bool TpTimer::isActive()
@@ -44,15 +47,15 @@ namespace WPEFramework
 
         void TpTimer::stop()
         {
-            baseTimer.Revoke(m_timerJob);
+            TimerWheel::instance().cancel(baseTimer);
             m_isActive = false;
         }
         
         void TpTimer::start()
         {
-            baseTimer.Revoke(m_timerJob);
-            baseTimer.Schedule(Core::Time::Now().Add(m_intervalInMs), m_timerJob);
+            // Before the timer is armed, a short one may expire and be dispatched right away
             m_isActive = true;
+            TimerWheel::instance().schedule(baseTimer, m_intervalInMs);
         }
 
         void TpTimer::start(int msec)
@@ -76,6 +79,14 @@ namespace WPEFramework
             onTimeoutCallback = callback;
         }
 
+        void TpTimer::Dispatch()
+        {
+            // Stopped after the expiry was submitted
+            if (m_isActive) {
+                Timed();
+            }
+        }
+
         void TpTimer::Timed()
         {
             if(onTimeoutCallback != nullptr) {
@@ -90,13 +101,5 @@ namespace WPEFramework
                 }
             }
         }
-        
-        uint64_t TpTimerJob::Timed(const uint64_t scheduledTime)
-        {
-            if(m_tptimer) {
-                m_tptimer->Timed();
-            }
-            return 0;
-        }
     }
 }
@@ -22,37 +22,18 @@
 
 //#include <core/Timer.h>
 #include <plugins/plugins.h>
+#include <atomic>
+#include "timerwheel.h"
 
 namespace WPEFramework
 {
 
     namespace Plugin
     {
-        class TpTimer;
-        
-        class TpTimerJob
-        {
-        private:
-            TpTimerJob() = delete;
-            TpTimerJob& operator=(const TpTimerJob& RHS) = delete;
-
-        public:
-            TpTimerJob(WPEFramework::Plugin::TpTimer* tpt) : m_tptimer(tpt) { }
-            TpTimerJob(const TpTimerJob& copy) : m_tptimer(copy.m_tptimer) { }
-            ~TpTimerJob() {}
-
-            inline bool operator==(const TpTimerJob& RHS) const
-            {
-                return(m_tptimer == RHS.m_tptimer);
-            }
-
-        public:
-            uint64_t Timed(const uint64_t scheduledTime);
-
-        private:
-            WPEFramework::Plugin::TpTimer* m_tptimer;
-        };
-
+        // Armed on the shared TimerWheel rather than on a Core::TimerType thread
+        // of its own. The wheel only submits a job on expiry, the callback runs
+        // on the worker pool so that a blocking callback (IARM, CEC) does not
+        // hold up the other timers of the process.
         class TpTimer
         {
         public:
@@ -69,18 +50,18 @@ namespace WPEFramework
             void connect(std::function< void() > callback);
             
         private:
+            friend Core::ThreadPool::JobType<TpTimer&>;
+            void Dispatch();
             
             void Timed();
             
-            WPEFramework::Core::TimerType<TpTimerJob> baseTimer;
-            TpTimerJob m_timerJob;
-            bool m_isActive;
+            TimerWheel::Timer baseTimer;
+            Core::WorkerPool::JobType<TpTimer&> m_job;
+            std::atomic<bool> m_isActive;
             bool m_isSingleShot;
             int m_intervalInMs;
             
             std::function< void() > onTimeoutCallback;
-            
-            friend class TpTimerJob;
         };
     }
     
@@ -0,0 +1,370 @@
+/**
+* If not stated otherwise in this file or this component's LICENSE
+* file the following copyright and licenses apply:
+*
+* Copyright 2020 RDK Management
+*
+* Licensed under the Apache License, Version 2.0 (the "License");
+* you may not use this file except in compliance with the License.
+* You may obtain a copy of the License at
+*
+* http://www.apache.org/licenses/LICENSE-2.0
+*
+* Unless required by applicable law or agreed to in writing, software
+* distributed under the License is distributed on an "AS IS" BASIS,
+* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+* See the License for the specific language governing permissions and
+* limitations under the License.
+**/
+
+#include "tr181client.h"
+
+#include <stdio.h>
+#include <chrono>
+#include <curl/curl.h>
+
+#include "UtilsLogging.h"
+
+namespace WPEFramework
+{
+
+    namespace Plugin
+    {
+
+        static const char* immutableParams[] = {
+            "Device.DeviceInfo.SerialNumber",
+            "Device.DeviceInfo.ModelName",
+            "Device.DeviceInfo.Manufacturer",
+            "Device.DeviceInfo.ManufacturerOUI",
+            "Device.DeviceInfo.HardwareVersion",
+            "Device.DeviceInfo.ProductClass",
+            "Device.DeviceInfo.X_COMCAST-COM_STB_MAC",
+        };
+
+        static size_t writeResponse(void *ptr, size_t size, size_t nmemb, void *userdata)
+        {
+            static_cast<std::string*>(userdata)->append(static_cast<const char*>(ptr), size * nmemb);
+            return size * nmemb;
+        }
+
+        static bool isPartialPath(const std::string& name)
+        {
+            return !name.empty() && name[name.size() - 1] == '.';
+        }
+
+        TR181Client& TR181Client::instance()
+        {
+            static TR181Client client;
+            return client;
+        }
+
+        TR181Client::TR181Client(const std::string& url, uint32_t ttlMs, long timeoutSec, size_t maxEntries)
+            : m_url(url)
+            , m_ttlMs(ttlMs)
+            , m_timeoutSec(timeoutSec)
+            , m_maxEntries(maxEntries)
+            , m_nextBatch(1)
+            , m_completedBatch(0)
+            , m_inFlight(false)
+            , m_curl(NULL)
+        {
+        }
+
+        TR181Client::~TR181Client()
+        {
+            if (m_curl) {
+                curl_easy_cleanup(m_curl);
+            }
+        }
+
+        uint64_t TR181Client::nowMs()
+        {
+            return std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+        }
+
+        bool TR181Client::isImmutable(const std::string& name)
+        {
+            for (size_t i = 0; i < sizeof(immutableParams) / sizeof(immutableParams[0]); i++) {
+                if (name == immutableParams[i]) {
+                    return true;
+                }
+            }
+            return false;
+        }
+
+        // Called with m_mutex held, creates the entry if needed and marks it most recently used
+        TR181Client::Entry& TR181Client::entry(const std::string& name)
+        {
+            auto it = m_entries.find(name);
+            if (it == m_entries.end()) {
+                m_lru.push_front(name);
+                it = m_entries.emplace(name, Entry()).first;
+                it->second.lru = m_lru.begin();
+            } else {
+                m_lru.splice(m_lru.begin(), m_lru, it->second.lru);
+            }
+            return it->second;
+        }
+
+        // Called with m_mutex held
+        void TR181Client::trim()
+        {
+            auto it = m_lru.end();
+            while (m_entries.size() > m_maxEntries && it != m_lru.begin()) {
+                --it;
+                auto entry = m_entries.find(*it);
+                if (entry->second.readers == 0) {
+                    m_entries.erase(entry);
+                    it = m_lru.erase(it);
+                }
+            }
+        }
+
+        // Called with m_mutex held
+        bool TR181Client::lookup(const std::string& name, uint64_t now, JsonObject& param)
+        {
+            auto it = m_entries.find(name);
+            if (it == m_entries.end() || !it->second.found || it->second.stale) {
+                return false;
+            }
+            if (!isImmutable(name) && now - it->second.fetchedAt >= m_ttlMs) {
+                return false;
+            }
+            m_lru.splice(m_lru.begin(), m_lru, it->second.lru);
+            param = it->second.param;
+            return true;
+        }
+
+        bool TR181Client::post(const std::vector<std::string>& names, JsonArray& paramList)
+        {
+            JsonArray requestList;
+            for (auto& name : names) {
+                JsonObject param;
+                param["name"] = name;
+                requestList.Add(param);
+            }
+            JsonObject request;
+            request["paramList"] = requestList;
+            std::string postData;
+            request.ToString(postData);
+
+            std::lock_guard<std::mutex> lock(m_curlMutex);
+
+            // The handle keeps its connection to tr69hostif open between requests
+            if (!m_curl) {
+                m_curl = curl_easy_init();
+                if (!m_curl) {
+                    LOGERR("Could not initialize curl");
+                    return false;
+                }
+            }
+
+            std::string response;
+            struct curl_slist *headers = NULL;
+            headers = curl_slist_append(headers, "content-type: application/json");
+
+            curl_easy_reset(m_curl);
+            curl_easy_setopt(m_curl, CURLOPT_URL, m_url.c_str());
+            curl_easy_setopt(m_curl, CURLOPT_HTTPHEADER, headers);
+            curl_easy_setopt(m_curl, CURLOPT_POSTFIELDS, postData.c_str());
+            curl_easy_setopt(m_curl, CURLOPT_POSTFIELDSIZE, postData.size());
+            curl_easy_setopt(m_curl, CURLOPT_FOLLOWLOCATION, 1);
+            curl_easy_setopt(m_curl, CURLOPT_WRITEFUNCTION, writeResponse);
+            curl_easy_setopt(m_curl, CURLOPT_WRITEDATA, &response);
+            curl_easy_setopt(m_curl, CURLOPT_TIMEOUT, m_timeoutSec);
+            curl_easy_setopt(m_curl, CURLOPT_TCP_KEEPALIVE, 1L);
+            curl_easy_setopt(m_curl, CURLOPT_NOSIGNAL, 1L);
+
+            long http_code = 0;
+            CURLcode res = curl_easy_perform(m_curl);
+            curl_easy_getinfo(m_curl, CURLINFO_RESPONSE_CODE, &http_code);
+            curl_slist_free_all(headers);
+
+            if (res != CURLE_OK || (http_code != 0 && http_code != 200)) {
+                LOGERR("Request failed: curl %d, http response code %ld", res, http_code);
+                return false;
+            }
+
+            JsonObject responseJson;
+            if (!responseJson.FromString(response) || !responseJson.HasLabel("paramList")) {
+                LOGWARN("Unexpected response: %s", response.c_str());
+                return false;
+            }
+            paramList = responseJson["paramList"].Array();
+            return true;
+        }
+
+        // Called without m_mutex held, by the one thread that owns the batch
+        void TR181Client::fetchBatch(uint64_t batch, std::set<std::string>& names)
+        {
+            std::vector<std::string> request(names.begin(), names.end());
+            JsonArray paramList;
+            bool ok = post(request, paramList);
+
+            uint64_t now = nowMs();
+            std::lock_guard<std::mutex> lock(m_mutex);
+
+            if (ok) {
+                for (int i = 0; i < paramList.Length(); i++) {
+                    JsonObject param = paramList[i].Object();
+                    std::string name = param["name"].String();
+                    if (names.erase(name) == 0) {
+                        continue;
+                    }
+                    Entry& entry = this->entry(name);
+                    entry.param = param;
+                    entry.fetchedAt = now;
+                    entry.batch = batch;
+                    entry.found = true;
+                    entry.failed = false;
+                    entry.stale = false;
+                }
+            }
+
+            // Parameters tr69hostif did not return, marked so their waiters do not block on a later batch
+            for (auto& name : names) {
+                Entry& entry = this->entry(name);
+                entry.batch = batch;
+                entry.found = false;
+                entry.failed = !ok;
+                entry.stale = false;
+            }
+        }
+
+        bool TR181Client::getParameters(const std::vector<std::string>& names, JsonArray& paramList)
+        {
+            // Indexes into names, every name gets its results in its own slot to keep the request order
+            std::vector<size_t> partial;
+            std::vector<size_t> wanted;
+            std::vector<JsonArray> results(names.size());
+
+            std::unique_lock<std::mutex> lock(m_mutex);
+
+            uint64_t now = nowMs();
+            for (size_t i = 0; i < names.size(); i++) {
+                JsonObject param;
+                if (isPartialPath(names[i])) {
+                    partial.push_back(i);
+                } else if (lookup(names[i], now, param)) {
+                    results[i].Add(param);
+                } else {
+                    wanted.push_back(i);
+                    entry(names[i]).readers++;
+                }
+            }
+
+            bool ok = true;
+
+            if (!wanted.empty()) {
+                // Join the batch that goes out next, whoever ends up sending it
+                uint64_t batch = m_nextBatch;
+                for (size_t i : wanted) {
+                    m_pending.insert(names[i]);
+                }
+
+                while (m_completedBatch < batch) {
+                    if (!m_inFlight) {
+                        std::set<std::string> sending;
+                        sending.swap(m_pending);
+                        uint64_t sendingBatch = m_nextBatch++;
+                        m_inFlight = true;
+                        lock.unlock();
+
+                        fetchBatch(sendingBatch, sending);
+
+                        lock.lock();
+                        m_inFlight = false;
+                        m_completedBatch = sendingBatch;
+                        m_cond.notify_all();
+                    } else {
+                        m_cond.wait(lock);
+                    }
+                }
+
+                for (size_t i : wanted) {
+                    Entry& entry = m_entries[names[i]];
+                    entry.readers--;
+                    if (entry.batch < batch) {
+                        continue;
+                    }
+                    if (entry.failed) {
+                        ok = false;
+                    } else if (entry.found) {
+                        results[i].Add(entry.param);
+                    }
+                }
+
+                trim();
+            }
+
+            lock.unlock();
+
+            if (!partial.empty()) {
+                std::vector<std::string> partialNames;
+                for (size_t i : partial) {
+                    partialNames.push_back(names[i]);
+                }
+
+                JsonArray partialList;
+                if (post(partialNames, partialList)) {
+                    // Each parameter goes with the first partial path it falls under
+                    for (int n = 0; n < partialList.Length(); n++) {
+                        std::string name = partialList[n].Object()["name"].String();
+                        size_t slot = partial.back();
+                        for (size_t i : partial) {
+                            if (name.compare(0, names[i].size(), names[i]) == 0) {
+                                slot = i;
+                                break;
+                            }
+                        }
+                        results[slot].Add(partialList[n]);
+                    }
+                } else {
+                    ok = false;
+                }
+            }
+
+            JsonArray result;
+            for (auto& found : results) {
+                for (int n = 0; n < found.Length(); n++) {
+                    result.Add(found[n]);
+                }
+            }
+            paramList = result;
+            return ok;
+        }
+
+        bool TR181Client::getParameter(const std::string& name, std::string& value)
+        {
+            JsonArray paramList;
+            if (!getParameters(std::vector<std::string>(1, name), paramList) || paramList.Length() == 0) {
+                return false;
+            }
+
+            JsonObject param = paramList[0].Object();
+            if (!param.HasLabel("value")) {
+                return false;
+            }
+            // Non-string values (numbers, booleans) are returned in their JSON form
+            value = param["value"].Content() == JsonValue::type::STRING ? param["value"].String() : param["value"].Value();
+            return true;
+        }
+
+        void TR181Client::invalidate()
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            // Entries stay, a waiter of a completed batch may not have picked up its result yet
+            for (auto& entry : m_entries) {
+                entry.second.stale = true;
+            }
+        }
+
+        size_t TR181Client::pending()
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            return m_pending.size();
+        }
+
+    } // namespace Plugin
+
+} // namespace WPEFramework
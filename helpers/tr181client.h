@@ -0,0 +1,142 @@
+/**
+* If not stated otherwise in this file or this component's LICENSE
+* file the following copyright and licenses apply:
+*
+* Copyright 2020 RDK Management
+*
+* Licensed under the Apache License, Version 2.0 (the "License");
+* you may not use this file except in compliance with the License.
+* You may obtain a copy of the License at
+*
+* http://www.apache.org/licenses/LICENSE-2.0
+*
+* Unless required by applicable law or agreed to in writing, software
+* distributed under the License is distributed on an "AS IS" BASIS,
+* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+* See the License for the specific language governing permissions and
+* limitations under the License.
+**/
+
+#ifndef TR181CLIENT_H
+#define TR181CLIENT_H
+
+#include <string>
+#include <vector>
+#include <list>
+#include <set>
+#include <map>
+#include <mutex>
+#include <condition_variable>
+
+#include <plugins/plugins.h>
+
+#define TR181_DEFAULT_URL "http://127.0.0.1:10999/"
+#define TR181_DEFAULT_TTL_MS 2000
+#define TR181_DEFAULT_TIMEOUT_S 30
+#define TR181_DEFAULT_MAX_ENTRIES 128
+
+typedef void CURL;
+
+namespace WPEFramework
+{
+
+    namespace Plugin
+    {
+
+        /***
+         * Client for the tr69hostif JSON interface. One keep-alive connection is
+         * shared by all callers; parameters requested while a POST is in flight are
+         * collected and fetched together in the next one. A fixed list of device identity
+         * parameters (serial number, model, the box MAC address) is cached for the process
+         * lifetime, all others for the TTL. Partial paths (ending in '.') are never cached.
+         * At most maxEntries parameters are kept, the least recently used go first.
+         */
+        class TR181Client
+        {
+        public:
+            static TR181Client& instance();
+
+            TR181Client(const std::string& url = TR181_DEFAULT_URL,
+                        uint32_t ttlMs = TR181_DEFAULT_TTL_MS,
+                        long timeoutSec = TR181_DEFAULT_TIMEOUT_S,
+                        size_t maxEntries = TR181_DEFAULT_MAX_ENTRIES);
+            ~TR181Client();
+
+            TR181Client(const TR181Client&) = delete;
+            TR181Client& operator=(const TR181Client&) = delete;
+
+            /***
+             * @brief        : Get parameters, in the format returned by tr69hostif.
+             * @param1[in]   : parameter names
+             * @param2[out]  : [{"name":"<string>","value":<value>}, ...] for every parameter found,
+             *                 in the order requested
+             * @return       : false if the request to tr69hostif failed
+             */
+            bool getParameters(const std::vector<std::string>& names, JsonArray& paramList);
+
+            /***
+             * @brief        : Get the value of a single parameter as a string.
+             * @return       : false if the parameter could not be retrieved
+             */
+            bool getParameter(const std::string& name, std::string& value);
+
+            /***
+             * @brief        : Drop all cached values, including the immutable ones.
+             */
+            void invalidate();
+
+            /***
+             * @brief        : Parameters waiting to go out with the next POST.
+             */
+            size_t pending();
+
+            static bool isImmutable(const std::string& name);
+
+        private:
+            struct Entry
+            {
+                Entry() : fetchedAt(0), batch(0), readers(0), found(false), failed(false), stale(false) {}
+
+                JsonObject param;
+                uint64_t fetchedAt;
+                uint64_t batch;
+                // Requests waiting for this parameter, it is not evicted before they read it
+                uint32_t readers;
+                bool found;
+                bool failed;
+                bool stale;
+                std::list<std::string>::iterator lru;
+            };
+
+            Entry& entry(const std::string& name);
+            void trim();
+            bool lookup(const std::string& name, uint64_t now, JsonObject& param);
+            void fetchBatch(uint64_t batch, std::set<std::string>& names);
+            bool post(const std::vector<std::string>& names, JsonArray& paramList);
+            static uint64_t nowMs();
+
+            const std::string m_url;
+            const uint32_t m_ttlMs;
+            const long m_timeoutSec;
+            const size_t m_maxEntries;
+
+            std::mutex m_mutex;
+            std::condition_variable m_cond;
+            std::map<std::string, Entry> m_entries;
+            // Most recently used first
+            std::list<std::string> m_lru;
+            std::set<std::string> m_pending;
+            uint64_t m_nextBatch;
+            uint64_t m_completedBatch;
+            bool m_inFlight;
+
+            // Only used by the thread that owns the in-flight POST (or a partial path request)
+            std::mutex m_curlMutex;
+            CURL *m_curl;
+        };
+
+    } // namespace Plugin
+
+} // namespace WPEFramework
+
+#endif
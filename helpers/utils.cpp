@@ -422,28 +422,3 @@ void Utils::syncPersistFile (const string file) {
     fsync(fileno(fp));
     fclose(fp);
 }
-
-void Utils::persistJsonSettings(const string strFile, const string strKey, const JsonValue& jsValue)
-{
-    Core::File file;
-    file = strFile.c_str();
-
-    file.Open(false);
-    if (!file.IsOpen())
-        file.Create();
-
-    JsonObject cecSetting;
-    cecSetting.IElement::FromFile(file);
-    file.Destroy();
-    file.Create();
-    cecSetting[strKey.c_str()] = jsValue;
-    cecSetting.IElement::ToFile(file);
-
-    file.Close();
-
-    //Sync the settings
-    Utils::syncPersistFile (strFile);
-
-    return;
-}
-
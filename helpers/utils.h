@@ -27,14 +27,12 @@
 #include <tracing/tracing.h>
 #include "rfcapi.h"
 #include <math.h>
-
-// telemetry
-#ifdef ENABLE_TELEMETRY_LOGGING
-#include <telemetry_busmessage_sender.h>
-#endif
+#include "UtilsLogging.h"
 
 // IARM
 #include "rdk/iarmbus/libIARM.h"
+#include "rdk/iarmbus/libIBus.h"
+#include "iarmcallstats.h"
 
 // std
 #include <string>
@@ -43,11 +41,6 @@
 #define UNUSED(expr)(void)(expr)
 #define C_STR(x) (x).c_str()
 
-#define LOGINFO(fmt, ...) do { fprintf(stderr, "[%d] INFO [%s:%d] %s: " fmt "\n", (int)syscall(SYS_gettid), Core::FileNameOnly(__FILE__), __LINE__, __FUNCTION__, ##__VA_ARGS__); fflush(stderr); } while (0)
-#define LOGDBG(fmt, ...) do { fprintf(stderr, "[%d] DEBUG [%s:%d] %s: " fmt "\n", (int)syscall(SYS_gettid), Core::FileNameOnly(__FILE__), __LINE__, __FUNCTION__, ##__VA_ARGS__); fflush(stderr); } while (0)
-#define LOGWARN(fmt, ...) do { fprintf(stderr, "[%d] WARN [%s:%d] %s: " fmt "\n", (int)syscall(SYS_gettid), Core::FileNameOnly(__FILE__), __LINE__, __FUNCTION__, ##__VA_ARGS__); fflush(stderr); } while (0)
-#define LOGERR(fmt, ...) do { fprintf(stderr, "[%d] ERROR [%s:%d] %s: " fmt "\n", (int)syscall(SYS_gettid), Core::FileNameOnly(__FILE__), __LINE__, __FUNCTION__, ##__VA_ARGS__); fflush(stderr); Utils::Telemetry::sendError(fmt, ##__VA_ARGS__); } while (0)
-
 #define LOGINFOMETHOD() { std::string json; parameters.ToString(json); LOGINFO( "params=%s", json.c_str() );  }
 #define LOGTRACEMETHODFIN() do { std::string json; response.ToString(json); LOGINFO( "response=%s", json.c_str() );  } while (0)
 
@@ -207,12 +200,33 @@
     } \
 }
 
+// IARM_Bus_Call, timed in IARMCallStats for getIARMCallStats of DeviceDiagnostics, and logged if slow
+#define IARM_BUS_CALL(ownerName, methodName, arg, argLen) \
+    Utils::IARM::call([]() -> WPEFramework::Plugin::IARMCallStats::Site& { static WPEFramework::Plugin::IARMCallStats::Site site; return site; }(), \
+        ownerName, methodName, arg, argLen, __FILE__, __LINE__)
+
 namespace Utils
 {
     struct IARM {
         static bool init();
         static bool isConnected();
 
+        static IARM_Result_t call(WPEFramework::Plugin::IARMCallStats::Site& site, const char* ownerName, const char* methodName,
+            void* arg, size_t argLen, const char* file, int line)
+        {
+            WPEFramework::Plugin::IARMCallStats::Call call(WPEFramework::Plugin::IARMCallStats::instance(), site, ownerName, methodName);
+            IARM_Result_t result = IARM_Bus_Call(ownerName, methodName, arg, argLen);
+            if (call.end(result == IARM_RESULT_SUCCESS))
+            {
+                // As LOGWARN, with the location of the call
+                fprintf(stderr, "[%d] WARN [%s:%d] IARM_BUS_CALL: %s %s took %llu ms, plugin '%s' method '%s'\n", (int)syscall(SYS_gettid),
+                    WPEFramework::Core::FileNameOnly(file), line, ownerName, methodName, static_cast<unsigned long long>(call.elapsedUs() / 1000),
+                    WPEFramework::Plugin::IARMCallStats::Scope::plugin(), WPEFramework::Plugin::IARMCallStats::Scope::method());
+                fflush(stderr);
+            }
+            return result;
+        }
+
         static const char* NAME;
     };
 
@@ -374,6 +388,7 @@ namespace Utils
     bool isValidInt(char* x);
     bool isValidUnsignedInt(char* x);
     void syncPersistFile (const string file);
+    // In settingsstore.cpp: written back through the file's SettingsStore, after a delay and atomically
     void persistJsonSettings(const string file, const string strKey, const JsonValue& jsValue);
 
     //class for std::thread RAII
@@ -394,46 +409,4 @@ namespace Utils
             std::thread t;
     };
 
-    struct Telemetry
-    {
-        static void init()
-        {
-#ifdef ENABLE_TELEMETRY_LOGGING
-            t2_init("Thunder_Plugins");
-#endif
-        };
-
-        static void sendMessage(const char* message)
-        {
-#ifdef ENABLE_TELEMETRY_LOGGING
-            t2_event_s("THUNDER_MESSAGE", message);
-#endif
-        };
-
-        static void sendMessage(const char *marker, const char* message)
-        {
-#ifdef ENABLE_TELEMETRY_LOGGING
-            t2_event_s(marker, message);
-#endif
-        };
-
-        static void sendError(const char* format, ...)
-        {
-#ifdef ENABLE_TELEMETRY_LOGGING
-            va_list parameters;
-            va_start(parameters, format);
-            std::string message;
-            WPEFramework::Trace::Format(message, format, parameters);
-            va_end(parameters);
-
-            // get rid of const for t2_event_s
-            char* error = strdup(message.c_str());
-            t2_event_s("THUNDER_ERROR", error);
-            if (error)
-            {
-                free(error);
-            }
-#endif
-        };
-    };
 } // namespace Utils